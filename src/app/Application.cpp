@@ -8,7 +8,10 @@
 #include "core/SceneManager.h"
 #include "core/Selection.h"
 #include "core/IntegrationController.h"
+#include "core/Commands/MeshDelta.h"
+#include "core/Commands/MeshEditCommand.h"
 #include "geometry/MeshData.h"
+#include "geometry/DerivedDataCache.h"
 #include "geometry/PrimitiveGenerator.h"
 #include "io/MeshImporter.h"
 #include "io/STLImporter.h"
@@ -35,6 +38,7 @@
 #include <QApplication>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QElapsedTimer>
 
 #include <sstream>
 #include <cstring>
@@ -42,6 +46,57 @@
 
 namespace dc3d {
 
+namespace {
+
+/**
+ * @brief Shows geometry in the viewport while a file is still being parsed
+ *
+ * Chunks are staged in the viewport as they arrive and uploaded to the
+ * GPU by the next paintGL(). The camera is fitted to the first triangles,
+ * and repaints are throttled so rendering does not slow the import down.
+ */
+class ViewportPreviewSink : public io::MeshSink
+{
+public:
+    ViewportPreviewSink(dc::Viewport* viewport, QProgressDialog* progressDialog)
+        : m_viewport(viewport), m_progressDialog(progressDialog) {}
+    
+    void begin(size_t expectedVertices, size_t expectedTriangles) override
+    {
+        m_viewport->beginImportPreview(expectedVertices, expectedTriangles);
+        m_refreshTimer.start();
+    }
+    
+    bool consume(const io::MeshChunk& chunk) override
+    {
+        m_viewport->appendImportPreview(chunk.vertices, chunk.vertexCount,
+                                        chunk.indices, chunk.indexCount,
+                                        chunk.boundsMin, chunk.boundsMax);
+        
+        // Show the first triangles right away, then refresh periodically
+        constexpr qint64 PREVIEW_REFRESH_MS = 100;
+        bool firstPixels = !m_fitted && chunk.indexCount > 0;
+        if (firstPixels) {
+            m_viewport->fitViewToImportPreview();
+            m_fitted = true;
+        }
+        if (firstPixels || m_refreshTimer.elapsed() >= PREVIEW_REFRESH_MS) {
+            QApplication::processEvents();
+            m_refreshTimer.restart();
+        }
+        
+        return !(m_progressDialog && m_progressDialog->wasCanceled());
+    }
+    
+private:
+    dc::Viewport* m_viewport;
+    QProgressDialog* m_progressDialog;
+    QElapsedTimer m_refreshTimer;
+    bool m_fitted = false;
+};
+
+} // anonymous namespace
+
 Application* Application::s_instance = nullptr;
 
 Application::Application(QObject* parent)
@@ -78,12 +133,33 @@ bool Application::initialize()
     m_undoStack->setUndoLimit(undoLimit);
     qDebug() << "Undo limit set to:" << undoLimit;
     
+    // Mesh edits keep deltas for undo; compress them unless turned off
+    core::MeshDelta::Options deltaOptions;
+    deltaOptions.compress = settings.value("preferences/performance/compressUndo", true).toBool();
+    core::MeshDelta::setDefaultOptions(deltaOptions);
+    
+    // Past the memory budget, older undo steps go to temp files instead of
+    // being dropped (up to the disk budget)
+    core::CommandHistory::SpillOptions spillOptions;
+    spillOptions.enabled = settings.value("preferences/performance/undoSpillToDisk", true).toBool();
+    spillOptions.maxDiskBytes = settings.value("preferences/performance/undoDiskLimitMB", 8192).toULongLong() << 20;
+    spillOptions.directory = settings.value("preferences/performance/undoSpillDirectory").toString().toStdString();
+    core::CommandHistory::setDefaultSpillOptions(spillOptions);
+    
     // Initialize scene manager
     m_sceneManager = std::make_unique<core::SceneManager>();
     
     // Initialize selection system
     m_selection = std::make_unique<core::Selection>();
     
+    // Welded meshes and BVHs are cached on disk by mesh content, so
+    // re-opening the same scan in a later session skips rebuilding them
+    auto& derivedCache = geometry::DerivedDataCache::instance();
+    derivedCache.setDirectory(settings.value("preferences/performance/derivedCacheDirectory",
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/derived").toString().toStdString());
+    derivedCache.setMaxBytes(settings.value("preferences/performance/derivedCacheSizeMB", 8192).toULongLong() << 20);
+    derivedCache.setEnabled(settings.value("preferences/performance/derivedCacheEnabled", true).toBool());
+    
     // Initialize picking system
     m_picking = std::make_unique<renderer::Picking>();
     
@@ -271,22 +347,32 @@ bool Application::importMesh(const QString& filePath)
             return true;  // Continue import
         };
         
+        // Stream large files into a viewport preview while they load
+        std::unique_ptr<ViewportPreviewSink> previewSink;
+        dc::Viewport* viewport = m_mainWindow ? m_mainWindow->viewport() : nullptr;
+        if (fileSize > PROGRESS_DIALOG_THRESHOLD && viewport) {
+            previewSink = std::make_unique<ViewportPreviewSink>(viewport, progressDialog.get());
+        }
+        
         try {
             if (extension == "stl") {
                 io::STLImportOptions options;
                 options.computeNormals = true;
                 options.mergeVertexTolerance = 1e-6f;
+                options.sink = previewSink.get();
                 result = io::STLImporter::import(path, options, progressCallback);
             } 
             else if (extension == "obj") {
                 io::OBJImportOptions options;
                 options.computeNormalsIfMissing = true;
                 options.triangulate = true;
+                options.sink = previewSink.get();
                 result = io::OBJImporter::import(path, options, progressCallback);
             }
             else if (extension == "ply") {
                 io::PLYImportOptions options;
                 options.computeNormalsIfMissing = true;
+                options.sink = previewSink.get();
                 result = io::PLYImporter::import(path, options, progressCallback);
             }
             else {
@@ -296,12 +382,20 @@ bool Application::importMesh(const QString& filePath)
                 return false;
             }
         } catch (const std::exception& e) {
+            if (previewSink) {
+                viewport->endImportPreview();
+            }
             QString error = QString("Import exception: %1").arg(e.what());
             qWarning() << error;
             emit importFailed(error);
             return false;
         }
         
+        // The imported mesh (or nothing, on failure) replaces the preview
+        if (previewSink) {
+            viewport->endImportPreview();
+        }
+        
         // Close progress dialog
         if (progressDialog) {
             progressDialog->close();
@@ -936,8 +1030,8 @@ bool Application::doSaveProject(const QString& filePath)
             manifest << "      \"visible\": " << (meshNode->isVisible() ? "true" : "false") << "\n";
             manifest << "    }" << (i < meshIds.size() - 1 ? "," : "") << "\n";
             
-            // Serialize mesh data
-            auto mesh = meshNode->mesh();
+            // Serialize mesh data (const: reading must not unshare the arrays)
+            std::shared_ptr<const geometry::MeshData> mesh = meshNode->mesh();
             if (mesh) {
                 std::vector<uint8_t> meshData;
                 
@@ -1208,7 +1302,7 @@ bool Application::doLoadProject(const QString& filePath)
                 if (offset < data.size()) {
                     bool hasNormals = data[offset++] != 0;
                     if (hasNormals && mesh->vertexCount() > 0) {
-                        auto& normals = mesh->normals();
+                        auto& normals = mesh->editNormals();
                         normals.reserve(mesh->vertexCount());
                         for (size_t i = 0; i < mesh->vertexCount() && offset + 12 <= data.size(); i++) {
                             float x = readFloat();
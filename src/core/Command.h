@@ -16,6 +16,8 @@
 namespace dc3d {
 namespace core {
 
+class UndoSpillStore;
+
 /**
  * @class Command
  * @brief Abstract base class for undoable commands
@@ -66,6 +68,20 @@ public:
      */
     virtual size_t memoryUsage() const { return sizeof(*this); }
     
+    /**
+     * @brief Move this command's stored state to disk
+     * @param store Store to write it to
+     * @return Memory in bytes freed (0 if nothing was moved)
+     * 
+     * Called by the undo history when it runs over its memory budget. The
+     * command must still undo and redo afterwards, reading the state back
+     * as needed.
+     */
+    virtual size_t spill(UndoSpillStore& store) {
+        Q_UNUSED(store);
+        return 0;
+    }
+    
     /**
      * @brief Get a human-readable description of the command
      * @return Description for display in Edit menu (e.g., "Undo Import Mesh")
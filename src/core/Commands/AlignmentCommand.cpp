@@ -164,7 +164,7 @@ void AlignmentCommand::computeNewTransforms()
 
 glm::vec3 AlignmentCommand::getBoundsMin(uint64_t meshId) const
 {
-    auto mesh = m_sceneManager->getMesh(meshId);
+    std::shared_ptr<const geometry::MeshData> mesh = m_sceneManager->getMesh(meshId);
     if (!mesh) return glm::vec3(0.0f);
     
     const auto& verts = mesh->vertices();
@@ -179,7 +179,7 @@ glm::vec3 AlignmentCommand::getBoundsMin(uint64_t meshId) const
 
 glm::vec3 AlignmentCommand::getBoundsMax(uint64_t meshId) const
 {
-    auto mesh = m_sceneManager->getMesh(meshId);
+    std::shared_ptr<const geometry::MeshData> mesh = m_sceneManager->getMesh(meshId);
     if (!mesh) return glm::vec3(0.0f);
     
     const auto& verts = mesh->vertices();
@@ -269,7 +269,7 @@ void DistributeCommand::computeDistribution()
     
     std::vector<MeshInfo> infos;
     for (uint64_t id : m_meshIds) {
-        auto mesh = m_sceneManager->getMesh(id);
+        std::shared_ptr<const geometry::MeshData> mesh = m_sceneManager->getMesh(id);
         if (!mesh) continue;
         
         const auto& verts = mesh->vertices();
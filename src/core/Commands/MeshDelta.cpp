@@ -0,0 +1,468 @@
+/**
+ * @file MeshDelta.cpp
+ * @brief Implementation of mesh state deltas
+ */
+
+#include "MeshDelta.h"
+#include "../TaskScheduler.h"
+
+#include <QByteArray>
+#include <QDebug>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace dc3d {
+namespace core {
+
+namespace {
+
+// Elements compared per parallel task
+constexpr size_t COMPARE_BLOCK_ELEMENTS = 1 << 16;
+
+// Changed runs closer than this are stored as one (the unchanged elements
+// in between XOR to zero, which costs less than another run)
+constexpr uint64_t RUN_MERGE_GAP = 8;
+
+// Stored bytes are compressed in independent blocks (multiple of 4)
+constexpr size_t PACK_BLOCK_BYTES = 1 << 22;
+
+MeshDelta::Options& defaultOptionsStorage()
+{
+    static MeshDelta::Options options;
+    return options;
+}
+
+// Part of a changed run, no longer than one compare block, so that one
+// run covering the whole array is still XORed in parallel
+struct Piece {
+    uint64_t first;     // First element in the array
+    uint64_t count;     // Number of elements
+    uint64_t offset;    // First element in the XOR data
+};
+
+template<typename RunList>
+std::vector<Piece> splitRuns(const RunList& runs)
+{
+    std::vector<Piece> pieces;
+    uint64_t offset = 0;
+    for (const auto& run : runs) {
+        for (uint64_t done = 0; done < run.count; done += COMPARE_BLOCK_ELEMENTS) {
+            uint64_t count = std::min<uint64_t>(COMPARE_BLOCK_ELEMENTS, run.count - done);
+            pieces.push_back({run.first + done, count, offset});
+            offset += count;
+        }
+    }
+    return pieces;
+}
+
+// Split 32-bit words into four byte planes (and back)
+void toBytePlanes(const uint8_t* in, uint8_t* planes, size_t words)
+{
+    for (size_t i = 0; i < words; ++i) {
+        for (size_t k = 0; k < 4; ++k) {
+            planes[k * words + i] = in[i * 4 + k];
+        }
+    }
+}
+
+void fromBytePlanes(const uint8_t* planes, uint8_t* out, size_t words)
+{
+    for (size_t i = 0; i < words; ++i) {
+        for (size_t k = 0; k < 4; ++k) {
+            out[i * 4 + k] = planes[k * words + i];
+        }
+    }
+}
+
+} // anonymous namespace
+
+const MeshDelta::Options& MeshDelta::defaultOptions()
+{
+    return defaultOptionsStorage();
+}
+
+void MeshDelta::setDefaultOptions(const Options& options)
+{
+    defaultOptionsStorage() = options;
+}
+
+// ============================================================================
+// Stored bytes
+// ============================================================================
+
+std::vector<MeshDelta::Block> MeshDelta::pack(const uint8_t* raw, size_t size, const Options& options)
+{
+    const size_t blockCount = (size + PACK_BLOCK_BYTES - 1) / PACK_BLOCK_BYTES;
+    std::vector<Block> blocks(blockCount);
+
+    parallelFor(0, blockCount, [&](size_t blockBegin, size_t blockEnd) {
+        std::vector<uint8_t> planes;
+        for (size_t b = blockBegin; b < blockEnd; ++b) {
+            const uint8_t* in = raw + b * PACK_BLOCK_BYTES;
+            const size_t length = std::min(PACK_BLOCK_BYTES, size - b * PACK_BLOCK_BYTES);
+            Block& block = blocks[b];
+            block.rawSize = static_cast<uint32_t>(length);
+
+            if (options.compress) {
+                planes.resize(length);
+                toBytePlanes(in, planes.data(), length / 4);
+                QByteArray packed = qCompress(planes.data(), static_cast<qsizetype>(length), options.level);
+                if (static_cast<size_t>(packed.size()) < length) {
+                    block.data.assign(packed.constData(), packed.constData() + packed.size());
+                    block.dataSize = static_cast<uint32_t>(block.data.size());
+                    block.compressed = true;
+                    continue;
+                }
+            }
+            block.data.assign(in, in + length);
+            block.dataSize = block.rawSize;
+        }
+    }, 1);
+
+    return blocks;
+}
+
+bool MeshDelta::unpack(const std::vector<Block>& blocks, std::vector<uint8_t>& out)
+{
+    std::vector<size_t> offsets(blocks.size());
+    size_t offset = 0;
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        offsets[b] = offset;
+        offset += blocks[b].rawSize;
+    }
+    out.resize(offset);
+
+    std::atomic<bool> ok{true};
+    parallelFor(0, blocks.size(), [&](size_t blockBegin, size_t blockEnd) {
+        for (size_t b = blockBegin; b < blockEnd; ++b) {
+            const Block& block = blocks[b];
+            if (!block.compressed) {
+                if (block.data.size() != block.rawSize) {
+                    ok = false;
+                    continue;
+                }
+                std::memcpy(out.data() + offsets[b], block.data.data(), block.rawSize);
+                continue;
+            }
+            QByteArray planes = qUncompress(block.data.data(), static_cast<qsizetype>(block.data.size()));
+            if (static_cast<size_t>(planes.size()) != block.rawSize) {
+                ok = false;
+                continue;
+            }
+            fromBytePlanes(reinterpret_cast<const uint8_t*>(planes.constData()),
+                           out.data() + offsets[b], block.rawSize / 4);
+        }
+    }, 1);
+
+    return ok;
+}
+
+size_t MeshDelta::ArrayDelta::memoryUsage() const
+{
+    size_t bytes = sizeof(*this) + runs.capacity() * sizeof(Run);
+    for (const auto* blocks : {&changes, &beforeTail, &afterTail}) {
+        bytes += blocks->capacity() * sizeof(Block);
+        for (const Block& block : *blocks) {
+            bytes += block.data.capacity();
+        }
+    }
+    return bytes;
+}
+
+// ============================================================================
+// Per-array diff
+// ============================================================================
+
+template<typename T>
+MeshDelta::ArrayDelta MeshDelta::diffArray(const std::vector<T>& before, const std::vector<T>& after,
+                                           const Options& options)
+{
+    // All mesh arrays are made of 32-bit components (byte planes rely on it)
+    static_assert(sizeof(T) % 4 == 0, "MeshDelta arrays must hold 32-bit components");
+
+    ArrayDelta delta;
+    delta.beforeCount = before.size();
+    delta.afterCount = after.size();
+    const size_t shared = std::min(before.size(), after.size());
+
+    // Find changed runs per block, comparing bytes (so -0/+0 and NaNs count)
+    const size_t blockCount = (shared + COMPARE_BLOCK_ELEMENTS - 1) / COMPARE_BLOCK_ELEMENTS;
+    std::vector<std::vector<Run>> blockRuns(blockCount);
+    parallelFor(0, blockCount, [&](size_t blockBegin, size_t blockEnd) {
+        for (size_t b = blockBegin; b < blockEnd; ++b) {
+            std::vector<Run>& runs = blockRuns[b];
+            const size_t end = std::min(shared, (b + 1) * COMPARE_BLOCK_ELEMENTS);
+            for (size_t i = b * COMPARE_BLOCK_ELEMENTS; i < end; ++i) {
+                if (std::memcmp(&before[i], &after[i], sizeof(T)) == 0) continue;
+                if (!runs.empty() && i - (runs.back().first + runs.back().count) <= RUN_MERGE_GAP) {
+                    runs.back().count = i + 1 - runs.back().first;
+                } else {
+                    runs.push_back({i, 1});
+                }
+            }
+        }
+    }, 1);
+
+    // Concatenate, joining runs that meet across block boundaries
+    for (const auto& runs : blockRuns) {
+        for (const Run& run : runs) {
+            if (!delta.runs.empty() &&
+                run.first - (delta.runs.back().first + delta.runs.back().count) <= RUN_MERGE_GAP) {
+                delta.runs.back().count = run.first + run.count - delta.runs.back().first;
+            } else {
+                delta.runs.push_back(run);
+            }
+        }
+    }
+
+    if (!delta.runs.empty()) {
+        const std::vector<Piece> pieces = splitRuns(delta.runs);
+        const Piece& last = pieces.back();
+        std::vector<uint8_t> changes((last.offset + last.count) * sizeof(T));
+
+        const uint8_t* beforeBytes = reinterpret_cast<const uint8_t*>(before.data());
+        const uint8_t* afterBytes = reinterpret_cast<const uint8_t*>(after.data());
+        parallelFor(0, pieces.size(), [&](size_t pieceBegin, size_t pieceEnd) {
+            for (size_t p = pieceBegin; p < pieceEnd; ++p) {
+                const Piece& piece = pieces[p];
+                const uint8_t* a = beforeBytes + piece.first * sizeof(T);
+                const uint8_t* b = afterBytes + piece.first * sizeof(T);
+                uint8_t* out = changes.data() + piece.offset * sizeof(T);
+                for (size_t k = 0; k < piece.count * sizeof(T); ++k) {
+                    out[k] = a[k] ^ b[k];
+                }
+            }
+        });
+
+        delta.changes = pack(changes.data(), changes.size(), options);
+    }
+
+    if (before.size() > shared) {
+        delta.beforeTail = pack(reinterpret_cast<const uint8_t*>(before.data() + shared),
+                                (before.size() - shared) * sizeof(T), options);
+    }
+    if (after.size() > shared) {
+        delta.afterTail = pack(reinterpret_cast<const uint8_t*>(after.data() + shared),
+                               (after.size() - shared) * sizeof(T), options);
+    }
+
+    return delta;
+}
+
+bool MeshDelta::decodeArray(const ArrayDelta& delta, size_t elementSize, bool toBefore,
+                            DecodedArray& decoded)
+{
+    const uint64_t shared = std::min(delta.beforeCount, delta.afterCount);
+    const uint64_t target = toBefore ? delta.beforeCount : delta.afterCount;
+
+    uint64_t changed = 0;
+    for (const Run& run : delta.runs) {
+        changed += run.count;
+    }
+    if (!unpack(delta.changes, decoded.changes) || decoded.changes.size() != changed * elementSize) {
+        return false;
+    }
+
+    if (target > shared) {
+        if (!unpack(toBefore ? delta.beforeTail : delta.afterTail, decoded.tail) ||
+            decoded.tail.size() != (target - shared) * elementSize) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+void MeshDelta::applyArray(const ArrayDelta& delta, const DecodedArray& decoded,
+                           std::vector<T>& array, bool toBefore)
+{
+    const uint64_t shared = std::min(delta.beforeCount, delta.afterCount);
+
+    // XOR the changed runs (same bytes in both directions)
+    if (!delta.runs.empty()) {
+        const std::vector<Piece> pieces = splitRuns(delta.runs);
+        const std::vector<uint8_t>& changes = decoded.changes;
+
+        uint8_t* arrayBytes = reinterpret_cast<uint8_t*>(array.data());
+        parallelFor(0, pieces.size(), [&](size_t pieceBegin, size_t pieceEnd) {
+            for (size_t p = pieceBegin; p < pieceEnd; ++p) {
+                const Piece& piece = pieces[p];
+                uint8_t* out = arrayBytes + piece.first * sizeof(T);
+                const uint8_t* in = changes.data() + piece.offset * sizeof(T);
+                for (size_t k = 0; k < piece.count * sizeof(T); ++k) {
+                    out[k] ^= in[k];
+                }
+            }
+        });
+    }
+
+    // Cut or extend to the target length
+    const uint64_t target = toBefore ? delta.beforeCount : delta.afterCount;
+    array.resize(static_cast<size_t>(target));
+    if (target > shared) {
+        std::memcpy(array.data() + shared, decoded.tail.data(), decoded.tail.size());
+    }
+}
+
+// ============================================================================
+// MeshDelta
+// ============================================================================
+
+MeshDelta MeshDelta::compute(const geometry::MeshData& before,
+                             const geometry::MeshData& after,
+                             const Options& options)
+{
+    MeshDelta delta;
+    delta.vertices_ = diffArray(before.vertices(), after.vertices(), options);
+    delta.indices_ = diffArray(before.indices(), after.indices(), options);
+    delta.normals_ = diffArray(before.normals(), after.normals(), options);
+    delta.uvs_ = diffArray(before.uvs(), after.uvs(), options);
+    return delta;
+}
+
+bool MeshDelta::apply(geometry::MeshData& mesh, bool toBefore) const
+{
+    // The mesh must be in the state on the other side of the delta
+    auto matches = [toBefore](const ArrayDelta& delta, size_t size) {
+        return size == (toBefore ? delta.afterCount : delta.beforeCount);
+    };
+    const geometry::MeshData& current = mesh;
+    if (!matches(vertices_, current.vertices().size()) ||
+        !matches(indices_, current.indices().size()) ||
+        !matches(normals_, current.normals().size()) ||
+        !matches(uvs_, current.uvs().size())) {
+        return false;
+    }
+    
+    if (spilled_) {
+        MeshDelta loaded;
+        if (!loadSpilled(loaded)) {
+            qWarning() << "Undo data could not be read back from disk";
+            return false;
+        }
+        return loaded.apply(mesh, toBefore);
+    }
+
+    // Decode everything first: damaged data must leave the mesh untouched
+    DecodedArray vertices, indices, normals, uvs;
+    if (!decodeArray(vertices_, sizeof(glm::vec3), toBefore, vertices) ||
+        !decodeArray(indices_, sizeof(uint32_t), toBefore, indices) ||
+        !decodeArray(normals_, sizeof(glm::vec3), toBefore, normals) ||
+        !decodeArray(uvs_, sizeof(glm::vec2), toBefore, uvs)) {
+        qWarning() << "Undo data is damaged and could not be decoded";
+        return false;
+    }
+
+    applyArray(vertices_, vertices, mesh.editVertices(), toBefore);
+    applyArray(indices_, indices, mesh.editIndices(), toBefore);
+    applyArray(normals_, normals, mesh.editNormals(), toBefore);
+    applyArray(uvs_, uvs, mesh.editUVs(), toBefore);
+
+    if (!vertices_.isEmpty()) {
+        mesh.invalidateBounds();
+    }
+    return true;
+}
+
+bool MeshDelta::revert(geometry::MeshData& mesh) const
+{
+    return apply(mesh, true);
+}
+
+bool MeshDelta::reapply(geometry::MeshData& mesh) const
+{
+    return apply(mesh, false);
+}
+
+bool MeshDelta::isEmpty() const
+{
+    return vertices_.isEmpty() && indices_.isEmpty() && normals_.isEmpty() && uvs_.isEmpty();
+}
+
+size_t MeshDelta::memoryUsage() const
+{
+    return vertices_.memoryUsage() + indices_.memoryUsage() +
+           normals_.memoryUsage() + uvs_.memoryUsage();
+}
+
+// ============================================================================
+// Spilling
+// ============================================================================
+
+template<typename Visit>
+void MeshDelta::forEachBlock(Visit visit)
+{
+    for (ArrayDelta* array : {&vertices_, &indices_, &normals_, &uvs_}) {
+        for (auto* blocks : {&array->changes, &array->beforeTail, &array->afterTail}) {
+            for (Block& block : *blocks) {
+                visit(block);
+            }
+        }
+    }
+}
+
+size_t MeshDelta::spill(UndoSpillStore& store)
+{
+    if (spilled_) {
+        return 0;
+    }
+    
+    size_t total = 0;
+    forEachBlock([&total](Block& block) { total += block.dataSize; });
+    if (total == 0) {
+        return 0;
+    }
+    
+    // Release each block as it is gathered, so the bytes exist only once
+    const size_t before = memoryUsage();
+    std::vector<uint8_t> bytes;
+    bytes.reserve(total);
+    forEachBlock([&bytes](Block& block) {
+        bytes.insert(bytes.end(), block.data.begin(), block.data.end());
+        std::vector<uint8_t>().swap(block.data);
+    });
+    
+    // put() is the only check of the store's state: a background write may
+    // fail at any moment, and an unavailable store leaves the bytes with us
+    spilled_ = store.put(std::move(bytes));
+    if (!spilled_) {
+        size_t offset = 0;
+        forEachBlock([&bytes, &offset](Block& block) {
+            block.data.assign(bytes.begin() + offset, bytes.begin() + offset + block.dataSize);
+            offset += block.dataSize;
+        });
+        return 0;
+    }
+    return before - memoryUsage();
+}
+
+bool MeshDelta::loadSpilled(MeshDelta& loaded) const
+{
+    std::vector<uint8_t> bytes;
+    if (!spilled_->read(bytes)) {
+        return false;
+    }
+    
+    // Same layout with the block contents filled back in
+    loaded.vertices_ = vertices_;
+    loaded.indices_ = indices_;
+    loaded.normals_ = normals_;
+    loaded.uvs_ = uvs_;
+    
+    size_t offset = 0;
+    bool ok = true;
+    loaded.forEachBlock([&](Block& block) {
+        if (!ok || bytes.size() - offset < block.dataSize) {
+            ok = false;
+            return;
+        }
+        block.data.assign(bytes.begin() + offset, bytes.begin() + offset + block.dataSize);
+        offset += block.dataSize;
+    });
+    return ok && offset == bytes.size();
+}
+
+} // namespace core
+} // namespace dc3d
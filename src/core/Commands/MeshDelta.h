@@ -0,0 +1,146 @@
+/**
+ * @file MeshDelta.h
+ * @brief Compact record of the difference between two mesh states
+ *
+ * Used by the mesh edit commands in place of full before/after copies.
+ */
+
+#pragma once
+
+#include "../UndoSpillStore.h"
+#include "../../geometry/MeshData.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace dc3d {
+namespace core {
+
+/**
+ * @brief Difference between a mesh before and after an edit
+ *
+ * Each array (positions, indices, normals, UVs) is compared element by
+ * element over the length both states share. Changed runs are stored as
+ * the XOR of the two states, so the same bytes take the mesh from after to
+ * before and back again. Elements past the shared length are stored as-is
+ * for whichever side has them. An edit that moves a few thousand vertices
+ * of a scan costs kilobytes; one that rebuilds the mesh (decimation,
+ * subdivision) costs at most one copy of it instead of two.
+ *
+ * With compression on, the stored bytes are split into byte planes and
+ * zlib-compressed in blocks. Small vertex moves leave the sign/exponent
+ * planes of the XOR almost entirely zero, so they shrink to next to nothing.
+ *
+ * A delta only applies to the state it was computed against: revert()
+ * expects the mesh as it was after the edit, reapply() as it was before.
+ * Both check the array sizes and leave the mesh untouched on a mismatch.
+ *
+ * spill() moves the stored bytes to an UndoSpillStore; revert() and
+ * reapply() then read them back for the duration of the call.
+ */
+class MeshDelta {
+public:
+    struct Options {
+        bool compress = true;   ///< zlib-compress stored bytes
+        int level = 1;          ///< zlib level (1 = fastest, 9 = smallest)
+    };
+
+    /// Options used when none are passed to compute() (set once at startup)
+    static const Options& defaultOptions();
+    static void setDefaultOptions(const Options& options);
+
+    MeshDelta() = default;
+
+    /**
+     * @brief Record the difference between two states of a mesh
+     */
+    static MeshDelta compute(const geometry::MeshData& before,
+                             const geometry::MeshData& after,
+                             const Options& options = defaultOptions());
+
+    /// Turn the after state back into the before state
+    bool revert(geometry::MeshData& mesh) const;
+
+    /// Turn the before state into the after state
+    bool reapply(geometry::MeshData& mesh) const;
+
+    /// True if both states were identical
+    bool isEmpty() const;
+
+    /// Bytes held by the delta in memory
+    size_t memoryUsage() const;
+    
+    /**
+     * @brief Move the stored bytes to disk
+     * @return Bytes of memory freed (0 if already spilled, nothing to move or
+     *         the store is unavailable; the bytes then stay in memory)
+     */
+    size_t spill(UndoSpillStore& store);
+    
+    /// True if the stored bytes live in a spill store
+    bool isSpilled() const { return spilled_ != nullptr; }
+
+private:
+    /// Range of changed elements
+    struct Run {
+        uint64_t first = 0;
+        uint64_t count = 0;
+    };
+
+    /// Stored bytes, compressed or not
+    struct Block {
+        std::vector<uint8_t> data;
+        uint32_t rawSize = 0;
+        uint32_t dataSize = 0;      ///< data.size(), kept while spilled
+        bool compressed = false;
+    };
+
+    struct ArrayDelta {
+        uint64_t beforeCount = 0;
+        uint64_t afterCount = 0;
+        std::vector<Run> runs;              ///< Changed runs within the shared length
+        std::vector<Block> changes;         ///< XOR of before and after over the runs
+        std::vector<Block> beforeTail;      ///< before[shared, beforeCount)
+        std::vector<Block> afterTail;       ///< after[shared, afterCount)
+
+        bool isEmpty() const { return beforeCount == afterCount && runs.empty(); }
+        size_t memoryUsage() const;
+    };
+
+    template<typename T>
+    static ArrayDelta diffArray(const std::vector<T>& before, const std::vector<T>& after,
+                                const Options& options);
+
+    /// Stored bytes of one array, decompressed before anything is changed
+    struct DecodedArray {
+        std::vector<uint8_t> changes;       ///< XOR over the runs
+        std::vector<uint8_t> tail;          ///< Elements past the shared length
+    };
+
+    static bool decodeArray(const ArrayDelta& delta, size_t elementSize, bool toBefore,
+                            DecodedArray& decoded);
+
+    template<typename T>
+    static void applyArray(const ArrayDelta& delta, const DecodedArray& decoded,
+                           std::vector<T>& array, bool toBefore);
+
+    static std::vector<Block> pack(const uint8_t* raw, size_t size, const Options& options);
+    static bool unpack(const std::vector<Block>& blocks, std::vector<uint8_t>& out);
+
+    template<typename Visit>
+    void forEachBlock(Visit visit);
+    
+    bool loadSpilled(MeshDelta& loaded) const;
+    bool apply(geometry::MeshData& mesh, bool toBefore) const;
+
+    ArrayDelta vertices_;
+    ArrayDelta indices_;
+    ArrayDelta normals_;
+    ArrayDelta uvs_;
+    
+    std::unique_ptr<UndoSpillStore::Entry> spilled_;
+};
+
+} // namespace core
+} // namespace dc3d
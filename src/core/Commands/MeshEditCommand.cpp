@@ -2,14 +2,13 @@
  * @file MeshEditCommand.cpp
  * @brief Implementation of mesh editing commands
  * 
- * Memory Note: MeshEditCommand stores both beforeMesh_ and afterMesh_, doubling
- * memory usage for large meshes. This is intentional for correctness when:
- * - Operations may not be deterministic
- * - User edits the mesh after command execution
- * 
- * For memory-constrained applications, consider storing lightweight deltas instead
- * of full mesh copies, or use streaming undo where only the last N commands store
- * full state and older commands just store operations.
+ * Memory Note: Commands keep a MeshDelta (XOR of the changed runs plus
+ * any added/removed tail, optionally compressed) rather than copies of the
+ * mesh. The full before state exists only while execute() runs. A delta
+ * applies only to the state it was recorded against, so edits that bypass
+ * the undo history leave older commands unable to undo (they log a
+ * warning and leave the mesh as is). Over its memory budget, CommandHistory
+ * can page the oldest deltas out to disk instead of discarding them.
  */
 
 #include "MeshEditCommand.h"
@@ -22,6 +21,25 @@
 namespace dc3d {
 namespace core {
 
+namespace {
+
+CommandHistory::SpillOptions& defaultSpillOptionsStorage()
+{
+    static CommandHistory::SpillOptions options;
+    return options;
+}
+
+// Undo a recorded edit, warning if the mesh no longer matches it
+void revertDelta(const MeshDelta& delta, geometry::MeshData& mesh, const QString& what)
+{
+    if (!delta.isEmpty() && !delta.revert(mesh)) {
+        qWarning() << "Cannot undo" << what
+                   << "- mesh was modified outside the undo history or the undo data is damaged";
+    }
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // MeshEditCommand Implementation
 // ============================================================================
@@ -47,24 +65,24 @@ CommandPtr MeshEditCommand::create(
 }
 
 void MeshEditCommand::execute() {
-    // Store current state
-    beforeMesh_ = mesh_;
+    // Keep the current state only until the delta is recorded
+    geometry::MeshData before = mesh_;
     
     // Apply operation
     if (!operation_(mesh_)) {
         // Operation failed, restore
-        mesh_ = beforeMesh_;
+        mesh_ = std::move(before);
         return;
     }
     
-    // Store result for redo
-    afterMesh_ = mesh_;
+    // Record the change for undo/redo
+    delta_ = MeshDelta::compute(before, mesh_);
     executed_ = true;
 }
 
 void MeshEditCommand::undo() {
     if (!executed_) return;
-    mesh_ = beforeMesh_;
+    revertDelta(delta_, mesh_, name_);
 }
 
 void MeshEditCommand::redo() {
@@ -72,13 +90,17 @@ void MeshEditCommand::redo() {
         execute();
         return;
     }
-    mesh_ = afterMesh_;
+    if (!delta_.isEmpty() && !delta_.reapply(mesh_)) {
+        qWarning() << "Cannot redo" << name_ << "- mesh was modified outside the undo history";
+    }
 }
 
 size_t MeshEditCommand::memoryUsage() const {
-    return sizeof(*this) + 
-           beforeMesh_.memoryUsage() + 
-           afterMesh_.memoryUsage();
+    return sizeof(*this) + delta_.memoryUsage();
+}
+
+size_t MeshEditCommand::spill(UndoSpillStore& store) {
+    return delta_.spill(store);
 }
 
 // ============================================================================
@@ -95,7 +117,8 @@ DecimateCommand::DecimateCommand(
 }
 
 void DecimateCommand::execute() {
-    beforeMesh_ = mesh_;
+    geometry::MeshData before = mesh_;
+    delta_ = MeshDelta();
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
@@ -106,20 +129,21 @@ void DecimateCommand::execute() {
     executionTimeMs_ = duration.count();
     
     if (!result.ok()) {
-        mesh_ = beforeMesh_;
+        mesh_ = std::move(before);
         qWarning() << "Polygon reduction failed:" << QString::fromStdString(result.error);
         return;
     }
     
     mesh_ = std::move(result.value->first);
     result_ = result.value->second;
+    delta_ = MeshDelta::compute(before, mesh_);
     
     qDebug() << "Polygon reduction complete (" << executionTimeMs_ / 1000.0 << "seconds)"
              << "- reduced from" << result_.originalFaces << "to" << result_.finalFaces << "faces";
 }
 
 void DecimateCommand::undo() {
-    mesh_ = beforeMesh_;
+    revertDelta(delta_, mesh_, description());
 }
 
 QString DecimateCommand::description() const {
@@ -141,7 +165,11 @@ QString DecimateCommand::description() const {
 }
 
 size_t DecimateCommand::memoryUsage() const {
-    return sizeof(*this) + beforeMesh_.memoryUsage();
+    return sizeof(*this) + delta_.memoryUsage();
+}
+
+size_t DecimateCommand::spill(UndoSpillStore& store) {
+    return delta_.spill(store);
 }
 
 // ============================================================================
@@ -158,11 +186,13 @@ SmoothCommand::SmoothCommand(
 }
 
 void SmoothCommand::execute() {
-    beforeMesh_ = mesh_;
+    geometry::MeshData before = mesh_;
+    delta_ = MeshDelta();
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
     result_ = geometry::MeshSmoother::smooth(mesh_, options_, nullptr);
+    delta_ = MeshDelta::compute(before, mesh_);
     
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
@@ -174,7 +204,7 @@ void SmoothCommand::execute() {
 }
 
 void SmoothCommand::undo() {
-    mesh_ = beforeMesh_;
+    revertDelta(delta_, mesh_, description());
 }
 
 QString SmoothCommand::description() const {
@@ -201,7 +231,11 @@ QString SmoothCommand::description() const {
 }
 
 size_t SmoothCommand::memoryUsage() const {
-    return sizeof(*this) + beforeMesh_.memoryUsage();
+    return sizeof(*this) + delta_.memoryUsage();
+}
+
+size_t SmoothCommand::spill(UndoSpillStore& store) {
+    return delta_.spill(store);
 }
 
 bool SmoothCommand::canMergeWith(const Command* other) const {
@@ -248,7 +282,8 @@ RepairCommand::RepairCommand(
 }
 
 void RepairCommand::execute() {
-    beforeMesh_ = mesh_;
+    geometry::MeshData before = mesh_;
+    delta_ = MeshDelta();
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
@@ -294,6 +329,7 @@ void RepairCommand::execute() {
                 nullptr);
             break;
     }
+    delta_ = MeshDelta::compute(before, mesh_);
     
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
@@ -304,7 +340,7 @@ void RepairCommand::execute() {
 }
 
 void RepairCommand::undo() {
-    mesh_ = beforeMesh_;
+    revertDelta(delta_, mesh_, description());
 }
 
 QString RepairCommand::description() const {
@@ -326,7 +362,11 @@ QString RepairCommand::description() const {
 }
 
 size_t RepairCommand::memoryUsage() const {
-    return sizeof(*this) + beforeMesh_.memoryUsage();
+    return sizeof(*this) + delta_.memoryUsage();
+}
+
+size_t RepairCommand::spill(UndoSpillStore& store) {
+    return delta_.spill(store);
 }
 
 // ============================================================================
@@ -343,7 +383,8 @@ SubdivideCommand::SubdivideCommand(
 }
 
 void SubdivideCommand::execute() {
-    beforeMesh_ = mesh_;
+    geometry::MeshData before = mesh_;
+    delta_ = MeshDelta();
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
@@ -354,20 +395,21 @@ void SubdivideCommand::execute() {
     executionTimeMs_ = duration.count();
     
     if (!result.ok()) {
-        mesh_ = beforeMesh_;
+        mesh_ = std::move(before);
         qWarning() << "Subdivision failed:" << QString::fromStdString(result.error);
         return;
     }
     
     mesh_ = std::move(result.value->first);
     result_ = result.value->second;
+    delta_ = MeshDelta::compute(before, mesh_);
     
     qDebug() << "Subdivision complete (" << executionTimeMs_ / 1000.0 << "seconds)"
              << "- increased from" << result_.originalFaces << "to" << result_.finalFaces << "faces";
 }
 
 void SubdivideCommand::undo() {
-    mesh_ = beforeMesh_;
+    revertDelta(delta_, mesh_, description());
 }
 
 QString SubdivideCommand::description() const {
@@ -394,7 +436,11 @@ QString SubdivideCommand::description() const {
 }
 
 size_t SubdivideCommand::memoryUsage() const {
-    return sizeof(*this) + beforeMesh_.memoryUsage();
+    return sizeof(*this) + delta_.memoryUsage();
+}
+
+size_t SubdivideCommand::spill(UndoSpillStore& store) {
+    return delta_.spill(store);
 }
 
 // ============================================================================
@@ -440,12 +486,29 @@ size_t CompoundCommand::memoryUsage() const {
     return total;
 }
 
+size_t CompoundCommand::spill(UndoSpillStore& store) {
+    size_t freed = 0;
+    for (auto& cmd : commands_) {
+        freed += cmd->spill(store);
+    }
+    return freed;
+}
+
 // ============================================================================
 // CommandHistory Implementation
 // ============================================================================
 
+const CommandHistory::SpillOptions& CommandHistory::defaultSpillOptions() {
+    return defaultSpillOptionsStorage();
+}
+
+void CommandHistory::setDefaultSpillOptions(const SpillOptions& options) {
+    defaultSpillOptionsStorage() = options;
+}
+
 CommandHistory::CommandHistory(size_t maxMemoryBytes)
     : maxMemoryBytes_(maxMemoryBytes)
+    , spillOptions_(defaultSpillOptions())
 {
 }
 
@@ -527,7 +590,9 @@ void CommandHistory::clear() {
 }
 
 size_t CommandHistory::memoryUsage() const {
-    return currentMemoryUsage_;
+    // Spilled state whose write failed is still in memory
+    return currentMemoryUsage_ +
+           (spillStore_ ? static_cast<size_t>(spillStore_->memoryUsage()) : 0);
 }
 
 void CommandHistory::setMaxMemory(size_t bytes) {
@@ -535,16 +600,62 @@ void CommandHistory::setMaxMemory(size_t bytes) {
     trimToMemoryLimit();
 }
 
+void CommandHistory::setSpillOptions(const SpillOptions& options) {
+    // Spilled commands keep their entries; only new spills use a new directory
+    if (options.directory != spillOptions_.directory) {
+        spillStore_.reset();
+    }
+    spillOptions_ = options;
+    trimToMemoryLimit();
+}
+
+size_t CommandHistory::diskUsage() const {
+    return spillStore_ ? static_cast<size_t>(spillStore_->diskUsage()) : 0;
+}
+
+void CommandHistory::spillToDisk() {
+    // Oldest first: those are the least likely to be undone. Writes finish
+    // in the background; once one fails the store turns unavailable, its
+    // bytes count as memory again and the trim below discards commands.
+    for (auto& cmd : undoStack_) {
+        if (memoryUsage() <= maxMemoryBytes_) break;
+        if (!spillStore_) {
+            spillStore_ = std::make_unique<UndoSpillStore>(spillOptions_.directory);
+        }
+        if (!spillStore_->isAvailable()) break;
+        currentMemoryUsage_ -= cmd->spill(*spillStore_);
+    }
+}
+
 void CommandHistory::trimToMemoryLimit() {
-    // First try removing old undo commands (oldest first)
-    while (currentMemoryUsage_ > maxMemoryBytes_ && !undoStack_.empty()) {
+    // Page old commands out to disk before discarding any
+    if (spillOptions_.enabled) {
+        spillToDisk();
+    }
+    
+    // Over the disk budget: discard the oldest commands (the spilled ones).
+    // Undone commands keep their spill entries on the redo stack, where
+    // popping the undo stack never frees them; like below, redo goes first.
+    if (diskUsage() > spillOptions_.maxDiskBytes && !redoStack_.empty()) {
+        for (const auto& cmd : redoStack_) {
+            currentMemoryUsage_ -= cmd->memoryUsage();
+        }
+        redoStack_.clear();
+    }
+    while (diskUsage() > spillOptions_.maxDiskBytes && !undoStack_.empty()) {
+        currentMemoryUsage_ -= undoStack_.front()->memoryUsage();
+        undoStack_.erase(undoStack_.begin());
+    }
+    
+    // Then remove old undo commands until within memory (oldest first)
+    while (memoryUsage() > maxMemoryBytes_ && !undoStack_.empty()) {
         currentMemoryUsage_ -= undoStack_.front()->memoryUsage();
         undoStack_.erase(undoStack_.begin());
     }
     
     // If still over limit, clear the redo stack entirely
     // (redo is less important than recent undo)
-    if (currentMemoryUsage_ > maxMemoryBytes_ && !redoStack_.empty()) {
+    if (memoryUsage() > maxMemoryBytes_ && !redoStack_.empty()) {
         for (const auto& cmd : redoStack_) {
             currentMemoryUsage_ -= cmd->memoryUsage();
         }
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "../Command.h"
+#include "MeshDelta.h"
+#include "../UndoSpillStore.h"
 #include "../../geometry/MeshData.h"
 #include "../../geometry/MeshDecimation.h"
 #include "../../geometry/MeshSmoothing.h"
@@ -20,6 +22,7 @@
 #include <functional>
 #include <variant>
 #include <chrono>
+#include <filesystem>
 
 namespace dc3d {
 namespace core {
@@ -57,10 +60,11 @@ private:
 };
 
 /**
- * @brief Generic mesh edit command that stores before/after mesh state
+ * @brief Generic mesh edit command that stores what the edit changed
  * 
- * This command stores a complete copy of the mesh before and after
- * the operation, enabling full undo/redo capability.
+ * The mesh is copied only while the operation runs; afterwards the command
+ * keeps a MeshDelta between the two states, which both undo and redo apply
+ * to the mesh in place.
  * 
  * Usage:
  * @code
@@ -119,12 +123,10 @@ public:
     QString category() const override { return QStringLiteral("Mesh Edit"); }
     
     size_t memoryUsage() const override;
+    size_t spill(UndoSpillStore& store) override;
     
-    /// Get the mesh before the operation
-    const geometry::MeshData& beforeMesh() const { return beforeMesh_; }
-    
-    /// Get the mesh after the operation
-    const geometry::MeshData& afterMesh() const { return afterMesh_; }
+    /// Get the recorded change
+    const MeshDelta& delta() const { return delta_; }
     
 private:
     MeshEditCommand(
@@ -136,8 +138,7 @@ private:
     QString name_;
     EditFunction operation_;
     
-    geometry::MeshData beforeMesh_;
-    geometry::MeshData afterMesh_;
+    MeshDelta delta_;
     bool executed_ = false;
 };
 
@@ -160,6 +161,7 @@ public:
     QString description() const override;
     QString category() const override { return QStringLiteral("Mesh Edit"); }
     size_t memoryUsage() const override;
+    size_t spill(UndoSpillStore& store) override;
     
     /// Get decimation result statistics
     const geometry::DecimationResult& result() const { return result_; }
@@ -170,7 +172,7 @@ public:
 private:
     geometry::MeshData& mesh_;
     geometry::DecimationOptions options_;
-    geometry::MeshData beforeMesh_;
+    MeshDelta delta_;
     geometry::DecimationResult result_;
     int64_t executionTimeMs_ = 0;
 };
@@ -190,6 +192,7 @@ public:
     QString description() const override;
     QString category() const override { return QStringLiteral("Mesh Edit"); }
     size_t memoryUsage() const override;
+    size_t spill(UndoSpillStore& store) override;
     
     bool canMergeWith(const Command* other) const override;
     bool mergeWith(const Command* other) override;
@@ -203,7 +206,7 @@ public:
 private:
     geometry::MeshData& mesh_;
     geometry::SmoothingOptions options_;
-    geometry::MeshData beforeMesh_;
+    MeshDelta delta_;
     geometry::SmoothingResult result_;
     int64_t executionTimeMs_ = 0;
 };
@@ -233,6 +236,7 @@ public:
     QString description() const override;
     QString category() const override { return QStringLiteral("Mesh Repair"); }
     size_t memoryUsage() const override;
+    size_t spill(UndoSpillStore& store) override;
     
     /// Get repair result
     const geometry::RepairResult& result() const { return result_; }
@@ -244,7 +248,7 @@ private:
     geometry::MeshData& mesh_;
     Operation operation_;
     float parameter_;
-    geometry::MeshData beforeMesh_;
+    MeshDelta delta_;
     geometry::RepairResult result_;
     int64_t executionTimeMs_ = 0;
 };
@@ -264,6 +268,7 @@ public:
     QString description() const override;
     QString category() const override { return QStringLiteral("Mesh Edit"); }
     size_t memoryUsage() const override;
+    size_t spill(UndoSpillStore& store) override;
     
     /// Get subdivision result
     const geometry::SubdivisionResult& result() const { return result_; }
@@ -274,7 +279,7 @@ public:
 private:
     geometry::MeshData& mesh_;
     geometry::SubdivisionOptions options_;
-    geometry::MeshData beforeMesh_;
+    MeshDelta delta_;
     geometry::SubdivisionResult result_;
     int64_t executionTimeMs_ = 0;
 };
@@ -303,6 +308,7 @@ public:
     QString description() const override { return name_; }
     QString category() const override { return QStringLiteral("Compound"); }
     size_t memoryUsage() const override;
+    size_t spill(UndoSpillStore& store) override;
     
 private:
     QString name_;
@@ -316,9 +322,24 @@ private:
 
 /**
  * @brief Manages command history for undo/redo
+ * 
+ * Stored command state is limited to maxMemory(). With spilling enabled,
+ * the oldest commands' state is first moved to an UndoSpillStore on disk
+ * (up to SpillOptions::maxDiskBytes) and read back when they are undone;
+ * commands are discarded only once both budgets are used up.
  */
 class CommandHistory {
 public:
+    struct SpillOptions {
+        bool enabled = false;                   ///< Page old commands out to disk
+        size_t maxDiskBytes = size_t(8) << 30;  ///< Disk budget for paged-out state
+        std::filesystem::path directory;        ///< Where to put the temp files (empty = system temp)
+    };
+    
+    /// Spill options of newly created histories (set once at startup)
+    static const SpillOptions& defaultSpillOptions();
+    static void setDefaultSpillOptions(const SpillOptions& options);
+    
     CommandHistory(size_t maxMemoryBytes = 100 * 1024 * 1024);  // 100MB default
     
     /// Execute and record a command
@@ -354,6 +375,15 @@ public:
     /// Set maximum memory limit
     void setMaxMemory(size_t bytes);
     
+    /// Get disk spilling options
+    const SpillOptions& spillOptions() const { return spillOptions_; }
+    
+    /// Set disk spilling options (state already on disk stays where it is)
+    void setSpillOptions(const SpillOptions& options);
+    
+    /// Get bytes of command state currently paged out to disk
+    size_t diskUsage() const;
+    
     /// Get number of undoable commands
     size_t undoCount() const { return undoStack_.size(); }
     
@@ -371,8 +401,11 @@ private:
     std::vector<CommandPtr> redoStack_;
     size_t maxMemoryBytes_;
     size_t currentMemoryUsage_ = 0;
+    SpillOptions spillOptions_;
+    std::unique_ptr<UndoSpillStore> spillStore_;  // Created on first spill
     HistoryChangedCallback historyChangedCallback_;
     
+    void spillToDisk();
     void trimToMemoryLimit();
     void notifyHistoryChanged();
 };
@@ -9,10 +9,338 @@
 
 #include "Selection.h"
 #include <algorithm>
+#include <iterator>
 
 namespace dc3d {
 namespace core {
 
+namespace {
+
+// Sort and drop duplicates
+void sortUnique(std::vector<uint64_t>& indices)
+{
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
+// Sort and keep indices listed an odd number of times (toggling twice is a no-op)
+void sortOddOccurrences(std::vector<uint64_t>& indices)
+{
+    std::sort(indices.begin(), indices.end());
+    size_t out = 0;
+    for (size_t i = 0; i < indices.size();) {
+        size_t j = i + 1;
+        while (j < indices.size() && indices[j] == indices[i]) ++j;
+        if ((j - i) % 2 == 1) {
+            indices[out++] = indices[i];
+        }
+        i = j;
+    }
+    indices.resize(out);
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// SelectionSet
+// ============================================================================
+
+bool SelectionSet::contains(uint64_t index) const
+{
+    if (m_dense) {
+        return index / 64 < m_words.size() && (m_words[index / 64] >> (index % 64)) & 1;
+    }
+    return std::binary_search(m_sparse.begin(), m_sparse.end(), index);
+}
+
+bool SelectionSet::insert(uint64_t index)
+{
+    if (m_dense && index >= DENSE_INDEX_LIMIT) {
+        makeSparse();
+    }
+    
+    if (m_dense) {
+        reserveBits(index);
+        uint64_t& word = m_words[index / 64];
+        uint64_t bit = uint64_t(1) << (index % 64);
+        if (word & bit) return false;
+        word |= bit;
+    } else {
+        auto it = std::lower_bound(m_sparse.begin(), m_sparse.end(), index);
+        if (it != m_sparse.end() && *it == index) return false;
+        m_sparse.insert(it, index);
+    }
+    
+    ++m_count;
+    updateLayout();
+    return true;
+}
+
+bool SelectionSet::erase(uint64_t index)
+{
+    if (m_dense) {
+        if (index / 64 >= m_words.size()) return false;
+        uint64_t& word = m_words[index / 64];
+        uint64_t bit = uint64_t(1) << (index % 64);
+        if (!(word & bit)) return false;
+        word &= ~bit;
+    } else {
+        auto it = std::lower_bound(m_sparse.begin(), m_sparse.end(), index);
+        if (it == m_sparse.end() || *it != index) return false;
+        m_sparse.erase(it);
+    }
+    
+    --m_count;
+    updateLayout();
+    return true;
+}
+
+size_t SelectionSet::insert(const std::vector<uint64_t>& sortedIndices)
+{
+    if (sortedIndices.empty()) return 0;
+    if (m_dense && sortedIndices.back() >= DENSE_INDEX_LIMIT) {
+        makeSparse();
+    }
+    
+    size_t added = 0;
+    if (m_dense) {
+        reserveBits(sortedIndices.back());
+        for (uint64_t index : sortedIndices) {
+            uint64_t& word = m_words[index / 64];
+            uint64_t bit = uint64_t(1) << (index % 64);
+            added += (word & bit) ? 0 : 1;
+            word |= bit;
+        }
+    } else {
+        std::vector<uint64_t> merged;
+        merged.reserve(m_sparse.size() + sortedIndices.size());
+        std::set_union(m_sparse.begin(), m_sparse.end(),
+                       sortedIndices.begin(), sortedIndices.end(), std::back_inserter(merged));
+        added = merged.size() - m_sparse.size();
+        m_sparse.swap(merged);
+    }
+    
+    m_count += added;
+    updateLayout();
+    return added;
+}
+
+size_t SelectionSet::erase(const std::vector<uint64_t>& sortedIndices)
+{
+    if (sortedIndices.empty() || m_count == 0) return 0;
+    
+    size_t removed = 0;
+    if (m_dense) {
+        for (uint64_t index : sortedIndices) {
+            if (index / 64 >= m_words.size()) break;
+            uint64_t& word = m_words[index / 64];
+            uint64_t bit = uint64_t(1) << (index % 64);
+            removed += (word & bit) ? 1 : 0;
+            word &= ~bit;
+        }
+    } else {
+        std::vector<uint64_t> remaining;
+        remaining.reserve(m_sparse.size());
+        std::set_difference(m_sparse.begin(), m_sparse.end(),
+                            sortedIndices.begin(), sortedIndices.end(), std::back_inserter(remaining));
+        removed = m_sparse.size() - remaining.size();
+        m_sparse.swap(remaining);
+    }
+    
+    m_count -= removed;
+    updateLayout();
+    return removed;
+}
+
+void SelectionSet::toggle(const std::vector<uint64_t>& sortedIndices)
+{
+    if (sortedIndices.empty()) return;
+    if (m_dense && sortedIndices.back() >= DENSE_INDEX_LIMIT) {
+        makeSparse();
+    }
+    
+    if (m_dense) {
+        reserveBits(sortedIndices.back());
+        for (uint64_t index : sortedIndices) {
+            uint64_t& word = m_words[index / 64];
+            uint64_t bit = uint64_t(1) << (index % 64);
+            if (word & bit) --m_count; else ++m_count;
+            word ^= bit;
+        }
+    } else {
+        std::vector<uint64_t> result;
+        result.reserve(m_sparse.size() + sortedIndices.size());
+        std::set_symmetric_difference(m_sparse.begin(), m_sparse.end(),
+                                      sortedIndices.begin(), sortedIndices.end(),
+                                      std::back_inserter(result));
+        m_sparse.swap(result);
+        m_count = m_sparse.size();
+    }
+    
+    updateLayout();
+}
+
+template<typename Op>
+int64_t SelectionSet::applyToRange(uint64_t first, uint64_t last, Op op)
+{
+    int64_t delta = 0;
+    const uint64_t firstWord = first / 64;
+    const uint64_t lastWord = (last - 1) / 64;
+    for (uint64_t w = firstWord; w <= lastWord; ++w) {
+        uint64_t mask = ~uint64_t(0);
+        if (w == firstWord) mask &= ~uint64_t(0) << (first % 64);
+        if (w == lastWord) mask &= ~uint64_t(0) >> (63 - (last - 1) % 64);
+        
+        uint64_t& word = m_words[w];
+        const size_t before = bitCount(word);
+        word = op(word, mask);
+        delta += static_cast<int64_t>(bitCount(word)) - static_cast<int64_t>(before);
+    }
+    return delta;
+}
+
+size_t SelectionSet::insertRange(uint64_t first, uint64_t last)
+{
+    if (first >= last) return 0;
+    
+    // Large ranges go straight to a bitset when the indices allow it
+    if (!m_dense && last - first > SPARSE_LIMIT) {
+        makeDense(std::max(last - 1, m_sparse.empty() ? 0 : m_sparse.back()));
+    }
+    if (m_dense && last > DENSE_INDEX_LIMIT) {
+        makeSparse();
+    }
+    
+    if (!m_dense) {
+        std::vector<uint64_t> indices;
+        indices.reserve(static_cast<size_t>(last - first));
+        for (uint64_t i = first; i < last; ++i) indices.push_back(i);
+        return insert(indices);
+    }
+    
+    reserveBits(last - 1);
+    const int64_t added = applyToRange(first, last, [](uint64_t word, uint64_t mask) {
+        return word | mask;
+    });
+    m_count += static_cast<size_t>(added);
+    updateLayout();
+    return static_cast<size_t>(added);
+}
+
+size_t SelectionSet::eraseRange(uint64_t first, uint64_t last)
+{
+    if (first >= last || m_count == 0) return 0;
+    
+    size_t removed = 0;
+    if (m_dense) {
+        last = std::min<uint64_t>(last, static_cast<uint64_t>(m_words.size()) * 64);
+        if (first >= last) return 0;
+        removed = static_cast<size_t>(-applyToRange(first, last, [](uint64_t word, uint64_t mask) {
+            return word & ~mask;
+        }));
+    } else {
+        auto begin = std::lower_bound(m_sparse.begin(), m_sparse.end(), first);
+        auto end = std::lower_bound(begin, m_sparse.end(), last);
+        removed = static_cast<size_t>(end - begin);
+        m_sparse.erase(begin, end);
+    }
+    
+    m_count -= removed;
+    updateLayout();
+    return removed;
+}
+
+void SelectionSet::toggleRange(uint64_t first, uint64_t last)
+{
+    if (first >= last) return;
+    
+    if (!m_dense && last - first > SPARSE_LIMIT) {
+        makeDense(std::max(last - 1, m_sparse.empty() ? 0 : m_sparse.back()));
+    }
+    if (m_dense && last > DENSE_INDEX_LIMIT) {
+        makeSparse();
+    }
+    
+    if (!m_dense) {
+        std::vector<uint64_t> indices;
+        indices.reserve(static_cast<size_t>(last - first));
+        for (uint64_t i = first; i < last; ++i) indices.push_back(i);
+        toggle(indices);
+        return;
+    }
+    
+    reserveBits(last - 1);
+    const int64_t delta = applyToRange(first, last, [](uint64_t word, uint64_t mask) {
+        return word ^ mask;
+    });
+    m_count = static_cast<size_t>(static_cast<int64_t>(m_count) + delta);
+    updateLayout();
+}
+
+void SelectionSet::clear()
+{
+    m_dense = false;
+    m_count = 0;
+    m_sparse.clear();
+    m_words.clear();
+}
+
+void SelectionSet::updateLayout()
+{
+    if (m_dense) {
+        // Hysteresis: go back to a list well below the limit
+        if (m_count <= SPARSE_LIMIT / 2) {
+            makeSparse();
+        }
+    } else if (m_count > SPARSE_LIMIT) {
+        // A bitset is no larger than the list once 1/64 of the range is selected
+        const uint64_t maxIndex = m_sparse.back();
+        if (maxIndex / 64 < m_count) {
+            makeDense(maxIndex);
+        }
+    }
+}
+
+bool SelectionSet::makeDense(uint64_t maxIndex)
+{
+    if (m_dense) return true;
+    if (maxIndex >= DENSE_INDEX_LIMIT) return false;
+    
+    m_words.assign(static_cast<size_t>(maxIndex / 64 + 1), 0);
+    for (uint64_t index : m_sparse) {
+        m_words[index / 64] |= uint64_t(1) << (index % 64);
+    }
+    m_sparse.clear();
+    m_sparse.shrink_to_fit();
+    m_dense = true;
+    return true;
+}
+
+void SelectionSet::makeSparse()
+{
+    if (!m_dense) return;
+    
+    std::vector<uint64_t> indices;
+    indices.reserve(m_count);
+    forEach([&indices](uint64_t index) { indices.push_back(index); });
+    m_sparse.swap(indices);
+    m_words.clear();
+    m_words.shrink_to_fit();
+    m_dense = false;
+}
+
+void SelectionSet::reserveBits(uint64_t maxIndex)
+{
+    const size_t words = static_cast<size_t>(maxIndex / 64 + 1);
+    if (m_words.size() < words) {
+        m_words.resize(words, 0);
+    }
+}
+
+// ============================================================================
+// Selection
+// ============================================================================
+
 Selection::Selection(QObject* parent)
     : QObject(parent)
 {
@@ -22,8 +350,8 @@ void Selection::setMode(SelectionMode mode)
 {
     if (m_mode != mode) {
         // Clear selection when changing modes
-        if (!m_selectedElements.empty()) {
-            m_selectedElements.clear();
+        if (!m_sets.empty()) {
+            m_sets.clear();
             emit selectionChanged();
         }
         
@@ -32,41 +360,86 @@ void Selection::setMode(SelectionMode mode)
     }
 }
 
+void Selection::removeIfEmpty(uint64_t key)
+{
+    auto it = m_sets.find(key);
+    if (it != m_sets.end() && it->second.empty()) {
+        m_sets.erase(it);
+    }
+}
+
+bool Selection::applyToSet(uint64_t key, const std::vector<uint64_t>& sortedIndices, SelectionOp op)
+{
+    if (sortedIndices.empty()) {
+        return false;
+    }
+    
+    bool changed = false;
+    
+    switch (op) {
+        case SelectionOp::Replace:
+        case SelectionOp::Add:
+            changed = m_sets[key].insert(sortedIndices) > 0;
+            break;
+            
+        case SelectionOp::Toggle:
+            m_sets[key].toggle(sortedIndices);
+            changed = true;
+            break;
+            
+        case SelectionOp::Remove:
+            {
+                auto it = m_sets.find(key);
+                if (it != m_sets.end()) {
+                    changed = it->second.erase(sortedIndices) > 0;
+                }
+            }
+            break;
+    }
+    
+    removeIfEmpty(key);
+    return changed;
+}
+
 void Selection::select(const SelectionElement& element, SelectionOp op)
 {
+    const uint64_t key = setKey(element.meshId, element.mode);
     bool changed = false;
     
     switch (op) {
         case SelectionOp::Replace:
             // Only skip if we already have exactly this one element selected
-            if (m_selectedElements.size() != 1 || m_selectedElements.find(element) == m_selectedElements.end()) {
-                m_selectedElements.clear();
-                m_selectedElements.insert(element);
+            if (count() != 1 || !isSelected(element)) {
+                m_sets.clear();
+                m_sets[key].insert(element.elementIndex);
                 changed = true;
             }
             break;
             
         case SelectionOp::Add:
-            if (m_selectedElements.insert(element).second) {
+            if (m_sets[key].insert(element.elementIndex)) {
                 changed = true;
             }
             break;
             
         case SelectionOp::Toggle:
             {
-                auto it = m_selectedElements.find(element);
-                if (it != m_selectedElements.end()) {
-                    m_selectedElements.erase(it);
-                } else {
-                    m_selectedElements.insert(element);
+                SelectionSet& set = m_sets[key];
+                if (!set.erase(element.elementIndex)) {
+                    set.insert(element.elementIndex);
                 }
+                removeIfEmpty(key);
                 changed = true;
             }
             break;
             
         case SelectionOp::Remove:
-            if (m_selectedElements.erase(element) > 0) {
-                changed = true;
+            {
+                auto it = m_sets.find(key);
+                if (it != m_sets.end() && it->second.erase(element.elementIndex)) {
+                    removeIfEmpty(key);
+                    changed = true;
+                }
             }
             break;
     }
@@ -79,47 +452,88 @@ void Selection::select(const SelectionElement& element, SelectionOp op)
 void Selection::select(const std::vector<SelectionElement>& elements, SelectionOp op)
 {
     if (elements.empty()) {
-        if (op == SelectionOp::Replace && !m_selectedElements.empty()) {
-            m_selectedElements.clear();
+        if (op == SelectionOp::Replace && !m_sets.empty()) {
+            m_sets.clear();
             emit selectionChanged();
         }
         return;
     }
     
+    // Group indices by mesh and mode (box selections are mostly one mesh)
+    std::map<uint64_t, std::vector<uint64_t>> groups;
+    uint64_t currentKey = 0;
+    std::vector<uint64_t>* current = nullptr;
+    for (const auto& elem : elements) {
+        uint64_t key = setKey(elem.meshId, elem.mode);
+        if (!current || key != currentKey) {
+            currentKey = key;
+            current = &groups[key];
+        }
+        current->push_back(elem.elementIndex);
+    }
+    
+    bool changed = false;
+    
+    if (op == SelectionOp::Replace) {
+        m_sets.clear();
+        changed = true;
+    }
+    
+    for (auto& [key, indices] : groups) {
+        if (op == SelectionOp::Toggle) {
+            sortOddOccurrences(indices);
+        } else {
+            sortUnique(indices);
+        }
+        if (applyToSet(key, indices, op)) {
+            changed = true;
+        }
+    }
+    
+    if (op == SelectionOp::Toggle) {
+        changed = true;
+    }
+    
+    if (changed) {
+        emit selectionChanged();
+    }
+}
+
+void Selection::selectRange(uint32_t meshId, uint32_t first, uint32_t count, SelectionOp op)
+{
+    const uint64_t key = setKey(meshId, m_mode);
+    const uint64_t begin = first;
+    const uint64_t end = begin + count;
     bool changed = false;
     
     switch (op) {
         case SelectionOp::Replace:
-            m_selectedElements.clear();
-            for (const auto& elem : elements) {
-                m_selectedElements.insert(elem);
+            changed = count > 0 || !m_sets.empty();
+            m_sets.clear();
+            if (count > 0) {
+                m_sets[key].insertRange(begin, end);
             }
-            changed = true;
             break;
             
         case SelectionOp::Add:
-            for (const auto& elem : elements) {
-                if (m_selectedElements.insert(elem).second) {
-                    changed = true;
-                }
+            if (count > 0) {
+                changed = m_sets[key].insertRange(begin, end) > 0;
             }
             break;
             
         case SelectionOp::Toggle:
-            for (const auto& elem : elements) {
-                auto it = m_selectedElements.find(elem);
-                if (it != m_selectedElements.end()) {
-                    m_selectedElements.erase(it);
-                } else {
-                    m_selectedElements.insert(elem);
-                }
+            if (count > 0) {
+                m_sets[key].toggleRange(begin, end);
+                removeIfEmpty(key);
+                changed = true;
             }
-            changed = true;
             break;
             
         case SelectionOp::Remove:
-            for (const auto& elem : elements) {
-                if (m_selectedElements.erase(elem) > 0) {
+            {
+                auto it = m_sets.find(key);
+                if (it != m_sets.end() && it->second.eraseRange(begin, end) > 0) {
+                    removeIfEmpty(key);
                     changed = true;
                 }
             }
@@ -131,6 +545,35 @@ void Selection::select(const std::vector<SelectionElement>& elements, SelectionO
     }
 }
 
+void Selection::selectIndices(uint32_t meshId, const std::vector<uint32_t>& indices, SelectionOp op)
+{
+    std::vector<uint64_t> sorted(indices.begin(), indices.end());
+    if (op == SelectionOp::Toggle) {
+        sortOddOccurrences(sorted);
+    } else {
+        sortUnique(sorted);
+    }
+    
+    bool changed = false;
+    
+    if (op == SelectionOp::Replace) {
+        changed = !indices.empty() || !m_sets.empty();
+        m_sets.clear();
+    }
+    
+    if (applyToSet(setKey(meshId, m_mode), sorted, op)) {
+        changed = true;
+    }
+    
+    if (op == SelectionOp::Toggle && !indices.empty()) {
+        changed = true;
+    }
+    
+    if (changed) {
+        emit selectionChanged();
+    }
+}
+
 SelectionElement Selection::createElementFromHit(const HitInfo& hit) const
 {
     SelectionElement elem;
@@ -198,104 +641,129 @@ void Selection::selectFromHit(const HitInfo& hit, SelectionOp op)
 
 void Selection::deselect(const SelectionElement& element)
 {
-    if (m_selectedElements.erase(element) > 0) {
+    const uint64_t key = setKey(element.meshId, element.mode);
+    auto it = m_sets.find(key);
+    if (it != m_sets.end() && it->second.erase(element.elementIndex)) {
+        removeIfEmpty(key);
         emit selectionChanged();
     }
 }
 
 void Selection::clear()
 {
-    if (!m_selectedElements.empty()) {
-        m_selectedElements.clear();
+    if (!m_sets.empty()) {
+        m_sets.clear();
         emit selectionChanged();
     }
 }
 
 void Selection::invertSelection(uint32_t meshId, uint32_t totalElements)
 {
-    std::set<SelectionElement> newSelection;
+    const uint64_t key = setKey(meshId, m_mode);
+    bool changed = false;
     
-    for (uint32_t i = 0; i < totalElements; ++i) {
-        SelectionElement elem;
-        elem.meshId = meshId;
-        elem.elementIndex = i;
-        elem.mode = m_mode;
-        
-        if (m_selectedElements.find(elem) == m_selectedElements.end()) {
-            newSelection.insert(elem);
+    // Only elements of this mesh in the current mode and below totalElements survive
+    for (auto it = m_sets.lower_bound(setKey(meshId, SelectionMode::Object));
+         it != m_sets.end() && meshIdOf(it->first) == meshId;) {
+        if (it->first != key) {
+            it = m_sets.erase(it);
+            changed = true;
+            continue;
         }
+        if (it->second.eraseRange(totalElements, std::numeric_limits<uint64_t>::max()) > 0) {
+            changed = true;
+        }
+        ++it;
     }
     
-    // Keep elements from other meshes
-    for (const auto& elem : m_selectedElements) {
-        if (elem.meshId != meshId) {
-            newSelection.insert(elem);
-        }
+    if (totalElements > 0) {
+        m_sets[key].toggleRange(0, totalElements);
+        removeIfEmpty(key);
+        changed = true;
     }
     
-    if (newSelection != m_selectedElements) {
-        m_selectedElements = std::move(newSelection);
+    if (changed) {
         emit selectionChanged();
     }
 }
 
 void Selection::selectAll(uint32_t meshId, uint32_t totalElements)
 {
-    bool changed = false;
-    
-    for (uint32_t i = 0; i < totalElements; ++i) {
-        SelectionElement elem;
-        elem.meshId = meshId;
-        elem.elementIndex = i;
-        elem.mode = m_mode;
-        
-        if (m_selectedElements.insert(elem).second) {
-            changed = true;
-        }
-    }
-    
-    if (changed) {
-        emit selectionChanged();
-    }
+    selectRange(meshId, 0, totalElements, SelectionOp::Add);
 }
 
 bool Selection::isSelected(const SelectionElement& element) const
 {
-    return m_selectedElements.find(element) != m_selectedElements.end();
+    auto it = m_sets.find(setKey(element.meshId, element.mode));
+    return it != m_sets.end() && it->second.contains(element.elementIndex);
 }
 
 bool Selection::hasSelection(uint32_t meshId) const
 {
-    for (const auto& elem : m_selectedElements) {
-        if (elem.meshId == meshId) {
-            return true;
-        }
+    auto it = m_sets.lower_bound(setKey(meshId, SelectionMode::Object));
+    return it != m_sets.end() && meshIdOf(it->first) == meshId;
+}
+
+size_t Selection::count() const
+{
+    size_t total = 0;
+    for (const auto& [key, set] : m_sets) {
+        total += set.size();
     }
-    return false;
+    return total;
+}
+
+size_t Selection::count(uint32_t meshId) const
+{
+    size_t total = 0;
+    for (auto it = m_sets.lower_bound(setKey(meshId, SelectionMode::Object));
+         it != m_sets.end() && meshIdOf(it->first) == meshId; ++it) {
+        total += it->second.size();
+    }
+    return total;
+}
+
+std::vector<SelectionElement> Selection::selectedElements() const
+{
+    std::vector<SelectionElement> elements;
+    elements.reserve(count());
+    
+    for (const auto& [key, set] : m_sets) {
+        SelectionElement elem;
+        elem.meshId = meshIdOf(key);
+        elem.mode = modeOf(key);
+        set.forEach([&](uint64_t index) {
+            elem.elementIndex = index;
+            elements.push_back(elem);
+        });
+    }
+    
+    return elements;
 }
 
 std::vector<uint32_t> Selection::selectedIndices(uint32_t meshId) const
 {
     std::vector<uint32_t> indices;
+    indices.reserve(count(meshId));
     
-    for (const auto& elem : m_selectedElements) {
-        if (elem.meshId == meshId) {
-            indices.push_back(elem.elementIndex);
-        }
-    }
+    forEachSelected(meshId, [&indices](uint64_t index) {
+        indices.push_back(static_cast<uint32_t>(index));
+    });
     
     return indices;
 }
 
 std::vector<uint32_t> Selection::selectedMeshIds() const
 {
-    std::set<uint32_t> meshIds;
+    std::vector<uint32_t> meshIds;
     
-    for (const auto& elem : m_selectedElements) {
-        meshIds.insert(elem.meshId);
+    for (const auto& [key, set] : m_sets) {
+        if (meshIds.empty() || meshIds.back() != meshIdOf(key)) {
+            meshIds.push_back(meshIdOf(key));
+        }
     }
     
-    return std::vector<uint32_t>(meshIds.begin(), meshIds.end());
+    return meshIds;
 }
 
 void Selection::selectObject(uint32_t meshId, SelectionOp op)
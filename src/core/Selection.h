@@ -5,18 +5,24 @@
  * Provides:
  * - Multiple selection modes (Object, Face, Vertex, Edge)
  * - Add/remove/toggle/clear selection operations
+ * - Range operations for region selections on large meshes
  * - Selection changed signals for UI updates
  */
 
 #pragma once
 
 #include <QObject>
-#include <set>
+#include <map>
 #include <vector>
 #include <memory>
 #include <cstdint>
+#include <limits>
 #include <glm/glm.hpp>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace dc3d {
 namespace core {
 
@@ -82,6 +88,110 @@ struct HitInfo {
     uint32_t closestVertex = 0;             ///< Closest vertex index
 };
 
+/**
+ * @brief Set of selected element indices of one mesh in one mode
+ *
+ * Small selections are kept as a sorted index list. Once a selection grows
+ * past SPARSE_LIMIT elements and covers at least 1/64 of its index range it
+ * switches to a bitset, so selecting all of a 10M-face mesh costs 1.25 MB
+ * instead of one tree node per face. Edge indices (vertex pairs packed into
+ * 64 bits) never fit a bitset and always stay sorted lists.
+ */
+class SelectionSet {
+public:
+    /// Sorted lists up to this size are never converted to a bitset
+    static constexpr size_t SPARSE_LIMIT = 1024;
+    
+    /// Indices at or above this are never stored in a bitset
+    static constexpr uint64_t DENSE_INDEX_LIMIT = uint64_t(1) << 32;
+    
+    bool empty() const { return m_count == 0; }
+    size_t size() const { return m_count; }
+    bool isDense() const { return m_dense; }
+    
+    bool contains(uint64_t index) const;
+    
+    /// Single index operations; return true if the set changed
+    bool insert(uint64_t index);
+    bool erase(uint64_t index);
+    
+    /**
+     * @brief Bulk operations on a sorted list of unique indices
+     * @return Number of indices added (insert) or removed (erase)
+     */
+    size_t insert(const std::vector<uint64_t>& sortedIndices);
+    size_t erase(const std::vector<uint64_t>& sortedIndices);
+    void toggle(const std::vector<uint64_t>& sortedIndices);
+    
+    /**
+     * @brief Range operations on [first, last)
+     * @return Number of indices added (insertRange) or removed (eraseRange)
+     */
+    size_t insertRange(uint64_t first, uint64_t last);
+    size_t eraseRange(uint64_t first, uint64_t last);
+    void toggleRange(uint64_t first, uint64_t last);
+    
+    void clear();
+    
+    /**
+     * @brief Call fn(index) for every index in ascending order
+     */
+    template<typename Fn>
+    void forEach(Fn&& fn) const
+    {
+        if (!m_dense) {
+            for (uint64_t index : m_sparse) {
+                fn(index);
+            }
+            return;
+        }
+        for (size_t w = 0; w < m_words.size(); ++w) {
+            uint64_t word = m_words[w];
+            while (word != 0) {
+                fn(static_cast<uint64_t>(w) * 64 + lowestBit(word));
+                word &= word - 1;
+            }
+        }
+    }
+    
+private:
+    static uint32_t lowestBit(uint64_t word)
+    {
+#ifdef _MSC_VER
+        unsigned long bit;
+        _BitScanForward64(&bit, word);
+        return static_cast<uint32_t>(bit);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(word));
+#endif
+    }
+    
+    static size_t bitCount(uint64_t word)
+    {
+#ifdef _MSC_VER
+        return static_cast<size_t>(__popcnt64(word));
+#else
+        return static_cast<size_t>(__builtin_popcountll(word));
+#endif
+    }
+    
+    // Apply op(word, mask) to the words covering [first, last); returns
+    // the change in the number of set bits
+    template<typename Op>
+    int64_t applyToRange(uint64_t first, uint64_t last, Op op);
+    
+    // Switch representation when the current one no longer pays off
+    void updateLayout();
+    bool makeDense(uint64_t maxIndex);
+    void makeSparse();
+    void reserveBits(uint64_t maxIndex);
+    
+    bool m_dense = false;
+    size_t m_count = 0;
+    std::vector<uint64_t> m_sparse;     ///< Sorted indices (sparse layout)
+    std::vector<uint64_t> m_words;      ///< Bitset words (dense layout)
+};
+
 /**
  * @brief Selection manager class
  * 
@@ -144,6 +254,24 @@ public:
      */
     void clear();
     
+    /**
+     * @brief Select a range of elements of a mesh in the current mode
+     * @param meshId Mesh to select in
+     * @param first First element index
+     * @param count Number of elements
+     * @param op Selection operation
+     */
+    void selectRange(uint32_t meshId, uint32_t first, uint32_t count, SelectionOp op = SelectionOp::Replace);
+    
+    /**
+     * @brief Select a list of elements of a mesh in the current mode
+     * @param meshId Mesh to select in
+     * @param indices Element indices (any order, duplicates allowed)
+     * @param op Selection operation
+     */
+    void selectIndices(uint32_t meshId, const std::vector<uint32_t>& indices,
+                       SelectionOp op = SelectionOp::Replace);
+    
     /**
      * @brief Invert selection within a mesh
      * @param meshId Mesh to invert selection in
@@ -173,17 +301,39 @@ public:
     /**
      * @brief Check if selection is empty
      */
-    bool isEmpty() const { return m_selectedElements.empty(); }
+    bool isEmpty() const { return m_sets.empty(); }
     
     /**
      * @brief Get count of selected elements
      */
-    size_t count() const { return m_selectedElements.size(); }
+    size_t count() const;
+    
+    /**
+     * @brief Get count of selected elements of a mesh
+     */
+    size_t count(uint32_t meshId) const;
     
     /**
      * @brief Get all selected elements
+     *
+     * Builds one entry per element; prefer forEachSelected() or
+     * selectedIndices() for face/vertex selections on large meshes.
      */
-    const std::set<SelectionElement>& selectedElements() const { return m_selectedElements; }
+    std::vector<SelectionElement> selectedElements() const;
+    
+    /**
+     * @brief Call fn(elementIndex) for every selected element of a mesh
+     *
+     * Elements are visited in ascending index order.
+     */
+    template<typename Fn>
+    void forEachSelected(uint32_t meshId, Fn&& fn) const
+    {
+        for (auto it = m_sets.lower_bound(setKey(meshId, SelectionMode::Object));
+             it != m_sets.end() && meshIdOf(it->first) == meshId; ++it) {
+            it->second.forEach(fn);
+        }
+    }
     
     /**
      * @brief Get selected elements for a specific mesh
@@ -252,8 +402,20 @@ signals:
     void modeChanged(SelectionMode newMode);
 
 private:
+    // Sets are keyed by mesh ID, then mode (same order as SelectionElement)
+    static uint64_t setKey(uint32_t meshId, SelectionMode mode)
+    {
+        return (static_cast<uint64_t>(meshId) << 8) | static_cast<uint64_t>(mode);
+    }
+    static uint32_t meshIdOf(uint64_t key) { return static_cast<uint32_t>(key >> 8); }
+    static SelectionMode modeOf(uint64_t key) { return static_cast<SelectionMode>(key & 0xFF); }
+    
+    // Apply op to one set given sorted unique indices; returns true if changed
+    bool applyToSet(uint64_t key, const std::vector<uint64_t>& sortedIndices, SelectionOp op);
+    void removeIfEmpty(uint64_t key);
+    
     SelectionMode m_mode = SelectionMode::Object;
-    std::set<SelectionElement> m_selectedElements;
+    std::map<uint64_t, SelectionSet> m_sets;   ///< Non-empty sets only
     
     // Helper to create element based on current mode
     SelectionElement createElementFromHit(const HitInfo& hit) const;
@@ -4,15 +4,131 @@
  */
 
 #include "SnapManager.h"
+#include "TaskScheduler.h"
 #include "geometry/MeshData.h"
+#include "geometry/BVH.h"
+#include "geometry/DerivedDataCache.h"
+#include "geometry/KDTree.h"
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <limits>
+#include <optional>
 
 namespace dc3d {
 namespace core {
 
+namespace {
+
+// Longest a unit world-space length can get in local space (Frobenius norm
+// of the inverse), so a local search radius of tolerance * stretch never
+// misses a point within tolerance in world space
+float localStretch(const glm::mat4& inverseTransform)
+{
+    const glm::mat3 inv3(inverseTransform);
+    return std::sqrt(glm::dot(inv3[0], inv3[0]) +
+                     glm::dot(inv3[1], inv3[1]) +
+                     glm::dot(inv3[2], inv3[2]));
+}
+
+uint64_t edgeKey(uint32_t a, uint32_t b)
+{
+    if (a > b) std::swap(a, b);
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+} // anonymous namespace
+
+/**
+ * Snap structures of one mesh in its local space. Each part is built the
+ * first time a query needs it, so meshes that are never snapped to cost
+ * nothing, and a mesh that only ever gets surface snaps never builds the
+ * point trees.
+ */
+struct SnapManager::LocalSnapCache {
+    std::shared_ptr<geometry::BVH> bvh;        ///< Faces: surface, face center and screen queries
+    geometry::KDTree vertexTree;               ///< Vertices (tree index = vertex index); screen queries of point clouds
+    std::vector<uint64_t> edgeKeys;            ///< Unique edges as (min << 32 | max), sorted
+    std::vector<glm::vec3> edgeMidpoints;      ///< Midpoint of each edge in edgeKeys
+    geometry::KDTree edgeTree;                 ///< Over edgeMidpoints
+    std::optional<glm::vec3> centroid;
+    bool verticesBuilt = false;
+    bool edgesBuilt = false;
+    
+    const geometry::BVH& faces(const geometry::MeshData& mesh)
+    {
+        if (!bvh) {
+            bvh = geometry::DerivedDataCache::instance().bvh(mesh);
+        }
+        return *bvh;
+    }
+    
+    const geometry::KDTree& vertices(const geometry::MeshData& mesh)
+    {
+        if (!verticesBuilt) {
+            vertexTree.build(mesh.vertices());
+            verticesBuilt = true;
+        }
+        return vertexTree;
+    }
+    
+    const geometry::KDTree& edges(const geometry::MeshData& mesh)
+    {
+        if (!edgesBuilt) {
+            buildEdges(mesh);
+            edgesBuilt = true;
+        }
+        return edgeTree;
+    }
+    
+    /// Index of an edge in edgeKeys / edgeMidpoints (edges() must have run)
+    uint32_t edgeIndex(uint64_t key) const
+    {
+        return static_cast<uint32_t>(
+            std::lower_bound(edgeKeys.begin(), edgeKeys.end(), key) - edgeKeys.begin());
+    }
+    
+    glm::vec3 origin(const geometry::MeshData& mesh)
+    {
+        if (!centroid) {
+            centroid = mesh.centroid();
+        }
+        return *centroid;
+    }
+    
+private:
+    void buildEdges(const geometry::MeshData& mesh)
+    {
+        // Every face edge once, then sort out the shared ones
+        const auto& indices = mesh.indices();
+        const size_t faceCount = indices.size() / 3;
+        edgeKeys.resize(faceCount * 3);
+        parallelFor(0, faceCount, [&](size_t begin, size_t end) {
+            for (size_t f = begin; f < end; ++f) {
+                const uint32_t* tri = &indices[f * 3];
+                edgeKeys[f * 3 + 0] = edgeKey(tri[0], tri[1]);
+                edgeKeys[f * 3 + 1] = edgeKey(tri[1], tri[2]);
+                edgeKeys[f * 3 + 2] = edgeKey(tri[2], tri[0]);
+            }
+        });
+        parallelSort(edgeKeys.begin(), edgeKeys.end(), std::less<uint64_t>());
+        edgeKeys.erase(std::unique(edgeKeys.begin(), edgeKeys.end()), edgeKeys.end());
+        edgeKeys.shrink_to_fit();
+        
+        const auto& vertices = mesh.vertices();
+        edgeMidpoints.resize(edgeKeys.size());
+        parallelFor(0, edgeKeys.size(), [&](size_t begin, size_t end) {
+            for (size_t e = begin; e < end; ++e) {
+                const uint32_t a = static_cast<uint32_t>(edgeKeys[e] >> 32);
+                const uint32_t b = static_cast<uint32_t>(edgeKeys[e]);
+                edgeMidpoints[e] = (vertices[a] + vertices[b]) * 0.5f;
+            }
+        });
+        edgeTree.build(edgeMidpoints);
+    }
+};
+
 SnapManager::SnapManager(QObject* parent)
     : QObject(parent)
 {
@@ -105,9 +221,19 @@ SnapResult SnapManager::findSnapTarget(const glm::vec3& point,
         }
         
         if (m_settings.snapToFaceCenters) {
+            auto centerSnap = findFaceCenterSnap(point, excludeMeshId);
+            if (centerSnap && centerSnap.distance < bestDist &&
+                centerSnap.distance < m_settings.worldTolerance) {
+                bestResult = centerSnap;
+                bestDist = centerSnap.distance;
+            }
+        }
+        
+        // Any surface point is at least as close as the features above,
+        // so surface snap only applies when no feature is in range
+        if (m_settings.snapToFaces && !bestResult.snapped) {
             auto faceSnap = findFaceSnap(point, excludeMeshId);
-            if (faceSnap && faceSnap.distance < bestDist &&
-                faceSnap.distance < m_settings.worldTolerance) {
+            if (faceSnap && faceSnap.distance < m_settings.worldTolerance) {
                 bestResult = faceSnap;
                 bestDist = faceSnap.distance;
             }
@@ -163,78 +289,44 @@ SnapResult SnapManager::findSnapTarget(const glm::vec3& point,
     
     // Check object snap points
     if (m_settings.objectSnapEnabled) {
+        const glm::mat4 viewProj = projMatrix * viewMatrix;
         for (const auto& regMesh : m_meshes) {
-            if (regMesh.id == excludeMeshId) continue;
+            if (regMesh.id == excludeMeshId || !regMesh.mesh || regMesh.mesh->vertices().empty()) continue;
             
-            // Check vertices
-            if (m_settings.snapToVertices) {
-                for (size_t i = 0; i < regMesh.vertices.size(); ++i) {
-                    glm::vec2 sp = worldToScreen(regMesh.vertices[i]);
+            // Vertices, edge midpoints and face centers
+            forEachFeatureNearScreen(regMesh, viewProj, screenPos, viewportSize,
+                                     m_settings.snapTolerance,
+                [&](SnapType type, uint32_t index, const glm::vec3& localPos) {
+                    glm::vec3 worldPos(regMesh.transform * glm::vec4(localPos, 1.0f));
+                    glm::vec2 sp = worldToScreen(worldPos);
                     float screenDist = glm::length(sp - screenPos);
                     
                     if (screenDist < m_settings.snapTolerance &&
                         screenDist < bestScreenDist) {
                         bestResult.snapped = true;
-                        bestResult.type = SnapType::Vertex;
-                        bestResult.position = regMesh.vertices[i];
+                        bestResult.type = type;
+                        bestResult.position = worldPos;
                         bestResult.meshId = regMesh.id;
-                        bestResult.elementIndex = static_cast<uint32_t>(i);
-                        bestResult.distance = glm::length(regMesh.vertices[i] - point);
+                        bestResult.elementIndex = index;
+                        bestResult.distance = glm::length(worldPos - point);
                         bestScreenDist = screenDist;
                     }
-                }
-            }
-            
-            // Check edge midpoints
-            if (m_settings.snapToEdgeMidpoints) {
-                for (size_t i = 0; i < regMesh.edgeMidpoints.size(); ++i) {
-                    glm::vec2 sp = worldToScreen(regMesh.edgeMidpoints[i]);
-                    float screenDist = glm::length(sp - screenPos);
-                    
-                    if (screenDist < m_settings.snapTolerance &&
-                        screenDist < bestScreenDist) {
-                        bestResult.snapped = true;
-                        bestResult.type = SnapType::EdgeMid;
-                        bestResult.position = regMesh.edgeMidpoints[i];
-                        bestResult.meshId = regMesh.id;
-                        bestResult.elementIndex = static_cast<uint32_t>(i);
-                        bestResult.distance = glm::length(regMesh.edgeMidpoints[i] - point);
-                        bestScreenDist = screenDist;
-                    }
-                }
-            }
-            
-            // Check face centers
-            if (m_settings.snapToFaceCenters) {
-                for (size_t i = 0; i < regMesh.faceCenters.size(); ++i) {
-                    glm::vec2 sp = worldToScreen(regMesh.faceCenters[i]);
-                    float screenDist = glm::length(sp - screenPos);
-                    
-                    if (screenDist < m_settings.snapTolerance &&
-                        screenDist < bestScreenDist) {
-                        bestResult.snapped = true;
-                        bestResult.type = SnapType::FaceCenter;
-                        bestResult.position = regMesh.faceCenters[i];
-                        bestResult.meshId = regMesh.id;
-                        bestResult.elementIndex = static_cast<uint32_t>(i);
-                        bestResult.distance = glm::length(regMesh.faceCenters[i] - point);
-                        bestScreenDist = screenDist;
-                    }
-                }
-            }
+                });
             
             // Check origin
             if (m_settings.snapToOrigins) {
-                glm::vec2 sp = worldToScreen(regMesh.origin);
+                glm::vec3 origin(regMesh.transform *
+                                 glm::vec4(regMesh.cache->origin(*regMesh.mesh), 1.0f));
+                glm::vec2 sp = worldToScreen(origin);
                 float screenDist = glm::length(sp - screenPos);
                 
                 if (screenDist < m_settings.snapTolerance &&
                     screenDist < bestScreenDist) {
                     bestResult.snapped = true;
                     bestResult.type = SnapType::Origin;
-                    bestResult.position = regMesh.origin;
+                    bestResult.position = origin;
                     bestResult.meshId = regMesh.id;
-                    bestResult.distance = glm::length(regMesh.origin - point);
+                    bestResult.distance = glm::length(origin - point);
                     bestScreenDist = screenDist;
                 }
             }
@@ -297,39 +389,21 @@ std::vector<SnapCandidate> SnapManager::findSnapCandidates(
     glm::vec2 screenPos = worldToScreen(point);
     
     // Collect candidates from all meshes
+    const glm::mat4 viewProj = projMatrix * viewMatrix;
+    const float tolerance = m_settings.snapTolerance * 2.0f;
     for (const auto& regMesh : m_meshes) {
-        if (m_settings.snapToVertices) {
-            for (const auto& v : regMesh.vertices) {
-                glm::vec2 sp = worldToScreen(v);
-                float dist = glm::length(sp - screenPos);
-                if (dist < m_settings.snapTolerance * 2.0f) {
-                    candidates.push_back({SnapType::Vertex, v, glm::vec3(0,1,0), 
-                                         regMesh.id, dist});
-                }
-            }
-        }
+        if (!regMesh.mesh || regMesh.mesh->vertices().empty()) continue;
         
-        if (m_settings.snapToEdgeMidpoints) {
-            for (const auto& e : regMesh.edgeMidpoints) {
-                glm::vec2 sp = worldToScreen(e);
+        forEachFeatureNearScreen(regMesh, viewProj, screenPos, viewportSize, tolerance,
+            [&](SnapType type, uint32_t, const glm::vec3& localPos) {
+                glm::vec3 worldPos(regMesh.transform * glm::vec4(localPos, 1.0f));
+                glm::vec2 sp = worldToScreen(worldPos);
                 float dist = glm::length(sp - screenPos);
-                if (dist < m_settings.snapTolerance * 2.0f) {
-                    candidates.push_back({SnapType::EdgeMid, e, glm::vec3(0,1,0),
+                if (dist < tolerance) {
+                    candidates.push_back({type, worldPos, glm::vec3(0,1,0),
                                          regMesh.id, dist});
                 }
-            }
-        }
-        
-        if (m_settings.snapToFaceCenters) {
-            for (const auto& f : regMesh.faceCenters) {
-                glm::vec2 sp = worldToScreen(f);
-                float dist = glm::length(sp - screenPos);
-                if (dist < m_settings.snapTolerance * 2.0f) {
-                    candidates.push_back({SnapType::FaceCenter, f, glm::vec3(0,1,0),
-                                         regMesh.id, dist});
-                }
-            }
-        }
+            });
     }
     
     // Sort by screen distance
@@ -357,8 +431,8 @@ void SnapManager::registerMesh(uint64_t id,
     regMesh.id = id;
     regMesh.mesh = mesh;
     regMesh.transform = transform;
-    
-    rebuildSnapCache(regMesh);
+    regMesh.inverseTransform = glm::inverse(transform);
+    regMesh.cache = std::make_shared<LocalSnapCache>();
     
     m_meshes.push_back(std::move(regMesh));
 }
@@ -368,7 +442,7 @@ void SnapManager::updateMeshTransform(uint64_t id, const glm::mat4& transform)
     for (auto& regMesh : m_meshes) {
         if (regMesh.id == id) {
             regMesh.transform = transform;
-            rebuildSnapCache(regMesh);
+            regMesh.inverseTransform = glm::inverse(transform);
             break;
         }
     }
@@ -388,95 +462,130 @@ void SnapManager::clearMeshes()
     m_meshes.clear();
 }
 
-void SnapManager::rebuildSnapCache(RegisteredMesh& regMesh)
+template<typename Visit>
+void SnapManager::forEachFeatureNearScreen(const RegisteredMesh& regMesh,
+                                           const glm::mat4& viewProj,
+                                           const glm::vec2& screenPos,
+                                           const glm::vec2& viewportSize,
+                                           float tolerance,
+                                           Visit&& visit) const
 {
-    if (!regMesh.mesh) return;
-    
-    const auto& mesh = *regMesh.mesh;
-    const auto& transform = regMesh.transform;
-    
-    // Transform vertices
-    regMesh.vertices.clear();
-    regMesh.vertices.reserve(mesh.vertexCount());
+    const geometry::MeshData& mesh = *regMesh.mesh;
+    LocalSnapCache& cache = *regMesh.cache;
+    
+    // Pick frustum through the tolerance square around the cursor: scale
+    // clip space so that square fills the unit NDC range
+    glm::vec2 ndc(screenPos.x / viewportSize.x * 2.0f - 1.0f,
+                  1.0f - screenPos.y / viewportSize.y * 2.0f);
+    glm::vec2 halfSize(tolerance * 2.0f / viewportSize.x,
+                       tolerance * 2.0f / viewportSize.y);
+    glm::mat4 pick(1.0f);
+    pick[0][0] = 1.0f / halfSize.x;
+    pick[1][1] = 1.0f / halfSize.y;
+    pick[3][0] = -ndc.x / halfSize.x;
+    pick[3][1] = -ndc.y / halfSize.y;
+    
+    // Planes in mesh-local space straight from the combined matrix
+    const glm::mat4 m = pick * viewProj * regMesh.transform;
+    auto row = [&m](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+    glm::vec4 planes[6] = {
+        row(3) + row(0), row(3) - row(0),   // Left, right
+        row(3) + row(1), row(3) - row(1),   // Bottom, top
+        row(3) + row(2), row(3) - row(2)    // Near, far
+    };
     
-    const auto& verts = mesh.vertices();
-    for (size_t i = 0; i < verts.size(); ++i) {
-        glm::vec4 worldVert = transform * glm::vec4(verts[i], 1.0f);
-        regMesh.vertices.push_back(glm::vec3(worldVert));
+    // Without faces (point clouds) only vertices can be snapped to; take
+    // the ones inside the frustum straight from the vertex tree
+    if (mesh.faceCount() == 0) {
+        if (m_settings.snapToVertices) {
+            const auto& vertices = mesh.vertices();
+            std::vector<uint32_t> nearVertices;
+            cache.vertices(mesh).findInFrustum(planes, nearVertices);
+            for (uint32_t v : nearVertices) {
+                visit(SnapType::Vertex, v, vertices[v]);
+            }
+        }
+        return;
     }
     
-    // Compute edge midpoints and face centers from triangles
-    regMesh.edgeMidpoints.clear();
-    regMesh.faceCenters.clear();
+    // A feature that projects into the square lies on a face that
+    // reaches into the frustum
+    const std::vector<uint32_t> faces = cache.faces(mesh).queryFrustum(planes);
+    if (faces.empty()) {
+        return;
+    }
     
+    const auto& vertices = mesh.vertices();
     const auto& indices = mesh.indices();
-    size_t faceCount = indices.size() / 3;
-    
-    regMesh.faceCenters.reserve(faceCount);
-    // Rough estimate: 3 edges per face, but shared, so roughly 1.5x faces
-    regMesh.edgeMidpoints.reserve(faceCount * 2);
     
-    // Track edges we've seen (to avoid duplicates)
-    // Simple approach: just collect all midpoints, duplicates will be near each other
-    std::vector<std::pair<uint32_t, uint32_t>> seenEdges;
-    
-    for (size_t f = 0; f < faceCount; ++f) {
-        uint32_t i0 = indices[f * 3 + 0];
-        uint32_t i1 = indices[f * 3 + 1];
-        uint32_t i2 = indices[f * 3 + 2];
-        
-        const glm::vec3& v0 = regMesh.vertices[i0];
-        const glm::vec3& v1 = regMesh.vertices[i1];
-        const glm::vec3& v2 = regMesh.vertices[i2];
-        
-        // Face center
-        regMesh.faceCenters.push_back((v0 + v1 + v2) / 3.0f);
-        
-        // Edge midpoints (check for duplicates)
-        auto addEdge = [&](uint32_t a, uint32_t b) {
-            if (a > b) std::swap(a, b);
-            auto edge = std::make_pair(a, b);
-            if (std::find(seenEdges.begin(), seenEdges.end(), edge) == seenEdges.end()) {
-                seenEdges.push_back(edge);
-                regMesh.edgeMidpoints.push_back(
-                    (regMesh.vertices[a] + regMesh.vertices[b]) * 0.5f);
-            }
-        };
-        
-        addEdge(i0, i1);
-        addEdge(i1, i2);
-        addEdge(i2, i0);
+    if (m_settings.snapToVertices) {
+        std::vector<uint32_t> nearVertices;
+        nearVertices.reserve(faces.size() * 3);
+        for (uint32_t f : faces) {
+            nearVertices.insert(nearVertices.end(), &indices[f * 3], &indices[f * 3] + 3);
+        }
+        std::sort(nearVertices.begin(), nearVertices.end());
+        nearVertices.erase(std::unique(nearVertices.begin(), nearVertices.end()), nearVertices.end());
+        for (uint32_t v : nearVertices) {
+            visit(SnapType::Vertex, v, vertices[v]);
+        }
     }
     
-    // Origin (centroid of mesh)
-    glm::vec3 origin(0.0f);
-    for (const auto& v : regMesh.vertices) {
-        origin += v;
+    if (m_settings.snapToEdgeMidpoints) {
+        cache.edges(mesh);
+        std::vector<uint64_t> nearEdges;
+        nearEdges.reserve(faces.size() * 3);
+        for (uint32_t f : faces) {
+            const uint32_t* tri = &indices[f * 3];
+            nearEdges.push_back(edgeKey(tri[0], tri[1]));
+            nearEdges.push_back(edgeKey(tri[1], tri[2]));
+            nearEdges.push_back(edgeKey(tri[2], tri[0]));
+        }
+        std::sort(nearEdges.begin(), nearEdges.end());
+        nearEdges.erase(std::unique(nearEdges.begin(), nearEdges.end()), nearEdges.end());
+        for (uint64_t key : nearEdges) {
+            uint32_t e = cache.edgeIndex(key);
+            visit(SnapType::EdgeMid, e, cache.edgeMidpoints[e]);
+        }
     }
-    if (!regMesh.vertices.empty()) {
-        origin /= static_cast<float>(regMesh.vertices.size());
+    
+    if (m_settings.snapToFaceCenters) {
+        for (uint32_t f : faces) {
+            const uint32_t* tri = &indices[f * 3];
+            visit(SnapType::FaceCenter, f,
+                  (vertices[tri[0]] + vertices[tri[1]] + vertices[tri[2]]) / 3.0f);
+        }
     }
-    regMesh.origin = origin;
 }
 
 SnapResult SnapManager::findVertexSnap(const glm::vec3& point,
                                         uint64_t excludeMeshId) const
 {
     SnapResult best;
-    float bestDist = std::numeric_limits<float>::max();
+    float bestDist = m_settings.worldTolerance;
+    std::vector<geometry::KDNeighbor> nearby;
     
     for (const auto& regMesh : m_meshes) {
-        if (regMesh.id == excludeMeshId) continue;
+        // Point clouds have vertices but no faces
+        if (regMesh.id == excludeMeshId || !regMesh.mesh || regMesh.mesh->vertices().empty()) continue;
         
-        for (size_t i = 0; i < regMesh.vertices.size(); ++i) {
-            float dist = glm::length(regMesh.vertices[i] - point);
+        const geometry::MeshData& mesh = *regMesh.mesh;
+        const auto& tree = regMesh.cache->vertices(mesh);
+        const auto& vertices = mesh.vertices();
+        
+        // Candidates from the local tree, ranked by world distance
+        glm::vec3 localPoint(regMesh.inverseTransform * glm::vec4(point, 1.0f));
+        tree.findInRadius(localPoint, bestDist * localStretch(regMesh.inverseTransform), nearby);
+        for (const auto& neighbor : nearby) {
+            glm::vec3 worldPos(regMesh.transform * glm::vec4(vertices[neighbor.index], 1.0f));
+            float dist = glm::length(worldPos - point);
             if (dist < bestDist) {
                 bestDist = dist;
                 best.snapped = true;
                 best.type = SnapType::Vertex;
-                best.position = regMesh.vertices[i];
+                best.position = worldPos;
                 best.meshId = regMesh.id;
-                best.elementIndex = static_cast<uint32_t>(i);
+                best.elementIndex = neighbor.index;
                 best.distance = dist;
             }
         }
@@ -489,20 +598,27 @@ SnapResult SnapManager::findEdgeSnap(const glm::vec3& point,
                                       uint64_t excludeMeshId) const
 {
     SnapResult best;
-    float bestDist = std::numeric_limits<float>::max();
+    float bestDist = m_settings.worldTolerance;
+    std::vector<geometry::KDNeighbor> nearby;
     
     for (const auto& regMesh : m_meshes) {
-        if (regMesh.id == excludeMeshId) continue;
+        if (regMesh.id == excludeMeshId || !regMesh.mesh || regMesh.mesh->faceCount() == 0) continue;
         
-        for (size_t i = 0; i < regMesh.edgeMidpoints.size(); ++i) {
-            float dist = glm::length(regMesh.edgeMidpoints[i] - point);
+        const auto& tree = regMesh.cache->edges(*regMesh.mesh);
+        const auto& midpoints = regMesh.cache->edgeMidpoints;
+        
+        glm::vec3 localPoint(regMesh.inverseTransform * glm::vec4(point, 1.0f));
+        tree.findInRadius(localPoint, bestDist * localStretch(regMesh.inverseTransform), nearby);
+        for (const auto& neighbor : nearby) {
+            glm::vec3 worldPos(regMesh.transform * glm::vec4(midpoints[neighbor.index], 1.0f));
+            float dist = glm::length(worldPos - point);
             if (dist < bestDist) {
                 bestDist = dist;
                 best.snapped = true;
                 best.type = SnapType::EdgeMid;
-                best.position = regMesh.edgeMidpoints[i];
+                best.position = worldPos;
                 best.meshId = regMesh.id;
-                best.elementIndex = static_cast<uint32_t>(i);
+                best.elementIndex = neighbor.index;
                 best.distance = dist;
             }
         }
@@ -515,20 +631,79 @@ SnapResult SnapManager::findFaceSnap(const glm::vec3& point,
                                       uint64_t excludeMeshId) const
 {
     SnapResult best;
-    float bestDist = std::numeric_limits<float>::max();
+    float bestDist = m_settings.worldTolerance;
     
     for (const auto& regMesh : m_meshes) {
-        if (regMesh.id == excludeMeshId) continue;
+        if (regMesh.id == excludeMeshId || !regMesh.mesh || regMesh.mesh->faceCount() == 0) continue;
+        
+        const geometry::BVH& bvh = regMesh.cache->faces(*regMesh.mesh);
+        const glm::mat3 inv3(regMesh.inverseTransform);
+        
+        glm::vec3 localPoint(regMesh.inverseTransform * glm::vec4(point, 1.0f));
+        auto closest = bvh.closestPoint(localPoint, bestDist * localStretch(regMesh.inverseTransform));
+        if (!closest.found) continue;
         
-        for (size_t i = 0; i < regMesh.faceCenters.size(); ++i) {
-            float dist = glm::length(regMesh.faceCenters[i] - point);
+        glm::vec3 worldPos(regMesh.transform * glm::vec4(closest.point, 1.0f));
+        float dist = glm::length(worldPos - point);
+        if (dist < bestDist) {
+            bestDist = dist;
+            best.snapped = true;
+            best.type = SnapType::Face;
+            best.position = worldPos;
+            best.meshId = regMesh.id;
+            best.elementIndex = closest.faceIndex;
+            best.distance = dist;
+            
+            // Normals transform by the inverse transpose
+            glm::vec3 n = glm::transpose(inv3) * closest.normal;
+            float len = glm::length(n);
+            if (len > 0.0f) {
+                best.normal = n / len;
+            }
+        }
+    }
+    
+    return best;
+}
+
+SnapResult SnapManager::findFaceCenterSnap(const glm::vec3& point,
+                                            uint64_t excludeMeshId) const
+{
+    SnapResult best;
+    float bestDist = m_settings.worldTolerance;
+    
+    for (const auto& regMesh : m_meshes) {
+        if (regMesh.id == excludeMeshId || !regMesh.mesh || regMesh.mesh->faceCount() == 0) continue;
+        
+        const geometry::MeshData& mesh = *regMesh.mesh;
+        const geometry::BVH& bvh = regMesh.cache->faces(mesh);
+        const auto& vertices = mesh.vertices();
+        const auto& indices = mesh.indices();
+        
+        // A face whose center is in range overlaps the tolerance box;
+        // collect candidates from the BVH in local space
+        geometry::AABB localBox;
+        for (int corner = 0; corner < 8; ++corner) {
+            glm::vec3 offset((corner & 1) ? bestDist : -bestDist,
+                             (corner & 2) ? bestDist : -bestDist,
+                             (corner & 4) ? bestDist : -bestDist);
+            localBox.expand(glm::vec3(regMesh.inverseTransform *
+                                      glm::vec4(point + offset, 1.0f)));
+        }
+        
+        for (uint32_t face : bvh.queryAABB(localBox)) {
+            const uint32_t* tri = &indices[face * 3];
+            glm::vec3 center = (vertices[tri[0]] + vertices[tri[1]] + vertices[tri[2]]) / 3.0f;
+            glm::vec3 worldPos(regMesh.transform * glm::vec4(center, 1.0f));
+            
+            float dist = glm::length(worldPos - point);
             if (dist < bestDist) {
                 bestDist = dist;
                 best.snapped = true;
                 best.type = SnapType::FaceCenter;
-                best.position = regMesh.faceCenters[i];
+                best.position = worldPos;
                 best.meshId = regMesh.id;
-                best.elementIndex = static_cast<uint32_t>(i);
+                best.elementIndex = face;
                 best.distance = dist;
             }
         }
@@ -269,19 +269,28 @@ signals:
     void activeSnapChanged(const SnapResult& result);
 
 private:
+    struct LocalSnapCache;
+    
     struct RegisteredMesh {
         uint64_t id;
         std::shared_ptr<geometry::MeshData> mesh;
-        glm::mat4 transform;
+        glm::mat4 transform{1.0f};
+        glm::mat4 inverseTransform{1.0f};
         
-        // Cached snap points (world space)
-        std::vector<glm::vec3> vertices;
-        std::vector<glm::vec3> edgeMidpoints;
-        std::vector<glm::vec3> faceCenters;
-        glm::vec3 origin;
+        // Snap structures in mesh-local space, each built on first use.
+        // Queries transform the point into local space, so transform
+        // updates never invalidate them.
+        std::shared_ptr<LocalSnapCache> cache;
     };
     
-    void rebuildSnapCache(RegisteredMesh& regMesh);
+    /// Visit the snap features of a mesh that may lie within tolerance pixels of screenPos
+    template<typename Visit>
+    void forEachFeatureNearScreen(const RegisteredMesh& regMesh,
+                                  const glm::mat4& viewProj,
+                                  const glm::vec2& screenPos,
+                                  const glm::vec2& viewportSize,
+                                  float tolerance,
+                                  Visit&& visit) const;
     
     SnapResult findVertexSnap(const glm::vec3& point, 
                               uint64_t excludeMeshId) const;
@@ -289,6 +298,8 @@ private:
                             uint64_t excludeMeshId) const;
     SnapResult findFaceSnap(const glm::vec3& point,
                             uint64_t excludeMeshId) const;
+    SnapResult findFaceCenterSnap(const glm::vec3& point,
+                                  uint64_t excludeMeshId) const;
     
     bool m_enabled = true;
     SnapSettings m_settings;
@@ -0,0 +1,264 @@
+/**
+ * @file TaskScheduler.cpp
+ * @brief Implementation of the work-stealing task scheduler
+ */
+
+#include "TaskScheduler.h"
+
+#ifdef HAVE_TBB
+#include <tbb/info.h>
+#endif
+
+namespace dc3d {
+namespace core {
+
+namespace {
+    // Index of the queue owned by the current thread (-1 = not a pool worker)
+    thread_local int t_workerIndex = -1;
+    // Scheduler that owns the current worker thread
+    thread_local const TaskScheduler* t_workerScheduler = nullptr;
+} // anonymous namespace
+
+// ============================================================================
+// TaskScheduler
+// ============================================================================
+
+TaskScheduler::TaskScheduler(size_t threadCount)
+{
+#ifdef HAVE_TBB
+    // TBB owns the threads; only report its concurrency for grain sizing
+    m_threadCount = threadCount > 0
+        ? threadCount
+        : static_cast<size_t>(tbb::info::default_concurrency());
+    m_queues.push_back(std::make_unique<TaskQueue>());
+#else
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_threadCount = threadCount;
+
+    // The calling thread participates in every parallel loop, so spawn one
+    // worker fewer than the requested concurrency
+    size_t workerCount = threadCount - 1;
+    for (size_t i = 0; i <= workerCount; ++i) {
+        m_queues.push_back(std::make_unique<TaskQueue>());
+    }
+
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+#endif
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+TaskScheduler& TaskScheduler::instance()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+void TaskScheduler::submit(Task task)
+{
+#ifdef HAVE_TBB
+    // Not used with the TBB backend (TaskGroup forwards to tbb::task_group)
+    task();
+#else
+    if (m_workers.empty()) {
+        task();
+        return;
+    }
+
+    // Workers push to their own deque; everyone else uses the injection queue
+    size_t queueIndex = (t_workerScheduler == this && t_workerIndex >= 0)
+        ? static_cast<size_t>(t_workerIndex)
+        : m_queues.size() - 1;
+
+    // Count the task before it becomes visible so the counter never underflows
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        ++m_pendingTasks;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queueIndex]->mutex);
+        m_queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    m_wakeCondition.notify_one();
+#endif
+}
+
+bool TaskScheduler::popTask(size_t queueIndex, Task& task)
+{
+    TaskQueue& queue = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+
+    // Owner takes the most recently pushed task (cache-warm, depth-first)
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool TaskScheduler::stealTask(size_t thiefIndex, Task& task)
+{
+    const size_t queueCount = m_queues.size();
+    for (size_t offset = 1; offset <= queueCount; ++offset) {
+        size_t victim = (thiefIndex + offset) % queueCount;
+        if (victim == thiefIndex) {
+            continue;
+        }
+
+        TaskQueue& queue = *m_queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            // Thieves take the oldest task (largest remaining work)
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::runPendingTask()
+{
+    if (m_pendingTasks.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    size_t ownIndex = (t_workerScheduler == this && t_workerIndex >= 0)
+        ? static_cast<size_t>(t_workerIndex)
+        : m_queues.size() - 1;
+
+    Task task;
+    if (!popTask(ownIndex, task) && !stealTask(ownIndex, task)) {
+        return false;
+    }
+
+    --m_pendingTasks;
+    task();
+    return true;
+}
+
+void TaskScheduler::workerLoop(size_t index)
+{
+    t_workerIndex = static_cast<int>(index);
+    t_workerScheduler = this;
+
+    for (;;) {
+        if (runPendingTask()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.wait(lock, [this]() {
+            return m_stopping || m_pendingTasks.load(std::memory_order_acquire) > 0;
+        });
+
+        if (m_stopping) {
+            return;
+        }
+    }
+}
+
+// ============================================================================
+// TaskGroup
+// ============================================================================
+
+#ifdef HAVE_TBB
+
+TaskGroup::TaskGroup(TaskScheduler& /*scheduler*/)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    try {
+        m_group.wait();
+    } catch (...) {
+        // Destructors must not throw; call wait() to observe errors
+    }
+}
+
+void TaskGroup::run(TaskScheduler::Task task)
+{
+    m_group.run(std::move(task));
+}
+
+void TaskGroup::wait()
+{
+    m_group.wait();
+}
+
+#else
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler)
+    : m_scheduler(scheduler)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    try {
+        wait();
+    } catch (...) {
+        // Destructors must not throw; call wait() to observe errors
+    }
+}
+
+void TaskGroup::run(TaskScheduler::Task task)
+{
+    ++m_outstanding;
+    m_scheduler.submit([this, task = std::move(task)]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+        m_outstanding.fetch_sub(1, std::memory_order_release);
+    });
+}
+
+void TaskGroup::wait()
+{
+    // Help run pool tasks instead of blocking, so nested groups make progress
+    while (m_outstanding.load(std::memory_order_acquire) > 0) {
+        if (!m_scheduler.runPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        std::swap(error, m_error);
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+#endif
+
+} // namespace core
+} // namespace dc3d
@@ -0,0 +1,395 @@
+/**
+ * @file TaskScheduler.h
+ * @brief Shared work-stealing task scheduler and parallel loop helpers
+ *
+ * Provides a process-wide pool of worker threads with per-worker task
+ * deques (owner pops LIFO, idle workers steal FIFO), plus parallelFor and
+ * parallelReduce over index ranges with cooperative cancellation.
+ *
+ * When the project is configured with USE_TBB and TBB is found (HAVE_TBB),
+ * the loop helpers and TaskGroup forward to TBB instead.
+ */
+
+#ifndef DC3D_CORE_TASKSCHEDULER_H
+#define DC3D_CORE_TASKSCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#ifdef HAVE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+#endif
+
+namespace dc3d {
+namespace core {
+
+/**
+ * @class CancellationToken
+ * @brief Shared flag used to cooperatively cancel parallel work
+ *
+ * Copies share the same flag, so a token can be handed to workers and
+ * cancelled from any thread (e.g. when a ProgressCallback returns false).
+ * Loops only observe cancellation between chunks.
+ */
+class CancellationToken
+{
+public:
+    CancellationToken() : m_flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    /// Request cancellation
+    void cancel() const { m_flag->store(true, std::memory_order_relaxed); }
+
+    /// Check if cancellation was requested
+    bool isCancelled() const { return m_flag->load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_flag;
+};
+
+/**
+ * @class ParallelProgress
+ * @brief Aggregates progress from parallel workers into one callback
+ *
+ * Workers call advance() with the number of items they finished. The
+ * callback is only ever invoked on the thread that created the reporter
+ * (typically the UI-facing caller participating in parallelFor), throttled
+ * to roughly every 1/1000 of the work. If the callback returns false, the
+ * token is cancelled so the remaining chunks are skipped.
+ */
+class ParallelProgress
+{
+public:
+    /**
+     * @param callback Progress callback (may be empty); returns false to cancel
+     * @param total Total number of items
+     * @param rangeStart Progress value reported at 0 items
+     * @param rangeEnd Progress value reported at total items
+     */
+    ParallelProgress(std::function<bool(float)> callback, size_t total,
+                     float rangeStart = 0.0f, float rangeEnd = 1.0f)
+        : m_callback(std::move(callback))
+        , m_total(std::max<size_t>(total, 1))
+        , m_step(std::max<size_t>(m_total / 1000, 1))
+        , m_rangeStart(rangeStart)
+        , m_rangeEnd(rangeEnd)
+        , m_owner(std::this_thread::get_id())
+    {
+    }
+
+    /// Record finished items; reports if called on the owning thread
+    void advance(size_t count)
+    {
+        size_t done = m_done.fetch_add(count, std::memory_order_relaxed) + count;
+        if (!m_callback || std::this_thread::get_id() != m_owner) {
+            return;
+        }
+        if (done - m_lastReported < m_step && done < m_total) {
+            return;
+        }
+        m_lastReported = done;
+
+        float fraction = static_cast<float>(std::min(done, m_total)) / static_cast<float>(m_total);
+        if (!m_callback(m_rangeStart + (m_rangeEnd - m_rangeStart) * fraction)) {
+            m_token.cancel();
+        }
+    }
+
+    /// Token cancelled when the callback requests it
+    const CancellationToken& token() const { return m_token; }
+
+    /// Check if the callback requested cancellation
+    bool isCancelled() const { return m_token.isCancelled(); }
+
+private:
+    std::function<bool(float)> m_callback;
+    size_t m_total;
+    size_t m_step;
+    float m_rangeStart;
+    float m_rangeEnd;
+    std::thread::id m_owner;
+    std::atomic<size_t> m_done{0};
+    size_t m_lastReported = 0;  ///< Only touched on the owning thread
+    CancellationToken m_token;
+};
+
+/**
+ * @class TaskScheduler
+ * @brief Work-stealing thread pool
+ *
+ * Each worker owns a deque. Tasks spawned from a worker go to its own deque;
+ * tasks spawned from other threads go to a shared injection queue. Threads
+ * that wait on a TaskGroup execute pending tasks while waiting, so nested
+ * parallel loops cannot deadlock the pool.
+ *
+ * Usage:
+ *   core::parallelFor(0, n, [&](size_t begin, size_t end) {
+ *       for (size_t i = begin; i < end; ++i) { ... }
+ *   });
+ */
+class TaskScheduler
+{
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Create a scheduler
+     * @param threadCount Total concurrency including the calling thread
+     *                    (0 = std::thread::hardware_concurrency())
+     */
+    explicit TaskScheduler(size_t threadCount = 0);
+    ~TaskScheduler();
+
+    // Prevent copying
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /**
+     * @brief Get the process-wide scheduler
+     */
+    static TaskScheduler& instance();
+
+    /**
+     * @brief Total concurrency (worker threads + one participating caller)
+     */
+    size_t threadCount() const { return m_threadCount; }
+
+    /**
+     * @brief Queue a task for execution on the pool
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Run one pending task on the calling thread, if any
+     * @return true if a task was executed
+     */
+    bool runPendingTask();
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool popTask(size_t queueIndex, Task& task);
+    bool stealTask(size_t thiefIndex, Task& task);
+
+    size_t m_threadCount = 1;
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;  ///< One per worker + injection queue (last)
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<size_t> m_pendingTasks{0};
+    std::atomic<bool> m_stopping{false};
+};
+
+/**
+ * @class TaskGroup
+ * @brief Fork/join group of tasks on a TaskScheduler
+ *
+ * wait() blocks until every task spawned through run() finished, executing
+ * pending pool tasks on the waiting thread meanwhile. The first exception
+ * thrown by a task is rethrown from wait().
+ */
+class TaskGroup
+{
+public:
+    explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::instance());
+    ~TaskGroup();
+
+    // Prevent copying
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Spawn a task
+     */
+    void run(TaskScheduler::Task task);
+
+    /**
+     * @brief Wait for all spawned tasks to complete
+     */
+    void wait();
+
+private:
+#ifdef HAVE_TBB
+    tbb::task_group m_group;
+#else
+    TaskScheduler& m_scheduler;
+    std::atomic<size_t> m_outstanding{0};
+    std::mutex m_errorMutex;
+    std::exception_ptr m_error;
+#endif
+};
+
+/**
+ * @brief Pick a chunk size for an index range
+ *
+ * Aims for several chunks per thread so stealing can balance uneven work.
+ */
+inline size_t defaultGrainSize(size_t count, size_t threadCount)
+{
+    constexpr size_t CHUNKS_PER_THREAD = 8;
+    return std::max<size_t>(1, count / (threadCount * CHUNKS_PER_THREAD));
+}
+
+/**
+ * @brief Run body(chunkBegin, chunkEnd) over [begin, end) in parallel
+ *
+ * The calling thread participates. Chunks are handed out dynamically, so
+ * uneven per-index cost is balanced automatically.
+ *
+ * @param begin First index
+ * @param end One past last index
+ * @param body Callable taking (size_t chunkBegin, size_t chunkEnd)
+ * @param grainSize Indices per chunk (0 = automatic)
+ * @param cancel Optional token; remaining chunks are skipped once cancelled
+ * @return false if the loop was cancelled before completing
+ */
+template<typename Body>
+bool parallelFor(size_t begin, size_t end, Body&& body,
+                 size_t grainSize = 0, const CancellationToken* cancel = nullptr)
+{
+    if (end <= begin) {
+        return !(cancel && cancel->isCancelled());
+    }
+
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    const size_t count = end - begin;
+    const size_t threads = scheduler.threadCount();
+    if (grainSize == 0) {
+        grainSize = defaultGrainSize(count, threads);
+    }
+
+    // Small ranges: run inline, no task overhead
+    if (count <= grainSize || threads <= 1) {
+        for (size_t b = begin; b < end; b += grainSize) {
+            if (cancel && cancel->isCancelled()) return false;
+            body(b, std::min(b + grainSize, end));
+        }
+        return !(cancel && cancel->isCancelled());
+    }
+
+#ifdef HAVE_TBB
+    tbb::parallel_for(tbb::blocked_range<size_t>(begin, end, grainSize),
+        [&](const tbb::blocked_range<size_t>& r) {
+            if (cancel && cancel->isCancelled()) return;
+            body(r.begin(), r.end());
+        });
+#else
+    const size_t numChunks = (count + grainSize - 1) / grainSize;
+    std::atomic<size_t> nextChunk{0};
+
+    auto worker = [&]() {
+        for (;;) {
+            if (cancel && cancel->isCancelled()) return;
+            size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= numChunks) return;
+            size_t b = begin + chunk * grainSize;
+            body(b, std::min(b + grainSize, end));
+        }
+    };
+
+    TaskGroup group(scheduler);
+    size_t helpers = std::min(numChunks, threads) - 1;
+    for (size_t i = 0; i < helpers; ++i) {
+        group.run(worker);
+    }
+    worker();
+    group.wait();
+#endif
+
+    return !(cancel && cancel->isCancelled());
+}
+
+/**
+ * @brief Parallel reduction over [begin, end)
+ *
+ * The range is split into fixed chunks; each chunk is reduced with
+ * map(chunkBegin, chunkEnd) and the partial results are combined in chunk
+ * order, so the result is deterministic for a given grain size.
+ *
+ * @param identity Initial/neutral value
+ * @param map Callable (size_t chunkBegin, size_t chunkEnd) -> T
+ * @param combine Callable (T, T) -> T
+ * @param grainSize Indices per chunk (0 = automatic)
+ * @param cancel Optional cancellation token
+ */
+template<typename T, typename Map, typename Combine>
+T parallelReduce(size_t begin, size_t end, T identity, Map&& map, Combine&& combine,
+                 size_t grainSize = 0, const CancellationToken* cancel = nullptr)
+{
+    if (end <= begin) {
+        return identity;
+    }
+
+    const size_t count = end - begin;
+    if (grainSize == 0) {
+        grainSize = defaultGrainSize(count, TaskScheduler::instance().threadCount());
+    }
+
+    const size_t numChunks = (count + grainSize - 1) / grainSize;
+    std::vector<T> partials(numChunks, identity);
+
+    parallelFor(0, numChunks, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+            size_t b = begin + c * grainSize;
+            partials[c] = map(b, std::min(b + grainSize, end));
+        }
+    }, 1, cancel);
+
+    T result = identity;
+    for (const T& partial : partials) {
+        result = combine(result, partial);
+    }
+    return result;
+}
+
+/**
+ * @brief Parallel comparison sort of a random-access range
+ *
+ * Fork/join merge sort: halves are sorted as separate tasks down to
+ * grainSize elements (std::sort), then merged in place. Not stable.
+ *
+ * @param grainSize Elements below which a range is sorted serially (0 = automatic)
+ */
+template<typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp, size_t grainSize = 0)
+{
+    const size_t count = static_cast<size_t>(last - first);
+    if (grainSize == 0) {
+        constexpr size_t MIN_SORT_GRAIN = 16384;
+        grainSize = std::max(MIN_SORT_GRAIN,
+                             defaultGrainSize(count, TaskScheduler::instance().threadCount()));
+    }
+
+    if (count <= grainSize || TaskScheduler::instance().threadCount() <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    RandomIt middle = first + count / 2;
+    TaskGroup group;
+    group.run([=]() { parallelSort(first, middle, comp, grainSize); });
+    parallelSort(middle, last, comp, grainSize);
+    group.wait();
+
+    std::inplace_merge(first, middle, last, comp);
+}
+
+} // namespace core
+} // namespace dc3d
+
+#endif // DC3D_CORE_TASKSCHEDULER_H
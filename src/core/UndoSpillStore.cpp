@@ -0,0 +1,267 @@
+/**
+ * @file UndoSpillStore.cpp
+ * @brief Implementation of the undo spill store
+ */
+
+#include "UndoSpillStore.h"
+
+#include <QDebug>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <system_error>
+
+namespace dc3d {
+namespace core {
+
+namespace {
+
+constexpr const char* FILE_EXTENSION = ".undo";
+
+// Name for the store's directory that no other store (in this or another
+// running instance) uses
+std::filesystem::path uniqueDirectory(const std::filesystem::path& parent)
+{
+    static std::atomic<uint64_t> counter{0};
+    std::random_device random;
+    uint64_t id = (uint64_t(random()) << 32) ^ random() ^
+                  static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                  counter++;
+    char name[40];
+    std::snprintf(name, sizeof(name), "dc3d-undo-%016llx", static_cast<unsigned long long>(id));
+    return parent / name;
+}
+
+bool writeFile(const std::filesystem::path& path, const std::vector<uint8_t>& bytes)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    out.close();
+    return !out.fail();
+}
+
+} // anonymous namespace
+
+struct UndoSpillStore::State {
+    std::filesystem::path directory;
+    bool available = false;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;           ///< Writer: work queued or stop
+    std::condition_variable idle;           ///< flush(): queue drained
+
+    /// Payloads not on disk yet (queued, being written, or failed)
+    std::map<uint64_t, std::shared_ptr<const std::vector<uint8_t>>> pending;
+    std::deque<uint64_t> queue;             ///< Write order
+    std::set<uint64_t> failed;              ///< Pending payloads that stay in memory
+    uint64_t nextId = 1;
+    uint64_t bytes = 0;                     ///< All live entries
+    uint64_t failedBytes = 0;               ///< Live entries in failed
+    bool writeFailed = false;
+    bool writing = false;
+    bool stop = false;
+
+    std::filesystem::path filePath(uint64_t id) const
+    {
+        char name[24];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(id));
+        return directory / (name + std::string(FILE_EXTENSION));
+    }
+
+    ~State()
+    {
+        if (available) {
+            std::error_code ec;
+            std::filesystem::remove_all(directory, ec);
+        }
+    }
+};
+
+// ============================================================================
+// UndoSpillStore
+// ============================================================================
+
+UndoSpillStore::UndoSpillStore(const std::filesystem::path& parent)
+    : m_state(std::make_shared<State>())
+{
+    std::error_code ec;
+    std::filesystem::path base = parent.empty() ? std::filesystem::temp_directory_path(ec) : parent;
+    if (!ec) {
+        m_state->directory = uniqueDirectory(base);
+        m_state->available = std::filesystem::create_directories(m_state->directory, ec) && !ec;
+    }
+    if (!m_state->available) {
+        qWarning() << "Undo spill directory could not be created in"
+                   << QString::fromStdString(base.string());
+        return;
+    }
+
+    m_writer = std::thread(writeLoop, m_state);
+}
+
+UndoSpillStore::~UndoSpillStore()
+{
+    // Finish the queued writes: live entries still need their data
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->stop = true;
+    }
+    m_state->wake.notify_all();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+}
+
+bool UndoSpillStore::isAvailable() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->available && !m_state->writeFailed;
+}
+
+std::unique_ptr<UndoSpillStore::Entry> UndoSpillStore::put(std::vector<uint8_t>&& bytes)
+{
+    const uint64_t size = bytes.size();
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        if (!m_state->available || m_state->writeFailed) {
+            return nullptr;
+        }
+        id = m_state->nextId++;
+        m_state->pending.emplace(id, std::make_shared<const std::vector<uint8_t>>(std::move(bytes)));
+        m_state->queue.push_back(id);
+        m_state->bytes += size;
+    }
+    m_state->wake.notify_one();
+
+    return std::unique_ptr<Entry>(new Entry(m_state, id, size));
+}
+
+uint64_t UndoSpillStore::diskUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->bytes - m_state->failedBytes;
+}
+
+uint64_t UndoSpillStore::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->failedBytes;
+}
+
+void UndoSpillStore::flush()
+{
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    m_state->idle.wait(lock, [this] { return m_state->queue.empty() && !m_state->writing; });
+}
+
+void UndoSpillStore::writeLoop(std::shared_ptr<State> state)
+{
+    std::unique_lock<std::mutex> lock(state->mutex);
+    for (;;) {
+        state->wake.wait(lock, [&] { return state->stop || !state->queue.empty(); });
+        if (state->queue.empty()) {
+            break;  // Stopped with nothing left to write
+        }
+
+        const uint64_t id = state->queue.front();
+        state->queue.pop_front();
+        auto it = state->pending.find(id);
+        if (it != state->pending.end() && state->writeFailed) {
+            // After a failure nothing more goes to disk
+            state->failed.insert(id);
+            state->failedBytes += it->second->size();
+        } else if (it != state->pending.end()) {
+            std::shared_ptr<const std::vector<uint8_t>> bytes = it->second;
+            const std::filesystem::path path = state->filePath(id);
+            state->writing = true;
+
+            lock.unlock();
+            bool ok = writeFile(path, *bytes);
+            lock.lock();
+
+            state->writing = false;
+            it = state->pending.find(id);
+            if (it == state->pending.end()) {
+                // Entry was dropped while the file was being written
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            } else if (ok) {
+                state->pending.erase(it);
+            } else {
+                qWarning() << "Undo data could not be written to"
+                           << QString::fromStdString(path.string())
+                           << "- keeping it in memory and no longer spilling";
+                state->writeFailed = true;
+                state->failed.insert(id);
+                state->failedBytes += bytes->size();
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+            }
+        }
+
+        if (state->queue.empty()) {
+            state->idle.notify_all();
+        }
+    }
+}
+
+// ============================================================================
+// Entry
+// ============================================================================
+
+UndoSpillStore::Entry::Entry(std::shared_ptr<State> state, uint64_t id, uint64_t size)
+    : m_state(std::move(state))
+    , m_id(id)
+    , m_size(size)
+{
+}
+
+UndoSpillStore::Entry::~Entry()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->bytes -= m_size;
+        if (m_state->failed.erase(m_id) > 0) {
+            m_state->failedBytes -= m_size;
+        }
+        if (m_state->pending.erase(m_id) > 0) {
+            return;  // Not on disk (yet); the writer cleans up after itself
+        }
+    }
+    std::error_code ec;
+    std::filesystem::remove(m_state->filePath(m_id), ec);
+}
+
+bool UndoSpillStore::Entry::read(std::vector<uint8_t>& bytes) const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        auto it = m_state->pending.find(m_id);
+        if (it != m_state->pending.end()) {
+            bytes = *it->second;
+            return true;
+        }
+    }
+
+    const std::filesystem::path path = m_state->filePath(m_id);
+    std::error_code ec;
+    if (std::filesystem::file_size(path, ec) != m_size || ec) {
+        return false;
+    }
+    std::ifstream in(path, std::ios::binary);
+    bytes.resize(static_cast<size_t>(m_size));
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(bytes.data()),
+                                     static_cast<std::streamsize>(m_size)));
+}
+
+} // namespace core
+} // namespace dc3d
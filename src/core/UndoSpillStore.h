@@ -0,0 +1,104 @@
+/**
+ * @file UndoSpillStore.h
+ * @brief Temporary on-disk storage for undo history payloads
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace dc3d {
+namespace core {
+
+/**
+ * @brief Temp-file store that undo commands page their stored state out to
+ *
+ * put() hands the bytes to a background thread that writes them to a file
+ * in a private temporary directory, so the caller (the undo history, right
+ * after an edit) never waits for the disk. Until a write has finished,
+ * reads are served from the queued bytes. The first write that fails makes
+ * the store unavailable: its bytes and those still queued stay in memory,
+ * and memoryUsage() reports them so the caller can account for them.
+ *
+ * Each payload belongs to the Entry returned by put(); destroying the entry
+ * deletes its file. Entries may outlive the store. The directory is removed
+ * once the store and all its entries are gone.
+ *
+ * Thread-safe.
+ */
+class UndoSpillStore {
+public:
+    class Entry;
+
+    /**
+     * @brief Create a store
+     * @param parent Directory to create the store's directory in (empty = system temp)
+     */
+    explicit UndoSpillStore(const std::filesystem::path& parent = {});
+    ~UndoSpillStore();
+
+    // Non-copyable
+    UndoSpillStore(const UndoSpillStore&) = delete;
+    UndoSpillStore& operator=(const UndoSpillStore&) = delete;
+
+    /// Check if the directory could be created and no write has failed
+    bool isAvailable() const;
+
+    /**
+     * @brief Queue bytes for writing
+     * @return Entry to read them back with; null if the store is unavailable,
+     *         in which case bytes is left untouched
+     */
+    std::unique_ptr<Entry> put(std::vector<uint8_t>&& bytes);
+
+    /// Bytes held by live entries (written or still queued)
+    uint64_t diskUsage() const;
+
+    /// Bytes of live entries kept in memory because writing failed
+    uint64_t memoryUsage() const;
+
+    /// Wait until every queued write has finished
+    void flush();
+
+private:
+    struct State;
+
+    static void writeLoop(std::shared_ptr<State> state);
+
+    std::shared_ptr<State> m_state;
+    std::thread m_writer;
+};
+
+/**
+ * @brief Payload stored in an UndoSpillStore
+ */
+class UndoSpillStore::Entry {
+public:
+    ~Entry();
+
+    // Non-copyable
+    Entry(const Entry&) = delete;
+    Entry& operator=(const Entry&) = delete;
+
+    /// Read the bytes back; false if the file is gone or damaged
+    bool read(std::vector<uint8_t>& bytes) const;
+
+    /// Payload size in bytes
+    uint64_t size() const { return m_size; }
+
+private:
+    friend class UndoSpillStore;
+
+    Entry(std::shared_ptr<State> state, uint64_t id, uint64_t size);
+
+    std::shared_ptr<State> m_state;
+    uint64_t m_id;
+    uint64_t m_size;
+};
+
+} // namespace core
+} // namespace dc3d
@@ -5,8 +5,23 @@
 
 #include "BVH.h"
 #include "MeshData.h"
+#include "../core/TaskScheduler.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <istream>
+#include <ostream>
+
+// SIMD backend for 4-wide node tests: SSE2 is baseline on x86-64 and NEON
+// on AArch64; anything else uses the scalar fallback
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define DC3D_BVH_SIMD_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define DC3D_BVH_SIMD_NEON 1
+#endif
 
 namespace dc3d {
 namespace geometry {
@@ -16,6 +31,575 @@ namespace {
     constexpr float EPSILON_RAY = 1e-10f;        // For ray-axis alignment detection
     constexpr float INV_DIR_MAX = 1e10f;         // Maximum inverse direction for axis-aligned rays
     constexpr float EPSILON_PARALLEL = 1e-10f;   // For ray-triangle parallel check
+    constexpr float EPSILON_EXTENT = 1e-10f;     // Centroid extent too small to split
+    constexpr int NUM_BUCKETS = 12;              // SAH bins per split
+    constexpr float SAH_TRAVERSAL_COST = 0.125f; // Relative cost of a node visit
+    constexpr uint32_t PARALLEL_BUILD_THRESHOLD = 4096;     // Prims per subtree worth a task
+    constexpr uint32_t PARALLEL_BINNING_THRESHOLD = 65536;  // Prims per node worth parallel binning
+    constexpr int MAX_STACK_SIZE = 256;          // Wide traversal: 3 entries per level + 4
+    constexpr size_t CLOSEST_POINT_BATCH = 256;  // Coherent queries per parallel batch
+
+// ============================================================================
+// 4-wide SIMD helpers
+// ============================================================================
+
+/// Four floats processed together (one per child slot)
+struct Float4 {
+#if defined(DC3D_BVH_SIMD_SSE)
+    __m128 v;
+    static Float4 load(const float* p) { return {_mm_load_ps(p)}; }
+    static Float4 broadcast(float s) { return {_mm_set1_ps(s)}; }
+#elif defined(DC3D_BVH_SIMD_NEON)
+    float32x4_t v;
+    static Float4 load(const float* p) { return {vld1q_f32(p)}; }
+    static Float4 broadcast(float s) { return {vdupq_n_f32(s)}; }
+#else
+    float v[4];
+    static Float4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    static Float4 broadcast(float s) { return {{s, s, s, s}}; }
+#endif
+};
+
+#if defined(DC3D_BVH_SIMD_SSE)
+
+inline Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Float4 min4(Float4 a, Float4 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline Float4 max4(Float4 a, Float4 b) { return {_mm_max_ps(a.v, b.v)}; }
+inline int lessEqualMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmple_ps(a.v, b.v)); }
+inline int lessMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmplt_ps(a.v, b.v)); }
+inline void store(float* out, Float4 a) { _mm_storeu_ps(out, a.v); }
+
+#elif defined(DC3D_BVH_SIMD_NEON)
+
+inline Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline Float4 operator-(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline Float4 operator*(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline Float4 min4(Float4 a, Float4 b) { return {vminq_f32(a.v, b.v)}; }
+inline Float4 max4(Float4 a, Float4 b) { return {vmaxq_f32(a.v, b.v)}; }
+inline int toMask(uint32x4_t c) {
+    const uint32x4_t bits = {1, 2, 4, 8};
+    return static_cast<int>(vaddvq_u32(vandq_u32(c, bits)));
+}
+inline int lessEqualMask(Float4 a, Float4 b) { return toMask(vcleq_f32(a.v, b.v)); }
+inline int lessMask(Float4 a, Float4 b) { return toMask(vcltq_f32(a.v, b.v)); }
+inline void store(float* out, Float4 a) { vst1q_f32(out, a.v); }
+
+#else
+
+template<typename Op>
+inline Float4 apply(Float4 a, Float4 b, Op op) {
+    return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+}
+inline Float4 operator+(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x + y; }); }
+inline Float4 operator-(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x - y; }); }
+inline Float4 operator*(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return x * y; }); }
+inline Float4 min4(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return std::min(x, y); }); }
+inline Float4 max4(Float4 a, Float4 b) { return apply(a, b, [](float x, float y) { return std::max(x, y); }); }
+inline int lessEqualMask(Float4 a, Float4 b) {
+    int mask = 0;
+    for (int i = 0; i < 4; ++i) mask |= (a.v[i] <= b.v[i]) ? (1 << i) : 0;
+    return mask;
+}
+inline int lessMask(Float4 a, Float4 b) {
+    int mask = 0;
+    for (int i = 0; i < 4; ++i) mask |= (a.v[i] < b.v[i]) ? (1 << i) : 0;
+    return mask;
+}
+inline void store(float* out, Float4 a) { std::copy(a.v, a.v + 4, out); }
+
+#endif
+
+/// Bit mask of the non-empty child slots
+inline int validSlotMask(const BVHWideNode& node) {
+    int mask = 0;
+    for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+        if (!node.isEmpty(i)) mask |= 1 << i;
+    }
+    return mask;
+}
+
+/// Ray data precomputed once per query for 4-wide slab tests
+struct WideRay {
+    Float4 originX, originY, originZ;
+    Float4 invDirX, invDirY, invDirZ;
+    float tMin;
+
+    explicit WideRay(const Ray& ray) {
+        // FIX: Handle axis-aligned rays (division by zero)
+        float inv[3];
+        for (int i = 0; i < 3; ++i) {
+            inv[i] = std::abs(ray.direction[i]) > EPSILON_RAY ?
+                1.0f / ray.direction[i] :
+                std::copysign(INV_DIR_MAX, ray.direction[i]);
+        }
+        originX = Float4::broadcast(ray.origin.x);
+        originY = Float4::broadcast(ray.origin.y);
+        originZ = Float4::broadcast(ray.origin.z);
+        invDirX = Float4::broadcast(inv[0]);
+        invDirY = Float4::broadcast(inv[1]);
+        invDirZ = Float4::broadcast(inv[2]);
+        tMin = ray.tMin;
+    }
+};
+
+/**
+ * @brief Slab test of a ray against the four child boxes of a node
+ * @param tNearOut Output: entry distance per slot
+ * @return Bit mask of slots hit within [ray.tMin, tMax]
+ */
+inline int intersectChildren(const BVHWideNode& node, const WideRay& ray,
+                             float tMax, float tNearOut[4]) {
+    Float4 tx0 = (Float4::load(node.minX) - ray.originX) * ray.invDirX;
+    Float4 tx1 = (Float4::load(node.maxX) - ray.originX) * ray.invDirX;
+    Float4 ty0 = (Float4::load(node.minY) - ray.originY) * ray.invDirY;
+    Float4 ty1 = (Float4::load(node.maxY) - ray.originY) * ray.invDirY;
+    Float4 tz0 = (Float4::load(node.minZ) - ray.originZ) * ray.invDirZ;
+    Float4 tz1 = (Float4::load(node.maxZ) - ray.originZ) * ray.invDirZ;
+
+    Float4 tNear = max4(max4(min4(tx0, tx1), min4(ty0, ty1)),
+                        max4(min4(tz0, tz1), Float4::broadcast(ray.tMin)));
+    Float4 tFar = min4(min4(max4(tx0, tx1), max4(ty0, ty1)),
+                       min4(max4(tz0, tz1), Float4::broadcast(tMax)));
+
+    store(tNearOut, tNear);
+    return lessEqualMask(tNear, tFar) & validSlotMask(node);
+}
+
+/**
+ * @brief Overlap test of an AABB against the four child boxes of a node
+ * @return Bit mask of overlapping slots
+ */
+inline int overlapChildren(const BVHWideNode& node, const AABB& box) {
+    int mask = lessEqualMask(Float4::load(node.minX), Float4::broadcast(box.max.x)) &
+               lessEqualMask(Float4::load(node.minY), Float4::broadcast(box.max.y)) &
+               lessEqualMask(Float4::load(node.minZ), Float4::broadcast(box.max.z)) &
+               lessEqualMask(Float4::broadcast(box.min.x), Float4::load(node.maxX)) &
+               lessEqualMask(Float4::broadcast(box.min.y), Float4::load(node.maxY)) &
+               lessEqualMask(Float4::broadcast(box.min.z), Float4::load(node.maxZ));
+    return mask & validSlotMask(node);
+}
+
+/**
+ * @brief Test the four child boxes of a node against frustum planes
+ * @return Bit mask of slots not fully outside any plane
+ */
+inline int frustumChildren(const BVHWideNode& node, const glm::vec4 frustumPlanes[6]) {
+    const Float4 minX = Float4::load(node.minX), maxX = Float4::load(node.maxX);
+    const Float4 minY = Float4::load(node.minY), maxY = Float4::load(node.maxY);
+    const Float4 minZ = Float4::load(node.minZ), maxZ = Float4::load(node.maxZ);
+    const Float4 zero = Float4::broadcast(0.0f);
+
+    int outside = 0;
+    for (int i = 0; i < 6; ++i) {
+        const glm::vec4& plane = frustumPlanes[i];
+
+        // p-vertex: box corner furthest along the plane normal
+        Float4 px = plane.x >= 0 ? maxX : minX;
+        Float4 py = plane.y >= 0 ? maxY : minY;
+        Float4 pz = plane.z >= 0 ? maxZ : minZ;
+
+        Float4 dist = px * Float4::broadcast(plane.x) +
+                      py * Float4::broadcast(plane.y) +
+                      pz * Float4::broadcast(plane.z) +
+                      Float4::broadcast(plane.w);
+        outside |= lessMask(dist, zero);
+    }
+    return ~outside & validSlotMask(node);
+}
+
+/// Query point broadcast once per closest-point query
+struct WidePoint {
+    Float4 x, y, z;
+
+    explicit WidePoint(const glm::vec3& p)
+        : x(Float4::broadcast(p.x)), y(Float4::broadcast(p.y)), z(Float4::broadcast(p.z)) {}
+};
+
+/**
+ * @brief Squared distance from a point to the four child boxes of a node
+ * @param distSqOut Output: squared distance per slot (0 if inside)
+ * @return Bit mask of slots closer than maxDistSq
+ */
+inline int distanceChildren(const BVHWideNode& node, const WidePoint& point,
+                            float maxDistSq, float distSqOut[4]) {
+    const Float4 zero = Float4::broadcast(0.0f);
+    Float4 dx = max4(max4(Float4::load(node.minX) - point.x, point.x - Float4::load(node.maxX)), zero);
+    Float4 dy = max4(max4(Float4::load(node.minY) - point.y, point.y - Float4::load(node.maxY)), zero);
+    Float4 dz = max4(max4(Float4::load(node.minZ) - point.z, point.z - Float4::load(node.maxZ)), zero);
+    Float4 distSq = dx * dx + dy * dy + dz * dz;
+
+    store(distSqOut, distSq);
+    return lessMask(distSq, Float4::broadcast(maxDistSq)) & validSlotMask(node);
+}
+
+// ============================================================================
+// Build helpers
+// ============================================================================
+
+/**
+ * @brief Binary node used during construction
+ *
+ * Trivially constructible so the worst-case node array (2N - 1) can be
+ * allocated without touching memory that is never used.
+ */
+struct BuildNode {
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t leftChild;   ///< Right child is leftChild + 1
+    uint32_t firstPrim;
+    uint32_t primCount;   ///< 0 for internal nodes
+
+    bool isLeaf() const { return primCount > 0; }
+
+    AABB bounds() const {
+        return AABB(glm::vec3(boundsMin[0], boundsMin[1], boundsMin[2]),
+                    glm::vec3(boundsMax[0], boundsMax[1], boundsMax[2]));
+    }
+
+    void setBounds(const AABB& box) {
+        for (int i = 0; i < 3; ++i) {
+            boundsMin[i] = box.min[i];
+            boundsMax[i] = box.max[i];
+        }
+    }
+};
+
+struct RangeBounds {
+    AABB bounds;      ///< Union of primitive bounds
+    AABB centroids;   ///< Bounds of primitive centroids
+};
+
+struct Bucket {
+    uint32_t count = 0;
+    AABB bounds;
+};
+using BucketArray = std::array<Bucket, NUM_BUCKETS>;
+
+/**
+ * @brief Top-down binned SAH builder
+ *
+ * Subtrees are built as tasks on the shared scheduler. Nodes are taken in
+ * pairs from an atomic counter, and each leaf references a contiguous range
+ * of the primitive array, which is partitioned in place.
+ */
+class BinaryBuilder {
+public:
+    BinaryBuilder(std::vector<PrimitiveInfo>& prims, BuildNode* nodes,
+                  uint32_t maxLeafSize, int maxDepth)
+        : m_prims(prims), m_nodes(nodes), m_maxLeafSize(maxLeafSize), m_maxDepth(maxDepth) {}
+
+    /// Build the subtree rooted at nodeIndex; returns its maximum depth
+    int build(uint32_t nodeIndex, uint32_t start, uint32_t end, int depth) {
+        BuildNode& node = m_nodes[nodeIndex];
+        const uint32_t numPrims = end - start;
+
+        RangeBounds range = computeBounds(start, end);
+        node.setBounds(range.bounds);
+
+        // Create leaf if few primitives or max depth reached
+        if (numPrims <= m_maxLeafSize || depth >= m_maxDepth) {
+            makeLeaf(node, start, end);
+            return depth;
+        }
+
+        int axis = range.centroids.longestAxis();
+        float axisMin = range.centroids.min[axis];
+        float extent = range.centroids.max[axis] - axisMin;
+
+        // Check for degenerate case (all centroids in same place)
+        if (extent < EPSILON_EXTENT) {
+            makeLeaf(node, start, end);
+            return depth;
+        }
+
+        auto bucketOf = [axis, axisMin, extent](const PrimitiveInfo& pi) {
+            int b = static_cast<int>(NUM_BUCKETS * (pi.centroid[axis] - axisMin) / extent);
+            return std::clamp(b, 0, NUM_BUCKETS - 1);
+        };
+
+        BucketArray buckets = computeBuckets(start, end, bucketOf);
+
+        // Sweep from the right, then from the left, to get all split costs
+        float rightArea[NUM_BUCKETS];
+        uint32_t rightCount[NUM_BUCKETS];
+        AABB accum;
+        uint32_t count = 0;
+        for (int i = NUM_BUCKETS - 1; i > 0; --i) {
+            if (buckets[i].count > 0) accum.expand(buckets[i].bounds);
+            count += buckets[i].count;
+            rightArea[i] = accum.isValid() ? accum.surfaceArea() : 0.0f;
+            rightCount[i] = count;
+        }
+
+        const float invArea = 1.0f / range.bounds.surfaceArea();
+        float minCost = std::numeric_limits<float>::max();
+        int minBucket = 0;
+        accum.reset();
+        count = 0;
+        for (int i = 0; i < NUM_BUCKETS - 1; ++i) {
+            if (buckets[i].count > 0) accum.expand(buckets[i].bounds);
+            count += buckets[i].count;
+            float leftArea = accum.isValid() ? accum.surfaceArea() : 0.0f;
+            float cost = SAH_TRAVERSAL_COST +
+                (count * leftArea + rightCount[i + 1] * rightArea[i + 1]) * invArea;
+            if (cost < minCost) {
+                minCost = cost;
+                minBucket = i;
+            }
+        }
+
+        // Partition primitives
+        auto midIter = std::partition(
+            m_prims.begin() + start,
+            m_prims.begin() + end,
+            [&](const PrimitiveInfo& pi) { return bucketOf(pi) <= minBucket; });
+        uint32_t mid = static_cast<uint32_t>(midIter - m_prims.begin());
+
+        // Ensure we actually split
+        if (mid == start || mid == end) {
+            mid = (start + end) / 2;
+            std::nth_element(
+                m_prims.begin() + start,
+                m_prims.begin() + mid,
+                m_prims.begin() + end,
+                [axis](const PrimitiveInfo& a, const PrimitiveInfo& b) {
+                    return a.centroid[axis] < b.centroid[axis];
+                });
+        }
+
+        // Build children
+        const uint32_t left = m_nodeCount.fetch_add(2, std::memory_order_relaxed);
+        node.leftChild = left;
+        node.firstPrim = 0;
+        node.primCount = 0;  // Internal node
+
+        int leftDepth = depth;
+        int rightDepth = depth;
+        if (numPrims >= PARALLEL_BUILD_THRESHOLD) {
+            // Children own disjoint primitive ranges and node slots
+            core::TaskGroup group;
+            group.run([&, left, start, mid]() {
+                leftDepth = build(left, start, mid, depth + 1);
+            });
+            rightDepth = build(left + 1, mid, end, depth + 1);
+            group.wait();
+        } else {
+            leftDepth = build(left, start, mid, depth + 1);
+            rightDepth = build(left + 1, mid, end, depth + 1);
+        }
+        return std::max(leftDepth, rightDepth);
+    }
+
+    uint32_t nodeCount() const { return m_nodeCount.load(); }
+
+private:
+    void makeLeaf(BuildNode& node, uint32_t start, uint32_t end) {
+        node.leftChild = 0;
+        node.firstPrim = start;
+        node.primCount = end - start;
+    }
+
+    RangeBounds computeBounds(uint32_t start, uint32_t end) const {
+        auto map = [this](size_t b, size_t e) {
+            RangeBounds r;
+            for (size_t i = b; i < e; ++i) {
+                r.bounds.expand(m_prims[i].bounds);
+                r.centroids.expand(m_prims[i].centroid);
+            }
+            return r;
+        };
+        if (end - start < PARALLEL_BINNING_THRESHOLD) {
+            return map(start, end);
+        }
+        return core::parallelReduce(start, end, RangeBounds{}, map,
+            [](RangeBounds a, const RangeBounds& b) {
+                a.bounds.expand(b.bounds);
+                a.centroids.expand(b.centroids);
+                return a;
+            });
+    }
+
+    template<typename BucketOf>
+    BucketArray computeBuckets(uint32_t start, uint32_t end, const BucketOf& bucketOf) const {
+        auto map = [this, &bucketOf](size_t b, size_t e) {
+            BucketArray buckets{};
+            for (size_t i = b; i < e; ++i) {
+                Bucket& bucket = buckets[bucketOf(m_prims[i])];
+                bucket.count++;
+                bucket.bounds.expand(m_prims[i].bounds);
+            }
+            return buckets;
+        };
+        if (end - start < PARALLEL_BINNING_THRESHOLD) {
+            return map(start, end);
+        }
+        return core::parallelReduce(start, end, BucketArray{}, map,
+            [](BucketArray a, const BucketArray& b) {
+                for (int i = 0; i < NUM_BUCKETS; ++i) {
+                    a[i].count += b[i].count;
+                    if (b[i].count > 0) a[i].bounds.expand(b[i].bounds);
+                }
+                return a;
+            });
+    }
+
+    std::vector<PrimitiveInfo>& m_prims;
+    BuildNode* m_nodes;
+    uint32_t m_maxLeafSize;
+    int m_maxDepth;
+    std::atomic<uint32_t> m_nodeCount{1};  ///< Root is node 0
+};
+
+/// Reset a wide node to four empty slots
+void initWideNode(BVHWideNode& node) {
+    AABB empty;
+    for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+        node.setChildBounds(i, empty);
+        node.child[i] = 0;
+        node.count[i] = BVHWideNode::EMPTY_SLOT;
+    }
+}
+
+/**
+ * @brief Collapse a binary subtree into 4-wide nodes (depth-first order)
+ *
+ * Repeatedly opens the inner child with the largest surface area until the
+ * node has four children, which keeps the wide tree close to SAH-optimal.
+ *
+ * @return Index of the wide node
+ */
+uint32_t collapseToWide(const BuildNode* buildNodes, uint32_t buildIndex,
+                        std::vector<BVHWideNode>& wideNodes) {
+    const uint32_t wideIndex = static_cast<uint32_t>(wideNodes.size());
+    wideNodes.emplace_back();
+    initWideNode(wideNodes[wideIndex]);
+
+    uint32_t slots[BVHWideNode::WIDTH];
+    int slotCount = 0;
+    slots[slotCount++] = buildNodes[buildIndex].leftChild;
+    slots[slotCount++] = buildNodes[buildIndex].leftChild + 1;
+
+    while (slotCount < BVHWideNode::WIDTH) {
+        int best = -1;
+        float bestArea = -1.0f;
+        for (int i = 0; i < slotCount; ++i) {
+            const BuildNode& candidate = buildNodes[slots[i]];
+            float area = candidate.bounds().surfaceArea();
+            if (!candidate.isLeaf() && area > bestArea) {
+                best = i;
+                bestArea = area;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+
+        uint32_t opened = slots[best];
+        slots[best] = buildNodes[opened].leftChild;
+        slots[slotCount++] = buildNodes[opened].leftChild + 1;
+    }
+
+    for (int i = 0; i < slotCount; ++i) {
+        const BuildNode& childNode = buildNodes[slots[i]];
+        uint32_t child = childNode.isLeaf()
+            ? childNode.firstPrim
+            : collapseToWide(buildNodes, slots[i], wideNodes);
+
+        // Recursion may reallocate wideNodes: index again
+        BVHWideNode& node = wideNodes[wideIndex];
+        node.setChildBounds(i, childNode.bounds());
+        node.child[i] = child;
+        node.count[i] = childNode.primCount;
+    }
+
+    return wideIndex;
+}
+
+/**
+ * @brief Build a 4-wide tree over primitives (binary SAH, then collapse)
+ *
+ * prims is partitioned in place. Leaves reference ranges of primIndices,
+ * which maps leaf slots back to PrimitiveInfo::index.
+ *
+ * @return Maximum depth of the binary build tree
+ */
+int buildWideTree(std::vector<PrimitiveInfo>& prims, uint32_t maxLeafSize, int maxDepth,
+                  std::vector<BVHWideNode>& nodes, std::vector<uint32_t>& primIndices,
+                  AABB& bounds) {
+    const size_t numPrims = prims.size();
+
+    // Binary SAH tree; worst case 2N - 1 nodes, only the used part is touched
+    std::unique_ptr<BuildNode[]> buildNodes(new BuildNode[numPrims * 2]);
+    BinaryBuilder builder(prims, buildNodes.get(), maxLeafSize, maxDepth);
+    int depth = builder.build(0, 0, static_cast<uint32_t>(numPrims), 0);
+
+    // Leaves reference ranges of the partitioned primitive array
+    primIndices.resize(numPrims);
+    core::parallelFor(0, numPrims, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            primIndices[i] = prims[i].index;
+        }
+    });
+
+    // Collapse to the 4-wide traversal tree
+    const BuildNode& root = buildNodes[0];
+    bounds = root.bounds();
+    nodes.reserve(builder.nodeCount() / 2 + 1);
+    if (root.isLeaf()) {
+        nodes.emplace_back();
+        initWideNode(nodes[0]);
+        nodes[0].setChildBounds(0, bounds);
+        nodes[0].child[0] = root.firstPrim;
+        nodes[0].count[0] = root.primCount;
+    } else {
+        collapseToWide(buildNodes.get(), 0, nodes);
+    }
+    nodes.shrink_to_fit();
+
+    return depth;
+}
+
+/// Union of all non-empty child slots of a wide node
+AABB wideNodeBounds(const BVHWideNode& node) {
+    AABB box;
+    for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+        if (!node.isEmpty(i)) {
+            box.expand(node.childBounds(i));
+        }
+    }
+    return box;
+}
+
+/// Recompute inner slot bounds bottom-up (children follow their parent)
+void refitInnerSlots(std::vector<BVHWideNode>& nodes) {
+    for (size_t n = nodes.size(); n-- > 0;) {
+        BVHWideNode& node = nodes[n];
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            if (node.isInner(i)) {
+                node.setChildBounds(i, wideNodeBounds(nodes[node.child[i]]));
+            }
+        }
+    }
+}
+
+/// SAH contribution of one child slot (area * expected work below it)
+double slotCost(const BVHWideNode& node, int slot) {
+    if (node.isEmpty(slot)) {
+        return 0.0;
+    }
+    double work = node.isLeaf(slot) ? static_cast<double>(node.count[slot]) : SAH_TRAVERSAL_COST;
+    return node.childBounds(slot).surfaceArea() * work;
+}
+
+/// Traversal stack entry: inner node (count == 0) or leaf range
+struct StackEntry {
+    uint32_t child;
+    uint32_t count;
+    float tNear;     ///< Ray entry distance, or squared box distance for point queries
+};
+
 } // anonymous namespace
 
 // ============================================================================
@@ -26,23 +610,22 @@ bool AABB::intersect(const Ray& ray, float& tNear, float& tFar) const
 {
     // Slab-based ray-AABB intersection
     // FIX: Handle axis-aligned rays (division by zero)
-    const float eps = 1e-10f;
     glm::vec3 invDir;
     for (int i = 0; i < 3; ++i) {
-        invDir[i] = std::abs(ray.direction[i]) > eps ? 
-            1.0f / ray.direction[i] : 
-            std::copysign(1e10f, ray.direction[i]);
+        invDir[i] = std::abs(ray.direction[i]) > EPSILON_RAY ?
+            1.0f / ray.direction[i] :
+            std::copysign(INV_DIR_MAX, ray.direction[i]);
     }
-    
+
     glm::vec3 t0 = (min - ray.origin) * invDir;
     glm::vec3 t1 = (max - ray.origin) * invDir;
-    
+
     glm::vec3 tSmall = glm::min(t0, t1);
     glm::vec3 tLarge = glm::max(t0, t1);
-    
+
     tNear = std::max({tSmall.x, tSmall.y, tSmall.z, ray.tMin});
     tFar = std::min({tLarge.x, tLarge.y, tLarge.z, ray.tMax});
-    
+
     return tNear <= tFar;
 }
 
@@ -58,58 +641,66 @@ BVH::BVH(const MeshData& mesh)
 void BVH::build(const MeshData& mesh)
 {
     clear();
-    
+
     // CRITICAL FIX: Use isValid() instead of isEmpty() to catch corrupted mesh data
     // isEmpty() only checks if vectors are non-empty, but doesn't validate indices
     if (mesh.isEmpty() || !mesh.isValid()) {
         return;
     }
-    
-    // Copy mesh data for thread safety
-    m_vertices = mesh.vertices();
-    m_indices = mesh.indices();
-    
+
+    // Share the mesh arrays (copy-on-write, so later mesh edits don't reach us)
+    m_vertices = mesh.vertexArray();
+    m_indices = mesh.indexArray();
+    const auto& vertices = m_vertices.read();
+    const auto& indices = m_indices.read();
+
     size_t numTriangles = mesh.faceCount();
     if (numTriangles == 0) {
         return;
     }
-    
-    size_t vertexCount = m_vertices.size();
-    
+
+    size_t vertexCount = vertices.size();
+
     // Build primitive info list
     std::vector<PrimitiveInfo> primitiveInfo(numTriangles);
-    
-    for (size_t i = 0; i < numTriangles; ++i) {
-        uint32_t i0 = m_indices[i * 3 + 0];
-        uint32_t i1 = m_indices[i * 3 + 1];
-        uint32_t i2 = m_indices[i * 3 + 2];
-        
-        // CRITICAL FIX: Bounds check to prevent crash on corrupted mesh data
-        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) {
-            // Clear and return - mesh is corrupted
-            clear();
-            return;
+    std::atomic<bool> corrupted{false};
+
+    core::parallelFor(0, numTriangles, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t i0 = indices[i * 3 + 0];
+            uint32_t i1 = indices[i * 3 + 1];
+            uint32_t i2 = indices[i * 3 + 2];
+
+            // CRITICAL FIX: Bounds check to prevent crash on corrupted mesh data
+            if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) {
+                corrupted.store(true, std::memory_order_relaxed);
+                return;
+            }
+
+            const glm::vec3& v0 = vertices[i0];
+            const glm::vec3& v1 = vertices[i1];
+            const glm::vec3& v2 = vertices[i2];
+
+            primitiveInfo[i].index = static_cast<uint32_t>(i);
+            primitiveInfo[i].bounds.reset();
+            primitiveInfo[i].bounds.expand(v0);
+            primitiveInfo[i].bounds.expand(v1);
+            primitiveInfo[i].bounds.expand(v2);
+            primitiveInfo[i].centroid = (v0 + v1 + v2) / 3.0f;
         }
-        
-        const glm::vec3& v0 = m_vertices[i0];
-        const glm::vec3& v1 = m_vertices[i1];
-        const glm::vec3& v2 = m_vertices[i2];
-        
-        primitiveInfo[i].index = static_cast<uint32_t>(i);
-        primitiveInfo[i].bounds.reset();
-        primitiveInfo[i].bounds.expand(v0);
-        primitiveInfo[i].bounds.expand(v1);
-        primitiveInfo[i].bounds.expand(v2);
-        primitiveInfo[i].centroid = (v0 + v1 + v2) / 3.0f;
+    });
+
+    if (corrupted.load()) {
+        // Clear and return - mesh is corrupted
+        clear();
+        return;
     }
+
+    m_maxDepth = buildWideTree(primitiveInfo, MAX_LEAF_SIZE, MAX_DEPTH,
+                               m_nodes, m_primitiveIndices, m_bounds);
     
-    // Reserve nodes (rough estimate: 2*n - 1 for full binary tree)
-    m_nodes.reserve(numTriangles * 2);
-    m_primitiveIndices.reserve(numTriangles);
-    
-    // Build tree recursively
-    m_maxDepth = 0;
-    buildRecursive(primitiveInfo, 0, static_cast<uint32_t>(numTriangles), 0);
+    m_slotCost = computeSlotCosts();
+    m_builtSahCost = sahCost();
 }
 
 void BVH::clear()
@@ -118,180 +709,330 @@ void BVH::clear()
     m_primitiveIndices.clear();
     m_vertices.clear();
     m_indices.clear();
+    m_bounds.reset();
+    m_parents.clear();
+    m_triangleNodes.clear();
+    m_slotCost = 0.0;
+    m_builtSahCost = 0.0f;
     m_maxDepth = 0;
 }
 
-uint32_t BVH::buildRecursive(std::vector<PrimitiveInfo>& prims,
-                              uint32_t start, uint32_t end, int depth)
+// ============================================================================
+// Serialization
+// ============================================================================
+
+namespace {
+
+template<typename T>
+void writeRaw(std::ostream& out, const T& value)
 {
-    m_maxDepth = std::max(m_maxDepth, depth);
-    
-    uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
-    m_nodes.emplace_back();
-    BVHNode& node = m_nodes[nodeIndex];
-    
-    // Compute bounds of all primitives in range
-    node.bounds.reset();
-    for (uint32_t i = start; i < end; ++i) {
-        node.bounds.expand(prims[i].bounds);
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool readRaw(std::istream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template<typename T>
+void writeArray(std::ostream& out, const std::vector<T>& values)
+{
+    writeRaw(out, static_cast<uint64_t>(values.size()));
+    out.write(reinterpret_cast<const char*>(values.data()),
+              static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template<typename T>
+bool readArray(std::istream& in, std::vector<T>& values, uint64_t maxCount)
+{
+    uint64_t count = 0;
+    if (!readRaw(in, count) || count > maxCount) {
+        return false;
     }
+    values.resize(static_cast<size_t>(count));
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()),
+                                     static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+// Identifies the node layout the data was written with
+constexpr uint32_t BVH_STREAM_VERSION = 1;
+constexpr uint32_t BVH_STREAM_LAYOUT = sizeof(BVHWideNode) << 8 | BVHWideNode::WIDTH;
+
+} // anonymous namespace
+
+bool BVH::save(std::ostream& out) const
+{
+    writeRaw(out, BVH_STREAM_VERSION);
+    writeRaw(out, BVH_STREAM_LAYOUT);
+    writeRaw(out, static_cast<uint64_t>(m_indices.read().size() / 3));
+    writeRaw(out, m_bounds);
+    writeRaw(out, m_slotCost);
+    writeRaw(out, m_builtSahCost);
+    writeRaw(out, static_cast<int32_t>(m_maxDepth));
+    writeArray(out, m_nodes);
+    writeArray(out, m_primitiveIndices);
+    return static_cast<bool>(out);
+}
+
+bool BVH::load(std::istream& in, const MeshData& mesh)
+{
+    clear();
     
-    uint32_t numPrims = end - start;
+    if (mesh.isEmpty() || !mesh.isValid()) {
+        return false;
+    }
     
-    // Create leaf if few primitives or max depth reached
-    if (numPrims <= MAX_LEAF_SIZE || depth >= MAX_DEPTH) {
-        node.firstPrim = static_cast<uint32_t>(m_primitiveIndices.size());
-        node.primCount = numPrims;
-        
-        for (uint32_t i = start; i < end; ++i) {
-            m_primitiveIndices.push_back(prims[i].index);
-        }
-        
-        return nodeIndex;
+    const uint64_t numTriangles = mesh.faceCount();
+    uint32_t version = 0, layout = 0;
+    uint64_t triangles = 0;
+    int32_t maxDepth = 0;
+    bool ok = readRaw(in, version) && version == BVH_STREAM_VERSION
+           && readRaw(in, layout) && layout == BVH_STREAM_LAYOUT
+           && readRaw(in, triangles) && triangles == numTriangles
+           && readRaw(in, m_bounds)
+           && readRaw(in, m_slotCost)
+           && readRaw(in, m_builtSahCost)
+           && readRaw(in, maxDepth)
+           && readArray(in, m_nodes, numTriangles)   // A wide tree has fewer nodes than triangles
+           && readArray(in, m_primitiveIndices, numTriangles)
+           && m_primitiveIndices.size() == numTriangles
+           && !m_nodes.empty();
+    
+    // Every link must stay inside the arrays
+    if (ok) {
+        std::atomic<bool> broken{false};
+        const size_t nodeCount = m_nodes.size();
+        core::parallelFor(0, nodeCount, [&](size_t begin, size_t end) {
+            for (size_t n = begin; n < end; ++n) {
+                const BVHWideNode& node = m_nodes[n];
+                for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+                    if ((node.isInner(i) && (node.child[i] <= n || node.child[i] >= nodeCount)) ||
+                        (node.isLeaf(i) && (node.child[i] > numTriangles ||
+                                            node.count[i] > numTriangles - node.child[i]))) {
+                        broken.store(true, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+            }
+        });
+        core::parallelFor(0, m_primitiveIndices.size(), [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p) {
+                if (m_primitiveIndices[p] >= numTriangles) {
+                    broken.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+        });
+        ok = !broken.load();
     }
     
-    // Compute centroid bounds for splitting
-    AABB centroidBounds;
-    for (uint32_t i = start; i < end; ++i) {
-        centroidBounds.expand(prims[i].centroid);
+    if (!ok) {
+        clear();
+        return false;
     }
     
-    int axis = centroidBounds.longestAxis();
+    m_maxDepth = maxDepth;
+    m_vertices = mesh.vertexArray();
+    m_indices = mesh.indexArray();
+    return true;
+}
+
+// ============================================================================
+// Refit
+// ============================================================================
+
+bool BVH::hasSameTopology(const MeshData& mesh) const
+{
+    // Any index edit unshares the mesh's array from ours (copy-on-write),
+    // so this also catches rewrites that keep the triangle count
+    return mesh.vertices().size() == m_vertices.read().size() &&
+           m_indices.sharesWith(mesh.indexArray());
+}
+
+AABB BVH::leafBounds(uint32_t firstPrim, uint32_t primCount) const
+{
+    const auto& vertices = m_vertices.read();
+    const auto& indices = m_indices.read();
+    AABB box;
+    for (uint32_t i = firstPrim; i < firstPrim + primCount; ++i) {
+        uint32_t tri = m_primitiveIndices[i];
+        box.expand(vertices[indices[tri * 3 + 0]]);
+        box.expand(vertices[indices[tri * 3 + 1]]);
+        box.expand(vertices[indices[tri * 3 + 2]]);
+    }
+    return box;
+}
+
+double BVH::refitNode(uint32_t nodeIndex)
+{
+    BVHWideNode& node = m_nodes[nodeIndex];
+    double costDelta = 0.0;
     
-    // Check for degenerate case (all centroids in same place)
-    float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
-    if (extent < 1e-10f) {
-        // Can't split meaningfully, create leaf
-        node.firstPrim = static_cast<uint32_t>(m_primitiveIndices.size());
-        node.primCount = numPrims;
-        
-        for (uint32_t i = start; i < end; ++i) {
-            m_primitiveIndices.push_back(prims[i].index);
+    for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+        if (node.isEmpty(i)) {
+            continue;
         }
         
-        return nodeIndex;
+        double oldCost = slotCost(node, i);
+        node.setChildBounds(i, node.isLeaf(i)
+            ? leafBounds(node.child[i], node.count[i])
+            : wideNodeBounds(m_nodes[node.child[i]]));
+        costDelta += slotCost(node, i) - oldCost;
     }
     
-    // Use SAH (Surface Area Heuristic) for best split
-    constexpr int NUM_BUCKETS = 12;
-    
-    struct Bucket {
-        uint32_t count = 0;
-        AABB bounds;
-    };
-    Bucket buckets[NUM_BUCKETS];
-    
-    for (uint32_t i = start; i < end; ++i) {
-        int b = static_cast<int>(
-            NUM_BUCKETS * (prims[i].centroid[axis] - centroidBounds.min[axis]) / extent);
-        b = std::clamp(b, 0, NUM_BUCKETS - 1);
-        buckets[b].count++;
-        buckets[b].bounds.expand(prims[i].bounds);
-    }
-    
-    // Compute costs for splitting after each bucket
-    float costs[NUM_BUCKETS - 1];
-    
-    for (int i = 0; i < NUM_BUCKETS - 1; ++i) {
-        AABB b0, b1;
-        uint32_t count0 = 0, count1 = 0;
-        
-        for (int j = 0; j <= i; ++j) {
-            if (buckets[j].count > 0) {
-                b0.expand(buckets[j].bounds);
-                count0 += buckets[j].count;
+    return costDelta;
+}
+
+double BVH::computeSlotCosts() const
+{
+    return core::parallelReduce(0, m_nodes.size(), 0.0,
+        [this](size_t begin, size_t end) {
+            double cost = 0.0;
+            for (size_t n = begin; n < end; ++n) {
+                for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+                    cost += slotCost(m_nodes[n], i);
+                }
             }
-        }
-        
-        for (int j = i + 1; j < NUM_BUCKETS; ++j) {
-            if (buckets[j].count > 0) {
-                b1.expand(buckets[j].bounds);
-                count1 += buckets[j].count;
+            return cost;
+        },
+        [](double a, double b) { return a + b; });
+}
+
+void BVH::buildRefitLinks()
+{
+    m_parents.assign(m_nodes.size(), 0);
+    m_triangleNodes.assign(m_indices.read().size() / 3, 0);
+    
+    core::parallelFor(0, m_nodes.size(), [this](size_t begin, size_t end) {
+        for (size_t n = begin; n < end; ++n) {
+            const BVHWideNode& node = m_nodes[n];
+            for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+                if (node.isInner(i)) {
+                    m_parents[node.child[i]] = static_cast<uint32_t>(n);
+                } else if (node.isLeaf(i)) {
+                    for (uint32_t p = node.child[i]; p < node.child[i] + node.count[i]; ++p) {
+                        m_triangleNodes[m_primitiveIndices[p]] = static_cast<uint32_t>(n);
+                    }
+                }
             }
         }
-        
-        float area0 = b0.isValid() ? b0.surfaceArea() : 0.0f;
-        float area1 = b1.isValid() ? b1.surfaceArea() : 0.0f;
-        costs[i] = 0.125f + (count0 * area0 + count1 * area1) / node.bounds.surfaceArea();
+    });
+}
+
+bool BVH::refit(const MeshData& mesh)
+{
+    if (m_nodes.empty() || !hasSameTopology(mesh)) {
+        return false;
     }
     
-    // Find best split
-    float minCost = costs[0];
-    int minBucket = 0;
-    for (int i = 1; i < NUM_BUCKETS - 1; ++i) {
-        if (costs[i] < minCost) {
-            minCost = costs[i];
-            minBucket = i;
+    m_vertices = mesh.vertexArray();
+    
+    // Leaf slots are independent: refit them in parallel
+    core::parallelFor(0, m_nodes.size(), [this](size_t begin, size_t end) {
+        for (size_t n = begin; n < end; ++n) {
+            BVHWideNode& node = m_nodes[n];
+            for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+                if (node.isLeaf(i)) {
+                    node.setChildBounds(i, leafBounds(node.child[i], node.count[i]));
+                }
+            }
         }
+    });
+    
+    // Inner slots bottom-up
+    refitInnerSlots(m_nodes);
+    
+    m_bounds = wideNodeBounds(m_nodes[0]);
+    m_slotCost = computeSlotCosts();
+    return true;
+}
+
+bool BVH::refit(const MeshData& mesh, const std::vector<uint32_t>& dirtyTriangles)
+{
+    if (m_nodes.empty() || !hasSameTopology(mesh)) {
+        return false;
     }
     
-    // Check if split is worth it
-    float leafCost = static_cast<float>(numPrims);
+    if (m_parents.empty()) {
+        buildRefitLinks();
+    }
     
-    if (numPrims > MAX_LEAF_SIZE || minCost < leafCost) {
-        // Partition primitives
-        auto midIter = std::partition(
-            prims.begin() + start,
-            prims.begin() + end,
-            [&](const PrimitiveInfo& pi) {
-                int b = static_cast<int>(
-                    NUM_BUCKETS * (pi.centroid[axis] - centroidBounds.min[axis]) / extent);
-                b = std::clamp(b, 0, NUM_BUCKETS - 1);
-                return b <= minBucket;
-            });
-        
-        uint32_t mid = static_cast<uint32_t>(midIter - prims.begin());
-        
-        // Ensure we actually split
-        if (mid == start || mid == end) {
-            mid = (start + end) / 2;
-            std::nth_element(
-                prims.begin() + start,
-                prims.begin() + mid,
-                prims.begin() + end,
-                [axis](const PrimitiveInfo& a, const PrimitiveInfo& b) {
-                    return a.centroid[axis] < b.centroid[axis];
-                });
+    // Take the moved positions and collect the leaves' nodes
+    m_vertices = mesh.vertexArray();
+    const size_t faceCount = m_indices.read().size() / 3;
+    std::vector<uint32_t> pending;
+    pending.reserve(dirtyTriangles.size());
+    for (uint32_t tri : dirtyTriangles) {
+        if (tri >= faceCount) {
+            continue;
         }
+        pending.push_back(m_triangleNodes[tri]);
+    }
+    
+    // Children have larger indices than their parents, so processing the
+    // largest pending index first refits every node after its children
+    std::make_heap(pending.begin(), pending.end());
+    uint32_t previous = BVHWideNode::EMPTY_SLOT;
+    while (!pending.empty()) {
+        std::pop_heap(pending.begin(), pending.end());
+        uint32_t nodeIndex = pending.back();
+        pending.pop_back();
         
-        // Build children
-        node.leftChild = buildRecursive(prims, start, mid, depth + 1);
-        node.rightChild = buildRecursive(prims, mid, end, depth + 1);
-        node.primCount = 0;  // Internal node
+        if (nodeIndex == previous) {
+            continue;  // Duplicates pop consecutively
+        }
+        previous = nodeIndex;
         
-        return nodeIndex;
+        m_slotCost += refitNode(nodeIndex);
+        if (nodeIndex != 0) {
+            pending.push_back(m_parents[nodeIndex]);
+            std::push_heap(pending.begin(), pending.end());
+        }
     }
     
-    // Create leaf
-    node.firstPrim = static_cast<uint32_t>(m_primitiveIndices.size());
-    node.primCount = numPrims;
-    
-    for (uint32_t i = start; i < end; ++i) {
-        m_primitiveIndices.push_back(prims[i].index);
+    m_bounds = wideNodeBounds(m_nodes[0]);
+    return true;
+}
+
+float BVH::sahCost() const
+{
+    float rootArea = m_bounds.isValid() ? m_bounds.surfaceArea() : 0.0f;
+    if (m_nodes.empty() || rootArea <= 0.0f) {
+        return 0.0f;
     }
-    
-    return nodeIndex;
+    return static_cast<float>(SAH_TRAVERSAL_COST + m_slotCost / rootArea);
+}
+
+float BVH::degradation() const
+{
+    if (m_builtSahCost <= 0.0f) {
+        return 1.0f;
+    }
+    return sahCost() / m_builtSahCost;
 }
 
 bool BVH::intersectTriangle(const Ray& ray, uint32_t triIndex,
                             float& t, glm::vec3& bary) const
 {
+    const auto& vertices = m_vertices.read();
+    const auto& indices = m_indices.read();
     // FIX: Bounds check on triangle and vertex indices
-    if (triIndex * 3 + 2 >= m_indices.size()) return false;
+    if (triIndex * 3 + 2 >= indices.size()) return false;
     
     // Möller–Trumbore intersection algorithm
-    uint32_t i0 = m_indices[triIndex * 3 + 0];
-    uint32_t i1 = m_indices[triIndex * 3 + 1];
-    uint32_t i2 = m_indices[triIndex * 3 + 2];
+    uint32_t i0 = indices[triIndex * 3 + 0];
+    uint32_t i1 = indices[triIndex * 3 + 1];
+    uint32_t i2 = indices[triIndex * 3 + 2];
     
     // FIX: Validate vertex indices
-    if (i0 >= m_vertices.size() || i1 >= m_vertices.size() || i2 >= m_vertices.size()) {
+    if (i0 >= vertices.size() || i1 >= vertices.size() || i2 >= vertices.size()) {
         return false;
     }
     
-    const glm::vec3& v0 = m_vertices[i0];
-    const glm::vec3& v1 = m_vertices[i1];
-    const glm::vec3& v2 = m_vertices[i2];
+    const glm::vec3& v0 = vertices[i0];
+    const glm::vec3& v1 = vertices[i1];
+    const glm::vec3& v2 = vertices[i2];
     
     glm::vec3 e1 = v1 - v0;
     glm::vec3 e2 = v2 - v0;
@@ -300,7 +1041,7 @@ bool BVH::intersectTriangle(const Ray& ray, uint32_t triIndex,
     float a = glm::dot(e1, h);
     
     // Check if ray is parallel to triangle
-    if (std::abs(a) < 1e-10f) {
+    if (std::abs(a) < EPSILON_PARALLEL) {
         return false;
     }
     
@@ -329,223 +1070,510 @@ bool BVH::intersectTriangle(const Ray& ray, uint32_t triIndex,
     return true;
 }
 
-void BVH::intersectNode(const Ray& ray, uint32_t nodeIndex,
-                        BVHHitResult& result) const
+BVHHitResult BVH::intersect(const Ray& ray) const
 {
-    const BVHNode& node = m_nodes[nodeIndex];
-    
-    float tNear, tFar;
-    if (!node.bounds.intersect(ray, tNear, tFar)) {
-        return;
-    }
-    
-    // Early out if we already have a closer hit
-    if (tNear > result.t) {
-        return;
+    const auto& vertices = m_vertices.read();
+    const auto& indices = m_indices.read();
+    BVHHitResult result;
+
+    if (m_nodes.empty()) {
+        return result;
     }
-    
-    if (node.isLeaf()) {
-        // Test all triangles in leaf
-        for (uint32_t i = 0; i < node.primCount; ++i) {
-            uint32_t triIndex = m_primitiveIndices[node.firstPrim + i];
-            
-            float t;
-            glm::vec3 bary;
-            if (intersectTriangle(ray, triIndex, t, bary)) {
-                if (t < result.t) {
+
+    const WideRay wideRay(ray);
+
+    StackEntry stack[MAX_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = {0, 0, ray.tMin};
+
+    while (stackSize > 0) {
+        const StackEntry entry = stack[--stackSize];
+
+        // Early out if we already have a closer hit
+        if (entry.tNear > result.t) {
+            continue;
+        }
+
+        if (entry.count > 0) {
+            // Test all triangles in leaf
+            for (uint32_t i = 0; i < entry.count; ++i) {
+                uint32_t triIndex = m_primitiveIndices[entry.child + i];
+
+                float t;
+                glm::vec3 bary;
+                if (intersectTriangle(ray, triIndex, t, bary) && t < result.t) {
                     result.hit = true;
                     result.t = t;
                     result.faceIndex = triIndex;
                     result.point = ray.at(t);
                     result.barycentric = bary;
-                    
+
                     // Get vertex indices
-                    result.indices[0] = m_indices[triIndex * 3 + 0];
-                    result.indices[1] = m_indices[triIndex * 3 + 1];
-                    result.indices[2] = m_indices[triIndex * 3 + 2];
-                    
+                    result.indices[0] = indices[triIndex * 3 + 0];
+                    result.indices[1] = indices[triIndex * 3 + 1];
+                    result.indices[2] = indices[triIndex * 3 + 2];
+
                     // Compute interpolated normal
-                    const glm::vec3& v0 = m_vertices[result.indices[0]];
-                    const glm::vec3& v1 = m_vertices[result.indices[1]];
-                    const glm::vec3& v2 = m_vertices[result.indices[2]];
+                    const glm::vec3& v0 = vertices[result.indices[0]];
+                    const glm::vec3& v1 = vertices[result.indices[1]];
+                    const glm::vec3& v2 = vertices[result.indices[2]];
                     result.normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
                 }
             }
+            continue;
         }
-    } else {
-        // Traverse children (front-to-back)
-        const BVHNode& left = m_nodes[node.leftChild];
-        const BVHNode& right = m_nodes[node.rightChild];
-        
-        float tLeftNear, tLeftFar, tRightNear, tRightFar;
-        bool hitLeft = left.bounds.intersect(ray, tLeftNear, tLeftFar);
-        bool hitRight = right.bounds.intersect(ray, tRightNear, tRightFar);
-        
-        if (hitLeft && hitRight) {
-            // Visit closer child first
-            if (tLeftNear < tRightNear) {
-                intersectNode(ray, node.leftChild, result);
-                if (tRightNear < result.t) {
-                    intersectNode(ray, node.rightChild, result);
-                }
-            } else {
-                intersectNode(ray, node.rightChild, result);
-                if (tLeftNear < result.t) {
-                    intersectNode(ray, node.leftChild, result);
+
+        const BVHWideNode& node = m_nodes[entry.child];
+        float tNear[BVHWideNode::WIDTH];
+        int mask = intersectChildren(node, wideRay, std::min(ray.tMax, result.t), tNear);
+
+        // Push hit children far-to-near so the nearest is popped first
+        StackEntry hits[BVHWideNode::WIDTH];
+        int hitCount = 0;
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            if (mask & (1 << i)) {
+                StackEntry hit{node.child[i], node.count[i], tNear[i]};
+                int j = hitCount++;
+                while (j > 0 && hits[j - 1].tNear < hit.tNear) {
+                    hits[j] = hits[j - 1];
+                    --j;
                 }
+                hits[j] = hit;
             }
-        } else if (hitLeft) {
-            intersectNode(ray, node.leftChild, result);
-        } else if (hitRight) {
-            intersectNode(ray, node.rightChild, result);
+        }
+        for (int i = 0; i < hitCount; ++i) {
+            stack[stackSize++] = hits[i];
         }
     }
+
+    return result;
 }
 
-BVHHitResult BVH::intersect(const Ray& ray) const
+bool BVH::intersectAny(const Ray& ray, float maxDist) const
 {
-    BVHHitResult result;
-    
     if (m_nodes.empty()) {
-        return result;
+        return false;
     }
-    
-    intersectNode(ray, 0, result);
-    return result;
+
+    const WideRay wideRay(ray);
+    const float tMax = std::min(ray.tMax, maxDist);
+
+    StackEntry stack[MAX_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = {0, 0, ray.tMin};
+
+    while (stackSize > 0) {
+        const StackEntry entry = stack[--stackSize];
+
+        if (entry.count > 0) {
+            for (uint32_t i = 0; i < entry.count; ++i) {
+                uint32_t triIndex = m_primitiveIndices[entry.child + i];
+
+                float t;
+                glm::vec3 bary;
+                if (intersectTriangle(ray, triIndex, t, bary) && t < maxDist) {
+                    return true;
+                }
+            }
+            continue;
+        }
+
+        const BVHWideNode& node = m_nodes[entry.child];
+        float tNear[BVHWideNode::WIDTH];
+        int mask = intersectChildren(node, wideRay, tMax, tNear);
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            if (mask & (1 << i)) {
+                stack[stackSize++] = {node.child[i], node.count[i], tNear[i]};
+            }
+        }
+    }
+
+    return false;
 }
 
-bool BVH::intersectNodeAny(const Ray& ray, uint32_t nodeIndex, float maxDist) const
+std::vector<uint32_t> BVH::queryFrustum(const glm::vec4 frustumPlanes[6]) const
 {
-    const BVHNode& node = m_nodes[nodeIndex];
-    
-    float tNear, tFar;
-    if (!node.bounds.intersect(ray, tNear, tFar)) {
-        return false;
+    std::vector<uint32_t> results;
+
+    // FIX Bug 19: Validate frustumPlanes pointer before use
+    if (frustumPlanes == nullptr || m_nodes.empty()) {
+        return results;
     }
-    
-    if (tNear > maxDist) {
+
+    uint32_t stack[MAX_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHWideNode& node = m_nodes[stack[--stackSize]];
+        int mask = frustumChildren(node, frustumPlanes);
+
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            if (!(mask & (1 << i))) {
+                continue;
+            }
+            if (node.isLeaf(i)) {
+                results.insert(results.end(),
+                               m_primitiveIndices.begin() + node.child[i],
+                               m_primitiveIndices.begin() + node.child[i] + node.count[i]);
+            } else {
+                stack[stackSize++] = node.child[i];
+            }
+        }
+    }
+
+    return results;
+}
+
+std::vector<uint32_t> BVH::queryAABB(const AABB& box) const
+{
+    std::vector<uint32_t> results;
+
+    if (m_nodes.empty()) {
+        return results;
+    }
+
+    // Stack-based traversal
+    uint32_t stack[MAX_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHWideNode& node = m_nodes[stack[--stackSize]];
+        int mask = overlapChildren(node, box);
+
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            if (!(mask & (1 << i))) {
+                continue;
+            }
+            if (node.isLeaf(i)) {
+                results.insert(results.end(),
+                               m_primitiveIndices.begin() + node.child[i],
+                               m_primitiveIndices.begin() + node.child[i] + node.count[i]);
+            } else {
+                stack[stackSize++] = node.child[i];
+            }
+        }
+    }
+
+    return results;
+}
+
+// ============================================================================
+// Closest-Point Queries
+// ============================================================================
+
+bool BVH::closestOnTriangle(const glm::vec3& point, uint32_t triIndex,
+                            float& bestDistSq, BVHClosestPointResult& result) const
+{
+    const auto& vertices = m_vertices.read();
+    const auto& indices = m_indices.read();
+    const glm::vec3& v0 = vertices[indices[triIndex * 3 + 0]];
+    const glm::vec3& v1 = vertices[indices[triIndex * 3 + 1]];
+    const glm::vec3& v2 = vertices[indices[triIndex * 3 + 2]];
+
+    glm::vec3 bary;
+    glm::vec3 cp = closestPointOnTriangle(point, v0, v1, v2, bary);
+    glm::vec3 diff = cp - point;
+    float distSq = glm::dot(diff, diff);
+
+    if (distSq >= bestDistSq) {
         return false;
     }
-    
-    if (node.isLeaf()) {
-        for (uint32_t i = 0; i < node.primCount; ++i) {
-            uint32_t triIndex = m_primitiveIndices[node.firstPrim + i];
-            
-            float t;
-            glm::vec3 bary;
-            if (intersectTriangle(ray, triIndex, t, bary)) {
-                if (t < maxDist) {
-                    return true;
+    bestDistSq = distSq;
+    result.found = true;
+    result.faceIndex = triIndex;
+    result.point = cp;
+    result.barycentric = bary;
+    return true;
+}
+
+void BVH::closestPointTraverse(const glm::vec3& point, float& bestDistSq,
+                               BVHClosestPointResult& result) const
+{
+    const WidePoint widePoint(point);
+
+    StackEntry stack[MAX_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = {0, 0, 0.0f};
+
+    while (stackSize > 0) {
+        const StackEntry entry = stack[--stackSize];
+
+        // Box further than the best triangle so far
+        if (entry.tNear >= bestDistSq) {
+            continue;
+        }
+
+        if (entry.count > 0) {
+            for (uint32_t i = 0; i < entry.count; ++i) {
+                closestOnTriangle(point, m_primitiveIndices[entry.child + i], bestDistSq, result);
+            }
+            continue;
+        }
+
+        const BVHWideNode& node = m_nodes[entry.child];
+        float distSq[BVHWideNode::WIDTH];
+        int mask = distanceChildren(node, widePoint, bestDistSq, distSq);
+
+        // Push far-to-near so the nearest box is searched first
+        StackEntry near[BVHWideNode::WIDTH];
+        int nearCount = 0;
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            if (mask & (1 << i)) {
+                StackEntry child{node.child[i], node.count[i], distSq[i]};
+                int j = nearCount++;
+                while (j > 0 && near[j - 1].tNear < child.tNear) {
+                    near[j] = near[j - 1];
+                    --j;
                 }
+                near[j] = child;
             }
         }
-        return false;
+        for (int i = 0; i < nearCount; ++i) {
+            stack[stackSize++] = near[i];
+        }
     }
-    
-    return intersectNodeAny(ray, node.leftChild, maxDist) ||
-           intersectNodeAny(ray, node.rightChild, maxDist);
 }
 
-bool BVH::intersectAny(const Ray& ray, float maxDist) const
+void BVH::finishClosestPoint(float bestDistSq, BVHClosestPointResult& result) const
+{
+    if (!result.found) {
+        return;
+    }
+    result.distance = std::sqrt(bestDistSq);
+
+    const auto& vertices = m_vertices.read();
+    const auto& indices = m_indices.read();
+    const glm::vec3& v0 = vertices[indices[result.faceIndex * 3 + 0]];
+    const glm::vec3& v1 = vertices[indices[result.faceIndex * 3 + 1]];
+    const glm::vec3& v2 = vertices[indices[result.faceIndex * 3 + 2]];
+    glm::vec3 n = glm::cross(v1 - v0, v2 - v0);
+    float len = glm::length(n);
+    result.normal = len > 0.0f ? n / len : glm::vec3(0.0f);
+}
+
+BVHClosestPointResult BVH::closestPoint(const glm::vec3& point, float maxDist) const
+{
+    return closestPoint(point, maxDist, std::numeric_limits<uint32_t>::max());
+}
+
+BVHClosestPointResult BVH::closestPoint(const glm::vec3& point, float maxDist,
+                                        uint32_t hintFace) const
+{
+    BVHClosestPointResult result;
+
+    if (m_nodes.empty() || !(maxDist >= 0.0f)) {
+        return result;
+    }
+
+    // Strict '<' comparisons below; nudge so a point exactly at maxDist counts
+    float bestDistSq = maxDist * maxDist;
+    bestDistSq = std::nextafter(bestDistSq, std::numeric_limits<float>::infinity());
+
+    if (hintFace < m_indices.read().size() / 3) {
+        closestOnTriangle(point, hintFace, bestDistSq, result);
+    }
+    closestPointTraverse(point, bestDistSq, result);
+    finishClosestPoint(bestDistSq, result);
+
+    return result;
+}
+
+std::vector<BVHClosestPointResult> BVH::closestPoints(
+    const std::vector<glm::vec3>& points, float maxDist,
+    const core::CancellationToken* cancel) const
 {
+    std::vector<BVHClosestPointResult> results(points.size());
+
     if (m_nodes.empty()) {
-        return false;
+        return results;
     }
-    
-    return intersectNodeAny(ray, 0, maxDist);
+
+    core::parallelFor(0, points.size(), [&](size_t begin, size_t end) {
+        uint32_t hint = std::numeric_limits<uint32_t>::max();
+        for (size_t i = begin; i < end; ++i) {
+            results[i] = closestPoint(points[i], maxDist, hint);
+            if (results[i].found) {
+                hint = results[i].faceIndex;
+            }
+        }
+    }, CLOSEST_POINT_BATCH, cancel);
+
+    return results;
 }
 
-bool BVH::aabbInFrustum(const AABB& box, const glm::vec4 frustumPlanes[6]) const
+// ============================================================================
+// InstanceBVH Implementation
+// ============================================================================
+
+void InstanceBVH::build(const std::vector<AABB>& bounds)
 {
-    // Test AABB against each frustum plane
-    for (int i = 0; i < 6; ++i) {
-        glm::vec3 normal(frustumPlanes[i].x, frustumPlanes[i].y, frustumPlanes[i].z);
-        float d = frustumPlanes[i].w;
-        
-        // Find the p-vertex (furthest along normal direction)
-        glm::vec3 p = box.min;
-        if (normal.x >= 0) p.x = box.max.x;
-        if (normal.y >= 0) p.y = box.max.y;
-        if (normal.z >= 0) p.z = box.max.z;
-        
-        // If p-vertex is outside, box is fully outside
-        if (glm::dot(normal, p) + d < 0) {
+    clear();
+    m_instanceBounds = bounds;
+
+    std::vector<PrimitiveInfo> prims;
+    prims.reserve(bounds.size());
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        if (bounds[i].isValid()) {
+            prims.push_back({static_cast<uint32_t>(i), bounds[i], bounds[i].center()});
+        }
+    }
+    if (prims.empty()) {
+        return;
+    }
+
+    buildWideTree(prims, MAX_LEAF_SIZE, MAX_DEPTH, m_nodes, m_instanceIndices, m_rootBounds);
+    m_builtSahCost = sahCost();
+}
+
+bool InstanceBVH::refit(const std::vector<AABB>& bounds)
+{
+    if (bounds.size() != m_instanceBounds.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        if (bounds[i].isValid() != m_instanceBounds[i].isValid()) {
             return false;
         }
     }
-    
+
+    m_instanceBounds = bounds;
+    if (m_nodes.empty()) {
+        return true;
+    }
+
+    for (BVHWideNode& node : m_nodes) {
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            if (node.isLeaf(i)) {
+                AABB box;
+                for (uint32_t p = node.child[i]; p < node.child[i] + node.count[i]; ++p) {
+                    box.expand(m_instanceBounds[m_instanceIndices[p]]);
+                }
+                node.setChildBounds(i, box);
+            }
+        }
+    }
+    refitInnerSlots(m_nodes);
+
+    m_rootBounds = wideNodeBounds(m_nodes[0]);
     return true;
 }
 
-void BVH::queryFrustumNode(uint32_t nodeIndex, const glm::vec4 frustumPlanes[6],
-                           std::vector<uint32_t>& results) const
+void InstanceBVH::clear()
 {
-    const BVHNode& node = m_nodes[nodeIndex];
-    
-    if (!aabbInFrustum(node.bounds, frustumPlanes)) {
-        return;
+    m_nodes.clear();
+    m_instanceIndices.clear();
+    m_instanceBounds.clear();
+    m_rootBounds.reset();
+    m_builtSahCost = 0.0f;
+}
+
+float InstanceBVH::sahCost() const
+{
+    float rootArea = m_rootBounds.isValid() ? m_rootBounds.surfaceArea() : 0.0f;
+    if (m_nodes.empty() || rootArea <= 0.0f) {
+        return 0.0f;
     }
-    
-    if (node.isLeaf()) {
-        for (uint32_t i = 0; i < node.primCount; ++i) {
-            results.push_back(m_primitiveIndices[node.firstPrim + i]);
+
+    double cost = 0.0;
+    for (const BVHWideNode& node : m_nodes) {
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            cost += slotCost(node, i);
         }
-    } else {
-        queryFrustumNode(node.leftChild, frustumPlanes, results);
-        queryFrustumNode(node.rightChild, frustumPlanes, results);
     }
+    return static_cast<float>(SAH_TRAVERSAL_COST + cost / rootArea);
 }
 
-std::vector<uint32_t> BVH::queryFrustum(const glm::vec4 frustumPlanes[6]) const
+void InstanceBVH::intersect(const Ray& ray, const RayVisitor& visit) const
 {
-    std::vector<uint32_t> results;
-    
-    // FIX Bug 19: Validate frustumPlanes pointer before use
-    if (frustumPlanes == nullptr || m_nodes.empty()) {
-        return results;
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    const WideRay wideRay(ray);
+    float tMax = ray.tMax;
+
+    StackEntry stack[MAX_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = {0, 0, ray.tMin};
+
+    while (stackSize > 0) {
+        const StackEntry entry = stack[--stackSize];
+
+        if (entry.tNear > tMax) {
+            continue;
+        }
+
+        if (entry.count > 0) {
+            // Shared leaves (coincident centroids) test each instance box
+            for (uint32_t i = 0; i < entry.count; ++i) {
+                uint32_t instance = m_instanceIndices[entry.child + i];
+                float tNear = entry.tNear;
+                float tFar = tMax;
+                if (entry.count == 1 ||
+                    (m_instanceBounds[instance].intersect(ray, tNear, tFar) && tNear <= tMax)) {
+                    tMax = std::min(tMax, visit(instance, tMax));
+                }
+            }
+            continue;
+        }
+
+        const BVHWideNode& node = m_nodes[entry.child];
+        float tNear[BVHWideNode::WIDTH];
+        int mask = intersectChildren(node, wideRay, tMax, tNear);
+
+        // Push hit children far-to-near so the nearest is popped first
+        StackEntry hits[BVHWideNode::WIDTH];
+        int hitCount = 0;
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            if (mask & (1 << i)) {
+                StackEntry hit{node.child[i], node.count[i], tNear[i]};
+                int j = hitCount++;
+                while (j > 0 && hits[j - 1].tNear < hit.tNear) {
+                    hits[j] = hits[j - 1];
+                    --j;
+                }
+                hits[j] = hit;
+            }
+        }
+        for (int i = 0; i < hitCount; ++i) {
+            stack[stackSize++] = hits[i];
+        }
     }
-    
-    queryFrustumNode(0, frustumPlanes, results);
-    
-    return results;
 }
 
-std::vector<uint32_t> BVH::queryAABB(const AABB& box) const
+std::vector<uint32_t> InstanceBVH::queryFrustum(const glm::vec4 frustumPlanes[6]) const
 {
     std::vector<uint32_t> results;
-    
-    if (m_nodes.empty()) {
+
+    if (frustumPlanes == nullptr || m_nodes.empty()) {
         return results;
     }
-    
-    // Stack-based traversal
-    std::vector<uint32_t> stack;
-    stack.reserve(64);
-    stack.push_back(0);
-    
-    while (!stack.empty()) {
-        uint32_t nodeIndex = stack.back();
-        stack.pop_back();
-        
-        const BVHNode& node = m_nodes[nodeIndex];
-        
-        // Check AABB overlap
-        if (box.max.x < node.bounds.min.x || box.min.x > node.bounds.max.x ||
-            box.max.y < node.bounds.min.y || box.min.y > node.bounds.max.y ||
-            box.max.z < node.bounds.min.z || box.min.z > node.bounds.max.z) {
-            continue;
-        }
-        
-        if (node.isLeaf()) {
-            for (uint32_t i = 0; i < node.primCount; ++i) {
-                results.push_back(m_primitiveIndices[node.firstPrim + i]);
+
+    uint32_t stack[MAX_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const BVHWideNode& node = m_nodes[stack[--stackSize]];
+        int mask = frustumChildren(node, frustumPlanes);
+
+        for (int i = 0; i < BVHWideNode::WIDTH; ++i) {
+            if (!(mask & (1 << i))) {
+                continue;
+            }
+            if (node.isLeaf(i)) {
+                results.insert(results.end(),
+                               m_instanceIndices.begin() + node.child[i],
+                               m_instanceIndices.begin() + node.child[i] + node.count[i]);
+            } else {
+                stack[stackSize++] = node.child[i];
             }
-        } else {
-            stack.push_back(node.leftChild);
-            stack.push_back(node.rightChild);
         }
     }
-    
+
+    std::sort(results.begin(), results.end());
     return results;
 }
 
@@ -3,18 +3,34 @@
  * @brief Bounding Volume Hierarchy for efficient ray-mesh intersection
  * 
  * Provides O(log n) ray-triangle intersection for picking operations.
- * Uses a top-down SAH (Surface Area Heuristic) construction method.
+ * Uses a top-down binned SAH (Surface Area Heuristic) construction, with
+ * subtrees built in parallel, then collapses the binary tree into a 4-wide
+ * BVH whose child bounds are stored SoA so one node is tested against a
+ * ray, box, frustum or query point with a single set of SIMD operations.
+ * 
+ * Besides picking, the BVH answers closest-point queries and is the shared
+ * point-to-surface structure for deviation analysis, shrink-wrap and snapping.
+ * InstanceBVH reuses the same builder and node layout as a top-level tree
+ * over the world bounds of whole meshes.
  */
 
 #pragma once
 
 #include <vector>
 #include <memory>
+#include <functional>
 #include <cstdint>
+#include <iosfwd>
 #include <limits>
 #include <glm/glm.hpp>
 
+#include "SharedArray.h"
+
 namespace dc3d {
+namespace core {
+class CancellationToken;
+}
+
 namespace geometry {
 
 // Forward declaration
@@ -50,6 +66,18 @@ struct BVHHitResult {
     uint32_t indices[3] = {0, 0, 0};
 };
 
+/**
+ * @brief Result of a closest-point query
+ */
+struct BVHClosestPointResult {
+    bool found = false;                              ///< False if nothing within maxDist
+    float distance = std::numeric_limits<float>::max();  ///< Distance to closest point
+    uint32_t faceIndex = 0;                          ///< Triangle index
+    glm::vec3 point{0.0f};                          ///< Closest point on surface
+    glm::vec3 normal{0.0f};                         ///< Face normal of closest triangle
+    glm::vec3 barycentric{0.0f};                    ///< Barycentric coordinates (u, v, w)
+};
+
 /**
  * @brief Axis-aligned bounding box for BVH nodes
  */
@@ -111,16 +139,40 @@ struct AABB {
 };
 
 /**
- * @brief BVH node structure
+ * @brief 4-wide BVH node with SoA child bounds
+ *
+ * Children are packed into the first slots. A slot is either an inner node
+ * (count == 0, child = node index), a leaf (count = primitive count, child =
+ * first primitive) or empty (count == EMPTY_SLOT).
  */
-struct BVHNode {
-    AABB bounds;
-    uint32_t leftChild = 0;   ///< Index of left child (0 if leaf)
-    uint32_t rightChild = 0;  ///< Index of right child (0 if leaf)
-    uint32_t firstPrim = 0;   ///< First primitive index (for leaves)
-    uint32_t primCount = 0;   ///< Number of primitives (0 if internal node)
-    
-    bool isLeaf() const { return primCount > 0; }
+struct BVHWideNode {
+    static constexpr int WIDTH = 4;
+    static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+    
+    alignas(16) float minX[WIDTH];
+    alignas(16) float minY[WIDTH];
+    alignas(16) float minZ[WIDTH];
+    alignas(16) float maxX[WIDTH];
+    alignas(16) float maxY[WIDTH];
+    alignas(16) float maxZ[WIDTH];
+    uint32_t child[WIDTH];
+    uint32_t count[WIDTH];
+    
+    bool isEmpty(int slot) const { return count[slot] == EMPTY_SLOT; }
+    bool isLeaf(int slot) const { return count[slot] != 0 && count[slot] != EMPTY_SLOT; }
+    bool isInner(int slot) const { return count[slot] == 0; }
+    
+    /// Get bounds of one child slot
+    AABB childBounds(int slot) const {
+        return AABB(glm::vec3(minX[slot], minY[slot], minZ[slot]),
+                    glm::vec3(maxX[slot], maxY[slot], maxZ[slot]));
+    }
+    
+    /// Set bounds of one child slot
+    void setChildBounds(int slot, const AABB& box) {
+        minX[slot] = box.min.x; minY[slot] = box.min.y; minZ[slot] = box.min.z;
+        maxX[slot] = box.max.x; maxY[slot] = box.max.y; maxZ[slot] = box.max.z;
+    }
 };
 
 /**
@@ -138,6 +190,7 @@ struct PrimitiveInfo {
  * Usage:
  * 1. Create BVH with mesh data: BVH bvh(meshData);
  * 2. Query with ray: BVHHitResult result = bvh.intersect(ray);
+ * 3. Or query a point: BVHClosestPointResult cp = bvh.closestPoint(point);
  */
 class BVH {
 public:
@@ -160,10 +213,86 @@ public:
      */
     void clear();
     
+    /**
+     * @brief Write the built tree to a stream
+     * 
+     * Only the tree is written, not the mesh. The data is host-endian and
+     * tied to this node layout; it is meant for DerivedDataCache, not as
+     * an interchange format.
+     * 
+     * @return false on write error
+     */
+    bool save(std::ostream& out) const;
+    
+    /**
+     * @brief Restore a tree written by save() for the same mesh
+     * 
+     * The tree is checked against the mesh (triangle count, node links and
+     * primitive indices), so stale or damaged data is rejected rather than
+     * crashing later queries.
+     * 
+     * @param in Stream positioned at data written by save()
+     * @param mesh The mesh the tree was built from
+     * @return false if the data is unreadable or does not fit the mesh (the BVH is then empty)
+     */
+    bool load(std::istream& in, const MeshData& mesh);
+    
+    /**
+     * @brief Update node bounds after vertices moved (topology unchanged)
+     * 
+     * Recomputes leaf bounds in parallel and inner bounds bottom-up,
+     * keeping the tree structure. Much cheaper than build(), but the tree
+     * degrades as the geometry drifts from the one it was built for; check
+     * needsRebuild() afterwards.
+     * 
+     * @param mesh The mesh the BVH was built from, with moved vertices
+     * @return false if the vertex count changed or the indices were edited
+     *         or replaced (call build())
+     */
+    bool refit(const MeshData& mesh);
+    
+    /**
+     * @brief Update node bounds for a set of moved triangles
+     * 
+     * Only the leaves holding the given triangles and their ancestors are
+     * touched. Every triangle that uses a moved vertex must be listed.
+     * 
+     * @param mesh The mesh the BVH was built from, with moved vertices
+     * @param dirtyTriangles Indices of triangles whose vertices moved
+     * @return false if the vertex count changed or the indices were edited
+     *         or replaced (call build())
+     */
+    bool refit(const MeshData& mesh, const std::vector<uint32_t>& dirtyTriangles);
+    
+    /**
+     * @brief SAH cost of the tree, normalized by the root surface area
+     * 
+     * Expected cost of a random ray in triangle-test units; lower is better.
+     */
+    float sahCost() const;
+    
+    /**
+     * @brief Current SAH cost relative to the cost right after build()
+     * 
+     * 1.0 for a fresh tree; grows as refits stretch the node bounds.
+     */
+    float degradation() const;
+    
+    /**
+     * @brief Check if refits degraded the tree enough to warrant build()
+     * @param maxDegradation Allowed degradation() before rebuilding
+     */
+    bool needsRebuild(float maxDegradation = DEFAULT_MAX_DEGRADATION) const {
+        return degradation() > maxDegradation;
+    }
+    
+    /// Default degradation() threshold for needsRebuild()
+    static constexpr float DEFAULT_MAX_DEGRADATION = 1.5f;
+    
     /**
      * @brief Check if BVH is valid
      */
-    bool isValid() const { return !m_nodes.empty() && !m_vertices.empty(); }
+    bool isValid() const { return !m_nodes.empty() && !m_vertices.read().empty(); }
     
     /**
      * @brief Find closest ray intersection
@@ -195,47 +324,94 @@ public:
      */
     std::vector<uint32_t> queryAABB(const AABB& box) const;
     
+    /**
+     * @brief Find the closest point on the mesh surface
+     * 
+     * Children are visited nearest-first and pruned once their box is
+     * further away than the best triangle found so far.
+     * 
+     * @param point Query point
+     * @param maxDist Only report surface points within this distance
+     * @return Closest point info (found == false if nothing within maxDist)
+     */
+    BVHClosestPointResult closestPoint(const glm::vec3& point,
+                                       float maxDist = std::numeric_limits<float>::max()) const;
+    
+    /**
+     * @brief Find the closest point, seeded with a nearby triangle
+     * 
+     * The distance to hintFace is the initial search bound. For spatially
+     * coherent query sequences the previous query's face is a tight bound
+     * and prunes most of the tree. An out-of-range hint is ignored.
+     */
+    BVHClosestPointResult closestPoint(const glm::vec3& point, float maxDist,
+                                       uint32_t hintFace) const;
+    
+    /**
+     * @brief Find the closest surface point for many query points
+     * 
+     * Points are processed in parallel batches; within a batch each query is
+     * seeded with the previous result, so spatially sorted input (e.g. Morton
+     * order) is much faster than random order.
+     * 
+     * @param points Query points
+     * @param maxDist Only report surface points within this distance
+     * @param cancel Optional cancellation token (unprocessed entries stay not found)
+     * @return One result per query point, in input order
+     */
+    std::vector<BVHClosestPointResult> closestPoints(
+        const std::vector<glm::vec3>& points,
+        float maxDist = std::numeric_limits<float>::max(),
+        const core::CancellationToken* cancel = nullptr) const;
+    
     /**
      * @brief Get bounds of entire BVH
      */
-    const AABB& bounds() const { return m_nodes.empty() ? m_emptyAABB : m_nodes[0].bounds; }
+    const AABB& bounds() const { return m_nodes.empty() ? m_emptyAABB : m_bounds; }
     
     /**
-     * @brief Get node count (for debugging/stats)
+     * @brief Get wide node count (for debugging/stats)
      */
     size_t nodeCount() const { return m_nodes.size(); }
     
     /**
-     * @brief Get max depth (for debugging/stats)
+     * @brief Get max depth of the binary build tree (for debugging/stats)
      */
     int maxDepth() const { return m_maxDepth; }
 
 private:
-    // Build methods
-    uint32_t buildRecursive(std::vector<PrimitiveInfo>& prims, 
-                            uint32_t start, uint32_t end, int depth);
-    
     // Intersection helpers
     bool intersectTriangle(const Ray& ray, uint32_t triIndex,
                           float& t, glm::vec3& bary) const;
     
-    void intersectNode(const Ray& ray, uint32_t nodeIndex,
-                      BVHHitResult& result) const;
+    // Closest-point helpers
+    bool closestOnTriangle(const glm::vec3& point, uint32_t triIndex,
+                           float& bestDistSq, BVHClosestPointResult& result) const;
+    void closestPointTraverse(const glm::vec3& point, float& bestDistSq,
+                              BVHClosestPointResult& result) const;
+    void finishClosestPoint(float bestDistSq, BVHClosestPointResult& result) const;
     
-    bool intersectNodeAny(const Ray& ray, uint32_t nodeIndex, float maxDist) const;
-    
-    void queryFrustumNode(uint32_t nodeIndex, const glm::vec4 frustumPlanes[6],
-                         std::vector<uint32_t>& results) const;
-    
-    bool aabbInFrustum(const AABB& box, const glm::vec4 frustumPlanes[6]) const;
+    // Refit helpers
+    bool hasSameTopology(const MeshData& mesh) const;
+    AABB leafBounds(uint32_t firstPrim, uint32_t primCount) const;
+    double refitNode(uint32_t nodeIndex);
+    double computeSlotCosts() const;
+    void buildRefitLinks();
     
     // Data
-    std::vector<BVHNode> m_nodes;
+    std::vector<BVHWideNode> m_nodes;
     std::vector<uint32_t> m_primitiveIndices;  ///< Reordered triangle indices
+    AABB m_bounds;                             ///< Bounds of the whole tree
+    
+    // Refit state
+    std::vector<uint32_t> m_parents;           ///< Parent of each wide node (built on demand)
+    std::vector<uint32_t> m_triangleNodes;     ///< Wide node holding each triangle (built on demand)
+    double m_slotCost = 0.0;                   ///< Sum of slot area * cost, unnormalized
+    float m_builtSahCost = 0.0f;               ///< sahCost() right after build()
     
-    // Mesh reference data (copied for thread safety)
-    std::vector<glm::vec3> m_vertices;
-    std::vector<uint32_t> m_indices;
+    // Mesh reference data (shared copy-on-write with the mesh)
+    SharedArray<glm::vec3> m_vertices;
+    SharedArray<uint32_t> m_indices;
     
     int m_maxDepth = 0;
     static constexpr int MAX_LEAF_SIZE = 4;  ///< Max triangles per leaf
@@ -244,6 +420,88 @@ private:
     AABB m_emptyAABB;  ///< Empty AABB for empty BVH
 };
 
+/**
+ * @brief Top-level BVH over the bounding boxes of mesh instances
+ * 
+ * Scene queries first find the instances whose world bounds are hit and
+ * only then descend into each instance's own BVH, so cost grows with the
+ * number of candidate meshes rather than the number of meshes in the scene.
+ * 
+ * Instances are identified by their index in the bounds array. An invalid
+ * (empty) box leaves the instance out of the tree, e.g. for hidden meshes.
+ */
+class InstanceBVH {
+public:
+    /**
+     * @brief Called for each instance whose box the ray enters before tMax
+     * @return The new tMax (closest hit so far), or tMax if nothing closer
+     */
+    using RayVisitor = std::function<float(uint32_t instance, float tMax)>;
+    
+    InstanceBVH() = default;
+    
+    /**
+     * @brief Build the tree from instance bounds
+     * @param bounds World-space box per instance (invalid box = excluded)
+     */
+    void build(const std::vector<AABB>& bounds);
+    
+    /**
+     * @brief Update node bounds after instances moved
+     * @param bounds New box per instance
+     * @return false if the instance count or the set of excluded
+     *         instances changed (call build())
+     */
+    bool refit(const std::vector<AABB>& bounds);
+    
+    /**
+     * @brief Clear the tree
+     */
+    void clear();
+    
+    /**
+     * @brief Check if any instance is in the tree
+     */
+    bool isValid() const { return !m_nodes.empty(); }
+    
+    /**
+     * @brief SAH cost of the tree, normalized by the root surface area
+     */
+    float sahCost() const;
+    
+    /**
+     * @brief Check if refits degraded the tree enough to warrant build()
+     */
+    bool needsRebuild(float maxDegradation = BVH::DEFAULT_MAX_DEGRADATION) const {
+        return m_builtSahCost > 0.0f && sahCost() / m_builtSahCost > maxDegradation;
+    }
+    
+    /**
+     * @brief Visit instances hit by a ray, roughly nearest-first
+     * 
+     * Boxes entered beyond the tMax returned by the visitor are skipped, so
+     * reporting each hit prunes the instances behind it.
+     */
+    void intersect(const Ray& ray, const RayVisitor& visit) const;
+    
+    /**
+     * @brief Get instances whose box is not fully outside a frustum
+     * @param frustumPlanes 6 frustum planes (normals pointing inward)
+     * @return Instance indices in ascending order
+     */
+    std::vector<uint32_t> queryFrustum(const glm::vec4 frustumPlanes[6]) const;
+
+private:
+    static constexpr int MAX_LEAF_SIZE = 1;  ///< Instances per leaf (more only if centroids coincide)
+    static constexpr int MAX_DEPTH = 64;     ///< Max tree depth
+    
+    std::vector<BVHWideNode> m_nodes;
+    std::vector<uint32_t> m_instanceIndices;  ///< Leaf slot -> instance
+    std::vector<AABB> m_instanceBounds;       ///< Box per instance
+    AABB m_rootBounds;
+    float m_builtSahCost = 0.0f;              ///< sahCost() right after build()
+};
+
 /**
  * @brief Utility: Compute closest point on triangle to a given point
  */
@@ -0,0 +1,378 @@
+/**
+ * @file DerivedDataCache.cpp
+ * @brief Implementation of the on-disk derived data cache
+ */
+
+#include "DerivedDataCache.h"
+#include "BVH.h"
+#include "MeshData.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace dc3d {
+namespace geometry {
+
+namespace {
+
+// Entry file: header, then the payload written by the caller
+constexpr char ENTRY_MAGIC[4] = {'D', 'C', 'D', 'C'};
+constexpr uint32_t ENTRY_VERSION = 1;
+constexpr const char* ENTRY_EXTENSION = ".dcc";
+
+// Stream buffer for entry files (payloads are large sequential arrays)
+constexpr size_t ENTRY_BUFFER_BYTES = 1 << 20;
+
+struct EntryHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint64_t payloadBytes;
+};
+
+template<typename T>
+void writeArray(std::ostream& out, const std::vector<T>& values)
+{
+    uint64_t count = values.size();
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(values.data()),
+              static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template<typename T>
+bool readArray(std::istream& in, std::vector<T>& values, uint64_t remainingBytes)
+{
+    uint64_t count = 0;
+    if (!in.read(reinterpret_cast<char*>(&count), sizeof(count)) ||
+        count > remainingBytes / sizeof(T)) {
+        return false;
+    }
+    values.resize(static_cast<size_t>(count));
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()),
+                                     static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+// Unique name for a temporary file next to the entry
+std::filesystem::path temporaryPath(const std::filesystem::path& path)
+{
+    static std::atomic<uint64_t> counter{0};
+    uint64_t id = (std::hash<std::thread::id>{}(std::this_thread::get_id()) << 16) ^ counter++;
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx.tmp", static_cast<unsigned long long>(id));
+    std::filesystem::path result = path;
+    result += suffix;
+    return result;
+}
+
+} // anonymous namespace
+
+DerivedDataCache& DerivedDataCache::instance()
+{
+    static DerivedDataCache cache;
+    return cache;
+}
+
+void DerivedDataCache::setDirectory(const std::filesystem::path& directory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directory = directory;
+}
+
+std::filesystem::path DerivedDataCache::directory() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_directory;
+}
+
+void DerivedDataCache::setMaxBytes(uint64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxBytes = bytes;
+}
+
+uint64_t DerivedDataCache::maxBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxBytes;
+}
+
+void DerivedDataCache::setEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_enabled = enabled;
+}
+
+bool DerivedDataCache::isEnabled() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_enabled && !m_directory.empty();
+}
+
+uint64_t DerivedDataCache::combineKey(uint64_t key, uint64_t value)
+{
+    // splitmix64 finalizer over the pair
+    uint64_t h = key ^ (value + 0x9E3779B97F4A7C15ULL + (key << 6) + (key >> 2));
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+bool DerivedDataCache::activeDirectory(std::filesystem::path& directory) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_enabled || m_directory.empty()) {
+        return false;
+    }
+    directory = m_directory;
+    return true;
+}
+
+std::filesystem::path DerivedDataCache::entryPath(const std::filesystem::path& directory,
+                                                  uint64_t key, const std::string& kind) const
+{
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx-", static_cast<unsigned long long>(key));
+    return directory / (name + kind + ENTRY_EXTENSION);
+}
+
+bool DerivedDataCache::store(uint64_t key, const std::string& kind, const Writer& write)
+{
+    std::filesystem::path directory;
+    if (!activeDirectory(directory)) {
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    const std::filesystem::path path = entryPath(directory, key, kind);
+    const std::filesystem::path tmpPath = temporaryPath(path);
+
+    bool ok = false;
+    {
+        std::vector<char> buffer(ENTRY_BUFFER_BYTES);
+        std::ofstream out;
+        out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.open(tmpPath, std::ios::binary | std::ios::trunc);
+        if (out) {
+            EntryHeader header{{ENTRY_MAGIC[0], ENTRY_MAGIC[1], ENTRY_MAGIC[2], ENTRY_MAGIC[3]},
+                               ENTRY_VERSION, key, 0};
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            if (write(out) && out) {
+                // Patch in the payload size now that it is known
+                auto end = out.tellp();
+                header.payloadBytes = static_cast<uint64_t>(end) - sizeof(header);
+                out.seekp(0);
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                out.close();
+                ok = !out.fail();
+            }
+        }
+    }
+
+    if (ok) {
+        std::filesystem::rename(tmpPath, path, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    trim(directory);
+    return true;
+}
+
+bool DerivedDataCache::load(uint64_t key, const std::string& kind, const Reader& read)
+{
+    std::filesystem::path directory;
+    if (!activeDirectory(directory)) {
+        return false;
+    }
+
+    const std::filesystem::path path = entryPath(directory, key, kind);
+    std::error_code ec;
+    const uint64_t fileSize = std::filesystem::file_size(path, ec);
+    if (ec || fileSize < sizeof(EntryHeader)) {
+        return false;
+    }
+
+    std::vector<char> buffer(ENTRY_BUFFER_BYTES);
+    std::ifstream in;
+    in.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    in.open(path, std::ios::binary);
+
+    EntryHeader header{};
+    if (!in || !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        !std::equal(ENTRY_MAGIC, ENTRY_MAGIC + 4, header.magic) ||
+        header.version != ENTRY_VERSION || header.key != key ||
+        header.payloadBytes != fileSize - sizeof(EntryHeader)) {
+        return false;
+    }
+
+    if (!read(in)) {
+        return false;
+    }
+
+    // Mark as recently used for trim()
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return true;
+}
+
+void DerivedDataCache::clear()
+{
+    std::filesystem::path directory = this->directory();
+    if (directory.empty()) {
+        return;
+    }
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.path().extension() == ENTRY_EXTENSION) {
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+}
+
+void DerivedDataCache::trim(const std::filesystem::path& directory)
+{
+    struct Entry {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUsed;
+        uint64_t bytes;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code ec;
+    for (const auto& item : std::filesystem::directory_iterator(directory, ec)) {
+        if (item.path().extension() != ENTRY_EXTENSION) continue;
+        std::error_code itemError;
+        Entry entry{item.path(), item.last_write_time(itemError), item.file_size(itemError)};
+        if (itemError) continue;
+        total += entry.bytes;
+        entries.push_back(std::move(entry));
+    }
+
+    const uint64_t limit = maxBytes();
+    if (total <= limit) {
+        return;
+    }
+
+    // Oldest first
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.lastUsed < b.lastUsed;
+    });
+    for (const Entry& entry : entries) {
+        if (total <= limit) break;
+        if (std::filesystem::remove(entry.path, ec)) {
+            total -= entry.bytes;
+        }
+    }
+}
+
+bool DerivedDataCache::storeMesh(uint64_t key, const std::string& kind, const MeshData& mesh)
+{
+    return store(key, kind, [&mesh](std::ostream& out) {
+        writeArray(out, mesh.vertices());
+        writeArray(out, mesh.indices());
+        writeArray(out, mesh.normals());
+        writeArray(out, mesh.uvs());
+        return static_cast<bool>(out);
+    });
+}
+
+bool DerivedDataCache::loadMesh(uint64_t key, const std::string& kind, MeshData& mesh)
+{
+    MeshData loaded;
+    bool ok = load(key, kind, [&loaded](std::istream& in) {
+        // Array counts are bounded by what is left of the file
+        std::streampos start = in.tellg();
+        in.seekg(0, std::ios::end);
+        uint64_t remaining = static_cast<uint64_t>(in.tellg() - start);
+        in.seekg(start);
+
+        return readArray(in, loaded.editVertices(), remaining)
+            && readArray(in, loaded.editIndices(), remaining)
+            && readArray(in, loaded.editNormals(), remaining)
+            && readArray(in, loaded.editUVs(), remaining)
+            && loaded.isValid();
+    });
+
+    if (ok) {
+        mesh = std::move(loaded);
+    }
+    return ok;
+}
+
+bool DerivedDataCache::weldMesh(MeshData& mesh, float weldTolerance, bool computeNormals,
+                                ProgressCallback progress)
+{
+    const bool useCache = isEnabled();
+    uint64_t key = 0;
+    if (useCache) {
+        uint32_t toleranceBits = 0;
+        std::memcpy(&toleranceBits, &weldTolerance, sizeof(toleranceBits));
+        key = combineKey(mesh.contentHash(), toleranceBits);
+        key = combineKey(key, computeNormals ? 1 : 0);
+        if (loadMesh(key, "weld", mesh)) {
+            return true;
+        }
+    }
+
+    // mergeDuplicateVertices() stops early on cancel without saying so; a
+    // partly welded mesh must not be stored under the weld key
+    bool cancelled = false;
+    ProgressCallback tracked;
+    if (progress) {
+        tracked = [&progress, &cancelled](float p) {
+            if (!progress(p)) {
+                cancelled = true;
+            }
+            return !cancelled;
+        };
+    }
+    mesh.mergeDuplicateVertices(weldTolerance, tracked);
+    if (cancelled) {
+        return false;
+    }
+    if (computeNormals) {
+        mesh.computeNormals();
+    }
+    mesh.shrinkToFit();
+
+    if (useCache) {
+        storeMesh(key, "weld", mesh);
+    }
+    return true;
+}
+
+std::shared_ptr<BVH> DerivedDataCache::bvh(const MeshData& mesh)
+{
+    auto result = std::make_shared<BVH>();
+    if (!isEnabled() || mesh.isEmpty() || !mesh.isValid()) {
+        result->build(mesh);
+        return result;
+    }
+
+    const uint64_t key = mesh.contentHash();
+    if (load(key, "bvh", [&](std::istream& in) { return result->load(in, mesh); })) {
+        return result;
+    }
+
+    result->build(mesh);
+    if (result->isValid()) {
+        store(key, "bvh", [&](std::ostream& out) { return result->save(out); });
+    }
+    return result;
+}
+
+} // namespace geometry
+} // namespace dc3d
@@ -0,0 +1,144 @@
+/**
+ * @file DerivedDataCache.h
+ * @brief On-disk cache for data derived from mesh content
+ *
+ * Welded meshes, normals and BVHs of large scans are expensive to rebuild
+ * but depend only on the mesh they were computed from. The cache stores
+ * them in a directory keyed by MeshData::contentHash() (combined with the
+ * parameters of the derivation), so opening the same data again - in this
+ * or a later session - reads them back instead of recomputing.
+ */
+
+#pragma once
+
+#include "MeshData.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dc3d {
+namespace geometry {
+
+class BVH;
+
+/**
+ * @brief Content-addressed store of derived mesh data
+ *
+ * Each entry is one file named after its key and kind. Entries are written
+ * to a temporary file and renamed into place, so concurrent writers (other
+ * threads or other running instances) never expose partial data, and a
+ * truncated or foreign file is simply treated as a miss. When the directory
+ * grows beyond maxBytes() the least recently used entries are removed.
+ *
+ * The cache does nothing until a directory is set; every call is then a
+ * miss, so callers need no separate code path for a disabled cache.
+ *
+ * Thread-safe.
+ */
+class DerivedDataCache {
+public:
+    using Writer = std::function<bool(std::ostream&)>;
+    using Reader = std::function<bool(std::istream&)>;
+
+    /// Process-wide cache used by importers and picking
+    static DerivedDataCache& instance();
+
+    DerivedDataCache() = default;
+
+    // Non-copyable
+    DerivedDataCache(const DerivedDataCache&) = delete;
+    DerivedDataCache& operator=(const DerivedDataCache&) = delete;
+
+    // ===================
+    // Configuration
+    // ===================
+
+    /// Set the cache directory (created on first store; empty disables the cache)
+    void setDirectory(const std::filesystem::path& directory);
+    std::filesystem::path directory() const;
+
+    /// Size limit of the directory in bytes
+    void setMaxBytes(uint64_t bytes);
+    uint64_t maxBytes() const;
+
+    /// Turn the cache on or off without forgetting the directory
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /// Mix a derivation parameter into a key
+    static uint64_t combineKey(uint64_t key, uint64_t value);
+
+    // ===================
+    // Raw entries
+    // ===================
+
+    /**
+     * @brief Store an entry
+     * @param key Content key (e.g. MeshData::contentHash() combined with parameters)
+     * @param kind Short name of the data type, part of the file name
+     * @param write Writes the payload; returning false discards the entry
+     * @return true if the entry was stored
+     */
+    bool store(uint64_t key, const std::string& kind, const Writer& write);
+
+    /**
+     * @brief Load an entry
+     * @param read Reads the payload; returning false counts as a miss
+     * @return true on a hit that read() accepted
+     */
+    bool load(uint64_t key, const std::string& kind, const Reader& read);
+
+    /// Remove every entry
+    void clear();
+
+    // ===================
+    // Typed entries
+    // ===================
+
+    /// Store a complete mesh (positions, indices, normals, UVs)
+    bool storeMesh(uint64_t key, const std::string& kind, const MeshData& mesh);
+
+    /// Load a mesh stored with storeMesh(); mesh is unchanged on a miss
+    bool loadMesh(uint64_t key, const std::string& kind, MeshData& mesh);
+
+    /**
+     * @brief Weld a mesh as read from a file and compute its normals
+     *
+     * On a hit the welded mesh is read from the cache; otherwise it is
+     * derived with mergeDuplicateVertices() and computeNormals() and stored.
+     *
+     * @param mesh Mesh as read from the file; replaced by the derived mesh
+     * @param weldTolerance mergeDuplicateVertices() tolerance
+     * @param computeNormals Also compute vertex normals
+     * @param progress Welding progress (not called on a hit)
+     * @return false if progress cancelled; the mesh is then partly welded
+     *         and nothing is cached
+     */
+    bool weldMesh(MeshData& mesh, float weldTolerance, bool computeNormals,
+                  ProgressCallback progress = nullptr);
+
+    /**
+     * @brief BVH for a mesh, read from the cache or built (and stored)
+     * @return Built BVH; never null
+     */
+    std::shared_ptr<BVH> bvh(const MeshData& mesh);
+
+private:
+    std::filesystem::path entryPath(const std::filesystem::path& directory,
+                                    uint64_t key, const std::string& kind) const;
+    bool activeDirectory(std::filesystem::path& directory) const;
+    void trim(const std::filesystem::path& directory);
+
+    mutable std::mutex m_mutex;
+    std::filesystem::path m_directory;
+    uint64_t m_maxBytes = uint64_t(8) << 30;
+    bool m_enabled = true;
+};
+
+} // namespace geometry
+} // namespace dc3d
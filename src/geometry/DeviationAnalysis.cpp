@@ -4,10 +4,11 @@
  */
 
 #include "DeviationAnalysis.h"
+#include "BVH.h"
+#include "../core/TaskScheduler.h"
 #include <algorithm>
 #include <cmath>
 #include <numeric>
-#include <random>
 
 namespace dc3d {
 namespace geometry {
@@ -15,217 +16,217 @@ namespace geometry {
 // FIX Bug 28: Define named constants for magic numbers
 namespace {
     constexpr float EPSILON_RAY = 1e-7f;         // For ray-triangle intersection
-    constexpr int NUM_SIGN_RAYS = 5;             // Number of rays for sign determination majority vote
-    constexpr int RANDOM_SEED = 42;              // Seed for reproducible random directions
-} // anonymous namespace
-
-// ============================================================================
-// KDBox
-// ============================================================================
 
-float KDBox::distanceSquared(const glm::vec3& point) const {
-    float dx = std::max(0.0f, std::max(min.x - point.x, point.x - max.x));
-    float dy = std::max(0.0f, std::max(min.y - point.y, point.y - max.y));
-    float dz = std::max(0.0f, std::max(min.z - point.z, point.z - max.z));
-    return dx * dx + dy * dy + dz * dz;
-}
-
-// ============================================================================
-// KDTree
-// ============================================================================
-
-void KDTree::build(const MeshData& mesh, ProgressCallback progress) {
-    mesh_ = &mesh;
-    
-    size_t faceCount = mesh.faceCount();
-    if (faceCount == 0) {
-        root_ = nullptr;
-        return;
-    }
-    
-    std::vector<uint32_t> triangleIndices(faceCount);
-    std::iota(triangleIndices.begin(), triangleIndices.end(), 0);
-    
-    if (progress) progress(0.1f);
-    
-    root_ = buildRecursive(triangleIndices, 0);
-    
-    if (progress) progress(1.0f);
-}
-
-std::unique_ptr<KDNode> KDTree::buildRecursive(
-    std::vector<uint32_t>& triangleIndices,
-    int depth
-) {
-    if (triangleIndices.empty()) {
-        return nullptr;
+/**
+ * @brief Inside/outside classification from angle-weighted pseudo-normals
+ * 
+ * For a query point p with closest surface point c, p is outside iff
+ * dot(p - c, N) >= 0, where N is the face normal if c lies inside a
+ * triangle, the sum of adjacent face normals if c lies on an edge, and
+ * the angle-weighted vertex normal if c is a vertex (Baerentzen & Aanaes).
+ * Only needs the closest point from the BVH, so signed deviation costs
+ * the same as unsigned instead of O(F) ray casts per vertex.
+ * 
+ * Requires consistently oriented triangles; closed meshes give exact signs.
+ */
+class PseudoNormalSign {
+public:
+    explicit PseudoNormalSign(const MeshData& mesh)
+        : vertices_(mesh.vertices())
+        , indices_(mesh.indices())
+    {
+        // Vertex -> face adjacency in CSR form (counting sort, no per-vertex vectors)
+        size_t vertexCount = vertices_.size();
+        size_t faceCount = indices_.size() / 3;
+        
+        faceOffsets_.assign(vertexCount + 1, 0);
+        for (uint32_t idx : indices_) {
+            ++faceOffsets_[idx + 1];
+        }
+        for (size_t v = 0; v < vertexCount; ++v) {
+            faceOffsets_[v + 1] += faceOffsets_[v];
+        }
+        
+        vertexFaces_.resize(indices_.size());
+        std::vector<uint32_t> cursor(faceOffsets_.begin(), faceOffsets_.end() - 1);
+        for (size_t f = 0; f < faceCount; ++f) {
+            for (int k = 0; k < 3; ++k) {
+                vertexFaces_[cursor[indices_[f * 3 + k]]++] = static_cast<uint32_t>(f);
+            }
+        }
     }
     
-    auto node = std::make_unique<KDNode>();
-    
-    // Compute bounds of all triangles
-    for (uint32_t ti : triangleIndices) {
-        KDBox triBounds = computeTriangleBounds(ti);
-        node->bounds.expand(triBounds.min);
-        node->bounds.expand(triBounds.max);
+    /**
+     * @brief Check whether a point lies inside the mesh
+     * @param point Query point
+     * @param triangle Closest triangle reported by the BVH
+     */
+    bool isInside(const glm::vec3& point, uint32_t triangle) const {
+        const uint32_t* tri = &indices_[triangle * 3];
+        glm::vec3 bary;
+        glm::vec3 closest = closestPointOnTriangle(
+            point, vertices_[tri[0]], vertices_[tri[1]], vertices_[tri[2]], bary);
+        
+        // closestPointOnTriangle returns exact zeros outside the face region
+        int zeroCount = (bary.x == 0.0f) + (bary.y == 0.0f) + (bary.z == 0.0f);
+        
+        glm::vec3 pseudoNormal;
+        if (zeroCount == 0) {
+            pseudoNormal = faceNormal(triangle);
+        } else if (zeroCount == 1) {
+            // Edge region: the two vertices with non-zero weight
+            uint32_t a = bary.x == 0.0f ? tri[1] : tri[0];
+            uint32_t b = bary.z == 0.0f ? tri[1] : tri[2];
+            pseudoNormal = edgePseudoNormal(a, b);
+        } else {
+            uint32_t v = bary.x != 0.0f ? tri[0] : (bary.y != 0.0f ? tri[1] : tri[2]);
+            pseudoNormal = vertexPseudoNormal(v);
+        }
+        
+        return glm::dot(point - closest, pseudoNormal) < 0.0f;
     }
     
-    // Leaf node if small enough
-    if (triangleIndices.size() == 1) {
-        node->triangleIndex = triangleIndices[0];
-        node->splitAxis = -1;
-        return node;
+private:
+    glm::vec3 faceNormal(uint32_t f) const {
+        const glm::vec3& v0 = vertices_[indices_[f * 3]];
+        const glm::vec3& v1 = vertices_[indices_[f * 3 + 1]];
+        const glm::vec3& v2 = vertices_[indices_[f * 3 + 2]];
+        glm::vec3 n = glm::cross(v1 - v0, v2 - v0);
+        float len = glm::length(n);
+        return len > 1e-20f ? n / len : glm::vec3(0.0f);
     }
     
-    // Choose split axis (cycle through X, Y, Z)
-    int axis = depth % 3;
-    node->splitAxis = axis;
-    
-    // Sort by centroid along split axis
-    std::sort(triangleIndices.begin(), triangleIndices.end(),
-        [this, axis](uint32_t a, uint32_t b) {
-            glm::vec3 ca = computeTriangleCentroid(a);
-            glm::vec3 cb = computeTriangleCentroid(b);
-            return ca[axis] < cb[axis];
+    glm::vec3 edgePseudoNormal(uint32_t a, uint32_t b) const {
+        glm::vec3 sum(0.0f);
+        for (uint32_t i = faceOffsets_[a]; i < faceOffsets_[a + 1]; ++i) {
+            uint32_t f = vertexFaces_[i];
+            const uint32_t* tri = &indices_[f * 3];
+            if (tri[0] == b || tri[1] == b || tri[2] == b) {
+                sum += faceNormal(f);
+            }
         }
-    );
-    
-    // Split at median
-    size_t mid = triangleIndices.size() / 2;
-    glm::vec3 midCentroid = computeTriangleCentroid(triangleIndices[mid]);
-    node->splitPos = midCentroid[axis];
+        return sum;
+    }
     
-    // If only 2 triangles, make this a leaf
-    if (triangleIndices.size() <= 4) {
-        node->triangleIndex = triangleIndices[0];  // Store first, search all
-        node->splitAxis = -1;
-        
-        // Store remaining triangles
-        if (triangleIndices.size() > 1) {
-            std::vector<uint32_t> leftTris(triangleIndices.begin(), triangleIndices.begin() + mid);
-            std::vector<uint32_t> rightTris(triangleIndices.begin() + mid, triangleIndices.end());
-            node->left = buildRecursive(leftTris, depth + 1);
-            node->right = buildRecursive(rightTris, depth + 1);
-            node->splitAxis = axis;
+    glm::vec3 vertexPseudoNormal(uint32_t v) const {
+        glm::vec3 sum(0.0f);
+        for (uint32_t i = faceOffsets_[v]; i < faceOffsets_[v + 1]; ++i) {
+            uint32_t f = vertexFaces_[i];
+            const uint32_t* tri = &indices_[f * 3];
+            int k = tri[0] == v ? 0 : (tri[1] == v ? 1 : 2);
+            
+            glm::vec3 e1 = vertices_[tri[(k + 1) % 3]] - vertices_[v];
+            glm::vec3 e2 = vertices_[tri[(k + 2) % 3]] - vertices_[v];
+            float len1 = glm::length(e1);
+            float len2 = glm::length(e2);
+            if (len1 < 1e-20f || len2 < 1e-20f) continue;
+            
+            float angle = std::acos(std::clamp(glm::dot(e1, e2) / (len1 * len2), -1.0f, 1.0f));
+            sum += angle * faceNormal(f);
         }
-        return node;
+        return sum;
     }
     
-    // Split triangles
-    std::vector<uint32_t> leftTris(triangleIndices.begin(), triangleIndices.begin() + mid);
-    std::vector<uint32_t> rightTris(triangleIndices.begin() + mid, triangleIndices.end());
-    
-    node->left = buildRecursive(leftTris, depth + 1);
-    node->right = buildRecursive(rightTris, depth + 1);
-    
-    return node;
-}
+    const std::vector<glm::vec3>& vertices_;
+    const std::vector<uint32_t>& indices_;
+    std::vector<uint32_t> faceOffsets_;   ///< CSR offsets into vertexFaces_ (size V+1)
+    std::vector<uint32_t> vertexFaces_;   ///< Faces incident to each vertex
+};
 
-float KDTree::findClosestPoint(
-    const glm::vec3& point,
-    glm::vec3& closestPoint,
-    uint32_t& closestTriangle
-) const {
-    if (!root_) {
-        closestPoint = point;
-        closestTriangle = 0;
-        return std::numeric_limits<float>::max();
-    }
-    
-    float bestDistSq = std::numeric_limits<float>::max();
-    findClosestRecursive(root_.get(), point, bestDistSq, closestPoint, closestTriangle);
-    
-    return std::sqrt(bestDistSq);
-}
+/// Points per parallel batch; consecutive Morton-ordered points share hints
+constexpr size_t DEVIATION_BATCH_SIZE = 1024;
 
-float KDTree::findClosestDistance(const glm::vec3& point) const {
-    glm::vec3 closestPoint;
-    uint32_t closestTriangle;
-    return findClosestPoint(point, closestPoint, closestTriangle);
+/// Spread the low 10 bits of v so there are two zero bits between each
+uint32_t expandBits(uint32_t v) {
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
 }
 
-void KDTree::findClosestRecursive(
-    const KDNode* node,
-    const glm::vec3& point,
-    float& bestDistSq,
-    glm::vec3& bestPoint,
-    uint32_t& bestTriangle
-) const {
-    if (!node) return;
-    
-    // Early out if node's bounding box is farther than current best
-    float boxDistSq = node->bounds.distanceSquared(point);
-    if (boxDistSq >= bestDistSq) {
-        return;
-    }
+/**
+ * @brief Order point indices along a 30-bit Morton (Z-order) curve
+ * 
+ * Neighbouring indices in the result are spatially close, so consecutive
+ * closest-point queries touch the same tree nodes and triangles.
+ */
+std::vector<uint32_t> mortonOrder(const std::vector<glm::vec3>& points) {
+    const size_t count = points.size();
     
-    // Leaf node: check triangle
-    if (node->splitAxis < 0) {
-        glm::vec3 closest = closestPointOnTriangle(point, node->triangleIndex);
-        float distSq = glm::dot(closest - point, closest - point);
-        
-        if (distSq < bestDistSq) {
-            bestDistSq = distSq;
-            bestPoint = closest;
-            bestTriangle = node->triangleIndex;
-        }
-        return;
+    BoundingBox bounds;
+    for (const auto& p : points) {
+        bounds.expand(p);
     }
+    glm::vec3 extent = glm::max(bounds.dimensions(), glm::vec3(1e-20f));
+    glm::vec3 scale = glm::vec3(1023.0f) / extent;
+    
+    std::vector<uint32_t> codes(count);
+    core::parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 q = glm::clamp((points[i] - bounds.min) * scale, 0.0f, 1023.0f);
+            codes[i] = (expandBits(static_cast<uint32_t>(q.x)) << 2) |
+                       (expandBits(static_cast<uint32_t>(q.y)) << 1) |
+                        expandBits(static_cast<uint32_t>(q.z));
+        }
+    });
     
-    // Internal node: traverse children
-    float splitDist = point[node->splitAxis] - node->splitPos;
-    
-    KDNode* nearChild = (splitDist < 0) ? node->left.get() : node->right.get();
-    KDNode* farChild = (splitDist < 0) ? node->right.get() : node->left.get();
-    
-    // Search near child first
-    findClosestRecursive(nearChild, point, bestDistSq, bestPoint, bestTriangle);
+    // LSD radix sort on the 30-bit codes (3 passes of 10 bits), O(n)
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    std::vector<uint32_t> scratch(count);
     
-    // Only search far child if it could contain closer point
-    if (splitDist * splitDist < bestDistSq) {
-        findClosestRecursive(farChild, point, bestDistSq, bestPoint, bestTriangle);
+    for (int shift = 0; shift < 30; shift += 10) {
+        std::vector<size_t> histogram(1025, 0);
+        for (uint32_t idx : order) {
+            ++histogram[((codes[idx] >> shift) & 1023u) + 1];
+        }
+        for (size_t b = 1; b < histogram.size(); ++b) {
+            histogram[b] += histogram[b - 1];
+        }
+        for (uint32_t idx : order) {
+            scratch[histogram[(codes[idx] >> shift) & 1023u]++] = idx;
+        }
+        order.swap(scratch);
     }
-}
-
-glm::vec3 KDTree::closestPointOnTriangle(
-    const glm::vec3& point,
-    uint32_t triangleIndex
-) const {
-    const auto& vertices = mesh_->vertices();
-    const auto& indices = mesh_->indices();
     
-    const glm::vec3& v0 = vertices[indices[triangleIndex * 3]];
-    const glm::vec3& v1 = vertices[indices[triangleIndex * 3 + 1]];
-    const glm::vec3& v2 = vertices[indices[triangleIndex * 3 + 2]];
-    
-    return DeviationAnalysis::closestPointOnTriangle(point, v0, v1, v2);
+    return order;
 }
 
-KDBox KDTree::computeTriangleBounds(uint32_t triangleIndex) const {
-    const auto& vertices = mesh_->vertices();
-    const auto& indices = mesh_->indices();
-    
-    const glm::vec3& v0 = vertices[indices[triangleIndex * 3]];
-    const glm::vec3& v1 = vertices[indices[triangleIndex * 3 + 1]];
-    const glm::vec3& v2 = vertices[indices[triangleIndex * 3 + 2]];
-    
-    KDBox box;
-    box.expand(v0);
-    box.expand(v1);
-    box.expand(v2);
-    return box;
+/**
+ * @brief Shared driver for computeDeviation / computeSignedDeviation
+ * 
+ * Runs Morton-ordered batches of closest-point queries on the task pool.
+ * Within a batch each query is seeded with the previous point's triangle.
+ * 
+ * @param queryFn Called as queryFn(pointIndex, hintTriangle) and returns
+ *                the closest triangle, writing the deviation itself
+ */
+template<typename QueryFn>
+void runDeviationBatches(const std::vector<glm::vec3>& points,
+                         ProgressCallback progress,
+                         QueryFn&& queryFn) {
+    std::vector<uint32_t> order = mortonOrder(points);
+    
+    const size_t count = order.size();
+    const size_t batchCount = (count + DEVIATION_BATCH_SIZE - 1) / DEVIATION_BATCH_SIZE;
+    core::ParallelProgress reporter(progress, count, 0.2f, 1.0f);
+    
+    core::parallelFor(0, batchCount, [&](size_t batchBegin, size_t batchEnd) {
+        for (size_t batch = batchBegin; batch < batchEnd; ++batch) {
+            size_t first = batch * DEVIATION_BATCH_SIZE;
+            size_t last = std::min(first + DEVIATION_BATCH_SIZE, count);
+            
+            uint32_t hint = std::numeric_limits<uint32_t>::max();
+            for (size_t k = first; k < last; ++k) {
+                hint = queryFn(order[k], hint);
+            }
+            reporter.advance(last - first);
+        }
+    }, 1, &reporter.token());
 }
 
-glm::vec3 KDTree::computeTriangleCentroid(uint32_t triangleIndex) const {
-    const auto& vertices = mesh_->vertices();
-    const auto& indices = mesh_->indices();
-    
-    const glm::vec3& v0 = vertices[indices[triangleIndex * 3]];
-    const glm::vec3& v1 = vertices[indices[triangleIndex * 3 + 1]];
-    const glm::vec3& v2 = vertices[indices[triangleIndex * 3 + 2]];
-    
-    return (v0 + v1 + v2) / 3.0f;
-}
+} // anonymous namespace
 
 // ============================================================================
 // DeviationAnalysis
@@ -244,32 +245,28 @@ std::vector<float> DeviationAnalysis::computeDeviation(
         return deviations;
     }
     
-    // Build KD-tree for acceleration
-    KDTree kdTree;
+    // Build BVH for acceleration
+    BVH bvh;
     if (config.useKDTree) {
-        kdTree.build(meshB, [&progress](float p) {
-            if (progress) return progress(p * 0.2f);
-            return true;
-        });
+        bvh.build(meshB);
+        if (progress && !progress(0.2f)) {
+            return deviations;
+        }
     }
     
-    // Compute distances
-    size_t totalVertices = vertices.size();
-    for (size_t i = 0; i < totalVertices; ++i) {
-        const glm::vec3& point = vertices[i];
-        
-        if (config.useKDTree && kdTree.isBuilt()) {
-            deviations[i] = kdTree.findClosestDistance(point);
-        } else {
-            glm::vec3 closestPoint;
-            deviations[i] = pointToMeshDistance(point, meshB, closestPoint);
-        }
-        
-        if (progress && (i % 1000 == 0)) {
-            float p = 0.2f + 0.8f * static_cast<float>(i) / totalVertices;
-            if (!progress(p)) break;
+    // Compute distances in parallel, Morton-ordered batches
+    const bool useTree = config.useKDTree && bvh.isValid();
+    runDeviationBatches(vertices, progress, [&](uint32_t i, uint32_t hint) -> uint32_t {
+        if (useTree) {
+            BVHClosestPointResult closest = bvh.closestPoint(
+                vertices[i], std::numeric_limits<float>::max(), hint);
+            deviations[i] = closest.distance;
+            return closest.faceIndex;
         }
-    }
+        glm::vec3 closestPoint;
+        deviations[i] = pointToMeshDistance(vertices[i], meshB, closestPoint);
+        return hint;
+    });
     
     if (progress) progress(1.0f);
     
@@ -288,50 +285,27 @@ std::vector<float> DeviationAnalysis::computeSignedDeviation(
         return deviations;
     }
     
-    // Build KD-tree for acceleration
-    KDTree kdTree;
-    kdTree.build(meshB, [&progress](float p) {
-        if (progress) return progress(p * 0.2f);
-        return true;
-    });
+    // Build BVH for acceleration
+    BVH bvh(meshB);
+    if (progress && !progress(0.2f)) {
+        return deviations;
+    }
     
-    // Compute signed distances
-    size_t totalVertices = vertices.size();
-    for (size_t i = 0; i < totalVertices; ++i) {
+    // Inside/outside classification at the closest point
+    PseudoNormalSign signOracle(meshB);
+    
+    // Compute signed distances in parallel, Morton-ordered batches
+    runDeviationBatches(vertices, progress, [&](uint32_t i, uint32_t hint) -> uint32_t {
         const glm::vec3& point = vertices[i];
         
-        glm::vec3 closestPoint;
-        uint32_t closestTriangle;
-        float distance = kdTree.findClosestPoint(point, closestPoint, closestTriangle);
-        
-        // Determine sign using ray casting
-        // Use multiple random rays and take majority vote for robustness
-        // FIX Bug 16: Use thread_local to make function thread-safe and reentrant
-        thread_local std::mt19937 rng(42);
-        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-        
-        int insideCount = 0;
-        const int numRays = 5;
-        
-        for (int r = 0; r < numRays; ++r) {
-            glm::vec3 direction = glm::normalize(glm::vec3(
-                dist(rng), dist(rng), dist(rng)
-            ));
-            
-            int intersections = countRayIntersections(point, direction, meshB);
-            if (intersections % 2 == 1) {
-                insideCount++;
-            }
-        }
-        
-        bool inside = insideCount > numRays / 2;
-        deviations[i] = inside ? -distance : distance;
+        BVHClosestPointResult closest = bvh.closestPoint(
+            point, std::numeric_limits<float>::max(), hint);
         
-        if (progress && (i % 1000 == 0)) {
-            float p = 0.2f + 0.8f * static_cast<float>(i) / totalVertices;
-            if (!progress(p)) break;
-        }
-    }
+        // Determine sign from the pseudo-normal at the closest point
+        bool inside = signOracle.isInside(point, closest.faceIndex);
+        deviations[i] = inside ? -closest.distance : closest.distance;
+        return closest.faceIndex;
+    });
     
     if (progress) progress(1.0f);
     
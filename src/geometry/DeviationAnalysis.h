@@ -44,108 +44,12 @@ struct DeviationStats {
     float toleranceThreshold = 0.0f;   ///< Threshold used
 };
 
-/**
- * @brief 3D axis-aligned bounding box for KD-tree
- */
-struct KDBox {
-    glm::vec3 min{std::numeric_limits<float>::max()};
-    glm::vec3 max{std::numeric_limits<float>::lowest()};
-    
-    void expand(const glm::vec3& point) {
-        min = glm::min(min, point);
-        max = glm::max(max, point);
-    }
-    
-    float distanceSquared(const glm::vec3& point) const;
-};
-
-/**
- * @brief KD-tree node for spatial acceleration
- */
-struct KDNode {
-    uint32_t triangleIndex;    ///< Index of triangle in mesh
-    int splitAxis;             ///< 0=X, 1=Y, 2=Z, -1=leaf
-    float splitPos;            ///< Split position
-    KDBox bounds;
-    std::unique_ptr<KDNode> left;
-    std::unique_ptr<KDNode> right;
-};
-
-/**
- * @brief KD-tree for accelerated point-to-mesh distance queries
- * 
- * Builds a spatial acceleration structure over triangles
- * for efficient nearest-triangle queries.
- */
-class KDTree {
-public:
-    KDTree() = default;
-    ~KDTree() = default;
-    
-    /**
-     * @brief Build KD-tree from mesh triangles
-     * @param mesh Source mesh
-     * @param progress Optional progress callback
-     */
-    void build(const MeshData& mesh, ProgressCallback progress = nullptr);
-    
-    /**
-     * @brief Find closest point on mesh to query point
-     * @param point Query point
-     * @param closestPoint Output: closest point on mesh surface
-     * @param closestTriangle Output: index of closest triangle
-     * @return Distance to closest point
-     */
-    float findClosestPoint(
-        const glm::vec3& point,
-        glm::vec3& closestPoint,
-        uint32_t& closestTriangle
-    ) const;
-    
-    /**
-     * @brief Find closest distance to mesh (unsigned)
-     * @param point Query point
-     * @return Distance to closest point
-     */
-    float findClosestDistance(const glm::vec3& point) const;
-    
-    /**
-     * @brief Check if tree has been built
-     */
-    bool isBuilt() const { return root_ != nullptr; }
-    
-private:
-    std::unique_ptr<KDNode> buildRecursive(
-        std::vector<uint32_t>& triangleIndices,
-        int depth
-    );
-    
-    void findClosestRecursive(
-        const KDNode* node,
-        const glm::vec3& point,
-        float& bestDistSq,
-        glm::vec3& bestPoint,
-        uint32_t& bestTriangle
-    ) const;
-    
-    glm::vec3 closestPointOnTriangle(
-        const glm::vec3& point,
-        uint32_t triangleIndex
-    ) const;
-    
-    KDBox computeTriangleBounds(uint32_t triangleIndex) const;
-    glm::vec3 computeTriangleCentroid(uint32_t triangleIndex) const;
-    
-    std::unique_ptr<KDNode> root_;
-    const MeshData* mesh_ = nullptr;
-};
-
 /**
  * @brief Configuration for deviation computation
  */
 struct DeviationConfig {
     bool computeSigned = true;           ///< Compute signed distance
-    bool useKDTree = true;               ///< Use KD-tree acceleration
+    bool useKDTree = true;               ///< Use BVH acceleration (brute force if false)
     float toleranceThreshold = 0.1f;     ///< Threshold for "within tolerance"
     int maxIterations = 100;             ///< Max iterations for distance refining
 };
@@ -164,6 +68,12 @@ public:
      * For each vertex in meshA, finds the closest point on meshB
      * and returns the distance.
      * 
+     * Query points are processed in Morton (Z-curve) order in batches
+     * across all cores; each query is seeded with the previous result of
+     * its batch. Progress is aggregated across workers and reported on the
+     * calling thread; returning false from progress cancels the remaining
+     * batches (their deviations stay 0).
+     * 
      * @param meshA Source mesh (distances computed for each vertex)
      * @param meshB Target mesh (surface to measure distance to)
      * @param config Configuration options
@@ -182,6 +92,10 @@ public:
      * 
      * Positive = outside meshB, Negative = inside meshB
      * 
+     * The sign is taken from the angle-weighted pseudo-normal at the closest
+     * point on meshB, so the cost matches computeDeviation (one BVH query
+     * per vertex). meshB must have consistently oriented faces.
+     * 
      * @param meshA Source mesh
      * @param meshB Target mesh (should be watertight for signed distance)
      * @param progress Optional progress callback
@@ -197,27 +197,27 @@ MeshData HalfEdgeMesh::toMeshData() const {
     if (isEmpty()) return mesh;
     
     // Copy vertices
-    mesh.vertices().reserve(vertices_.size());
+    mesh.editVertices().reserve(vertices_.size());
     for (const auto& v : vertices_) {
-        mesh.vertices().push_back(v.position);
+        mesh.editVertices().push_back(v.position);
     }
     
     // Copy normals
-    mesh.normals().reserve(vertices_.size());
+    mesh.editNormals().reserve(vertices_.size());
     for (const auto& v : vertices_) {
-        mesh.normals().push_back(v.normal);
+        mesh.editNormals().push_back(v.normal);
     }
     
     // Build indices from faces
-    mesh.indices().reserve(faces_.size() * 3);
+    mesh.editIndices().reserve(faces_.size() * 3);
     for (const auto& face : faces_) {
         if (!face.isValid()) continue;
         
         auto verts = faceVertices(static_cast<uint32_t>(&face - &faces_[0]));
         if (verts.size() == 3) {
-            mesh.indices().push_back(verts[0]);
-            mesh.indices().push_back(verts[1]);
-            mesh.indices().push_back(verts[2]);
+            mesh.editIndices().push_back(verts[0]);
+            mesh.editIndices().push_back(verts[1]);
+            mesh.editIndices().push_back(verts[2]);
         }
     }
     
@@ -4,6 +4,7 @@
  */
 
 #include "ICP.h"
+#include "../core/TaskScheduler.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <algorithm>
 #include <numeric>
@@ -20,121 +21,6 @@ namespace {
     constexpr int MAX_SVD_ITERATIONS = 50;       // Maximum iterations for power iteration SVD
 } // anonymous namespace
 
-// ============================================================================
-// KDTree Implementation
-// ============================================================================
-
-void KDTree::build(const std::vector<glm::vec3>& points,
-                   const std::vector<glm::vec3>& normals) {
-    points_ = points;
-    normals_ = normals;
-    
-    if (points_.empty()) {
-        root_ = nullptr;
-        return;
-    }
-    
-    std::vector<int> indices(points_.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    
-    root_ = buildRecursive(indices, 0, points_, normals_);
-}
-
-std::unique_ptr<KDNode> KDTree::buildRecursive(
-    std::vector<int>& indices, int depth,
-    const std::vector<glm::vec3>& points,
-    const std::vector<glm::vec3>& normals)
-{
-    if (indices.empty()) {
-        return nullptr;
-    }
-    
-    int axis = depth % 3;
-    
-    // Sort by current axis
-    std::sort(indices.begin(), indices.end(), [&](int a, int b) {
-        return points[a][axis] < points[b][axis];
-    });
-    
-    size_t mid = indices.size() / 2;
-    
-    auto node = std::make_unique<KDNode>();
-    node->index = indices[mid];
-    node->point = points[indices[mid]];
-    node->normal = normals.empty() ? glm::vec3(0, 0, 1) : normals[indices[mid]];
-    node->splitAxis = axis;
-    
-    // Build subtrees
-    std::vector<int> leftIndices(indices.begin(), indices.begin() + mid);
-    std::vector<int> rightIndices(indices.begin() + mid + 1, indices.end());
-    
-    node->left = buildRecursive(leftIndices, depth + 1, points, normals);
-    node->right = buildRecursive(rightIndices, depth + 1, points, normals);
-    
-    return node;
-}
-
-int KDTree::findNearest(const glm::vec3& query, float maxDistance) const {
-    float dist;
-    glm::vec3 normal;
-    return findNearest(query, dist, normal, maxDistance);
-}
-
-glm::vec3 KDTree::getPoint(int index) const {
-    if (index < 0 || static_cast<size_t>(index) >= points_.size()) {
-        return glm::vec3(0.0f);
-    }
-    return points_[index];
-}
-
-int KDTree::findNearest(const glm::vec3& query, float& outDistance, glm::vec3& outNormal,
-                        float maxDistance) const {
-    if (!root_) {
-        return -1;
-    }
-    
-    int bestIndex = -1;
-    float bestDist = maxDistance;
-    glm::vec3 bestNormal(0, 0, 1);
-    
-    findNearestRecursive(root_.get(), query, bestIndex, bestDist, bestNormal, maxDistance);
-    
-    outDistance = bestDist;
-    outNormal = bestNormal;
-    return bestIndex;
-}
-
-void KDTree::findNearestRecursive(const KDNode* node, const glm::vec3& query,
-                                   int& bestIndex, float& bestDist, glm::vec3& bestNormal,
-                                   float maxDistance) const {
-    if (!node) {
-        return;
-    }
-    
-    // Check current node
-    float dist = glm::length(node->point - query);
-    if (dist < bestDist) {
-        bestDist = dist;
-        bestIndex = node->index;
-        bestNormal = node->normal;
-    }
-    
-    // Determine which subtree to search first
-    int axis = node->splitAxis;
-    float diff = query[axis] - node->point[axis];
-    
-    KDNode* first = diff < 0 ? node->left.get() : node->right.get();
-    KDNode* second = diff < 0 ? node->right.get() : node->left.get();
-    
-    // Search nearer subtree
-    findNearestRecursive(first, query, bestIndex, bestDist, bestNormal, maxDistance);
-    
-    // Check if we need to search farther subtree
-    if (std::abs(diff) < bestDist) {
-        findNearestRecursive(second, query, bestIndex, bestDist, bestNormal, maxDistance);
-    }
-}
-
 // ============================================================================
 // ICP Implementation
 // ============================================================================
@@ -178,7 +64,7 @@ ICPResult ICP::alignPoints(std::vector<glm::vec3>& sourcePoints,
     
     // Build KD-Tree for target mesh
     KDTree targetTree;
-    targetTree.build(target.vertices(), target.normals());
+    targetTree.build(target.vertices());
     
     glm::mat4 cumulativeTransform(1.0f);
     glm::mat4 prevTransform(1.0f);
@@ -187,12 +73,12 @@ ICPResult ICP::alignPoints(std::vector<glm::vec3>& sourcePoints,
     std::vector<glm::vec3> workingPoints = sourcePoints;
     
     // Initial error
-    auto initialCorr = findCorrespondences(workingPoints, targetTree, options);
+    auto initialCorr = findCorrespondences(workingPoints, targetTree, target, options);
     result.initialRMSError = computeRMSError(initialCorr);
     
     for (int iter = 0; iter < options.maxIterations; ++iter) {
         // Find correspondences
-        auto correspondences = findCorrespondences(workingPoints, targetTree, options);
+        auto correspondences = findCorrespondences(workingPoints, targetTree, target, options);
         
         if (correspondences.empty()) {
             break;
@@ -248,7 +134,7 @@ ICPResult ICP::alignPoints(std::vector<glm::vec3>& sourcePoints,
     }
     
     // Final correspondences for error
-    auto finalCorr = findCorrespondences(workingPoints, targetTree, options);
+    auto finalCorr = findCorrespondences(workingPoints, targetTree, target, options);
     result.finalRMSError = computeRMSError(finalCorr);
     result.correspondenceCount = static_cast<int>(finalCorr.size());
     result.transform = cumulativeTransform;
@@ -267,25 +153,43 @@ ICPResult ICP::alignPoints(std::vector<glm::vec3>& sourcePoints,
 std::vector<Correspondence> ICP::findCorrespondences(
     const std::vector<glm::vec3>& sourcePoints,
     const KDTree& targetTree,
+    const MeshData& target,
     const ICPOptions& options)
 {
-    std::vector<Correspondence> correspondences;
-    correspondences.reserve(sourcePoints.size() / options.correspondenceSampling);
-    
-    for (size_t i = 0; i < sourcePoints.size(); i += options.correspondenceSampling) {
-        float distance;
-        glm::vec3 normal;
-        int targetIdx = targetTree.findNearest(sourcePoints[i], distance, normal,
-                                               options.maxCorrespondenceDistance);
-        
-        if (targetIdx >= 0) {
-            Correspondence corr;
+    const auto& targetVertices = target.vertices();
+    const auto& targetNormals = target.normals();
+    const bool hasNormals = targetNormals.size() == targetVertices.size();
+    
+    const size_t sampling = static_cast<size_t>(std::max(1, options.correspondenceSampling));
+    const size_t sampleCount = (sourcePoints.size() + sampling - 1) / sampling;
+    
+    // Nearest-neighbor queries are independent: run them across all cores
+    // into per-sample slots, then compact in order (deterministic output)
+    std::vector<Correspondence> candidates(sampleCount);
+    core::parallelFor(0, sampleCount, [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) {
+            size_t i = s * sampling;
+            Correspondence& corr = candidates[s];
+            
+            float distance;
+            int targetIdx = targetTree.findNearest(sourcePoints[i],
+                                                   options.maxCorrespondenceDistance, &distance);
+            
             corr.sourceIndex = static_cast<int>(i);
             corr.targetIndex = targetIdx;
-            corr.sourcePoint = sourcePoints[i];
-            corr.targetPoint = targetTree.getPoint(targetIdx);  // FIX: Get actual target point from KD-tree
-            corr.targetNormal = normal;
-            corr.distance = distance;
+            if (targetIdx >= 0) {
+                corr.sourcePoint = sourcePoints[i];
+                corr.targetPoint = targetVertices[targetIdx];
+                corr.targetNormal = hasNormals ? targetNormals[targetIdx] : glm::vec3(0, 0, 1);
+                corr.distance = distance;
+            }
+        }
+    });
+    
+    std::vector<Correspondence> correspondences;
+    correspondences.reserve(sampleCount);
+    for (const auto& corr : candidates) {
+        if (corr.targetIndex >= 0) {
             correspondences.push_back(corr);
         }
     }
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "MeshData.h"
+#include "KDTree.h"
 #include <glm/glm.hpp>
 #include <vector>
 #include <functional>
@@ -83,79 +84,6 @@ struct ICPIterationStats {
  */
 using ICPIterationCallback = std::function<bool(const ICPIterationStats& stats)>;
 
-/**
- * @brief KD-Tree node for nearest neighbor queries
- */
-struct KDNode {
-    glm::vec3 point;
-    glm::vec3 normal;
-    int index = -1;
-    std::unique_ptr<KDNode> left;
-    std::unique_ptr<KDNode> right;
-    int splitAxis = 0;
-};
-
-/**
- * @brief Simple KD-Tree for nearest neighbor search
- */
-class KDTree {
-public:
-    KDTree() = default;
-    ~KDTree() = default;
-    
-    /**
-     * @brief Build KD-Tree from points
-     * @param points Point positions
-     * @param normals Optional point normals
-     */
-    void build(const std::vector<glm::vec3>& points,
-               const std::vector<glm::vec3>& normals = {});
-    
-    /**
-     * @brief Find nearest neighbor
-     * @param query Query point
-     * @param maxDistance Maximum search distance
-     * @return Index of nearest point, or -1 if none found
-     */
-    int findNearest(const glm::vec3& query, float maxDistance = std::numeric_limits<float>::max()) const;
-    
-    /**
-     * @brief Find nearest neighbor with distance and normal
-     * @param query Query point
-     * @param outDistance Output: distance to nearest
-     * @param outNormal Output: normal at nearest point
-     * @param maxDistance Maximum search distance
-     * @return Index of nearest point, or -1 if none found
-     */
-    int findNearest(const glm::vec3& query, float& outDistance, glm::vec3& outNormal,
-                    float maxDistance = std::numeric_limits<float>::max()) const;
-    
-    /**
-     * @brief Check if tree is built
-     */
-    bool isBuilt() const { return root_ != nullptr; }
-    
-    /**
-     * @brief Get point at index
-     * @param index Index of the point
-     * @return Point position at index, or zero vector if invalid
-     */
-    glm::vec3 getPoint(int index) const;
-    
-private:
-    std::unique_ptr<KDNode> buildRecursive(std::vector<int>& indices, int depth,
-                                            const std::vector<glm::vec3>& points,
-                                            const std::vector<glm::vec3>& normals);
-    
-    void findNearestRecursive(const KDNode* node, const glm::vec3& query,
-                              int& bestIndex, float& bestDist, glm::vec3& bestNormal,
-                              float maxDistance) const;
-    
-    std::unique_ptr<KDNode> root_;
-    std::vector<glm::vec3> points_;
-    std::vector<glm::vec3> normals_;
-};
-
 /**
  * @brief Point correspondence for ICP
  */
@@ -220,6 +148,7 @@ private:
     std::vector<Correspondence> findCorrespondences(
         const std::vector<glm::vec3>& sourcePoints,
         const KDTree& targetTree,
+        const MeshData& target,
         const ICPOptions& options);
     
     /**
@@ -0,0 +1,385 @@
+/**
+ * @file KDTree.cpp
+ * @brief Implementation of the flat point KD-tree
+ */
+
+#include "KDTree.h"
+#include "../core/TaskScheduler.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+namespace dc3d {
+namespace geometry {
+
+// FIX Bug 28: Define named constants for magic numbers
+namespace {
+    constexpr size_t PARALLEL_BUILD_THRESHOLD = 32768;  // Items per subtree worth a task
+    constexpr int MAX_STACK_DEPTH = 64;                 // Median splits: depth <= log2(N) + 1
+    constexpr uint32_t INVALID_SLOT = std::numeric_limits<uint32_t>::max();
+
+float boxDistanceSquared(const AABB& box, const glm::vec3& point) {
+    float dx = std::max(0.0f, std::max(box.min.x - point.x, point.x - box.max.x));
+    float dy = std::max(0.0f, std::max(box.min.y - point.y, point.y - box.max.y));
+    float dz = std::max(0.0f, std::max(box.min.z - point.z, point.z - box.max.z));
+    return dx * dx + dy * dy + dz * dz;
+}
+
+/**
+ * @brief Number of nodes in a median-split subtree holding count items
+ *
+ * Halving gives at most two distinct sizes per level (s and s + 1), so the
+ * count is computed level by level without building anything.
+ */
+size_t subtreeNodeCount(size_t count, uint32_t leafSize) {
+    size_t total = 0;
+    size_t size = count;       // Smaller size on this level
+    size_t countSmall = 1;     // Nodes of `size` items
+    size_t countLarge = 0;     // Nodes of `size + 1` items
+
+    while (countSmall + countLarge > 0) {
+        total += countSmall + countLarge;
+
+        size_t splitSmall = size > leafSize ? countSmall : 0;
+        size_t splitLarge = size + 1 > leafSize ? countLarge : 0;
+        size_t nextSmall = 0;
+        size_t nextLarge = 0;
+        if (size % 2 == 0) {
+            // s -> (s/2, s/2), s+1 -> (s/2, s/2 + 1)
+            nextSmall = 2 * splitSmall + splitLarge;
+            nextLarge = splitLarge;
+        } else {
+            // s -> (s/2, s/2 + 1), s+1 -> (s/2 + 1, s/2 + 1)
+            nextSmall = splitSmall;
+            nextLarge = splitSmall + 2 * splitLarge;
+        }
+
+        size /= 2;
+        countSmall = nextSmall;
+        countLarge = nextLarge;
+    }
+    return total;
+}
+
+/**
+ * @brief Builds a flat median-split tree into preallocated arrays
+ *
+ * items holds the item ids and is partitioned in place; each leaf owns a
+ * contiguous range of it. expandBounds(box, item) grows a box by one item.
+ */
+template<typename ExpandBounds>
+struct FlatTreeBuilder {
+    std::vector<KDNode>& nodes;
+    std::vector<uint32_t>& items;
+    const std::vector<glm::vec3>& centroids;
+    ExpandBounds expandBounds;
+    uint32_t leafSize;
+
+    void build(uint32_t nodeIndex, size_t begin, size_t end) {
+        KDNode& node = nodes[nodeIndex];
+
+        AABB centroidBounds;
+        for (size_t i = begin; i < end; ++i) {
+            expandBounds(node.bounds, items[i]);
+            centroidBounds.expand(centroids[items[i]]);
+        }
+
+        const size_t count = end - begin;
+        if (count <= leafSize) {
+            node.offset = static_cast<uint32_t>(begin);
+            node.count = static_cast<uint32_t>(count);
+            return;
+        }
+
+        // Median split along the longest axis of the centroids
+        const int axis = centroidBounds.longestAxis();
+        const size_t mid = begin + count / 2;
+        std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+            [this, axis](uint32_t a, uint32_t b) {
+                return centroids[a][axis] < centroids[b][axis];
+            });
+
+        const uint32_t left = nodeIndex + 1;
+        const uint32_t right = left + static_cast<uint32_t>(subtreeNodeCount(count / 2, leafSize));
+        node.offset = right;
+        node.count = 0;
+
+        if (count >= PARALLEL_BUILD_THRESHOLD) {
+            // Subtrees write disjoint node and item ranges
+            core::TaskGroup group;
+            group.run([this, left, begin, mid]() { build(left, begin, mid); });
+            build(right, mid, end);
+            group.wait();
+        } else {
+            build(left, begin, mid);
+            build(right, mid, end);
+        }
+    }
+};
+
+template<typename ExpandBounds>
+void buildFlatTree(std::vector<KDNode>& nodes,
+                   std::vector<uint32_t>& items,
+                   const std::vector<glm::vec3>& centroids,
+                   ExpandBounds expandBounds,
+                   uint32_t leafSize) {
+    leafSize = std::max<uint32_t>(leafSize, 1);
+
+    items.resize(centroids.size());
+    std::iota(items.begin(), items.end(), 0u);
+
+    // Exact node count: one allocation, no per-node heap traffic
+    nodes.assign(subtreeNodeCount(items.size(), leafSize), KDNode{});
+
+    FlatTreeBuilder<ExpandBounds> builder{nodes, items, centroids, expandBounds, leafSize};
+    builder.build(0, 0, items.size());
+}
+
+/// Traversal stack entry: node and its squared box distance
+struct StackEntry {
+    uint32_t node;
+    float distSq;
+};
+
+} // anonymous namespace
+
+// ============================================================================
+// KDTree
+// ============================================================================
+
+void KDTree::build(const std::vector<glm::vec3>& points, uint32_t leafSize) {
+    clear();
+    if (points.empty()) {
+        return;
+    }
+
+    buildFlatTree(m_nodes, m_indices, points,
+        [&points](AABB& box, uint32_t item) { box.expand(points[item]); },
+        leafSize);
+
+    // Copy positions into leaf order so each bucket is contiguous
+    m_points.resize(points.size());
+    core::parallelFor(0, points.size(), [&](size_t begin, size_t end) {
+        for (size_t slot = begin; slot < end; ++slot) {
+            m_points[slot] = points[m_indices[slot]];
+        }
+    });
+}
+
+void KDTree::clear() {
+    m_nodes.clear();
+    m_nodes.shrink_to_fit();
+    m_points.clear();
+    m_points.shrink_to_fit();
+    m_indices.clear();
+    m_indices.shrink_to_fit();
+}
+
+int KDTree::findNearest(const glm::vec3& query, float maxDistance, float* outDistance) const {
+    if (outDistance) {
+        *outDistance = maxDistance;
+    }
+    if (m_nodes.empty()) {
+        return -1;
+    }
+
+    float bestDistSq = maxDistance * maxDistance;
+    uint32_t bestSlot = INVALID_SLOT;
+
+    StackEntry stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = {0, boxDistanceSquared(m_nodes[0].bounds, query)};
+
+    while (stackSize > 0) {
+        const StackEntry entry = stack[--stackSize];
+        if (entry.distSq >= bestDistSq) {
+            continue;
+        }
+
+        const KDNode& node = m_nodes[entry.node];
+        if (node.isLeaf()) {
+            const uint32_t last = node.offset + node.count;
+            for (uint32_t slot = node.offset; slot < last; ++slot) {
+                glm::vec3 d = m_points[slot] - query;
+                float distSq = glm::dot(d, d);
+                if (distSq < bestDistSq) {
+                    bestDistSq = distSq;
+                    bestSlot = slot;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first (pushed last)
+        const uint32_t left = entry.node + 1;
+        const uint32_t right = node.offset;
+        float leftDistSq = boxDistanceSquared(m_nodes[left].bounds, query);
+        float rightDistSq = boxDistanceSquared(m_nodes[right].bounds, query);
+        if (leftDistSq <= rightDistSq) {
+            stack[stackSize++] = {right, rightDistSq};
+            stack[stackSize++] = {left, leftDistSq};
+        } else {
+            stack[stackSize++] = {left, leftDistSq};
+            stack[stackSize++] = {right, rightDistSq};
+        }
+    }
+
+    if (bestSlot == INVALID_SLOT) {
+        return -1;
+    }
+    if (outDistance) {
+        *outDistance = std::sqrt(bestDistSq);
+    }
+    return static_cast<int>(m_indices[bestSlot]);
+}
+
+size_t KDTree::findKNearest(const glm::vec3& query, size_t k,
+                            std::vector<KDNeighbor>& out, float maxDistance) const {
+    out.clear();
+    if (m_nodes.empty() || k == 0) {
+        return 0;
+    }
+
+    // Max-heap on distance: the root is the current k-th neighbor
+    auto farther = [](const KDNeighbor& a, const KDNeighbor& b) {
+        return a.distanceSquared < b.distanceSquared;
+    };
+    const float maxDistSq = maxDistance * maxDistance;
+    auto bound = [&]() {
+        return out.size() < k ? maxDistSq : out.front().distanceSquared;
+    };
+
+    StackEntry stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = {0, boxDistanceSquared(m_nodes[0].bounds, query)};
+
+    while (stackSize > 0) {
+        const StackEntry entry = stack[--stackSize];
+        if (entry.distSq >= bound()) {
+            continue;
+        }
+
+        const KDNode& node = m_nodes[entry.node];
+        if (node.isLeaf()) {
+            const uint32_t last = node.offset + node.count;
+            for (uint32_t slot = node.offset; slot < last; ++slot) {
+                glm::vec3 d = m_points[slot] - query;
+                float distSq = glm::dot(d, d);
+                if (distSq >= bound()) {
+                    continue;
+                }
+                out.push_back({m_indices[slot], distSq});
+                std::push_heap(out.begin(), out.end(), farther);
+                if (out.size() > k) {
+                    std::pop_heap(out.begin(), out.end(), farther);
+                    out.pop_back();
+                }
+            }
+            continue;
+        }
+
+        const uint32_t left = entry.node + 1;
+        const uint32_t right = node.offset;
+        float leftDistSq = boxDistanceSquared(m_nodes[left].bounds, query);
+        float rightDistSq = boxDistanceSquared(m_nodes[right].bounds, query);
+        if (leftDistSq <= rightDistSq) {
+            stack[stackSize++] = {right, rightDistSq};
+            stack[stackSize++] = {left, leftDistSq};
+        } else {
+            stack[stackSize++] = {left, leftDistSq};
+            stack[stackSize++] = {right, rightDistSq};
+        }
+    }
+
+    std::sort_heap(out.begin(), out.end(), farther);
+    return out.size();
+}
+
+size_t KDTree::findInRadius(const glm::vec3& query, float radius,
+                            std::vector<KDNeighbor>& out) const {
+    out.clear();
+    if (m_nodes.empty() || radius < 0.0f) {
+        return 0;
+    }
+
+    const float radiusSq = radius * radius;
+
+    uint32_t stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const uint32_t nodeIndex = stack[--stackSize];
+        const KDNode& node = m_nodes[nodeIndex];
+        if (boxDistanceSquared(node.bounds, query) > radiusSq) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            const uint32_t last = node.offset + node.count;
+            for (uint32_t slot = node.offset; slot < last; ++slot) {
+                glm::vec3 d = m_points[slot] - query;
+                float distSq = glm::dot(d, d);
+                if (distSq <= radiusSq) {
+                    out.push_back({m_indices[slot], distSq});
+                }
+            }
+            continue;
+        }
+
+        stack[stackSize++] = node.offset;
+        stack[stackSize++] = nodeIndex + 1;
+    }
+
+    return out.size();
+}
+
+size_t KDTree::findInFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& out) const {
+    out.clear();
+    if (m_nodes.empty()) {
+        return 0;
+    }
+
+    uint32_t stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const uint32_t nodeIndex = stack[--stackSize];
+        const KDNode& node = m_nodes[nodeIndex];
+
+        // Skip the node if its p-vertex is outside any plane
+        bool outside = false;
+        for (int i = 0; i < 6 && !outside; ++i) {
+            glm::vec3 p(planes[i].x >= 0.0f ? node.bounds.max.x : node.bounds.min.x,
+                        planes[i].y >= 0.0f ? node.bounds.max.y : node.bounds.min.y,
+                        planes[i].z >= 0.0f ? node.bounds.max.z : node.bounds.min.z);
+            outside = glm::dot(glm::vec3(planes[i]), p) + planes[i].w < 0.0f;
+        }
+        if (outside) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            const uint32_t last = node.offset + node.count;
+            for (uint32_t slot = node.offset; slot < last; ++slot) {
+                bool inside = true;
+                for (int i = 0; i < 6 && inside; ++i) {
+                    inside = glm::dot(glm::vec3(planes[i]), m_points[slot]) + planes[i].w >= 0.0f;
+                }
+                if (inside) {
+                    out.push_back(m_indices[slot]);
+                }
+            }
+            continue;
+        }
+
+        stack[stackSize++] = node.offset;
+        stack[stackSize++] = nodeIndex + 1;
+    }
+
+    return out.size();
+}
+
+} // namespace geometry
+} // namespace dc3d
@@ -0,0 +1,137 @@
+/**
+ * @file KDTree.h
+ * @brief Flat KD-tree for nearest-neighbor queries on point clouds
+ *
+ * The tree is a single contiguous array of 32-byte nodes in depth-first
+ * order. An internal node's left child immediately follows it and the right
+ * child index is stored in the node, so there are no per-node allocations
+ * and traversal walks memory mostly forward.
+ *
+ * Nodes split at the median along the longest axis until a leaf bucket
+ * holds at most leafSize items. The node count is known up front, so the
+ * build allocates each array exactly once and subtrees are built in
+ * parallel on the shared TaskScheduler.
+ *
+ * Used for ICP correspondences and kNN / radius queries. Closest points
+ * on triangle meshes are answered by BVH::closestPoint().
+ */
+
+#pragma once
+
+#include "BVH.h"
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+namespace dc3d {
+namespace geometry {
+
+/**
+ * @brief Node of a flat KD-tree
+ */
+struct KDNode {
+    AABB bounds;              ///< Bounds of all items below this node
+    uint32_t offset = 0;      ///< Leaf: first item slot; internal: right child index
+    uint32_t count = 0;       ///< Leaf: number of items (0 if internal node)
+
+    bool isLeaf() const { return count > 0; }
+};
+
+/**
+ * @brief Result entry of a kNN or radius query
+ */
+struct KDNeighbor {
+    uint32_t index;           ///< Index of the point in the input array
+    float distanceSquared;    ///< Squared distance to the query point
+};
+
+/**
+ * @brief KD-tree over a point cloud
+ *
+ * Points are copied into leaf order, so each leaf is a contiguous run of
+ * positions. Queries are read-only and safe to run concurrently.
+ */
+class KDTree {
+public:
+    static constexpr uint32_t DEFAULT_LEAF_SIZE = 16;  ///< Points per leaf bucket
+
+    KDTree() = default;
+    ~KDTree() = default;
+
+    /**
+     * @brief Build tree from points
+     * @param points Point positions (indices into this array are returned by queries)
+     * @param leafSize Maximum points per leaf
+     */
+    void build(const std::vector<glm::vec3>& points, uint32_t leafSize = DEFAULT_LEAF_SIZE);
+
+    /**
+     * @brief Release all memory
+     */
+    void clear();
+
+    /**
+     * @brief Check if tree is built
+     */
+    bool isBuilt() const { return !m_nodes.empty(); }
+
+    /**
+     * @brief Number of indexed points
+     */
+    size_t size() const { return m_points.size(); }
+
+    /**
+     * @brief Number of nodes
+     */
+    size_t nodeCount() const { return m_nodes.size(); }
+
+    /**
+     * @brief Find nearest neighbor
+     * @param query Query point
+     * @param maxDistance Maximum search distance
+     * @param outDistance Optional output: distance to nearest (maxDistance if none found)
+     * @return Index of nearest point, or -1 if none found
+     */
+    int findNearest(const glm::vec3& query,
+                    float maxDistance = std::numeric_limits<float>::max(),
+                    float* outDistance = nullptr) const;
+
+    /**
+     * @brief Find the k nearest neighbors
+     * @param query Query point
+     * @param k Number of neighbors
+     * @param out Output: neighbors sorted by increasing distance (cleared first)
+     * @param maxDistance Maximum search distance
+     * @return Number of neighbors found
+     */
+    size_t findKNearest(const glm::vec3& query, size_t k,
+                        std::vector<KDNeighbor>& out,
+                        float maxDistance = std::numeric_limits<float>::max()) const;
+
+    /**
+     * @brief Find all points within a radius
+     * @param query Query point
+     * @param radius Search radius (inclusive)
+     * @param out Output: neighbors in no particular order (cleared first)
+     * @return Number of neighbors found
+     */
+    size_t findInRadius(const glm::vec3& query, float radius,
+                        std::vector<KDNeighbor>& out) const;
+
+    /**
+     * @brief Find all points inside a convex volume
+     * @param planes Six planes with inward normals (dot(n, p) + w >= 0 inside)
+     * @param out Output: input indices in no particular order (cleared first)
+     * @return Number of points found
+     */
+    size_t findInFrustum(const glm::vec4 planes[6], std::vector<uint32_t>& out) const;
+
+private:
+    std::vector<KDNode> m_nodes;
+    std::vector<glm::vec3> m_points;      ///< Positions in leaf order
+    std::vector<uint32_t> m_indices;      ///< Leaf slot -> input index
+};
+
+} // namespace geometry
+} // namespace dc3d
@@ -4,8 +4,10 @@
  */
 
 #include "MeshAnalysis.h"
+#include "../core/TaskScheduler.h"
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <numeric>
 #include <queue>
 
@@ -45,30 +47,51 @@ MeshAnalysisStats MeshAnalysis::analyze(const MeshData& mesh, ProgressCallback p
     
     // Compute bounding box and centroid
     stats.bounds = mesh.boundingBox();
-    stats.centroid = mesh.centroid();
     
-    // Surface area
-    stats.surfaceArea = mesh.surfaceArea();
-    
-    if (progress && !progress(0.3f)) return stats;
-    
-    // Edge statistics
-    computeEdgeStatistics(mesh, edgeMap, stats);
-    
-    if (progress && !progress(0.5f)) return stats;
-    
-    // Face statistics
-    computeFaceStatistics(mesh, stats);
-    
-    if (progress && !progress(0.6f)) return stats;
-    
-    // Topology statistics
-    computeTopologyStatistics(mesh, edgeMap, stats);
+    // The remaining passes only read the mesh and the edge map and write
+    // disjoint fields of stats, so they run concurrently on the task pool.
+    // Each finished pass advances progress from 0.2 to 0.7; passes not yet
+    // started are skipped once the callback cancels.
+    bool consistentWinding = true;
+    std::vector<HoleInfo> holes;
+    size_t degenerateFaceCount = 0;
+    size_t isolatedVertexCount = 0;
+    
+    const std::vector<std::function<void()>> passes = {
+        [&]() { stats.centroid = mesh.centroid(); },
+        [&]() { stats.surfaceArea = mesh.surfaceArea(); },
+        [&]() { computeEdgeStatistics(mesh, edgeMap, stats); },
+        [&]() { computeFaceStatistics(mesh, stats); },
+        [&]() { computeTopologyStatistics(mesh, edgeMap, stats); },
+        [&]() { consistentWinding = checkConsistentWinding(mesh, edgeMap); },
+        [&]() { holes = findHoles(mesh); },
+        [&]() { degenerateFaceCount = mesh.countDegenerateFaces(); },
+        [&]() {
+            // Count isolated vertices
+            std::vector<bool> vertexUsed(vertices.size(), false);
+            for (uint32_t idx : indices) {
+                vertexUsed[idx] = true;
+            }
+            isolatedVertexCount = std::count(vertexUsed.begin(), vertexUsed.end(), false);
+        }
+    };
+    
+    core::ParallelProgress reporter(progress, passes.size(), 0.2f, 0.7f);
+    core::TaskGroup group;
+    for (const auto& pass : passes) {
+        group.run([&reporter, &pass]() {
+            if (reporter.isCancelled()) return;
+            pass();
+            reporter.advance(1);
+        });
+    }
+    group.wait();
     
+    if (reporter.isCancelled()) return stats;
     if (progress && !progress(0.7f)) return stats;
     
     // Check winding consistency
-    stats.hasConsistentWinding = checkConsistentWinding(mesh, edgeMap);
+    stats.hasConsistentWinding = consistentWinding;
     
     // Manifold check
     stats.isManifold = (stats.nonManifoldEdgeCount == 0 && stats.nonManifoldVertexCount == 0);
@@ -86,19 +109,13 @@ MeshAnalysisStats MeshAnalysis::analyze(const MeshData& mesh, ProgressCallback p
         stats.volumeValid = true;
     }
     
-    // Find holes
-    stats.holes = findHoles(mesh);
+    // Holes found above
+    stats.holes = std::move(holes);
     stats.holeCount = stats.holes.size();
     
-    // Count degenerate faces
-    stats.degenerateFaceCount = mesh.countDegenerateFaces();
-    
-    // Count isolated vertices
-    std::vector<bool> vertexUsed(vertices.size(), false);
-    for (uint32_t idx : indices) {
-        vertexUsed[idx] = true;
-    }
-    stats.isolatedVertexCount = std::count(vertexUsed.begin(), vertexUsed.end(), false);
+    // Degenerate faces and isolated vertices counted above
+    stats.degenerateFaceCount = degenerateFaceCount;
+    stats.isolatedVertexCount = isolatedVertexCount;
     
     if (progress) progress(1.0f);
     
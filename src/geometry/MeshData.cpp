@@ -4,10 +4,12 @@
  */
 
 #include "MeshData.h"
+#include "../core/TaskScheduler.h"
 
 #include <algorithm>
 #include <unordered_map>
 #include <cmath>
+#include <cstring>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/norm.hpp>
@@ -49,33 +51,142 @@ struct Vec3Hash {
     }
 };
 
+// Content hashing: XXH64 over fixed-size blocks, then over the block digests
+constexpr size_t HASH_BLOCK_BYTES = 1 << 20;
+
+constexpr uint64_t XXH_PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t xxhRound(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_PRIME1;
+}
+
+inline uint64_t xxhMergeRound(uint64_t acc, uint64_t value) {
+    acc ^= xxhRound(0, value);
+    return acc * XXH_PRIME1 + XXH_PRIME4;
+}
+
+// XXH64 (little-endian input, as on all supported platforms)
+uint64_t xxh64(const void* data, size_t length, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + length;
+    uint64_t h;
+    
+    if (length >= 32) {
+        uint64_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+        uint64_t v2 = seed + XXH_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_PRIME1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = xxhRound(v1, read64(p));
+            v2 = xxhRound(v2, read64(p + 8));
+            v3 = xxhRound(v3, read64(p + 16));
+            v4 = xxhRound(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxhMergeRound(h, v1);
+        h = xxhMergeRound(h, v2);
+        h = xxhMergeRound(h, v3);
+        h = xxhMergeRound(h, v4);
+    } else {
+        h = seed + XXH_PRIME5;
+    }
+    
+    h += static_cast<uint64_t>(length);
+    
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxhRound(0, read64(p));
+        h = rotl64(h, 27) * XXH_PRIME1 + XXH_PRIME4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * XXH_PRIME1;
+        h = rotl64(h, 23) * XXH_PRIME2 + XXH_PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= (*p) * XXH_PRIME5;
+        h = rotl64(h, 11) * XXH_PRIME1;
+    }
+    
+    h ^= h >> 33;
+    h *= XXH_PRIME2;
+    h ^= h >> 29;
+    h *= XXH_PRIME3;
+    h ^= h >> 32;
+    return h;
+}
+
+// Blocks are hashed in parallel; the digests (plus the byte count) are
+// hashed again, so the result is independent of the thread count
+uint64_t hashArray(const void* data, size_t bytes, uint64_t seed) {
+    const unsigned char* base = static_cast<const unsigned char*>(data);
+    const size_t blockCount = (bytes + HASH_BLOCK_BYTES - 1) / HASH_BLOCK_BYTES;
+    std::vector<uint64_t> digests(blockCount + 1);
+    
+    core::parallelFor(0, blockCount, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b) {
+            size_t offset = b * HASH_BLOCK_BYTES;
+            digests[b] = xxh64(base + offset, std::min(HASH_BLOCK_BYTES, bytes - offset), seed);
+        }
+    }, 1);
+    digests[blockCount] = static_cast<uint64_t>(bytes);
+    
+    return xxh64(digests.data(), digests.size() * sizeof(uint64_t), seed);
+}
+
 } // anonymous namespace
 
 bool MeshData::isValid() const {
-    if (vertices_.empty() || indices_.empty()) {
+    const auto& vertices = vertices_.read();
+    const auto& indices = indices_.read();
+    const auto& normals = normals_.read();
+    const auto& uvs = uvs_.read();
+    if (vertices.empty() || indices.empty()) {
         return false;
     }
     
     // Check that index count is multiple of 3
-    if (indices_.size() % 3 != 0) {
+    if (indices.size() % 3 != 0) {
         return false;
     }
     
     // Check that all indices are valid
-    size_t vertexCount = vertices_.size();
-    for (uint32_t idx : indices_) {
+    size_t vertexCount = vertices.size();
+    for (uint32_t idx : indices) {
         if (idx >= vertexCount) {
             return false;
         }
     }
     
     // Check normals size if present
-    if (!normals_.empty() && normals_.size() != vertices_.size()) {
+    if (!normals.empty() && normals.size() != vertices.size()) {
         return false;
     }
     
     // Check UVs size if present
-    if (!uvs_.empty() && uvs_.size() != vertices_.size()) {
+    if (!uvs.empty() && uvs.size() != vertices.size()) {
         return false;
     }
     
@@ -90,17 +201,20 @@ const BoundingBox& MeshData::boundingBox() const {
 }
 
 void MeshData::updateBounds() const {
+    const auto& vertices = vertices_.read();
     bounds_.reset();
-    for (const auto& v : vertices_) {
+    for (const auto& v : vertices) {
         bounds_.expand(v);
     }
     boundsDirty_ = false;
 }
 
 MeshStats MeshData::computeStats() const {
+    const auto& vertices = vertices_.read();
+    const auto& indices = indices_.read();
     MeshStats stats;
-    stats.vertexCount = vertices_.size();
-    stats.faceCount = indices_.size() / 3;
+    stats.vertexCount = vertices.size();
+    stats.faceCount = indices.size() / 3;
     stats.bounds = boundingBox();
     stats.hasNormals = hasNormals();
     stats.hasUVs = hasUVs();
@@ -108,7 +222,7 @@ MeshStats MeshData::computeStats() const {
     
     // Edge count for closed manifold: E = 3F/2
     // This is an approximation
-    stats.edgeCount = (indices_.size() / 3) * 3 / 2;
+    stats.edgeCount = (indices.size() / 3) * 3 / 2;
     
     // TODO: Compute watertightness and boundary edges
     // This requires building edge adjacency, which is done in HalfEdgeMesh
@@ -117,43 +231,50 @@ MeshStats MeshData::computeStats() const {
 }
 
 void MeshData::reserveVertices(size_t count) {
-    vertices_.reserve(count);
-    normals_.reserve(count);
+    auto& vertices = vertices_.write();
+    auto& normals = normals_.write();
+    vertices.reserve(count);
+    normals.reserve(count);
 }
 
 void MeshData::reserveFaces(size_t count) {
-    indices_.reserve(count * 3);
+    auto& indices = indices_.write();
+    indices.reserve(count * 3);
 }
 
 uint32_t MeshData::addVertex(const glm::vec3& position) {
-    uint32_t idx = static_cast<uint32_t>(vertices_.size());
-    vertices_.push_back(position);
+    auto& vertices = vertices_.write();
+    uint32_t idx = static_cast<uint32_t>(vertices.size());
+    vertices.push_back(position);
     invalidateBounds();
     return idx;
 }
 
 uint32_t MeshData::addVertex(const glm::vec3& position, const glm::vec3& normal) {
+    auto& vertices = vertices_.write();
+    auto& normals = normals_.write();
     // FIX Bug 23: Document behavior when mixing addVertex calls with/without normals
     // If vertices were added without normals previously, this fills the gaps with zero normals.
     // For consistent behavior, either always use addVertex with normals, or call computeNormals()
     // after adding all vertices to generate proper normals for the entire mesh.
-    uint32_t idx = static_cast<uint32_t>(vertices_.size());
-    vertices_.push_back(position);
+    uint32_t idx = static_cast<uint32_t>(vertices.size());
+    vertices.push_back(position);
     
     // Ensure normals array is sized correctly - fill gaps with zero normals
-    while (normals_.size() < vertices_.size() - 1) {
-        normals_.push_back(glm::vec3(0.0f));  // Zero normal indicates uninitialized
+    while (normals.size() < vertices.size() - 1) {
+        normals.push_back(glm::vec3(0.0f));  // Zero normal indicates uninitialized
     }
-    normals_.push_back(normal);
+    normals.push_back(normal);
     
     invalidateBounds();
     return idx;
 }
 
 void MeshData::addFace(uint32_t v0, uint32_t v1, uint32_t v2) {
-    indices_.push_back(v0);
-    indices_.push_back(v1);
-    indices_.push_back(v2);
+    auto& indices = indices_.write();
+    indices.push_back(v0);
+    indices.push_back(v1);
+    indices.push_back(v2);
 }
 
 void MeshData::clear() {
@@ -166,7 +287,9 @@ void MeshData::clear() {
 }
 
 void MeshData::computeNormals() {
-    if (vertices_.empty() || indices_.empty()) {
+    const auto& vertices = vertices_.read();
+    const auto& indices = indices_.read();
+    if (vertices.empty() || indices.empty()) {
         return;
     }
     
@@ -175,65 +298,78 @@ void MeshData::computeNormals() {
         return;
     }
     
-    // Initialize normals to zero
-    normals_.assign(vertices_.size(), glm::vec3(0.0f));
+    size_t numFaces = indices.size() / 3;
+    size_t vertexCount = vertices.size();
     
-    // Accumulate face normals for each vertex
-    size_t numFaces = indices_.size() / 3;
-    size_t vertexCount = vertices_.size();
-    for (size_t f = 0; f < numFaces; ++f) {
-        uint32_t i0 = indices_[f * 3 + 0];
-        uint32_t i1 = indices_[f * 3 + 1];
-        uint32_t i2 = indices_[f * 3 + 2];
-        
-        // CRITICAL FIX: Bounds check to prevent crash on corrupted mesh data
-        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) {
-            continue;  // Skip invalid face
+    // Face normals are independent - compute them across all cores
+    std::vector<glm::vec3> faceNormals(numFaces);
+    core::parallelFor(0, numFaces, [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; ++f) {
+            uint32_t i0 = indices[f * 3 + 0];
+            uint32_t i1 = indices[f * 3 + 1];
+            uint32_t i2 = indices[f * 3 + 2];
+            
+            // CRITICAL FIX: Bounds check to prevent crash on corrupted mesh data
+            if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) {
+                faceNormals[f] = glm::vec3(0.0f);  // Skip invalid face
+                continue;
+            }
+            
+            const glm::vec3& v0 = vertices[i0];
+            const glm::vec3& v1 = vertices[i1];
+            const glm::vec3& v2 = vertices[i2];
+            
+            // Area-weighted (unnormalized) face normal
+            faceNormals[f] = glm::cross(v1 - v0, v2 - v0);
         }
-        
-        const glm::vec3& v0 = vertices_[i0];
-        const glm::vec3& v1 = vertices_[i1];
-        const glm::vec3& v2 = vertices_[i2];
-        
-        glm::vec3 edge1 = v1 - v0;
-        glm::vec3 edge2 = v2 - v0;
-        glm::vec3 faceNormal = glm::cross(edge1, edge2);
-        
-        // Add to each vertex's normal (will normalize later)
-        normals_[i0] += faceNormal;
-        normals_[i1] += faceNormal;
-        normals_[i2] += faceNormal;
+    });
+    
+    // Accumulate face normals for each vertex (scatter stays serial so the
+    // result is deterministic and free of write conflicts)
+    auto& normals = normals_.overwrite();
+    normals.assign(vertexCount, glm::vec3(0.0f));
+    for (size_t f = 0; f < numFaces; ++f) {
+        const glm::vec3& faceNormal = faceNormals[f];
+        normals[indices[f * 3 + 0]] += faceNormal;
+        normals[indices[f * 3 + 1]] += faceNormal;
+        normals[indices[f * 3 + 2]] += faceNormal;
     }
     
     // Normalize all normals
-    for (auto& n : normals_) {
-        float len = glm::length(n);
-        if (len > 1e-10f) {
-            n /= len;
-        } else {
-            n = glm::vec3(0.0f, 0.0f, 1.0f);  // Default up for degenerate cases
+    core::parallelFor(0, vertexCount, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3& n = normals[i];
+            float len = glm::length(n);
+            if (len > 1e-10f) {
+                n /= len;
+            } else {
+                n = glm::vec3(0.0f, 0.0f, 1.0f);  // Default up for degenerate cases
+            }
         }
-    }
+    });
 }
 
 void MeshData::computeNormalsWeighted() {
-    if (vertices_.empty() || indices_.empty()) {
+    const auto& vertices = vertices_.read();
+    const auto& indices = indices_.read();
+    if (vertices.empty() || indices.empty()) {
         return;
     }
     
     // Initialize normals to zero
-    normals_.assign(vertices_.size(), glm::vec3(0.0f));
+    auto& normals = normals_.overwrite();
+    normals.assign(vertices.size(), glm::vec3(0.0f));
     
     // Accumulate angle-weighted face normals for each vertex
-    size_t numFaces = indices_.size() / 3;
+    size_t numFaces = indices.size() / 3;
     for (size_t f = 0; f < numFaces; ++f) {
-        uint32_t i0 = indices_[f * 3 + 0];
-        uint32_t i1 = indices_[f * 3 + 1];
-        uint32_t i2 = indices_[f * 3 + 2];
+        uint32_t i0 = indices[f * 3 + 0];
+        uint32_t i1 = indices[f * 3 + 1];
+        uint32_t i2 = indices[f * 3 + 2];
         
-        const glm::vec3& v0 = vertices_[i0];
-        const glm::vec3& v1 = vertices_[i1];
-        const glm::vec3& v2 = vertices_[i2];
+        const glm::vec3& v0 = vertices[i0];
+        const glm::vec3& v1 = vertices[i1];
+        const glm::vec3& v2 = vertices[i2];
         
         glm::vec3 e01 = v1 - v0;
         glm::vec3 e02 = v2 - v0;
@@ -258,13 +394,13 @@ void MeshData::computeNormalsWeighted() {
         float angle2 = std::acos(glm::clamp(glm::dot(-e02, -e12) / (len02 * len12), -1.0f, 1.0f));
         
         // Weight by angle
-        normals_[i0] += faceNormal * angle0;
-        normals_[i1] += faceNormal * angle1;
-        normals_[i2] += faceNormal * angle2;
+        normals[i0] += faceNormal * angle0;
+        normals[i1] += faceNormal * angle1;
+        normals[i2] += faceNormal * angle2;
     }
     
     // Normalize all normals
-    for (auto& n : normals_) {
+    for (auto& n : normals) {
         float len = glm::length(n);
         if (len > 1e-10f) {
             n /= len;
@@ -276,14 +412,15 @@ void MeshData::computeNormalsWeighted() {
 
 void MeshData::flipNormals() {
     // Flip vertex normals
-    for (auto& n : normals_) {
+    for (auto& n : normals_.write()) {
         n = -n;
     }
     
     // Reverse winding order of all faces
-    size_t numFaces = indices_.size() / 3;
+    auto& indices = indices_.write();
+    size_t numFaces = indices.size() / 3;
     for (size_t f = 0; f < numFaces; ++f) {
-        std::swap(indices_[f * 3 + 1], indices_[f * 3 + 2]);
+        std::swap(indices[f * 3 + 1], indices[f * 3 + 2]);
     }
 }
 
@@ -292,17 +429,19 @@ void MeshData::clearNormals() {
 }
 
 glm::vec3 MeshData::faceNormal(size_t faceIndex) const {
-    if (faceIndex * 3 + 2 >= indices_.size()) {
+    const auto& vertices = vertices_.read();
+    const auto& indices = indices_.read();
+    if (faceIndex * 3 + 2 >= indices.size()) {
         return glm::vec3(0.0f, 0.0f, 1.0f);
     }
     
-    uint32_t i0 = indices_[faceIndex * 3 + 0];
-    uint32_t i1 = indices_[faceIndex * 3 + 1];
-    uint32_t i2 = indices_[faceIndex * 3 + 2];
+    uint32_t i0 = indices[faceIndex * 3 + 0];
+    uint32_t i1 = indices[faceIndex * 3 + 1];
+    uint32_t i2 = indices[faceIndex * 3 + 2];
     
-    const glm::vec3& v0 = vertices_[i0];
-    const glm::vec3& v1 = vertices_[i1];
-    const glm::vec3& v2 = vertices_[i2];
+    const glm::vec3& v0 = vertices[i0];
+    const glm::vec3& v1 = vertices[i1];
+    const glm::vec3& v2 = vertices[i2];
     
     glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
     float len = glm::length(normal);
@@ -311,24 +450,27 @@ glm::vec3 MeshData::faceNormal(size_t faceIndex) const {
 }
 
 float MeshData::faceArea(size_t faceIndex) const {
-    if (faceIndex * 3 + 2 >= indices_.size()) {
+    const auto& vertices = vertices_.read();
+    const auto& indices = indices_.read();
+    if (faceIndex * 3 + 2 >= indices.size()) {
         return 0.0f;
     }
     
-    uint32_t i0 = indices_[faceIndex * 3 + 0];
-    uint32_t i1 = indices_[faceIndex * 3 + 1];
-    uint32_t i2 = indices_[faceIndex * 3 + 2];
+    uint32_t i0 = indices[faceIndex * 3 + 0];
+    uint32_t i1 = indices[faceIndex * 3 + 1];
+    uint32_t i2 = indices[faceIndex * 3 + 2];
     
-    const glm::vec3& v0 = vertices_[i0];
-    const glm::vec3& v1 = vertices_[i1];
-    const glm::vec3& v2 = vertices_[i2];
+    const glm::vec3& v0 = vertices[i0];
+    const glm::vec3& v1 = vertices[i1];
+    const glm::vec3& v2 = vertices[i2];
     
     return 0.5f * glm::length(glm::cross(v1 - v0, v2 - v0));
 }
 
 float MeshData::surfaceArea() const {
+    const auto& indices = indices_.read();
     float area = 0.0f;
-    size_t numFaces = indices_.size() / 3;
+    size_t numFaces = indices.size() / 3;
     
     for (size_t f = 0; f < numFaces; ++f) {
         area += faceArea(f);
@@ -338,19 +480,21 @@ float MeshData::surfaceArea() const {
 }
 
 float MeshData::volume() const {
+    const auto& vertices = vertices_.read();
+    const auto& indices = indices_.read();
     // Compute signed volume using divergence theorem
     // V = (1/6) * sum over faces of (v0 · (v1 × v2))
     float vol = 0.0f;
-    size_t numFaces = indices_.size() / 3;
+    size_t numFaces = indices.size() / 3;
     
     for (size_t f = 0; f < numFaces; ++f) {
-        uint32_t i0 = indices_[f * 3 + 0];
-        uint32_t i1 = indices_[f * 3 + 1];
-        uint32_t i2 = indices_[f * 3 + 2];
+        uint32_t i0 = indices[f * 3 + 0];
+        uint32_t i1 = indices[f * 3 + 1];
+        uint32_t i2 = indices[f * 3 + 2];
         
-        const glm::vec3& v0 = vertices_[i0];
-        const glm::vec3& v1 = vertices_[i1];
-        const glm::vec3& v2 = vertices_[i2];
+        const glm::vec3& v0 = vertices[i0];
+        const glm::vec3& v1 = vertices[i1];
+        const glm::vec3& v2 = vertices[i2];
         
         vol += glm::dot(v0, glm::cross(v1, v2));
     }
@@ -359,29 +503,30 @@ float MeshData::volume() const {
 }
 
 glm::vec3 MeshData::centroid() const {
-    if (vertices_.empty()) {
+    const auto& vertices = vertices_.read();
+    if (vertices.empty()) {
         return glm::vec3(0.0f);
     }
     
     glm::vec3 sum(0.0f);
-    for (const auto& v : vertices_) {
+    for (const auto& v : vertices) {
         sum += v;
     }
     
-    return sum / static_cast<float>(vertices_.size());
+    return sum / static_cast<float>(vertices.size());
 }
 
 void MeshData::transform(const glm::mat4& matrix) {
     // Transform positions
-    for (auto& v : vertices_) {
+    for (auto& v : vertices_.write()) {
         glm::vec4 transformed = matrix * glm::vec4(v, 1.0f);
         v = glm::vec3(transformed) / transformed.w;
     }
     
     // Transform normals using normal matrix (transpose of inverse of upper-left 3x3)
-    if (!normals_.empty()) {
+    if (hasNormals()) {
         glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(matrix)));
-        for (auto& n : normals_) {
+        for (auto& n : normals_.write()) {
             n = glm::normalize(normalMatrix * n);
         }
     }
@@ -390,21 +535,24 @@ void MeshData::transform(const glm::mat4& matrix) {
 }
 
 void MeshData::translate(const glm::vec3& offset) {
-    for (auto& v : vertices_) {
+    auto& vertices = vertices_.write();
+    for (auto& v : vertices) {
         v += offset;
     }
     invalidateBounds();
 }
 
 void MeshData::scale(float factor) {
-    for (auto& v : vertices_) {
+    auto& vertices = vertices_.write();
+    for (auto& v : vertices) {
         v *= factor;
     }
     invalidateBounds();
 }
 
 void MeshData::scale(const glm::vec3& factors) {
-    for (auto& v : vertices_) {
+    auto& vertices = vertices_.write();
+    for (auto& v : vertices) {
         v *= factors;
     }
     invalidateBounds();
@@ -430,8 +578,9 @@ void MeshData::normalizeToUnitCube() {
 }
 
 size_t MeshData::countDegenerateFaces(float areaThreshold) const {
+    const auto& indices = indices_.read();
     size_t count = 0;
-    size_t numFaces = indices_.size() / 3;
+    size_t numFaces = indices.size() / 3;
     
     for (size_t f = 0; f < numFaces; ++f) {
         if (faceArea(f) < areaThreshold) {
@@ -443,48 +592,50 @@ size_t MeshData::countDegenerateFaces(float areaThreshold) const {
 }
 
 size_t MeshData::removeDegenerateFaces(float areaThreshold) {
+    const auto& indices = indices_.read();
     std::vector<uint32_t> newIndices;
-    newIndices.reserve(indices_.size());
+    newIndices.reserve(indices.size());
     
-    size_t numFaces = indices_.size() / 3;
+    size_t numFaces = indices.size() / 3;
     size_t removed = 0;
     
     for (size_t f = 0; f < numFaces; ++f) {
         if (faceArea(f) >= areaThreshold) {
-            newIndices.push_back(indices_[f * 3 + 0]);
-            newIndices.push_back(indices_[f * 3 + 1]);
-            newIndices.push_back(indices_[f * 3 + 2]);
+            newIndices.push_back(indices[f * 3 + 0]);
+            newIndices.push_back(indices[f * 3 + 1]);
+            newIndices.push_back(indices[f * 3 + 2]);
         } else {
             ++removed;
         }
     }
     
-    indices_ = std::move(newIndices);
+    indices_.assign(std::move(newIndices));
     return removed;
 }
 
 size_t MeshData::countDuplicateVertices(float tolerance) const {
-    if (vertices_.empty()) return 0;
+    const auto& vertices = vertices_.read();
+    if (vertices.empty()) return 0;
     
     // FIX Bug 24: Check neighbor cells to catch duplicates near cell boundaries
     // Use spatial hashing for efficient duplicate detection
     Vec3Hash hasher(tolerance);
     std::unordered_multimap<size_t, size_t> spatialHash;
     
-    for (size_t i = 0; i < vertices_.size(); ++i) {
-        spatialHash.emplace(hasher(vertices_[i]), i);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        spatialHash.emplace(hasher(vertices[i]), i);
     }
     
     size_t duplicates = 0;
-    std::vector<bool> counted(vertices_.size(), false);
+    std::vector<bool> counted(vertices.size(), false);
     
     float tolSq = tolerance * tolerance;
     float cellSize = std::max(tolerance, 1e-7f);
     
-    for (size_t i = 0; i < vertices_.size(); ++i) {
+    for (size_t i = 0; i < vertices.size(); ++i) {
         if (counted[i]) continue;
         
-        const glm::vec3& vi = vertices_[i];
+        const glm::vec3& vi = vertices[i];
         
         // Check 3x3x3 neighborhood of cells to catch boundary cases
         for (int dx = -1; dx <= 1; ++dx) {
@@ -498,7 +649,7 @@ size_t MeshData::countDuplicateVertices(float tolerance) const {
                         size_t j = it->second;
                         if (j <= i) continue;
                         
-                        if (glm::length2(vertices_[j] - vi) < tolSq) {
+                        if (glm::length2(vertices[j] - vi) < tolSq) {
                             if (!counted[j]) {
                                 counted[j] = true;
                                 ++duplicates;
@@ -514,91 +665,142 @@ size_t MeshData::countDuplicateVertices(float tolerance) const {
 }
 
 size_t MeshData::mergeDuplicateVertices(float tolerance, ProgressCallback progress) {
-    if (vertices_.empty()) return 0;
+    const auto& vertices = vertices_.read();
+    const auto& normals = normals_.read();
+    const auto& uvs = uvs_.read();
+    if (vertices.empty()) return 0;
     
-    const size_t totalVertices = vertices_.size();
+    const size_t totalVertices = vertices.size();
     const bool reportProgress = progress && totalVertices > 1000000;
     
-    // Use spatial hashing for efficient duplicate detection
-    Vec3Hash hasher(tolerance);
-    std::unordered_map<size_t, std::vector<size_t>> spatialHash;
+    // Sort-based spatial hashing: vertices with equal cell hashes end up in
+    // contiguous runs, ordered by index within a run. This gives the same
+    // buckets as a hash map, without per-bucket allocations, and every
+    // phase runs in parallel.
+    struct CellKey {
+        size_t hash;
+        uint32_t index;
+    };
     
-    // Build spatial hash
-    for (size_t i = 0; i < totalVertices; ++i) {
-        spatialHash[hasher(vertices_[i])].push_back(i);
-        
-        if (reportProgress && (i % 100000 == 0)) {
-            if (!progress(static_cast<float>(i) / (2.0f * totalVertices))) {
-                return 0;  // Cancelled
-            }
+    Vec3Hash hasher(tolerance);
+    std::vector<CellKey> keys(totalVertices);
+    core::parallelFor(0, totalVertices, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            keys[i] = {hasher(vertices[i]), static_cast<uint32_t>(i)};
         }
-    }
-    
-    // Map old indices to new indices
-    std::vector<uint32_t> indexMap(totalVertices);
-    std::vector<glm::vec3> newVertices;
-    std::vector<glm::vec3> newNormals;
-    std::vector<glm::vec2> newUVs;
+    });
     
-    newVertices.reserve(totalVertices);
-    if (hasNormals()) newNormals.reserve(totalVertices);
-    if (hasUVs()) newUVs.reserve(totalVertices);
+    core::parallelSort(keys.begin(), keys.end(), [](const CellKey& a, const CellKey& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.index < b.index;
+    });
     
-    float tolSq = tolerance * tolerance;
-    size_t mergedCount = 0;
+    if (reportProgress && !progress(0.4f)) {
+        return 0;  // Cancelled
+    }
     
-    for (size_t i = 0; i < totalVertices; ++i) {
-        const glm::vec3& vi = vertices_[i];
-        size_t h = hasher(vi);
-        
-        // Check if we've already processed a duplicate of this vertex
-        bool foundDuplicate = false;
-        const auto& bucket = spatialHash[h];
-        
-        for (size_t j : bucket) {
-            if (j >= i) break;  // Only check previously processed vertices
+    // Resolve each vertex to the representative of the first earlier vertex
+    // in its bucket within tolerance (itself if none). Each chunk handles the
+    // runs that start inside it, so runs are never split between threads.
+    const float tolSq = tolerance * tolerance;
+    std::vector<uint32_t> representative(totalVertices);
+    core::parallelFor(0, totalVertices, [&](size_t begin, size_t end) {
+        size_t runBegin = begin;
+        while (runBegin < end && runBegin > 0 && keys[runBegin].hash == keys[runBegin - 1].hash) {
+            ++runBegin;
+        }
+        while (runBegin < end) {
+            size_t runEnd = runBegin + 1;
+            while (runEnd < totalVertices && keys[runEnd].hash == keys[runBegin].hash) {
+                ++runEnd;
+            }
             
-            if (glm::length2(vertices_[j] - vi) < tolSq) {
-                // Found a duplicate - use its new index
-                indexMap[i] = indexMap[j];
-                foundDuplicate = true;
-                ++mergedCount;
-                break;
+            for (size_t k = runBegin; k < runEnd; ++k) {
+                const uint32_t i = keys[k].index;
+                const glm::vec3& vi = vertices[i];
+                representative[i] = i;
+                for (size_t m = runBegin; m < k; ++m) {
+                    const uint32_t j = keys[m].index;
+                    if (glm::length2(vertices[j] - vi) < tolSq) {
+                        representative[i] = representative[j];
+                        break;
+                    }
+                }
             }
+            runBegin = runEnd;
         }
-        
-        if (!foundDuplicate) {
-            // New unique vertex
-            indexMap[i] = static_cast<uint32_t>(newVertices.size());
-            newVertices.push_back(vi);
-            
-            if (hasNormals()) {
-                newNormals.push_back(normals_[i]);
+    });
+    
+    if (reportProgress && !progress(0.7f)) {
+        return 0;  // Cancelled
+    }
+    
+    // New indices follow first occurrence order: prefix sum over unique flags
+    const size_t grain = core::defaultGrainSize(totalVertices,
+                                                core::TaskScheduler::instance().threadCount());
+    const size_t numChunks = (totalVertices + grain - 1) / grain;
+    std::vector<uint32_t> chunkOffsets(numChunks + 1, 0);
+    core::parallelFor(0, numChunks, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+            const size_t last = std::min((c + 1) * grain, totalVertices);
+            uint32_t unique = 0;
+            for (size_t i = c * grain; i < last; ++i) {
+                unique += representative[i] == i ? 1 : 0;
             }
-            if (hasUVs()) {
-                newUVs.push_back(uvs_[i]);
+            chunkOffsets[c + 1] = unique;
+        }
+    }, 1);
+    for (size_t c = 0; c < numChunks; ++c) {
+        chunkOffsets[c + 1] += chunkOffsets[c];
+    }
+    const size_t uniqueCount = chunkOffsets[numChunks];
+    
+    const bool keepNormals = hasNormals();
+    const bool keepUVs = hasUVs();
+    std::vector<uint32_t> indexMap(totalVertices);
+    std::vector<glm::vec3> newVertices(uniqueCount);
+    std::vector<glm::vec3> newNormals(keepNormals ? uniqueCount : 0);
+    std::vector<glm::vec2> newUVs(keepUVs ? uniqueCount : 0);
+    
+    core::parallelFor(0, numChunks, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+            const size_t last = std::min((c + 1) * grain, totalVertices);
+            uint32_t next = chunkOffsets[c];
+            for (size_t i = c * grain; i < last; ++i) {
+                if (representative[i] != i) continue;
+                indexMap[i] = next;
+                newVertices[next] = vertices[i];
+                if (keepNormals) newNormals[next] = normals[i];
+                if (keepUVs) newUVs[next] = uvs[i];
+                ++next;
             }
         }
-        
-        if (reportProgress && (i % 100000 == 0)) {
-            if (!progress(0.5f + static_cast<float>(i) / (2.0f * totalVertices))) {
-                return mergedCount;  // Cancelled
+    }, 1);
+    
+    // Representatives always precede their duplicates, so their slot is set
+    core::parallelFor(0, totalVertices, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (representative[i] != i) {
+                indexMap[i] = indexMap[representative[i]];
             }
         }
-    }
+    });
     
     // Update indices to use new vertex indices
-    for (auto& idx : indices_) {
-        idx = indexMap[idx];
-    }
+    auto& indices = indices_.write();
+    core::parallelFor(0, indices.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            indices[i] = indexMap[indices[i]];
+        }
+    });
     
-    // Replace vertex arrays
-    vertices_ = std::move(newVertices);
-    if (hasNormals()) {
-        normals_ = std::move(newNormals);
+    // Replace vertex arrays (flags captured up front: hasNormals() compares
+    // against the vertex count, which changes here)
+    vertices_.assign(std::move(newVertices));
+    if (keepNormals) {
+        normals_.assign(std::move(newNormals));
     }
-    if (hasUVs()) {
-        uvs_ = std::move(newUVs);
+    if (keepUVs) {
+        uvs_.assign(std::move(newUVs));
     }
     
     invalidateBounds();
@@ -607,25 +809,32 @@ size_t MeshData::mergeDuplicateVertices(float tolerance, ProgressCallback progre
         progress(1.0f);
     }
     
-    return mergedCount;
+    return totalVertices - uniqueCount;
+}
+
+uint64_t MeshData::contentHash() const {
+    const auto& vertices = vertices_.read();
+    const auto& indices = indices_.read();
+    uint64_t hash = hashArray(vertices.data(), vertices.size() * sizeof(glm::vec3), 0);
+    return hashArray(indices.data(), indices.size() * sizeof(uint32_t), hash);
 }
 
 size_t MeshData::memoryUsage() const {
     size_t bytes = 0;
-    bytes += vertices_.capacity() * sizeof(glm::vec3);
-    bytes += indices_.capacity() * sizeof(uint32_t);
-    bytes += normals_.capacity() * sizeof(glm::vec3);
-    bytes += uvs_.capacity() * sizeof(glm::vec2);
+    bytes += vertices_.read().capacity() * sizeof(glm::vec3);
+    bytes += indices_.read().capacity() * sizeof(uint32_t);
+    bytes += normals_.read().capacity() * sizeof(glm::vec3);
+    bytes += uvs_.read().capacity() * sizeof(glm::vec2);
     bytes += sizeof(BoundingBox);
     bytes += sizeof(bool);
     return bytes;
 }
 
 void MeshData::shrinkToFit() {
-    vertices_.shrink_to_fit();
-    indices_.shrink_to_fit();
-    normals_.shrink_to_fit();
-    uvs_.shrink_to_fit();
+    vertices_.shrinkToFit();
+    indices_.shrinkToFit();
+    normals_.shrinkToFit();
+    uvs_.shrinkToFit();
 }
 
 } // namespace geometry
@@ -17,6 +17,8 @@
 
 #include <glm/glm.hpp>
 
+#include "SharedArray.h"
+
 namespace dc3d {
 namespace geometry {
 
@@ -126,6 +128,13 @@ struct MeshStats {
  * This is a simple indexed triangle mesh (triangle soup), suitable for
  * rendering and as input for algorithms. For topological operations,
  * convert to HalfEdgeMesh.
+ * 
+ * Each array is copy-on-write (see SharedArray): copies of a mesh share
+ * their arrays, and an edit duplicates only the arrays it touches. The
+ * accessors are read-only, so reading never copies. Writes go through
+ * editVertices(), editIndices(), editNormals() and editUVs(), which give
+ * the mesh its own copy of that whole array first if another mesh still
+ * shares it.
  */
 class MeshData {
 public:
@@ -136,7 +145,7 @@ public:
     MeshData(MeshData&&) noexcept = default;
     MeshData& operator=(MeshData&&) noexcept = default;
     
-    // Copy (can be expensive for large meshes)
+    // Copy is cheap: arrays are shared until one side writes to them
     MeshData(const MeshData&) = default;
     MeshData& operator=(const MeshData&) = default;
     
@@ -144,51 +153,57 @@ public:
     // Data Access
     // ===================
     
-    /// Get vertex positions (read-only)
-    const std::vector<glm::vec3>& vertices() const { return vertices_; }
+    /// Get vertex positions
+    const std::vector<glm::vec3>& vertices() const { return vertices_.read(); }
+    
+    /// Get vertex positions for writing (unshares them first)
+    std::vector<glm::vec3>& editVertices() { return vertices_.write(); }
     
-    /// Get vertex positions (mutable)
-    std::vector<glm::vec3>& vertices() { return vertices_; }
+    /// Get face indices - every 3 indices form a triangle
+    const std::vector<uint32_t>& indices() const { return indices_.read(); }
     
-    /// Get face indices (read-only) - every 3 indices form a triangle
-    const std::vector<uint32_t>& indices() const { return indices_; }
+    /// Get face indices for writing (unshares them first)
+    std::vector<uint32_t>& editIndices() { return indices_.write(); }
     
-    /// Get face indices (mutable)
-    std::vector<uint32_t>& indices() { return indices_; }
+    /// Get vertex normals
+    const std::vector<glm::vec3>& normals() const { return normals_.read(); }
     
-    /// Get vertex normals (read-only)
-    const std::vector<glm::vec3>& normals() const { return normals_; }
+    /// Get vertex normals for writing (unshares them first)
+    std::vector<glm::vec3>& editNormals() { return normals_.write(); }
     
-    /// Get vertex normals (mutable)
-    std::vector<glm::vec3>& normals() { return normals_; }
+    /// Get texture coordinates
+    const std::vector<glm::vec2>& uvs() const { return uvs_.read(); }
     
-    /// Get texture coordinates (read-only)
-    const std::vector<glm::vec2>& uvs() const { return uvs_; }
+    /// Get texture coordinates for writing (unshares them first)
+    std::vector<glm::vec2>& editUVs() { return uvs_.write(); }
     
-    /// Get texture coordinates (mutable)
-    std::vector<glm::vec2>& uvs() { return uvs_; }
+    /// Shared vertex positions, for holders that keep their own reference (BVH)
+    const SharedArray<glm::vec3>& vertexArray() const { return vertices_; }
+    
+    /// Shared face indices, for holders that keep their own reference (BVH)
+    const SharedArray<uint32_t>& indexArray() const { return indices_; }
     
     // ===================
     // Statistics
     // ===================
     
     /// Number of vertices
-    size_t vertexCount() const { return vertices_.size(); }
+    size_t vertexCount() const { return vertices().size(); }
     
     /// Number of triangular faces
-    size_t faceCount() const { return indices_.size() / 3; }
+    size_t faceCount() const { return indices().size() / 3; }
     
     /// Number of indices
-    size_t indexCount() const { return indices_.size(); }
+    size_t indexCount() const { return indices().size(); }
     
     /// Check if mesh has normals
-    bool hasNormals() const { return !normals_.empty() && normals_.size() == vertices_.size(); }
+    bool hasNormals() const { return !normals().empty() && normals().size() == vertices().size(); }
     
     /// Check if mesh has texture coordinates
-    bool hasUVs() const { return !uvs_.empty() && uvs_.size() == vertices_.size(); }
+    bool hasUVs() const { return !uvs().empty() && uvs().size() == vertices().size(); }
     
     /// Check if mesh is empty
-    bool isEmpty() const { return vertices_.empty() || indices_.empty(); }
+    bool isEmpty() const { return vertices().empty() || indices().empty(); }
     
     /// Check if mesh has valid data
     bool isValid() const;
@@ -196,6 +211,9 @@ public:
     /// Get bounding box (cached, computed lazily)
     const BoundingBox& boundingBox() const;
     
+    /// Mark the cached bounding box stale after editing vertices() directly
+    void invalidateBounds() { boundsDirty_ = true; }
+    
     /// Get comprehensive mesh statistics
     MeshStats computeStats() const;
     
@@ -294,6 +312,20 @@ public:
     /// Merge duplicate vertices within tolerance
     size_t mergeDuplicateVertices(float tolerance = 1e-6f, ProgressCallback progress = nullptr);
     
+    // ===================
+    // Identity
+    // ===================
+    
+    /**
+     * @brief 64-bit hash of the vertex positions and face indices
+     * 
+     * Identical geometry always gives the same value, in any session and
+     * with any thread count, so it can key data derived from the mesh
+     * (see DerivedDataCache). Normals and UVs are not included. Hashes the
+     * arrays in parallel blocks with XXH64; cost is one pass over memory.
+     */
+    uint64_t contentHash() const;
+    
     // ===================
     // Memory
     // ===================
@@ -305,16 +337,15 @@ public:
     void shrinkToFit();
     
 private:
-    std::vector<glm::vec3> vertices_;
-    std::vector<uint32_t> indices_;
-    std::vector<glm::vec3> normals_;
-    std::vector<glm::vec2> uvs_;
+    SharedArray<glm::vec3> vertices_;
+    SharedArray<uint32_t> indices_;
+    SharedArray<glm::vec3> normals_;
+    SharedArray<glm::vec2> uvs_;
     
     // Cached bounding box
     mutable BoundingBox bounds_;
     mutable bool boundsDirty_ = true;
     
-    void invalidateBounds() { boundsDirty_ = true; }
     void updateBounds() const;
 };
 
@@ -529,7 +529,7 @@ MeshData DecimationState::toMeshData() const {
     for (size_t i = 0; i < mesh_.vertexCount(); ++i) {
         if (!vertexDeleted_[i]) {
             vertexMap[i] = newIdx++;
-            output.vertices().push_back(mesh_.vertex(static_cast<uint32_t>(i)).position);
+            output.editVertices().push_back(mesh_.vertex(static_cast<uint32_t>(i)).position);
         }
     }
     
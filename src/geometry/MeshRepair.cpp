@@ -207,9 +207,9 @@ size_t MeshRepair::keepLargestComponent(MeshData& mesh) {
             }
             if (vertexMap[vi] == INVALID_INDEX) {
                 vertexMap[vi] = static_cast<uint32_t>(newMesh.vertices().size());
-                newMesh.vertices().push_back(vertices[vi]);
+                newMesh.editVertices().push_back(vertices[vi]);
                 if (!normals.empty() && vi < normals.size()) {
-                    newMesh.normals().push_back(normals[vi]);
+                    newMesh.editNormals().push_back(normals[vi]);
                 }
             }
             newIndices[i] = vertexMap[vi];
@@ -310,7 +310,7 @@ RepairResult MeshRepair::removeOutliers(
             uint32_t vi = indices[fi * 3 + i];
             if (vertexMap[vi] == INVALID_INDEX) {
                 vertexMap[vi] = static_cast<uint32_t>(newMesh.vertices().size());
-                newMesh.vertices().push_back(vertices[vi]);
+                newMesh.editVertices().push_back(vertices[vi]);
             }
             newIndices[i] = vertexMap[vi];
         }
@@ -635,7 +635,7 @@ size_t MeshRepair::removeDuplicateVertices(
     if (mesh.isEmpty()) return 0;
     
     const auto& vertices = mesh.vertices();
-    auto& indices = mesh.indices();
+    auto& indices = mesh.editIndices();
     
     // Use spatial hashing for efficiency
     SpatialGrid grid(tolerance * 10.0f);
@@ -684,9 +684,9 @@ size_t MeshRepair::removeDuplicateVertices(
     
     size_t removed = vertices.size() - newVertices.size();
     
-    mesh.vertices() = std::move(newVertices);
+    mesh.editVertices() = std::move(newVertices);
     if (!newNormals.empty()) {
-        mesh.normals() = std::move(newNormals);
+        mesh.editNormals() = std::move(newNormals);
     }
     
     // Remove degenerate faces created by merging
@@ -747,7 +747,7 @@ size_t MeshRepair::removeDegenerateFaces(MeshData& mesh) {
         }
     }
     
-    mesh.indices() = std::move(newIndices);
+    mesh.editIndices() = std::move(newIndices);
     
     return degenerate.size();
 }
@@ -855,7 +855,7 @@ RepairResult MeshRepair::makeManifold(
         }
         
         result.itemsRemoved = removeFaces.size();
-        mesh.indices() = std::move(newIndices);
+        mesh.editIndices() = std::move(newIndices);
     }
     
     // Step 2: Handle non-manifold vertices
@@ -964,7 +964,7 @@ size_t MeshRepair::makeOrientationConsistent(MeshData& mesh) {
     
     // Apply flips
     if (flipCount > 0) {
-        auto& mutableIndices = mesh.indices();
+        auto& mutableIndices = mesh.editIndices();
         for (size_t fi = 0; fi < faceCount; ++fi) {
             if (flipped[fi]) {
                 std::swap(mutableIndices[fi * 3 + 1], mutableIndices[fi * 3 + 2]);
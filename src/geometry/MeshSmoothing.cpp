@@ -5,6 +5,7 @@
 
 #include "MeshSmoothing.h"
 #include "HalfEdgeMesh.h"
+#include "../core/TaskScheduler.h"
 
 #include <cmath>
 #include <algorithm>
@@ -296,10 +297,34 @@ SmoothingResult MeshSmoother::smooth(
         }
     }
     
-    auto& vertices = mesh.vertices();
+    auto& vertices = mesh.editVertices();
     std::vector<glm::vec3> newPositions(vertices.size());
     std::vector<glm::vec3> bValues;  // For HC smoothing
     
+    // Per-vertex Laplacian step into newPositions. Each vertex only reads the
+    // current positions and writes its own slot, so vertices run in parallel.
+    auto laplacianStep = [&](float factor, bool cotangent) {
+        core::parallelFor(0, vertices.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (fixedVertices.count(static_cast<uint32_t>(i))) {
+                    newPositions[i] = vertices[i];
+                    continue;
+                }
+                
+                glm::vec3 laplacian;
+                if (cotangent) {
+                    laplacian = computeCotangentLaplacian(
+                        mesh, static_cast<uint32_t>(i), adjacency, vertexFaces);
+                } else {
+                    laplacian = computeLaplacian(
+                        mesh, static_cast<uint32_t>(i), adjacency);
+                }
+                
+                newPositions[i] = vertices[i] + factor * laplacian;
+            }
+        });
+    };
+    
     // FIX: Track total displacement locally to avoid uninitialized struct member issue
     float localTotalDisplacement = 0.0f;
     
@@ -317,23 +342,8 @@ SmoothingResult MeshSmoother::smooth(
         switch (options.algorithm) {
             case SmoothingAlgorithm::Laplacian:
             case SmoothingAlgorithm::Cotangent: {
-                for (size_t i = 0; i < vertices.size(); ++i) {
-                    if (fixedVertices.count(static_cast<uint32_t>(i))) {
-                        newPositions[i] = vertices[i];
-                        continue;
-                    }
-                    
-                    glm::vec3 laplacian;
-                    if (options.algorithm == SmoothingAlgorithm::Cotangent) {
-                        laplacian = computeCotangentLaplacian(
-                            mesh, static_cast<uint32_t>(i), adjacency, vertexFaces);
-                    } else {
-                        laplacian = computeLaplacian(
-                            mesh, static_cast<uint32_t>(i), adjacency);
-                    }
-                    
-                    newPositions[i] = vertices[i] + options.lambda * laplacian;
-                }
+                laplacianStep(options.lambda,
+                              options.algorithm == SmoothingAlgorithm::Cotangent);
                 
                 // Apply
                 for (size_t i = 0; i < vertices.size(); ++i) {
@@ -350,30 +360,12 @@ SmoothingResult MeshSmoother::smooth(
             
             case SmoothingAlgorithm::Taubin: {
                 // Forward pass (shrink)
-                for (size_t i = 0; i < vertices.size(); ++i) {
-                    if (fixedVertices.count(static_cast<uint32_t>(i))) {
-                        newPositions[i] = vertices[i];
-                        continue;
-                    }
-                    
-                    glm::vec3 laplacian = computeLaplacian(
-                        mesh, static_cast<uint32_t>(i), adjacency);
-                    newPositions[i] = vertices[i] + options.lambda * laplacian;
-                }
+                laplacianStep(options.lambda, false);
                 
                 vertices = newPositions;
                 
                 // Backward pass (inflate)
-                for (size_t i = 0; i < vertices.size(); ++i) {
-                    if (fixedVertices.count(static_cast<uint32_t>(i))) {
-                        newPositions[i] = vertices[i];
-                        continue;
-                    }
-                    
-                    glm::vec3 laplacian = computeLaplacian(
-                        mesh, static_cast<uint32_t>(i), adjacency);
-                    newPositions[i] = vertices[i] + options.mu * laplacian;
-                }
+                laplacianStep(options.mu, false);
                 
                 // Apply and measure
                 for (size_t i = 0; i < vertices.size(); ++i) {
@@ -388,45 +380,40 @@ SmoothingResult MeshSmoother::smooth(
             
             case SmoothingAlgorithm::HCLaplacian: {
                 // Step 1: Regular Laplacian smoothing
-                for (size_t i = 0; i < vertices.size(); ++i) {
-                    if (fixedVertices.count(static_cast<uint32_t>(i))) {
-                        newPositions[i] = vertices[i];
-                        continue;
-                    }
-                    
-                    glm::vec3 laplacian = computeLaplacian(
-                        mesh, static_cast<uint32_t>(i), adjacency);
-                    newPositions[i] = vertices[i] + options.lambda * laplacian;
-                }
+                laplacianStep(options.lambda, false);
                 
                 // Step 2: Compute b values (difference from original)
                 bValues.resize(vertices.size());
-                for (size_t i = 0; i < vertices.size(); ++i) {
-                    bValues[i] = newPositions[i] - 
-                        (options.alpha * originalPositions[i] + 
-                         (1.0f - options.alpha) * vertices[i]);
-                }
+                core::parallelFor(0, vertices.size(), [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        bValues[i] = newPositions[i] - 
+                            (options.alpha * originalPositions[i] + 
+                             (1.0f - options.alpha) * vertices[i]);
+                    }
+                });
                 
                 // Step 3: Pushback based on neighbor b values
-                for (size_t i = 0; i < vertices.size(); ++i) {
-                    if (fixedVertices.count(static_cast<uint32_t>(i))) {
-                        continue;
+                core::parallelFor(0, vertices.size(), [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        if (fixedVertices.count(static_cast<uint32_t>(i))) {
+                            continue;
+                        }
+                        
+                        // Average neighbor b values
+                        const auto& neighbors = adjacency[i];
+                        glm::vec3 avgB(0.0f);
+                        for (uint32_t ni : neighbors) {
+                            avgB += bValues[ni];
+                        }
+                        if (!neighbors.empty()) {
+                            avgB /= static_cast<float>(neighbors.size());
+                        }
+                        
+                        // Pushback
+                        newPositions[i] -= options.beta * bValues[i] + 
+                                           (1.0f - options.beta) * avgB;
                     }
-                    
-                    // Average neighbor b values
-                    const auto& neighbors = adjacency[i];
-                    glm::vec3 avgB(0.0f);
-                    for (uint32_t ni : neighbors) {
-                        avgB += bValues[ni];
-                    }
-                    if (!neighbors.empty()) {
-                        avgB /= static_cast<float>(neighbors.size());
-                    }
-                    
-                    // Pushback
-                    newPositions[i] -= options.beta * bValues[i] + 
-                                       (1.0f - options.beta) * avgB;
-                }
+                });
                 
                 // Apply
                 for (size_t i = 0; i < vertices.size(); ++i) {
@@ -516,7 +503,7 @@ size_t MeshSmoother::hcSmooth(
         fixedVertices = findBoundaryVertices(mesh);
     }
     
-    auto& vertices = mesh.vertices();
+    auto& vertices = mesh.editVertices();
     std::vector<glm::vec3> newPositions(vertices.size());
     std::vector<glm::vec3> bValues(vertices.size());
     
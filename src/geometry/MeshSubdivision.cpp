@@ -772,7 +772,7 @@ Result<MeshData> MeshSubdivider::midpointSubdivide(const MeshData& mesh) {
     MeshData output;
     
     // Copy original vertices
-    output.vertices() = mesh.vertices();
+    output.editVertices() = mesh.vertices();
     
     const auto& indices = mesh.indices();
     const auto& vertices = mesh.vertices();
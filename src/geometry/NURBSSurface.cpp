@@ -358,13 +358,13 @@ MeshData NURBSSurface::tessellate(int uDivs, int vDivs) const {
     }
     
     // Set up UVs
-    mesh.uvs().resize(mesh.vertexCount());
+    mesh.editUVs().resize(mesh.vertexCount());
     int idx = 0;
     for (int j = 0; j <= vDivs; ++j) {
         float v = static_cast<float>(j) / vDivs;
         for (int i = 0; i <= uDivs; ++i) {
             float u = static_cast<float>(i) / uDivs;
-            mesh.uvs()[idx++] = glm::vec2(u, v);
+            mesh.editUVs()[idx++] = glm::vec2(u, v);
         }
     }
     
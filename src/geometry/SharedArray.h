@@ -0,0 +1,109 @@
+/**
+ * @file SharedArray.h
+ * @brief Copy-on-write array used for the attribute arrays of MeshData
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace dc3d {
+namespace geometry {
+
+/**
+ * @brief std::vector shared between copies until one of them writes
+ *
+ * Copying a SharedArray only copies a reference. write() gives the holder
+ * its own copy first if anyone else still references the contents, so
+ * readers holding an older copy (a BVH, an undo snapshot, a preview on
+ * another thread) never see the change. Contents stay one contiguous
+ * std::vector, so data() can go straight to the GPU or a SIMD loop.
+ *
+ * A reference obtained from write() must not be held across a copy of the
+ * array: writes through it would then show up in both copies.
+ *
+ * Like std::vector, a single SharedArray must not be written and read from
+ * different threads at once; distinct copies may be used freely.
+ */
+template<typename T>
+class SharedArray {
+public:
+    SharedArray() : m_data(emptyData()) {}
+
+    explicit SharedArray(std::vector<T>&& values)
+        : m_data(std::make_shared<std::vector<T>>(std::move(values))) {}
+
+    SharedArray(const SharedArray&) = default;
+    SharedArray& operator=(const SharedArray&) = default;
+
+    // A moved-from array is empty (never null)
+    SharedArray(SharedArray&& other) noexcept
+        : m_data(std::exchange(other.m_data, emptyData())) {}
+
+    SharedArray& operator=(SharedArray&& other) noexcept
+    {
+        if (this != &other) {
+            m_data = std::exchange(other.m_data, emptyData());
+        }
+        return *this;
+    }
+
+    /// Read access (never copies)
+    const std::vector<T>& read() const { return *m_data; }
+
+    /// Write access; copies the contents first if they are shared
+    std::vector<T>& write()
+    {
+        if (m_data.use_count() > 1) {
+            m_data = std::make_shared<std::vector<T>>(*m_data);
+        }
+        return *m_data;
+    }
+
+    /// Write access for replacing all contents; never copies the old ones
+    std::vector<T>& overwrite()
+    {
+        if (m_data.use_count() > 1) {
+            m_data = std::make_shared<std::vector<T>>();
+        }
+        return *m_data;
+    }
+
+    /// Replace the contents
+    void assign(std::vector<T>&& values)
+    {
+        m_data = std::make_shared<std::vector<T>>(std::move(values));
+    }
+
+    /// Drop the contents (and this holder's reference to them)
+    void clear() { m_data = emptyData(); }
+
+    /// Release unused capacity, unless the contents are shared
+    void shrinkToFit()
+    {
+        if (m_data.use_count() == 1) {
+            m_data->shrink_to_fit();
+        }
+    }
+
+    /// Check if another SharedArray references the same contents
+    bool isShared() const { return m_data.use_count() > 1; }
+
+    /// Check if this and other reference the same contents (no edit since they were shared)
+    bool sharesWith(const SharedArray& other) const { return m_data == other.m_data; }
+
+private:
+    // Shared empty contents, so that m_data is never null
+    static const std::shared_ptr<std::vector<T>>& emptyData()
+    {
+        static const std::shared_ptr<std::vector<T>> empty = std::make_shared<std::vector<T>>();
+        return empty;
+    }
+
+    std::shared_ptr<std::vector<T>> m_data;
+};
+
+} // namespace geometry
+} // namespace dc3d
@@ -790,90 +790,32 @@ glm::vec3 closestPointOnTriangle(const glm::vec3& point,
 
 // MeshAccelerator implementation
 MeshAccelerator::MeshAccelerator(const TriangleMesh& mesh) : m_mesh(mesh) {
-    buildBVH();
-}
-
-void MeshAccelerator::buildBVH() {
-    // Simple BVH construction
-    const auto& vertices = m_mesh.vertices();
-    const auto& indices = m_mesh.indices();
-    
-    // Check for empty mesh before processing
-    if (vertices.empty() || indices.empty()) {
-        return;  // Initialize with empty BVH
-    }
-    
-    int numTriangles = static_cast<int>(indices.size() / 3);
-    
-    // For now, create a single root node containing all triangles
-    BVHNode root;
-    root.boundsMin = glm::vec3(std::numeric_limits<float>::max());
-    root.boundsMax = glm::vec3(std::numeric_limits<float>::lowest());
-    root.leftChild = -1;
-    root.rightChild = -1;
-    
-    for (size_t i = 0; i < indices.size(); ++i) {
-        const glm::vec3& p = vertices[indices[i]];
-        root.boundsMin = glm::min(root.boundsMin, p);
-        root.boundsMax = glm::max(root.boundsMax, p);
-    }
-    
-    for (int i = 0; i < numTriangles; ++i) {
-        root.triangles.push_back(i);
-    }
-    
-    m_bvh.push_back(root);
-    
-    // Full implementation would recursively split nodes
+    m_bvh.build(m_mesh.meshData());
 }
 
 glm::vec3 MeshAccelerator::closestPoint(const glm::vec3& point) const {
-    // For now, use brute force (BVH traversal would be faster)
-    return closestPointOnMesh(point, m_mesh);
+    dc3d::geometry::BVHClosestPointResult closest = m_bvh.closestPoint(point);
+    return closest.found ? closest.point : point;
 }
 
 bool MeshAccelerator::rayIntersect(const glm::vec3& origin, const glm::vec3& direction,
                                     glm::vec3& hitPoint, float& hitDistance) const {
-    const auto& vertices = m_mesh.vertices();
-    const auto& indices = m_mesh.indices();
-    
     hitDistance = std::numeric_limits<float>::max();
-    bool hit = false;
     
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        const glm::vec3& v0 = vertices[indices[i]];
-        const glm::vec3& v1 = vertices[indices[i + 1]];
-        const glm::vec3& v2 = vertices[indices[i + 2]];
-        
-        // Möller–Trumbore
-        glm::vec3 edge1 = v1 - v0;
-        glm::vec3 edge2 = v2 - v0;
-        glm::vec3 h = glm::cross(direction, edge2);
-        float a = glm::dot(edge1, h);
-        
-        if (std::abs(a) < 1e-6f) continue;
-        
-        float f = 1.0f / a;
-        glm::vec3 s = origin - v0;
-        float u = f * glm::dot(s, h);
-        
-        if (u < 0.0f || u > 1.0f) continue;
-        
-        glm::vec3 q = glm::cross(s, edge1);
-        float v = f * glm::dot(direction, q);
-        
-        if (v < 0.0f || u + v > 1.0f) continue;
-        
-        float t = f * glm::dot(edge2, q);
-        
-        if (t > 0.0f && t < hitDistance) {
-            hitDistance = t;
-            hitPoint = origin + direction * t;
-            hit = true;
-        }
+    float dirLength = glm::length(direction);
+    if (dirLength < 1e-10f) {
+        return false;
     }
     
-    return hit;
+    dc3d::geometry::BVHHitResult hit = m_bvh.intersect(dc3d::geometry::Ray(origin, direction));
+    if (!hit.hit) {
+        return false;
+    }
+    
+    // Report distance in units of the caller's direction vector
+    hitDistance = hit.t / dirLength;
+    hitPoint = hit.point;
+    return true;
 }
 
 } // namespace WrapUtils
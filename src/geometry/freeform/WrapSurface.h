@@ -6,6 +6,7 @@
 #include <string>
 #include <glm/glm.hpp>
 #include "../NURBSSurface.h"
+#include "../BVH.h"
 
 namespace dc {
 
@@ -221,17 +222,7 @@ namespace WrapUtils {
         
     private:
         const TriangleMesh& m_mesh;
-        // BVH or octree data
-        struct BVHNode {
-            glm::vec3 boundsMin;
-            glm::vec3 boundsMax;
-            int leftChild;
-            int rightChild;
-            std::vector<int> triangles;
-        };
-        std::vector<BVHNode> m_bvh;
-        
-        void buildBVH();
+        dc3d::geometry::BVH m_bvh;  // Closest-point and ray acceleration
     };
 }
 
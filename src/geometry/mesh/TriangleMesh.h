@@ -53,19 +53,19 @@ public:
      * @brief Get vertices
      */
     const std::vector<glm::vec3>& vertices() const { return m_data.vertices(); }
-    std::vector<glm::vec3>& vertices() { return m_data.vertices(); }
+    std::vector<glm::vec3>& editVertices() { return m_data.editVertices(); }
     
     /**
      * @brief Get indices
      */
     const std::vector<uint32_t>& indices() const { return m_data.indices(); }
-    std::vector<uint32_t>& indices() { return m_data.indices(); }
+    std::vector<uint32_t>& editIndices() { return m_data.editIndices(); }
     
     /**
      * @brief Get normals
      */
     const std::vector<glm::vec3>& normals() const { return m_data.normals(); }
-    std::vector<glm::vec3>& normals() { return m_data.normals(); }
+    std::vector<glm::vec3>& editNormals() { return m_data.editNormals(); }
     
     /**
      * @brief Compute normals
@@ -264,20 +264,20 @@ MeshData SymmetryPlane::reflectMesh(const MeshData& mesh) const {
     
     // Copy and reflect vertices
     const auto& srcVerts = mesh.vertices();
-    reflected.vertices().reserve(srcVerts.size());
+    reflected.editVertices().reserve(srcVerts.size());
     
     for (const auto& v : srcVerts) {
-        reflected.vertices().push_back(reflectPoint(v));
+        reflected.editVertices().push_back(reflectPoint(v));
     }
     
     // Copy indices but reverse winding
     const auto& srcIndices = mesh.indices();
-    reflected.indices().reserve(srcIndices.size());
+    reflected.editIndices().reserve(srcIndices.size());
     
     for (size_t i = 0; i < srcIndices.size(); i += 3) {
-        reflected.indices().push_back(srcIndices[i]);
-        reflected.indices().push_back(srcIndices[i + 2]);  // Swap to reverse winding
-        reflected.indices().push_back(srcIndices[i + 1]);
+        reflected.editIndices().push_back(srcIndices[i]);
+        reflected.editIndices().push_back(srcIndices[i + 2]);  // Swap to reverse winding
+        reflected.editIndices().push_back(srcIndices[i + 1]);
     }
     
     // Compute new normals
@@ -481,14 +481,14 @@ MeshData Fillet::generatePreview(const Solid& solid,
         uint32_t baseIdx = static_cast<uint32_t>(preview.vertices().size());
         
         for (const auto& v : vertices) {
-            preview.vertices().push_back(v.position);
-            preview.normals().push_back(v.normal);
+            preview.editVertices().push_back(v.position);
+            preview.editNormals().push_back(v.normal);
         }
         vertices.clear();
         
         for (const auto& face : faces) {
             for (uint32_t vi : face.vertices) {
-                preview.indices().push_back(baseIdx + vi);
+                preview.editIndices().push_back(baseIdx + vi);
             }
         }
     }
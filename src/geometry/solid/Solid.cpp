@@ -613,34 +613,34 @@ MeshData Solid::toMesh() const {
     MeshData mesh;
     
     // Copy vertices
-    mesh.vertices().reserve(vertices_.size());
-    mesh.normals().reserve(vertices_.size());
+    mesh.editVertices().reserve(vertices_.size());
+    mesh.editNormals().reserve(vertices_.size());
     for (const auto& v : vertices_) {
-        mesh.vertices().push_back(v.position);
-        mesh.normals().push_back(v.normal);
+        mesh.editVertices().push_back(v.position);
+        mesh.editNormals().push_back(v.normal);
     }
     
     // Triangulate faces
     for (const auto& face : faces_) {
         if (face.vertices.size() == 3) {
-            mesh.indices().push_back(face.vertices[0]);
-            mesh.indices().push_back(face.vertices[1]);
-            mesh.indices().push_back(face.vertices[2]);
+            mesh.editIndices().push_back(face.vertices[0]);
+            mesh.editIndices().push_back(face.vertices[1]);
+            mesh.editIndices().push_back(face.vertices[2]);
         } else if (face.vertices.size() == 4) {
             // Quad -> 2 triangles
-            mesh.indices().push_back(face.vertices[0]);
-            mesh.indices().push_back(face.vertices[1]);
-            mesh.indices().push_back(face.vertices[2]);
+            mesh.editIndices().push_back(face.vertices[0]);
+            mesh.editIndices().push_back(face.vertices[1]);
+            mesh.editIndices().push_back(face.vertices[2]);
             
-            mesh.indices().push_back(face.vertices[0]);
-            mesh.indices().push_back(face.vertices[2]);
-            mesh.indices().push_back(face.vertices[3]);
+            mesh.editIndices().push_back(face.vertices[0]);
+            mesh.editIndices().push_back(face.vertices[2]);
+            mesh.editIndices().push_back(face.vertices[3]);
         } else {
             // Fan triangulation for n-gons
             for (size_t i = 1; i < face.vertices.size() - 1; ++i) {
-                mesh.indices().push_back(face.vertices[0]);
-                mesh.indices().push_back(face.vertices[i]);
-                mesh.indices().push_back(face.vertices[i + 1]);
+                mesh.editIndices().push_back(face.vertices[0]);
+                mesh.editIndices().push_back(face.vertices[i]);
+                mesh.editIndices().push_back(face.vertices[i + 1]);
             }
         }
     }
@@ -222,7 +222,7 @@ PlanarSurfaceResult PlanarSurface::createPlanar(const PlanarProfile& profile,
         
         // Offset back face
         for (size_t i = 0; i < backMesh.vertexCount(); ++i) {
-            backMesh.vertices()[i] -= result.normal * options.thickness;
+            backMesh.editVertices()[i] -= result.normal * options.thickness;
         }
         backMesh.flipNormals();
         
@@ -15,7 +15,8 @@ enum class ExportFormat {
     STL_ASCII,      // STL ASCII format
     STL_BINARY,     // STL binary format
     OBJ,            // Wavefront OBJ
-    NATIVE_DCA      // Native .dca format
+    NATIVE_DCA,     // Native .dca format
+    PLY             // Stanford PLY (binary)
 };
 
 /**
@@ -86,6 +87,10 @@ struct ExportOptions {
     bool stlBinary = true;              // Binary vs ASCII
     bool stlIncludeNormals = true;      // Include vertex normals
     
+    // OBJ/PLY-specific options
+    bool meshIncludeNormals = true;     // Write per-vertex normals when present
+    bool meshIncludeUVs = true;         // Write texture coordinates when present (OBJ)
+    
     // General options
     bool exportHiddenObjects = false;
     bool mergeCoplanarFaces = true;
@@ -184,6 +189,8 @@ struct ExportOptions {
                 return ".obj";
             case ExportFormat::NATIVE_DCA:
                 return ".dca";
+            case ExportFormat::PLY:
+                return ".ply";
             default:
                 return "";
         }
@@ -201,6 +208,7 @@ struct ExportOptions {
             case ExportFormat::STL_BINARY: return "STL (Binary)";
             case ExportFormat::OBJ: return "OBJ";
             case ExportFormat::NATIVE_DCA: return "DC Design (*.dca)";
+            case ExportFormat::PLY: return "PLY";
             default: return "Unknown";
         }
     }
@@ -1,14 +1,42 @@
 #include "IGESImporter.h"
-#include <fstream>
-#include <sstream>
+#include "TextTokenizer.h"
+#include "../core/TaskScheduler.h"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
 #include <cmath>
 #include <cctype>
 #include <cstdint>
+#include <cstring>
+#include <system_error>
 
 namespace {
 // LOW FIX: Define PI constant instead of relying on non-standard M_PI
 constexpr double PI = 3.14159265358979323846;
+
+// Records are indexed in chunks of about this size, one task each
+constexpr size_t RECORD_CHUNK_BYTES = 4 << 20;
+
+// Fixed-width columns of a record (clipped to short lines)
+std::string_view column(std::string_view record, size_t start, size_t width)
+{
+    if (start >= record.size()) return std::string_view();
+    return record.substr(start, width);
+}
+
+std::string_view trimBlanks(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+std::string_view trimTrailingBlanks(std::string_view text)
+{
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
 } // anonymous namespace
 
 namespace dc {
@@ -72,23 +100,19 @@ IGESImporter::~IGESImporter()
 std::shared_ptr<Model> IGESImporter::importFile(const std::string& filename, const ImportOptions& options)
 {
     m_options = options;
-    m_directoryEntries.clear();
-    m_parameterEntries.clear();
-    m_points.clear();
-    m_curves.clear();
-    m_surfaces.clear();
-    m_transformations.clear();
-    m_colors.clear();
+    releaseTables();
     m_errorMessage.clear();
     m_stats = ImportStats();
     
     // Parse file
     if (!parseFile(filename)) {
+        releaseTables();
         return nullptr;
     }
     
     // Process entities
     if (!processEntities()) {
+        releaseTables();
         return nullptr;
     }
     
@@ -100,14 +124,16 @@ std::shared_ptr<Model> IGESImporter::importFile(const std::string& filename, con
     auto body = std::make_shared<Body>();
     body->name = "Imported Geometry";
     
-    for (auto& [id, surface] : m_surfaces) {
+    for (size_t i = 0; i < m_surfaces.size(); i++) {
+        if (!m_surfaces[i]) continue;
+        
         auto face = std::make_shared<Face>();
-        face->surface = surface;
+        face->surface = m_surfaces[i];
         
-        // Apply color if available
-        auto& dirEntry = m_directoryEntries[(id - 1) / 2];
-        if (dirEntry.colorNumber > 0) {
-            auto colorIt = m_colors.find(dirEntry.colorNumber);
+        // Apply color if available (negative color numbers point to a color definition)
+        const auto& dirEntry = m_directoryEntries[i];
+        if (dirEntry.colorNumber < 0) {
+            auto colorIt = m_colors.find(-dirEntry.colorNumber);
             if (colorIt != m_colors.end()) {
                 face->color = colorIt->second;
             }
@@ -120,78 +146,114 @@ std::shared_ptr<Model> IGESImporter::importFile(const std::string& filename, con
         model->bodies.push_back(body);
     }
     
+    // Parameters point into the mapping; the model owns everything it needs
+    releaseTables();
     return model;
 }
 
+void IGESImporter::releaseTables()
+{
+    m_directoryEntries = {};
+    m_parameterEntries = {};
+    m_parameterText = {};
+    m_points = {};
+    m_curves = {};
+    m_surfaces = {};
+    m_transformations.clear();
+    m_colors.clear();
+    m_file.close();
+}
+
 bool IGESImporter::parseFile(const std::string& filename)
 {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        m_errorMessage = "Failed to open file: " + filename;
+    std::string error;
+    if (!m_file.open(filename, &error)) {
+        m_errorMessage = "Failed to open file: " + filename + "\n" + error;
         return false;
     }
     
-    std::vector<std::string> startLines, globalLines, directoryLines, parameterLines;
-    std::string line;
-    
-    while (std::getline(file, line)) {
-        if (line.length() < 73) {
-            line.resize(80, ' ');
+    // Index the records of each section in parallel chunks of whole lines;
+    // the section letter is in column 73
+    const char* begin = m_file.data();
+    const char* end = begin + m_file.size();
+    auto bounds = dc3d::io::TextTokenizer::splitLines(begin, end, RECORD_CHUNK_BYTES);
+    const size_t chunkCount = bounds.size() - 1;
+    
+    enum Section { START, GLOBAL, DIRECTORY, PARAMETER, SECTION_COUNT };
+    std::vector<std::array<std::vector<std::string_view>, SECTION_COUNT>> chunks(chunkCount);
+    
+    dc3d::core::parallelFor(0, chunkCount, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t c = chunkBegin; c < chunkEnd; c++) {
+            const char* pos = bounds[c];
+            const char* stop = bounds[c + 1];
+            auto& sections = chunks[c];
+            while (pos < stop) {
+                const void* newline = std::memchr(pos, '\n', static_cast<size_t>(stop - pos));
+                const char* lineEnd = newline ? static_cast<const char*>(newline) : stop;
+                std::string_view record(pos, static_cast<size_t>(lineEnd - pos));
+                if (!record.empty() && record.back() == '\r') record.remove_suffix(1);
+                pos = newline ? lineEnd + 1 : stop;
+                
+                if (record.size() < 73) continue;
+                switch (record[72]) {
+                    case 'S': sections[START].push_back(record); break;
+                    case 'G': sections[GLOBAL].push_back(record); break;
+                    case 'D': sections[DIRECTORY].push_back(record); break;
+                    case 'P': sections[PARAMETER].push_back(record); break;
+                    default: break;  // Terminate section
+                }
+            }
         }
-        
-        char section = line[72];
-        
-        switch (section) {
-            case 'S':
-                startLines.push_back(line.substr(0, 72));
-                break;
-            case 'G':
-                globalLines.push_back(line.substr(0, 72));
-                break;
-            case 'D':
-                directoryLines.push_back(line.substr(0, 72));
-                break;
-            case 'P':
-                parameterLines.push_back(line.substr(0, 72));
-                break;
-            case 'T':
-                // Terminate section - stop reading
-                break;
+    }, 1);
+    
+    std::array<std::vector<std::string_view>, SECTION_COUNT> records;
+    for (size_t section = 0; section < SECTION_COUNT; section++) {
+        size_t total = 0;
+        for (const auto& chunk : chunks) total += chunk[section].size();
+        records[section].reserve(total);
+        for (auto& chunk : chunks) {
+            records[section].insert(records[section].end(), chunk[section].begin(), chunk[section].end());
+            chunk[section] = {};
         }
     }
     
-    file.close();
-    
     // Parse each section
-    if (!parseStartSection(startLines)) return false;
-    if (!parseGlobalSection(globalLines)) return false;
-    if (!parseDirectorySection(directoryLines)) return false;
-    if (!parseParameterSection(parameterLines)) return false;
+    if (!parseStartSection(records[START])) return false;
+    if (!parseGlobalSection(records[GLOBAL])) return false;
+    if (!parseDirectorySection(records[DIRECTORY])) return false;
+    if (!parseParameterSection(records[PARAMETER])) return false;
     
     return true;
 }
 
-bool IGESImporter::parseStartSection(const std::vector<std::string>& lines)
+bool IGESImporter::parseStartSection(const std::vector<std::string_view>& records)
 {
     m_startSection.clear();
-    for (const auto& line : lines) {
-        m_startSection += line;
+    for (const auto& record : records) {
+        m_startSection += column(record, 0, 72);
     }
     return true;
 }
 
-bool IGESImporter::parseGlobalSection(const std::vector<std::string>& lines)
+bool IGESImporter::parseGlobalSection(const std::vector<std::string_view>& records)
 {
     m_globalSection.clear();
-    for (const auto& line : lines) {
-        m_globalSection += line;
+    for (const auto& record : records) {
+        m_globalSection += column(record, 0, 72);
     }
     
-    // Parse global parameters
-    auto params = parseParameterData(m_globalSection);
+    // Parse global parameters (delimiters may be redefined by the first two)
+    m_paramDelimiter = ',';
+    m_recordDelimiter = ';';
+    std::vector<std::string_view> params;
+    parseParameterData(m_globalSection, params);
     
-    if (params.size() > 0) m_paramDelimiter = params[0].empty() ? ',' : params[0][0];
-    if (params.size() > 1) m_recordDelimiter = params[1].empty() ? ';' : params[1][0];
+    auto delimiter = [](std::string_view param, char fallback) {
+        std::string text = parseHollerith(param);
+        return text.empty() ? fallback : text[0];
+    };
+    if (params.size() > 0) m_paramDelimiter = delimiter(params[0], ',');
+    if (params.size() > 1) m_recordDelimiter = delimiter(params[1], ';');
     if (params.size() > 2) m_productId = parseHollerith(params[2]);
     if (params.size() > 3) m_fileName = parseHollerith(params[3]);
     if (params.size() > 12) m_modelScale = parseReal(params[12]);
@@ -201,193 +263,273 @@ bool IGESImporter::parseGlobalSection(const std::vector<std::string>& lines)
     return true;
 }
 
-bool IGESImporter::parseDirectorySection(const std::vector<std::string>& lines)
+bool IGESImporter::parseDirectorySection(const std::vector<std::string_view>& records)
 {
-    // Directory entries come in pairs of lines
-    for (size_t i = 0; i + 1 < lines.size(); i += 2) {
-        IGESDirectoryEntry entry;
-        
-        // First line
-        std::string line1 = lines[i];
-        entry.entityType = parseInt(line1.substr(0, 8));
-        entry.parameterData = parseInt(line1.substr(8, 8));
-        entry.structure = parseInt(line1.substr(16, 8));
-        entry.lineFontPattern = parseInt(line1.substr(24, 8));
-        entry.level = parseInt(line1.substr(32, 8));
-        entry.view = parseInt(line1.substr(40, 8));
-        entry.transformationMatrix = parseInt(line1.substr(48, 8));
-        entry.labelDisplayAssoc = parseInt(line1.substr(56, 8));
-        entry.statusNumber = parseInt(line1.substr(64, 8));
-        
-        // Second line
-        std::string line2 = lines[i + 1];
-        entry.lineWeight = parseInt(line2.substr(8, 8));
-        entry.colorNumber = parseInt(line2.substr(16, 8));
-        entry.parameterLineCount = parseInt(line2.substr(24, 8));
-        entry.formNumber = parseInt(line2.substr(32, 8));
-        entry.entityLabel = line2.substr(56, 8);
-        entry.entitySubscript = line2.substr(64, 8);
-        
-        // Trim whitespace from label
-        entry.entityLabel.erase(entry.entityLabel.find_last_not_of(" \t") + 1);
-        
-        entry.sequenceNumber = (i / 2) + 1;
-        
-        m_directoryEntries.push_back(entry);
-        m_stats.totalEntities++;
-    }
+    // Directory entries come in pairs of records; each pair is independent
+    const size_t count = records.size() / 2;
+    m_directoryEntries.resize(count);
+    
+    dc3d::core::parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            IGESDirectoryEntry& entry = m_directoryEntries[i];
+            
+            // First line
+            std::string_view line1 = records[2 * i];
+            entry.entityType = parseInt(column(line1, 0, 8));
+            entry.parameterData = parseInt(column(line1, 8, 8));
+            entry.structure = parseInt(column(line1, 16, 8));
+            entry.lineFontPattern = parseInt(column(line1, 24, 8));
+            entry.level = parseInt(column(line1, 32, 8));
+            entry.view = parseInt(column(line1, 40, 8));
+            entry.transformationMatrix = parseInt(column(line1, 48, 8));
+            entry.labelDisplayAssoc = parseInt(column(line1, 56, 8));
+            entry.statusNumber = parseInt(column(line1, 64, 8));
+            
+            // Second line
+            std::string_view line2 = records[2 * i + 1];
+            entry.lineWeight = parseInt(column(line2, 8, 8));
+            entry.colorNumber = parseInt(column(line2, 16, 8));
+            entry.parameterLineCount = parseInt(column(line2, 24, 8));
+            entry.formNumber = parseInt(column(line2, 32, 8));
+            entry.entityLabel = std::string(trimTrailingBlanks(column(line2, 56, 8)));
+            entry.entitySubscript = std::string(column(line2, 64, 8));
+            
+            entry.sequenceNumber = static_cast<int>(i + 1);
+        }
+    });
     
+    m_stats.totalEntities = static_cast<int>(count);
     return true;
 }
 
-bool IGESImporter::parseParameterSection(const std::vector<std::string>& lines)
+bool IGESImporter::parseParameterSection(const std::vector<std::string_view>& records)
 {
-    // Combine parameter lines for each entity
-    std::map<int, std::string> paramData;  // Directory entry -> accumulated parameter data
+    // Each entity's parameter lines are a run of records tagged with its
+    // directory entry number in columns 65-72
+    struct Run {
+        size_t first = 0;
+        size_t count = 0;
+    };
+    const size_t count = m_directoryEntries.size();
+    std::vector<Run> runs(count);
+    bool scattered = false;
     
-    for (const auto& line : lines) {
-        if (line.length() < 72) continue;
-        
-        std::string data = line.substr(0, 64);
-        int dirEntryNum = parseInt(line.substr(64, 8));
-        
-        // Remove trailing spaces
-        data.erase(data.find_last_not_of(" \t") + 1);
+    for (size_t line = 0; line < records.size(); line++) {
+        int index = entityIndex(parseInt(column(records[line], 64, 8)));
+        if (index < 0) continue;
         
-        paramData[dirEntryNum] += data;
+        Run& run = runs[static_cast<size_t>(index)];
+        if (run.count == 0) {
+            run.first = line;
+            run.count = 1;
+        } else if (run.first + run.count == line) {
+            run.count++;
+        } else {
+            scattered = true;
+        }
+    }
+    if (scattered) {
+        addWarning("Parameter lines of some entities are not contiguous; extra lines were ignored");
     }
     
-    // Parse each entity's parameter data
-    for (auto& [dirNum, data] : paramData) {
-        IGESParameterEntry entry;
-        entry.directoryEntry = dirNum;
-        
-        // First parameter is entity type
-        auto params = parseParameterData(data);
-        if (!params.empty()) {
-            entry.entityType = parseInt(params[0]);
-            entry.parameters = std::vector<std::string>(params.begin() + 1, params.end());
+    // Split each entity's parameters concurrently. m_parameterText is
+    // filled in place and never resized, so views into it stay valid.
+    m_parameterEntries.assign(count, IGESParameterEntry());
+    m_parameterText.assign(count, std::string());
+    
+    dc3d::core::parallelFor(0, count, [&](size_t begin, size_t end) {
+        std::vector<std::string_view> params;
+        for (size_t i = begin; i < end; i++) {
+            const Run& run = runs[i];
+            if (run.count == 0) continue;
+            
+            // Data is in columns 1-64; single-line entities are read in place
+            std::string_view data;
+            if (run.count == 1) {
+                data = trimTrailingBlanks(column(records[run.first], 0, 64));
+            } else {
+                std::string& text = m_parameterText[i];
+                for (size_t line = run.first; line < run.first + run.count; line++) {
+                    text += trimTrailingBlanks(column(records[line], 0, 64));
+                }
+                data = text;
+            }
+            
+            IGESParameterEntry& entry = m_parameterEntries[i];
+            entry.directoryEntry = static_cast<int>(2 * i + 1);
+            
+            // First parameter is entity type
+            params.clear();
+            parseParameterData(data, params);
+            if (!params.empty()) {
+                entry.entityType = parseInt(params[0]);
+                entry.parameters.assign(params.begin() + 1, params.end());
+            }
         }
-        
-        m_parameterEntries[dirNum] = entry;
-    }
+    });
     
     return true;
 }
 
-std::vector<std::string> IGESImporter::parseParameterData(const std::string& data)
+void IGESImporter::parseParameterData(std::string_view data, std::vector<std::string_view>& params) const
 {
-    std::vector<std::string> params;
-    std::string current;
-    bool inHollerith = false;
-    int hollerithCount = 0;
+    size_t start = 0;           // Start of the current parameter
+    bool started = false;       // Leading blanks are not part of a parameter
+    bool allDigits = true;
     
     for (size_t i = 0; i < data.length(); i++) {
         char c = data[i];
         
-        if (inHollerith) {
-            current += c;
-            hollerithCount--;
-            if (hollerithCount <= 0) {
-                inHollerith = false;
-            }
-        }
-        else if (std::isdigit(c) && current.empty()) {
-            // Possible Hollerith string start
-            current += c;
+        if (!started) {
+            if (c == ' ') continue;
+            start = i;
+            started = true;
+            allDigits = true;
         }
-        else if (c == 'H' && !current.empty() && std::all_of(current.begin(), current.end(), ::isdigit)) {
-            // Hollerith string
-            hollerithCount = std::stoi(current);
+        
+        if (c == 'H' && allDigits && i > start) {
+            // Hollerith string: nHxxx... holds n characters (delimiters included)
+            size_t hollerithCount = 0;
+            std::from_chars(data.data() + start, data.data() + i, hollerithCount);
             // HIGH FIX: Validate Hollerith count to prevent buffer over-read
-            if (hollerithCount < 0 || i + static_cast<size_t>(hollerithCount) >= data.length()) {
-                // Malformed Hollerith string - treat as regular token and continue
-                current += c;
+            if (i + hollerithCount < data.length()) {
+                i += hollerithCount;
+                allDigits = false;
                 continue;
             }
-            current = std::to_string(hollerithCount) + "H";
-            inHollerith = true;
+            // Malformed Hollerith string - treat as regular token and continue
         }
-        else if (c == m_paramDelimiter || c == m_recordDelimiter) {
-            params.push_back(current);
-            current.clear();
-            if (c == m_recordDelimiter) break;
+        
+        if (c == m_paramDelimiter || c == m_recordDelimiter) {
+            params.push_back(started ? data.substr(start, i - start) : std::string_view());
+            started = false;
+            if (c == m_recordDelimiter) return;
+            continue;
         }
-        else if (c != ' ' || !current.empty()) {
-            current += c;
+        
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            allDigits = false;
         }
     }
     
-    if (!current.empty()) {
-        params.push_back(current);
+    if (started) {
+        params.push_back(data.substr(start));
     }
-    
-    return params;
+}
+
+int IGESImporter::entityIndex(int directoryEntry) const
+{
+    if (directoryEntry <= 0 || directoryEntry % 2 == 0) return -1;
+    size_t index = static_cast<size_t>(directoryEntry - 1) / 2;
+    return index < m_directoryEntries.size() ? static_cast<int>(index) : -1;
+}
+
+const IGESParameterEntry* IGESImporter::parameterEntry(int directoryEntry) const
+{
+    int index = entityIndex(directoryEntry);
+    if (index < 0 || static_cast<size_t>(index) >= m_parameterEntries.size()) return nullptr;
+    const IGESParameterEntry& entry = m_parameterEntries[static_cast<size_t>(index)];
+    return entry.directoryEntry != 0 ? &entry : nullptr;
+}
+
+std::shared_ptr<NURBSCurve> IGESImporter::curveAt(int directoryEntry) const
+{
+    int index = entityIndex(directoryEntry);
+    if (index < 0 || static_cast<size_t>(index) >= m_curves.size()) return nullptr;
+    return m_curves[static_cast<size_t>(index)];
+}
+
+std::shared_ptr<NURBSSurface> IGESImporter::surfaceAt(int directoryEntry) const
+{
+    int index = entityIndex(directoryEntry);
+    if (index < 0 || static_cast<size_t>(index) >= m_surfaces.size()) return nullptr;
+    return m_surfaces[static_cast<size_t>(index)];
 }
 
 bool IGESImporter::processEntities()
 {
-    double unitScale = getUnitScale();
-    
-    for (const auto& entry : m_directoryEntries) {
-        int dirNum = entry.sequenceNumber * 2 - 1;  // Directory entry number (odd)
-        
-        auto paramIt = m_parameterEntries.find(dirNum);
-        if (paramIt == m_parameterEntries.end()) continue;
+    const size_t count = m_directoryEntries.size();
+    m_points.assign(count, glm::dvec3(0));
+    m_curves.assign(count, nullptr);
+    m_surfaces.assign(count, nullptr);
+    
+    // First pass: entities defined only by their own parameters, in parallel
+    std::atomic<int> points{0}, curves{0}, surfaces{0};
+    dc3d::core::parallelFor(0, count, [&](size_t begin, size_t end) {
+        int chunkPoints = 0, chunkCurves = 0, chunkSurfaces = 0;
+        for (size_t i = begin; i < end; i++) {
+            if (m_parameterEntries[i].directoryEntry == 0) continue;
+            int dirNum = static_cast<int>(2 * i + 1);  // Directory entry number (odd)
+            
+            switch (m_directoryEntries[i].entityType) {
+                case 116:  // Point
+                    m_points[i] = getPoint(dirNum);
+                    chunkPoints++;
+                    break;
+                    
+                case 110:  // Line
+                    m_curves[i] = getLine(dirNum);
+                    chunkCurves++;
+                    break;
+                    
+                case 100:  // Circular Arc
+                    m_curves[i] = getCircularArc(dirNum);
+                    chunkCurves++;
+                    break;
+                    
+                case 126:  // Rational B-Spline Curve
+                    m_curves[i] = getRationalBSplineCurve(dirNum);
+                    chunkCurves++;
+                    break;
+                    
+                case 108:  // Plane
+                    m_surfaces[i] = getPlane(dirNum);
+                    chunkSurfaces++;
+                    break;
+                    
+                case 128:  // Rational B-Spline Surface
+                    m_surfaces[i] = getRationalBSplineSurface(dirNum);
+                    chunkSurfaces++;
+                    break;
+            }
+        }
+        points += chunkPoints;
+        curves += chunkCurves;
+        surfaces += chunkSurfaces;
+    });
+    m_stats.pointsImported = points;
+    m_stats.curvesImported = curves;
+    m_stats.surfacesImported = surfaces;
+    
+    // Second pass: entities built from other entities, in directory order
+    // so that they may also reference earlier entities of this pass
+    for (size_t i = 0; i < count; i++) {
+        if (m_parameterEntries[i].directoryEntry == 0) continue;
+        int dirNum = static_cast<int>(2 * i + 1);
         
-        switch (entry.entityType) {
-            case 116:  // Point
-                m_points[dirNum] = getPoint(dirNum);
-                m_stats.pointsImported++;
-                break;
-                
-            case 110:  // Line
-                m_curves[dirNum] = getLine(dirNum);
-                m_stats.curvesImported++;
-                break;
-                
-            case 100:  // Circular Arc
-                m_curves[dirNum] = getCircularArc(dirNum);
-                m_stats.curvesImported++;
-                break;
-                
-            case 126:  // Rational B-Spline Curve
-                m_curves[dirNum] = getRationalBSplineCurve(dirNum);
-                m_stats.curvesImported++;
-                break;
-                
+        switch (m_directoryEntries[i].entityType) {
             case 102:  // Composite Curve
-                m_curves[dirNum] = getCompositeCurve(dirNum);
+                m_curves[i] = getCompositeCurve(dirNum);
                 m_stats.curvesImported++;
                 break;
                 
-            case 108:  // Plane
-                m_surfaces[dirNum] = getPlane(dirNum);
-                m_stats.surfacesImported++;
-                break;
-                
             case 118:  // Ruled Surface
-                m_surfaces[dirNum] = getRuledSurface(dirNum);
+                m_surfaces[i] = getRuledSurface(dirNum);
                 m_stats.surfacesImported++;
                 break;
                 
             case 120:  // Surface of Revolution
-                m_surfaces[dirNum] = getSurfaceOfRevolution(dirNum);
+                m_surfaces[i] = getSurfaceOfRevolution(dirNum);
                 m_stats.surfacesImported++;
                 break;
                 
             case 122:  // Tabulated Cylinder
-                m_surfaces[dirNum] = getTabulatedCylinder(dirNum);
-                m_stats.surfacesImported++;
-                break;
-                
-            case 128:  // Rational B-Spline Surface
-                m_surfaces[dirNum] = getRationalBSplineSurface(dirNum);
+                m_surfaces[i] = getTabulatedCylinder(dirNum);
                 m_stats.surfacesImported++;
                 break;
                 
             case 144:  // Trimmed Parametric Surface
-                m_surfaces[dirNum] = getTrimmedSurface(dirNum);
+                m_surfaces[i] = getTrimmedSurface(dirNum);
                 m_stats.surfacesImported++;
                 break;
                 
@@ -406,12 +548,12 @@ bool IGESImporter::processEntities()
 
 glm::dvec3 IGESImporter::getPoint(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 3) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 3) {
         return glm::dvec3(0);
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     double scale = getUnitScale();
     
     return glm::dvec3(
@@ -423,12 +565,12 @@ glm::dvec3 IGESImporter::getPoint(int directoryEntry)
 
 std::shared_ptr<NURBSCurve> IGESImporter::getLine(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 6) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 6) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     double scale = getUnitScale();
     
     auto curve = std::make_shared<NURBSCurve>();
@@ -453,12 +595,12 @@ std::shared_ptr<NURBSCurve> IGESImporter::getLine(int directoryEntry)
 
 std::shared_ptr<NURBSCurve> IGESImporter::getCircularArc(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 6) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 6) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     double scale = getUnitScale();
     
     double zt = parseReal(params[0]) * scale;  // Z displacement
@@ -505,12 +647,12 @@ std::shared_ptr<NURBSCurve> IGESImporter::getCircularArc(int directoryEntry)
 
 std::shared_ptr<NURBSCurve> IGESImporter::getCompositeCurve(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.empty()) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.empty()) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     int numCurves = parseInt(params[0]);
     
     // Combine all referenced curves
@@ -520,11 +662,11 @@ std::shared_ptr<NURBSCurve> IGESImporter::getCompositeCurve(int directoryEntry)
     for (int i = 1; i <= numCurves && i < (int)params.size(); i++) {
         int curveRef = parseInt(params[i]);
         
-        // Find curve in our map
-        auto curveIt = m_curves.find(curveRef);
-        if (curveIt != m_curves.end() && curveIt->second) {
+        // Find the referenced curve
+        auto curve = curveAt(curveRef);
+        if (curve) {
             // Append control points
-            for (const auto& cp : curveIt->second->controlPoints) {
+            for (const auto& cp : curve->controlPoints) {
                 composite->controlPoints.push_back(cp);
             }
         }
@@ -535,12 +677,12 @@ std::shared_ptr<NURBSCurve> IGESImporter::getCompositeCurve(int directoryEntry)
 
 std::shared_ptr<NURBSCurve> IGESImporter::getRationalBSplineCurve(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 7) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 7) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     double scale = getUnitScale();
     
     int K = parseInt(params[0]);   // Upper index of sum
@@ -586,12 +728,12 @@ std::shared_ptr<NURBSCurve> IGESImporter::getRationalBSplineCurve(int directoryE
 
 std::shared_ptr<NURBSSurface> IGESImporter::getPlane(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 4) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 4) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     double scale = getUnitScale();
     
     // Form 0: A*X + B*Y + C*Z = D
@@ -627,12 +769,12 @@ std::shared_ptr<NURBSSurface> IGESImporter::getPlane(int directoryEntry)
 
 std::shared_ptr<NURBSSurface> IGESImporter::getRuledSurface(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 3) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 3) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     
     int curve1Ref = parseInt(params[0]);
     int curve2Ref = parseInt(params[1]);
@@ -640,19 +782,13 @@ std::shared_ptr<NURBSSurface> IGESImporter::getRuledSurface(int directoryEntry)
     int devFlag = params.size() > 3 ? parseInt(params[3]) : 0;
     
     // Get the two generator curves
-    std::shared_ptr<NURBSCurve> curve1, curve2;
-    
-    auto it1 = m_curves.find(curve1Ref);
-    auto it2 = m_curves.find(curve2Ref);
+    std::shared_ptr<NURBSCurve> curve1 = curveAt(curve1Ref);
+    std::shared_ptr<NURBSCurve> curve2 = curveAt(curve2Ref);
     
-    if (it1 == m_curves.end() || it2 == m_curves.end() ||
-        !it1->second || !it2->second) {
+    if (!curve1 || !curve2) {
         return nullptr;
     }
     
-    curve1 = it1->second;
-    curve2 = it2->second;
-    
     // Create ruled surface
     auto surface = std::make_shared<NURBSSurface>();
     surface->degreeU = std::max(curve1->degree, curve2->degree);
@@ -680,12 +816,12 @@ std::shared_ptr<NURBSSurface> IGESImporter::getRuledSurface(int directoryEntry)
 
 std::shared_ptr<NURBSSurface> IGESImporter::getSurfaceOfRevolution(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 4) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 4) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     
     int lineRef = parseInt(params[0]);     // Axis line
     int curveRef = parseInt(params[1]);    // Generatrix curve
@@ -693,13 +829,11 @@ std::shared_ptr<NURBSSurface> IGESImporter::getSurfaceOfRevolution(int directory
     double endAngle = parseReal(params[3]);
     
     // Get generatrix curve
-    auto curveIt = m_curves.find(curveRef);
-    if (curveIt == m_curves.end() || !curveIt->second) {
+    auto curve = curveAt(curveRef);
+    if (!curve) {
         return nullptr;
     }
     
-    auto curve = curveIt->second;
-    
     // Get axis (assume Z-axis for simplicity)
     glm::dvec3 axisPoint(0, 0, 0);
     glm::dvec3 axisDir(0, 0, 1);
@@ -765,12 +899,12 @@ std::shared_ptr<NURBSSurface> IGESImporter::getSurfaceOfRevolution(int directory
 
 std::shared_ptr<NURBSSurface> IGESImporter::getTabulatedCylinder(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 4) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 4) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     double scale = getUnitScale();
     
     int curveRef = parseInt(params[0]);
@@ -780,13 +914,11 @@ std::shared_ptr<NURBSSurface> IGESImporter::getTabulatedCylinder(int directoryEn
     
     glm::dvec3 direction(lx, ly, lz);
     
-    auto curveIt = m_curves.find(curveRef);
-    if (curveIt == m_curves.end() || !curveIt->second) {
+    auto curve = curveAt(curveRef);
+    if (!curve) {
         return nullptr;
     }
     
-    auto curve = curveIt->second;
-    
     auto surface = std::make_shared<NURBSSurface>();
     surface->degreeU = curve->degree;
     surface->degreeV = 1;
@@ -804,12 +936,12 @@ std::shared_ptr<NURBSSurface> IGESImporter::getTabulatedCylinder(int directoryEn
 
 std::shared_ptr<NURBSSurface> IGESImporter::getRationalBSplineSurface(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 10) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 10) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     double scale = getUnitScale();
     
     int K1 = parseInt(params[0]);    // Upper index U
@@ -873,22 +1005,22 @@ std::shared_ptr<NURBSSurface> IGESImporter::getRationalBSplineSurface(int direct
 
 std::shared_ptr<NURBSSurface> IGESImporter::getTrimmedSurface(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 3) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 3) {
         return nullptr;
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     
     int surfaceRef = parseInt(params[0]);
     int n1 = parseInt(params[1]);  // Outer boundary flag
     int n2 = parseInt(params[2]);  // Number of inner boundaries
     
     // Get the base surface
-    auto surfIt = m_surfaces.find(surfaceRef);
-    if (surfIt != m_surfaces.end()) {
+    auto base = surfaceAt(surfaceRef);
+    if (base) {
         // Return copy of base surface (trimming handled separately)
-        auto trimmed = std::make_shared<NURBSSurface>(*surfIt->second);
+        auto trimmed = std::make_shared<NURBSSurface>(*base);
         return trimmed;
     }
     
@@ -897,12 +1029,12 @@ std::shared_ptr<NURBSSurface> IGESImporter::getTrimmedSurface(int directoryEntry
 
 glm::dmat4 IGESImporter::getTransformationMatrix(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 12) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 12) {
         return glm::dmat4(1.0);
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     double scale = getUnitScale();
     
     // IGES transformation matrix: R11, R12, R13, T1, R21, R22, R23, T2, R31, R32, R33, T3
@@ -928,12 +1060,12 @@ glm::dmat4 IGESImporter::getTransformationMatrix(int directoryEntry)
 
 glm::vec3 IGESImporter::getColorDefinition(int directoryEntry)
 {
-    auto paramIt = m_parameterEntries.find(directoryEntry);
-    if (paramIt == m_parameterEntries.end() || paramIt->second.parameters.size() < 3) {
+    const IGESParameterEntry* entry = parameterEntry(directoryEntry);
+    if (!entry || entry->parameters.size() < 3) {
         return glm::vec3(0.7f);
     }
     
-    auto& params = paramIt->second.parameters;
+    const auto& params = entry->parameters;
     
     // Colors are 0-100 range
     return glm::vec3(
@@ -943,48 +1075,51 @@ glm::vec3 IGESImporter::getColorDefinition(int directoryEntry)
     );
 }
 
-double IGESImporter::parseReal(const std::string& str)
+double IGESImporter::parseReal(std::string_view str)
 {
-    std::string s = str;
-    
-    // Remove leading/trailing whitespace
-    s.erase(0, s.find_first_not_of(" \t"));
-    s.erase(s.find_last_not_of(" \t") + 1);
-    
-    // Handle IGES D exponent notation
-    std::replace(s.begin(), s.end(), 'D', 'E');
-    std::replace(s.begin(), s.end(), 'd', 'e');
-    
-    try {
-        return std::stod(s);
-    } catch (...) {
-        return 0.0;
+    str = trimBlanks(str);
+    if (!str.empty() && str.front() == '+') str.remove_prefix(1);
+    
+    // Handle IGES D exponent notation (copied to a small buffer; longer
+    // fields are not valid numbers)
+    char buffer[64];
+    if (str.empty() || str.size() > sizeof(buffer)) return 0.0;
+    for (size_t i = 0; i < str.size(); i++) {
+        buffer[i] = (str[i] == 'D' || str[i] == 'd') ? 'E' : str[i];
     }
+    
+    // Shared with the other importers, including the fallback for
+    // standard libraries without floating-point from_chars
+    double value = 0.0;
+    const std::string_view text(buffer, str.size());
+    return dc3d::io::TextTokenizer::parseNumber(text, value) ? value : 0.0;
 }
 
-int IGESImporter::parseInt(const std::string& str)
+int IGESImporter::parseInt(std::string_view str)
 {
-    std::string s = str;
-    s.erase(0, s.find_first_not_of(" \t"));
-    s.erase(s.find_last_not_of(" \t") + 1);
+    str = trimBlanks(str);
+    if (!str.empty() && str.front() == '+') str.remove_prefix(1);
     
-    try {
-        return std::stoi(s);
-    } catch (...) {
-        return 0;
-    }
+    int value = 0;
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+    return result.ec == std::errc() ? value : 0;
 }
 
-std::string IGESImporter::parseHollerith(const std::string& str)
+std::string IGESImporter::parseHollerith(std::string_view str)
 {
     // Format: nHstring where n is string length
+    str = trimBlanks(str);
     size_t hPos = str.find('H');
-    if (hPos == std::string::npos) {
-        return str;
+    if (hPos == std::string_view::npos || hPos == 0) {
+        return std::string(str);
     }
     
-    int length = std::stoi(str.substr(0, hPos));
-    return str.substr(hPos + 1, length);
+    size_t length = 0;
+    auto result = std::from_chars(str.data(), str.data() + hPos, length);
+    if (result.ec != std::errc() || result.ptr != str.data() + hPos) {
+        return std::string(str);
+    }
+    return std::string(str.substr(hPos + 1, length));
 }
 
 double IGESImporter::getUnitScale() const
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "ExportOptions.h"
+#include "MappedFile.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <map>
@@ -41,16 +43,26 @@ struct IGESDirectoryEntry {
 
 /**
  * Parsed IGES parameter entry
+ * Parameters are views into the mapped file (or, for entities spanning
+ * several lines, into the importer's joined copy) and are only valid
+ * during the import. Hollerith strings keep their "nH" prefix.
  */
 struct IGESParameterEntry {
-    int entityType;
-    std::vector<std::string> parameters;
-    int directoryEntry;
+    int entityType = 0;
+    std::vector<std::string_view> parameters;
+    int directoryEntry = 0;     // 0 = entity has no parameter data
 };
 
 /**
  * IGES file importer
  * Imports IGES format files
+ *
+ * The file is memory-mapped and its 80-column records are indexed in
+ * parallel chunks. Directory entries (two records each) and the parameter
+ * data of each entity are then decoded concurrently, as are all entities
+ * that depend only on their own parameters. Entities built from other
+ * entities (composite curves, ruled, swept and trimmed surfaces) follow in
+ * directory order.
  */
 class IGESImporter {
 public:
@@ -85,15 +97,19 @@ public:
     
 private:
     // File sections
+    dc3d::io::MappedFile m_file;
     std::string m_startSection;
     std::string m_globalSection;
     std::vector<IGESDirectoryEntry> m_directoryEntries;
-    std::map<int, IGESParameterEntry> m_parameterEntries;  // Keyed by directory entry number
+    std::vector<IGESParameterEntry> m_parameterEntries;  // Indexed like m_directoryEntries
+    std::vector<std::string> m_parameterText;            // Joined data of multi-line entities
+    
+    // Parsed data, indexed like m_directoryEntries
+    std::vector<glm::dvec3> m_points;
+    std::vector<std::shared_ptr<NURBSCurve>> m_curves;
+    std::vector<std::shared_ptr<NURBSSurface>> m_surfaces;
     
-    // Parsed data
-    std::map<int, glm::dvec3> m_points;
-    std::map<int, std::shared_ptr<NURBSCurve>> m_curves;
-    std::map<int, std::shared_ptr<NURBSSurface>> m_surfaces;
+    // Sparse data, keyed by directory entry number
     std::map<int, glm::dmat4> m_transformations;
     std::map<int, glm::vec3> m_colors;
     
@@ -110,14 +126,21 @@ private:
     ImportStats m_stats;
     ImportOptions m_options;
     
-    // Parsing
+    // Parsing (records are lines without their line break)
     bool parseFile(const std::string& filename);
-    bool parseStartSection(const std::vector<std::string>& lines);
-    bool parseGlobalSection(const std::vector<std::string>& lines);
-    bool parseDirectorySection(const std::vector<std::string>& lines);
-    bool parseParameterSection(const std::vector<std::string>& lines);
+    bool parseStartSection(const std::vector<std::string_view>& records);
+    bool parseGlobalSection(const std::vector<std::string_view>& records);
+    bool parseDirectorySection(const std::vector<std::string_view>& records);
+    bool parseParameterSection(const std::vector<std::string_view>& records);
+    
+    void parseParameterData(std::string_view data, std::vector<std::string_view>& params) const;
+    void releaseTables();
     
-    std::vector<std::string> parseParameterData(const std::string& data);
+    // Entity lookup by directory entry number (odd, 1-based)
+    int entityIndex(int directoryEntry) const;
+    const IGESParameterEntry* parameterEntry(int directoryEntry) const;
+    std::shared_ptr<NURBSCurve> curveAt(int directoryEntry) const;
+    std::shared_ptr<NURBSSurface> surfaceAt(int directoryEntry) const;
     
     // Entity processing
     bool processEntities();
@@ -140,10 +163,10 @@ private:
     glm::dmat4 getTransformationMatrix(int directoryEntry);
     glm::vec3 getColorDefinition(int directoryEntry);
     
-    // Utility functions
-    double parseReal(const std::string& str);
-    int parseInt(const std::string& str);
-    std::string parseHollerith(const std::string& str);
+    // Utility functions (thread-safe: used while decoding in parallel)
+    static double parseReal(std::string_view str);
+    static int parseInt(std::string_view str);
+    static std::string parseHollerith(std::string_view str);
     double getUnitScale() const;
     
     void addWarning(const std::string& msg);
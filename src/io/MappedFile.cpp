@@ -0,0 +1,164 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Implementation of read-only memory-mapped files
+ */
+
+#include "MappedFile.h"
+
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dc3d {
+namespace io {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_open = std::exchange(other.m_open, false);
+#ifdef _WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::filesystem::path& path, std::string* error) {
+    close();
+
+    // Others may append to the file while it is mapped (incremental .dca saves)
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        if (error) *error = "Cannot open file (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        if (error) *error = "Cannot query file size (error " + std::to_string(GetLastError()) + ")";
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_open = true;
+    if (m_size == 0) {
+        return true;  // Empty files cannot be mapped
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        if (error) *error = "Cannot map file (error " + std::to_string(GetLastError()) + ")";
+        close();
+        return false;
+    }
+    m_mapping = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        if (error) *error = "Cannot map file view (error " + std::to_string(GetLastError()) + ")";
+        close();
+        return false;
+    }
+    m_data = static_cast<const char*>(view);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+    }
+    if (m_file) {
+        CloseHandle(static_cast<HANDLE>(m_file));
+    }
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#else
+
+bool MappedFile::open(const std::filesystem::path& path, std::string* error) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (error) *error = std::string("Cannot open file: ") + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        if (error) *error = std::string("Cannot query file size: ") + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(info.st_size);
+    m_open = true;
+    if (m_size == 0) {
+        ::close(fd);
+        return true;  // Empty files cannot be mapped
+    }
+
+    void* mapped = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps its own reference to the file
+    if (mapped == MAP_FAILED) {
+        if (error) *error = std::string("Cannot map file: ") + std::strerror(errno);
+        m_size = 0;
+        m_open = false;
+        return false;
+    }
+
+    // Importers read front to back; let the kernel read ahead aggressively
+    ::madvise(mapped, m_size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<const char*>(mapped);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
+
+#endif
+
+} // namespace io
+} // namespace dc3d
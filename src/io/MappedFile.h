@@ -0,0 +1,65 @@
+/**
+ * @file MappedFile.h
+ * @brief Read-only memory-mapped file
+ *
+ * Maps a whole file into the address space so importers can decode it in
+ * place: no intermediate copies, and the OS pages data in at disk speed
+ * while worker threads touch disjoint ranges.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+
+namespace dc3d {
+namespace io {
+
+/**
+ * @brief RAII read-only memory map of a file
+ *
+ * The mapping is released when the object is destroyed or closed. Move-only.
+ * An empty file opens successfully with size() == 0 and data() == nullptr.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Non-copyable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file for reading
+     * @param path File to map
+     * @param error Optional output: reason on failure
+     * @return true on success
+     */
+    bool open(const std::filesystem::path& path, std::string* error = nullptr);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close();
+
+    bool isOpen() const { return m_open; }
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+#ifdef _WIN32
+    void* m_file = nullptr;       ///< HANDLE from CreateFileW
+    void* m_mapping = nullptr;    ///< HANDLE from CreateFileMappingW
+#endif
+};
+
+} // namespace io
+} // namespace dc3d
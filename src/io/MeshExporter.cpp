@@ -0,0 +1,640 @@
+/**
+ * @file MeshExporter.cpp
+ * @brief Implementation of streaming STL, OBJ and PLY writers
+ */
+
+#include "MeshExporter.h"
+#include "../core/TaskScheduler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace dc3d {
+namespace io {
+
+namespace {
+
+// Target size of one formatted block (one write call per block)
+constexpr size_t BLOCK_BYTES = 1 << 20;
+
+// Blocks formatted per thread in each wave; bounds memory use
+constexpr size_t BLOCKS_PER_THREAD = 2;
+
+// Binary STL layout
+constexpr size_t STL_HEADER_SIZE = 80;
+constexpr size_t STL_TRIANGLE_SIZE = 50;  // 12 + 12*3 + 2 = 50 bytes
+
+// Longest shortest-round-trip float ("-1.17549435e-38") plus separator
+constexpr size_t MAX_FLOAT_CHARS = 16;
+
+// Longest uint64 index used in OBJ faces ("4294967296")
+constexpr size_t MAX_INDEX_CHARS = 10;
+
+// Upper bounds of one formatted text element
+constexpr size_t STL_FACET_CHARS = 16 + 3 * MAX_FLOAT_CHARS
+                                 + 16 + 3 * (14 + 3 * MAX_FLOAT_CHARS)
+                                 + 12 + 11;
+constexpr size_t OBJ_VEC3_CHARS = 3 + 3 * MAX_FLOAT_CHARS + 1;
+constexpr size_t OBJ_VEC2_CHARS = 3 + 2 * MAX_FLOAT_CHARS + 1;
+constexpr size_t OBJ_FACE_CHARS = 2 + 3 * (3 * MAX_INDEX_CHARS + 3) + 1;
+
+// PLY face record: uchar count + three int indices
+constexpr size_t PLY_FACE_SIZE = 1 + 3 * sizeof(int32_t);
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be tightly packed");
+
+/**
+ * Units and coordinate system from ExportOptions, applied per vertex.
+ * The coordinate transform has no translation, so a 3x3 matrix suffices.
+ */
+struct ExportTransform {
+    glm::mat3 position{1.0f};
+    glm::mat3 normal{1.0f};
+    bool identity = true;
+    bool flipWinding = false;   ///< Mirroring transform: reverse triangles to keep them outward
+
+    explicit ExportTransform(const dc::ExportOptions& options) {
+        glm::dmat3 coords(options.getCoordinateTransform());
+        double scale = options.getUnitScale() * options.scaleFactor;
+
+        position = glm::mat3(coords * scale);
+        // Coordinate transforms are orthonormal: the normal matrix is the
+        // rotation itself, mirrored as well if the scale is negative
+        normal = glm::mat3(scale < 0.0 ? -coords : coords);
+        identity = coords == glm::dmat3(1.0) && scale == 1.0;
+        flipWinding = glm::determinant(coords) * scale < 0.0;
+    }
+
+    glm::vec3 point(const glm::vec3& p) const { return identity ? p : position * p; }
+    glm::vec3 direction(const glm::vec3& n) const { return identity ? n : normal * n; }
+
+    /// Corner order of an exported triangle
+    void corners(const uint32_t* face, uint32_t out[3]) const {
+        out[0] = face[0];
+        out[1] = flipWinding ? face[2] : face[1];
+        out[2] = flipWinding ? face[1] : face[2];
+    }
+};
+
+// ============================================================================
+// Text formatting
+// ============================================================================
+
+template<size_t N>
+char* appendLiteral(char* out, const char (&text)[N]) {
+    std::memcpy(out, text, N - 1);
+    return out + N - 1;
+}
+
+// Shortest text that reads back as the same float, locale independent.
+// Without floating-point to_chars (libc++ before macOS 13.3) nine
+// significant digits, which also round-trip; printf follows LC_NUMERIC,
+// so a decimal comma is turned back into a point.
+char* appendFloat(char* out, float value) {
+#if defined(__cpp_lib_to_chars)
+    return std::to_chars(out, out + MAX_FLOAT_CHARS, value).ptr;
+#else
+    int length = std::snprintf(out, MAX_FLOAT_CHARS, "%.9g", static_cast<double>(value));
+    char* end = out + std::clamp(length, 0, static_cast<int>(MAX_FLOAT_CHARS) - 1);
+    std::replace(out, end, ',', '.');
+    return end;
+#endif
+}
+
+char* appendVec3(char* out, const glm::vec3& v) {
+    out = appendFloat(out, v.x);
+    *out++ = ' ';
+    out = appendFloat(out, v.y);
+    *out++ = ' ';
+    return appendFloat(out, v.z);
+}
+
+char* appendIndex(char* out, uint64_t value) {
+    return std::to_chars(out, out + MAX_INDEX_CHARS, value).ptr;
+}
+
+// Unit facet normal of an exported triangle (zero if degenerate)
+glm::vec3 facetNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 n = glm::cross(b - a, c - a);
+    float length = glm::length(n);
+    return length > 0.0f ? n / length : glm::vec3(0.0f);
+}
+
+bool hostIsLittleEndian() {
+    const uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// ============================================================================
+// Block writer
+// ============================================================================
+
+/**
+ * Formats elements in parallel blocks and writes the blocks in file order.
+ *
+ * Each wave formats threads * BLOCKS_PER_THREAD blocks concurrently while
+ * the previous wave is being written by a pool task, so formatting and
+ * disk I/O overlap and memory stays bounded regardless of mesh size.
+ */
+class BlockWriter {
+public:
+    BlockWriter(std::ostream& stream, const geometry::ProgressCallback& progress,
+                size_t totalElements)
+        : m_stream(stream)
+        , m_progress(progress)
+        , m_total(std::max<size_t>(totalElements, 1)) {}
+
+    /// Write text directly (headers and footers)
+    bool writeText(std::string_view text) {
+        return writeBytes(text.data(), text.size());
+    }
+
+    bool writeBytes(const void* data, size_t size) {
+        m_stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!m_stream) {
+            m_failed = true;
+            return false;
+        }
+        m_bytes += size;
+        return true;
+    }
+
+    /**
+     * @brief Write elements [0, count)
+     * @param maxElementBytes Upper bound of one formatted element
+     * @param format Callable (size_t first, size_t last, char* out) -> char* end;
+     *               called concurrently for disjoint ranges
+     * @return false on write error or cancellation
+     */
+    template<typename Format>
+    bool writeElements(size_t count, size_t maxElementBytes, Format&& format) {
+        if (m_failed || m_cancelled) return false;
+        if (count == 0) return true;
+
+        const size_t blockElements = std::max<size_t>(1, BLOCK_BYTES / maxElementBytes);
+        const size_t blockCount = (count + blockElements - 1) / blockElements;
+        const size_t waveBlocks = core::TaskScheduler::instance().threadCount() * BLOCKS_PER_THREAD;
+        const size_t capacity = blockElements * maxElementBytes;
+
+        Wave waves[2];
+        core::TaskGroup writer;
+
+        for (size_t first = 0, index = 0; first < blockCount; first += waveBlocks, ++index) {
+            const size_t last = std::min(first + waveBlocks, blockCount);
+            Wave& wave = waves[index & 1];
+            wave.resize(last - first, capacity);
+
+            core::parallelFor(first, last, [&](size_t begin, size_t end) {
+                for (size_t block = begin; block < end; ++block) {
+                    size_t elementBegin = block * blockElements;
+                    size_t elementEnd = std::min(elementBegin + blockElements, count);
+                    Block& out = wave.blocks[block - first];
+                    char* stop = format(elementBegin, elementEnd, out.data.get());
+                    out.size = static_cast<size_t>(stop - out.data.get());
+                }
+            }, 1);
+
+            // The other buffer set must be on disk before it is reused
+            writer.wait();
+            if (m_failed || !report()) {
+                return false;
+            }
+
+            const size_t elements = std::min(last * blockElements, count) - first * blockElements;
+            writer.run([this, &wave, elements]() {
+                for (const Block& block : wave.blocks) {
+                    if (!writeBytes(block.data.get(), block.size)) return;
+                }
+                m_done += elements;
+            });
+        }
+
+        writer.wait();
+        return !m_failed && report();
+    }
+
+    size_t bytesWritten() const { return m_bytes; }
+    bool failed() const { return m_failed; }
+    bool cancelled() const { return m_cancelled; }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size = 0;
+    };
+
+    struct Wave {
+        std::vector<Block> blocks;
+        size_t capacity = 0;
+
+        void resize(size_t count, size_t blockCapacity) {
+            if (blockCapacity != capacity) {
+                blocks.clear();
+                capacity = blockCapacity;
+            }
+            blocks.resize(count);
+            for (Block& block : blocks) {
+                if (!block.data) block.data.reset(new char[capacity]);
+            }
+        }
+    };
+
+    bool report() {
+        if (m_progress && !m_progress(static_cast<float>(std::min(m_done, m_total)) /
+                                      static_cast<float>(m_total))) {
+            m_cancelled = true;
+        }
+        return !m_cancelled;
+    }
+
+    std::ostream& m_stream;
+    const geometry::ProgressCallback& m_progress;
+    size_t m_total;
+    size_t m_done = 0;
+    size_t m_bytes = 0;
+    bool m_failed = false;
+    bool m_cancelled = false;
+};
+
+// ============================================================================
+// Format writers
+// ============================================================================
+
+void writeSTLBinary(BlockWriter& writer, const geometry::MeshData& mesh,
+                    const dc::ExportOptions& options, const ExportTransform& transform) {
+    char header[STL_HEADER_SIZE] = {};
+    std::string title = "Binary STL exported by " + options.applicationName;
+    std::memcpy(header, title.data(), std::min(title.size(), STL_HEADER_SIZE));
+    uint32_t triangleCount = static_cast<uint32_t>(mesh.faceCount());
+    if (!writer.writeBytes(header, sizeof(header)) ||
+        !writer.writeBytes(&triangleCount, sizeof(triangleCount))) {
+        return;
+    }
+
+    const glm::vec3* vertices = mesh.vertices().data();
+    const uint32_t* indices = mesh.indices().data();
+    const bool includeNormals = options.stlIncludeNormals;
+
+    writer.writeElements(mesh.faceCount(), STL_TRIANGLE_SIZE,
+        [&](size_t first, size_t last, char* out) {
+            for (size_t f = first; f < last; ++f) {
+                uint32_t corner[3];
+                transform.corners(indices + f * 3, corner);
+                glm::vec3 triangle[4];
+                for (int k = 0; k < 3; ++k) {
+                    triangle[k + 1] = transform.point(vertices[corner[k]]);
+                }
+                triangle[0] = includeNormals ? facetNormal(triangle[1], triangle[2], triangle[3])
+                                             : glm::vec3(0.0f);
+                std::memcpy(out, triangle, sizeof(triangle));
+                out[48] = 0;
+                out[49] = 0;  // Attribute byte count
+                out += STL_TRIANGLE_SIZE;
+            }
+            return out;
+        });
+}
+
+void writeSTLAscii(BlockWriter& writer, const geometry::MeshData& mesh,
+                   const dc::ExportOptions& options, const ExportTransform& transform) {
+    const std::string name = options.applicationName;
+    if (!writer.writeText("solid " + name + "\n")) return;
+
+    const glm::vec3* vertices = mesh.vertices().data();
+    const uint32_t* indices = mesh.indices().data();
+    const bool includeNormals = options.stlIncludeNormals;
+
+    bool written = writer.writeElements(mesh.faceCount(), STL_FACET_CHARS,
+        [&](size_t first, size_t last, char* out) {
+            for (size_t f = first; f < last; ++f) {
+                uint32_t corner[3];
+                transform.corners(indices + f * 3, corner);
+                glm::vec3 p[3];
+                for (int k = 0; k < 3; ++k) {
+                    p[k] = transform.point(vertices[corner[k]]);
+                }
+                glm::vec3 n = includeNormals ? facetNormal(p[0], p[1], p[2]) : glm::vec3(0.0f);
+
+                out = appendLiteral(out, "  facet normal ");
+                out = appendVec3(out, n);
+                out = appendLiteral(out, "\n    outer loop\n");
+                for (int k = 0; k < 3; ++k) {
+                    out = appendLiteral(out, "      vertex ");
+                    out = appendVec3(out, p[k]);
+                    *out++ = '\n';
+                }
+                out = appendLiteral(out, "    endloop\n  endfacet\n");
+            }
+            return out;
+        });
+
+    if (written) {
+        writer.writeText("endsolid " + name + "\n");
+    }
+}
+
+void writeOBJ(BlockWriter& writer, const geometry::MeshData& mesh,
+              const dc::ExportOptions& options, const ExportTransform& transform) {
+    const bool includeNormals = options.meshIncludeNormals && mesh.hasNormals();
+    const bool includeUVs = options.meshIncludeUVs && mesh.hasUVs();
+
+    std::string header = "# Exported by " + options.applicationName + " " +
+                         options.applicationVersion + "\n"
+                         "# " + std::to_string(mesh.vertexCount()) + " vertices, " +
+                         std::to_string(mesh.faceCount()) + " faces\n";
+    if (!writer.writeText(header)) return;
+
+    const glm::vec3* vertices = mesh.vertices().data();
+    bool ok = writer.writeElements(mesh.vertexCount(), OBJ_VEC3_CHARS,
+        [&](size_t first, size_t last, char* out) {
+            for (size_t i = first; i < last; ++i) {
+                out = appendLiteral(out, "v ");
+                out = appendVec3(out, transform.point(vertices[i]));
+                *out++ = '\n';
+            }
+            return out;
+        });
+
+    if (ok && includeUVs) {
+        const glm::vec2* uvs = mesh.uvs().data();
+        ok = writer.writeElements(mesh.vertexCount(), OBJ_VEC2_CHARS,
+            [&](size_t first, size_t last, char* out) {
+                for (size_t i = first; i < last; ++i) {
+                    out = appendLiteral(out, "vt ");
+                    out = appendFloat(out, uvs[i].x);
+                    *out++ = ' ';
+                    out = appendFloat(out, uvs[i].y);
+                    *out++ = '\n';
+                }
+                return out;
+            });
+    }
+
+    if (ok && includeNormals) {
+        const glm::vec3* normals = mesh.normals().data();
+        ok = writer.writeElements(mesh.vertexCount(), OBJ_VEC3_CHARS,
+            [&](size_t first, size_t last, char* out) {
+                for (size_t i = first; i < last; ++i) {
+                    out = appendLiteral(out, "vn ");
+                    out = appendVec3(out, transform.direction(normals[i]));
+                    *out++ = '\n';
+                }
+                return out;
+            });
+    }
+
+    if (!ok) return;
+
+    // Positions, UVs and normals share numbering, so each corner repeats its index
+    const uint32_t* indices = mesh.indices().data();
+    writer.writeElements(mesh.faceCount(), OBJ_FACE_CHARS,
+        [&](size_t first, size_t last, char* out) {
+            for (size_t f = first; f < last; ++f) {
+                uint32_t corner[3];
+                transform.corners(indices + f * 3, corner);
+                *out++ = 'f';
+                for (int k = 0; k < 3; ++k) {
+                    uint64_t index = static_cast<uint64_t>(corner[k]) + 1;
+                    *out++ = ' ';
+                    out = appendIndex(out, index);
+                    if (includeUVs || includeNormals) {
+                        *out++ = '/';
+                        if (includeUVs) out = appendIndex(out, index);
+                        if (includeNormals) {
+                            *out++ = '/';
+                            out = appendIndex(out, index);
+                        }
+                    }
+                }
+                *out++ = '\n';
+            }
+            return out;
+        });
+}
+
+void writePLY(BlockWriter& writer, const geometry::MeshData& mesh,
+              const dc::ExportOptions& options, const ExportTransform& transform) {
+    const bool includeNormals = options.meshIncludeNormals && mesh.hasNormals();
+
+    std::string header =
+        "ply\n"
+        "format " + std::string(hostIsLittleEndian() ? "binary_little_endian" : "binary_big_endian") +
+        " 1.0\n"
+        "comment Exported by " + options.applicationName + " " + options.applicationVersion + "\n"
+        "element vertex " + std::to_string(mesh.vertexCount()) + "\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n";
+    if (includeNormals) {
+        header += "property float nx\n"
+                  "property float ny\n"
+                  "property float nz\n";
+    }
+    header += "element face " + std::to_string(mesh.faceCount()) + "\n"
+              "property list uchar int vertex_indices\n"
+              "end_header\n";
+    if (!writer.writeText(header)) return;
+
+    const glm::vec3* vertices = mesh.vertices().data();
+    const glm::vec3* normals = includeNormals ? mesh.normals().data() : nullptr;
+    const size_t vertexSize = (includeNormals ? 2 : 1) * sizeof(glm::vec3);
+
+    bool ok = writer.writeElements(mesh.vertexCount(), vertexSize,
+        [&](size_t first, size_t last, char* out) {
+            if (transform.identity && !normals) {
+                // Packed positions are already the record layout
+                size_t bytes = (last - first) * sizeof(glm::vec3);
+                std::memcpy(out, vertices + first, bytes);
+                return out + bytes;
+            }
+            for (size_t i = first; i < last; ++i) {
+                glm::vec3 p = transform.point(vertices[i]);
+                std::memcpy(out, &p, sizeof(p));
+                out += sizeof(p);
+                if (normals) {
+                    glm::vec3 n = transform.direction(normals[i]);
+                    std::memcpy(out, &n, sizeof(n));
+                    out += sizeof(n);
+                }
+            }
+            return out;
+        });
+
+    if (!ok) return;
+
+    const uint32_t* indices = mesh.indices().data();
+    writer.writeElements(mesh.faceCount(), PLY_FACE_SIZE,
+        [&](size_t first, size_t last, char* out) {
+            for (size_t f = first; f < last; ++f) {
+                uint32_t corner[3];
+                transform.corners(indices + f * 3, corner);
+                *out++ = 3;
+                std::memcpy(out, corner, sizeof(corner));
+                out += sizeof(corner);
+            }
+            return out;
+        });
+}
+
+} // anonymous namespace
+
+// ============================================================================
+// MeshExporter
+// ============================================================================
+
+geometry::Result<size_t> MeshExporter::exportMesh(
+    const geometry::MeshData& mesh,
+    const std::filesystem::path& path,
+    const dc::ExportOptions& options,
+    geometry::ProgressCallback progress) {
+
+    std::string fileName = path.filename().string();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return geometry::Result<size_t>::failure(
+            "Cannot create file: \"" + fileName + "\"\n"
+            "Path: " + path.string() + "\n"
+            "Check that the folder exists and you have permission to write to it.");
+    }
+
+    auto result = exportToStream(file, mesh, options, std::move(progress));
+    if (result.ok()) {
+        file.close();
+        if (!file) {
+            result = geometry::Result<size_t>::failure(
+                "Failed to finish writing \"" + fileName + "\"\n"
+                "The disk may be full or the file may have been removed.");
+        }
+    }
+
+    if (!result.ok()) {
+        // Never leave a truncated file behind
+        file.close();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+    return result;
+}
+
+geometry::Result<size_t> MeshExporter::exportToStream(
+    std::ostream& stream,
+    const geometry::MeshData& mesh,
+    const dc::ExportOptions& options,
+    geometry::ProgressCallback progress) {
+
+    if (!isSupported(options.format)) {
+        return geometry::Result<size_t>::failure(
+            "Unsupported mesh export format: " + options.getFormatName() + "\n"
+            "Meshes can be exported as STL, OBJ or PLY.");
+    }
+
+    if (mesh.isEmpty() || mesh.indexCount() % 3 != 0) {
+        return geometry::Result<size_t>::failure(
+            "Nothing to export: the mesh has no triangles.");
+    }
+
+    const size_t vertexCount = mesh.vertexCount();
+    const uint32_t* indices = mesh.indices().data();
+    uint32_t maxIndex = core::parallelReduce(size_t(0), mesh.indexCount(), uint32_t(0),
+        [&](size_t begin, size_t end) {
+            return *std::max_element(indices + begin, indices + end);
+        },
+        [](uint32_t a, uint32_t b) { return std::max(a, b); });
+    if (maxIndex >= vertexCount) {
+        return geometry::Result<size_t>::failure(
+            "Cannot export: the mesh is corrupted.\n"
+            "A face references vertex " + std::to_string(maxIndex) + " but the mesh has only " +
+            std::to_string(vertexCount) + " vertices. Try Mesh Repair first.");
+    }
+
+    const bool binarySTL = options.format == dc::ExportFormat::STL_BINARY;
+    if (binarySTL && mesh.faceCount() > UINT32_MAX) {
+        return geometry::Result<size_t>::failure(
+            "Mesh too large for binary STL: " + std::to_string(mesh.faceCount()) + " triangles\n"
+            "Binary STL stores at most 4294967295 triangles. Export as PLY instead.");
+    }
+
+    // Progress is measured in elements written across all sections
+    size_t totalElements = mesh.faceCount();
+    if (options.format == dc::ExportFormat::OBJ) {
+        totalElements += vertexCount;
+        if (options.meshIncludeUVs && mesh.hasUVs()) totalElements += vertexCount;
+        if (options.meshIncludeNormals && mesh.hasNormals()) totalElements += vertexCount;
+    } else if (options.format == dc::ExportFormat::PLY) {
+        totalElements += vertexCount;
+    }
+
+    ExportTransform transform(options);
+    BlockWriter writer(stream, progress, totalElements);
+
+    switch (options.format) {
+        case dc::ExportFormat::STL_BINARY:
+            writeSTLBinary(writer, mesh, options, transform);
+            break;
+        case dc::ExportFormat::STL_ASCII:
+            writeSTLAscii(writer, mesh, options, transform);
+            break;
+        case dc::ExportFormat::OBJ:
+            writeOBJ(writer, mesh, options, transform);
+            break;
+        default:
+            writePLY(writer, mesh, options, transform);
+            break;
+    }
+
+    if (writer.cancelled()) {
+        return geometry::Result<size_t>::failure("Export cancelled by user.");
+    }
+    if (writer.failed()) {
+        return geometry::Result<size_t>::failure(
+            "Failed to write " + options.getFormatName() + " data after " +
+            std::to_string(writer.bytesWritten()) + " bytes.\n"
+            "The disk may be full or the destination may have become unavailable.");
+    }
+
+    return geometry::Result<size_t>::success(writer.bytesWritten());
+}
+
+bool MeshExporter::isSupported(dc::ExportFormat format) {
+    switch (format) {
+        case dc::ExportFormat::STL_ASCII:
+        case dc::ExportFormat::STL_BINARY:
+        case dc::ExportFormat::OBJ:
+        case dc::ExportFormat::PLY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool MeshExporter::formatForExtension(const std::string& extension, dc::ExportFormat& format) {
+    std::string ext = extension;
+    if (!ext.empty() && ext.front() == '.') ext.erase(0, 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (ext == "stl") {
+        format = dc::ExportFormat::STL_BINARY;
+    } else if (ext == "obj") {
+        format = dc::ExportFormat::OBJ;
+    } else if (ext == "ply") {
+        format = dc::ExportFormat::PLY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace io
+} // namespace dc3d
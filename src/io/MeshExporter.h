@@ -0,0 +1,92 @@
+/**
+ * @file MeshExporter.h
+ * @brief Streaming writers for STL, OBJ and PLY mesh files
+ *
+ * Writes straight from MeshData without building the file in memory: the
+ * mesh is formatted block by block into reusable buffers (in parallel for
+ * the text formats) and each block is written as one large sequential
+ * write. The ExportOptions unit scale and coordinate system are applied to
+ * every position and normal as it is written, so the source mesh is never
+ * copied or modified.
+ */
+
+#pragma once
+
+#include "ExportOptions.h"
+#include "../geometry/MeshData.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <ostream>
+#include <string>
+
+namespace dc3d {
+namespace io {
+
+/**
+ * @brief Mesh file exporter
+ *
+ * Supports:
+ * - Binary and ASCII STL (facet normals computed from the exported triangles)
+ * - Wavefront OBJ with optional vertex normals and texture coordinates
+ * - Binary PLY with optional vertex normals
+ *
+ * Binary files are written in the host byte order (little-endian on all
+ * supported platforms), which is what STL requires and what the PLY header
+ * declares.
+ */
+class MeshExporter {
+public:
+    MeshExporter() = default;
+    ~MeshExporter() = default;
+
+    // Non-copyable
+    MeshExporter(const MeshExporter&) = delete;
+    MeshExporter& operator=(const MeshExporter&) = delete;
+
+    /**
+     * @brief Export a mesh to disk
+     * @param mesh Mesh to write
+     * @param path Destination file (replaced if it exists)
+     * @param options Format (STL_ASCII, STL_BINARY, OBJ or PLY), units and
+     *                coordinate system
+     * @param progress Optional progress callback; returning false cancels
+     *                 the export and removes the partial file
+     * @return Result containing the number of bytes written or error message
+     */
+    static geometry::Result<size_t> exportMesh(
+        const geometry::MeshData& mesh,
+        const std::filesystem::path& path,
+        const dc::ExportOptions& options,
+        geometry::ProgressCallback progress = nullptr);
+
+    /**
+     * @brief Export a mesh to an output stream
+     * @param stream Stream opened in binary mode
+     * @param mesh Mesh to write
+     * @param options Format, units and coordinate system
+     * @param progress Optional progress callback
+     * @return Result containing the number of bytes written or error message
+     */
+    static geometry::Result<size_t> exportToStream(
+        std::ostream& stream,
+        const geometry::MeshData& mesh,
+        const dc::ExportOptions& options,
+        geometry::ProgressCallback progress = nullptr);
+
+    /**
+     * @brief Check if a format is written by this exporter
+     */
+    static bool isSupported(dc::ExportFormat format);
+
+    /**
+     * @brief Pick a mesh format from a file extension
+     * @param extension Extension with or without the leading dot (any case)
+     * @param format Output: STL_BINARY, OBJ or PLY
+     * @return false if the extension is not a mesh format
+     */
+    static bool formatForExtension(const std::string& extension, dc::ExportFormat& format);
+};
+
+} // namespace io
+} // namespace dc3d
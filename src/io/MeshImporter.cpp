@@ -90,6 +90,7 @@ ImportResult MeshImporter::importSTL(const std::string& filePath, const ImportOp
     STLImportOptions stlOptions;
     stlOptions.computeNormals = options.computeNormals;
     stlOptions.mergeVertexTolerance = options.mergeVertices ? 1e-6f : 0.0f;
+    stlOptions.sink = options.sink;
     
     auto stlResult = STLImporter::import(std::filesystem::path(filePath), stlOptions, nullptr);
     
@@ -111,6 +112,7 @@ ImportResult MeshImporter::importOBJ(const std::string& filePath, const ImportOp
     objOptions.computeNormalsIfMissing = options.computeNormals;
     objOptions.triangulate = true;
     objOptions.importUVs = true;
+    objOptions.sink = options.sink;
     
     auto objResult = OBJImporter::import(std::filesystem::path(filePath), objOptions, nullptr);
     
@@ -130,6 +132,7 @@ ImportResult MeshImporter::importPLY(const std::string& filePath, const ImportOp
     // MEDIUM FIX: Forward to actual PLYImporter instead of stub
     PLYImportOptions plyOptions;
     plyOptions.computeNormalsIfMissing = options.computeNormals;
+    plyOptions.sink = options.sink;
     
     auto plyResult = PLYImporter::import(std::filesystem::path(filePath), plyOptions, nullptr);
     
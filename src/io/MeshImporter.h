@@ -20,6 +20,8 @@ class MeshData;
 
 namespace io {
 
+class MeshSink;
+
 /**
  * @struct ImportOptions
  * @brief Options for mesh import operations
@@ -29,6 +31,7 @@ struct ImportOptions
     bool computeNormals = true;     ///< Recompute normals after import
     bool mergeVertices = true;      ///< Merge duplicate vertices
     double mergeTolerance = 1e-6;   ///< Tolerance for vertex merging
+    MeshSink* sink = nullptr;       ///< Optional: receives geometry in chunks while loading
 };
 
 /**
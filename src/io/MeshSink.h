@@ -0,0 +1,156 @@
+/**
+ * @file MeshSink.h
+ * @brief Receiver for geometry streamed out of an importer while it loads
+ *
+ * Importers given a sink (via their options) hand over each block of the
+ * file as soon as it is decoded, so callers can show a growing preview
+ * long before the complete MeshData is returned. Welding, normals and the
+ * BVH still run on the complete mesh after parsing.
+ */
+
+#pragma once
+
+#include "../core/TaskScheduler.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace dc3d {
+namespace io {
+
+/// Triangles per chunk delivered by binary importers
+constexpr size_t STREAM_CHUNK_TRIANGLES = 1 << 18;
+
+/**
+ * @brief Block of geometry decoded from a file
+ *
+ * Chunks arrive in file order. A chunk's vertices continue the numbering of
+ * earlier chunks; its indices form triangles over any vertex delivered so
+ * far, including its own. Either part may be empty. The pointers are only
+ * valid for the duration of MeshSink::consume().
+ */
+struct MeshChunk {
+    const glm::vec3* vertices = nullptr;
+    size_t vertexCount = 0;
+    size_t firstVertex = 0;           ///< Stream index of vertices[0]
+    const uint32_t* indices = nullptr;
+    size_t indexCount = 0;            ///< Multiple of 3
+    glm::vec3 boundsMin{std::numeric_limits<float>::max()};     ///< Of vertices (invalid if none)
+    glm::vec3 boundsMax{std::numeric_limits<float>::lowest()};
+};
+
+/**
+ * @brief Consumer of streamed import geometry
+ *
+ * Called on the thread that runs the import, never concurrently. The
+ * stream is the geometry as stored in the file: the final mesh returned
+ * by the importer may renumber it (STL welding, OBJ corner
+ * deduplication), so a sink is for previews, not a replacement for the
+ * result.
+ */
+class MeshSink {
+public:
+    virtual ~MeshSink() = default;
+
+    /**
+     * @brief Called once before the first chunk
+     * @param expectedVertices Vertex count from the file header (0 if unknown)
+     * @param expectedTriangles Triangle count from the file header (0 if unknown)
+     */
+    virtual void begin(size_t expectedVertices, size_t expectedTriangles) {
+        (void)expectedVertices;
+        (void)expectedTriangles;
+    }
+
+    /**
+     * @brief Receive the next chunk
+     * @return false to cancel the import
+     */
+    virtual bool consume(const MeshChunk& chunk) = 0;
+};
+
+/**
+ * @brief Forwards growing vertex/index arrays to a sink
+ *
+ * Importers that decode into arrays in file order call flush() whenever a
+ * further prefix is complete; only the part not yet delivered is sent,
+ * with its bounds computed in parallel so the sink does not scan it again.
+ * Does nothing without a sink.
+ */
+class MeshStreamer {
+public:
+    explicit MeshStreamer(MeshSink* sink) : m_sink(sink) {}
+
+    bool active() const { return m_sink != nullptr; }
+
+    void begin(size_t expectedVertices, size_t expectedTriangles) {
+        if (m_sink) m_sink->begin(expectedVertices, expectedTriangles);
+    }
+
+    /**
+     * @brief Deliver vertices [sent, vertexCount) and indices [sent, indexCount)
+     * @return false if the sink cancelled the import
+     */
+    bool flush(const glm::vec3* vertices, size_t vertexCount,
+               const uint32_t* indices, size_t indexCount) {
+        if (!m_sink || (vertexCount <= m_vertices && indexCount <= m_indices)) {
+            return true;
+        }
+        MeshChunk chunk;
+        if (vertexCount > m_vertices) {
+            chunk.vertices = vertices + m_vertices;
+            chunk.vertexCount = vertexCount - m_vertices;
+            computeBounds(chunk.vertices, chunk.vertexCount, chunk.boundsMin, chunk.boundsMax);
+        }
+        chunk.firstVertex = m_vertices;
+        if (indexCount > m_indices) {
+            chunk.indices = indices + m_indices;
+            chunk.indexCount = indexCount - m_indices;
+        }
+        m_vertices = std::max(m_vertices, vertexCount);
+        m_indices = std::max(m_indices, indexCount);
+        return m_sink->consume(chunk);
+    }
+
+    bool flush(const std::vector<glm::vec3>& vertices, size_t vertexCount,
+               const std::vector<uint32_t>& indices, size_t indexCount) {
+        return flush(vertices.data(), vertexCount, indices.data(), indexCount);
+    }
+
+    size_t sentVertices() const { return m_vertices; }
+    size_t sentIndices() const { return m_indices; }
+
+private:
+    static void computeBounds(const glm::vec3* vertices, size_t count,
+                              glm::vec3& boundsMin, glm::vec3& boundsMax) {
+        constexpr size_t BOUNDS_BLOCK = 1 << 16;
+        const size_t blockCount = (count + BOUNDS_BLOCK - 1) / BOUNDS_BLOCK;
+        std::vector<glm::vec3> blockMin(blockCount, boundsMin);
+        std::vector<glm::vec3> blockMax(blockCount, boundsMax);
+        core::parallelFor(0, blockCount, [&](size_t blockBegin, size_t blockEnd) {
+            for (size_t b = blockBegin; b < blockEnd; ++b) {
+                const size_t end = std::min(count, (b + 1) * BOUNDS_BLOCK);
+                for (size_t i = b * BOUNDS_BLOCK; i < end; ++i) {
+                    blockMin[b] = glm::min(blockMin[b], vertices[i]);
+                    blockMax[b] = glm::max(blockMax[b], vertices[i]);
+                }
+            }
+        }, 1);
+        for (size_t b = 0; b < blockCount; ++b) {
+            boundsMin = glm::min(boundsMin, blockMin[b]);
+            boundsMax = glm::max(boundsMax, blockMax[b]);
+        }
+    }
+
+    MeshSink* m_sink;
+    size_t m_vertices = 0;
+    size_t m_indices = 0;
+};
+
+} // namespace io
+} // namespace dc3d
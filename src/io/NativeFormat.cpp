@@ -1,77 +1,434 @@
 #include "NativeFormat.h"
+#include "../core/TaskScheduler.h"
+
+#include <QByteArray>
+
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <limits>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
 #include <cstring>
 #include <algorithm>
 #include <cstdint>
+#include <cstdio>
+#include <filesystem>
 #include <stdexcept>
 
 namespace dc {
 
-// Placeholder classes
-class NURBSSurface {
-public:
-    int degreeU = 3, degreeV = 3;
-    std::vector<std::vector<glm::dvec3>> controlPoints;
-    std::vector<std::vector<double>> weights;
-    std::vector<double> knotsU, knotsV;
-    double uMin = 0, uMax = 1, vMin = 0, vMax = 1;
-};
+namespace {
 
-class NURBSCurve {
-public:
-    int degree = 3;
-    std::vector<glm::dvec3> controlPoints;
-    std::vector<double> weights;
-    std::vector<double> knots;
-    double tMin = 0, tMax = 1;
-};
+// Compressed mesh streams are cut into blocks that are encoded and decoded
+// independently, so large meshes use every core in both directions
+constexpr size_t MESH_BLOCK_BYTES = 4 << 20;
 
-class SketchElement {
-public:
-    enum class Type { Line, Arc, Circle, Spline };
-    Type type = Type::Line;
-    std::vector<glm::dvec2> points;
-    std::vector<double> parameters;
-    bool isConstruction = false;
-};
+// Block storage
+constexpr uint8_t BLOCK_STORED = 0;
+constexpr uint8_t BLOCK_ZLIB = 1;
 
-class Sketch {
-public:
-    std::string name = "Sketch";
-    glm::dvec3 origin{0, 0, 0};
-    glm::dvec3 normal{0, 0, 1};
-    glm::dvec3 xAxis{1, 0, 0};
-    std::vector<std::shared_ptr<SketchElement>> elements;
-    bool isVisible = true;
-};
+// Attribute encodings in MESH_COMPRESSED chunks
+constexpr uint32_t POSITIONS_FLOAT = 0;       // Exact floats as byte planes
+constexpr uint32_t POSITIONS_QUANTIZED = 1;   // Delta-coded cells of 2 * tolerance
+constexpr uint32_t NORMALS_FLOAT = 0;
+constexpr uint32_t NORMALS_OCTAHEDRAL = 1;    // Delta-coded 16-bit octahedral
 
-class Face {
-public:
-    std::shared_ptr<NURBSSurface> surface;
-    MeshData mesh;
-    glm::vec3 color{0.7f, 0.7f, 0.8f};
-};
+// Largest quantization grid per axis
+constexpr double MAX_QUANTIZED_CELLS = 4294967296.0;
 
-class Body {
-public:
-    std::string name = "Body";
-    std::string id;
-    std::vector<std::shared_ptr<Face>> faces;
-    MeshData combinedMesh;
-    glm::vec3 color{0.7f, 0.7f, 0.8f};
-    bool isVisible = true;
-};
+// Octahedral coordinates in [-1, 1] map to 16-bit integers
+constexpr float OCTAHEDRAL_SCALE = 32767.0f;
+
+// Recently referenced vertices remembered by the index coder
+constexpr size_t INDEX_CACHE_SIZE = 16;
+
+bool hostIsLittleEndian()
+{
+    const uint16_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+void putUint32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint32_t getUint32(const std::vector<uint8_t>& buffer, size_t& offset)
+{
+    if (offset + 4 > buffer.size()) {
+        throw std::runtime_error("Buffer underflow in compressed mesh stream at offset " +
+                                 std::to_string(offset));
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(buffer[offset + i]) << (8 * i);
+    }
+    offset += 4;
+    return value;
+}
+
+uint64_t zigzag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t code)
+{
+    return static_cast<int64_t>(code >> 1) ^ -static_cast<int64_t>(code & 1);
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && in < end; shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Split 32-bit words into four byte planes: sign/exponent bytes of floats
+// end up next to each other, which the entropy stage compresses far better
+void putBytePlanes(std::vector<uint8_t>& out, const void* data, size_t count)
+{
+    size_t offset = out.size();
+    out.resize(offset + count * 4);
+    uint8_t* planes = out.data() + offset;
+    const uint8_t* in = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t word;
+        std::memcpy(&word, in + i * 4, 4);
+        for (size_t k = 0; k < 4; k++) {
+            planes[k * count + i] = static_cast<uint8_t>(word >> (8 * k));
+        }
+    }
+}
+
+bool getBytePlanes(const uint8_t* planes, const uint8_t* end, void* data, size_t count)
+{
+    if (static_cast<size_t>(end - planes) != count * 4) return false;
+    uint8_t* out = static_cast<uint8_t*>(data);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t word = 0;
+        for (size_t k = 0; k < 4; k++) {
+            word |= static_cast<uint32_t>(planes[k * count + i]) << (8 * k);
+        }
+        std::memcpy(out + i * 4, &word, 4);
+    }
+    return true;
+}
+
+// Unit vector to the [-1, 1]^2 octahedral square (zero maps to +Z)
+glm::vec2 octahedralEncode(const glm::vec3& n)
+{
+    float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (!(sum > 0.0f)) return glm::vec2(0.0f);
+    glm::vec2 p(n.x / sum, n.y / sum);
+    if (n.z < 0.0f) {
+        p = glm::vec2((1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+                      (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+    }
+    return p;
+}
+
+glm::vec3 octahedralDecode(const glm::vec2& p)
+{
+    glm::vec3 n(p.x, p.y, 1.0f - std::abs(p.x) - std::abs(p.y));
+    float fold = std::max(-n.z, 0.0f);
+    n.x += n.x >= 0.0f ? -fold : fold;
+    n.y += n.y >= 0.0f ? -fold : fold;
+    return glm::normalize(n);
+}
+
+// Move-to-front list of recent vertex indices shared by index coder and decoder
+struct IndexCache {
+    uint32_t slots[INDEX_CACHE_SIZE];
+    int64_t next = 0;   // One past the highest index seen
+
+    IndexCache() { std::fill(std::begin(slots), std::end(slots), UINT32_MAX); }
 
-class Project {
-public:
-    ProjectSettings settings;
-    std::vector<std::shared_ptr<Body>> bodies;
-    std::vector<std::shared_ptr<Sketch>> sketches;
-    std::string filePath;
+    size_t find(uint32_t index) const {
+        return static_cast<size_t>(std::find(std::begin(slots), std::end(slots), index) - std::begin(slots));
+    }
+
+    // Record a reference; slot is the hit position or INDEX_CACHE_SIZE on a miss
+    void use(size_t slot, uint32_t index) {
+        size_t from = std::min(slot, INDEX_CACHE_SIZE - 1);
+        std::copy_backward(slots, slots + from, slots + from + 1);
+        slots[0] = index;
+        next = std::max(next, static_cast<int64_t>(index) + 1);
+    }
 };
 
+/**
+ * Write elements [0, count) as independently encoded blocks.
+ * encode(first, last, out) appends the block's bytes; each block is then
+ * stored or zlib-compressed, whichever is smaller. Blocks run in parallel.
+ */
+template<typename Encode>
+void writeBlockStream(std::vector<uint8_t>& buffer, size_t count, size_t elementBytes,
+                      int level, Encode&& encode)
+{
+    const size_t blockElements = std::max<size_t>(1, MESH_BLOCK_BYTES / elementBytes);
+    const size_t blockCount = (count + blockElements - 1) / blockElements;
+    std::vector<std::vector<uint8_t>> blocks(blockCount);
+    std::vector<uint8_t> codings(blockCount, BLOCK_STORED);
+    std::vector<uint32_t> rawSizes(blockCount, 0);
+    
+    dc3d::core::parallelFor(0, blockCount, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; block++) {
+            std::vector<uint8_t> raw;
+            raw.reserve(blockElements * elementBytes);
+            size_t first = block * blockElements;
+            encode(first, std::min(first + blockElements, count), raw);
+            rawSizes[block] = static_cast<uint32_t>(raw.size());
+            
+            QByteArray packed = qCompress(raw.data(), static_cast<qsizetype>(raw.size()), level);
+            if (static_cast<size_t>(packed.size()) < raw.size()) {
+                codings[block] = BLOCK_ZLIB;
+                blocks[block].assign(packed.constData(), packed.constData() + packed.size());
+            } else {
+                blocks[block] = std::move(raw);
+            }
+        }
+    }, 1);
+    
+    putUint32(buffer, static_cast<uint32_t>(blockElements));
+    putUint32(buffer, static_cast<uint32_t>(blockCount));
+    for (size_t block = 0; block < blockCount; block++) {
+        buffer.push_back(codings[block]);
+        putUint32(buffer, rawSizes[block]);
+        putUint32(buffer, static_cast<uint32_t>(blocks[block].size()));
+        buffer.insert(buffer.end(), blocks[block].begin(), blocks[block].end());
+    }
+}
+
+/**
+ * Read a stream written by writeBlockStream, decoding blocks in parallel.
+ * decode(first, last, in, end) fills elements [first, last) and returns
+ * false if the block is malformed.
+ */
+template<typename Decode>
+void readBlockStream(const std::vector<uint8_t>& data, size_t& offset, size_t count, Decode&& decode)
+{
+    struct BlockRef {
+        uint8_t coding;
+        uint32_t rawSize;
+        uint32_t storedSize;
+        size_t offset;
+    };
+    
+    uint32_t blockElements = getUint32(data, offset);
+    uint32_t blockCount = getUint32(data, offset);
+    if (blockElements == 0 || blockElements > MESH_BLOCK_BYTES ||
+        blockCount != (count + blockElements - 1) / blockElements) {
+        throw std::runtime_error("Corrupt compressed mesh stream: bad block layout");
+    }
+    
+    std::vector<BlockRef> blocks(blockCount);
+    for (BlockRef& block : blocks) {
+        if (offset >= data.size()) {
+            throw std::runtime_error("Buffer underflow in compressed mesh stream at offset " +
+                                     std::to_string(offset));
+        }
+        block.coding = data[offset++];
+        block.rawSize = getUint32(data, offset);
+        block.storedSize = getUint32(data, offset);
+        block.offset = offset;
+        if (block.storedSize > data.size() - offset) {
+            throw std::runtime_error("Buffer underflow in compressed mesh stream at offset " +
+                                     std::to_string(offset));
+        }
+        offset += block.storedSize;
+    }
+    
+    std::atomic<bool> valid{true};
+    dc3d::core::parallelFor(0, blocks.size(), [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            const BlockRef& block = blocks[b];
+            const uint8_t* in = data.data() + block.offset;
+            QByteArray unpacked;
+            if (block.coding == BLOCK_ZLIB) {
+                unpacked = qUncompress(in, static_cast<qsizetype>(block.storedSize));
+                if (static_cast<size_t>(unpacked.size()) != block.rawSize) {
+                    valid = false;
+                    continue;
+                }
+                in = reinterpret_cast<const uint8_t*>(unpacked.constData());
+            } else if (block.coding != BLOCK_STORED || block.storedSize != block.rawSize) {
+                valid = false;
+                continue;
+            }
+            
+            size_t first = b * blockElements;
+            if (!decode(first, std::min<size_t>(first + blockElements, count), in, in + block.rawSize)) {
+                valid = false;
+            }
+        }
+    }, 1);
+    
+    if (!valid) {
+        throw std::runtime_error("Corrupt compressed mesh data");
+    }
+}
+
+// Archive footer: table of contents offset, table checksum, magic
+constexpr size_t ARCHIVE_FOOTER_SIZE = 8 + 8 + 4;
+
+// Incremental saves append to the archive until the file is this many times
+// larger than its live data; the next save then rewrites it compactly
+constexpr double ARCHIVE_COMPACTION_RATIO = 2.0;
+
+std::string meshEntryName(size_t body)
+{
+    return "meshes/body_" + std::to_string(body) + ".bin";
+}
+
+std::string surfaceEntryName(size_t body, size_t face)
+{
+    return "surfaces/body_" + std::to_string(body) + "_face_" + std::to_string(face) + ".bin";
+}
+
+std::string sketchEntryName(size_t sketch)
+{
+    return "sketches/sketch_" + std::to_string(sketch) + ".bin";
+}
+
+// Archive structures are stored in host byte order, like the original ARCH layout
+template<typename T>
+void appendRaw(std::vector<uint8_t>& buffer, T value)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+T loadRaw(const void* data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// XXH64 (seed 0): checksums entries at memory speed, unlike a bytewise CRC
+constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+uint64_t rotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t xxhRound(uint64_t acc, uint64_t input)
+{
+    acc += input * XXH_PRIME64_2;
+    return rotateLeft(acc, 31) * XXH_PRIME64_1;
+}
+
+uint64_t xxhMerge(uint64_t acc, uint64_t value)
+{
+    acc ^= xxhRound(0, value);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+uint64_t archiveChecksum(const uint8_t* data, size_t size)
+{
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    uint64_t hash;
+    
+    if (size >= 32) {
+        uint64_t v1 = XXH_PRIME64_1 + XXH_PRIME64_2;
+        uint64_t v2 = XXH_PRIME64_2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - XXH_PRIME64_1;
+        for (; end - p >= 32; p += 32) {
+            v1 = xxhRound(v1, loadRaw<uint64_t>(p));
+            v2 = xxhRound(v2, loadRaw<uint64_t>(p + 8));
+            v3 = xxhRound(v3, loadRaw<uint64_t>(p + 16));
+            v4 = xxhRound(v4, loadRaw<uint64_t>(p + 24));
+        }
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        hash = xxhMerge(hash, v1);
+        hash = xxhMerge(hash, v2);
+        hash = xxhMerge(hash, v3);
+        hash = xxhMerge(hash, v4);
+    } else {
+        hash = XXH_PRIME64_5;
+    }
+    
+    hash += static_cast<uint64_t>(size);
+    for (; end - p >= 8; p += 8) {
+        hash ^= xxhRound(0, loadRaw<uint64_t>(p));
+        hash = rotateLeft(hash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+    if (end - p >= 4) {
+        hash ^= static_cast<uint64_t>(loadRaw<uint32_t>(p)) * XXH_PRIME64_1;
+        hash = rotateLeft(hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= static_cast<uint64_t>(*p) * XXH_PRIME64_5;
+        hash = rotateLeft(hash, 11) * XXH_PRIME64_1;
+    }
+    
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+template<typename T>
+uint64_t arrayChecksum(const std::vector<T>& values)
+{
+    return archiveChecksum(reinterpret_cast<const uint8_t*>(values.data()), values.size() * sizeof(T));
+}
+
+// Locate the footer of the last completed save. An interrupted append
+// leaves partial data after it, so footers are searched from the end back
+// until one's table of contents verifies.
+bool findArchiveFooter(const uint8_t* data, size_t size, uint64_t& tocOffset, uint64_t& tocEnd)
+{
+    const size_t headerSize = 2 * sizeof(uint32_t);
+    if (size < headerSize + ARCHIVE_FOOTER_SIZE) {
+        return false;
+    }
+    
+    for (size_t footer = size - ARCHIVE_FOOTER_SIZE; footer >= headerSize; footer--) {
+        if (loadRaw<uint32_t>(data + footer + 16) != SimpleArchive::ARCHIVE_TOC_MAGIC) continue;
+        const uint64_t offset = loadRaw<uint64_t>(data + footer);
+        if (offset < headerSize || offset > footer) continue;
+        if (archiveChecksum(data + offset, footer - offset) != loadRaw<uint64_t>(data + footer + 8)) continue;
+        tocOffset = offset;
+        tocEnd = footer;
+        return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
 NativeFormat::NativeFormat()
 {
 }
@@ -80,61 +437,202 @@ NativeFormat::~NativeFormat()
 {
 }
 
-bool NativeFormat::saveProject(const Project& project, const std::string& filename)
+bool NativeFormat::saveProject(Project& project, const std::string& filename)
 {
     m_errorMessage.clear();
     
     try {
-        std::vector<SimpleArchive::Entry> entries;
+        // Each entry of the new archive either carries fresh data or refers
+        // to an unchanged entry of the project's current archive
+        struct PendingEntry {
+            std::string name;
+            std::vector<uint8_t> data;
+            const ArchiveReader::EntryInfo* source = nullptr;
+        };
+        std::vector<PendingEntry> entries;
+        
+        const ArchiveReader* previous =
+            project.archive && project.archive->isOpen() ? project.archive.get() : nullptr;
         
         // Create manifest JSON
         std::string manifest = createManifestJSON(project);
-        SimpleArchive::Entry manifestEntry;
-        manifestEntry.name = "manifest.json";
-        manifestEntry.data = std::vector<uint8_t>(manifest.begin(), manifest.end());
-        entries.push_back(manifestEntry);
+        entries.push_back({"manifest.json", std::vector<uint8_t>(manifest.begin(), manifest.end()), nullptr});
+        
+        // Stored surfaces by body (unloaded bodies have no faces to enumerate)
+        std::unordered_map<size_t, std::vector<std::pair<size_t, const ArchiveReader::EntryInfo*>>> storedSurfaces;
+        if (previous) {
+            for (const auto& info : previous->entries()) {
+                size_t body = 0, face = 0;
+                if (std::sscanf(info.name.c_str(), "surfaces/body_%zu_face_%zu.bin", &body, &face) == 2) {
+                    storedSurfaces[body].emplace_back(face, &info);
+                }
+            }
+        }
         
         // Serialize bodies
+        std::vector<uint64_t> bodyHashes(project.bodies.size(), 0);
+        std::vector<uint64_t> sketchHashes(project.sketches.size(), 0);
         for (size_t i = 0; i < project.bodies.size(); i++) {
+            // Bodies that were never loaded, or whose content still matches
+            // the stored data, are carried over without re-serializing them
+            const bool loaded = isBodyLoaded(project, i);
+            if (loaded) {
+                bodyHashes[i] = contentHash(*project.bodies[i]);
+            }
+            if (previous && project.bodies[i]->archiveIndex >= 0 &&
+                (!loaded || bodyHashes[i] == project.bodies[i]->storedHash)) {
+                const size_t stored = static_cast<size_t>(project.bodies[i]->archiveIndex);
+                if (const auto* info = previous->find(meshEntryName(stored))) {
+                    entries.push_back({meshEntryName(i), {}, info});
+                }
+                auto it = storedSurfaces.find(stored);
+                if (it != storedSurfaces.end()) {
+                    for (const auto& [face, info] : it->second) {
+                        entries.push_back({surfaceEntryName(i, face), {}, info});
+                    }
+                }
+                continue;
+            }
+            
+            // A body without stored data must be complete before it is written
+            if (!loaded) {
+                if (!loadBody(project, i)) {
+                    return false;
+                }
+                bodyHashes[i] = contentHash(*project.bodies[i]);
+            }
             const auto& body = project.bodies[i];
             
             // Mesh data
             auto meshData = serializeMeshData(body->combinedMesh);
             if (!meshData.empty()) {
-                SimpleArchive::Entry meshEntry;
-                meshEntry.name = "meshes/body_" + std::to_string(i) + ".bin";
-                meshEntry.data = meshData;
-                entries.push_back(meshEntry);
+                entries.push_back({meshEntryName(i), std::move(meshData), nullptr});
             }
             
             // Surface data for each face
             for (size_t j = 0; j < body->faces.size(); j++) {
                 const auto& face = body->faces[j];
                 if (face->surface) {
-                    auto surfData = serializeSurfaceData(*face->surface);
-                    SimpleArchive::Entry surfEntry;
-                    surfEntry.name = "surfaces/body_" + std::to_string(i) + "_face_" + std::to_string(j) + ".bin";
-                    surfEntry.data = surfData;
-                    entries.push_back(surfEntry);
+                    entries.push_back({surfaceEntryName(i, j), serializeSurfaceData(*face->surface), nullptr});
                 }
             }
         }
         
         // Serialize sketches
         for (size_t i = 0; i < project.sketches.size(); i++) {
-            auto sketchData = serializeSketchData(*project.sketches[i]);
-            SimpleArchive::Entry sketchEntry;
-            sketchEntry.name = "sketches/sketch_" + std::to_string(i) + ".bin";
-            sketchEntry.data = sketchData;
-            entries.push_back(sketchEntry);
+            const bool loaded = i >= project.sketchLoaded.size() || project.sketchLoaded[i];
+            std::vector<uint8_t> sketchData;
+            if (loaded) {
+                sketchData = serializeSketchData(*project.sketches[i]);
+                sketchHashes[i] = archiveChecksum(sketchData.data(), sketchData.size());
+            }
+            if (previous && project.sketches[i]->archiveIndex >= 0 &&
+                (!loaded || sketchHashes[i] == project.sketches[i]->storedHash)) {
+                const size_t stored = static_cast<size_t>(project.sketches[i]->archiveIndex);
+                if (const auto* info = previous->find(sketchEntryName(stored))) {
+                    entries.push_back({sketchEntryName(i), {}, info});
+                }
+                continue;
+            }
+            
+            if (!loaded) {
+                if (!loadSketch(project, i)) {
+                    return false;
+                }
+                sketchData = serializeSketchData(*project.sketches[i]);
+                sketchHashes[i] = archiveChecksum(sketchData.data(), sketchData.size());
+            }
+            entries.push_back({sketchEntryName(i), std::move(sketchData), nullptr});
         }
         
-        // Write archive
-        SimpleArchive archive;
-        if (!archive.write(filename, entries)) {
-            m_errorMessage = "Failed to write archive file";
+        // Append to the current archive unless that would leave it mostly dead space
+        uint64_t liveBytes = 0;
+        uint64_t newBytes = 0;
+        for (const auto& entry : entries) {
+            liveBytes += entry.source ? entry.source->size : entry.data.size();
+            if (!entry.source) newBytes += entry.data.size();
+        }
+        std::error_code ec;
+        const bool sameFile = previous && std::filesystem::equivalent(previous->filename(), filename, ec);
+        const bool incremental = sameFile && previous->hasChecksums() &&
+            static_cast<double>(previous->fileSize() + newBytes) <=
+                ARCHIVE_COMPACTION_RATIO * static_cast<double>(liveBytes);
+        
+        if (incremental) {
+            ArchiveWriter writer;
+            if (!writer.append(filename)) {
+                m_errorMessage = "Failed to open archive file for writing";
+                return false;
+            }
+            for (const auto& entry : entries) {
+                if (entry.source) {
+                    writer.keep(*entry.source, entry.name);
+                } else if (!writer.add(entry.name, entry.data)) {
+                    m_errorMessage = "Failed to write archive file";
+                    return false;
+                }
+            }
+            if (!writer.finish()) {
+                m_errorMessage = "Failed to write archive file";
+                return false;
+            }
+        } else {
+            // Write beside the target and rename over it: the current archive
+            // stays readable while unchanged entries are copied out of it, and
+            // a failed save leaves the previous file intact
+            const std::string tempName = filename + ".tmp";
+            ArchiveWriter writer;
+            if (!writer.create(tempName)) {
+                m_errorMessage = "Failed to write archive file";
+                return false;
+            }
+            std::vector<uint8_t> copied;
+            std::string error;
+            for (const auto& entry : entries) {
+                if (entry.source && !previous->read(entry.source->name, copied, &error)) {
+                    m_errorMessage = error;
+                    return false;
+                }
+                if (!writer.add(entry.name, entry.source ? copied : entry.data)) {
+                    m_errorMessage = "Failed to write archive file";
+                    return false;
+                }
+            }
+            if (!writer.finish()) {
+                m_errorMessage = "Failed to write archive file";
+                return false;
+            }
+            entries.clear();
+            
+            // The old mapping has to go before the file under it is replaced
+            std::string previousName = previous ? previous->filename() : std::string();
+            if (project.archive) project.archive->close();
+            std::filesystem::rename(tempName, filename, ec);
+            if (ec) {
+                m_errorMessage = "Failed to replace " + filename + ": " + ec.message();
+                std::filesystem::remove(tempName, ec);
+                if (project.archive && !previousName.empty()) project.archive->open(previousName);
+                return false;
+            }
+        }
+        
+        // Track the saved file: everything in the project is now stored there
+        auto archive = std::make_shared<ArchiveReader>();
+        std::string error;
+        if (!archive->open(filename, &error)) {
+            m_errorMessage = "Saved, but failed to reopen archive file: " + error;
             return false;
         }
+        project.archive = std::move(archive);
+        for (size_t i = 0; i < project.bodies.size(); i++) {
+            project.bodies[i]->archiveIndex = static_cast<int>(i);
+            project.bodies[i]->storedHash = bodyHashes[i];
+        }
+        for (size_t i = 0; i < project.sketches.size(); i++) {
+            project.sketches[i]->archiveIndex = static_cast<int>(i);
+            project.sketches[i]->storedHash = sketchHashes[i];
+        }
+        project.filePath = filename;
         
         return true;
     }
@@ -145,72 +643,203 @@ bool NativeFormat::saveProject(const Project& project, const std::string& filena
 }
 
 std::shared_ptr<Project> NativeFormat::loadProject(const std::string& filename)
+{
+    auto project = openProject(filename);
+    if (!project) {
+        return nullptr;
+    }
+    
+    for (size_t i = 0; i < project->bodies.size(); i++) {
+        if (!loadBody(*project, i)) {
+            return nullptr;
+        }
+    }
+    for (size_t i = 0; i < project->sketches.size(); i++) {
+        if (!loadSketch(*project, i)) {
+            return nullptr;
+        }
+    }
+    
+    // The archive stays mapped so the next save can skip unmodified parts
+    return project;
+}
+
+std::shared_ptr<Project> NativeFormat::openProject(const std::string& filename)
 {
     m_errorMessage.clear();
     
     try {
-        // Read archive
-        SimpleArchive archive;
-        std::vector<SimpleArchive::Entry> entries;
-        
-        if (!archive.read(filename, entries)) {
-            m_errorMessage = "Failed to read archive file";
+        auto archive = std::make_shared<ArchiveReader>();
+        std::string error;
+        if (!archive->open(filename, &error)) {
+            m_errorMessage = "Failed to read archive file: " + error;
             return nullptr;
         }
         
         auto project = std::make_shared<Project>();
         project->filePath = filename;
         
-        // Find and parse manifest
-        for (const auto& entry : entries) {
-            if (entry.name == "manifest.json") {
-                std::string json(entry.data.begin(), entry.data.end());
-                if (!parseManifestJSON(json, *project)) {
-                    return nullptr;
-                }
-                break;
+        // Parse manifest
+        std::vector<uint8_t> manifest;
+        if (archive->read("manifest.json", manifest, &error)) {
+            std::string json(manifest.begin(), manifest.end());
+            if (!parseManifestJSON(json, *project)) {
+                return nullptr;
             }
         }
         
-        // Load mesh data
-        std::map<std::string, std::vector<uint8_t>> dataMap;
-        for (const auto& entry : entries) {
-            dataMap[entry.name] = entry.data;
+        project->archive = std::move(archive);
+        project->bodyLoaded.assign(project->bodies.size(), false);
+        project->sketchLoaded.assign(project->sketches.size(), false);
+        // Content hashes are recorded as the parts are loaded
+        for (size_t i = 0; i < project->bodies.size(); i++) {
+            project->bodies[i]->archiveIndex = static_cast<int>(i);
+        }
+        for (size_t i = 0; i < project->sketches.size(); i++) {
+            project->sketches[i]->archiveIndex = static_cast<int>(i);
+        }
+        return project;
+    }
+    catch (const std::exception& e) {
+        m_errorMessage = std::string("Load error: ") + e.what();
+        return nullptr;
+    }
+}
+
+bool NativeFormat::loadBody(Project& project, size_t index)
+{
+    m_errorMessage.clear();
+    
+    if (index >= project.bodies.size()) {
+        m_errorMessage = "Body index " + std::to_string(index) + " out of range";
+        return false;
+    }
+    if (isBodyLoaded(project, index)) {
+        return true;
+    }
+    if (!project.archive) {
+        m_errorMessage = "Project archive is not open";
+        return false;
+    }
+    
+    try {
+        auto& body = project.bodies[index];
+        std::vector<uint8_t> data;
+        std::string error;
+        
+        // Bodies may have been reordered since the archive was written
+        if (body->archiveIndex < 0) {
+            project.bodyLoaded[index] = true;
+            return true;
         }
+        const size_t stored = static_cast<size_t>(body->archiveIndex);
         
-        // Load body meshes
-        for (size_t i = 0; i < project->bodies.size(); i++) {
-            std::string meshName = "meshes/body_" + std::to_string(i) + ".bin";
-            auto it = dataMap.find(meshName);
-            if (it != dataMap.end()) {
-                project->bodies[i]->combinedMesh = deserializeMeshData(it->second);
+        // Missing entries are not errors: the body simply has no such data
+        std::string meshName = meshEntryName(stored);
+        if (project.archive->find(meshName)) {
+            if (!project.archive->read(meshName, data, &error)) {
+                m_errorMessage = error;
+                return false;
             }
-            
-            // Load face surfaces
-            for (size_t j = 0; j < project->bodies[i]->faces.size(); j++) {
-                std::string surfName = "surfaces/body_" + std::to_string(i) + "_face_" + std::to_string(j) + ".bin";
-                auto surfIt = dataMap.find(surfName);
-                if (surfIt != dataMap.end()) {
-                    project->bodies[i]->faces[j]->surface = deserializeSurfaceData(surfIt->second);
+            body->combinedMesh = deserializeMeshData(data);
+        }
+        
+        for (size_t j = 0; j < body->faces.size(); j++) {
+            std::string surfName = surfaceEntryName(stored, j);
+            if (project.archive->find(surfName)) {
+                if (!project.archive->read(surfName, data, &error)) {
+                    m_errorMessage = error;
+                    return false;
                 }
+                body->faces[j]->surface = deserializeSurfaceData(data);
             }
         }
         
-        // Load sketches
-        for (size_t i = 0; i < project->sketches.size(); i++) {
-            std::string sketchName = "sketches/sketch_" + std::to_string(i) + ".bin";
-            auto it = dataMap.find(sketchName);
-            if (it != dataMap.end()) {
-                project->sketches[i] = deserializeSketchData(it->second);
+        body->storedHash = contentHash(*body);
+        project.bodyLoaded[index] = true;
+        return true;
+    }
+    catch (const std::exception& e) {
+        m_errorMessage = std::string("Load error: ") + e.what();
+        return false;
+    }
+}
+
+bool NativeFormat::loadSketch(Project& project, size_t index)
+{
+    m_errorMessage.clear();
+    
+    if (index >= project.sketches.size()) {
+        m_errorMessage = "Sketch index " + std::to_string(index) + " out of range";
+        return false;
+    }
+    if (index < project.sketchLoaded.size() && project.sketchLoaded[index]) {
+        return true;
+    }
+    if (!project.archive) {
+        m_errorMessage = "Project archive is not open";
+        return false;
+    }
+    
+    try {
+        const int stored = project.sketches[index]->archiveIndex;
+        std::string sketchName = stored >= 0 ? sketchEntryName(static_cast<size_t>(stored)) : std::string();
+        if (stored >= 0 && project.archive->find(sketchName)) {
+            std::vector<uint8_t> data;
+            std::string error;
+            if (!project.archive->read(sketchName, data, &error)) {
+                m_errorMessage = error;
+                return false;
             }
+            auto sketch = deserializeSketchData(data);
+            sketch->archiveIndex = stored;
+            sketch->storedHash = contentHash(*sketch);
+            project.sketches[index] = sketch;
         }
         
-        return project;
+        project.sketchLoaded[index] = true;
+        return true;
     }
     catch (const std::exception& e) {
         m_errorMessage = std::string("Load error: ") + e.what();
-        return nullptr;
+        return false;
+    }
+}
+
+bool NativeFormat::isBodyLoaded(const Project& project, size_t index)
+{
+    // Projects that were never lazily opened are fully in memory
+    if (index >= project.bodyLoaded.size()) {
+        return index < project.bodies.size();
+    }
+    return project.bodyLoaded[index];
+}
+
+uint64_t NativeFormat::contentHash(const Body& body)
+{
+    // Covers what saveProject() stores for the body; names and colors are in the manifest
+    const MeshData& mesh = body.combinedMesh;
+    uint64_t hash = arrayChecksum(mesh.vertices);
+    hash = xxhMerge(hash, arrayChecksum(mesh.normals));
+    hash = xxhMerge(hash, arrayChecksum(mesh.texCoords));
+    hash = xxhMerge(hash, arrayChecksum(mesh.indices));
+    const glm::vec3 bounds[2] = {mesh.boundingBoxMin, mesh.boundingBoxMax};
+    hash = xxhMerge(hash, archiveChecksum(reinterpret_cast<const uint8_t*>(bounds), sizeof(bounds)));
+    
+    for (size_t j = 0; j < body.faces.size(); j++) {
+        if (body.faces[j]->surface) {
+            auto data = serializeSurfaceData(*body.faces[j]->surface);
+            hash = xxhMerge(hash, j);
+            hash = xxhMerge(hash, archiveChecksum(data.data(), data.size()));
+        }
     }
+    return hash;
+}
+
+uint64_t NativeFormat::contentHash(const Sketch& sketch)
+{
+    auto data = serializeSketchData(sketch);
+    return archiveChecksum(data.data(), data.size());
 }
 
 bool NativeFormat::isValidDCAFile(const std::string& filename)
@@ -221,53 +850,50 @@ bool NativeFormat::isValidDCAFile(const std::string& filename)
     uint32_t magic;
     file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
     
-    return magic == SimpleArchive::ARCHIVE_MAGIC || magic == DCA_MAGIC_NUMBER;
+    return magic == SimpleArchive::ARCHIVE_MAGIC || magic == SimpleArchive::ARCHIVE_TOC_MAGIC ||
+           magic == DCA_MAGIC_NUMBER;
 }
 
 NativeFormat::FileInfo NativeFormat::getFileInfo(const std::string& filename)
 {
-    FileInfo info;
+    FileInfo info{};
     
     try {
-        SimpleArchive archive;
-        std::vector<SimpleArchive::Entry> entries;
-        
-        if (!archive.read(filename, entries)) {
+        // Only the table of contents and the manifest are read
+        ArchiveReader archive;
+        if (!archive.open(filename)) {
             return info;
         }
         
         // Find manifest
-        for (const auto& entry : entries) {
-            if (entry.name == "manifest.json") {
-                // Simple JSON parsing for basic info
-                std::string json(entry.data.begin(), entry.data.end());
-                
-                // MEDIUM FIX: Safe JSON string extraction with npos checks
-                auto safeExtractString = [&json](const std::string& key) -> std::string {
-                    size_t pos = json.find("\"" + key + "\"");
-                    if (pos == std::string::npos) return "";
-                    pos = json.find(":", pos);
-                    if (pos == std::string::npos) return "";
-                    size_t start = json.find("\"", pos);
-                    if (start == std::string::npos) return "";
-                    start++;  // Move past the opening quote
-                    size_t end = json.find("\"", start);
-                    if (end == std::string::npos) return "";
-                    return json.substr(start, end - start);
-                };
-                
-                // Extract name
-                info.name = safeExtractString("name");
-                
-                // Extract author
-                info.author = safeExtractString("author");
-                
-                break;
-            }
+        std::vector<uint8_t> manifest;
+        if (archive.read("manifest.json", manifest)) {
+            // Simple JSON parsing for basic info
+            std::string json(manifest.begin(), manifest.end());
+            
+            // MEDIUM FIX: Safe JSON string extraction with npos checks
+            auto safeExtractString = [&json](const std::string& key) -> std::string {
+                size_t pos = json.find("\"" + key + "\"");
+                if (pos == std::string::npos) return "";
+                pos = json.find(":", pos);
+                if (pos == std::string::npos) return "";
+                size_t start = json.find("\"", pos);
+                if (start == std::string::npos) return "";
+                start++;  // Move past the opening quote
+                size_t end = json.find("\"", start);
+                if (end == std::string::npos) return "";
+                return json.substr(start, end - start);
+            };
+            
+            // Extract name
+            info.name = safeExtractString("name");
+            
+            // Extract author
+            info.author = safeExtractString("author");
         }
         
         // Count bodies and sketches
-        for (const auto& entry : entries) {
+        for (const auto& entry : archive.entries()) {
             if (entry.name.find("meshes/body_") == 0) info.bodyCount++;
             if (entry.name.find("sketches/sketch_") == 0) info.sketchCount++;
         }
@@ -397,20 +1023,36 @@ bool NativeFormat::parseManifestJSON(const std::string& json, Project& project)
     project.settings.modifiedDate = extractString("modifiedDate");
     project.settings.appVersion = extractString("appVersion");
     
-    // Count bodies and sketches (simplified - count array elements)
-    size_t bodiesStart = json.find("\"bodies\"");
-    size_t bodiesEnd = json.find("]", bodiesStart);
-    size_t bodyCount = 0;
-    for (size_t i = bodiesStart; i < bodiesEnd; i++) {
-        if (json[i] == '{') bodyCount++;
-    }
+    // Count bodies and sketches: objects directly inside each array
+    // (nested arrays such as colors must not end the scan early)
+    auto countArrayObjects = [&json](const std::string& key) -> size_t {
+        size_t pos = json.find("\"" + key + "\"");
+        if (pos == std::string::npos) return 0;
+        pos = json.find("[", pos);
+        if (pos == std::string::npos) return 0;
+        size_t count = 0;
+        int depth = 0;
+        bool inString = false;
+        for (size_t i = pos; i < json.length(); i++) {
+            char c = json[i];
+            if (inString) {
+                if (c == '\\') i++;
+                else if (c == '"') inString = false;
+                continue;
+            }
+            if (c == '"') inString = true;
+            else if (c == '[' || c == '{') {
+                if (c == '{' && depth == 1) count++;
+                depth++;
+            } else if (c == ']' || c == '}') {
+                if (--depth == 0) break;
+            }
+        }
+        return count;
+    };
     
-    size_t sketchesStart = json.find("\"sketches\"");
-    size_t sketchesEnd = json.find("]", sketchesStart);
-    size_t sketchCount = 0;
-    for (size_t i = sketchesStart; i < sketchesEnd; i++) {
-        if (json[i] == '{') sketchCount++;
-    }
+    size_t bodyCount = countArrayObjects("bodies");
+    size_t sketchCount = countArrayObjects("sketches");
     
     // Create placeholder bodies and sketches
     for (size_t i = 0; i < bodyCount; i++) {
@@ -426,6 +1068,16 @@ bool NativeFormat::parseManifestJSON(const std::string& json, Project& project)
 
 std::vector<uint8_t> NativeFormat::serializeMeshData(const MeshData& mesh)
 {
+    // Compressed chunks are only kept when they beat the raw layout
+    if (m_meshCompression.enabled) {
+        size_t rawSize = 4 * 5 + mesh.vertices.size() * 12 + mesh.normals.size() * 12 +
+                         mesh.texCoords.size() * 8 + mesh.indices.size() * 4 + 24;
+        auto compressed = compressMeshData(mesh);
+        if (!compressed.empty() && compressed.size() < rawSize) {
+            return compressed;
+        }
+    }
+    
     std::vector<uint8_t> buffer;
     
     // Chunk header
@@ -435,28 +1087,19 @@ std::vector<uint8_t> NativeFormat::serializeMeshData(const MeshData& mesh)
     writeUint32(buffer, mesh.vertices.size());
     
     // Write vertices
-    for (const auto& v : mesh.vertices) {
-        writeVec3(buffer, v);
-    }
+    writeWords(buffer, mesh.vertices.data(), mesh.vertices.size() * 3);
     
     // Write normals
     writeUint32(buffer, mesh.normals.size());
-    for (const auto& n : mesh.normals) {
-        writeVec3(buffer, n);
-    }
+    writeWords(buffer, mesh.normals.data(), mesh.normals.size() * 3);
     
     // Write texture coordinates
     writeUint32(buffer, mesh.texCoords.size());
-    for (const auto& tc : mesh.texCoords) {
-        writeFloat(buffer, tc.x);
-        writeFloat(buffer, tc.y);
-    }
+    writeWords(buffer, mesh.texCoords.data(), mesh.texCoords.size() * 2);
     
     // Write indices
     writeUint32(buffer, mesh.indices.size());
-    for (uint32_t idx : mesh.indices) {
-        writeUint32(buffer, idx);
-    }
+    writeWords(buffer, mesh.indices.data(), mesh.indices.size());
     
     // Bounding box
     writeVec3(buffer, mesh.boundingBoxMin);
@@ -470,41 +1113,255 @@ MeshData NativeFormat::deserializeMeshData(const std::vector<uint8_t>& data)
     MeshData mesh;
     size_t offset = 0;
     
-    // Skip chunk header
+    // Chunk header
     uint32_t chunkType = readUint32(data, offset);
+    if (chunkType == static_cast<uint32_t>(DCAChunkType::MESH_COMPRESSED)) {
+        return decompressMeshData(data);
+    }
+    
+    // Array of 32-bit words preceded by its element count
+    auto readArray = [&](auto& array, size_t wordsPerElement) {
+        uint32_t count = readUint32(data, offset);
+        if (count > (data.size() - offset) / (4 * wordsPerElement)) {
+            throw std::runtime_error("Buffer underflow in deserializeMeshData: " +
+                std::to_string(count) + " elements at offset " + std::to_string(offset) +
+                " exceed size " + std::to_string(data.size()));
+        }
+        array.resize(count);
+        readWords(data, offset, array.data(), count * wordsPerElement);
+    };
+    
+    readArray(mesh.vertices, 3);
+    readArray(mesh.normals, 3);
+    readArray(mesh.texCoords, 2);
+    readArray(mesh.indices, 1);
     
-    // Read vertices
+    // Bounding box
+    mesh.boundingBoxMin = readVec3(data, offset);
+    mesh.boundingBoxMax = readVec3(data, offset);
+    
+    return mesh;
+}
+
+std::vector<uint8_t> NativeFormat::compressMeshData(const MeshData& mesh)
+{
+    const MeshCompressionOptions& options = m_meshCompression;
+    const int level = std::clamp(options.level, 1, 9);
+    std::vector<uint8_t> buffer;
+    
+    writeUint32(buffer, static_cast<uint32_t>(DCAChunkType::MESH_COMPRESSED));
+    writeUint32(buffer, mesh.vertices.size());
+    writeUint32(buffer, mesh.normals.size());
+    writeUint32(buffer, mesh.texCoords.size());
+    writeUint32(buffer, mesh.indices.size());
+    writeVec3(buffer, mesh.boundingBoxMin);
+    writeVec3(buffer, mesh.boundingBoxMax);
+    
+    // Positions: integer grid of the tolerance, or exact floats
+    const glm::vec3* vertices = mesh.vertices.data();
+    const double step = 2.0 * static_cast<double>(options.positionTolerance);
+    glm::vec3 origin(0.0f);
+    bool quantize = step > 0.0 && !mesh.vertices.empty();
+    if (quantize) {
+        using Bounds = std::pair<glm::vec3, glm::vec3>;
+        Bounds bounds = dc3d::core::parallelReduce(size_t(0), mesh.vertices.size(),
+            Bounds(glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest())),
+            [&](size_t begin, size_t end) {
+                Bounds b(vertices[begin], vertices[begin]);
+                for (size_t i = begin + 1; i < end; i++) {
+                    b.first = glm::min(b.first, vertices[i]);
+                    b.second = glm::max(b.second, vertices[i]);
+                }
+                return b;
+            },
+            [](const Bounds& a, const Bounds& b) {
+                return Bounds(glm::min(a.first, b.first), glm::max(a.second, b.second));
+            });
+        origin = bounds.first;
+        for (int axis = 0; axis < 3; axis++) {
+            double cells = (static_cast<double>(bounds.second[axis]) - origin[axis]) / step;
+            if (!std::isfinite(cells) || cells >= MAX_QUANTIZED_CELLS) {
+                quantize = false;  // Tolerance too fine for the extent: keep floats
+            }
+        }
+    }
+    
+    writeUint32(buffer, quantize ? POSITIONS_QUANTIZED : POSITIONS_FLOAT);
+    writeVec3(buffer, origin);
+    writeDouble(buffer, step);
+    if (quantize) {
+        writeBlockStream(buffer, mesh.vertices.size(), 12, level,
+            [&](size_t first, size_t last, std::vector<uint8_t>& out) {
+                int64_t previous[3] = {0, 0, 0};
+                for (size_t i = first; i < last; i++) {
+                    for (int axis = 0; axis < 3; axis++) {
+                        int64_t cell = std::llround((static_cast<double>(vertices[i][axis]) - origin[axis]) / step);
+                        putVarint(out, zigzag(cell - previous[axis]));
+                        previous[axis] = cell;
+                    }
+                }
+            });
+    } else {
+        writeBlockStream(buffer, mesh.vertices.size(), 12, level,
+            [&](size_t first, size_t last, std::vector<uint8_t>& out) {
+                putBytePlanes(out, vertices + first, (last - first) * 3);
+            });
+    }
+    
+    // Normals: octahedral 2x16-bit, or exact floats
+    const glm::vec3* normals = mesh.normals.data();
+    const bool octahedral = options.octahedralNormals;
+    writeUint32(buffer, octahedral ? NORMALS_OCTAHEDRAL : NORMALS_FLOAT);
+    if (octahedral) {
+        writeBlockStream(buffer, mesh.normals.size(), 12, level,
+            [&](size_t first, size_t last, std::vector<uint8_t>& out) {
+                int64_t previous[2] = {0, 0};
+                for (size_t i = first; i < last; i++) {
+                    glm::vec2 encoded = octahedralEncode(normals[i]);
+                    for (int k = 0; k < 2; k++) {
+                        int64_t value = std::lround(std::clamp(encoded[k], -1.0f, 1.0f) * OCTAHEDRAL_SCALE);
+                        putVarint(out, zigzag(value - previous[k]));
+                        previous[k] = value;
+                    }
+                }
+            });
+    } else {
+        writeBlockStream(buffer, mesh.normals.size(), 12, level,
+            [&](size_t first, size_t last, std::vector<uint8_t>& out) {
+                putBytePlanes(out, normals + first, (last - first) * 3);
+            });
+    }
+    
+    // Texture coordinates: exact floats
+    const glm::vec2* texCoords = mesh.texCoords.data();
+    writeBlockStream(buffer, mesh.texCoords.size(), 8, level,
+        [&](size_t first, size_t last, std::vector<uint8_t>& out) {
+            putBytePlanes(out, texCoords + first, (last - first) * 2);
+        });
+    
+    // Indices: recently used vertices by cache slot, new ones by distance
+    // from the next unused vertex; both are one byte on well-ordered meshes
+    const uint32_t* indices = mesh.indices.data();
+    writeBlockStream(buffer, mesh.indices.size(), 4, level,
+        [&](size_t first, size_t last, std::vector<uint8_t>& out) {
+            IndexCache cache;
+            for (size_t i = first; i < last; i++) {
+                size_t slot = cache.find(indices[i]);
+                if (slot < INDEX_CACHE_SIZE) {
+                    putVarint(out, slot);
+                } else {
+                    putVarint(out, INDEX_CACHE_SIZE + zigzag(static_cast<int64_t>(indices[i]) - cache.next));
+                }
+                cache.use(slot, indices[i]);
+            }
+        });
+    
+    return buffer;
+}
+
+MeshData NativeFormat::decompressMeshData(const std::vector<uint8_t>& data)
+{
+    MeshData mesh;
+    size_t offset = 0;
+    
+    readUint32(data, offset);  // Skip chunk header
     uint32_t vertexCount = readUint32(data, offset);
+    uint32_t normalCount = readUint32(data, offset);
+    uint32_t texCoordCount = readUint32(data, offset);
+    uint32_t indexCount = readUint32(data, offset);
+    mesh.boundingBoxMin = readVec3(data, offset);
+    mesh.boundingBoxMax = readVec3(data, offset);
+    
+    // Positions
+    uint32_t positionCoding = readUint32(data, offset);
+    const glm::vec3 origin = readVec3(data, offset);
+    const double step = readDouble(data, offset);
     mesh.vertices.resize(vertexCount);
-    for (uint32_t i = 0; i < vertexCount; i++) {
-        mesh.vertices[i] = readVec3(data, offset);
+    glm::vec3* vertices = mesh.vertices.data();
+    if (positionCoding == POSITIONS_QUANTIZED) {
+        readBlockStream(data, offset, vertexCount,
+            [&](size_t first, size_t last, const uint8_t* in, const uint8_t* end) {
+                int64_t cell[3] = {0, 0, 0};
+                for (size_t i = first; i < last; i++) {
+                    for (int axis = 0; axis < 3; axis++) {
+                        uint64_t code;
+                        if (!getVarint(in, end, code)) return false;
+                        cell[axis] += unzigzag(code);
+                        vertices[i][axis] = static_cast<float>(origin[axis] + static_cast<double>(cell[axis]) * step);
+                    }
+                }
+                return in == end;
+            });
+    } else if (positionCoding == POSITIONS_FLOAT) {
+        readBlockStream(data, offset, vertexCount,
+            [&](size_t first, size_t last, const uint8_t* in, const uint8_t* end) {
+                return getBytePlanes(in, end, vertices + first, (last - first) * 3);
+            });
+    } else {
+        throw std::runtime_error("Unknown position encoding " + std::to_string(positionCoding));
     }
     
-    // Read normals
-    uint32_t normalCount = readUint32(data, offset);
+    // Normals
+    uint32_t normalCoding = readUint32(data, offset);
     mesh.normals.resize(normalCount);
-    for (uint32_t i = 0; i < normalCount; i++) {
-        mesh.normals[i] = readVec3(data, offset);
+    glm::vec3* normals = mesh.normals.data();
+    if (normalCoding == NORMALS_OCTAHEDRAL) {
+        readBlockStream(data, offset, normalCount,
+            [&](size_t first, size_t last, const uint8_t* in, const uint8_t* end) {
+                int64_t value[2] = {0, 0};
+                for (size_t i = first; i < last; i++) {
+                    for (int k = 0; k < 2; k++) {
+                        uint64_t code;
+                        if (!getVarint(in, end, code)) return false;
+                        value[k] += unzigzag(code);
+                    }
+                    normals[i] = octahedralDecode(glm::vec2(
+                        static_cast<float>(value[0]) / OCTAHEDRAL_SCALE,
+                        static_cast<float>(value[1]) / OCTAHEDRAL_SCALE));
+                }
+                return in == end;
+            });
+    } else if (normalCoding == NORMALS_FLOAT) {
+        readBlockStream(data, offset, normalCount,
+            [&](size_t first, size_t last, const uint8_t* in, const uint8_t* end) {
+                return getBytePlanes(in, end, normals + first, (last - first) * 3);
+            });
+    } else {
+        throw std::runtime_error("Unknown normal encoding " + std::to_string(normalCoding));
     }
     
-    // Read texture coordinates
-    uint32_t texCoordCount = readUint32(data, offset);
+    // Texture coordinates
     mesh.texCoords.resize(texCoordCount);
-    for (uint32_t i = 0; i < texCoordCount; i++) {
-        mesh.texCoords[i].x = readFloat(data, offset);
-        mesh.texCoords[i].y = readFloat(data, offset);
-    }
+    glm::vec2* texCoords = mesh.texCoords.data();
+    readBlockStream(data, offset, texCoordCount,
+        [&](size_t first, size_t last, const uint8_t* in, const uint8_t* end) {
+            return getBytePlanes(in, end, texCoords + first, (last - first) * 2);
+        });
     
-    // Read indices
-    uint32_t indexCount = readUint32(data, offset);
+    // Indices
     mesh.indices.resize(indexCount);
-    for (uint32_t i = 0; i < indexCount; i++) {
-        mesh.indices[i] = readUint32(data, offset);
-    }
-    
-    // Bounding box
-    mesh.boundingBoxMin = readVec3(data, offset);
-    mesh.boundingBoxMax = readVec3(data, offset);
+    uint32_t* indices = mesh.indices.data();
+    readBlockStream(data, offset, indexCount,
+        [&](size_t first, size_t last, const uint8_t* in, const uint8_t* end) {
+            IndexCache cache;
+            for (size_t i = first; i < last; i++) {
+                uint64_t code;
+                if (!getVarint(in, end, code)) return false;
+                size_t slot = INDEX_CACHE_SIZE;
+                uint32_t index;
+                if (code < INDEX_CACHE_SIZE) {
+                    slot = static_cast<size_t>(code);
+                    index = cache.slots[slot];
+                } else {
+                    int64_t value = cache.next + unzigzag(code - INDEX_CACHE_SIZE);
+                    if (value < 0 || value > UINT32_MAX) return false;
+                    index = static_cast<uint32_t>(value);
+                }
+                cache.use(slot, index);
+                indices[i] = index;
+            }
+            return in == end;
+        });
     
     return mesh;
 }
@@ -818,6 +1675,27 @@ void NativeFormat::writeString(std::vector<uint8_t>& buffer, const std::string&
     }
 }
 
+void NativeFormat::writeWords(std::vector<uint8_t>& buffer, const void* data, size_t count)
+{
+    // Bulk copy on little-endian hosts, byte by byte elsewhere
+    size_t offset = buffer.size();
+    buffer.resize(offset + count * 4);
+    if (count == 0) return;
+    uint8_t* out = buffer.data() + offset;
+    if (hostIsLittleEndian()) {
+        std::memcpy(out, data, count * 4);
+        return;
+    }
+    const uint8_t* in = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t word;
+        std::memcpy(&word, in + i * 4, 4);
+        for (int k = 0; k < 4; k++) {
+            out[i * 4 + k] = static_cast<uint8_t>(word >> (8 * k));
+        }
+    }
+}
+
 // Binary read helpers
 uint32_t NativeFormat::readUint32(const std::vector<uint8_t>& buffer, size_t& offset)
 {
@@ -865,20 +1743,19 @@ double NativeFormat::readDouble(const std::vector<uint8_t>& buffer, size_t& offs
 
 glm::vec3 NativeFormat::readVec3(const std::vector<uint8_t>& buffer, size_t& offset)
 {
-    return glm::vec3(
-        readFloat(buffer, offset),
-        readFloat(buffer, offset),
-        readFloat(buffer, offset)
-    );
+    // Sequenced reads: the evaluation order of constructor arguments is unspecified
+    float x = readFloat(buffer, offset);
+    float y = readFloat(buffer, offset);
+    float z = readFloat(buffer, offset);
+    return glm::vec3(x, y, z);
 }
 
 glm::dvec3 NativeFormat::readDVec3(const std::vector<uint8_t>& buffer, size_t& offset)
 {
-    return glm::dvec3(
-        readDouble(buffer, offset),
-        readDouble(buffer, offset),
-        readDouble(buffer, offset)
-    );
+    double x = readDouble(buffer, offset);
+    double y = readDouble(buffer, offset);
+    double z = readDouble(buffer, offset);
+    return glm::dvec3(x, y, z);
 }
 
 std::string NativeFormat::readString(const std::vector<uint8_t>& buffer, size_t& offset)
@@ -895,6 +1772,30 @@ std::string NativeFormat::readString(const std::vector<uint8_t>& buffer, size_t&
     return str;
 }
 
+void NativeFormat::readWords(const std::vector<uint8_t>& buffer, size_t& offset, void* data, size_t count)
+{
+    if (offset > buffer.size() || count > (buffer.size() - offset) / 4) {
+        throw std::runtime_error("Buffer underflow in readWords: offset " +
+            std::to_string(offset) + " + " + std::to_string(count) + " words > size " +
+            std::to_string(buffer.size()));
+    }
+    if (count == 0) return;
+    const uint8_t* in = buffer.data() + offset;
+    uint8_t* out = static_cast<uint8_t*>(data);
+    if (hostIsLittleEndian()) {
+        std::memcpy(out, in, count * 4);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t word = 0;
+            for (int k = 0; k < 4; k++) {
+                word |= static_cast<uint32_t>(in[i * 4 + k]) << (8 * k);
+            }
+            std::memcpy(out + i * 4, &word, 4);
+        }
+    }
+    offset += count * 4;
+}
+
 std::string NativeFormat::getCurrentTimestamp()
 {
     std::time_t now = std::time(nullptr);
@@ -913,70 +1814,340 @@ std::string NativeFormat::getCurrentTimestamp()
 // SimpleArchive implementation
 bool SimpleArchive::write(const std::string& filename, const std::vector<Entry>& entries)
 {
-    std::ofstream file(filename, std::ios::binary);
-    if (!file.is_open()) return false;
+    ArchiveWriter writer;
+    if (!writer.create(filename)) return false;
     
-    // Write magic number
-    uint32_t magic = ARCHIVE_MAGIC;
-    file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    for (const auto& entry : entries) {
+        if (!writer.add(entry.name, entry.data)) return false;
+    }
     
-    // Write entry count
-    uint32_t count = entries.size();
-    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    return writer.finish();
+}
+
+bool SimpleArchive::read(const std::string& filename, std::vector<Entry>& entries)
+{
+    ArchiveReader reader;
+    if (!reader.open(filename)) return false;
     
-    // Write entries
-    for (const auto& entry : entries) {
-        // Name length and name
-        uint32_t nameLen = entry.name.length();
-        file.write(reinterpret_cast<const char*>(&nameLen), sizeof(nameLen));
-        file.write(entry.name.c_str(), nameLen);
-        
-        // Data length and data
-        uint32_t dataLen = entry.data.size();
-        file.write(reinterpret_cast<const char*>(&dataLen), sizeof(dataLen));
-        if (!entry.data.empty()) {
-            file.write(reinterpret_cast<const char*>(entry.data.data()), dataLen);
+    for (const auto& info : reader.entries()) {
+        Entry entry;
+        entry.name = info.name;
+        if (!reader.read(info.name, entry.data)) return false;
+        entries.push_back(std::move(entry));
+    }
+    
+    return true;
+}
+
+// ArchiveWriter implementation
+ArchiveWriter::~ArchiveWriter()
+{
+    discard();
+}
+
+bool ArchiveWriter::create(const std::string& filename)
+{
+    discard();
+    
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) return false;
+    m_filename = filename;
+    m_appending = false;
+    m_initialSize = 0;
+    m_bytesAdded = 0;
+    m_entries.clear();
+    
+    // Header: magic number and layout version
+    uint32_t header[2] = {SimpleArchive::ARCHIVE_TOC_MAGIC, SimpleArchive::ARCHIVE_VERSION};
+    m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    m_offset = sizeof(header);
+    
+    if (m_file.fail()) {
+        discard();
+        return false;
+    }
+    return true;
+}
+
+bool ArchiveWriter::append(const std::string& filename)
+{
+    discard();
+    
+    // Only ARC2 archives can be extended. New data goes after the last
+    // complete save, dropping whatever an interrupted append left behind.
+    uint64_t size = 0;
+    {
+        dc3d::io::MappedFile in;
+        if (!in.open(filename)) return false;
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(in.data());
+        uint64_t tocOffset = 0;
+        uint64_t tocEnd = 0;
+        if (in.size() < sizeof(uint32_t) || loadRaw<uint32_t>(data) != SimpleArchive::ARCHIVE_TOC_MAGIC ||
+            !findArchiveFooter(data, in.size(), tocOffset, tocEnd)) {
+            return false;
+        }
+        size = tocEnd + ARCHIVE_FOOTER_SIZE;
+        if (size < in.size()) {
+            in.close();
+            // May fail while the file is mapped elsewhere (Windows); the
+            // leftover bytes then just stay after the new footer
+            std::error_code ec;
+            std::filesystem::resize_file(filename, size, ec);
         }
     }
     
+    m_file.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+    if (!m_file.is_open()) return false;
+    m_file.seekp(static_cast<std::streamoff>(size));
+    m_filename = filename;
+    m_appending = true;
+    m_initialSize = size;
+    m_offset = size;
+    m_bytesAdded = 0;
+    m_entries.clear();
+    
+    if (m_file.fail()) {
+        discard();
+        return false;
+    }
     return true;
 }
 
-bool SimpleArchive::read(const std::string& filename, std::vector<Entry>& entries)
+bool ArchiveWriter::add(const std::string& name, const std::vector<uint8_t>& data)
 {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open()) return false;
+    if (!m_file.is_open()) return false;
+    
+    ArchiveReader::EntryInfo entry;
+    entry.name = name;
+    entry.offset = m_offset;
+    entry.size = data.size();
+    entry.checksum = archiveChecksum(data.data(), data.size());
+    if (!data.empty()) {
+        m_file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (m_file.fail()) return false;
+    }
     
-    // Read and verify magic number
-    uint32_t magic;
-    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-    if (magic != ARCHIVE_MAGIC) return false;
+    m_offset += data.size();
+    m_bytesAdded += data.size();
+    m_entries.push_back(std::move(entry));
+    return true;
+}
+
+void ArchiveWriter::keep(const ArchiveReader::EntryInfo& entry, const std::string& name)
+{
+    ArchiveReader::EntryInfo kept = entry;
+    kept.name = name;
+    m_entries.push_back(std::move(kept));
+}
+
+bool ArchiveWriter::finish()
+{
+    if (!m_file.is_open()) return false;
+    
+    std::vector<uint8_t> toc;
+    appendRaw(toc, static_cast<uint32_t>(m_entries.size()));
+    for (const auto& entry : m_entries) {
+        appendRaw(toc, static_cast<uint32_t>(entry.name.length()));
+        toc.insert(toc.end(), entry.name.begin(), entry.name.end());
+        appendRaw(toc, entry.offset);
+        appendRaw(toc, entry.size);
+        appendRaw(toc, entry.checksum);
+    }
+    
+    // Table of contents, then the footer that locates it. The footer goes
+    // last, so an interrupted append never looks like a complete archive.
+    m_file.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size()));
+    std::vector<uint8_t> footer;
+    appendRaw(footer, m_offset);
+    appendRaw(footer, archiveChecksum(toc.data(), toc.size()));
+    appendRaw(footer, SimpleArchive::ARCHIVE_TOC_MAGIC);
+    m_file.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+    
+    m_file.close();
+    if (m_file.fail()) {
+        discard();
+        return false;
+    }
+    m_filename.clear();
+    m_entries.clear();
+    return true;
+}
+
+void ArchiveWriter::discard()
+{
+    if (m_filename.empty()) return;
     
-    // Read entry count
-    uint32_t count;
-    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_file.clear();
     
-    // Read entries
+    std::error_code ec;
+    if (m_appending) {
+        std::filesystem::resize_file(m_filename, m_initialSize, ec);
+    } else {
+        std::filesystem::remove(m_filename, ec);
+    }
+    m_filename.clear();
+    m_entries.clear();
+}
+
+// ArchiveReader implementation
+bool ArchiveReader::open(const std::string& filename, std::string* error)
+{
+    close();
+    
+    if (!m_file.open(filename, error)) {
+        return false;
+    }
+    m_filename = filename;
+    
+    bool ok = false;
+    if (m_file.size() >= sizeof(uint32_t)) {
+        uint32_t magic = loadRaw<uint32_t>(m_file.data());
+        if (magic == SimpleArchive::ARCHIVE_TOC_MAGIC) {
+            ok = parseTableOfContents(error);
+        } else if (magic == SimpleArchive::ARCHIVE_MAGIC) {
+            ok = parseLegacyEntries(error);
+        } else if (error) {
+            *error = "Not a .dca archive (unknown magic number)";
+        }
+    } else if (error) {
+        *error = "File is too small to be a .dca archive";
+    }
+    
+    if (!ok) {
+        close();
+        return false;
+    }
+    
+    m_index.reserve(m_entries.size());
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        m_index.emplace(m_entries[i].name, i);
+    }
+    return true;
+}
+
+void ArchiveReader::close()
+{
+    m_file.close();
+    m_filename.clear();
+    m_entries.clear();
+    m_index.clear();
+    m_hasChecksums = false;
+}
+
+const ArchiveReader::EntryInfo* ArchiveReader::find(const std::string& name) const
+{
+    auto it = m_index.find(name);
+    return it != m_index.end() ? &m_entries[it->second] : nullptr;
+}
+
+bool ArchiveReader::read(const std::string& name, std::vector<uint8_t>& data, std::string* error) const
+{
+    const EntryInfo* entry = find(name);
+    if (!entry) {
+        if (error) *error = "Archive has no entry \"" + name + "\"";
+        return false;
+    }
+    
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(m_file.data()) + entry->offset;
+    if (m_hasChecksums && archiveChecksum(begin, entry->size) != entry->checksum) {
+        if (error) *error = "Checksum mismatch in \"" + name + "\": the file is corrupted";
+        return false;
+    }
+    
+    data.assign(begin, begin + entry->size);
+    return true;
+}
+
+bool ArchiveReader::parseTableOfContents(std::string* error)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(m_file.data());
+    const size_t headerSize = 2 * sizeof(uint32_t);
+    
+    auto fail = [error](const std::string& message) {
+        if (error) *error = message;
+        return false;
+    };
+    
+    // Footer: table offset, table checksum, magic
+    uint64_t tocOffset = 0;
+    uint64_t tocEnd = 0;
+    if (!findArchiveFooter(data, m_file.size(), tocOffset, tocEnd)) {
+        return fail("Archive is truncated or corrupted (no valid table of contents)");
+    }
+    
+    const uint8_t* toc = data + tocOffset;
+    const size_t tocSize = static_cast<size_t>(tocEnd - tocOffset);
+    
+    size_t pos = 0;
+    auto take = [&](size_t bytes) {
+        if (bytes > tocSize - pos) return false;
+        pos += bytes;
+        return true;
+    };
+    
+    if (!take(4)) return fail("Archive table of contents is truncated");
+    uint32_t count = loadRaw<uint32_t>(toc);
+    m_entries.reserve(std::min<size_t>(count, tocSize / 28));
     for (uint32_t i = 0; i < count; i++) {
-        Entry entry;
-        
-        // Name
-        uint32_t nameLen;
-        file.read(reinterpret_cast<char*>(&nameLen), sizeof(nameLen));
-        entry.name.resize(nameLen);
-        file.read(&entry.name[0], nameLen);
-        
-        // Data
-        uint32_t dataLen;
-        file.read(reinterpret_cast<char*>(&dataLen), sizeof(dataLen));
-        entry.data.resize(dataLen);
-        if (dataLen > 0) {
-            file.read(reinterpret_cast<char*>(entry.data.data()), dataLen);
+        EntryInfo entry;
+        if (!take(4)) return fail("Archive table of contents is truncated");
+        uint32_t nameLen = loadRaw<uint32_t>(toc + pos - 4);
+        if (!take(nameLen)) return fail("Archive table of contents is truncated");
+        entry.name.assign(reinterpret_cast<const char*>(toc + pos - nameLen), nameLen);
+        if (!take(24)) return fail("Archive table of contents is truncated");
+        entry.offset = loadRaw<uint64_t>(toc + pos - 24);
+        entry.size = loadRaw<uint64_t>(toc + pos - 16);
+        entry.checksum = loadRaw<uint64_t>(toc + pos - 8);
+        if (entry.offset < headerSize || entry.offset > tocOffset || entry.size > tocOffset - entry.offset) {
+            return fail("Archive entry \"" + entry.name + "\" is out of range");
         }
+        m_entries.push_back(std::move(entry));
+    }
+    
+    m_hasChecksums = true;
+    return true;
+}
+
+bool ArchiveReader::parseLegacyEntries(std::string* error)
+{
+    // ARCH layout: magic, count, then (name length, name, data length, data) per entry
+    const char* data = m_file.data();
+    const size_t size = m_file.size();
+    size_t pos = sizeof(uint32_t);
+    
+    auto fail = [error]() {
+        if (error) *error = "Archive is truncated";
+        return false;
+    };
+    
+    if (size - pos < 4) return fail();
+    uint32_t count = loadRaw<uint32_t>(data + pos);
+    pos += 4;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        EntryInfo entry;
+        if (size - pos < 4) return fail();
+        uint32_t nameLen = loadRaw<uint32_t>(data + pos);
+        pos += 4;
+        if (size - pos < nameLen) return fail();
+        entry.name.assign(data + pos, nameLen);
+        pos += nameLen;
+        
+        if (size - pos < 4) return fail();
+        uint32_t dataLen = loadRaw<uint32_t>(data + pos);
+        pos += 4;
+        if (size - pos < dataLen) return fail();
+        entry.offset = pos;
+        entry.size = dataLen;
+        pos += dataLen;
         
-        entries.push_back(entry);
+        m_entries.push_back(std::move(entry));
     }
     
+    m_hasChecksums = false;
     return true;
 }
 
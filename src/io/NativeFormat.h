@@ -1,11 +1,14 @@
 #pragma once
 
 #include "ExportOptions.h"
+#include "MappedFile.h"
 #include <string>
 #include <vector>
 #include <memory>
 #include <fstream>
 #include <map>
+#include <unordered_map>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace dc {
@@ -22,7 +25,7 @@ class Project;
 /**
  * File format version
  */
-constexpr uint32_t DCA_FORMAT_VERSION = 1;
+constexpr uint32_t DCA_FORMAT_VERSION = 2;          // 2: compressed mesh chunks
 constexpr uint32_t DCA_MAGIC_NUMBER = 0x44434133;  // "DCA3"
 
 /**
@@ -31,6 +34,7 @@ constexpr uint32_t DCA_MAGIC_NUMBER = 0x44434133;  // "DCA3"
 enum class DCAChunkType : uint32_t {
     HEADER = 0x48445200,      // "HDR\0"
     MESH_DATA = 0x4D455348,   // "MESH"
+    MESH_COMPRESSED = 0x4D455343, // "MESC"
     SURFACE_DATA = 0x53555246, // "SURF"
     CURVE_DATA = 0x43555256,  // "CURV"
     SKETCH_DATA = 0x534B4348,  // "SKCH"
@@ -75,6 +79,19 @@ struct MeshData {
     glm::vec3 boundingBoxMax;
 };
 
+/**
+ * Compressed mesh chunk options
+ *
+ * Each mesh is encoded as a MESH_COMPRESSED chunk only if that comes out
+ * smaller than the raw MESH_DATA chunk; files with either kind load the same.
+ */
+struct MeshCompressionOptions {
+    bool enabled = false;               // Try compressed encoding when saving
+    float positionTolerance = 0.0f;     // Max position error per axis (0 = lossless)
+    bool octahedralNormals = true;      // 2x16-bit normals (< 0.01 degree error); false = exact
+    int level = 1;                      // zlib level for the entropy stage (1 = fastest, 9 = smallest)
+};
+
 /**
  * Native .dca format reader/writer
  * Format structure:
@@ -92,11 +109,19 @@ public:
     
     /**
      * Save project to .dca file
+     * Saving back to the file the project was opened from or last saved to
+     * only writes the manifest and the bodies and sketches whose content
+     * hash differs from the one recorded when they were loaded or saved:
+     * they are appended with a new table of contents that points at the
+     * unchanged data (and at parts that were never loaded) in place. The file is rewritten in full (through a
+     * temporary file) when dead space would exceed the live data, or when
+     * saving somewhere else. Afterwards the project keeps the saved archive
+     * open.
      * @param project The project to save
      * @param filename Output file path
      * @return true if save successful
      */
-    bool saveProject(const Project& project, const std::string& filename);
+    bool saveProject(Project& project, const std::string& filename);
     
     /**
      * Load project from .dca file
@@ -105,6 +130,38 @@ public:
      */
     std::shared_ptr<Project> loadProject(const std::string& filename);
     
+    /**
+     * Open project from .dca file without loading its geometry
+     * Only the manifest is read; bodies and sketches stay empty until
+     * loadBody()/loadSketch() materialize them from the mapped archive.
+     * @param filename Input file path
+     * @return Project skeleton, or nullptr on failure
+     */
+    std::shared_ptr<Project> openProject(const std::string& filename);
+    
+    /**
+     * Load mesh and surfaces of one body of an opened project
+     * @return true if loaded (or already loaded)
+     */
+    bool loadBody(Project& project, size_t index);
+    
+    /**
+     * Load one sketch of an opened project
+     * @return true if loaded (or already loaded)
+     */
+    bool loadSketch(Project& project, size_t index);
+    
+    /**
+     * Check if a body has been materialized
+     */
+    static bool isBodyLoaded(const Project& project, size_t index);
+    
+    /**
+     * Set how mesh chunks are encoded by saveProject()
+     */
+    void setMeshCompression(const MeshCompressionOptions& options) { m_meshCompression = options; }
+    const MeshCompressionOptions& meshCompression() const { return m_meshCompression; }
+    
     /**
      * Get last error message
      */
@@ -133,6 +190,7 @@ public:
     
 private:
     std::string m_errorMessage;
+    MeshCompressionOptions m_meshCompression;
     
     // JSON serialization
     std::string createManifestJSON(const Project& project);
@@ -142,6 +200,10 @@ private:
     std::vector<uint8_t> serializeMeshData(const MeshData& mesh);
     MeshData deserializeMeshData(const std::vector<uint8_t>& data);
     
+    // Compressed mesh chunks (empty result = encoding not applicable)
+    std::vector<uint8_t> compressMeshData(const MeshData& mesh);
+    MeshData decompressMeshData(const std::vector<uint8_t>& data);
+    
     std::vector<uint8_t> serializeSurfaceData(const NURBSSurface& surface);
     std::shared_ptr<NURBSSurface> deserializeSurfaceData(const std::vector<uint8_t>& data);
     
@@ -151,6 +213,10 @@ private:
     std::vector<uint8_t> serializeSketchData(const Sketch& sketch);
     std::shared_ptr<Sketch> deserializeSketchData(const std::vector<uint8_t>& data);
     
+    // Change detection for incremental saves
+    uint64_t contentHash(const Body& body);
+    uint64_t contentHash(const Sketch& sketch);
+    
     // ZIP operations (simplified - real implementation would use minizip or similar)
     bool writeZipFile(const std::string& filename, 
                       const std::map<std::string, std::vector<uint8_t>>& contents);
@@ -164,6 +230,7 @@ private:
     void writeVec3(std::vector<uint8_t>& buffer, const glm::vec3& v);
     void writeDVec3(std::vector<uint8_t>& buffer, const glm::dvec3& v);
     void writeString(std::vector<uint8_t>& buffer, const std::string& str);
+    void writeWords(std::vector<uint8_t>& buffer, const void* data, size_t count);
     
     uint32_t readUint32(const std::vector<uint8_t>& buffer, size_t& offset);
     float readFloat(const std::vector<uint8_t>& buffer, size_t& offset);
@@ -171,13 +238,95 @@ private:
     glm::vec3 readVec3(const std::vector<uint8_t>& buffer, size_t& offset);
     glm::dvec3 readDVec3(const std::vector<uint8_t>& buffer, size_t& offset);
     std::string readString(const std::vector<uint8_t>& buffer, size_t& offset);
+    void readWords(const std::vector<uint8_t>& buffer, size_t& offset, void* data, size_t count);
     
     std::string getCurrentTimestamp();
 };
 
+/**
+ * Random-access reader for archives written by SimpleArchive
+ *
+ * open() maps the file and parses only the table of contents, so its cost
+ * does not depend on how much data the archive holds. Entry data is
+ * copied out, and its checksum verified, when read() asks for it. Bytes
+ * after the last footer whose table verifies (left by an interrupted
+ * append) are ignored.
+ */
+class ArchiveReader {
+public:
+    struct EntryInfo {
+        std::string name;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint64_t checksum = 0;
+    };
+    
+    ArchiveReader() = default;
+    
+    // Non-copyable (owns the mapping)
+    ArchiveReader(const ArchiveReader&) = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+    
+    /**
+     * Map an archive and parse its table of contents
+     * @param error Optional output: reason on failure
+     */
+    bool open(const std::string& filename, std::string* error = nullptr);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    
+    /**
+     * Path passed to open()
+     */
+    const std::string& filename() const { return m_filename; }
+    
+    /**
+     * Size of the mapped file, including superseded data
+     */
+    uint64_t fileSize() const { return m_file.size(); }
+    
+    /**
+     * Check if the archive is ARC2 (checksummed, can be appended to)
+     */
+    bool hasChecksums() const { return m_hasChecksums; }
+    
+    /**
+     * Entries in file order
+     */
+    const std::vector<EntryInfo>& entries() const { return m_entries; }
+    
+    /**
+     * Look up an entry by name (nullptr if absent)
+     */
+    const EntryInfo* find(const std::string& name) const;
+    
+    /**
+     * Copy an entry's data out of the mapping
+     * Safe to call from several threads at once.
+     * @param error Optional output: reason on failure (missing entry, bad checksum)
+     */
+    bool read(const std::string& name, std::vector<uint8_t>& data, std::string* error = nullptr) const;
+    
+private:
+    bool parseTableOfContents(std::string* error);
+    bool parseLegacyEntries(std::string* error);
+    
+    dc3d::io::MappedFile m_file;
+    std::string m_filename;
+    std::vector<EntryInfo> m_entries;
+    std::unordered_map<std::string, size_t> m_index;
+    bool m_hasChecksums = false;
+};
+
 /**
  * Simple uncompressed archive format (alternative to ZIP)
  * For simpler implementation without external dependencies
+ *
+ * Layout (ARC2): header, entry data back to back, table of contents
+ * (name, offset, size and checksum of every entry), then a fixed-size
+ * footer pointing at the table. Readers map the file and seek straight to
+ * the entries they need. The original ARCH layout (entries inline, no
+ * table) is still read.
  */
 class SimpleArchive {
 public:
@@ -186,10 +335,158 @@ public:
         std::vector<uint8_t> data;
     };
     
-    static constexpr uint32_t ARCHIVE_MAGIC = 0x41524348;  // "ARCH"
+    static constexpr uint32_t ARCHIVE_MAGIC = 0x41524348;      // "ARCH" (no table of contents)
+    static constexpr uint32_t ARCHIVE_TOC_MAGIC = 0x41524332;  // "ARC2"
+    static constexpr uint32_t ARCHIVE_VERSION = 2;
     
     bool write(const std::string& filename, const std::vector<Entry>& entries);
     bool read(const std::string& filename, std::vector<Entry>& entries);
 };
 
+/**
+ * Entry-by-entry writer for the ARC2 layout
+ *
+ * create() starts a new archive. append() reopens an existing ARC2 archive
+ * so that added entries go after its current end, while keep() carries
+ * entries over by pointing the new table of contents at data already in
+ * the file. finish() writes the table and footer; until then the file
+ * still opens as it was. Replaced data and superseded tables stay in the
+ * file as dead space until it is rewritten.
+ */
+class ArchiveWriter {
+public:
+    ArchiveWriter() = default;
+    ~ArchiveWriter();  // Discards an unfinished archive
+    
+    // Non-copyable (owns the file)
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+    
+    /**
+     * Start a new archive, replacing any existing file
+     */
+    bool create(const std::string& filename);
+    
+    /**
+     * Reopen an ARC2 archive to add entries after its last complete save
+     * Partial data left by an interrupted append is cut off first.
+     */
+    bool append(const std::string& filename);
+    
+    /**
+     * Write an entry's data and record it in the table of contents
+     */
+    bool add(const std::string& name, const std::vector<uint8_t>& data);
+    
+    /**
+     * Record an entry whose data is already in the file being appended to
+     * @param entry Entry from an ArchiveReader opened on that file
+     * @param name Name in the new table of contents (entries may be renamed)
+     */
+    void keep(const ArchiveReader::EntryInfo& entry, const std::string& name);
+    
+    /**
+     * Write the table of contents and footer and close the file
+     */
+    bool finish();
+    
+    /**
+     * Abandon the archive: a new file is removed, an appended one is cut
+     * back to its previous size
+     */
+    void discard();
+    
+    /**
+     * Bytes added so far (entry data only)
+     */
+    uint64_t bytesAdded() const { return m_bytesAdded; }
+    
+private:
+    std::ofstream m_file;
+    std::string m_filename;
+    std::vector<ArchiveReader::EntryInfo> m_entries;
+    uint64_t m_offset = 0;        // Where the next entry's data goes
+    uint64_t m_initialSize = 0;   // File size before append()
+    uint64_t m_bytesAdded = 0;
+    bool m_appending = false;
+};
+
+// Project data model (placeholder classes until the modeling kernel is wired in)
+class NURBSSurface {
+public:
+    int degreeU = 3, degreeV = 3;
+    std::vector<std::vector<glm::dvec3>> controlPoints;
+    std::vector<std::vector<double>> weights;
+    std::vector<double> knotsU, knotsV;
+    double uMin = 0, uMax = 1, vMin = 0, vMax = 1;
+};
+
+class NURBSCurve {
+public:
+    int degree = 3;
+    std::vector<glm::dvec3> controlPoints;
+    std::vector<double> weights;
+    std::vector<double> knots;
+    double tMin = 0, tMax = 1;
+};
+
+class SketchElement {
+public:
+    enum class Type { Line, Arc, Circle, Spline };
+    Type type = Type::Line;
+    std::vector<glm::dvec2> points;
+    std::vector<double> parameters;
+    bool isConstruction = false;
+};
+
+class Sketch {
+public:
+    std::string name = "Sketch";
+    glm::dvec3 origin{0, 0, 0};
+    glm::dvec3 normal{0, 0, 1};
+    glm::dvec3 xAxis{1, 0, 0};
+    std::vector<std::shared_ptr<SketchElement>> elements;
+    bool isVisible = true;
+    
+    // Save bookkeeping: index in the project's archive (-1 = not stored yet)
+    // and content hash of the data stored there, compared at save time
+    int archiveIndex = -1;
+    uint64_t storedHash = 0;
+};
+
+class Face {
+public:
+    std::shared_ptr<NURBSSurface> surface;
+    MeshData mesh;
+    glm::vec3 color{0.7f, 0.7f, 0.8f};
+};
+
+class Body {
+public:
+    std::string name = "Body";
+    std::string id;
+    std::vector<std::shared_ptr<Face>> faces;
+    MeshData combinedMesh;
+    glm::vec3 color{0.7f, 0.7f, 0.8f};
+    bool isVisible = true;
+    
+    // Save bookkeeping, as for Sketch (covers the mesh and all face surfaces)
+    int archiveIndex = -1;
+    uint64_t storedHash = 0;
+};
+
+class Project {
+public:
+    ProjectSettings settings;
+    std::vector<std::shared_ptr<Body>> bodies;
+    std::vector<std::shared_ptr<Sketch>> sketches;
+    std::string filePath;
+    
+    // Archive the project was opened from or last saved to: unloaded parts
+    // are read from it and unchanged parts are saved by reference into it
+    std::shared_ptr<ArchiveReader> archive;
+    std::vector<bool> bodyLoaded;
+    std::vector<bool> sketchLoaded;
+};
+
 } // namespace dc
@@ -4,25 +4,23 @@
  */
 
 #include "OBJImporter.h"
+#include "MappedFile.h"
+#include "TextTokenizer.h"
+#include "../core/TaskScheduler.h"
 
 #include <fstream>
-#include <sstream>
 #include <unordered_map>
 #include <algorithm>
 #include <cstdint>
+#include <limits>
 
 namespace dc3d {
 namespace io {
 
 namespace {
 
-// Trim whitespace from string
-std::string trim(const std::string& str) {
-    size_t first = str.find_first_not_of(" \t\r\n");
-    if (first == std::string::npos) return "";
-    size_t last = str.find_last_not_of(" \t\r\n");
-    return str.substr(first, last - first + 1);
-}
+// Text parsed per parallel chunk
+constexpr size_t OBJ_CHUNK_BYTES = 4 << 20;
 
 // Hash function for vertex key (position + texcoord + normal indices)
 struct VertexKey {
@@ -47,8 +45,64 @@ struct VertexKeyHash {
     }
 };
 
+// Flags marking which indices of a face corner were written as negative
+constexpr uint8_t RELATIVE_POSITION = 1;
+constexpr uint8_t RELATIVE_TEXCOORD = 2;
+constexpr uint8_t RELATIVE_NORMAL = 4;
+
+/// How texture or normal indices relate to position indices
+enum class IndexPattern {
+    None,       ///< No corners seen yet
+    Absent,     ///< Always 0
+    Equal,      ///< Always equal to the position index
+    Mixed       ///< Anything else
+};
+
+IndexPattern classifyIndex(int index, int posIdx) {
+    if (index == 0) return IndexPattern::Absent;
+    return index == posIdx ? IndexPattern::Equal : IndexPattern::Mixed;
+}
+
+IndexPattern combinePatterns(IndexPattern a, IndexPattern b) {
+    if (a == IndexPattern::None) return b;
+    if (b == IndexPattern::None) return a;
+    return a == b ? a : IndexPattern::Mixed;
+}
+
+// Start of the line holding the given face of a chunk (for error messages)
+const char* findFaceLine(const char* begin, const char* end, size_t faceOrdinal) {
+    TextTokenizer tokenizer(begin, end);
+    for (; !tokenizer.atEnd(); tokenizer.nextLine()) {
+        const char* lineStart = tokenizer.position();
+        if (tokenizer.token() == "f" && faceOrdinal-- == 0) {
+            return lineStart;
+        }
+    }
+    return begin;
+}
+
 } // anonymous namespace
 
+/**
+ * @brief Elements parsed from one newline-aligned chunk of an OBJ file
+ *
+ * Positive indices are global and stored as written. Negative indices are
+ * relative to the elements defined so far, which a chunk only knows
+ * locally: they are stored resolved against the chunk's own counts and
+ * flagged, then shifted by the counts of all earlier chunks when stitching.
+ */
+struct OBJImporter::Chunk {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<VertexKey> corners;      ///< Face corners, in file order
+    std::vector<uint32_t> faceSizes;     ///< Corners per face
+    std::vector<uint8_t> relative;       ///< Per corner RELATIVE_* bits (empty if none)
+    
+    const char* errorLine = nullptr;     ///< Start of the offending line, if any
+    std::string error;                   ///< Error description without line number
+};
+
 geometry::Result<geometry::MeshData> OBJImporter::import(
     const std::filesystem::path& path,
     const OBJImportOptions& options,
@@ -80,8 +134,15 @@ geometry::Result<geometry::MeshData> OBJImporter::import(
             "The file contains no data. It may be corrupted or incomplete.");
     }
     
-    // Open file
-    std::ifstream file(path);
+    // Parse straight from a memory map
+    MappedFile mapped;
+    std::string mapError;
+    if (mapped.open(path, &mapError)) {
+        return importFromData(mapped.data(), mapped.size(), options, progress);
+    }
+    
+    // Mapping can fail on exotic filesystems; fall back to streaming
+    std::ifstream file(path, std::ios::in | std::ios::binary);
     if (!file) {
         return geometry::Result<geometry::MeshData>::failure(
             "Cannot open file: \"" + fileName + "\"\n"
@@ -96,277 +157,374 @@ geometry::Result<geometry::MeshData> OBJImporter::importFromStream(
     const OBJImportOptions& options,
     geometry::ProgressCallback progress) {
     
-    // Temporary storage for OBJ data
-    std::vector<glm::vec3> positions;
-    std::vector<glm::vec3> normals;
-    std::vector<glm::vec2> texCoords;
+    std::string text = TextTokenizer::readAll(stream);
+    return importFromData(text.data(), text.size(), options, progress);
+}
+
+geometry::Result<geometry::MeshData> OBJImporter::importFromMemory(
+    const void* data,
+    size_t size,
+    const OBJImportOptions& options,
+    geometry::ProgressCallback progress) {
+    
+    if (!data || size == 0) {
+        return geometry::Result<geometry::MeshData>::failure(
+            "Cannot import from memory: data buffer is empty or null.");
+    }
     
-    // Face indices (each face is a vector of VertexKeys)
-    std::vector<std::vector<VertexKey>> faces;
+    return importFromData(static_cast<const char*>(data), size, options, progress);
+}
+
+geometry::Result<geometry::MeshData> OBJImporter::importFromData(
+    const char* data,
+    size_t size,
+    const OBJImportOptions& options,
+    geometry::ProgressCallback progress) {
     
-    // Estimate file size for progress
-    stream.seekg(0, std::ios::end);
-    auto fileSize = stream.tellg();
-    stream.seekg(0);
+    using MeshResult = geometry::Result<geometry::MeshData>;
+    const char* end = data + size;
     
     // Rough estimate: 30 bytes per line average
-    size_t estimatedLines = static_cast<size_t>(fileSize) / 30;
-    size_t currentLine = 0;
-    
+    size_t estimatedLines = size / 30;
     bool reportProgress = progress && estimatedLines > options.progressThreshold;
     
-    // Reserve approximate space
-    positions.reserve(estimatedLines / 4);
-    faces.reserve(estimatedLines / 4);
+    // ========================================================================
+    // Pass 1: tokenize newline-aligned chunks in parallel
+    // ========================================================================
     
-    std::string line;
-    size_t lineNumber = 0;
+    std::vector<const char*> bounds = TextTokenizer::splitLines(data, end, OBJ_CHUNK_BYTES);
+    const size_t chunkCount = bounds.size() - 1;
+    std::vector<Chunk> chunks(chunkCount);
     
-    while (std::getline(stream, line)) {
-        ++lineNumber;
-        ++currentLine;
-        
-        // Progress reporting
-        if (reportProgress && (currentLine % 100000 == 0)) {
-            float prog = static_cast<float>(stream.tellg()) / fileSize;
-            if (!progress(prog * 0.5f)) {  // First half is parsing
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Import cancelled by user.");
+    core::ParallelProgress reporter(reportProgress ? progress : nullptr, size, 0.0f, 0.5f);
+    
+    // Without a sink all chunks form one wave. When streaming, a wave holds
+    // one chunk per worker and its positions and faces are delivered as a
+    // preview before the next starts; corners referring to positions not
+    // seen yet are left out of the preview.
+    if (options.sink) {
+        options.sink->begin(0, 0);
+    }
+    const size_t waveSize = options.sink
+        ? std::max<size_t>(1, core::TaskScheduler::instance().threadCount())
+        : chunkCount;
+    size_t streamedPositions = 0;
+    bool streaming = options.sink != nullptr;
+    std::vector<uint32_t> previewTriangles;
+    
+    for (size_t wave = 0; wave < chunkCount; wave += waveSize) {
+        const size_t waveEnd = std::min(wave + waveSize, chunkCount);
+        bool completed = core::parallelFor(wave, waveEnd, [&](size_t chunkBegin, size_t chunkEnd) {
+            for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+                parseChunk(bounds[c], bounds[c + 1], options, chunks[c]);
+                reporter.advance(static_cast<size_t>(bounds[c + 1] - bounds[c]));
             }
-        }
+        }, 1, &reporter.token());
         
-        line = trim(line);
-        if (line.empty() || line[0] == '#') {
-            continue;  // Skip empty lines and comments
+        if (!completed) {
+            return MeshResult::failure("Import cancelled by user.");
         }
         
-        std::istringstream iss(line);
-        std::string keyword;
-        iss >> keyword;
-        
-        if (keyword == "v") {
-            // Vertex position
-            glm::vec3 pos;
-            iss >> pos.x >> pos.y >> pos.z;
-            
-            if (iss.fail()) {
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                    "Invalid vertex coordinates. Expected: v x y z\n"
-                    "Line content: " + line);
-            }
-            
-            positions.push_back(pos);
-        }
-        else if (keyword == "vn") {
-            // Vertex normal
-            glm::vec3 norm;
-            iss >> norm.x >> norm.y >> norm.z;
-            
-            if (iss.fail()) {
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                    "Invalid vertex normal. Expected: vn nx ny nz\n"
-                    "Line content: " + line);
+        for (size_t c = wave; c < waveEnd && streaming; ++c) {
+            const Chunk& chunk = chunks[c];
+            if (chunk.errorLine) {
+                streaming = false;  // Reported once all chunks are parsed
+                break;
             }
             
-            normals.push_back(norm);
-        }
-        else if (keyword == "vt") {
-            // Texture coordinate
-            if (options.importUVs) {
-                glm::vec2 uv;
-                iss >> uv.x >> uv.y;
-                
-                if (iss.fail()) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                        "Invalid texture coordinate. Expected: vt u v\n"
-                        "Line content: " + line);
-                }
-                
-                if (options.flipV) {
-                    uv.y = 1.0f - uv.y;
-                }
-                
-                texCoords.push_back(uv);
-            }
-        }
-        else if (keyword == "f") {
-            // Face
-            std::vector<VertexKey> faceVertices;
-            std::string vertexSpec;
-            
-            while (iss >> vertexSpec) {
-                int vIdx = 0, vtIdx = 0, vnIdx = 0;
-                
-                if (!parseFaceVertex(vertexSpec, vIdx, vtIdx, vnIdx)) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                        "Invalid face vertex format: '" + vertexSpec + "'\n"
-                        "Expected format: v, v/vt, v/vt/vn, or v//vn");
-                }
-                
-                // Handle negative (relative) indices
-                if (vIdx < 0) {
-                    vIdx = static_cast<int>(positions.size()) + vIdx + 1;
-                }
-                if (vtIdx < 0) {
-                    vtIdx = static_cast<int>(texCoords.size()) + vtIdx + 1;
-                }
-                if (vnIdx < 0) {
-                    vnIdx = static_cast<int>(normals.size()) + vnIdx + 1;
-                }
-                
-                // HIGH FIX: Validate indices - must be positive after relative conversion
-                if (vIdx <= 0 || vIdx > static_cast<int>(positions.size())) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                        "Vertex index " + std::to_string(vIdx) + " is out of range.\n"
-                        "Valid range: 1 to " + std::to_string(positions.size()) + "\n"
-                        "The face references a vertex that hasn't been defined yet.");
-                }
-                // Also validate texture and normal indices if specified
-                if (vtIdx != 0 && (vtIdx < 0 || vtIdx > static_cast<int>(texCoords.size()))) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                        "Texture coordinate index " + std::to_string(vtIdx) + " is out of range.\n"
-                        "Valid range: 1 to " + std::to_string(texCoords.size()));
-                }
-                if (vnIdx != 0 && (vnIdx < 0 || vnIdx > static_cast<int>(normals.size()))) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                        "Normal index " + std::to_string(vnIdx) + " is out of range.\n"
-                        "Valid range: 1 to " + std::to_string(normals.size()));
+            const size_t available = streamedPositions + chunk.positions.size();
+            previewTriangles.clear();
+            size_t corner = 0;
+            for (uint32_t faceSize : chunk.faceSizes) {
+                uint32_t fan[3] = {};
+                bool valid = true;
+                for (uint32_t k = 0; k < faceSize; ++k, ++corner) {
+                    int64_t index = chunk.corners[corner].posIdx - 1;  // OBJ is 1-indexed
+                    if (!chunk.relative.empty() && (chunk.relative[corner] & RELATIVE_POSITION)) {
+                        index += static_cast<int64_t>(streamedPositions);
+                    }
+                    valid = valid && index >= 0 && static_cast<size_t>(index) < available;
+                    fan[k < 2 ? k : 2] = static_cast<uint32_t>(index);
+                    if (k >= 2 && valid) {
+                        previewTriangles.insert(previewTriangles.end(), {fan[0], fan[1], fan[2]});
+                        fan[1] = fan[2];
+                    }
                 }
-                
-                faceVertices.push_back({vIdx, vtIdx, vnIdx});
             }
             
-            if (faceVertices.size() < 3) {
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                    "Face has only " + std::to_string(faceVertices.size()) + " vertices.\n"
-                    "A face must have at least 3 vertices to form a polygon.");
+            MeshChunk preview;
+            preview.vertices = chunk.positions.data();
+            preview.vertexCount = chunk.positions.size();
+            preview.firstVertex = streamedPositions;
+            preview.indices = previewTriangles.data();
+            preview.indexCount = previewTriangles.size();
+            if (!options.sink->consume(preview)) {
+                return MeshResult::failure("Import cancelled by user.");
             }
-            
-            faces.push_back(std::move(faceVertices));
+            streamedPositions = available;
         }
-        // Skip other keywords (o, g, s, usemtl, mtllib, etc.)
     }
     
-    if (positions.empty()) {
-        return geometry::Result<geometry::MeshData>::failure(
+    auto lineNumberAt = [data](const char* lineStart) {
+        return std::to_string(1 + TextTokenizer::countLines(data, lineStart));
+    };
+    
+    // Per-chunk element offsets in the global index space
+    struct ChunkBase {
+        size_t positions = 0;
+        size_t texCoords = 0;
+        size_t normals = 0;
+        size_t corners = 0;
+        size_t faces = 0;
+    };
+    std::vector<ChunkBase> bases(chunkCount + 1);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        const Chunk& chunk = chunks[c];
+        if (chunk.errorLine) {
+            return MeshResult::failure(
+                "Parse error at line " + lineNumberAt(chunk.errorLine) + ":\n" + chunk.error);
+        }
+        bases[c + 1].positions = bases[c].positions + chunk.positions.size();
+        bases[c + 1].texCoords = bases[c].texCoords + chunk.texCoords.size();
+        bases[c + 1].normals = bases[c].normals + chunk.normals.size();
+        bases[c + 1].corners = bases[c].corners + chunk.corners.size();
+        bases[c + 1].faces = bases[c].faces + chunk.faceSizes.size();
+    }
+    const ChunkBase& totals = bases[chunkCount];
+    
+    if (totals.positions == 0) {
+        return MeshResult::failure(
             "No vertices found in OBJ file.\n"
             "The file contains no 'v' (vertex position) entries.\n"
             "Check that this is a valid Wavefront OBJ file.");
     }
     
-    if (faces.empty()) {
-        return geometry::Result<geometry::MeshData>::failure(
+    if (totals.faces == 0) {
+        return MeshResult::failure(
             "No faces found in OBJ file.\n"
-            "Found " + std::to_string(positions.size()) + " vertices but no 'f' (face) entries.\n"
+            "Found " + std::to_string(totals.positions) + " vertices but no 'f' (face) entries.\n"
             "The file may be a point cloud rather than a mesh.");
     }
     
-    // Build mesh - deduplicate vertices with same pos/tex/norm combination
-    geometry::MeshData mesh;
-    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertexMap;
-    
-    // Estimate vertex count (upper bound is 3 * face count for all triangles)
-    size_t estimatedVertices = 0;
-    for (const auto& face : faces) {
-        estimatedVertices += face.size();
+    if (totals.positions > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+        totals.corners > std::numeric_limits<uint32_t>::max()) {
+        return MeshResult::failure(
+            "OBJ file is too large: " + std::to_string(totals.positions) + " vertices, " +
+            std::to_string(totals.corners) + " face corners.\n"
+            "Try decimating the mesh in the original application before importing.");
     }
-    mesh.reserveVertices(estimatedVertices);
-    
-    // Estimate triangle count
-    size_t estimatedTriangles = 0;
-    for (const auto& face : faces) {
-        if (options.triangulate && face.size() > 3) {
-            estimatedTriangles += face.size() - 2;  // Fan triangulation
-        } else {
-            estimatedTriangles += 1;
+    
+    // ========================================================================
+    // Pass 2: stitch indices into the global index space and validate them
+    // ========================================================================
+    
+    // Per chunk: whether texture/normal indices are absent or equal to the
+    // position index, so a position alone identifies the output vertex
+    std::vector<IndexPattern> texPatterns(chunkCount, IndexPattern::None);
+    std::vector<IndexPattern> normPatterns(chunkCount, IndexPattern::None);
+    
+    core::parallelFor(0, chunkCount, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+            Chunk& chunk = chunks[c];
+            const ChunkBase& base = bases[c];
+            IndexPattern texPattern = IndexPattern::None;
+            IndexPattern normPattern = IndexPattern::None;
+            
+            size_t corner = 0;
+            for (size_t f = 0; f < chunk.faceSizes.size(); ++f) {
+                for (uint32_t k = 0; k < chunk.faceSizes[f]; ++k, ++corner) {
+                    VertexKey& key = chunk.corners[corner];
+                    if (!chunk.relative.empty()) {
+                        uint8_t flags = chunk.relative[corner];
+                        if (flags & RELATIVE_POSITION) key.posIdx += static_cast<int>(base.positions);
+                        if (flags & RELATIVE_TEXCOORD) key.texIdx += static_cast<int>(base.texCoords);
+                        if (flags & RELATIVE_NORMAL) key.normIdx += static_cast<int>(base.normals);
+                    }
+                    
+                    // HIGH FIX: Validate indices - must be positive after relative conversion
+                    std::string error;
+                    if (key.posIdx <= 0 || static_cast<size_t>(key.posIdx) > totals.positions) {
+                        error = "Vertex index " + std::to_string(key.posIdx) + " is out of range.\n"
+                                "Valid range: 1 to " + std::to_string(totals.positions) + "\n"
+                                "The face references a vertex that is not defined.";
+                    }
+                    // Also validate texture and normal indices if specified
+                    else if (key.texIdx != 0 && (key.texIdx < 0 || static_cast<size_t>(key.texIdx) > totals.texCoords)) {
+                        error = "Texture coordinate index " + std::to_string(key.texIdx) + " is out of range.\n"
+                                "Valid range: 1 to " + std::to_string(totals.texCoords);
+                    }
+                    else if (key.normIdx != 0 && (key.normIdx < 0 || static_cast<size_t>(key.normIdx) > totals.normals)) {
+                        error = "Normal index " + std::to_string(key.normIdx) + " is out of range.\n"
+                                "Valid range: 1 to " + std::to_string(totals.normals);
+                    }
+                    if (!error.empty()) {
+                        chunk.errorLine = findFaceLine(bounds[c], bounds[c + 1], f);
+                        chunk.error = std::move(error);
+                        return;
+                    }
+                    
+                    texPattern = combinePatterns(texPattern, classifyIndex(key.texIdx, key.posIdx));
+                    normPattern = combinePatterns(normPattern, classifyIndex(key.normIdx, key.posIdx));
+                }
+            }
+            std::vector<uint8_t>().swap(chunk.relative);
+            texPatterns[c] = texPattern;
+            normPatterns[c] = normPattern;
+        }
+    });
+    
+    IndexPattern texPattern = IndexPattern::None;
+    IndexPattern normPattern = IndexPattern::None;
+    for (size_t c = 0; c < chunkCount; ++c) {
+        if (chunks[c].errorLine) {
+            return MeshResult::failure(
+                "Parse error at line " + lineNumberAt(chunks[c].errorLine) + ":\n" + chunks[c].error);
         }
+        texPattern = combinePatterns(texPattern, texPatterns[c]);
+        normPattern = combinePatterns(normPattern, normPatterns[c]);
     }
-    mesh.reserveFaces(estimatedTriangles);
+    const bool positionKeyed = texPattern != IndexPattern::Mixed && normPattern != IndexPattern::Mixed;
     
-    bool hasNormals = !normals.empty();
-    bool hasUVs = !texCoords.empty() && options.importUVs;
+    if (reportProgress && !progress(0.6f)) {
+        return MeshResult::failure("Import cancelled by user.");
+    }
     
-    // Process faces
-    size_t faceIndex = 0;
-    for (const auto& face : faces) {
-        ++faceIndex;
-        
-        // Progress reporting (second half)
-        if (reportProgress && (faceIndex % 100000 == 0)) {
-            float prog = 0.5f + 0.5f * static_cast<float>(faceIndex) / faces.size();
-            if (!progress(prog)) {
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Import cancelled by user.");
-            }
+    // ========================================================================
+    // Pass 3: concatenate element arrays
+    // ========================================================================
+    
+    std::vector<glm::vec3> positions(totals.positions);
+    std::vector<glm::vec3> normals(totals.normals);
+    std::vector<glm::vec2> texCoords(totals.texCoords);
+    core::parallelFor(0, chunkCount, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+            Chunk& chunk = chunks[c];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + bases[c].positions);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + bases[c].normals);
+            std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + bases[c].texCoords);
+            std::vector<glm::vec3>().swap(chunk.positions);
+            std::vector<glm::vec3>().swap(chunk.normals);
+            std::vector<glm::vec2>().swap(chunk.texCoords);
         }
-        
-        // Convert face vertices to mesh vertex indices
-        std::vector<uint32_t> meshIndices;
-        meshIndices.reserve(face.size());
-        
-        for (const auto& vk : face) {
-            // Check if we already have this vertex combination
-            auto it = vertexMap.find(vk);
-            if (it != vertexMap.end()) {
-                meshIndices.push_back(it->second);
-            } else {
-                // Create new vertex
-                glm::vec3 pos = positions[vk.posIdx - 1];  // OBJ is 1-indexed
-                uint32_t newIdx;
-                
-                if (hasNormals && vk.normIdx > 0 && 
-                    vk.normIdx <= static_cast<int>(normals.size())) {
-                    glm::vec3 norm = normals[vk.normIdx - 1];
-                    newIdx = mesh.addVertex(pos, norm);
-                } else {
-                    newIdx = mesh.addVertex(pos);
-                }
-                
-                // Add UV if available
-                if (hasUVs && vk.texIdx > 0 && 
-                    vk.texIdx <= static_cast<int>(texCoords.size())) {
-                    // LOW FIX: Use resize() instead of push_back in loop (O(1) vs O(n²))
-                    if (newIdx >= mesh.uvs().size()) {
-                        mesh.uvs().resize(newIdx + 1, glm::vec2(0.0f));
-                    }
-                    mesh.uvs()[newIdx] = texCoords[vk.texIdx - 1];
+    }, 1);
+    
+    // ========================================================================
+    // Pass 4: deduplicate vertices with same pos/tex/norm combination
+    // ========================================================================
+    
+    // Output vertices are numbered in order of first use. The assigned id
+    // replaces each corner's position index.
+    std::vector<VertexKey> vertexKeys;
+    vertexKeys.reserve(positionKeyed ? totals.positions : totals.corners / 2);
+    
+    if (positionKeyed) {
+        // Fast path: texture/normal indices follow the position index
+        // throughout the file, so a flat table replaces the hash map
+        std::vector<uint32_t> vertexOfPosition(totals.positions, std::numeric_limits<uint32_t>::max());
+        for (Chunk& chunk : chunks) {
+            for (VertexKey& key : chunk.corners) {
+                uint32_t& id = vertexOfPosition[key.posIdx - 1];
+                if (id == std::numeric_limits<uint32_t>::max()) {
+                    id = static_cast<uint32_t>(vertexKeys.size());
+                    vertexKeys.push_back(key);
                 }
-                
-                vertexMap[vk] = newIdx;
-                meshIndices.push_back(newIdx);
+                key.posIdx = static_cast<int>(id);
             }
         }
-        
-        // Triangulate face
-        if (meshIndices.size() == 3) {
-            // Triangle - add directly
-            mesh.addFace(meshIndices[0], meshIndices[1], meshIndices[2]);
-        }
-        else if (meshIndices.size() == 4 && options.triangulate) {
-            // Quad - split into 2 triangles (fan from first vertex)
-            mesh.addFace(meshIndices[0], meshIndices[1], meshIndices[2]);
-            mesh.addFace(meshIndices[0], meshIndices[2], meshIndices[3]);
+    } else {
+        std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertexMap;
+        vertexMap.reserve(totals.corners / 2);
+        for (Chunk& chunk : chunks) {
+            for (VertexKey& key : chunk.corners) {
+                auto inserted = vertexMap.emplace(key, static_cast<uint32_t>(vertexKeys.size()));
+                if (inserted.second) {
+                    vertexKeys.push_back(key);
+                }
+                key.posIdx = static_cast<int>(inserted.first->second);
+            }
         }
-        else if (meshIndices.size() > 4 && options.triangulate) {
-            // Polygon - fan triangulation from first vertex
-            for (size_t i = 1; i < meshIndices.size() - 1; ++i) {
-                mesh.addFace(meshIndices[0], meshIndices[i], meshIndices[i + 1]);
+    }
+    
+    if (reportProgress && !progress(0.8f)) {
+        return MeshResult::failure("Import cancelled by user.");
+    }
+    
+    // ========================================================================
+    // Pass 5: build the mesh
+    // ========================================================================
+    
+    geometry::MeshData mesh;
+    const size_t vertexCount = vertexKeys.size();
+    const bool hasNormals = !normals.empty();
+    const bool hasUVs = !texCoords.empty() && options.importUVs;
+    
+    // Normals are kept only if every vertex has one, otherwise they are
+    // recomputed; missing UVs are zero
+    bool allNormals = hasNormals && core::parallelReduce(0, vertexCount, true,
+        [&](size_t begin, size_t stop) {
+            for (size_t v = begin; v < stop; ++v) {
+                if (vertexKeys[v].normIdx == 0) return false;
+            }
+            return true;
+        },
+        [](bool a, bool b) { return a && b; });
+    
+    auto& meshVertices = mesh.editVertices();
+    auto& meshNormals = mesh.editNormals();
+    auto& meshUVs = mesh.editUVs();
+    meshVertices.resize(vertexCount);
+    if (allNormals) meshNormals.resize(vertexCount);
+    if (hasUVs) meshUVs.resize(vertexCount, glm::vec2(0.0f));
+    core::parallelFor(0, vertexCount, [&](size_t begin, size_t stop) {
+        for (size_t v = begin; v < stop; ++v) {
+            const VertexKey& key = vertexKeys[v];
+            meshVertices[v] = positions[key.posIdx - 1];  // OBJ is 1-indexed
+            if (allNormals) {
+                meshNormals[v] = normals[key.normIdx - 1];
+            }
+            if (hasUVs && key.texIdx > 0) {
+                meshUVs[v] = texCoords[key.texIdx - 1];
             }
         }
-        else if (meshIndices.size() > 3) {
-            // Skip non-triangulated polygons
-            // Could add as first triangle only, but better to fail explicitly
+    });
+    
+    // Triangles per chunk, then fan-triangulate in parallel
+    std::vector<size_t> triangleOffsets(chunkCount + 1, 0);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        size_t triangles = 0;
+        for (uint32_t faceSize : chunks[c].faceSizes) {
+            if (faceSize == 3) {
+                triangles += 1;
+            } else if (options.triangulate) {
+                triangles += faceSize - 2;
+            }
+            // Non-triangulated polygons are skipped
         }
+        triangleOffsets[c + 1] = triangleOffsets[c] + triangles;
     }
     
+    std::vector<uint32_t>& indices = mesh.editIndices();
+    indices.resize(triangleOffsets[chunkCount] * 3);
+    core::parallelFor(0, chunkCount, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+            const Chunk& chunk = chunks[c];
+            uint32_t* out = indices.data() + triangleOffsets[c] * 3;
+            size_t corner = 0;
+            for (uint32_t faceSize : chunk.faceSizes) {
+                const VertexKey* face = chunk.corners.data() + corner;
+                corner += faceSize;
+                if (faceSize != 3 && !options.triangulate) {
+                    continue;
+                }
+                for (uint32_t i = 1; i + 1 < faceSize; ++i) {
+                    *out++ = static_cast<uint32_t>(face[0].posIdx);
+                    *out++ = static_cast<uint32_t>(face[i].posIdx);
+                    *out++ = static_cast<uint32_t>(face[i + 1].posIdx);
+                }
+            }
+        }
+    }, 1);
+    
     // Compute normals if missing
     if (options.computeNormalsIfMissing && !mesh.hasNormals()) {
         mesh.computeNormals();
@@ -378,27 +536,108 @@ geometry::Result<geometry::MeshData> OBJImporter::importFromStream(
         progress(1.0f);
     }
     
-    return geometry::Result<geometry::MeshData>::success(std::move(mesh));
+    return MeshResult::success(std::move(mesh));
 }
 
-geometry::Result<geometry::MeshData> OBJImporter::importFromMemory(
-    const void* data,
-    size_t size,
-    const OBJImportOptions& options,
-    geometry::ProgressCallback progress) {
-    
-    if (!data || size == 0) {
-        return geometry::Result<geometry::MeshData>::failure(
-            "Cannot import from memory: data buffer is empty or null.");
+void OBJImporter::parseChunk(const char* begin, const char* end,
+                             const OBJImportOptions& options, Chunk& chunk) {
+    TextTokenizer tokenizer(begin, end);
+    
+    auto fail = [&](const char* lineStart, std::string message) {
+        chunk.errorLine = lineStart;
+        chunk.error = std::move(message);
+    };
+    auto lineContent = [end](const char* lineStart) {
+        return std::string(TextTokenizer(lineStart, end).restOfLine());
+    };
+    
+    for (; !tokenizer.atEnd(); tokenizer.nextLine()) {
+        const char* lineStart = tokenizer.position();
+        std::string_view keyword = tokenizer.token();
+        
+        if (keyword == "v") {
+            // Vertex position
+            glm::vec3 pos;
+            if (!tokenizer.read(pos.x) || !tokenizer.read(pos.y) || !tokenizer.read(pos.z)) {
+                return fail(lineStart,
+                    "Invalid vertex coordinates. Expected: v x y z\n"
+                    "Line content: " + lineContent(lineStart));
+            }
+            chunk.positions.push_back(pos);
+        }
+        else if (keyword == "vn") {
+            // Vertex normal
+            glm::vec3 norm;
+            if (!tokenizer.read(norm.x) || !tokenizer.read(norm.y) || !tokenizer.read(norm.z)) {
+                return fail(lineStart,
+                    "Invalid vertex normal. Expected: vn nx ny nz\n"
+                    "Line content: " + lineContent(lineStart));
+            }
+            chunk.normals.push_back(norm);
+        }
+        else if (keyword == "vt") {
+            // Texture coordinate (counted even when UVs are not imported,
+            // so face texture indices stay valid)
+            glm::vec2 uv;
+            if (!tokenizer.read(uv.x) || !tokenizer.read(uv.y)) {
+                return fail(lineStart,
+                    "Invalid texture coordinate. Expected: vt u v\n"
+                    "Line content: " + lineContent(lineStart));
+            }
+            if (options.flipV) {
+                uv.y = 1.0f - uv.y;
+            }
+            chunk.texCoords.push_back(uv);
+        }
+        else if (keyword == "f") {
+            // Face
+            uint32_t faceSize = 0;
+            for (std::string_view spec = tokenizer.token(); !spec.empty(); spec = tokenizer.token()) {
+                int vIdx = 0, vtIdx = 0, vnIdx = 0;
+                
+                if (!parseFaceVertex(spec, vIdx, vtIdx, vnIdx)) {
+                    return fail(lineStart,
+                        "Invalid face vertex format: '" + std::string(spec) + "'\n"
+                        "Expected format: v, v/vt, v/vt/vn, or v//vn");
+                }
+                
+                // Negative (relative) indices: resolve against this chunk's
+                // counts now, add earlier chunks' counts when stitching
+                uint8_t flags = 0;
+                if (vIdx < 0) {
+                    vIdx = static_cast<int>(chunk.positions.size()) + vIdx + 1;
+                    flags |= RELATIVE_POSITION;
+                }
+                if (vtIdx < 0) {
+                    vtIdx = static_cast<int>(chunk.texCoords.size()) + vtIdx + 1;
+                    flags |= RELATIVE_TEXCOORD;
+                }
+                if (vnIdx < 0) {
+                    vnIdx = static_cast<int>(chunk.normals.size()) + vnIdx + 1;
+                    flags |= RELATIVE_NORMAL;
+                }
+                if (flags != 0 || !chunk.relative.empty()) {
+                    chunk.relative.resize(chunk.corners.size(), 0);
+                    chunk.relative.push_back(flags);
+                }
+                
+                chunk.corners.push_back({vIdx, vtIdx, vnIdx});
+                ++faceSize;
+            }
+            
+            if (faceSize < 3) {
+                return fail(lineStart,
+                    "Face has only " + std::to_string(faceSize) + " vertices.\n"
+                    "A face must have at least 3 vertices to form a polygon.");
+            }
+            
+            chunk.faceSizes.push_back(faceSize);
+        }
+        // Skip comments, blank lines and other keywords (o, g, s, usemtl, mtllib, etc.)
     }
-    
-    std::string dataStr(static_cast<const char*>(data), size);
-    std::istringstream stream(dataStr);
-    
-    return importFromStream(stream, options, progress);
 }
 
-bool OBJImporter::parseFaceVertex(const std::string& spec,
+bool OBJImporter::parseFaceVertex(std::string_view spec,
                                    int& vertexIdx,
                                    int& texCoordIdx,
                                    int& normalIdx) {
@@ -413,56 +652,34 @@ bool OBJImporter::parseFaceVertex(const std::string& spec,
     // Find slashes
     size_t slash1 = spec.find('/');
     
-    if (slash1 == std::string::npos) {
+    if (slash1 == std::string_view::npos) {
         // Just vertex index: v
-        try {
-            vertexIdx = std::stoi(spec);
-        } catch (...) {
-            return false;
-        }
-        return true;
+        return TextTokenizer::parseNumber(spec, vertexIdx);
     }
     
     // Parse vertex index
-    try {
-        vertexIdx = std::stoi(spec.substr(0, slash1));
-    } catch (...) {
+    if (!TextTokenizer::parseNumber(spec.substr(0, slash1), vertexIdx)) {
         return false;
     }
     
     size_t slash2 = spec.find('/', slash1 + 1);
     
-    if (slash2 == std::string::npos) {
+    if (slash2 == std::string_view::npos) {
         // Vertex and texture: v/vt
-        std::string texStr = spec.substr(slash1 + 1);
-        if (!texStr.empty()) {
-            try {
-                texCoordIdx = std::stoi(texStr);
-            } catch (...) {
-                return false;
-            }
-        }
-        return true;
+        std::string_view texStr = spec.substr(slash1 + 1);
+        return texStr.empty() || TextTokenizer::parseNumber(texStr, texCoordIdx);
     }
     
     // Three parts: v/vt/vn or v//vn
-    std::string texStr = spec.substr(slash1 + 1, slash2 - slash1 - 1);
-    std::string normStr = spec.substr(slash2 + 1);
-    
-    if (!texStr.empty()) {
-        try {
-            texCoordIdx = std::stoi(texStr);
-        } catch (...) {
-            return false;
-        }
+    std::string_view texStr = spec.substr(slash1 + 1, slash2 - slash1 - 1);
+    std::string_view normStr = spec.substr(slash2 + 1);
+    
+    if (!texStr.empty() && !TextTokenizer::parseNumber(texStr, texCoordIdx)) {
+        return false;
     }
     
-    if (!normStr.empty()) {
-        try {
-            normalIdx = std::stoi(normStr);
-        } catch (...) {
-            return false;
-        }
+    if (!normStr.empty() && !TextTokenizer::parseNumber(normStr, normalIdx)) {
+        return false;
     }
     
     return true;
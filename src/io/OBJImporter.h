@@ -4,13 +4,16 @@
  * 
  * Supports importing vertex positions, normals, texture coordinates,
  * and faces (triangles and quads with automatic triangulation).
+ * Files are memory-mapped and tokenized in parallel chunks.
  */
 
 #pragma once
 
 #include "../geometry/MeshData.h"
+#include "MeshSink.h"
 
 #include <string>
+#include <string_view>
 #include <filesystem>
 #include <istream>
 
@@ -38,6 +41,9 @@ struct OBJImportOptions {
     
     /// Ignore materials (MTL files)
     bool ignoreMaterials = true;
+    
+    /// Optional: receives geometry in chunks while the file is decoded
+    MeshSink* sink = nullptr;
 };
 
 /**
@@ -107,6 +113,26 @@ public:
         geometry::ProgressCallback progress = nullptr);
 
 private:
+    /// Elements parsed from one chunk of the file (defined in the .cpp)
+    struct Chunk;
+    
+    /**
+     * @brief Import OBJ text held in memory
+     * 
+     * The text is split into newline-aligned chunks that are tokenized in
+     * parallel; face indices are then stitched into the file's global
+     * index space and the mesh is assembled.
+     */
+    static geometry::Result<geometry::MeshData> importFromData(
+        const char* data,
+        size_t size,
+        const OBJImportOptions& options,
+        geometry::ProgressCallback progress);
+    
+    /// Tokenize the elements of one newline-aligned chunk
+    static void parseChunk(const char* begin, const char* end,
+                           const OBJImportOptions& options, Chunk& chunk);
+    
     /**
      * @brief Parse face vertex specification (v, v/vt, v/vt/vn, or v//vn)
      * @param spec Face vertex specification string
@@ -115,7 +141,7 @@ private:
      * @param normalIdx Output normal index (0 if not present)
      * @return true if parsed successfully
      */
-    static bool parseFaceVertex(const std::string& spec,
+    static bool parseFaceVertex(std::string_view spec,
                                 int& vertexIdx,
                                 int& texCoordIdx,
                                 int& normalIdx);
@@ -4,6 +4,9 @@
  */
 
 #include "PLYImporter.h"
+#include "MappedFile.h"
+#include "TextTokenizer.h"
+#include "../core/TaskScheduler.h"
 
 #include <fstream>
 #include <sstream>
@@ -11,6 +14,17 @@
 #include <cstring>
 #include <bit>
 #include <cstdint>
+#include <atomic>
+
+// SIMD byte swapping for big-endian files: SSE2 is baseline on x86-64 and
+// NEON on AArch64; anything else uses the scalar fallback
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define DC3D_PLY_SIMD_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define DC3D_PLY_SIMD_NEON 1
+#endif
 
 namespace dc3d {
 namespace io {
@@ -20,6 +34,12 @@ namespace {
 // Maximum list size to prevent DoS attacks (CRITICAL FIX)
 constexpr int64_t MAX_LIST_SIZE = 10000000;  // 10M elements max
 
+// ASCII body text parsed per parallel chunk
+constexpr size_t PLY_ASCII_CHUNK_BYTES = 4 << 20;
+
+// Binary records decoded per parallel chunk
+constexpr size_t PLY_BINARY_GRAIN = 65536;
+
 // MEDIUM FIX: RAII guard for stream position restoration on error
 struct StreamPositionGuard {
     std::istream& stream;
@@ -52,6 +72,68 @@ bool isSystemLittleEndian() {
     return *reinterpret_cast<uint8_t*>(&test) == 0x01;
 }
 
+// Reverse the byte order of a single value
+void reverseBytes(void* data, size_t size) {
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    for (size_t i = 0; i < size / 2; ++i) {
+        std::swap(bytes[i], bytes[size - 1 - i]);
+    }
+}
+
+// Reverse the byte order of each 32-bit word in place
+void byteSwap32(uint32_t* words, size_t count) {
+    size_t i = 0;
+#if defined(DC3D_PLY_SIMD_SSE)
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+        // Swap bytes within each 16-bit half, then swap the halves
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(words + i), v);
+    }
+#elif defined(DC3D_PLY_SIMD_NEON)
+    for (; i + 4 <= count; i += 4) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(words + i));
+        vst1q_u8(reinterpret_cast<uint8_t*>(words + i), vrev32q_u8(v));
+    }
+#endif
+    for (; i < count; ++i) {
+        reverseBytes(&words[i], sizeof(uint32_t));
+    }
+}
+
+// Load a value from possibly unaligned memory
+template<typename T>
+T loadValue(const char* data, bool swap) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    if (swap && sizeof(T) > 1) {
+        reverseBytes(&value, sizeof(T));
+    }
+    return value;
+}
+
+// Size of the header including the end_header line (0 if not found)
+size_t findHeaderSize(const char* data, size_t size) {
+    TextTokenizer tokenizer(data, data + size);
+    for (; !tokenizer.atEnd(); tokenizer.nextLine()) {
+        if (tokenizer.token() == "end_header") {
+            tokenizer.nextLine();
+            return static_cast<size_t>(tokenizer.position() - data);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Output of one newline-aligned chunk of an ASCII PLY body
+ */
+struct ASCIIChunk {
+    std::vector<uint32_t> triangles;   ///< Fan-triangulated face indices
+    std::string error;                 ///< First error in this chunk, if any
+};
+
 } // anonymous namespace
 
 geometry::Result<geometry::MeshData> PLYImporter::import(
@@ -72,7 +154,14 @@ geometry::Result<geometry::MeshData> PLYImporter::import(
             "File is empty: " + path.string());
     }
     
-    // Open file in binary mode (we'll handle ASCII separately)
+    // Decode straight from a memory map
+    MappedFile mapped;
+    std::string mapError;
+    if (mapped.open(path, &mapError)) {
+        return importFromData(mapped.data(), mapped.size(), options, progress);
+    }
+    
+    // Mapping can fail on exotic filesystems; fall back to streaming
     std::ifstream file(path, std::ios::in | std::ios::binary);
     if (!file) {
         return geometry::Result<geometry::MeshData>::failure(
@@ -93,14 +182,9 @@ geometry::Result<geometry::MeshData> PLYImporter::importFromStream(
         return geometry::Result<geometry::MeshData>::failure(headerResult.error);
     }
     
-    const Header& header = *headerResult.value;
-    
-    // Import based on format
-    if (header.format == Format::ASCII) {
-        return readASCII(stream, header, options, progress);
-    } else {
-        return readBinary(stream, header, options, progress);
-    }
+    // Bodies are decoded from memory
+    std::string body = TextTokenizer::readAll(stream);
+    return readBody(*headerResult.value, body.data(), body.data() + body.size(), options, progress);
 }
 
 geometry::Result<geometry::MeshData> PLYImporter::importFromMemory(
@@ -113,10 +197,38 @@ geometry::Result<geometry::MeshData> PLYImporter::importFromMemory(
         return geometry::Result<geometry::MeshData>::failure("Empty data");
     }
     
-    std::string dataStr(static_cast<const char*>(data), size);
-    std::istringstream stream(dataStr, std::ios::binary);
+    return importFromData(static_cast<const char*>(data), size, options, progress);
+}
+
+geometry::Result<geometry::MeshData> PLYImporter::importFromData(
+    const char* data,
+    size_t size,
+    const PLYImportOptions& options,
+    geometry::ProgressCallback progress) {
+    
+    size_t headerSize = findHeaderSize(data, size);
+    std::istringstream headerStream(std::string(data, headerSize));
+    auto headerResult = parseHeader(headerStream);
+    if (!headerResult) {
+        return geometry::Result<geometry::MeshData>::failure(headerResult.error);
+    }
+    
+    return readBody(*headerResult.value, data + headerSize, data + size, options, progress);
+}
+
+geometry::Result<geometry::MeshData> PLYImporter::readBody(
+    const Header& header,
+    const char* begin,
+    const char* end,
+    const PLYImportOptions& options,
+    geometry::ProgressCallback progress) {
     
-    return importFromStream(stream, options, progress);
+    // Import based on format
+    if (header.format == Format::ASCII) {
+        return readASCII(begin, end, header, options, progress);
+    } else {
+        return readBinary(begin, end, header, options, progress);
+    }
 }
 
 geometry::Result<PLYImporter::Header> PLYImporter::parseHeader(std::istream& stream) {
@@ -261,71 +373,95 @@ size_t PLYImporter::dataTypeSize(DataType type) {
     }
 }
 
-void PLYImporter::swapBytes(void* data, size_t size) {
-    uint8_t* bytes = static_cast<uint8_t*>(data);
-    for (size_t i = 0; i < size / 2; ++i) {
-        std::swap(bytes[i], bytes[size - 1 - i]);
-    }
-}
-
-template<typename T>
-T PLYImporter::readBinaryValue(std::istream& stream, bool swapBytes) {
-    T value;
-    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
-    if (swapBytes && sizeof(T) > 1) {
-        PLYImporter::swapBytes(&value, sizeof(T));
-    }
-    return value;
-}
-
-double PLYImporter::readBinaryAsDouble(std::istream& stream, DataType type, bool swap) {
+float PLYImporter::loadAsFloat(const char* data, DataType type, bool swap) {
     switch (type) {
         case DataType::Int8:
-            return static_cast<double>(readBinaryValue<int8_t>(stream, swap));
+            return static_cast<float>(loadValue<int8_t>(data, swap));
         case DataType::UInt8:
-            return static_cast<double>(readBinaryValue<uint8_t>(stream, swap));
+            return static_cast<float>(loadValue<uint8_t>(data, swap));
         case DataType::Int16:
-            return static_cast<double>(readBinaryValue<int16_t>(stream, swap));
+            return static_cast<float>(loadValue<int16_t>(data, swap));
         case DataType::UInt16:
-            return static_cast<double>(readBinaryValue<uint16_t>(stream, swap));
+            return static_cast<float>(loadValue<uint16_t>(data, swap));
         case DataType::Int32:
-            return static_cast<double>(readBinaryValue<int32_t>(stream, swap));
+            return static_cast<float>(loadValue<int32_t>(data, swap));
         case DataType::UInt32:
-            return static_cast<double>(readBinaryValue<uint32_t>(stream, swap));
+            return static_cast<float>(loadValue<uint32_t>(data, swap));
         case DataType::Float32:
-            return static_cast<double>(readBinaryValue<float>(stream, swap));
+            return loadValue<float>(data, swap);
         case DataType::Float64:
-            return readBinaryValue<double>(stream, swap);
+            return static_cast<float>(loadValue<double>(data, swap));
         default:
-            return 0.0;
+            return 0.0f;
     }
 }
 
-int64_t PLYImporter::readBinaryAsInt(std::istream& stream, DataType type, bool swap) {
+int64_t PLYImporter::loadAsInt(const char* data, DataType type, bool swap) {
     switch (type) {
         case DataType::Int8:
-            return static_cast<int64_t>(readBinaryValue<int8_t>(stream, swap));
+            return static_cast<int64_t>(loadValue<int8_t>(data, swap));
         case DataType::UInt8:
-            return static_cast<int64_t>(readBinaryValue<uint8_t>(stream, swap));
+            return static_cast<int64_t>(loadValue<uint8_t>(data, swap));
         case DataType::Int16:
-            return static_cast<int64_t>(readBinaryValue<int16_t>(stream, swap));
+            return static_cast<int64_t>(loadValue<int16_t>(data, swap));
         case DataType::UInt16:
-            return static_cast<int64_t>(readBinaryValue<uint16_t>(stream, swap));
+            return static_cast<int64_t>(loadValue<uint16_t>(data, swap));
         case DataType::Int32:
-            return static_cast<int64_t>(readBinaryValue<int32_t>(stream, swap));
+            return static_cast<int64_t>(loadValue<int32_t>(data, swap));
         case DataType::UInt32:
-            return static_cast<int64_t>(readBinaryValue<uint32_t>(stream, swap));
+            return static_cast<int64_t>(loadValue<uint32_t>(data, swap));
         case DataType::Float32:
-            return static_cast<int64_t>(readBinaryValue<float>(stream, swap));
+            return static_cast<int64_t>(loadValue<float>(data, swap));
         case DataType::Float64:
-            return static_cast<int64_t>(readBinaryValue<double>(stream, swap));
+            return static_cast<int64_t>(loadValue<double>(data, swap));
         default:
             return 0;
     }
 }
 
+PLYImporter::ElementLayout PLYImporter::compileLayout(const Element& element) {
+    ElementLayout layout;
+    layout.offsets.reserve(element.properties.size());
+    
+    size_t offset = 0;
+    for (const auto& prop : element.properties) {
+        if (prop.isList) {
+            // Records vary in size; only the leading fixed part is known
+            layout.fixedSize = false;
+            break;
+        }
+        layout.offsets.push_back(offset);
+        offset += dataTypeSize(prop.type);
+    }
+    layout.recordSize = layout.fixedSize ? offset : 0;
+    return layout;
+}
+
+const char* PLYImporter::skipRecord(const char* record, const char* end,
+                                    const Element& element, bool swap, int64_t* badListSize) {
+    const char* pos = record;
+    for (const auto& prop : element.properties) {
+        if (!prop.isList) {
+            pos += dataTypeSize(prop.type);
+            continue;
+        }
+        size_t sizeBytes = dataTypeSize(prop.listSizeType);
+        if (static_cast<size_t>(end - pos) < sizeBytes) return nullptr;
+        int64_t listSize = loadAsInt(pos, prop.listSizeType, swap);
+        // CRITICAL FIX: Bounds check for list size to prevent DoS
+        if (listSize < 0 || listSize > MAX_LIST_SIZE) {
+            if (badListSize) *badListSize = listSize;
+            return nullptr;
+        }
+        pos += sizeBytes + static_cast<size_t>(listSize) * dataTypeSize(prop.listElementType);
+        if (pos > end) return nullptr;
+    }
+    return pos <= end ? pos : nullptr;
+}
+
 geometry::Result<geometry::MeshData> PLYImporter::readASCII(
-    std::istream& stream,
+    const char* begin,
+    const char* end,
     const Header& header,
     const PLYImportOptions& options,
     geometry::ProgressCallback progress) {
@@ -344,7 +480,6 @@ geometry::Result<geometry::MeshData> PLYImporter::readASCII(
     // Find property indices for vertex element
     int xIdx = -1, yIdx = -1, zIdx = -1;
     int nxIdx = -1, nyIdx = -1, nzIdx = -1;
-    int redIdx = -1, greenIdx = -1, blueIdx = -1;
     
     for (size_t i = 0; i < vertexElem->properties.size(); ++i) {
         const auto& prop = vertexElem->properties[i];
@@ -354,9 +489,6 @@ geometry::Result<geometry::MeshData> PLYImporter::readASCII(
         else if (prop.name == "nx") nxIdx = static_cast<int>(i);
         else if (prop.name == "ny") nyIdx = static_cast<int>(i);
         else if (prop.name == "nz") nzIdx = static_cast<int>(i);
-        else if (prop.name == "red") redIdx = static_cast<int>(i);
-        else if (prop.name == "green") greenIdx = static_cast<int>(i);
-        else if (prop.name == "blue") blueIdx = static_cast<int>(i);
     }
     
     if (xIdx < 0 || yIdx < 0 || zIdx < 0) {
@@ -379,118 +511,178 @@ geometry::Result<geometry::MeshData> PLYImporter::readASCII(
         }
     }
     
-    // Reserve space
-    mesh.reserveVertices(vertexElem->count);
-    if (faceElem) {
-        mesh.reserveFaces(faceElem->count);
+    // Every element record is one line: element e occupies the body lines
+    // [firstLine[e], firstLine[e] + count). Faces may only reference
+    // vertices of a vertex element that precedes them.
+    const size_t elementCount = header.elements.size();
+    std::vector<size_t> firstLine(elementCount + 1, 0);
+    size_t verticesBeforeFaces = 0;
+    for (size_t e = 0; e < elementCount; ++e) {
+        firstLine[e + 1] = firstLine[e] + header.elements[e].count;
+        if (&header.elements[e] == vertexElem && (!faceElem || faceElem > vertexElem)) {
+            verticesBeforeFaces = vertexElem->count;
+        }
+    }
+    
+    // Newline-aligned chunks; the line count of each gives its first line
+    std::vector<const char*> bounds = TextTokenizer::splitLines(begin, end, PLY_ASCII_CHUNK_BYTES);
+    const size_t chunkCount = bounds.size() - 1;
+    std::vector<size_t> chunkFirstLine(chunkCount + 1, 0);
+    core::parallelFor(0, chunkCount, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+            chunkFirstLine[c + 1] = TextTokenizer::countLines(bounds[c], bounds[c + 1]);
+        }
+    }, 1);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        chunkFirstLine[c + 1] += chunkFirstLine[c];
+    }
+    const size_t availableLines = chunkFirstLine[chunkCount] + (end > begin && end[-1] != '\n' ? 1 : 0);
+    
+    for (size_t e = 0; e < elementCount; ++e) {
+        const Element& element = header.elements[e];
+        const bool required = &element == vertexElem || (&element == faceElem && faceListIdx >= 0);
+        if (required && firstLine[e + 1] > availableLines) {
+            size_t missingAt = availableLines > firstLine[e] ? availableLines - firstLine[e] : 0;
+            return geometry::Result<geometry::MeshData>::failure(
+                "Unexpected end of file reading " + std::string(&element == vertexElem ? "vertex " : "face ") +
+                std::to_string(missingAt));
+        }
+    }
+    
+    // Vertices are written straight into place; faces are gathered per chunk
+    auto& meshVertices = mesh.editVertices();
+    auto& meshNormals = mesh.editNormals();
+    auto& meshIndices = mesh.editIndices();
+    meshVertices.resize(vertexElem->count);
+    if (hasNormals) {
+        meshNormals.resize(vertexElem->count);
     }
     
     size_t totalElements = vertexElem->count + (faceElem ? faceElem->count : 0);
     bool reportProgress = progress && totalElements > options.progressThreshold;
-    size_t elementsProcessed = 0;
     
-    // Read all elements in order
-    for (const auto& element : header.elements) {
-        std::string line;
-        
-        if (element.name == "vertex") {
-            // Read vertices
-            for (size_t v = 0; v < element.count; ++v) {
-                if (!std::getline(stream, line)) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Unexpected end of file reading vertex " + std::to_string(v));
-                }
-                
-                std::istringstream iss(trim(line));
-                std::vector<double> values(element.properties.size());
+    std::vector<ASCIIChunk> chunks(chunkCount);
+    core::ParallelProgress reporter(reportProgress ? progress : nullptr,
+                                    static_cast<size_t>(end - begin), 0.0f, 0.95f);
+    
+    // Chunks are parsed in waves; faces are appended in file order after
+    // each one. Without a sink the whole body is a single wave; when
+    // streaming, a wave holds one chunk per worker and the decoded prefix
+    // is delivered before the next starts.
+    MeshStreamer streamer(options.sink);
+    streamer.begin(vertexElem->count, faceElem ? faceElem->count : 0);
+    const size_t waveSize = streamer.active()
+        ? std::max<size_t>(1, core::TaskScheduler::instance().threadCount())
+        : chunkCount;
+    const size_t vertexFirstLine = firstLine[static_cast<size_t>(vertexElem - header.elements.data())];
+    
+    for (size_t wave = 0; wave < chunkCount; wave += waveSize) {
+        const size_t waveEnd = std::min(wave + waveSize, chunkCount);
+        bool completed = core::parallelFor(wave, waveEnd, [&](size_t chunkBegin, size_t chunkEnd) {
+            std::vector<double> values(vertexElem->properties.size());
+            std::vector<uint32_t> indices;
+            
+            for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+                ASCIIChunk& chunk = chunks[c];
+                TextTokenizer tokenizer(bounds[c], bounds[c + 1]);
+                size_t line = chunkFirstLine[c];
+                size_t e = static_cast<size_t>(
+                    std::upper_bound(firstLine.begin(), firstLine.end(), line) - firstLine.begin()) - 1;
                 
-                for (size_t p = 0; p < element.properties.size(); ++p) {
-                    if (!(iss >> values[p])) {
-                        return geometry::Result<geometry::MeshData>::failure(
-                            "Failed to parse vertex " + std::to_string(v));
+                for (; !tokenizer.atEnd() && e < elementCount; tokenizer.nextLine(), ++line) {
+                    while (e < elementCount && line >= firstLine[e + 1]) ++e;
+                    if (e >= elementCount) break;
+                    
+                    const Element& element = header.elements[e];
+                    const size_t record = line - firstLine[e];
+                    
+                    if (&element == vertexElem) {
+                        for (size_t p = 0; p < values.size(); ++p) {
+                            if (!tokenizer.read(values[p])) {
+                                chunk.error = "Failed to parse vertex " + std::to_string(record);
+                                break;
+                            }
+                        }
+                        if (!chunk.error.empty()) break;
+                        
+                        meshVertices[record] = glm::vec3(
+                            static_cast<float>(values[xIdx]),
+                            static_cast<float>(values[yIdx]),
+                            static_cast<float>(values[zIdx])
+                        );
+                        if (hasNormals) {
+                            meshNormals[record] = glm::vec3(
+                                static_cast<float>(values[nxIdx]),
+                                static_cast<float>(values[nyIdx]),
+                                static_cast<float>(values[nzIdx])
+                            );
+                        }
                     }
-                }
-                
-                glm::vec3 pos(
-                    static_cast<float>(values[xIdx]),
-                    static_cast<float>(values[yIdx]),
-                    static_cast<float>(values[zIdx])
-                );
-                
-                if (hasNormals) {
-                    glm::vec3 norm(
-                        static_cast<float>(values[nxIdx]),
-                        static_cast<float>(values[nyIdx]),
-                        static_cast<float>(values[nzIdx])
-                    );
-                    mesh.addVertex(pos, norm);
-                } else {
-                    mesh.addVertex(pos);
-                }
-                
-                ++elementsProcessed;
-                if (reportProgress && (elementsProcessed % 100000 == 0)) {
-                    if (!progress(static_cast<float>(elementsProcessed) / totalElements)) {
-                        return geometry::Result<geometry::MeshData>::failure(
-                            "Import cancelled");
+                    else if (&element == faceElem && faceListIdx >= 0) {
+                        // Skip properties before the face list
+                        for (int p = 0; p < faceListIdx; ++p) {
+                            tokenizer.token();
+                        }
+                        
+                        // Read face list
+                        int vertexCount = 0;
+                        if (!tokenizer.read(vertexCount) || vertexCount < 3) {
+                            chunk.error = "Face " + std::to_string(record) + " has fewer than 3 vertices";
+                            break;
+                        }
+                        
+                        indices.resize(static_cast<size_t>(vertexCount));
+                        for (int i = 0; i < vertexCount; ++i) {
+                            if (!tokenizer.read(indices[i]) || indices[i] >= verticesBeforeFaces) {
+                                chunk.error = "Face " + std::to_string(record) + " has invalid vertex index";
+                                break;
+                            }
+                        }
+                        if (!chunk.error.empty()) break;
+                        
+                        // Triangulate (fan triangulation)
+                        for (int i = 1; i < vertexCount - 1; ++i) {
+                            chunk.triangles.insert(chunk.triangles.end(),
+                                                   {indices[0], indices[i], indices[i + 1]});
+                        }
                     }
+                    // Records of other elements are skipped
                 }
+                
+                reporter.advance(static_cast<size_t>(bounds[c + 1] - bounds[c]));
             }
+        }, 1, &reporter.token());
+        
+        if (!completed) {
+            return geometry::Result<geometry::MeshData>::failure(
+                "Import cancelled");
         }
-        else if (element.name == "face" && faceListIdx >= 0) {
-            // Read faces
-            for (size_t f = 0; f < element.count; ++f) {
-                if (!std::getline(stream, line)) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Unexpected end of file reading face " + std::to_string(f));
-                }
-                
-                std::istringstream iss(trim(line));
-                
-                // Skip properties before the face list
-                for (int p = 0; p < faceListIdx; ++p) {
-                    double dummy;
-                    iss >> dummy;
-                }
-                
-                // Read face list
-                int vertexCount;
-                iss >> vertexCount;
-                
-                if (vertexCount < 3) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Face " + std::to_string(f) + " has fewer than 3 vertices");
-                }
-                
-                std::vector<uint32_t> indices(vertexCount);
-                for (int i = 0; i < vertexCount; ++i) {
-                    iss >> indices[i];
-                    
-                    if (indices[i] >= mesh.vertexCount()) {
-                        return geometry::Result<geometry::MeshData>::failure(
-                            "Face " + std::to_string(f) + " has invalid vertex index");
-                    }
-                }
-                
-                // Triangulate (fan triangulation)
-                for (int i = 1; i < vertexCount - 1; ++i) {
-                    mesh.addFace(indices[0], indices[i], indices[i + 1]);
-                }
-                
-                ++elementsProcessed;
-                if (reportProgress && (elementsProcessed % 100000 == 0)) {
-                    if (!progress(static_cast<float>(elementsProcessed) / totalElements)) {
-                        return geometry::Result<geometry::MeshData>::failure(
-                            "Import cancelled");
-                    }
-                }
+        
+        // Append faces in file order
+        std::vector<size_t> offsets(waveEnd - wave + 1, meshIndices.size());
+        for (size_t c = wave; c < waveEnd; ++c) {
+            if (!chunks[c].error.empty()) {
+                return geometry::Result<geometry::MeshData>::failure(chunks[c].error);
             }
+            offsets[c - wave + 1] = offsets[c - wave] + chunks[c].triangles.size();
         }
-        else {
-            // Skip unknown elements
-            for (size_t i = 0; i < element.count; ++i) {
-                std::getline(stream, line);
+        
+        meshIndices.resize(offsets[waveEnd - wave]);
+        core::parallelFor(wave, waveEnd, [&](size_t chunkBegin, size_t chunkEnd) {
+            for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+                std::copy(chunks[c].triangles.begin(), chunks[c].triangles.end(),
+                          meshIndices.begin() + static_cast<std::ptrdiff_t>(offsets[c - wave]));
+                std::vector<uint32_t>().swap(chunks[c].triangles);
             }
+        }, 1);
+        
+        // Vertex records on the lines parsed so far are complete
+        const size_t linesDone = waveEnd == chunkCount ? availableLines : chunkFirstLine[waveEnd];
+        const size_t verticesDone = std::min(vertexElem->count,
+            linesDone > vertexFirstLine ? linesDone - vertexFirstLine : 0);
+        if (!streamer.flush(mesh.vertices(), verticesDone, mesh.indices(), mesh.indices().size())) {
+            return geometry::Result<geometry::MeshData>::failure(
+                "Import cancelled");
         }
     }
     
@@ -509,7 +701,8 @@ geometry::Result<geometry::MeshData> PLYImporter::readASCII(
 }
 
 geometry::Result<geometry::MeshData> PLYImporter::readBinary(
-    std::istream& stream,
+    const char* begin,
+    const char* end,
     const Header& header,
     const PLYImportOptions& options,
     geometry::ProgressCallback progress) {
@@ -568,169 +761,330 @@ geometry::Result<geometry::MeshData> PLYImporter::readBinary(
         }
     }
     
-    // Reserve space
-    mesh.reserveVertices(vertexElem->count);
-    if (faceElem) {
-        mesh.reserveFaces(faceElem->count);
-    }
-    
     size_t totalElements = vertexElem->count + (faceElem ? faceElem->count : 0);
     bool reportProgress = progress && totalElements > options.progressThreshold;
-    size_t elementsProcessed = 0;
+    core::ParallelProgress reporter(reportProgress ? progress : nullptr, totalElements, 0.0f, 0.95f);
+    
+    // Decode a vec3 from three scalar properties of a fixed-size element
+    // into out[first, last). Three consecutive float32 fields are copied
+    // as a block and byte-swapped with SIMD if needed.
+    auto decodeVec3 = [&](const char* records, const ElementLayout& layout, const Element& element,
+                          const int fields[3], glm::vec3* out, size_t first, size_t last) {
+        const size_t stride = layout.recordSize;
+        const size_t offset = layout.offsets[fields[0]];
+        const bool packedFloats =
+            element.properties[fields[0]].type == DataType::Float32 &&
+            element.properties[fields[1]].type == DataType::Float32 &&
+            element.properties[fields[2]].type == DataType::Float32 &&
+            layout.offsets[fields[1]] == offset + 4 &&
+            layout.offsets[fields[2]] == offset + 8;
+        
+        if (packedFloats) {
+            static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be tightly packed");
+            for (size_t i = first; i < last; ++i) {
+                std::memcpy(&out[i], records + i * stride + offset, sizeof(glm::vec3));
+            }
+            if (needSwap) {
+                byteSwap32(reinterpret_cast<uint32_t*>(&out[first]), (last - first) * 3);
+            }
+            return;
+        }
+        
+        for (size_t i = first; i < last; ++i) {
+            const char* record = records + i * stride;
+            out[i] = glm::vec3(
+                loadAsFloat(record + layout.offsets[fields[0]], element.properties[fields[0]].type, needSwap),
+                loadAsFloat(record + layout.offsets[fields[1]], element.properties[fields[1]].type, needSwap),
+                loadAsFloat(record + layout.offsets[fields[2]], element.properties[fields[2]].type, needSwap));
+        }
+    };
+    
+    MeshStreamer streamer(options.sink);
+    streamer.begin(vertexElem->count, faceElem ? faceElem->count : 0);
+    
+    const char* pos = begin;
+    size_t verticesDecoded = 0;
     
     // Read all elements in order
     for (const auto& element : header.elements) {
-        if (element.name == "vertex") {
-            // Read vertices
-            for (size_t v = 0; v < element.count; ++v) {
-                std::vector<double> values(element.properties.size());
+        const ElementLayout layout = compileLayout(element);
+        
+        if (&element == vertexElem) {
+            const int positionFields[3] = {xIdx, yIdx, zIdx};
+            const int normalFields[3] = {nxIdx, nyIdx, nzIdx};
+            auto& meshVertices = mesh.editVertices();
+            auto& meshNormals = mesh.editNormals();
+            meshVertices.resize(element.count);
+            if (hasNormals) {
+                meshNormals.resize(element.count);
+            }
+            
+            if (layout.fixedSize) {
+                // Fixed-size records: decode blocks in parallel
+                size_t available = static_cast<size_t>(end - pos) / std::max<size_t>(layout.recordSize, 1);
+                if (available < element.count) {
+                    return geometry::Result<geometry::MeshData>::failure(
+                        "Failed to read vertex " + std::to_string(available));
+                }
+                
+                bool completed = core::parallelFor(0, element.count, [&](size_t first, size_t last) {
+                    decodeVec3(pos, layout, element, positionFields, meshVertices.data(), first, last);
+                    if (hasNormals) {
+                        decodeVec3(pos, layout, element, normalFields, meshNormals.data(), first, last);
+                    }
+                    reporter.advance(last - first);
+                }, PLY_BINARY_GRAIN, &reporter.token());
                 
-                for (size_t p = 0; p < element.properties.size(); ++p) {
-                    const auto& prop = element.properties[p];
-                    if (prop.isList) {
-                        // Skip list properties in vertex (unusual)
-                        int64_t listSize = readBinaryAsInt(stream, prop.listSizeType, needSwap);
-                        // CRITICAL FIX: Bounds check for list size to prevent DoS
-                        if (listSize < 0 || listSize > MAX_LIST_SIZE) {
+                if (!completed) {
+                    return geometry::Result<geometry::MeshData>::failure(
+                        "Import cancelled");
+                }
+                pos += element.count * layout.recordSize;
+            } else {
+                // List properties in vertex records (unusual): walk records
+                for (size_t v = 0; v < element.count; ++v) {
+                    int64_t badListSize = 0;
+                    const char* next = skipRecord(pos, end, element, needSwap, &badListSize);
+                    if (!next) {
+                        if (badListSize != 0) {
                             return geometry::Result<geometry::MeshData>::failure(
-                                "Invalid list size in binary PLY: " + std::to_string(listSize));
+                                "Invalid list size in binary PLY: " + std::to_string(badListSize));
                         }
-                        for (int64_t i = 0; i < listSize; ++i) {
-                            readBinaryAsDouble(stream, prop.listElementType, needSwap);
+                        return geometry::Result<geometry::MeshData>::failure(
+                            "Failed to read vertex " + std::to_string(v));
+                    }
+                    
+                    // Locate the scalar fields of this record
+                    float values[6] = {};
+                    const int fields[6] = {xIdx, yIdx, zIdx, nxIdx, nyIdx, nzIdx};
+                    const char* field = pos;
+                    for (size_t p = 0; p < element.properties.size(); ++p) {
+                        const auto& prop = element.properties[p];
+                        for (int f = 0; f < 6; ++f) {
+                            if (fields[f] == static_cast<int>(p)) {
+                                values[f] = loadAsFloat(field, prop.type, needSwap);
+                            }
+                        }
+                        field += prop.isList
+                            ? dataTypeSize(prop.listSizeType) +
+                              static_cast<size_t>(loadAsInt(field, prop.listSizeType, needSwap)) *
+                              dataTypeSize(prop.listElementType)
+                            : dataTypeSize(prop.type);
+                    }
+                    
+                    meshVertices[v] = glm::vec3(values[0], values[1], values[2]);
+                    if (hasNormals) {
+                        meshNormals[v] = glm::vec3(values[3], values[4], values[5]);
+                    }
+                    pos = next;
+                    
+                    if ((v + 1) % PLY_BINARY_GRAIN == 0) {
+                        reporter.advance(PLY_BINARY_GRAIN);
+                        if (reporter.isCancelled()) {
+                            return geometry::Result<geometry::MeshData>::failure(
+                                "Import cancelled");
                         }
-                        values[p] = 0;
-                    } else {
-                        values[p] = readBinaryAsDouble(stream, prop.type, needSwap);
                     }
                 }
-                
-                if (!stream) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Failed to read vertex " + std::to_string(v));
-                }
-                
-                glm::vec3 pos(
-                    static_cast<float>(values[xIdx]),
-                    static_cast<float>(values[yIdx]),
-                    static_cast<float>(values[zIdx])
-                );
-                
-                if (hasNormals) {
-                    glm::vec3 norm(
-                        static_cast<float>(values[nxIdx]),
-                        static_cast<float>(values[nyIdx]),
-                        static_cast<float>(values[nzIdx])
-                    );
-                    mesh.addVertex(pos, norm);
+            }
+            verticesDecoded = element.count;
+            
+            // Faces refer to these, so hand them over before the face element
+            if (!streamer.flush(mesh.vertices(), verticesDecoded, mesh.indices(), 0)) {
+                return geometry::Result<geometry::MeshData>::failure(
+                    "Import cancelled");
+            }
+        }
+        else if (&element == faceElem && faceListIdx >= 0) {
+            // Fixed parts around the index list
+            size_t prefixBytes = 0;
+            size_t suffixBytes = 0;
+            bool otherLists = false;
+            for (size_t p = 0; p < element.properties.size(); ++p) {
+                const auto& prop = element.properties[p];
+                if (static_cast<int>(p) == faceListIdx) continue;
+                if (prop.isList) {
+                    otherLists = true;
+                } else if (static_cast<int>(p) < faceListIdx) {
+                    prefixBytes += dataTypeSize(prop.type);
                 } else {
-                    mesh.addVertex(pos);
+                    suffixBytes += dataTypeSize(prop.type);
                 }
+            }
+            const size_t countBytes = dataTypeSize(faceListSizeType);
+            const size_t indexBytes = dataTypeSize(faceListElemType);
+            
+            // Fast path: every face is a triangle, so records have a fixed
+            // stride and decode in parallel. Verified while decoding; from
+            // the first block with another polygon on, records are walked
+            // sequentially.
+            std::vector<uint32_t>& indices = mesh.editIndices();
+            size_t facesDone = 0;
+            const size_t triangleStride = prefixBytes + countBytes + 3 * indexBytes + suffixBytes;
+            if (!otherLists && static_cast<size_t>(end - pos) / triangleStride >= element.count) {
+                indices.resize(element.count * 3);
+                const bool int32Indices = faceListElemType == DataType::Int32 ||
+                                          faceListElemType == DataType::UInt32;
+                const size_t blockSize = streamer.active() ? STREAM_CHUNK_TRIANGLES : element.count;
                 
-                ++elementsProcessed;
-                if (reportProgress && (elementsProcessed % 100000 == 0)) {
-                    if (!progress(static_cast<float>(elementsProcessed) / totalElements)) {
+                for (size_t block = 0; block < element.count; block += blockSize) {
+                    const size_t blockEnd = std::min(block + blockSize, element.count);
+                    std::atomic<bool> allTriangles{true};
+                    std::atomic<size_t> firstBadFace{blockEnd};
+                    
+                    bool completed = core::parallelFor(block, blockEnd, [&](size_t first, size_t last) {
+                        for (size_t f = first; f < last; ++f) {
+                            const char* record = pos + f * triangleStride + prefixBytes;
+                            if (loadAsInt(record, faceListSizeType, needSwap) != 3) {
+                                allTriangles.store(false, std::memory_order_relaxed);
+                                return;
+                            }
+                            if (int32Indices) {
+                                std::memcpy(&indices[f * 3], record + countBytes, 3 * sizeof(uint32_t));
+                            } else {
+                                for (size_t k = 0; k < 3; ++k) {
+                                    indices[f * 3 + k] = static_cast<uint32_t>(
+                                        loadAsInt(record + countBytes + k * indexBytes, faceListElemType, needSwap));
+                                }
+                            }
+                        }
+                        if (int32Indices && needSwap) {
+                            byteSwap32(&indices[first * 3], (last - first) * 3);
+                        }
+                        for (size_t i = first * 3; i < last * 3; ++i) {
+                            if (indices[i] >= verticesDecoded) {
+                                size_t face = i / 3;
+                                size_t current = firstBadFace.load(std::memory_order_relaxed);
+                                while (face < current &&
+                                       !firstBadFace.compare_exchange_weak(current, face, std::memory_order_relaxed)) {
+                                }
+                                break;
+                            }
+                        }
+                        reporter.advance(last - first);
+                    }, PLY_BINARY_GRAIN, &reporter.token());
+                    
+                    if (!completed && reporter.isCancelled()) {
+                        return geometry::Result<geometry::MeshData>::failure(
+                            "Import cancelled");
+                    }
+                    if (!allTriangles.load()) {
+                        break;
+                    }
+                    if (firstBadFace.load() < blockEnd) {
+                        return geometry::Result<geometry::MeshData>::failure(
+                            "Face " + std::to_string(firstBadFace.load()) + " has invalid vertex index");
+                    }
+                    
+                    facesDone = blockEnd;
+                    if (!streamer.flush(mesh.vertices(), verticesDecoded, indices, facesDone * 3)) {
                         return geometry::Result<geometry::MeshData>::failure(
                             "Import cancelled");
                     }
                 }
+                
+                indices.resize(facesDone * 3);
+                pos += facesDone * triangleStride;
             }
-        }
-        else if (element.name == "face" && faceListIdx >= 0) {
-            // Read faces
-            for (size_t f = 0; f < element.count; ++f) {
-                // Skip properties before the face list
-                for (int p = 0; p < faceListIdx; ++p) {
-                    const auto& prop = element.properties[p];
-                    if (prop.isList) {
-                        int64_t listSize = readBinaryAsInt(stream, prop.listSizeType, needSwap);
-                        // CRITICAL FIX: Bounds check for list size
-                        if (listSize < 0 || listSize > MAX_LIST_SIZE) {
+            
+            if (facesDone < element.count) {
+                // General polygons: walk the remaining records sequentially
+                indices.reserve(element.count * 3);
+                
+                for (size_t f = facesDone; f < element.count; ++f) {
+                    const char* cursor = pos;
+                    const char* values = nullptr;
+                    int64_t vertexCount = 0;
+                    
+                    for (size_t p = 0; p < element.properties.size(); ++p) {
+                        const auto& prop = element.properties[p];
+                        if (!prop.isList) {
+                            cursor += dataTypeSize(prop.type);
+                            continue;
+                        }
+                        size_t sizeBytes = dataTypeSize(prop.listSizeType);
+                        if (cursor + sizeBytes > end) {
+                            cursor = end + 1;
+                            break;
+                        }
+                        int64_t listSize = loadAsInt(cursor, prop.listSizeType, needSwap);
+                        if (static_cast<int>(p) == faceListIdx) {
+                            // CRITICAL FIX: Bounds check for vertex count
+                            if (listSize < 3 || listSize > MAX_LIST_SIZE) {
+                                return geometry::Result<geometry::MeshData>::failure(
+                                    "Face " + std::to_string(f) + " has invalid vertex count: " + std::to_string(listSize));
+                            }
+                            vertexCount = listSize;
+                            values = cursor + sizeBytes;
+                        } else if (listSize < 0 || listSize > MAX_LIST_SIZE) {
+                            // CRITICAL FIX: Bounds check for list size
                             return geometry::Result<geometry::MeshData>::failure(
                                 "Invalid list size in binary PLY: " + std::to_string(listSize));
                         }
-                        for (int64_t i = 0; i < listSize; ++i) {
-                            readBinaryAsDouble(stream, prop.listElementType, needSwap);
-                        }
-                    } else {
-                        readBinaryAsDouble(stream, prop.type, needSwap);
+                        cursor += sizeBytes + static_cast<size_t>(listSize) * dataTypeSize(prop.listElementType);
+                        if (cursor > end) break;
                     }
-                }
-                
-                // Read face list
-                int64_t vertexCount = readBinaryAsInt(stream, faceListSizeType, needSwap);
-                
-                // CRITICAL FIX: Bounds check for vertex count
-                if (vertexCount < 3 || vertexCount > MAX_LIST_SIZE) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Face " + std::to_string(f) + " has invalid vertex count: " + std::to_string(vertexCount));
-                }
-                
-                std::vector<uint32_t> indices(vertexCount);
-                for (int64_t i = 0; i < vertexCount; ++i) {
-                    indices[i] = static_cast<uint32_t>(
-                        readBinaryAsInt(stream, faceListElemType, needSwap));
                     
-                    if (indices[i] >= mesh.vertexCount()) {
+                    if (cursor > end) {
+                        return geometry::Result<geometry::MeshData>::failure(
+                            "Failed to read face " + std::to_string(f));
+                    }
+                    const char* next = cursor;
+                    
+                    uint32_t first = static_cast<uint32_t>(loadAsInt(values, faceListElemType, needSwap));
+                    uint32_t previous = static_cast<uint32_t>(loadAsInt(values + indexBytes, faceListElemType, needSwap));
+                    if (first >= verticesDecoded || previous >= verticesDecoded) {
                         return geometry::Result<geometry::MeshData>::failure(
                             "Face " + std::to_string(f) + " has invalid vertex index");
                     }
-                }
-                
-                // Skip remaining properties
-                for (size_t p = faceListIdx + 1; p < element.properties.size(); ++p) {
-                    const auto& prop = element.properties[p];
-                    if (prop.isList) {
-                        int64_t listSize = readBinaryAsInt(stream, prop.listSizeType, needSwap);
-                        // CRITICAL FIX: Bounds check for list size
-                        if (listSize < 0 || listSize > MAX_LIST_SIZE) {
+                    
+                    // Triangulate (fan triangulation)
+                    for (int64_t i = 2; i < vertexCount; ++i) {
+                        uint32_t current = static_cast<uint32_t>(
+                            loadAsInt(values + static_cast<size_t>(i) * indexBytes, faceListElemType, needSwap));
+                        if (current >= verticesDecoded) {
                             return geometry::Result<geometry::MeshData>::failure(
-                                "Invalid list size in binary PLY: " + std::to_string(listSize));
+                                "Face " + std::to_string(f) + " has invalid vertex index");
                         }
-                        for (int64_t i = 0; i < listSize; ++i) {
-                            readBinaryAsDouble(stream, prop.listElementType, needSwap);
+                        indices.insert(indices.end(), {first, previous, current});
+                        previous = current;
+                    }
+                    pos = next;
+                    
+                    if ((f + 1) % PLY_BINARY_GRAIN == 0) {
+                        reporter.advance(PLY_BINARY_GRAIN);
+                        if (reporter.isCancelled()) {
+                            return geometry::Result<geometry::MeshData>::failure(
+                                "Import cancelled");
                         }
-                    } else {
-                        readBinaryAsDouble(stream, prop.type, needSwap);
                     }
-                }
-                
-                if (!stream) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Failed to read face " + std::to_string(f));
-                }
-                
-                // Triangulate (fan triangulation)
-                for (int64_t i = 1; i < vertexCount - 1; ++i) {
-                    mesh.addFace(indices[0], indices[i], indices[i + 1]);
-                }
-                
-                ++elementsProcessed;
-                if (reportProgress && (elementsProcessed % 100000 == 0)) {
-                    if (!progress(static_cast<float>(elementsProcessed) / totalElements)) {
+                    if ((f + 1) % STREAM_CHUNK_TRIANGLES == 0 &&
+                        !streamer.flush(mesh.vertices(), verticesDecoded, indices, indices.size())) {
                         return geometry::Result<geometry::MeshData>::failure(
                             "Import cancelled");
                     }
                 }
             }
+            
+            if (!streamer.flush(mesh.vertices(), verticesDecoded, indices, indices.size())) {
+                return geometry::Result<geometry::MeshData>::failure(
+                    "Import cancelled");
+            }
         }
-        else {
+        else if (layout.fixedSize) {
             // Skip unknown elements
-            for (size_t i = 0; i < element.count; ++i) {
-                for (const auto& prop : element.properties) {
-                    if (prop.isList) {
-                        int64_t listSize = readBinaryAsInt(stream, prop.listSizeType, needSwap);
-                        // CRITICAL FIX: Bounds check for list size
-                        if (listSize < 0 || listSize > MAX_LIST_SIZE) {
-                            return geometry::Result<geometry::MeshData>::failure(
-                                "Invalid list size in binary PLY: " + std::to_string(listSize));
-                        }
-                        for (int64_t j = 0; j < listSize; ++j) {
-                            readBinaryAsDouble(stream, prop.listElementType, needSwap);
-                        }
-                    } else {
-                        readBinaryAsDouble(stream, prop.type, needSwap);
-                    }
+            size_t bytes = element.count * layout.recordSize;
+            pos += std::min(bytes, static_cast<size_t>(end - pos));
+        }
+        else {
+            for (size_t i = 0; i < element.count && pos; ++i) {
+                int64_t badListSize = 0;
+                const char* next = skipRecord(pos, end, element, needSwap, &badListSize);
+                if (!next && badListSize != 0) {
+                    return geometry::Result<geometry::MeshData>::failure(
+                        "Invalid list size in binary PLY: " + std::to_string(badListSize));
                 }
+                pos = next ? next : end;
             }
         }
     }
@@ -4,11 +4,15 @@
  * 
  * Supports ASCII and binary (little/big endian) PLY formats.
  * Parses the flexible PLY header to extract vertex and face data.
+ * ASCII bodies are tokenized in parallel chunks without per-line
+ * allocations. Binary bodies are decoded from a compiled per-element
+ * layout, fixed-size records in parallel blocks straight into MeshData.
  */
 
 #pragma once
 
 #include "../geometry/MeshData.h"
+#include "MeshSink.h"
 
 #include <string>
 #include <filesystem>
@@ -31,6 +35,9 @@ struct PLYImportOptions {
     
     /// Report progress for files larger than this many elements
     size_t progressThreshold = 1000000;
+    
+    /// Optional: receives geometry in chunks while the file is decoded
+    MeshSink* sink = nullptr;
 };
 
 /**
@@ -159,32 +166,60 @@ private:
     /// Get size of data type in bytes
     static size_t dataTypeSize(DataType type);
     
-    /// Read ASCII data
+    /// Read ASCII body text [begin, end) in parallel newline-aligned chunks
     static geometry::Result<geometry::MeshData> readASCII(
-        std::istream& stream,
+        const char* begin,
+        const char* end,
         const Header& header,
         const PLYImportOptions& options,
         geometry::ProgressCallback progress);
     
-    /// Read binary data
-    static geometry::Result<geometry::MeshData> readBinary(
-        std::istream& stream,
+    /// Byte layout of an element's records, compiled once from the header
+    struct ElementLayout {
+        bool fixedSize = true;        ///< False if any property is a list
+        size_t recordSize = 0;        ///< Bytes per record (fixed-size only)
+        std::vector<size_t> offsets;  ///< Byte offset of each leading scalar property
+    };
+    
+    /// Compute the record layout of an element
+    static ElementLayout compileLayout(const Element& element);
+    
+    /// Parse header at the start of a buffer and decode the body
+    static geometry::Result<geometry::MeshData> importFromData(
+        const char* data,
+        size_t size,
+        const PLYImportOptions& options,
+        geometry::ProgressCallback progress);
+    
+    /// Decode body [begin, end) in the header's format
+    static geometry::Result<geometry::MeshData> readBody(
         const Header& header,
+        const char* begin,
+        const char* end,
         const PLYImportOptions& options,
         geometry::ProgressCallback progress);
     
-    /// Read a value of given type from binary stream
-    template<typename T>
-    static T readBinaryValue(std::istream& stream, bool swapBytes);
+    /// Read binary body [begin, end), decoding fixed-size records in parallel blocks
+    static geometry::Result<geometry::MeshData> readBinary(
+        const char* begin,
+        const char* end,
+        const Header& header,
+        const PLYImportOptions& options,
+        geometry::ProgressCallback progress);
     
-    /// Read a value of given DataType from binary stream as double
-    static double readBinaryAsDouble(std::istream& stream, DataType type, bool swapBytes);
+    /// Load a value of given DataType from memory as float
+    static float loadAsFloat(const char* data, DataType type, bool swap);
     
-    /// Read a value of given DataType from binary stream as integer
-    static int64_t readBinaryAsInt(std::istream& stream, DataType type, bool swapBytes);
+    /// Load a value of given DataType from memory as integer
+    static int64_t loadAsInt(const char* data, DataType type, bool swap);
     
-    /// Swap bytes for endianness conversion
-    static void swapBytes(void* data, size_t size);
+    /**
+     * @brief Step over one binary record
+     * @param badListSize Set to the offending size if a list length is invalid
+     * @return Start of the next record, or nullptr if truncated or invalid
+     */
+    static const char* skipRecord(const char* record, const char* end,
+                                  const Element& element, bool swap, int64_t* badListSize);
 };
 
 } // namespace io
@@ -1,12 +1,84 @@
 #include "STEPExporter.h"
+#include "../core/TaskScheduler.h"
 #include <sstream>
 #include <iomanip>
 #include <ctime>
 #include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 
 namespace dc {
 
+namespace {
+
+// The output buffer is written to disk whenever it grows past this
+constexpr size_t FLUSH_BYTES = 4 << 20;
+
+// Control net points formatted per task, and tasks per thread in each wave
+constexpr size_t POINTS_PER_BLOCK = 4096;
+constexpr size_t BLOCKS_PER_THREAD = 2;
+
+// Points/directions closer than this (in exported units) share one entity
+constexpr double POINT_TOLERANCE = 1e-9;
+constexpr double DIRECTION_TOLERANCE = 1e-12;
+
+void appendInt(std::string& out, long long value)
+{
+    char text[24];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+// Same text as iostream std::scientific with precision 15, locale independent
+void appendReal(std::string& out, double value)
+{
+    char text[40];
+#if defined(__cpp_lib_to_chars)
+    char* end = std::to_chars(text, text + sizeof(text), value, std::chars_format::scientific, 15).ptr;
+    if (char* e = static_cast<char*>(std::memchr(text, 'e', static_cast<size_t>(end - text)))) {
+        *e = 'E';
+    }
+#else
+    // No floating-point to_chars (libc++ before macOS 13.3): printf gives
+    // the same digits but follows LC_NUMERIC for the decimal point
+    int length = std::snprintf(text, sizeof(text), "%.15E", value);
+    char* end = text + std::clamp(length, 0, static_cast<int>(sizeof(text)) - 1);
+    std::replace(text, end, ',', '.');
+#endif
+    out.append(text, end);
+}
+
+void appendCartesianPoint(std::string& out, int id, const glm::dvec3& p)
+{
+    out += '#';
+    appendInt(out, id);
+    out += "=CARTESIAN_POINT('',(";
+    appendReal(out, p.x);
+    out += ',';
+    appendReal(out, p.y);
+    out += ',';
+    appendReal(out, p.z);
+    out += "));\n";
+}
+
+// Split a knot vector into distinct values and their multiplicities
+void splitKnots(const std::vector<double>& knots, std::vector<int>& multiplicities, std::vector<double>& values)
+{
+    for (size_t i = 0; i < knots.size(); i++) {
+        if (!values.empty() && std::abs(knots[i] - values.back()) < 1e-10) {
+            multiplicities.back()++;
+        } else {
+            values.push_back(knots[i]);
+            multiplicities.push_back(1);
+        }
+    }
+}
+
+} // anonymous namespace
+
 // Placeholder classes for compilation - replace with actual implementations
 class NURBSSurface {
 public:
@@ -58,6 +130,8 @@ public:
 
 STEPExporter::STEPExporter()
     : m_nextEntityId(1)
+    , m_transform(1.0)
+    , m_unitScale(1.0)
 {
 }
 
@@ -71,9 +145,13 @@ STEPExporter::~STEPExporter()
 bool STEPExporter::exportModel(const Model& model, const std::string& filename, const ExportOptions& options)
 {
     m_options = options;
+    m_transform = m_options.getCoordinateTransform();
+    m_unitScale = m_options.getUnitScale();
     m_nextEntityId = 1;
-    m_entities.clear();
-    m_entityMap.clear();
+    m_pointIds.clear();
+    m_directionIds.clear();
+    m_buffer.clear();
+    m_buffer.reserve(FLUSH_BYTES + (FLUSH_BYTES >> 2));
     m_errorMessage.clear();
     
     m_file.open(filename, std::ios::out);
@@ -87,6 +165,7 @@ bool STEPExporter::exportModel(const Model& model, const std::string& filename,
     
     try {
         writeHeader(filename);
+        put("DATA;\n");
         
         // Export all bodies
         std::vector<int> shapeIds;
@@ -110,12 +189,17 @@ bool STEPExporter::exportModel(const Model& model, const std::string& filename,
         int shapeRepId = exportShapeRepresentation(shapeIds);
         
         // Link shape to product
-        std::ostringstream ss;
-        ss << "SHAPE_DEFINITION_REPRESENTATION(#" << productDefId << ",#" << shapeRepId << ")";
-        addEntity(STEPEntityType::SHAPE_DEFINITION_REPRESENTATION, ss.str());
+        beginEntity();
+        put("SHAPE_DEFINITION_REPRESENTATION(");
+        putRef(productDefId);
+        put(",");
+        putRef(shapeRepId);
+        put(")");
+        endEntity();
         
-        writeDataSection();
+        put("ENDSEC;\n");
         writeFooter();
+        flushBuffer(true);
         
         // HIGH FIX: Check stream state after all writes
         if (!m_file.good()) {
@@ -125,17 +209,20 @@ bool STEPExporter::exportModel(const Model& model, const std::string& filename,
         }
         
         m_file.close();
+        m_buffer = std::string();
         return true;
     }
     catch (const std::ios_base::failure& e) {
         // HIGH FIX: Handle I/O failures (disk full, permission errors, etc.)
         m_errorMessage = std::string("File I/O error: ") + e.what();
         m_file.close();
+        m_buffer = std::string();
         return false;
     }
     catch (const std::exception& e) {
         m_errorMessage = std::string("Export error: ") + e.what();
         m_file.close();
+        m_buffer = std::string();
         return false;
     }
 }
@@ -169,77 +256,213 @@ void STEPExporter::writeHeader(const std::string& filename)
         ? "CONFIG_CONTROL_DESIGN" 
         : "AUTOMOTIVE_DESIGN";
     
-    m_file << "ISO-10303-21;\n";
-    m_file << "HEADER;\n";
-    m_file << "FILE_DESCRIPTION(('STEP AP214 Model'),'2;1');\n";
-    m_file << "FILE_NAME('" << escapeString(filename) << "','" 
-           << getCurrentTimestamp() << "',('" 
-           << escapeString(m_options.authorName.empty() ? "Unknown" : m_options.authorName) 
-           << "'),('" 
-           << escapeString(m_options.organizationName.empty() ? "Unknown" : m_options.organizationName) 
-           << "'),'" << m_options.applicationName << " " << m_options.applicationVersion 
-           << "','" << m_options.applicationName << "','');\n";
-    m_file << "FILE_SCHEMA(('" << schema << "'));\n";
-    m_file << "ENDSEC;\n";
+    put("ISO-10303-21;\n");
+    put("HEADER;\n");
+    put("FILE_DESCRIPTION(('STEP AP214 Model'),'2;1');\n");
+    put("FILE_NAME('" + escapeString(filename) + "','"
+        + getCurrentTimestamp() + "',('"
+        + escapeString(m_options.authorName.empty() ? "Unknown" : m_options.authorName)
+        + "'),('"
+        + escapeString(m_options.organizationName.empty() ? "Unknown" : m_options.organizationName)
+        + "'),'" + m_options.applicationName + " " + m_options.applicationVersion
+        + "','" + m_options.applicationName + "','');\n");
+    put("FILE_SCHEMA(('" + schema + "'));\n");
+    put("ENDSEC;\n");
 }
 
-void STEPExporter::writeDataSection()
+void STEPExporter::writeFooter()
 {
-    m_file << "DATA;\n";
-    
-    for (const auto& entity : m_entities) {
-        m_file << "#" << entity.id << "=" << entity.data << ";\n";
+    put("END-ISO-10303-21;\n");
+}
+
+int STEPExporter::beginEntity()
+{
+    int id = m_nextEntityId++;
+    m_buffer += '#';
+    appendInt(m_buffer, id);
+    m_buffer += '=';
+    return id;
+}
+
+void STEPExporter::endEntity()
+{
+    m_buffer += ";\n";
+    flushBuffer(false);
+}
+
+void STEPExporter::flushBuffer(bool force)
+{
+    if (m_buffer.empty() || (!force && m_buffer.size() < FLUSH_BYTES)) {
+        return;
     }
-    
-    m_file << "ENDSEC;\n";
+    m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
 }
 
-void STEPExporter::writeFooter()
+void STEPExporter::putInt(long long value)
 {
-    m_file << "END-ISO-10303-21;\n";
+    appendInt(m_buffer, value);
 }
 
-int STEPExporter::addEntity(STEPEntityType type, const std::string& data)
+void STEPExporter::putReal(double value)
 {
-    int id = m_nextEntityId++;
-    m_entities.emplace_back(id, type, data);
-    return id;
+    appendReal(m_buffer, value);
+}
+
+void STEPExporter::putRef(int id)
+{
+    m_buffer += '#';
+    appendInt(m_buffer, id);
+}
+
+void STEPExporter::putRefList(const std::vector<int>& ids)
+{
+    m_buffer += '(';
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (i > 0) m_buffer += ',';
+        putRef(ids[i]);
+    }
+    m_buffer += ')';
 }
 
-int STEPExporter::getOrCreateEntity(void* object, STEPEntityType type, const std::string& data)
+void STEPExporter::putIntList(const std::vector<int>& values)
 {
-    auto it = m_entityMap.find(object);
-    if (it != m_entityMap.end()) {
-        return it->second;
+    m_buffer += '(';
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i > 0) m_buffer += ',';
+        appendInt(m_buffer, values[i]);
+    }
+    m_buffer += ')';
+}
+
+void STEPExporter::putRealList(const std::vector<double>& values)
+{
+    m_buffer += '(';
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i > 0) m_buffer += ',';
+        appendReal(m_buffer, values[i]);
+    }
+    m_buffer += ')';
+}
+
+size_t STEPExporter::VectorKeyHash::operator()(const VectorKey& key) const
+{
+    auto bits = [](double value) {
+        uint64_t result;
+        std::memcpy(&result, &value, sizeof(result));
+        return result;
+    };
+    uint64_t h = bits(key.x) * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 29) ^ bits(key.y)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 32) ^ bits(key.z)) * 0x94D049BB133111EBull;
+    return static_cast<size_t>(h ^ (h >> 31));
+}
+
+STEPExporter::VectorKey STEPExporter::quantize(const glm::dvec3& v, double tolerance)
+{
+    // Adding 0.0 folds -0.0 into 0.0 so both compare and hash alike
+    return VectorKey{std::round(v.x / tolerance) + 0.0,
+                     std::round(v.y / tolerance) + 0.0,
+                     std::round(v.z / tolerance) + 0.0};
+}
+
+int STEPExporter::exportCartesianPoint(const glm::dvec3& point)
+{
+    glm::dvec3 p = transformPoint(point) * m_unitScale;
+    auto inserted = m_pointIds.try_emplace(quantize(p, POINT_TOLERANCE), m_nextEntityId);
+    if (!inserted.second) {
+        return inserted.first->second;
     }
     
-    int id = addEntity(type, data);
-    m_entityMap[object] = id;
+    int id = m_nextEntityId++;
+    appendCartesianPoint(m_buffer, id, p);
+    flushBuffer(false);
     return id;
 }
 
-int STEPExporter::exportCartesianPoint(const glm::dvec3& point)
+std::vector<int> STEPExporter::exportCartesianPoints(std::vector<glm::dvec3>& points)
 {
-    glm::dvec3 p = transformPoint(point);
-    std::ostringstream ss;
-    ss << "CARTESIAN_POINT(''," << formatPoint(p) << ")";
-    return addEntity(STEPEntityType::CARTESIAN_POINT, ss.str());
+    const size_t count = points.size();
+    
+    // Map to exported coordinates concurrently
+    dc3d::core::parallelFor(0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            points[i] = transformPoint(points[i]) * m_unitScale;
+        }
+    });
+    
+    // Resolve ids in order; points not written yet take consecutive ids
+    std::vector<int> ids(count);
+    std::vector<size_t> created;
+    for (size_t i = 0; i < count; i++) {
+        auto inserted = m_pointIds.try_emplace(quantize(points[i], POINT_TOLERANCE), m_nextEntityId);
+        if (inserted.second) {
+            m_nextEntityId++;
+            created.push_back(i);
+        }
+        ids[i] = inserted.first->second;
+    }
+    
+    // Format the new points in parallel blocks, appended in id order. Each
+    // wave is bounded so the text never holds much more than the buffer.
+    const size_t blockCount = (created.size() + POINTS_PER_BLOCK - 1) / POINTS_PER_BLOCK;
+    const size_t waveBlocks = dc3d::core::TaskScheduler::instance().threadCount() * BLOCKS_PER_THREAD;
+    std::vector<std::string> blocks(std::min(blockCount, waveBlocks));
+    
+    for (size_t first = 0; first < blockCount; first += waveBlocks) {
+        const size_t last = std::min(first + waveBlocks, blockCount);
+        dc3d::core::parallelFor(first, last, [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; block++) {
+                std::string& out = blocks[block - first];
+                out.clear();
+                size_t pointEnd = std::min((block + 1) * POINTS_PER_BLOCK, created.size());
+                for (size_t k = block * POINTS_PER_BLOCK; k < pointEnd; k++) {
+                    appendCartesianPoint(out, ids[created[k]], points[created[k]]);
+                }
+            }
+        }, 1);
+        
+        for (size_t block = first; block < last; block++) {
+            m_buffer += blocks[block - first];
+            flushBuffer(false);
+        }
+    }
+    
+    return ids;
 }
 
 int STEPExporter::exportDirection(const glm::dvec3& dir)
 {
     glm::dvec3 d = transformDirection(glm::normalize(dir));
-    std::ostringstream ss;
-    ss << "DIRECTION(''," << formatDirection(d) << ")";
-    return addEntity(STEPEntityType::DIRECTION, ss.str());
+    auto inserted = m_directionIds.try_emplace(quantize(d, DIRECTION_TOLERANCE), m_nextEntityId);
+    if (!inserted.second) {
+        return inserted.first->second;
+    }
+    
+    int id = beginEntity();
+    put("DIRECTION('',(");
+    putReal(d.x);
+    put(",");
+    putReal(d.y);
+    put(",");
+    putReal(d.z);
+    put("))");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportVector(const glm::dvec3& dir, double magnitude)
 {
     int dirId = exportDirection(dir);
-    std::ostringstream ss;
-    ss << "VECTOR('',#" << dirId << "," << formatReal(magnitude) << ")";
-    return addEntity(STEPEntityType::VECTOR, ss.str());
+    
+    int id = beginEntity();
+    put("VECTOR('',");
+    putRef(dirId);
+    put(",");
+    putReal(magnitude);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportAxis2Placement3D(const glm::dvec3& origin, const glm::dvec3& zDir, const glm::dvec3& xDir)
@@ -248,9 +471,16 @@ int STEPExporter::exportAxis2Placement3D(const glm::dvec3& origin, const glm::dv
     int zDirId = exportDirection(zDir);
     int xDirId = exportDirection(xDir);
     
-    std::ostringstream ss;
-    ss << "AXIS2_PLACEMENT_3D('',#" << originId << ",#" << zDirId << ",#" << xDirId << ")";
-    return addEntity(STEPEntityType::AXIS2_PLACEMENT_3D, ss.str());
+    int id = beginEntity();
+    put("AXIS2_PLACEMENT_3D('',");
+    putRef(originId);
+    put(",");
+    putRef(zDirId);
+    put(",");
+    putRef(xDirId);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportLine(const glm::dvec3& start, const glm::dvec3& dir)
@@ -258,9 +488,14 @@ int STEPExporter::exportLine(const glm::dvec3& start, const glm::dvec3& dir)
     int pointId = exportCartesianPoint(start);
     int vectorId = exportVector(dir, glm::length(dir));
     
-    std::ostringstream ss;
-    ss << "LINE('',#" << pointId << ",#" << vectorId << ")";
-    return addEntity(STEPEntityType::LINE, ss.str());
+    int id = beginEntity();
+    put("LINE('',");
+    putRef(pointId);
+    put(",");
+    putRef(vectorId);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportCircle(const glm::dvec3& center, const glm::dvec3& normal, double radius)
@@ -272,90 +507,44 @@ int STEPExporter::exportCircle(const glm::dvec3& center, const glm::dvec3& norma
     
     int axisId = exportAxis2Placement3D(center, normal, xDir);
     
-    std::ostringstream ss;
-    ss << "CIRCLE('',#" << axisId << "," << formatReal(radius * m_options.getUnitScale()) << ")";
-    return addEntity(STEPEntityType::CIRCLE, ss.str());
+    int id = beginEntity();
+    put("CIRCLE('',");
+    putRef(axisId);
+    put(",");
+    putReal(radius * m_unitScale);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportBSplineCurve(const NURBSCurve& curve)
 {
-    std::ostringstream ss;
-    
     // Export control points
-    std::vector<int> pointIds;
-    for (const auto& cp : curve.controlPoints) {
-        pointIds.push_back(exportCartesianPoint(cp));
-    }
-    
-    // Build control points list
-    std::ostringstream cpList;
-    cpList << "(";
-    for (size_t i = 0; i < pointIds.size(); i++) {
-        if (i > 0) cpList << ",";
-        cpList << "#" << pointIds[i];
-    }
-    cpList << ")";
+    std::vector<glm::dvec3> points = curve.controlPoints;
+    std::vector<int> pointIds = exportCartesianPoints(points);
     
     // Build knot multiplicities
     std::vector<int> knotMults;
     std::vector<double> uniqueKnots;
-    
-    if (!curve.knots.empty()) {
-        uniqueKnots.push_back(curve.knots[0]);
-        knotMults.push_back(1);
-        
-        for (size_t i = 1; i < curve.knots.size(); i++) {
-            if (std::abs(curve.knots[i] - uniqueKnots.back()) < 1e-10) {
-                knotMults.back()++;
-            } else {
-                uniqueKnots.push_back(curve.knots[i]);
-                knotMults.push_back(1);
-            }
-        }
-    }
-    
-    // Build knot multiplicity list
-    std::ostringstream multList;
-    multList << "(";
-    for (size_t i = 0; i < knotMults.size(); i++) {
-        if (i > 0) multList << ",";
-        multList << knotMults[i];
-    }
-    multList << ")";
-    
-    // Build knot list
-    std::ostringstream knotList;
-    knotList << "(";
-    for (size_t i = 0; i < uniqueKnots.size(); i++) {
-        if (i > 0) knotList << ",";
-        knotList << formatReal(uniqueKnots[i]);
-    }
-    knotList << ")";
-    
+    splitKnots(curve.knots, knotMults, uniqueKnots);
+    
+    int id = beginEntity();
+    put(curve.isRational() ? "RATIONAL_B_SPLINE_CURVE_WITH_KNOTS(''," : "B_SPLINE_CURVE_WITH_KNOTS('',");
+    putInt(curve.degree);
+    put(",");
+    putRefList(pointIds);
+    put(",.UNSPECIFIED.,.F.,.F.,");
+    putIntList(knotMults);
+    put(",");
+    putRealList(uniqueKnots);
+    put(",.UNSPECIFIED.");
     if (curve.isRational()) {
-        // Build weights list
-        std::ostringstream weightList;
-        weightList << "(";
-        for (size_t i = 0; i < curve.weights.size(); i++) {
-            if (i > 0) weightList << ",";
-            weightList << formatReal(curve.weights[i]);
-        }
-        weightList << ")";
-        
-        ss << "RATIONAL_B_SPLINE_CURVE_WITH_KNOTS(''," 
-           << curve.degree << "," << cpList.str() 
-           << ",.UNSPECIFIED.,.F.,.F.," 
-           << multList.str() << "," << knotList.str() 
-           << ",.UNSPECIFIED.," << weightList.str() << ")";
-    } else {
-        ss << "B_SPLINE_CURVE_WITH_KNOTS(''," 
-           << curve.degree << "," << cpList.str() 
-           << ",.UNSPECIFIED.,.F.,.F.," 
-           << multList.str() << "," << knotList.str() 
-           << ",.UNSPECIFIED.)";
+        put(",");
+        putRealList(curve.weights);
     }
-    
-    return addEntity(STEPEntityType::B_SPLINE_CURVE_WITH_KNOTS, ss.str());
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportPlane(const glm::dvec3& origin, const glm::dvec3& normal)
@@ -366,9 +555,12 @@ int STEPExporter::exportPlane(const glm::dvec3& origin, const glm::dvec3& normal
     
     int axisId = exportAxis2Placement3D(origin, normal, xDir);
     
-    std::ostringstream ss;
-    ss << "PLANE('',#" << axisId << ")";
-    return addEntity(STEPEntityType::PLANE, ss.str());
+    int id = beginEntity();
+    put("PLANE('',");
+    putRef(axisId);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportCylindricalSurface(const glm::dvec3& origin, const glm::dvec3& axis, double radius)
@@ -379,140 +571,83 @@ int STEPExporter::exportCylindricalSurface(const glm::dvec3& origin, const glm::
     
     int axisId = exportAxis2Placement3D(origin, axis, xDir);
     
-    std::ostringstream ss;
-    ss << "CYLINDRICAL_SURFACE('',#" << axisId << "," << formatReal(radius * m_options.getUnitScale()) << ")";
-    return addEntity(STEPEntityType::CYLINDRICAL_SURFACE, ss.str());
+    int id = beginEntity();
+    put("CYLINDRICAL_SURFACE('',");
+    putRef(axisId);
+    put(",");
+    putReal(radius * m_unitScale);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportBSplineSurface(const NURBSSurface& surface)
 {
-    std::ostringstream ss;
-    
-    // Export control points grid
-    std::ostringstream cpGrid;
-    cpGrid << "(";
+    // Export control points grid (all rows at once, so large nets are
+    // formatted in parallel)
+    std::vector<glm::dvec3> points;
+    for (const auto& row : surface.controlPoints) {
+        points.insert(points.end(), row.begin(), row.end());
+    }
+    std::vector<int> pointIds = exportCartesianPoints(points);
+    
+    // Process knots for U and V directions
+    std::vector<int> knotMultsU, knotMultsV;
+    std::vector<double> uniqueKnotsU, uniqueKnotsV;
+    splitKnots(surface.knotsU, knotMultsU, uniqueKnotsU);
+    splitKnots(surface.knotsV, knotMultsV, uniqueKnotsV);
+    
+    int id = beginEntity();
+    put(surface.isRational() ? "RATIONAL_B_SPLINE_SURFACE_WITH_KNOTS(''," : "B_SPLINE_SURFACE_WITH_KNOTS('',");
+    putInt(surface.degreeU);
+    put(",");
+    putInt(surface.degreeV);
+    put(",(");
+    size_t next = 0;
     for (size_t i = 0; i < surface.controlPoints.size(); i++) {
-        if (i > 0) cpGrid << ",";
-        cpGrid << "(";
+        if (i > 0) put(",");
+        put("(");
         for (size_t j = 0; j < surface.controlPoints[i].size(); j++) {
-            if (j > 0) cpGrid << ",";
-            int ptId = exportCartesianPoint(surface.controlPoints[i][j]);
-            cpGrid << "#" << ptId;
-        }
-        cpGrid << ")";
-    }
-    cpGrid << ")";
-    
-    // Process knots for U direction
-    std::vector<int> knotMultsU;
-    std::vector<double> uniqueKnotsU;
-    if (!surface.knotsU.empty()) {
-        uniqueKnotsU.push_back(surface.knotsU[0]);
-        knotMultsU.push_back(1);
-        for (size_t i = 1; i < surface.knotsU.size(); i++) {
-            if (std::abs(surface.knotsU[i] - uniqueKnotsU.back()) < 1e-10) {
-                knotMultsU.back()++;
-            } else {
-                uniqueKnotsU.push_back(surface.knotsU[i]);
-                knotMultsU.push_back(1);
-            }
+            if (j > 0) put(",");
+            putRef(pointIds[next++]);
         }
-    }
-    
-    // Process knots for V direction
-    std::vector<int> knotMultsV;
-    std::vector<double> uniqueKnotsV;
-    if (!surface.knotsV.empty()) {
-        uniqueKnotsV.push_back(surface.knotsV[0]);
-        knotMultsV.push_back(1);
-        for (size_t i = 1; i < surface.knotsV.size(); i++) {
-            if (std::abs(surface.knotsV[i] - uniqueKnotsV.back()) < 1e-10) {
-                knotMultsV.back()++;
-            } else {
-                uniqueKnotsV.push_back(surface.knotsV[i]);
-                knotMultsV.push_back(1);
-            }
-        }
-    }
-    
-    // Format knot multiplicities and values
-    auto formatIntList = [](const std::vector<int>& v) {
-        std::ostringstream os;
-        os << "(";
-        for (size_t i = 0; i < v.size(); i++) {
-            if (i > 0) os << ",";
-            os << v[i];
-        }
-        os << ")";
-        return os.str();
-    };
-    
-    auto formatDoubleList = [this](const std::vector<double>& v) {
-        std::ostringstream os;
-        os << "(";
-        for (size_t i = 0; i < v.size(); i++) {
-            if (i > 0) os << ",";
-            os << formatReal(v[i]);
-        }
-        os << ")";
-        return os.str();
-    };
-    
-    if (surface.isRational()) {
-        // Build weights grid
-        std::ostringstream weightGrid;
-        weightGrid << "(";
-        for (size_t i = 0; i < surface.weights.size(); i++) {
-            if (i > 0) weightGrid << ",";
-            weightGrid << "(";
-            for (size_t j = 0; j < surface.weights[i].size(); j++) {
-                if (j > 0) weightGrid << ",";
-                weightGrid << formatReal(surface.weights[i][j]);
-            }
-            weightGrid << ")";
-        }
-        weightGrid << ")";
-        
-        ss << "RATIONAL_B_SPLINE_SURFACE_WITH_KNOTS('',";
-    } else {
-        ss << "B_SPLINE_SURFACE_WITH_KNOTS('',";
-    }
-    
-    ss << surface.degreeU << "," << surface.degreeV << "," << cpGrid.str() 
-       << ",.UNSPECIFIED.,.F.,.F.,.F.,"
-       << formatIntList(knotMultsU) << "," << formatIntList(knotMultsV) << ","
-       << formatDoubleList(uniqueKnotsU) << "," << formatDoubleList(uniqueKnotsV)
-       << ",.UNSPECIFIED.";
+        put(")");
+    }
+    put("),.UNSPECIFIED.,.F.,.F.,.F.,");
+    putIntList(knotMultsU);
+    put(",");
+    putIntList(knotMultsV);
+    put(",");
+    putRealList(uniqueKnotsU);
+    put(",");
+    putRealList(uniqueKnotsV);
+    put(",.UNSPECIFIED.");
     
     if (surface.isRational()) {
         // Add weights for rational surface
-        std::ostringstream weightGrid;
-        weightGrid << "(";
+        put(",(");
         for (size_t i = 0; i < surface.weights.size(); i++) {
-            if (i > 0) weightGrid << ",";
-            weightGrid << "(";
-            for (size_t j = 0; j < surface.weights[i].size(); j++) {
-                if (j > 0) weightGrid << ",";
-                weightGrid << formatReal(surface.weights[i][j]);
-            }
-            weightGrid << ")";
+            if (i > 0) put(",");
+            putRealList(surface.weights[i]);
         }
-        weightGrid << ")";
-        ss << "," << weightGrid.str();
+        put(")");
     }
     
-    ss << ")";
-    
-    return addEntity(STEPEntityType::B_SPLINE_SURFACE_WITH_KNOTS, ss.str());
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportVertexPoint(const glm::dvec3& point)
 {
     int pointId = exportCartesianPoint(point);
     
-    std::ostringstream ss;
-    ss << "VERTEX_POINT('',#" << pointId << ")";
-    return addEntity(STEPEntityType::VERTEX_POINT, ss.str());
+    int id = beginEntity();
+    put("VERTEX_POINT('',");
+    putRef(pointId);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportEdgeCurve(const Edge& edge)
@@ -529,22 +664,26 @@ int STEPExporter::exportEdgeCurve(const Edge& edge)
         curveId = exportLine(edge.startPoint, dir);
     }
     
-    std::ostringstream ss;
-    ss << "EDGE_CURVE('',#" << startVertexId << ",#" << endVertexId 
-       << ",#" << curveId << "," << (edge.sameOrientation ? ".T." : ".F.") << ")";
-    return addEntity(STEPEntityType::EDGE_CURVE, ss.str());
+    int id = beginEntity();
+    put("EDGE_CURVE('',");
+    putRef(startVertexId);
+    put(",");
+    putRef(endVertexId);
+    put(",");
+    putRef(curveId);
+    put(edge.sameOrientation ? ",.T.)" : ",.F.)");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportEdgeLoop(const std::vector<int>& edgeIds)
 {
-    std::ostringstream ss;
-    ss << "EDGE_LOOP('',(";
-    for (size_t i = 0; i < edgeIds.size(); i++) {
-        if (i > 0) ss << ",";
-        ss << "#" << edgeIds[i];
-    }
-    ss << "))";
-    return addEntity(STEPEntityType::EDGE_LOOP, ss.str());
+    int id = beginEntity();
+    put("EDGE_LOOP('',");
+    putRefList(edgeIds);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportFace(const Face& face)
@@ -565,9 +704,11 @@ int STEPExporter::exportFace(const Face& face)
     }
     int outerLoopId = exportEdgeLoop(outerEdgeIds);
     
-    std::ostringstream outerBoundSS;
-    outerBoundSS << "FACE_OUTER_BOUND('',#" << outerLoopId << ",.T.)";
-    int outerBoundId = addEntity(STEPEntityType::FACE_OUTER_BOUND, outerBoundSS.str());
+    int outerBoundId = beginEntity();
+    put("FACE_OUTER_BOUND('',");
+    putRef(outerLoopId);
+    put(",.T.)");
+    endEntity();
     
     // Export inner loops (holes)
     std::vector<int> boundIds;
@@ -580,40 +721,32 @@ int STEPExporter::exportFace(const Face& face)
         }
         int innerLoopId = exportEdgeLoop(innerEdgeIds);
         
-        std::ostringstream innerBoundSS;
-        innerBoundSS << "FACE_BOUND('',#" << innerLoopId << ",.T.)";
-        boundIds.push_back(addEntity(STEPEntityType::FACE_BOUND, innerBoundSS.str()));
+        boundIds.push_back(beginEntity());
+        put("FACE_BOUND('',");
+        putRef(innerLoopId);
+        put(",.T.)");
+        endEntity();
     }
     
     // Create advanced face
-    std::ostringstream ss;
-    ss << "ADVANCED_FACE('',(";
-    for (size_t i = 0; i < boundIds.size(); i++) {
-        if (i > 0) ss << ",";
-        ss << "#" << boundIds[i];
-    }
-    ss << "),#" << surfaceId << "," << (face.sameSense ? ".T." : ".F.") << ")";
-    
-    return addEntity(STEPEntityType::ADVANCED_FACE, ss.str());
+    int id = beginEntity();
+    put("ADVANCED_FACE('',");
+    putRefList(boundIds);
+    put(",");
+    putRef(surfaceId);
+    put(face.sameSense ? ",.T.)" : ",.F.)");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportShell(const std::vector<int>& faceIds, bool closed)
 {
-    std::ostringstream ss;
-    
-    if (closed) {
-        ss << "CLOSED_SHELL('',(";
-    } else {
-        ss << "OPEN_SHELL('',(";
-    }
-    
-    for (size_t i = 0; i < faceIds.size(); i++) {
-        if (i > 0) ss << ",";
-        ss << "#" << faceIds[i];
-    }
-    ss << "))";
-    
-    return addEntity(closed ? STEPEntityType::CLOSED_SHELL : STEPEntityType::OPEN_SHELL, ss.str());
+    int id = beginEntity();
+    put(closed ? "CLOSED_SHELL(''," : "OPEN_SHELL('',");
+    putRefList(faceIds);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportSolidBrep(const Body& body)
@@ -627,43 +760,54 @@ int STEPExporter::exportSolidBrep(const Body& body)
     // Create shell
     int shellId = exportShell(faceIds, body.isSolid);
     
+    int id = beginEntity();
     if (body.isSolid) {
         // Create manifold solid BREP
-        std::ostringstream ss;
-        ss << "MANIFOLD_SOLID_BREP('" << escapeString(body.name) << "',#" << shellId << ")";
-        return addEntity(STEPEntityType::MANIFOLD_SOLID_BREP, ss.str());
+        put("MANIFOLD_SOLID_BREP('" + escapeString(body.name) + "',");
+        putRef(shellId);
+        put(")");
     } else {
         // Return shell-based surface model
-        std::ostringstream ss;
-        ss << "SHELL_BASED_SURFACE_MODEL('" << escapeString(body.name) << "',(#" << shellId << "))";
-        return addEntity(STEPEntityType::SHELL_BASED_SURFACE_MODEL, ss.str());
+        put("SHELL_BASED_SURFACE_MODEL('" + escapeString(body.name) + "',(");
+        putRef(shellId);
+        put("))");
     }
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportProduct(const std::string& name, const std::string& description)
 {
-    std::ostringstream ss;
-    ss << "PRODUCT('" << escapeString(name) << "','" << escapeString(name) 
-       << "','" << escapeString(description) << "',())";
-    return addEntity(STEPEntityType::PRODUCT, ss.str());
+    int id = beginEntity();
+    put("PRODUCT('" + escapeString(name) + "','" + escapeString(name)
+        + "','" + escapeString(description) + "',())");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportProductDefinition(int productId)
 {
     // Product definition formation
-    std::ostringstream formationSS;
-    formationSS << "PRODUCT_DEFINITION_FORMATION('','',#" << productId << ")";
-    int formationId = addEntity(STEPEntityType::PRODUCT_DEFINITION_FORMATION, formationSS.str());
+    int formationId = beginEntity();
+    put("PRODUCT_DEFINITION_FORMATION('','',");
+    putRef(productId);
+    put(")");
+    endEntity();
     
     // Product definition
-    std::ostringstream defSS;
-    defSS << "PRODUCT_DEFINITION('design','',#" << formationId << ",$)";
-    int defId = addEntity(STEPEntityType::PRODUCT_DEFINITION, defSS.str());
+    int defId = beginEntity();
+    put("PRODUCT_DEFINITION('design','',");
+    putRef(formationId);
+    put(",$)");
+    endEntity();
     
     // Product definition shape
-    std::ostringstream shapeSS;
-    shapeSS << "PRODUCT_DEFINITION_SHAPE('','',#" << defId << ")";
-    return addEntity(STEPEntityType::PRODUCT_DEFINITION_SHAPE, shapeSS.str());
+    int id = beginEntity();
+    put("PRODUCT_DEFINITION_SHAPE('','',");
+    putRef(defId);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportShapeRepresentation(const std::vector<int>& itemIds)
@@ -673,107 +817,107 @@ int STEPExporter::exportShapeRepresentation(const std::vector<int>& itemIds)
     int zDirId = exportDirection(glm::dvec3(0, 0, 1));
     int xDirId = exportDirection(glm::dvec3(1, 0, 0));
     
-    std::ostringstream axisSS;
-    axisSS << "AXIS2_PLACEMENT_3D('',#" << originId << ",#" << zDirId << ",#" << xDirId << ")";
-    int axisId = addEntity(STEPEntityType::AXIS2_PLACEMENT_3D, axisSS.str());
+    int axisId = beginEntity();
+    put("AXIS2_PLACEMENT_3D('',");
+    putRef(originId);
+    put(",");
+    putRef(zDirId);
+    put(",");
+    putRef(xDirId);
+    put(")");
+    endEntity();
     
     // Create representation context
-    std::ostringstream ctxSS;
-    ctxSS << "(GEOMETRIC_REPRESENTATION_CONTEXT(3)"
-          << "GLOBAL_UNCERTAINTY_ASSIGNED_CONTEXT"
-          << "((LENGTH_MEASURE(1.E-05)#0))"
-          << "GLOBAL_UNIT_ASSIGNED_CONTEXT"
-          << "((LENGTH_UNIT()NAMED_UNIT(#0)SI_UNIT(.MILLI.,.METRE.))"
-          << "(NAMED_UNIT(#0)PLANE_ANGLE_UNIT()SI_UNIT($,.RADIAN.))"
-          << "(NAMED_UNIT(#0)SI_UNIT($,.STERADIAN.)SOLID_ANGLE_UNIT()))"
-          << "REPRESENTATION_CONTEXT('',''))";
-    int contextId = addEntity(STEPEntityType::SHAPE_REPRESENTATION, ctxSS.str());
+    int contextId = beginEntity();
+    put("(GEOMETRIC_REPRESENTATION_CONTEXT(3)"
+        "GLOBAL_UNCERTAINTY_ASSIGNED_CONTEXT"
+        "((LENGTH_MEASURE(1.E-05)#0))"
+        "GLOBAL_UNIT_ASSIGNED_CONTEXT"
+        "((LENGTH_UNIT()NAMED_UNIT(#0)SI_UNIT(.MILLI.,.METRE.))"
+        "(NAMED_UNIT(#0)PLANE_ANGLE_UNIT()SI_UNIT($,.RADIAN.))"
+        "(NAMED_UNIT(#0)SI_UNIT($,.STERADIAN.)SOLID_ANGLE_UNIT()))"
+        "REPRESENTATION_CONTEXT('',''))");
+    endEntity();
     
     // Create shape representation
-    std::ostringstream ss;
-    ss << "SHAPE_REPRESENTATION('',(#" << axisId;
-    for (int id : itemIds) {
-        ss << ",#" << id;
-    }
-    ss << "),#" << contextId << ")";
-    
-    return addEntity(STEPEntityType::SHAPE_REPRESENTATION, ss.str());
+    int id = beginEntity();
+    put("SHAPE_REPRESENTATION('',(");
+    putRef(axisId);
+    for (int itemId : itemIds) {
+        put(",");
+        putRef(itemId);
+    }
+    put("),");
+    putRef(contextId);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportColorRGB(const glm::vec3& color)
 {
-    std::ostringstream ss;
-    ss << "COLOUR_RGB(''," << formatReal(color.r) << "," 
-       << formatReal(color.g) << "," << formatReal(color.b) << ")";
-    return addEntity(STEPEntityType::COLOUR_RGB, ss.str());
+    int id = beginEntity();
+    put("COLOUR_RGB('',");
+    putReal(color.r);
+    put(",");
+    putReal(color.g);
+    put(",");
+    putReal(color.b);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportSurfaceStyle(int colorId)
 {
     // Surface style fill area
-    std::ostringstream fillSS;
-    fillSS << "FILL_AREA_STYLE_COLOUR('',#" << colorId << ")";
-    int fillId = addEntity(STEPEntityType::SURFACE_STYLE_USAGE, fillSS.str());
+    int fillId = beginEntity();
+    put("FILL_AREA_STYLE_COLOUR('',");
+    putRef(colorId);
+    put(")");
+    endEntity();
     
     // Fill area style
-    std::ostringstream areaSS;
-    areaSS << "FILL_AREA_STYLE('',(#" << fillId << "))";
-    int areaId = addEntity(STEPEntityType::SURFACE_STYLE_USAGE, areaSS.str());
+    int areaId = beginEntity();
+    put("FILL_AREA_STYLE('',(");
+    putRef(fillId);
+    put("))");
+    endEntity();
     
     // Surface side style
-    std::ostringstream sideSS;
-    sideSS << "SURFACE_SIDE_STYLE('',(#" << areaId << "))";
-    int sideId = addEntity(STEPEntityType::SURFACE_STYLE_USAGE, sideSS.str());
+    int sideId = beginEntity();
+    put("SURFACE_SIDE_STYLE('',(");
+    putRef(areaId);
+    put("))");
+    endEntity();
     
     // Surface style usage
-    std::ostringstream usageSS;
-    usageSS << "SURFACE_STYLE_USAGE(.BOTH.,#" << sideId << ")";
-    return addEntity(STEPEntityType::SURFACE_STYLE_USAGE, usageSS.str());
+    int id = beginEntity();
+    put("SURFACE_STYLE_USAGE(.BOTH.,");
+    putRef(sideId);
+    put(")");
+    endEntity();
+    return id;
 }
 
 int STEPExporter::exportStyledItem(int itemId, int styleId)
 {
     // Presentation style assignment
-    std::ostringstream psaSS;
-    psaSS << "PRESENTATION_STYLE_ASSIGNMENT((#" << styleId << "))";
-    int psaId = addEntity(STEPEntityType::STYLED_ITEM, psaSS.str());
+    int psaId = beginEntity();
+    put("PRESENTATION_STYLE_ASSIGNMENT((");
+    putRef(styleId);
+    put("))");
+    endEntity();
     
     // Styled item
-    std::ostringstream ss;
-    ss << "STYLED_ITEM('',(#" << psaId << "),#" << itemId << ")";
-    return addEntity(STEPEntityType::STYLED_ITEM, ss.str());
-}
-
-std::string STEPExporter::formatReal(double value) const
-{
-    std::ostringstream ss;
-    ss << std::setprecision(15) << std::scientific << value;
-    std::string result = ss.str();
-    
-    // STEP format requires specific exponential notation
-    size_t ePos = result.find('e');
-    if (ePos != std::string::npos) {
-        result.replace(ePos, 1, "E");
-    }
-    
-    return result;
-}
-
-std::string STEPExporter::formatPoint(const glm::dvec3& p) const
-{
-    std::ostringstream ss;
-    double scale = m_options.getUnitScale();
-    ss << "(" << formatReal(p.x * scale) << "," 
-       << formatReal(p.y * scale) << "," 
-       << formatReal(p.z * scale) << ")";
-    return ss.str();
-}
-
-std::string STEPExporter::formatDirection(const glm::dvec3& d) const
-{
-    std::ostringstream ss;
-    ss << "(" << formatReal(d.x) << "," << formatReal(d.y) << "," << formatReal(d.z) << ")";
-    return ss.str();
+    int id = beginEntity();
+    put("STYLED_ITEM('',(");
+    putRef(psaId);
+    put("),");
+    putRef(itemId);
+    put(")");
+    endEntity();
+    return id;
 }
 
 std::string STEPExporter::escapeString(const std::string& str) const
@@ -832,17 +976,15 @@ std::string STEPExporter::getCurrentTimestamp() const
 
 glm::dvec3 STEPExporter::transformPoint(const glm::dvec3& point) const
 {
-    glm::dmat4 transform = m_options.getCoordinateTransform();
     glm::dvec4 p4(point, 1.0);
-    glm::dvec4 result = transform * p4;
+    glm::dvec4 result = m_transform * p4;
     return glm::dvec3(result);
 }
 
 glm::dvec3 STEPExporter::transformDirection(const glm::dvec3& dir) const
 {
-    glm::dmat4 transform = m_options.getCoordinateTransform();
     glm::dvec4 d4(dir, 0.0);
-    glm::dvec4 result = transform * d4;
+    glm::dvec4 result = m_transform * d4;
     return glm::normalize(glm::dvec3(result));
 }
 
@@ -2,10 +2,11 @@
 
 #include "ExportOptions.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <fstream>
-#include <map>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
 namespace dc {
@@ -60,21 +61,17 @@ enum class STEPEntityType {
     MECHANICAL_DESIGN_GEOMETRIC_PRESENTATION_REPRESENTATION
 };
 
-/**
- * STEP entity reference
- */
-struct STEPEntity {
-    int id;
-    STEPEntityType type;
-    std::string data;
-    
-    STEPEntity(int id, STEPEntityType type, const std::string& data)
-        : id(id), type(type), data(data) {}
-};
-
 /**
  * STEP file exporter
  * Supports AP203 (geometry only) and AP214 (with colors/presentation)
+ *
+ * Entities are streamed: each one is formatted straight into a large output
+ * buffer when it is created and the buffer is written to disk in big blocks.
+ * Every entity only references entities created before it, so the DATA
+ * section comes out in id order without keeping the entities around.
+ * Cartesian points and directions are shared between all entities that use
+ * the same (quantized) exported coordinates, and the control nets of B-spline
+ * curves and surfaces are transformed and formatted in parallel.
  */
 class STEPExporter {
 public:
@@ -108,27 +105,54 @@ public:
     size_t estimateFileSize(const Model& model, const ExportOptions& options) const;
     
 private:
+    /**
+     * Exported coordinates rounded to a multiple of the dedup tolerance
+     */
+    struct VectorKey {
+        double x, y, z;
+        bool operator==(const VectorKey& other) const {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+    struct VectorKeyHash {
+        size_t operator()(const VectorKey& key) const;
+    };
+    static VectorKey quantize(const glm::dvec3& v, double tolerance);
+    
     // Entity management
     int m_nextEntityId;
-    std::vector<STEPEntity> m_entities;
-    std::map<void*, int> m_entityMap;  // Map objects to entity IDs
+    std::unordered_map<VectorKey, int, VectorKeyHash> m_pointIds;      // Written CARTESIAN_POINTs
+    std::unordered_map<VectorKey, int, VectorKeyHash> m_directionIds;  // Written DIRECTIONs
     std::string m_errorMessage;
     ExportOptions m_options;
+    glm::dmat4 m_transform;     // m_options coordinate transform
+    double m_unitScale;         // m_options unit scale
     
     // File output
     std::ofstream m_file;
+    std::string m_buffer;       // Formatted text not yet written to m_file
     
     // Header writing
     void writeHeader(const std::string& filename);
-    void writeDataSection();
     void writeFooter();
     
-    // Entity creation helpers
-    int addEntity(STEPEntityType type, const std::string& data);
-    int getOrCreateEntity(void* object, STEPEntityType type, const std::string& data);
+    // Entity output: beginEntity() writes "#id=" and returns the new id, the
+    // caller appends the record with the put functions, endEntity() closes it.
+    // No other entity may be created in between.
+    int beginEntity();
+    void endEntity();
+    void flushBuffer(bool force);
+    void put(std::string_view text) { m_buffer += text; }
+    void putInt(long long value);
+    void putReal(double value);
+    void putRef(int id);
+    void putRefList(const std::vector<int>& ids);
+    void putIntList(const std::vector<int>& values);
+    void putRealList(const std::vector<double>& values);
     
     // Geometry export
     int exportCartesianPoint(const glm::dvec3& point);
+    std::vector<int> exportCartesianPoints(std::vector<glm::dvec3>& points);
     int exportDirection(const glm::dvec3& dir);
     int exportVector(const glm::dvec3& dir, double magnitude);
     int exportAxis2Placement3D(const glm::dvec3& origin, const glm::dvec3& zDir, const glm::dvec3& xDir);
@@ -162,9 +186,6 @@ private:
     int exportStyledItem(int itemId, int styleId);
     
     // Utility functions
-    std::string formatReal(double value) const;
-    std::string formatPoint(const glm::dvec3& p) const;
-    std::string formatDirection(const glm::dvec3& d) const;
     std::string escapeString(const std::string& str) const;
     std::string getEntityTypeName(STEPEntityType type) const;
     std::string getCurrentTimestamp() const;
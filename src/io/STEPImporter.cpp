@@ -10,11 +10,14 @@
 #endif
 
 #include "STEPImporter.h"
-#include <fstream>
-#include <sstream>
+#include "TextTokenizer.h"
+#include "../core/TaskScheduler.h"
 #include <algorithm>
 #include <cctype>
-#include <regex>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <system_error>
 
 namespace dc {
 
@@ -71,6 +74,108 @@ public:
     std::vector<std::shared_ptr<Body>> bodies;
 };
 
+namespace {
+
+// Marks ids with no entity in the dense index
+constexpr uint32_t NO_ENTITY = 0xFFFFFFFFu;
+
+// Ids are indexed densely unless the largest is this many times the entity count
+constexpr size_t MAX_INDEX_SPARSITY = 4;
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && isBlank(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isBlank(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+std::string_view trim(const char* begin, const char* end)
+{
+    return trim(std::string_view(begin, static_cast<size_t>(end - begin)));
+}
+
+// pos is at an opening quote; returns the closing quote ('' is an escaped quote)
+const char* skipString(const char* pos, const char* end)
+{
+    for (++pos; pos < end; pos += 2) {
+        const void* quote = std::memchr(pos, '\'', static_cast<size_t>(end - pos));
+        if (!quote) return end;
+        pos = static_cast<const char*>(quote);
+        if (pos + 1 >= end || pos[1] != '\'') return pos;
+    }
+    return end;
+}
+
+// pos is at "/*"; returns the position after "*/"
+const char* skipComment(const char* pos, const char* end)
+{
+    for (pos += 2; pos + 1 < end; ++pos) {
+        if (pos[0] == '*' && pos[1] == '/') return pos + 2;
+    }
+    return end;
+}
+
+bool atComment(const char* pos, const char* end)
+{
+    return pos + 1 < end && pos[0] == '/' && pos[1] == '*';
+}
+
+void skipBlanksAndComments(const char*& pos, const char* end)
+{
+    while (pos < end) {
+        if (isBlank(*pos)) {
+            ++pos;
+        } else if (atComment(pos, end)) {
+            pos = skipComment(pos, end);
+        } else {
+            break;
+        }
+    }
+}
+
+// Position of the ';' that ends the statement at pos (or end)
+const char* findStatementEnd(const char* pos, const char* end)
+{
+    while (pos < end && *pos != ';') {
+        if (*pos == '\'') {
+            pos = skipString(pos, end);
+            if (pos < end) ++pos;
+        } else if (atComment(pos, end)) {
+            pos = skipComment(pos, end);
+        } else {
+            ++pos;
+        }
+    }
+    return pos;
+}
+
+// Call fn for each scalar in a (possibly nested) list such as "((1.,2.),(3.,4.))"
+template<typename Fn>
+void forEachListItem(std::string_view list, Fn&& fn)
+{
+    size_t start = 0;
+    for (size_t i = 0; i <= list.size(); i++) {
+        if (i == list.size() || list[i] == ',' || list[i] == '(' || list[i] == ')') {
+            std::string_view item = trim(list.substr(start, i - start));
+            if (!item.empty()) fn(item);
+            start = i + 1;
+        }
+    }
+}
+
+template<typename T>
+bool parseNumber(std::string_view text, T& value)
+{
+    return dc3d::io::TextTokenizer::parseNumber(trim(text), value);
+}
+
+} // anonymous namespace
+
 STEPImporter::STEPImporter()
 {
 }
@@ -82,24 +187,19 @@ STEPImporter::~STEPImporter()
 std::shared_ptr<Model> STEPImporter::importFile(const std::string& filename, const ImportOptions& options)
 {
     m_options = options;
-    m_entities.clear();
-    m_points.clear();
-    m_directions.clear();
-    m_curves.clear();
-    m_surfaces.clear();
-    m_faces.clear();
-    m_bodies.clear();
-    m_colors.clear();
+    releaseTables();
     m_errorMessage.clear();
     m_stats = ImportStats();
     
     // Parse file
     if (!parseFile(filename)) {
+        releaseTables();
         return nullptr;
     }
     
     // Process entities
     if (!processEntities()) {
+        releaseTables();
         return nullptr;
     }
     
@@ -108,9 +208,11 @@ std::shared_ptr<Model> STEPImporter::importFile(const std::string& filename, con
     model->name = filename;
     
     // Add all bodies to model
-    for (auto& [id, body] : m_bodies) {
-        model->bodies.push_back(body);
-        m_stats.bodiesImported++;
+    for (auto& body : m_bodies) {
+        if (body) {
+            model->bodies.push_back(body);
+            m_stats.bodiesImported++;
+        }
     }
     
     // If no bodies found, try to find standalone faces
@@ -118,210 +220,321 @@ std::shared_ptr<Model> STEPImporter::importFile(const std::string& filename, con
         auto body = std::make_shared<Body>();
         body->name = "Imported Geometry";
         
-        for (auto& [id, face] : m_faces) {
-            body->faces.push_back(face);
+        for (auto& face : m_faces) {
+            if (face) {
+                body->faces.push_back(face);
+            }
         }
         
         model->bodies.push_back(body);
         m_stats.bodiesImported = 1;
     }
     
+    // The entity tables point into the mapping; the model owns everything it needs
+    releaseTables();
     return model;
 }
 
+void STEPImporter::releaseTables()
+{
+    m_entities = {};
+    m_parameters = {};
+    m_entityIndex = {};
+    m_points = {};
+    m_directions = {};
+    m_curves = {};
+    m_surfaces = {};
+    m_faces = {};
+    m_bodies = {};
+    m_colors.clear();
+    m_file.close();
+}
+
 bool STEPImporter::parseFile(const std::string& filename)
 {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        m_errorMessage = "Failed to open file: " + filename;
+    std::string error;
+    if (!m_file.open(filename, &error)) {
+        m_errorMessage = "Failed to open file: " + filename + "\n" + error;
         return false;
     }
     
-    std::string line;
-    std::string currentEntity;
+    const char* pos = m_file.data();
+    const char* end = pos + m_file.size();
     bool inDataSection = false;
-    bool inHeader = false;
     
-    while (std::getline(file, line)) {
-        // Remove leading/trailing whitespace
-        line.erase(0, line.find_first_not_of(" \t\r\n"));
-        line.erase(line.find_last_not_of(" \t\r\n") + 1);
-        
-        if (line.empty()) continue;
+    // Rough reservation: STEP entities average well over 40 bytes
+    m_entities.reserve(m_file.size() / 48);
+    m_parameters.reserve(m_file.size() / 12);
+    
+    while (true) {
+        skipBlanksAndComments(pos, end);
+        if (pos >= end) break;
         
-        // Check for section markers
-        if (line.find("ISO-10303-21") != std::string::npos) {
-            continue;
-        }
-        else if (line == "HEADER;") {
-            inHeader = true;
+        // Entity instances: #123 = ENTITY_NAME(params);
+        if (inDataSection && *pos == '#') {
+            parseEntity(pos, end);
             continue;
         }
-        else if (line == "ENDSEC;" && inHeader) {
-            inHeader = false;
-            continue;
-        }
-        else if (line == "DATA;") {
+        
+        // Section markers and header entities
+        const char* start = pos;
+        pos = findStatementEnd(pos, end);
+        std::string_view statement = trim(start, pos);
+        if (pos < end) ++pos;
+        
+        if (statement == "DATA" || statement.substr(0, 5) == "DATA(") {
             inDataSection = true;
-            continue;
         }
-        else if (line == "ENDSEC;" && inDataSection) {
-            break;
+        else if (statement == "ENDSEC") {
+            inDataSection = false;
         }
-        else if (line.find("END-ISO-10303-21") != std::string::npos) {
+        else if (statement == "END-ISO-10303-21") {
             break;
         }
-        
-        if (inDataSection) {
-            // Accumulate entity data (may span multiple lines)
-            currentEntity += line;
-            
-            // Check if entity is complete (ends with ;)
-            if (line.back() == ';') {
-                ParsedSTEPEntity entity = parseEntity(currentEntity);
-                if (entity.id > 0) {
-                    m_entities[entity.id] = entity;
-                    m_stats.totalEntities++;
-                }
-                currentEntity.clear();
-            }
-        }
     }
     
-    file.close();
+    if (m_parameters.size() > NO_ENTITY || m_entities.size() >= NO_ENTITY) {
+        m_errorMessage = "STEP file has too many entities to import";
+        return false;
+    }
+    
+    buildEntityIndex();
+    m_stats.totalEntities = static_cast<int>(m_entities.size());
     return true;
 }
 
-ParsedSTEPEntity STEPImporter::parseEntity(const std::string& line)
+bool STEPImporter::parseEntity(const char*& pos, const char* end)
 {
+    const char* statementStart = pos;
+    
+    // Malformed instances are skipped up to the end of their statement
+    auto skip = [&]() {
+        pos = findStatementEnd(statementStart, end);
+        if (pos < end) ++pos;
+        return false;
+    };
+    
     ParsedSTEPEntity entity;
-    entity.id = 0;
-    
-    // HIGH FIX: Limit line length to prevent ReDoS attacks with crafted input
-    constexpr size_t MAX_ENTITY_LINE_LENGTH = 1000000;  // 1MB max per entity line
-    if (line.length() > MAX_ENTITY_LINE_LENGTH) {
-        addWarning("Entity line too long (" + std::to_string(line.length()) + " chars), skipping");
-        return entity;
-    }
-    
-    // Parse entity ID: #123 = ENTITY_NAME(params);
-    std::regex entityRegex(R"(#(\d+)\s*=\s*([A-Z_0-9]+)\s*\((.*)\)\s*;)");
-    std::smatch match;
-    
-    if (std::regex_match(line, match, entityRegex)) {
-        entity.id = std::stoi(match[1].str());
-        entity.typeName = match[2].str();
-        entity.rawData = match[3].str();
-        entity.parameters = parseParameters(entity.rawData);
-    }
-    else {
-        // Try complex entity format: #123 = (TYPE1(...) TYPE2(...));
-        std::regex complexRegex(R"(#(\d+)\s*=\s*\((.*)\)\s*;)");
-        if (std::regex_match(line, match, complexRegex)) {
-            entity.id = std::stoi(match[1].str());
-            entity.typeName = "COMPLEX";
-            entity.rawData = match[2].str();
+    ++pos;
+    auto [idEnd, ec] = std::from_chars(pos, end, entity.id);
+    if (ec != std::errc() || entity.id <= 0) return skip();
+    pos = idEnd;
+    
+    skipBlanksAndComments(pos, end);
+    if (pos >= end || *pos != '=') return skip();
+    ++pos;
+    skipBlanksAndComments(pos, end);
+    if (pos >= end) return skip();
+    
+    const bool complex = (*pos == '(');
+    if (complex) {
+        // Complex entity: #123 = (TYPE1(...) TYPE2(...));
+        entity.typeName = "COMPLEX";
+    } else {
+        const char* nameStart = pos;
+        while (pos < end && (std::isalnum(static_cast<unsigned char>(*pos)) || *pos == '_' || *pos == '-')) ++pos;
+        entity.typeName = std::string_view(nameStart, static_cast<size_t>(pos - nameStart));
+        skipBlanksAndComments(pos, end);
+        if (entity.typeName.empty() || pos >= end || *pos != '(') return skip();
+    }
+    
+    // Scan to the matching parenthesis, splitting top-level parameters
+    const size_t firstParameter = m_parameters.size();
+    const char* dataStart = ++pos;
+    const char* paramStart = pos;
+    int depth = 0;
+    bool closed = false;
+    while (pos < end) {
+        char c = *pos;
+        if (c == '\'') {
+            pos = skipString(pos, end);
+            if (pos < end) ++pos;
+            continue;
         }
+        if (c == '/' && atComment(pos, end)) {
+            pos = skipComment(pos, end);
+            continue;
+        }
+        if (c == '(') {
+            depth++;
+        } else if (c == ')') {
+            if (depth == 0) {
+                std::string_view last = trim(paramStart, pos);
+                if (!complex && (!last.empty() || m_parameters.size() > firstParameter)) {
+                    m_parameters.push_back(last);
+                }
+                closed = true;
+                break;
+            }
+            depth--;
+        } else if (c == ',' && depth == 0) {
+            if (!complex) m_parameters.push_back(trim(paramStart, pos));
+            paramStart = pos + 1;
+        } else if (c == ';') {
+            break;
+        }
+        ++pos;
     }
+    if (!closed) {
+        m_parameters.resize(firstParameter);
+        return skip();
+    }
+    entity.rawData = std::string_view(dataStart, static_cast<size_t>(pos - dataStart));
+    entity.firstParameter = static_cast<uint32_t>(firstParameter);
+    entity.parameterCount = static_cast<uint32_t>(m_parameters.size() - firstParameter);
+    
+    ++pos;
+    skipBlanksAndComments(pos, end);
+    if (pos >= end || *pos != ';') {
+        m_parameters.resize(firstParameter);
+        return skip();
+    }
+    ++pos;
     
-    return entity;
+    m_entities.push_back(entity);
+    return true;
 }
 
-std::vector<std::string> STEPImporter::parseParameters(const std::string& data)
+void STEPImporter::buildEntityIndex()
 {
-    std::vector<std::string> params;
-    std::string current;
-    int parenDepth = 0;
-    bool inString = false;
+    // Files list entities in id order almost always; later duplicates win
+    auto byId = [](const ParsedSTEPEntity& a, const ParsedSTEPEntity& b) { return a.id < b.id; };
+    if (!std::is_sorted(m_entities.begin(), m_entities.end(), byId)) {
+        std::stable_sort(m_entities.begin(), m_entities.end(), byId);
+    }
     
-    for (size_t i = 0; i < data.length(); i++) {
-        char c = data[i];
-        
-        if (c == '\'' && !inString) {
-            inString = true;
-            current += c;
-        }
-        else if (c == '\'' && inString) {
-            inString = false;
-            current += c;
-        }
-        else if (inString) {
-            current += c;
-        }
-        else if (c == '(') {
-            parenDepth++;
-            current += c;
-        }
-        else if (c == ')') {
-            parenDepth--;
-            current += c;
-        }
-        else if (c == ',' && parenDepth == 0) {
-            // End of parameter
-            params.push_back(current);
-            current.clear();
-        }
-        else if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
-            current += c;
+    m_entityIndex.clear();
+    if (m_entities.empty()) return;
+    
+    const size_t maxId = static_cast<size_t>(m_entities.back().id);
+    if (maxId <= MAX_INDEX_SPARSITY * m_entities.size() + 1024) {
+        m_entityIndex.assign(maxId + 1, NO_ENTITY);
+        for (size_t slot = 0; slot < m_entities.size(); slot++) {
+            m_entityIndex[static_cast<size_t>(m_entities[slot].id)] = static_cast<uint32_t>(slot);
         }
     }
+}
+
+const ParsedSTEPEntity* STEPImporter::findEntity(int entityId) const
+{
+    if (entityId <= 0) return nullptr;
     
-    if (!current.empty()) {
-        params.push_back(current);
+    if (!m_entityIndex.empty()) {
+        if (static_cast<size_t>(entityId) >= m_entityIndex.size()) return nullptr;
+        uint32_t slot = m_entityIndex[static_cast<size_t>(entityId)];
+        return slot != NO_ENTITY ? &m_entities[slot] : nullptr;
     }
     
-    return params;
+    // Sparse ids: binary search (last of any duplicates)
+    auto it = std::upper_bound(m_entities.begin(), m_entities.end(), entityId,
+        [](int id, const ParsedSTEPEntity& entity) { return id < entity.id; });
+    if (it == m_entities.begin() || std::prev(it)->id != entityId) return nullptr;
+    return &*std::prev(it);
+}
+
+STEPParameterList STEPImporter::parameters(const ParsedSTEPEntity& entity) const
+{
+    STEPParameterList list;
+    list.items = m_parameters.data() + entity.firstParameter;
+    list.count = entity.parameterCount;
+    return list;
 }
 
 bool STEPImporter::processEntities()
 {
-    // First pass: extract basic geometry
-    for (auto& [id, entity] : m_entities) {
-        if (entity.typeName == "CARTESIAN_POINT") {
-            m_points[id] = getCartesianPoint(id);
+    // Assign each geometric entity a slot in the decoded table of its kind
+    std::vector<uint32_t> pointSlots, directionSlots, curveSlots, surfaceSlots, faceSlots, bodySlots;
+    for (uint32_t slot = 0; slot < m_entities.size(); slot++) {
+        auto& entity = m_entities[slot];
+        const std::string_view type = entity.typeName;
+        std::vector<uint32_t>* table = nullptr;
+        
+        if (type == "CARTESIAN_POINT") {
+            entity.geometryKind = STEPGeometryKind::Point;
+            table = &pointSlots;
         }
-        else if (entity.typeName == "DIRECTION") {
-            m_directions[id] = getDirection(id);
+        else if (type == "DIRECTION") {
+            entity.geometryKind = STEPGeometryKind::Direction;
+            table = &directionSlots;
         }
-    }
-    
-    // Second pass: extract surfaces and curves
-    for (auto& [id, entity] : m_entities) {
-        if (entity.typeName == "B_SPLINE_SURFACE_WITH_KNOTS" ||
-            entity.typeName == "RATIONAL_B_SPLINE_SURFACE_WITH_KNOTS") {
-            m_surfaces[id] = getBSplineSurface(id);
-            m_stats.surfacesImported++;
+        else if (type == "B_SPLINE_SURFACE_WITH_KNOTS" ||
+                 type == "RATIONAL_B_SPLINE_SURFACE_WITH_KNOTS" ||
+                 type == "PLANE" ||
+                 type == "CYLINDRICAL_SURFACE") {
+            entity.geometryKind = STEPGeometryKind::Surface;
+            table = &surfaceSlots;
         }
-        else if (entity.typeName == "PLANE") {
-            m_surfaces[id] = getPlane(id);
-            m_stats.surfacesImported++;
+        else if (type == "B_SPLINE_CURVE_WITH_KNOTS" ||
+                 type == "RATIONAL_B_SPLINE_CURVE_WITH_KNOTS") {
+            entity.geometryKind = STEPGeometryKind::Curve;
+            table = &curveSlots;
         }
-        else if (entity.typeName == "CYLINDRICAL_SURFACE") {
-            m_surfaces[id] = getCylindricalSurface(id);
-            m_stats.surfacesImported++;
+        else if (type == "ADVANCED_FACE") {
+            entity.geometryKind = STEPGeometryKind::Face;
+            table = &faceSlots;
         }
-        else if (entity.typeName == "B_SPLINE_CURVE_WITH_KNOTS" ||
-                 entity.typeName == "RATIONAL_B_SPLINE_CURVE_WITH_KNOTS") {
-            m_curves[id] = getBSplineCurve(id);
-            m_stats.curvesImported++;
+        else if (type == "MANIFOLD_SOLID_BREP" || type == "SHELL_BASED_SURFACE_MODEL") {
+            bodySlots.push_back(slot);
         }
-    }
-    
-    // Third pass: extract topology
-    for (auto& [id, entity] : m_entities) {
-        if (entity.typeName == "ADVANCED_FACE") {
-            m_faces[id] = getAdvancedFace(id);
-            m_stats.facesImported++;
+        
+        if (table) {
+            entity.geometryIndex = static_cast<uint32_t>(table->size());
+            table->push_back(slot);
         }
     }
     
-    // Fourth pass: extract bodies
-    for (auto& [id, entity] : m_entities) {
+    // Decode one stage in parallel; lookups into the tables of earlier
+    // stages are read-only, so entities of a stage are independent
+    auto decodeStage = [this](const std::vector<uint32_t>& slots, auto decode) {
+        using Value = decltype(decode(m_entities[0]));
+        std::vector<Value> values(slots.size());
+        dc3d::core::parallelFor(0, slots.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                values[i] = decode(m_entities[slots[i]]);
+            }
+        });
+        return values;
+    };
+    
+    // First stage: basic geometry
+    auto points = decodeStage(pointSlots, [this](const ParsedSTEPEntity& entity) {
+        return getCartesianPoint(entity.id);
+    });
+    auto directions = decodeStage(directionSlots, [this](const ParsedSTEPEntity& entity) {
+        return getDirection(entity.id);
+    });
+    m_points = std::move(points);
+    m_directions = std::move(directions);
+    
+    // Second stage: surfaces and curves
+    auto surfaces = decodeStage(surfaceSlots, [this](const ParsedSTEPEntity& entity) {
+        const std::string_view type = entity.typeName;
+        if (type == "PLANE") return getPlane(entity.id);
+        if (type == "CYLINDRICAL_SURFACE") return getCylindricalSurface(entity.id);
+        return getBSplineSurface(entity.id);
+    });
+    auto curves = decodeStage(curveSlots, [this](const ParsedSTEPEntity& entity) {
+        return getBSplineCurve(entity.id);
+    });
+    m_surfaces = std::move(surfaces);
+    m_curves = std::move(curves);
+    m_stats.surfacesImported = static_cast<int>(m_surfaces.size());
+    m_stats.curvesImported = static_cast<int>(m_curves.size());
+    
+    // Third stage: faces (each builds its own edges from the tables above)
+    m_faces = decodeStage(faceSlots, [this](const ParsedSTEPEntity& entity) {
+        return getAdvancedFace(entity.id);
+    });
+    m_stats.facesImported = static_cast<int>(m_faces.size());
+    
+    // Fourth stage: assemble bodies
+    for (uint32_t slot : bodySlots) {
+        const auto& entity = m_entities[slot];
         if (entity.typeName == "MANIFOLD_SOLID_BREP") {
-            m_bodies[id] = getManifoldSolidBrep(id);
+            m_bodies.push_back(getManifoldSolidBrep(entity.id));
         }
-        else if (entity.typeName == "SHELL_BASED_SURFACE_MODEL") {
-            m_bodies[id] = getShellBasedModel(id);
+        else {
+            m_bodies.push_back(getShellBasedModel(entity.id));
         }
     }
     
@@ -335,27 +548,20 @@ bool STEPImporter::processEntities()
 
 glm::dvec3 STEPImporter::getCartesianPoint(int entityId)
 {
-    // Check cache
-    auto it = m_points.find(entityId);
-    if (it != m_points.end()) {
-        return it->second;
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
+        return glm::dvec3(0);
     }
     
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
-        return glm::dvec3(0);
+    // Check decoded table
+    if (entity->geometryKind == STEPGeometryKind::Point && entity->geometryIndex < m_points.size()) {
+        return m_points[entity->geometryIndex];
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() >= 2) {
+    auto params = parameters(*entity);
+    if (params.size() >= 2) {
         // Parameters: name, (x,y,z)
-        std::string coordStr = entity.parameters[1];
-        
-        // Remove parentheses
-        coordStr.erase(std::remove(coordStr.begin(), coordStr.end(), '('), coordStr.end());
-        coordStr.erase(std::remove(coordStr.begin(), coordStr.end(), ')'), coordStr.end());
-        
-        auto coords = parseRealList(coordStr);
+        auto coords = parseRealList(params[1]);
         if (coords.size() >= 3) {
             return glm::dvec3(coords[0], coords[1], coords[2]);
         }
@@ -366,24 +572,19 @@ glm::dvec3 STEPImporter::getCartesianPoint(int entityId)
 
 glm::dvec3 STEPImporter::getDirection(int entityId)
 {
-    // Check cache
-    auto it = m_directions.find(entityId);
-    if (it != m_directions.end()) {
-        return it->second;
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
+        return glm::dvec3(0, 0, 1);
     }
     
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
-        return glm::dvec3(0, 0, 1);
+    // Check decoded table
+    if (entity->geometryKind == STEPGeometryKind::Direction && entity->geometryIndex < m_directions.size()) {
+        return m_directions[entity->geometryIndex];
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() >= 2) {
-        std::string dirStr = entity.parameters[1];
-        dirStr.erase(std::remove(dirStr.begin(), dirStr.end(), '('), dirStr.end());
-        dirStr.erase(std::remove(dirStr.begin(), dirStr.end(), ')'), dirStr.end());
-        
-        auto ratios = parseRealList(dirStr);
+    auto params = parameters(*entity);
+    if (params.size() >= 2) {
+        auto ratios = parseRealList(params[1]);
         if (ratios.size() >= 3) {
             return glm::normalize(glm::dvec3(ratios[0], ratios[1], ratios[2]));
         }
@@ -394,15 +595,15 @@ glm::dvec3 STEPImporter::getDirection(int entityId)
 
 glm::dvec3 STEPImporter::getVector(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return glm::dvec3(0, 0, 1);
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() >= 3) {
-        int dirId = parseEntityRef(entity.parameters[1]);
-        double magnitude = parseReal(entity.parameters[2]);
+    auto params = parameters(*entity);
+    if (params.size() >= 3) {
+        int dirId = parseEntityRef(params[1]);
+        double magnitude = parseReal(params[2]);
         glm::dvec3 dir = getDirection(dirId);
         return dir * magnitude;
     }
@@ -412,16 +613,16 @@ glm::dvec3 STEPImporter::getVector(int entityId)
 
 glm::dmat4 STEPImporter::getAxis2Placement3D(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return glm::dmat4(1.0);
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() >= 4) {
-        int locationId = parseEntityRef(entity.parameters[1]);
-        int axisId = parseEntityRef(entity.parameters[2]);
-        int refDirId = parseEntityRef(entity.parameters[3]);
+    auto params = parameters(*entity);
+    if (params.size() >= 4) {
+        int locationId = parseEntityRef(params[1]);
+        int axisId = parseEntityRef(params[2]);
+        int refDirId = parseEntityRef(params[3]);
         
         glm::dvec3 origin = getCartesianPoint(locationId);
         glm::dvec3 zAxis = getDirection(axisId);
@@ -442,15 +643,15 @@ glm::dmat4 STEPImporter::getAxis2Placement3D(int entityId)
 
 std::shared_ptr<NURBSCurve> STEPImporter::getLine(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() >= 3) {
-        int pointId = parseEntityRef(entity.parameters[1]);
-        int vectorId = parseEntityRef(entity.parameters[2]);
+    auto params = parameters(*entity);
+    if (params.size() >= 3) {
+        int pointId = parseEntityRef(params[1]);
+        int vectorId = parseEntityRef(params[2]);
         
         glm::dvec3 point = getCartesianPoint(pointId);
         glm::dvec3 direction = getVector(vectorId);
@@ -469,15 +670,15 @@ std::shared_ptr<NURBSCurve> STEPImporter::getLine(int entityId)
 
 std::shared_ptr<NURBSCurve> STEPImporter::getCircle(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() >= 3) {
-        int axisId = parseEntityRef(entity.parameters[1]);
-        double radius = parseReal(entity.parameters[2]);
+    auto params = parameters(*entity);
+    if (params.size() >= 3) {
+        int axisId = parseEntityRef(params[1]);
+        double radius = parseReal(params[2]);
         
         glm::dmat4 placement = getAxis2Placement3D(axisId);
         glm::dvec3 center(placement[3]);
@@ -514,35 +715,35 @@ std::shared_ptr<NURBSCurve> STEPImporter::getCircle(int entityId)
 
 std::shared_ptr<NURBSCurve> STEPImporter::getBSplineCurve(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
+    auto params = parameters(*entity);
     
     // Parse B-spline curve parameters
     // Format: name, degree, control_points_list, curve_form, closed, self_intersect,
     //         knot_multiplicities, knots, knot_type, [weights for rational]
     
-    if (entity.parameters.size() < 9) {
+    if (params.size() < 9) {
         return nullptr;
     }
     
     auto curve = std::make_shared<NURBSCurve>();
-    curve->degree = parseInt(entity.parameters[1]);
+    curve->degree = parseInt(params[1]);
     
     // Parse control point references
-    auto cpRefs = parseEntityRefList(entity.parameters[2]);
+    auto cpRefs = parseEntityRefList(params[2]);
     for (int ref : cpRefs) {
         curve->controlPoints.push_back(getCartesianPoint(ref));
     }
     
     // Parse knot multiplicities
-    auto knotMults = parseIntList(entity.parameters[6]);
+    auto knotMults = parseIntList(params[6]);
     
     // Parse knot values
-    auto knotValues = parseRealList(entity.parameters[7]);
+    auto knotValues = parseRealList(params[7]);
     
     // Build full knot vector
     for (size_t i = 0; i < knotValues.size() && i < knotMults.size(); i++) {
@@ -552,8 +753,8 @@ std::shared_ptr<NURBSCurve> STEPImporter::getBSplineCurve(int entityId)
     }
     
     // Check for rational (weights)
-    if (entity.typeName.find("RATIONAL") != std::string::npos && entity.parameters.size() > 9) {
-        curve->weights = parseRealList(entity.parameters[9]);
+    if (entity->typeName.find("RATIONAL") != std::string_view::npos && params.size() > 9) {
+        curve->weights = parseRealList(params[9]);
     }
     
     return curve;
@@ -561,14 +762,14 @@ std::shared_ptr<NURBSCurve> STEPImporter::getBSplineCurve(int entityId)
 
 std::shared_ptr<NURBSSurface> STEPImporter::getPlane(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() >= 2) {
-        int axisId = parseEntityRef(entity.parameters[1]);
+    auto params = parameters(*entity);
+    if (params.size() >= 2) {
+        int axisId = parseEntityRef(params[1]);
         glm::dmat4 placement = getAxis2Placement3D(axisId);
         
         glm::dvec3 origin(placement[3]);
@@ -597,15 +798,15 @@ std::shared_ptr<NURBSSurface> STEPImporter::getPlane(int entityId)
 
 std::shared_ptr<NURBSSurface> STEPImporter::getCylindricalSurface(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() >= 3) {
-        int axisId = parseEntityRef(entity.parameters[1]);
-        double radius = parseReal(entity.parameters[2]);
+    auto params = parameters(*entity);
+    if (params.size() >= 3) {
+        int axisId = parseEntityRef(params[1]);
+        double radius = parseReal(params[2]);
         
         glm::dmat4 placement = getAxis2Placement3D(axisId);
         glm::dvec3 origin(placement[3]);
@@ -649,64 +850,49 @@ std::shared_ptr<NURBSSurface> STEPImporter::getCylindricalSurface(int entityId)
 
 std::shared_ptr<NURBSSurface> STEPImporter::getBSplineSurface(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
+    auto params = parameters(*entity);
     
     // Parse B-spline surface parameters
-    if (entity.parameters.size() < 12) {
+    if (params.size() < 12) {
         return nullptr;
     }
     
     auto surface = std::make_shared<NURBSSurface>();
-    surface->degreeU = parseInt(entity.parameters[1]);
-    surface->degreeV = parseInt(entity.parameters[2]);
+    surface->degreeU = parseInt(params[1]);
+    surface->degreeV = parseInt(params[2]);
     
-    // Parse control points grid
-    std::string cpGrid = entity.parameters[3];
-    
-    // Remove outer parentheses
-    if (cpGrid.front() == '(' && cpGrid.back() == ')') {
-        cpGrid = cpGrid.substr(1, cpGrid.length() - 2);
-    }
-    
-    // Parse rows
+    // Parse control points grid: ((#1,#2,...),(#5,#6,...),...), one list per row
+    std::string_view cpGrid = params[3];
     int depth = 0;
-    std::string currentRow;
-    for (char c : cpGrid) {
-        if (c == '(') {
-            if (depth == 0) currentRow.clear();
-            depth++;
-            if (depth > 1) currentRow += c;
+    size_t rowStart = 0;
+    for (size_t i = 0; i < cpGrid.size(); i++) {
+        if (cpGrid[i] == '(') {
+            if (++depth == 2) rowStart = i;
         }
-        else if (c == ')') {
-            depth--;
-            if (depth == 0) {
+        else if (cpGrid[i] == ')') {
+            if (depth-- == 2) {
                 // End of row
-                auto refs = parseEntityRefList("(" + currentRow + ")");
+                auto refs = parseEntityRefList(cpGrid.substr(rowStart, i + 1 - rowStart));
                 std::vector<glm::dvec3> row;
+                row.reserve(refs.size());
                 for (int ref : refs) {
                     row.push_back(getCartesianPoint(ref));
                 }
-                surface->controlPoints.push_back(row);
-            }
-            else {
-                currentRow += c;
+                surface->controlPoints.push_back(std::move(row));
             }
         }
-        else if (depth > 0) {
-            currentRow += c;
-        }
     }
     
     // Parse knot multiplicities and knots
-    auto knotMultsU = parseIntList(entity.parameters[8]);
-    auto knotMultsV = parseIntList(entity.parameters[9]);
-    auto knotValuesU = parseRealList(entity.parameters[10]);
-    auto knotValuesV = parseRealList(entity.parameters[11]);
+    auto knotMultsU = parseIntList(params[8]);
+    auto knotMultsV = parseIntList(params[9]);
+    auto knotValuesU = parseRealList(params[10]);
+    auto knotValuesV = parseRealList(params[11]);
     
     // Build full knot vectors
     for (size_t i = 0; i < knotValuesU.size() && i < knotMultsU.size(); i++) {
@@ -722,9 +908,8 @@ std::shared_ptr<NURBSSurface> STEPImporter::getBSplineSurface(int entityId)
     }
     
     // Parse weights for rational surface
-    if (entity.typeName.find("RATIONAL") != std::string::npos && entity.parameters.size() > 13) {
-        // Parse weight grid similarly to control points
-        std::string weightGrid = entity.parameters[13];
+    if (entity->typeName.find("RATIONAL") != std::string_view::npos && params.size() > 13) {
+        // Parse weight grid (params[13]) similarly to control points
         // ... (similar parsing)
     }
     
@@ -733,28 +918,29 @@ std::shared_ptr<NURBSSurface> STEPImporter::getBSplineSurface(int entityId)
 
 std::shared_ptr<Face> STEPImporter::getAdvancedFace(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() < 4) {
+    auto params = parameters(*entity);
+    if (params.size() < 4) {
         return nullptr;
     }
     
     auto face = std::make_shared<Face>();
     
     // Parse bounds list
-    auto boundRefs = parseEntityRefList(entity.parameters[1]);
+    auto boundRefs = parseEntityRefList(params[1]);
     
     for (int boundRef : boundRefs) {
-        auto boundEntity = m_entities.find(boundRef);
-        if (boundEntity != m_entities.end()) {
-            bool isOuter = (boundEntity->second.typeName == "FACE_OUTER_BOUND");
+        const ParsedSTEPEntity* boundEntity = findEntity(boundRef);
+        if (boundEntity) {
+            bool isOuter = (boundEntity->typeName == "FACE_OUTER_BOUND");
+            auto boundParams = parameters(*boundEntity);
             
-            if (boundEntity->second.parameters.size() >= 2) {
-                int loopRef = parseEntityRef(boundEntity->second.parameters[1]);
+            if (boundParams.size() >= 2) {
+                int loopRef = parseEntityRef(boundParams[1]);
                 auto edges = getEdgeLoop(loopRef);
                 
                 if (isOuter) {
@@ -767,14 +953,15 @@ std::shared_ptr<Face> STEPImporter::getAdvancedFace(int entityId)
     }
     
     // Get surface
-    int surfaceRef = parseEntityRef(entity.parameters[2]);
-    auto surfIt = m_surfaces.find(surfaceRef);
-    if (surfIt != m_surfaces.end()) {
-        face->surface = surfIt->second;
+    int surfaceRef = parseEntityRef(params[2]);
+    const ParsedSTEPEntity* surfaceEntity = findEntity(surfaceRef);
+    if (surfaceEntity && surfaceEntity->geometryKind == STEPGeometryKind::Surface &&
+        surfaceEntity->geometryIndex < m_surfaces.size()) {
+        face->surface = m_surfaces[surfaceEntity->geometryIndex];
     }
     
     // Get same sense flag
-    face->sameSense = parseBool(entity.parameters[3]);
+    face->sameSense = parseBool(params[3]);
     
     return face;
 }
@@ -783,14 +970,14 @@ std::vector<std::shared_ptr<Edge>> STEPImporter::getEdgeLoop(int entityId)
 {
     std::vector<std::shared_ptr<Edge>> edges;
     
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return edges;
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() >= 2) {
-        auto edgeRefs = parseEntityRefList(entity.parameters[1]);
+    auto params = parameters(*entity);
+    if (params.size() >= 2) {
+        auto edgeRefs = parseEntityRefList(params[1]);
         
         for (int edgeRef : edgeRefs) {
             auto edge = getEdgeCurveAsEdge(edgeRef);
@@ -805,18 +992,18 @@ std::vector<std::shared_ptr<Edge>> STEPImporter::getEdgeLoop(int entityId)
 
 std::shared_ptr<Edge> STEPImporter::getEdgeCurveAsEdge(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
+    auto params = parameters(*entity);
     
     // Handle ORIENTED_EDGE
-    if (entity.typeName == "ORIENTED_EDGE") {
-        if (entity.parameters.size() >= 4) {
-            int edgeCurveRef = parseEntityRef(entity.parameters[3]);
-            bool orientation = parseBool(entity.parameters[4]);
+    if (entity->typeName == "ORIENTED_EDGE") {
+        if (params.size() >= 5) {
+            int edgeCurveRef = parseEntityRef(params[3]);
+            bool orientation = parseBool(params[4]);
             auto edge = getEdgeCurveAsEdge(edgeCurveRef);
             if (edge) {
                 edge->sameOrientation = orientation;
@@ -826,43 +1013,39 @@ std::shared_ptr<Edge> STEPImporter::getEdgeCurveAsEdge(int entityId)
     }
     
     // Handle EDGE_CURVE
-    if (entity.typeName == "EDGE_CURVE" && entity.parameters.size() >= 5) {
+    if (entity->typeName == "EDGE_CURVE" && params.size() >= 5) {
         auto edge = std::make_shared<Edge>();
         
-        int startVertexRef = parseEntityRef(entity.parameters[1]);
-        int endVertexRef = parseEntityRef(entity.parameters[2]);
-        int curveRef = parseEntityRef(entity.parameters[3]);
-        edge->sameOrientation = parseBool(entity.parameters[4]);
+        int startVertexRef = parseEntityRef(params[1]);
+        int endVertexRef = parseEntityRef(params[2]);
+        int curveRef = parseEntityRef(params[3]);
+        edge->sameOrientation = parseBool(params[4]);
         
         // Get vertex positions
-        auto startVertexEntity = m_entities.find(startVertexRef);
-        auto endVertexEntity = m_entities.find(endVertexRef);
+        const ParsedSTEPEntity* startVertexEntity = findEntity(startVertexRef);
+        const ParsedSTEPEntity* endVertexEntity = findEntity(endVertexRef);
         
-        if (startVertexEntity != m_entities.end() && 
-            startVertexEntity->second.parameters.size() >= 2) {
-            int pointRef = parseEntityRef(startVertexEntity->second.parameters[1]);
+        if (startVertexEntity && parameters(*startVertexEntity).size() >= 2) {
+            int pointRef = parseEntityRef(parameters(*startVertexEntity)[1]);
             edge->startPoint = getCartesianPoint(pointRef);
         }
         
-        if (endVertexEntity != m_entities.end() && 
-            endVertexEntity->second.parameters.size() >= 2) {
-            int pointRef = parseEntityRef(endVertexEntity->second.parameters[1]);
+        if (endVertexEntity && parameters(*endVertexEntity).size() >= 2) {
+            int pointRef = parseEntityRef(parameters(*endVertexEntity)[1]);
             edge->endPoint = getCartesianPoint(pointRef);
         }
         
         // Get curve
-        auto curveIt = m_curves.find(curveRef);
-        if (curveIt != m_curves.end()) {
-            edge->curve = curveIt->second;
-        } else {
+        const ParsedSTEPEntity* curveEntity = findEntity(curveRef);
+        if (curveEntity && curveEntity->geometryKind == STEPGeometryKind::Curve &&
+            curveEntity->geometryIndex < m_curves.size()) {
+            edge->curve = m_curves[curveEntity->geometryIndex];
+        } else if (curveEntity) {
             // Try to create curve from entity
-            auto curveEntity = m_entities.find(curveRef);
-            if (curveEntity != m_entities.end()) {
-                if (curveEntity->second.typeName == "LINE") {
-                    edge->curve = getLine(curveRef);
-                } else if (curveEntity->second.typeName == "CIRCLE") {
-                    edge->curve = getCircle(curveRef);
-                }
+            if (curveEntity->typeName == "LINE") {
+                edge->curve = getLine(curveRef);
+            } else if (curveEntity->typeName == "CIRCLE") {
+                edge->curve = getCircle(curveRef);
             }
         }
         
@@ -874,27 +1057,28 @@ std::shared_ptr<Edge> STEPImporter::getEdgeCurveAsEdge(int entityId)
 
 std::shared_ptr<Body> STEPImporter::getManifoldSolidBrep(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
-    if (entity.parameters.size() < 2) {
+    auto params = parameters(*entity);
+    if (params.size() < 2) {
         return nullptr;
     }
     
     auto body = std::make_shared<Body>();
-    body->name = parseString(entity.parameters[0]);
+    body->name = parseString(params[0]);
     body->isSolid = true;
     
-    int shellRef = parseEntityRef(entity.parameters[1]);
+    int shellRef = parseEntityRef(params[1]);
     auto faceIds = getShellFaceIds(shellRef);
     
     for (int faceId : faceIds) {
-        auto faceIt = m_faces.find(faceId);
-        if (faceIt != m_faces.end()) {
-            body->faces.push_back(faceIt->second);
+        const ParsedSTEPEntity* faceEntity = findEntity(faceId);
+        if (faceEntity && faceEntity->geometryKind == STEPGeometryKind::Face &&
+            faceEntity->geometryIndex < m_faces.size()) {
+            body->faces.push_back(m_faces[faceEntity->geometryIndex]);
         }
     }
     
@@ -903,23 +1087,28 @@ std::shared_ptr<Body> STEPImporter::getManifoldSolidBrep(int entityId)
 
 std::shared_ptr<Body> STEPImporter::getShellBasedModel(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt == m_entities.end()) {
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (!entity) {
+        return nullptr;
+    }
+    
+    auto params = parameters(*entity);
+    if (params.size() < 2) {
         return nullptr;
     }
     
-    auto& entity = entityIt->second;
     auto body = std::make_shared<Body>();
-    body->name = parseString(entity.parameters[0]);
+    body->name = parseString(params[0]);
     body->isSolid = false;
     
-    auto shellRefs = parseEntityRefList(entity.parameters[1]);
+    auto shellRefs = parseEntityRefList(params[1]);
     for (int shellRef : shellRefs) {
         auto faceIds = getShellFaceIds(shellRef);
         for (int faceId : faceIds) {
-            auto faceIt = m_faces.find(faceId);
-            if (faceIt != m_faces.end()) {
-                body->faces.push_back(faceIt->second);
+            const ParsedSTEPEntity* faceEntity = findEntity(faceId);
+            if (faceEntity && faceEntity->geometryKind == STEPGeometryKind::Face &&
+                faceEntity->geometryIndex < m_faces.size()) {
+                body->faces.push_back(m_faces[faceEntity->geometryIndex]);
             }
         }
     }
@@ -931,9 +1120,9 @@ std::vector<int> STEPImporter::getShellFaceIds(int shellId)
 {
     std::vector<int> faceIds;
     
-    auto entityIt = m_entities.find(shellId);
-    if (entityIt != m_entities.end() && entityIt->second.parameters.size() >= 2) {
-        faceIds = parseEntityRefList(entityIt->second.parameters[1]);
+    const ParsedSTEPEntity* entity = findEntity(shellId);
+    if (entity && parameters(*entity).size() >= 2) {
+        faceIds = parseEntityRefList(parameters(*entity)[1]);
     }
     
     return faceIds;
@@ -941,11 +1130,12 @@ std::vector<int> STEPImporter::getShellFaceIds(int shellId)
 
 void STEPImporter::processStyledItems()
 {
-    for (auto& [id, entity] : m_entities) {
-        if (entity.typeName == "STYLED_ITEM" && entity.parameters.size() >= 3) {
+    for (const auto& entity : m_entities) {
+        auto params = parameters(entity);
+        if (entity.typeName == "STYLED_ITEM" && params.size() >= 3) {
             // Extract style and item references
-            auto styleRefs = parseEntityRefList(entity.parameters[1]);
-            int itemRef = parseEntityRef(entity.parameters[2]);
+            auto styleRefs = parseEntityRefList(params[1]);
+            int itemRef = parseEntityRef(params[2]);
             
             // Find color in style chain
             for (int styleRef : styleRefs) {
@@ -958,9 +1148,9 @@ void STEPImporter::processStyledItems()
 
 glm::vec3 STEPImporter::getColorRGB(int entityId)
 {
-    auto entityIt = m_entities.find(entityId);
-    if (entityIt != m_entities.end() && entityIt->second.parameters.size() >= 4) {
-        auto& params = entityIt->second.parameters;
+    const ParsedSTEPEntity* entity = findEntity(entityId);
+    if (entity && parameters(*entity).size() >= 4) {
+        auto params = parameters(*entity);
         return glm::vec3(
             parseReal(params[1]),
             parseReal(params[2]),
@@ -970,112 +1160,83 @@ glm::vec3 STEPImporter::getColorRGB(int entityId)
     return glm::vec3(0.7f);
 }
 
-int STEPImporter::parseEntityRef(const std::string& ref)
+int STEPImporter::parseEntityRef(std::string_view ref)
 {
+    ref = trim(ref);
     if (ref.empty() || ref[0] != '#') {
         return 0;
     }
-    try {
-        return std::stoi(ref.substr(1));
-    } catch (...) {
-        return 0;
-    }
+    int id = 0;
+    return parseNumber(ref.substr(1), id) ? id : 0;
 }
 
-double STEPImporter::parseReal(const std::string& str)
+double STEPImporter::parseReal(std::string_view str)
 {
-    try {
-        return std::stod(str);
-    } catch (...) {
-        return 0.0;
-    }
+    double value = 0.0;
+    return parseNumber(str, value) ? value : 0.0;
 }
 
-int STEPImporter::parseInt(const std::string& str)
+int STEPImporter::parseInt(std::string_view str)
 {
-    try {
-        return std::stoi(str);
-    } catch (...) {
-        return 0;
-    }
+    int value = 0;
+    return parseNumber(str, value) ? value : 0;
 }
 
-std::string STEPImporter::parseString(const std::string& str)
+std::string STEPImporter::parseString(std::string_view str)
 {
-    std::string result = str;
+    str = trim(str);
     
     // Remove quotes
-    if (result.size() >= 2 && result.front() == '\'' && result.back() == '\'') {
-        result = result.substr(1, result.size() - 2);
+    if (str.size() >= 2 && str.front() == '\'' && str.back() == '\'') {
+        str = str.substr(1, str.size() - 2);
     }
     
     // Unescape doubled quotes
-    size_t pos = 0;
-    while ((pos = result.find("''", pos)) != std::string::npos) {
-        result.replace(pos, 2, "'");
-        pos += 1;
+    std::string result;
+    result.reserve(str.size());
+    for (size_t i = 0; i < str.size(); i++) {
+        result += str[i];
+        if (str[i] == '\'' && i + 1 < str.size() && str[i + 1] == '\'') {
+            i++;
+        }
     }
     
     return result;
 }
 
-bool STEPImporter::parseBool(const std::string& str)
+bool STEPImporter::parseBool(std::string_view str)
 {
+    str = trim(str);
     return str == ".T." || str == "T" || str == "TRUE" || str == "true";
 }
 
-std::vector<int> STEPImporter::parseIntList(const std::string& str)
+std::vector<int> STEPImporter::parseIntList(std::string_view str)
 {
     std::vector<int> result;
-    std::string s = str;
-    
-    // Remove parentheses
-    s.erase(std::remove(s.begin(), s.end(), '('), s.end());
-    s.erase(std::remove(s.begin(), s.end(), ')'), s.end());
-    
-    std::istringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, ',')) {
+    forEachListItem(str, [&result](std::string_view item) {
         result.push_back(parseInt(item));
-    }
-    
+    });
     return result;
 }
 
-std::vector<double> STEPImporter::parseRealList(const std::string& str)
+std::vector<double> STEPImporter::parseRealList(std::string_view str)
 {
     std::vector<double> result;
-    std::string s = str;
-    
-    s.erase(std::remove(s.begin(), s.end(), '('), s.end());
-    s.erase(std::remove(s.begin(), s.end(), ')'), s.end());
-    
-    std::istringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, ',')) {
+    forEachListItem(str, [&result](std::string_view item) {
         result.push_back(parseReal(item));
-    }
-    
+    });
     return result;
 }
 
-std::vector<int> STEPImporter::parseEntityRefList(const std::string& str)
+std::vector<int> STEPImporter::parseEntityRefList(std::string_view str)
 {
     std::vector<int> result;
-    std::string s = str;
-    
-    s.erase(std::remove(s.begin(), s.end(), '('), s.end());
-    s.erase(std::remove(s.begin(), s.end(), ')'), s.end());
-    
-    std::istringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, ',')) {
+    forEachListItem(str, [&result](std::string_view item) {
         int ref = parseEntityRef(item);
         if (ref > 0) {
             result.push_back(ref);
         }
-    }
-    
+    });
     return result;
 }
 
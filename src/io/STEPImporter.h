@@ -1,7 +1,9 @@
 #pragma once
 
 #include "ExportOptions.h"
+#include "MappedFile.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <map>
@@ -18,15 +20,43 @@ class Edge;
 class NURBSSurface;
 class NURBSCurve;
 
+/**
+ * Decoded geometry table an entity's geometryIndex refers to
+ */
+enum class STEPGeometryKind : uint8_t {
+    None,
+    Point,
+    Direction,
+    Curve,
+    Surface,
+    Face
+};
+
 /**
  * Parsed STEP entity
+ * Views point into the mapped file and stay valid for the duration of the
+ * import. The top-level parameters are stored contiguously in the
+ * importer's parameter table; nested lists are kept as their raw text.
  */
 struct ParsedSTEPEntity {
-    int id;
-    std::string typeName;
-    std::string rawData;
-    std::vector<std::string> parameters;
-    bool parsed = false;
+    int id = 0;
+    std::string_view typeName;          // "COMPLEX" for multi-type entities
+    std::string_view rawData;           // Text between the outer parentheses
+    uint32_t firstParameter = 0;
+    uint32_t parameterCount = 0;
+    STEPGeometryKind geometryKind = STEPGeometryKind::None;
+    uint32_t geometryIndex = 0;         // Slot in the decoded table of that kind
+};
+
+/**
+ * Top-level parameters of one entity
+ */
+struct STEPParameterList {
+    const std::string_view* items = nullptr;
+    size_t count = 0;
+    
+    size_t size() const { return count; }
+    std::string_view operator[](size_t index) const { return items[index]; }
 };
 
 /**
@@ -67,6 +97,11 @@ struct STEPBSplineSurface {
 /**
  * STEP file importer
  * Imports STEP AP203 and AP214 files
+ *
+ * The file is memory-mapped and lexed in a single pass into a table of
+ * entities indexed densely by id. Points and directions, then curves and
+ * surfaces, then faces are decoded in parallel, each stage reading only
+ * the tables completed before it; bodies are assembled last.
  */
 class STEPImporter {
 public:
@@ -101,13 +136,18 @@ public:
     const ImportStats& getStats() const { return m_stats; }
     
 private:
-    std::map<int, ParsedSTEPEntity> m_entities;
-    std::map<int, glm::dvec3> m_points;
-    std::map<int, glm::dvec3> m_directions;
-    std::map<int, std::shared_ptr<NURBSCurve>> m_curves;
-    std::map<int, std::shared_ptr<NURBSSurface>> m_surfaces;
-    std::map<int, std::shared_ptr<Face>> m_faces;
-    std::map<int, std::shared_ptr<Body>> m_bodies;
+    dc3d::io::MappedFile m_file;
+    std::vector<ParsedSTEPEntity> m_entities;       // Sorted by id
+    std::vector<std::string_view> m_parameters;     // Top-level parameters of all entities
+    std::vector<uint32_t> m_entityIndex;            // Id -> slot in m_entities (empty if ids are sparse)
+    
+    // Decoded geometry, indexed by ParsedSTEPEntity::geometryIndex
+    std::vector<glm::dvec3> m_points;
+    std::vector<glm::dvec3> m_directions;
+    std::vector<std::shared_ptr<NURBSCurve>> m_curves;
+    std::vector<std::shared_ptr<NURBSSurface>> m_surfaces;
+    std::vector<std::shared_ptr<Face>> m_faces;
+    std::vector<std::shared_ptr<Body>> m_bodies;
     std::map<int, glm::vec3> m_colors;
     
     std::string m_errorMessage;
@@ -116,10 +156,13 @@ private:
     
     // Parsing
     bool parseFile(const std::string& filename);
-    bool parseHeader(std::istream& stream);
-    bool parseDataSection(std::istream& stream);
-    ParsedSTEPEntity parseEntity(const std::string& line);
-    std::vector<std::string> parseParameters(const std::string& data);
+    bool parseEntity(const char*& pos, const char* end);
+    void buildEntityIndex();
+    void releaseTables();
+    
+    // Entity lookup
+    const ParsedSTEPEntity* findEntity(int entityId) const;
+    STEPParameterList parameters(const ParsedSTEPEntity& entity) const;
     
     // Entity processing
     bool processEntities();
@@ -157,15 +200,15 @@ private:
     // Product structure
     std::string getProductName(int productId);
     
-    // Utility functions
-    int parseEntityRef(const std::string& ref);
-    double parseReal(const std::string& str);
-    int parseInt(const std::string& str);
-    std::string parseString(const std::string& str);
-    bool parseBool(const std::string& str);
-    std::vector<int> parseIntList(const std::string& str);
-    std::vector<double> parseRealList(const std::string& str);
-    std::vector<int> parseEntityRefList(const std::string& str);
+    // Utility functions (thread-safe: used while decoding in parallel)
+    static int parseEntityRef(std::string_view ref);
+    static double parseReal(std::string_view str);
+    static int parseInt(std::string_view str);
+    static std::string parseString(std::string_view str);
+    static bool parseBool(std::string_view str);
+    static std::vector<int> parseIntList(std::string_view str);
+    static std::vector<double> parseRealList(std::string_view str);
+    static std::vector<int> parseEntityRefList(std::string_view str);
     
     void addWarning(const std::string& msg);
 };
@@ -4,9 +4,12 @@
  */
 
 #include "STLImporter.h"
+#include "MappedFile.h"
+#include "TextTokenizer.h"
+#include "../core/TaskScheduler.h"
+#include "../geometry/DerivedDataCache.h"
 
 #include <fstream>
-#include <sstream>
 #include <cstring>
 #include <cctype>
 #include <algorithm>
@@ -23,12 +26,20 @@ constexpr size_t STL_HEADER_SIZE = 80;
 // Size of a single triangle in binary STL (normal + 3 vertices + attribute)
 constexpr size_t STL_TRIANGLE_SIZE = 50;  // 12 + 12*3 + 2 = 50 bytes
 
-// Read a little-endian float from stream
-float readFloat(std::istream& stream) {
-    float value;
-    stream.read(reinterpret_cast<char*>(&value), sizeof(float));
-    return value;
-}
+// Offset of the first vertex within a triangle record (after the normal)
+constexpr size_t STL_VERTEX_OFFSET = 12;
+
+// Bytes inspected by format detection
+constexpr size_t STL_DETECT_SIZE = 255;
+
+// Triangles decoded per parallel chunk
+constexpr size_t STL_DECODE_GRAIN = 65536;
+
+// ASCII text parsed per parallel chunk
+constexpr size_t STL_ASCII_CHUNK_BYTES = 4 << 20;
+
+// Binary records are decoded by copying three packed floats per vertex
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be tightly packed");
 
 // Read a little-endian uint32 from stream
 uint32_t readUint32(std::istream& stream) {
@@ -37,22 +48,6 @@ uint32_t readUint32(std::istream& stream) {
     return value;
 }
 
-// Read a little-endian uint16 from stream
-uint16_t readUint16(std::istream& stream) {
-    uint16_t value;
-    stream.read(reinterpret_cast<char*>(&value), sizeof(uint16_t));
-    return value;
-}
-
-// Read vec3 from stream (3 floats)
-glm::vec3 readVec3(std::istream& stream) {
-    glm::vec3 v;
-    v.x = readFloat(stream);
-    v.y = readFloat(stream);
-    v.z = readFloat(stream);
-    return v;
-}
-
 // Trim whitespace from string
 std::string trim(const std::string& str) {
     size_t first = str.find_first_not_of(" \t\r\n");
@@ -69,6 +64,154 @@ std::string toLower(const std::string& str) {
     return result;
 }
 
+/**
+ * @brief Decide binary vs ASCII from the start of a file
+ * @param head First bytes of the file (up to STL_DETECT_SIZE)
+ * @param headSize Number of bytes in head
+ * @param fileSize Total file size
+ */
+bool isBinarySTL(const char* head, size_t headSize, size_t fileSize) {
+    if (headSize < STL_HEADER_SIZE) {
+        return false;  // File too small, assume ASCII
+    }
+    
+    // Check if header starts with "solid" (ASCII STL marker)
+    std::string headerStr(head, strnlen(head, STL_HEADER_SIZE));
+    std::string headerLower = toLower(trim(headerStr));
+    
+    // Read triangle count (for binary)
+    uint32_t triangleCount = 0;
+    if (headSize >= STL_HEADER_SIZE + 4) {
+        std::memcpy(&triangleCount, head + STL_HEADER_SIZE, sizeof(uint32_t));
+    }
+    
+    // Calculate expected binary file size
+    size_t expectedBinarySize = STL_HEADER_SIZE + 4 + (static_cast<size_t>(triangleCount) * STL_TRIANGLE_SIZE);
+    
+    // Heuristics:
+    // 1. If file size matches binary size calculation, it's likely binary
+    // 2. If header starts with "solid" and file size doesn't match, it's likely ASCII
+    // 3. Check for non-printable characters in header
+    
+    // Check for non-printable characters (indicates binary); line breaks
+    // and tabs are part of any ASCII STL's first lines
+    bool hasNonPrintable = false;
+    for (size_t i = 0; i < STL_HEADER_SIZE; ++i) {
+        unsigned char c = static_cast<unsigned char>(head[i]);
+        if (c == '\n' || c == '\r' || c == '\t') continue;
+        if (c != 0 && (c < 32 || c > 126)) {
+            hasNonPrintable = true;
+            break;
+        }
+    }
+    
+    // Decision logic
+    if (fileSize == expectedBinarySize && triangleCount > 0) {
+        return true;  // Likely binary
+    }
+    
+    if (headerLower.substr(0, 5) == "solid" && !hasNonPrintable) {
+        // ASCII STL should have "facet" keyword early
+        std::string content(head, strnlen(head, std::min(headSize, STL_DETECT_SIZE)));
+        if (content.find("facet") != std::string::npos ||
+            content.find("endsolid") != std::string::npos) {
+            return false;  // ASCII
+        }
+    }
+    
+    // Default to binary if file size matches or has non-printable chars
+    return hasNonPrintable || 
+           (fileSize >= STL_HEADER_SIZE + 4 + STL_TRIANGLE_SIZE);
+}
+
+/**
+ * @brief Triangles parsed from one chunk of an ASCII STL
+ */
+struct ASCIIChunk {
+    std::vector<glm::vec3> vertices;   ///< Three per completed facet
+    const char* errorLine = nullptr;   ///< Start of the offending line, if any
+    std::string error;                 ///< Error description without line number
+    bool reachedEnd = false;           ///< Chunk contains 'endsolid'
+};
+
+// Move a chunk boundary forward to the next line that starts a facet
+const char* alignToFacet(const char* pos, const char* end) {
+    TextTokenizer tokenizer(pos, end);
+    for (; !tokenizer.atEnd(); tokenizer.nextLine()) {
+        const char* lineStart = tokenizer.position();
+        std::string_view keyword = tokenizer.token();
+        if (TextTokenizer::equalsKeyword(keyword, "facet") ||
+            TextTokenizer::equalsKeyword(keyword, "endsolid")) {
+            return lineStart;
+        }
+    }
+    return end;
+}
+
+// Parse the facets of one chunk; stops at the first error or 'endsolid'
+void parseASCIIChunk(const char* begin, const char* end, ASCIIChunk& chunk) {
+    TextTokenizer tokenizer(begin, end);
+    
+    glm::vec3 vertices[3];
+    int vertexIndex = 0;
+    bool inFacet = false;
+    
+    auto fail = [&](const char* lineStart, std::string message) {
+        chunk.errorLine = lineStart;
+        chunk.error = std::move(message);
+    };
+    
+    for (; !tokenizer.atEnd(); tokenizer.nextLine()) {
+        const char* lineStart = tokenizer.position();
+        std::string_view keyword = tokenizer.token();
+        
+        if (TextTokenizer::equalsKeyword(keyword, "endsolid")) {
+            chunk.reachedEnd = true;
+            return;
+        }
+        else if (TextTokenizer::equalsKeyword(keyword, "facet")) {
+            // facet normal ni nj nk - the normal is recomputed, so it is not parsed
+            inFacet = true;
+            vertexIndex = 0;
+        }
+        else if (TextTokenizer::equalsKeyword(keyword, "vertex")) {
+            if (!inFacet) {
+                return fail(lineStart,
+                    "Found 'vertex' outside of a facet block.\n"
+                    "Expected 'facet normal' before vertex definitions.");
+            }
+            if (vertexIndex >= 3) {
+                return fail(lineStart,
+                    "Too many vertices in facet (found more than 3).\n"
+                    "STL format only supports triangular faces.");
+            }
+            
+            glm::vec3& v = vertices[vertexIndex];
+            if (!tokenizer.read(v.x) || !tokenizer.read(v.y) || !tokenizer.read(v.z)) {
+                return fail(lineStart,
+                    "Invalid vertex coordinates. Expected 3 numeric values.\n"
+                    "Line content: " + std::string(TextTokenizer(lineStart, end).restOfLine()));
+            }
+            ++vertexIndex;
+        }
+        else if (TextTokenizer::equalsKeyword(keyword, "endfacet")) {
+            if (!inFacet) {
+                return fail(lineStart,
+                    "Found 'endfacet' without matching 'facet' keyword.");
+            }
+            if (vertexIndex != 3) {
+                return fail(lineStart,
+                    "Incomplete facet - found " + std::to_string(vertexIndex) + " vertices, expected 3.\n"
+                    "Each triangle in STL must have exactly 3 vertices.");
+            }
+            
+            chunk.vertices.insert(chunk.vertices.end(), vertices, vertices + 3);
+            inFacet = false;
+        }
+        // 'solid', 'outer loop', 'endloop' and blank lines carry no data
+    }
+}
+
 } // anonymous namespace
 
 geometry::Result<geometry::MeshData> STLImporter::import(
@@ -120,6 +263,18 @@ geometry::Result<geometry::MeshData> STLImporter::import(
     
     bool isBinary = *isBinaryOpt;
     
+    // Decode straight from a memory map, no stream or copies
+    {
+        MappedFile mapped;
+        std::string mapError;
+        if (mapped.open(path, &mapError)) {
+            return isBinary
+                ? importBinaryData(mapped.data(), mapped.size(), options, progress)
+                : importASCIIData(mapped.data(), mapped.size(), options, progress);
+        }
+        // Mapping can fail on exotic filesystems; fall back to streaming
+    }
+    
     // Open file
     std::ios_base::openmode mode = std::ios::in;
     if (isBinary) {
@@ -166,15 +321,12 @@ geometry::Result<geometry::MeshData> STLImporter::importFromMemory(
             "A valid STL requires at least " + std::to_string(STL_HEADER_SIZE + 4) + " bytes.");
     }
     
-    // Create memory stream
-    std::string dataStr(static_cast<const char*>(data), size);
-    std::istringstream stream(dataStr, std::ios::binary);
-    
-    // Detect format
-    bool isBinary = detectBinaryFormat(stream);
-    stream.seekg(0);  // Reset to beginning
+    const char* bytes = static_cast<const char*>(data);
+    if (isBinarySTL(bytes, std::min(size, STL_DETECT_SIZE), size)) {
+        return importBinaryData(bytes, size, options, progress);  // Zero-copy
+    }
     
-    return importFromStream(stream, isBinary, options, progress);
+    return importASCIIData(bytes, size, options, progress);
 }
 
 std::optional<bool> STLImporter::detectBinaryFormat(const std::filesystem::path& path) {
@@ -190,23 +342,11 @@ bool STLImporter::detectBinaryFormat(std::istream& stream) {
     // Save current position
     auto startPos = stream.tellg();
     
-    // Read first 80 characters (header for binary STL)
-    char header[STL_HEADER_SIZE + 1];
-    stream.read(header, STL_HEADER_SIZE);
-    header[STL_HEADER_SIZE] = '\0';
-    
-    if (!stream) {
-        stream.clear();
-        stream.seekg(startPos);
-        return false;  // File too small, assume ASCII
-    }
-    
-    // Check if header starts with "solid" (ASCII STL marker)
-    std::string headerStr(header);
-    std::string headerLower = toLower(trim(headerStr));
-    
-    // Read triangle count (for binary)
-    uint32_t triangleCount = readUint32(stream);
+    // Read the start of the file (header, triangle count, first ASCII lines)
+    char head[STL_DETECT_SIZE];
+    stream.read(head, STL_DETECT_SIZE);
+    size_t headSize = static_cast<size_t>(stream.gcount());
+    stream.clear();
     
     // Get file size
     stream.seekg(0, std::ios::end);
@@ -215,49 +355,7 @@ bool STLImporter::detectBinaryFormat(std::istream& stream) {
     // Reset position
     stream.seekg(startPos);
     
-    // Calculate expected binary file size
-    size_t expectedBinarySize = STL_HEADER_SIZE + 4 + (triangleCount * STL_TRIANGLE_SIZE);
-    
-    // Heuristics:
-    // 1. If file size matches binary size calculation, it's likely binary
-    // 2. If header starts with "solid" and file size doesn't match, it's likely ASCII
-    // 3. Check for non-printable characters in header
-    
-    // Check for non-printable characters (indicates binary)
-    bool hasNonPrintable = false;
-    for (int i = 0; i < 80; ++i) {
-        unsigned char c = static_cast<unsigned char>(header[i]);
-        if (c != 0 && (c < 32 || c > 126)) {
-            hasNonPrintable = true;
-            break;
-        }
-    }
-    
-    // Decision logic
-    if (static_cast<size_t>(fileSize) == expectedBinarySize && triangleCount > 0) {
-        return true;  // Likely binary
-    }
-    
-    if (headerLower.substr(0, 5) == "solid" && !hasNonPrintable) {
-        // Additional check: look for "facet" keyword in ASCII STL
-        stream.seekg(startPos);
-        char buffer[256];
-        stream.read(buffer, 255);
-        buffer[255] = '\0';
-        
-        std::string content(buffer);
-        stream.seekg(startPos);
-        
-        // ASCII STL should have "facet" keyword early
-        if (content.find("facet") != std::string::npos ||
-            content.find("endsolid") != std::string::npos) {
-            return false;  // ASCII
-        }
-    }
-    
-    // Default to binary if file size matches or has non-printable chars
-    return hasNonPrintable || 
-           (static_cast<size_t>(fileSize) >= STL_HEADER_SIZE + 4 + STL_TRIANGLE_SIZE);
+    return isBinarySTL(head, headSize, fileSize > 0 ? static_cast<size_t>(fileSize) : 0);
 }
 
 size_t STLImporter::getTriangleCount(const std::filesystem::path& path) {
@@ -283,145 +381,125 @@ geometry::Result<geometry::MeshData> STLImporter::importASCII(
     const STLImportOptions& options,
     geometry::ProgressCallback progress) {
     
-    geometry::MeshData mesh;
-    
-    std::string line;
-    std::string token;
-    
-    glm::vec3 faceNormal(0.0f);
-    glm::vec3 vertices[3];
-    int vertexIndex = 0;
-    bool inFacet = false;
-    size_t faceCount = 0;
-    size_t lineNumber = 0;
+    std::string text = TextTokenizer::readAll(stream);
+    return importASCIIData(text.data(), text.size(), options, progress);
+}
+
+geometry::Result<geometry::MeshData> STLImporter::importASCIIData(
+    const char* data,
+    size_t size,
+    const STLImportOptions& options,
+    geometry::ProgressCallback progress) {
     
-    // Estimate total lines for progress (rough guess)
-    stream.seekg(0, std::ios::end);
-    auto fileSize = stream.tellg();
-    stream.seekg(0);
+    geometry::MeshData mesh;
+    const char* end = data + size;
     
-    // Rough estimate: ~50 bytes per triangle in ASCII
-    size_t estimatedTriangles = static_cast<size_t>(fileSize) / 200;
+    // Rough estimate: ~200 bytes per triangle in ASCII
+    size_t estimatedTriangles = size / 200;
     bool reportProgress = progress && estimatedTriangles > options.progressThreshold;
     
-    // Reserve approximate space
-    if (estimatedTriangles > 0) {
-        mesh.reserveVertices(estimatedTriangles * 3);
-        mesh.reserveFaces(estimatedTriangles);
-    }
-    
-    while (std::getline(stream, line)) {
-        ++lineNumber;
-        
-        line = trim(line);
-        if (line.empty()) continue;
-        
-        std::istringstream iss(line);
-        iss >> token;
-        token = toLower(token);
+    // Newline-aligned chunks, each moved forward to a facet boundary so
+    // every facet is parsed by exactly one chunk
+    std::vector<const char*> bounds = TextTokenizer::splitLines(data, end, STL_ASCII_CHUNK_BYTES);
+    for (size_t c = 1; c + 1 < bounds.size(); ++c) {
+        bounds[c] = std::max(alignToFacet(bounds[c], end), bounds[c - 1]);
+    }
+    
+    const size_t chunkCount = bounds.size() - 1;
+    std::vector<ASCIIChunk> chunks(chunkCount);
+    core::ParallelProgress reporter(reportProgress ? progress : nullptr, size, 0.0f, 0.8f);
+    
+    // Chunks are parsed in waves and stitched after each one. Without a
+    // sink the whole file is a single wave; when streaming, a wave holds
+    // one chunk per worker and is delivered before the next starts.
+    MeshStreamer streamer(options.sink);
+    streamer.begin(0, 0);
+    const size_t waveSize = streamer.active()
+        ? std::max<size_t>(1, core::TaskScheduler::instance().threadCount())
+        : chunkCount;
+    
+    std::vector<glm::vec3>& vertices = mesh.editVertices();
+    std::vector<uint32_t>& indices = mesh.editIndices();
+    bool reachedEnd = false;
+    
+    for (size_t wave = 0; wave < chunkCount && !reachedEnd; wave += waveSize) {
+        const size_t waveEnd = std::min(wave + waveSize, chunkCount);
+        bool completed = core::parallelFor(wave, waveEnd, [&](size_t chunkBegin, size_t chunkEnd) {
+            for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+                parseASCIIChunk(bounds[c], bounds[c + 1], chunks[c]);
+                reporter.advance(static_cast<size_t>(bounds[c + 1] - bounds[c]));
+            }
+        }, 1, &reporter.token());
         
-        if (token == "solid") {
-            // Start of solid - ignore name
-            continue;
-        }
-        else if (token == "endsolid") {
-            // End of solid
-            break;
-        }
-        else if (token == "facet") {
-            // facet normal ni nj nk
-            inFacet = true;
-            vertexIndex = 0;
-            
-            iss >> token;  // "normal"
-            iss >> faceNormal.x >> faceNormal.y >> faceNormal.z;
-        }
-        else if (token == "outer") {
-            // outer loop - just skip
-            continue;
+        if (!completed) {
+            return geometry::Result<geometry::MeshData>::failure(
+                "Import cancelled by user.");
         }
-        else if (token == "vertex") {
-            if (!inFacet) {
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                    "Found 'vertex' outside of a facet block.\n"
-                    "Expected 'facet normal' before vertex definitions.");
-            }
-            if (vertexIndex >= 3) {
+        
+        // Stitch chunks in file order, up to the first error or 'endsolid'
+        std::vector<size_t> offsets(waveEnd - wave + 1, vertices.size());
+        size_t usedChunks = wave;
+        for (; usedChunks < waveEnd; ++usedChunks) {
+            const ASCIIChunk& chunk = chunks[usedChunks];
+            if (chunk.errorLine) {
+                size_t lineNumber = 1 + TextTokenizer::countLines(data, chunk.errorLine);
                 return geometry::Result<geometry::MeshData>::failure(
-                    "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                    "Too many vertices in facet (found more than 3).\n"
-                    "STL format only supports triangular faces.");
+                    "Parse error at line " + std::to_string(lineNumber) + ":\n" + chunk.error);
             }
-            
-            iss >> vertices[vertexIndex].x 
-                >> vertices[vertexIndex].y 
-                >> vertices[vertexIndex].z;
-            
-            if (iss.fail()) {
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                    "Invalid vertex coordinates. Expected 3 numeric values.\n"
-                    "Line content: " + line);
+            offsets[usedChunks - wave + 1] = offsets[usedChunks - wave] + chunk.vertices.size();
+            if (chunk.reachedEnd) {
+                ++usedChunks;
+                reachedEnd = true;
+                break;
             }
-            ++vertexIndex;
         }
-        else if (token == "endloop") {
-            // End of vertex loop
-            continue;
-        }
-        else if (token == "endfacet") {
-            if (!inFacet) {
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                    "Found 'endfacet' without matching 'facet' keyword.");
-            }
-            if (vertexIndex != 3) {
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Parse error at line " + std::to_string(lineNumber) + ":\n"
-                    "Incomplete facet - found " + std::to_string(vertexIndex) + " vertices, expected 3.\n"
-                    "Each triangle in STL must have exactly 3 vertices.");
-            }
-            
-            // Add the triangle
-            uint32_t i0 = mesh.addVertex(vertices[0]);
-            uint32_t i1 = mesh.addVertex(vertices[1]);
-            uint32_t i2 = mesh.addVertex(vertices[2]);
-            mesh.addFace(i0, i1, i2);
-            
-            inFacet = false;
-            ++faceCount;
-            
-            // Progress reporting
-            if (reportProgress && (faceCount % 100000 == 0)) {
-                float prog = static_cast<float>(faceCount) / estimatedTriangles;
-                if (!progress(std::min(prog, 0.95f))) {
-                    return geometry::Result<geometry::MeshData>::failure(
-                        "Import cancelled by user.");
+        
+        vertices.resize(offsets[usedChunks - wave]);
+        indices.resize(vertices.size());
+        core::parallelFor(wave, usedChunks, [&](size_t chunkBegin, size_t chunkEnd) {
+            for (size_t c = chunkBegin; c < chunkEnd; ++c) {
+                const size_t first = offsets[c - wave];
+                std::copy(chunks[c].vertices.begin(), chunks[c].vertices.end(),
+                          vertices.begin() + static_cast<std::ptrdiff_t>(first));
+                for (size_t i = first; i < offsets[c - wave + 1]; ++i) {
+                    indices[i] = static_cast<uint32_t>(i);
                 }
+                std::vector<glm::vec3>().swap(chunks[c].vertices);
             }
+        }, 1);
+        
+        if (!streamer.flush(vertices, vertices.size(), indices, indices.size())) {
+            return geometry::Result<geometry::MeshData>::failure(
+                "Import cancelled by user.");
         }
     }
     
-    if (mesh.isEmpty()) {
+    if (vertices.empty()) {
         return geometry::Result<geometry::MeshData>::failure(
             "No valid triangles found in ASCII STL file.\n"
             "The file may be empty, or it may not be a valid STL file.\n"
             "Check that the file contains 'facet' and 'vertex' definitions.");
     }
     
-    // Post-processing
+    // Post-processing (welding is cached by mesh content across sessions)
     if (options.mergeVertexTolerance > 0) {
-        mesh.mergeDuplicateVertices(options.mergeVertexTolerance, 
-            reportProgress ? progress : nullptr);
-    }
-    
-    if (options.computeNormals) {
-        mesh.computeNormals();
+        auto progressWrapper = reportProgress ? 
+            [&progress](float p) { return progress(0.8f + p * 0.15f); } : 
+            geometry::ProgressCallback{};
+        
+        if (!geometry::DerivedDataCache::instance().weldMesh(
+                mesh, options.mergeVertexTolerance, options.computeNormals, progressWrapper)) {
+            return geometry::Result<geometry::MeshData>::failure(
+                "Import cancelled by user.");
+        }
+    } else {
+        if (options.computeNormals) {
+            mesh.computeNormals();
+        }
+        
+        mesh.shrinkToFit();
     }
     
-    mesh.shrinkToFit();
-    
     // CRITICAL FIX: Validate ASCII mesh before returning to catch any corruption
     if (!mesh.isValid()) {
         return geometry::Result<geometry::MeshData>::failure(
@@ -442,24 +520,47 @@ geometry::Result<geometry::MeshData> STLImporter::importBinary(
     const STLImportOptions& options,
     geometry::ProgressCallback progress) {
     
+    // Pull the remaining stream into memory and decode it in bulk
+    auto startPos = stream.tellg();
+    stream.seekg(0, std::ios::end);
+    auto endPos = stream.tellg();
+    stream.seekg(startPos);
+    if (startPos < 0 || endPos < startPos) {
+        return geometry::Result<geometry::MeshData>::failure(
+            "Cannot read STL header (first 80 bytes).\n"
+            "The file may be corrupted or truncated.");
+    }
+    
+    std::vector<char> buffer(static_cast<size_t>(endPos - startPos));
+    stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.resize(static_cast<size_t>(stream.gcount()));
+    
+    return importBinaryData(buffer.data(), buffer.size(), options, progress);
+}
+
+geometry::Result<geometry::MeshData> STLImporter::importBinaryData(
+    const char* data,
+    size_t size,
+    const STLImportOptions& options,
+    geometry::ProgressCallback progress) {
+    
     geometry::MeshData mesh;
     
-    // Read header (80 bytes)
-    char header[STL_HEADER_SIZE];
-    stream.read(header, STL_HEADER_SIZE);
-    if (!stream) {
+    // Header (80 bytes)
+    if (size < STL_HEADER_SIZE) {
         return geometry::Result<geometry::MeshData>::failure(
             "Cannot read STL header (first 80 bytes).\n"
             "The file may be corrupted or truncated.");
     }
     
-    // Read triangle count
-    uint32_t triangleCount = readUint32(stream);
-    if (!stream) {
+    // Triangle count
+    if (size < STL_HEADER_SIZE + 4) {
         return geometry::Result<geometry::MeshData>::failure(
             "Cannot read triangle count from STL header.\n"
             "The file may be corrupted or truncated.");
     }
+    uint32_t triangleCount;
+    std::memcpy(&triangleCount, data + STL_HEADER_SIZE, sizeof(uint32_t));
     
     if (triangleCount == 0) {
         return geometry::Result<geometry::MeshData>::failure(
@@ -479,76 +580,73 @@ geometry::Result<geometry::MeshData> STLImporter::importBinary(
     
     // Validate file has enough data for declared triangle count (CRITICAL FIX: File size validation)
     size_t expectedSize = STL_HEADER_SIZE + 4 + (static_cast<size_t>(triangleCount) * STL_TRIANGLE_SIZE);
-    stream.seekg(0, std::ios::end);
-    auto actualFileSize = stream.tellg();
-    if (actualFileSize < 0 || static_cast<size_t>(actualFileSize) < expectedSize) {
-        size_t actualSize = actualFileSize > 0 ? static_cast<size_t>(actualFileSize) : 0;
-        size_t missingBytes = expectedSize - actualSize;
+    if (size < expectedSize) {
+        size_t missingBytes = expectedSize - size;
         return geometry::Result<geometry::MeshData>::failure(
             "STL file is truncated.\n"
             "File declares " + std::to_string(triangleCount) + " triangles, "
             "but file is missing " + std::to_string(missingBytes) + " bytes of data.\n"
             "The file may have been incompletely downloaded or copied.");
     }
-    stream.seekg(STL_HEADER_SIZE + 4);  // Reset to start of triangle data
     
     bool reportProgress = progress && triangleCount > options.progressThreshold;
     
-    // Pre-allocate (STL files have 3 vertices per triangle, with duplicates)
-    mesh.reserveVertices(triangleCount * 3);
-    mesh.reserveFaces(triangleCount);
-    
-    // Read triangles
-    for (uint32_t t = 0; t < triangleCount; ++t) {
-        // LOW FIX: Skip face normal directly instead of reading into unused variable
-        // Skip 12 bytes (normal vector) - we recompute normals later
-        stream.seekg(12, std::ios::cur);
-        
-        // Read 3 vertices (36 bytes)
-        glm::vec3 v0 = readVec3(stream);
-        glm::vec3 v1 = readVec3(stream);
-        glm::vec3 v2 = readVec3(stream);
-        
-        // LOW FIX: Skip attribute byte count directly (2 bytes) - usually 0
-        stream.seekg(2, std::ios::cur);
+    // Unwelded layout: triangle t owns vertices 3t..3t+2, so every record
+    // decodes independently into its final slot
+    const size_t vertexCount = static_cast<size_t>(triangleCount) * 3;
+    std::vector<glm::vec3>& vertices = mesh.editVertices();
+    std::vector<uint32_t>& indices = mesh.editIndices();
+    vertices.resize(vertexCount);
+    indices.resize(vertexCount);
+    
+    // Records are little-endian like the host; the face normal and attribute
+    // bytes are skipped (normals are recomputed later)
+    const char* records = data + STL_HEADER_SIZE + 4;
+    core::ParallelProgress reporter(reportProgress ? progress : nullptr, triangleCount, 0.0f, 0.8f);
+    
+    // When streaming, decode block by block and hand each one to the sink
+    MeshStreamer streamer(options.sink);
+    streamer.begin(vertexCount, triangleCount);
+    const size_t blockSize = streamer.active() ? STREAM_CHUNK_TRIANGLES : triangleCount;
+    
+    for (size_t block = 0; block < triangleCount; block += blockSize) {
+        const size_t blockEnd = std::min<size_t>(block + blockSize, triangleCount);
+        bool completed = core::parallelFor(block, blockEnd, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                std::memcpy(&vertices[t * 3], records + t * STL_TRIANGLE_SIZE + STL_VERTEX_OFFSET,
+                            3 * sizeof(glm::vec3));
+                indices[t * 3 + 0] = static_cast<uint32_t>(t * 3 + 0);
+                indices[t * 3 + 1] = static_cast<uint32_t>(t * 3 + 1);
+                indices[t * 3 + 2] = static_cast<uint32_t>(t * 3 + 2);
+            }
+            reporter.advance(end - begin);
+        }, STL_DECODE_GRAIN, &reporter.token());
         
-        if (!stream) {
+        if (!completed || !streamer.flush(vertices, blockEnd * 3, indices, blockEnd * 3)) {
             return geometry::Result<geometry::MeshData>::failure(
-                "Failed to read triangle " + std::to_string(t + 1) + " of " + std::to_string(triangleCount) + ".\n"
-                "The file may be truncated or corrupted.");
-        }
-        
-        // Add vertices and face
-        uint32_t i0 = mesh.addVertex(v0);
-        uint32_t i1 = mesh.addVertex(v1);
-        uint32_t i2 = mesh.addVertex(v2);
-        mesh.addFace(i0, i1, i2);
-        
-        // Progress reporting
-        if (reportProgress && (t % 100000 == 0)) {
-            float prog = static_cast<float>(t) / triangleCount;
-            if (!progress(prog * 0.8f)) {  // Reserve 20% for post-processing
-                return geometry::Result<geometry::MeshData>::failure(
-                    "Import cancelled");
-            }
+                "Import cancelled");
         }
     }
     
-    // Post-processing
+    // Post-processing (welding is cached by mesh content across sessions)
     if (options.mergeVertexTolerance > 0) {
         auto progressWrapper = reportProgress ? 
             [&progress](float p) { return progress(0.8f + p * 0.15f); } : 
             geometry::ProgressCallback{};
         
-        mesh.mergeDuplicateVertices(options.mergeVertexTolerance, progressWrapper);
-    }
-    
-    if (options.computeNormals) {
-        mesh.computeNormals();
+        if (!geometry::DerivedDataCache::instance().weldMesh(
+                mesh, options.mergeVertexTolerance, options.computeNormals, progressWrapper)) {
+            return geometry::Result<geometry::MeshData>::failure(
+                "Import cancelled by user.");
+        }
+    } else {
+        if (options.computeNormals) {
+            mesh.computeNormals();
+        }
+        
+        mesh.shrinkToFit();
     }
     
-    mesh.shrinkToFit();
-    
     // CRITICAL FIX: Validate binary mesh before returning to catch any corruption
     if (!mesh.isValid()) {
         return geometry::Result<geometry::MeshData>::failure(
@@ -3,12 +3,14 @@
  * @brief STL file format importer (ASCII and binary)
  * 
  * Supports both ASCII and binary STL formats with automatic detection.
- * Handles large files efficiently with progress reporting.
+ * Binary files are memory-mapped and decoded in parallel, so large scans
+ * load at close to disk bandwidth.
  */
 
 #pragma once
 
 #include "../geometry/MeshData.h"
+#include "MeshSink.h"
 
 #include <string>
 #include <filesystem>
@@ -29,6 +31,9 @@ struct STLImportOptions {
     
     /// Report progress for files larger than this many triangles
     size_t progressThreshold = 1000000;
+    
+    /// Optional: receives geometry in chunks while the file is decoded
+    MeshSink* sink = nullptr;
 };
 
 /**
@@ -117,10 +122,34 @@ private:
         const STLImportOptions& options,
         geometry::ProgressCallback progress);
     
+    /**
+     * @brief Parse a complete ASCII STL held in memory
+     * 
+     * The text is split into facet-aligned chunks that are tokenized in
+     * parallel and concatenated in file order.
+     */
+    static geometry::Result<geometry::MeshData> importASCIIData(
+        const char* data,
+        size_t size,
+        const STLImportOptions& options,
+        geometry::ProgressCallback progress);
+    
     static geometry::Result<geometry::MeshData> importBinary(
         std::istream& stream,
         const STLImportOptions& options,
         geometry::ProgressCallback progress);
+    
+    /**
+     * @brief Decode a complete binary STL held in memory
+     * 
+     * Triangle records are decoded in parallel chunks straight into the
+     * pre-sized vertex array; data may point into a memory-mapped file.
+     */
+    static geometry::Result<geometry::MeshData> importBinaryData(
+        const char* data,
+        size_t size,
+        const STLImportOptions& options,
+        geometry::ProgressCallback progress);
 };
 
 } // namespace io
@@ -0,0 +1,284 @@
+/**
+ * @file TextTokenizer.h
+ * @brief Allocation-free tokenizer for ASCII mesh formats
+ *
+ * Works directly on a memory buffer (typically a MappedFile). Numbers are
+ * parsed with std::from_chars, which neither allocates nor depends on the
+ * global locale. Standard libraries without floating-point from_chars
+ * (libc++ for older macOS deployment targets) fall back to strtod_l with
+ * the "C" locale. splitLines() cuts a buffer into newline-aligned chunks
+ * so importers can parse large files concurrently and stitch the results.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if !defined(__cpp_lib_to_chars)
+#include <clocale>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+#endif
+
+namespace dc3d {
+namespace io {
+
+/**
+ * @brief Line-oriented cursor over a text buffer
+ *
+ * Tokens are blank-delimited and never cross a line break; nextLine()
+ * moves to the start of the following line. Returned string_views point
+ * into the buffer.
+ */
+class TextTokenizer {
+public:
+    TextTokenizer(const char* begin, const char* end) : m_pos(begin), m_end(end) {}
+
+    const char* position() const { return m_pos; }
+    bool atEnd() const { return m_pos >= m_end; }
+
+    /// Skip spaces, tabs and carriage returns on the current line
+    void skipBlanks() {
+        while (m_pos < m_end && isBlank(*m_pos)) ++m_pos;
+    }
+
+    /// Check if only blanks remain on the current line
+    bool atLineEnd() {
+        skipBlanks();
+        return m_pos >= m_end || *m_pos == '\n';
+    }
+
+    /// Move to the start of the next line
+    void nextLine() {
+        const void* newline = std::memchr(m_pos, '\n', static_cast<size_t>(m_end - m_pos));
+        m_pos = newline ? static_cast<const char*>(newline) + 1 : m_end;
+    }
+
+    /// Next blank-delimited token on the current line (empty at line end)
+    std::string_view token() {
+        skipBlanks();
+        const char* start = m_pos;
+        while (m_pos < m_end && !isDelimiter(*m_pos)) ++m_pos;
+        return std::string_view(start, static_cast<size_t>(m_pos - start));
+    }
+
+    /**
+     * @brief Parse the next token on the current line as a number
+     * @return false (cursor unchanged past blanks) if the token is not a
+     *         complete number of type T
+     */
+    template<typename T>
+    bool read(T& value) {
+        skipBlanks();
+        const char* start = m_pos;
+        const char* last = m_end;
+        if (!parseNumber(start, last, value)) {
+            return false;
+        }
+        m_pos = last;
+        return true;
+    }
+
+    /// Rest of the current line without the line break (for error messages)
+    std::string_view restOfLine() const {
+        const char* start = m_pos;
+        while (start < m_end && isBlank(*start)) ++start;
+        const void* newline = std::memchr(start, '\n', static_cast<size_t>(m_end - start));
+        const char* stop = newline ? static_cast<const char*>(newline) : m_end;
+        while (stop > start && isBlank(stop[-1])) --stop;
+        return std::string_view(start, static_cast<size_t>(stop - start));
+    }
+
+    /**
+     * @brief Parse a number that spans a whole token
+     * @param first Start of the token; on success, last is set to its end
+     * @param last End of the buffer
+     */
+    template<typename T>
+    static bool parseNumber(const char* first, const char*& last, T& value) {
+        // from_chars rejects the explicit '+' that some exporters write
+        if (first < last && *first == '+') ++first;
+        const char* ptr = fromChars(first, last, value);
+        if (!ptr || (ptr < last && !isDelimiter(*ptr))) {
+            return false;
+        }
+        last = ptr;
+        return true;
+    }
+
+    /// Parse a number that is exactly the given text
+    template<typename T>
+    static bool parseNumber(std::string_view text, T& value) {
+        if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+        const char* end = text.data() + text.size();
+        return !text.empty() && fromChars(text.data(), end, value) == end;
+    }
+
+    /// Case-insensitive comparison against a lowercase keyword
+    static bool equalsKeyword(std::string_view token, std::string_view keyword) {
+        if (token.size() != keyword.size()) return false;
+        for (size_t i = 0; i < token.size(); ++i) {
+            char c = token[i];
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+            if (c != keyword[i]) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Split a buffer into newline-aligned chunks
+     * @param chunkBytes Approximate chunk size
+     * @return Chunk boundaries: begin, interior line starts, end
+     */
+    static std::vector<const char*> splitLines(const char* begin, const char* end,
+                                               size_t chunkBytes) {
+        std::vector<const char*> bounds{begin};
+        const size_t size = static_cast<size_t>(end - begin);
+        const size_t chunks = std::max<size_t>(1, size / std::max<size_t>(chunkBytes, 1));
+        const size_t step = size / chunks;
+
+        for (size_t c = 1; c < chunks; ++c) {
+            const char* cut = std::max(begin + c * step, bounds.back());
+            const void* newline = std::memchr(cut, '\n', static_cast<size_t>(end - cut));
+            if (!newline) break;
+            cut = static_cast<const char*>(newline) + 1;
+            if (cut < end && cut > bounds.back()) {
+                bounds.push_back(cut);
+            }
+        }
+        bounds.push_back(end);
+        return bounds;
+    }
+
+    /// Number of line breaks in [begin, end)
+    static size_t countLines(const char* begin, const char* end) {
+        return static_cast<size_t>(std::count(begin, end, '\n'));
+    }
+
+    /// Read the remainder of a stream into a buffer
+    static std::string readAll(std::istream& stream) {
+        std::string buffer;
+        auto start = stream.tellg();
+        stream.seekg(0, std::ios::end);
+        auto stop = stream.tellg();
+        stream.seekg(start);
+        if (start >= 0 && stop > start) {
+            buffer.resize(static_cast<size_t>(stop - start));
+            stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.resize(static_cast<size_t>(stream.gcount()));
+        } else {
+            buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        }
+        return buffer;
+    }
+
+private:
+    static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+    static bool isDelimiter(char c) { return isBlank(c) || c == '\n'; }
+
+    /// std::from_chars; returns the end of the number, or nullptr if none
+    template<typename T>
+    static const char* fromChars(const char* first, const char* last, T& value) {
+#if !defined(__cpp_lib_to_chars)
+        if constexpr (std::is_floating_point_v<T>) {
+            return fromCharsC(first, last, value);
+        } else
+#endif
+        {
+            auto [ptr, ec] = std::from_chars(first, last, value);
+            if constexpr (std::is_floating_point_v<T>) {
+                // Out of range also covers underflow, which istringstream and
+                // strtod read as 0 or a denormal; only overflow is an error
+                if (ec == std::errc::result_out_of_range && hasNegativeExponent(first, ptr)) {
+                    value = underflowValue<T>(first, ptr);
+                    return ptr;
+                }
+            }
+            return ec == std::errc() ? ptr : nullptr;
+        }
+    }
+
+    static bool hasNegativeExponent(const char* first, const char* last) {
+        for (const char* p = first; p + 1 < last; ++p) {
+            if ((*p == 'e' || *p == 'E') && p[1] == '-') return true;
+        }
+        return false;
+    }
+
+    /// Value of a number too small for T: via a wider type if there is one
+    template<typename T>
+    static T underflowValue(const char* first, const char* last) {
+        if constexpr (sizeof(T) < sizeof(long double)) {
+            long double wide = 0;
+            auto [ptr, ec] = std::from_chars(first, last, wide);
+            if (ec == std::errc() && ptr == last) {
+                return static_cast<T>(wide);
+            }
+        }
+        return *first == '-' ? -T(0) : T(0);
+    }
+
+#if !defined(__cpp_lib_to_chars)
+    /**
+     * @brief Floating-point fallback through strtod_l in the "C" locale
+     *
+     * strtod needs a terminated string, so the token is copied to a stack
+     * buffer first. The copy stops at an 'x' so that hex floats, which
+     * from_chars does not accept, end the number there as well.
+     */
+    template<typename T>
+    static const char* fromCharsC(const char* first, const char* last, T& value) {
+        char text[128];
+        size_t length = 0;
+        while (first + length < last && length < sizeof(text) - 1 &&
+               !isDelimiter(first[length]) && first[length] != 'x' && first[length] != 'X') {
+            text[length] = first[length];
+            ++length;
+        }
+        text[length] = '\0';
+        if (length == 0) {
+            return nullptr;
+        }
+
+        char* end = nullptr;
+        errno = 0;
+        T parsed;
+#if defined(_WIN32)
+        static const _locale_t cLocale = _create_locale(LC_ALL, "C");
+        if constexpr (std::is_same_v<T, float>) parsed = _strtof_l(text, &end, cLocale);
+        else if constexpr (std::is_same_v<T, double>) parsed = _strtod_l(text, &end, cLocale);
+        else parsed = _strtold_l(text, &end, cLocale);
+#else
+        static const locale_t cLocale = newlocale(LC_ALL_MASK, "C", locale_t(0));
+        if constexpr (std::is_same_v<T, float>) parsed = strtof_l(text, &end, cLocale);
+        else if constexpr (std::is_same_v<T, double>) parsed = strtod_l(text, &end, cLocale);
+        else parsed = strtold_l(text, &end, cLocale);
+#endif
+        if (end == text || (errno == ERANGE && std::isinf(parsed))) {
+            return nullptr;
+        }
+        value = parsed;
+        return first + (end - text);
+    }
+#endif
+
+    const char* m_pos;
+    const char* m_end;
+};
+
+} // namespace io
+} // namespace dc3d
@@ -6,6 +6,7 @@
 #include "Picking.h"
 #include "Camera.h"
 #include "../geometry/MeshData.h"
+#include "../geometry/DerivedDataCache.h"
 
 #include <QMatrix4x4>
 #include <algorithm>
@@ -45,10 +46,12 @@ void Picking::addMesh(uint32_t meshId, const geometry::MeshData* mesh,
             m.transform = transform;
             m.inverseTransform = glm::inverse(transform);
             try {
-                m.bvh = std::make_shared<geometry::BVH>(*mesh);
+                // Read from the derived data cache when this mesh was seen before
+                m.bvh = geometry::DerivedDataCache::instance().bvh(*mesh);
             } catch (const std::exception& e) {
                 qWarning() << "Picking: BVH construction exception for mesh" << meshId << ":" << e.what();
                 m.bvh = nullptr;
+                updateSceneBVH();
                 return;
             }
             // Validate BVH construction succeeded
@@ -56,6 +59,7 @@ void Picking::addMesh(uint32_t meshId, const geometry::MeshData* mesh,
                 qWarning() << "Picking: BVH construction failed for mesh" << meshId 
                            << "(possibly empty mesh)";
             }
+            updateSceneBVH();
             return;
         }
     }
@@ -67,7 +71,8 @@ void Picking::addMesh(uint32_t meshId, const geometry::MeshData* mesh,
     pm.transform = transform;
     pm.inverseTransform = glm::inverse(transform);
     try {
-        pm.bvh = std::make_shared<geometry::BVH>(*mesh);
+        // Read from the derived data cache when this mesh was seen before
+        pm.bvh = geometry::DerivedDataCache::instance().bvh(*mesh);
     } catch (const std::exception& e) {
         qWarning() << "Picking: BVH construction exception for mesh" << meshId << ":" << e.what();
         pm.bvh = nullptr;
@@ -80,6 +85,7 @@ void Picking::addMesh(uint32_t meshId, const geometry::MeshData* mesh,
     pm.visible = true;
     
     m_meshes.push_back(std::move(pm));
+    updateSceneBVH();
 }
 
 void Picking::updateTransform(uint32_t meshId, const glm::mat4& transform)
@@ -88,6 +94,7 @@ void Picking::updateTransform(uint32_t meshId, const glm::mat4& transform)
         if (m.meshId == meshId) {
             m.transform = transform;
             m.inverseTransform = glm::inverse(transform);
+            updateSceneBVH();
             return;
         }
     }
@@ -97,7 +104,10 @@ void Picking::setMeshVisible(uint32_t meshId, bool visible)
 {
     for (auto& m : m_meshes) {
         if (m.meshId == meshId) {
-            m.visible = visible;
+            if (m.visible != visible) {
+                m.visible = visible;
+                updateSceneBVH();
+            }
             return;
         }
     }
@@ -109,13 +119,31 @@ void Picking::removeMesh(uint32_t meshId)
         std::remove_if(m_meshes.begin(), m_meshes.end(),
                       [meshId](const PickableMesh& m) { return m.meshId == meshId; }),
         m_meshes.end());
+    updateSceneBVH();
 }
 
 void Picking::rebuildBVH(uint32_t meshId)
 {
     for (auto& m : m_meshes) {
         if (m.meshId == meshId && m.mesh) {
-            m.bvh = std::make_shared<geometry::BVH>(*m.mesh);
+            // Positions-only edits: refit in place while the tree stays good
+            if (!m.bvh || !m.bvh->refit(*m.mesh) || m.bvh->needsRebuild()) {
+                m.bvh = std::make_shared<geometry::BVH>(*m.mesh);
+            }
+            updateSceneBVH();
+            return;
+        }
+    }
+}
+
+void Picking::refitBVH(uint32_t meshId, const std::vector<uint32_t>& dirtyTriangles)
+{
+    for (auto& m : m_meshes) {
+        if (m.meshId == meshId && m.mesh) {
+            if (!m.bvh || !m.bvh->refit(*m.mesh, dirtyTriangles) || m.bvh->needsRebuild()) {
+                m.bvh = std::make_shared<geometry::BVH>(*m.mesh);
+            }
+            updateSceneBVH();
             return;
         }
     }
@@ -124,6 +152,38 @@ void Picking::rebuildBVH(uint32_t meshId)
 void Picking::clear()
 {
     m_meshes.clear();
+    m_sceneBVH.clear();
+}
+
+geometry::AABB Picking::worldBounds(const PickableMesh& pm)
+{
+    geometry::AABB box;
+    if (!pm.visible || !pm.bvh || !pm.bvh->isValid()) {
+        return box;
+    }
+
+    const geometry::AABB& local = pm.bvh->bounds();
+    for (int corner = 0; corner < 8; ++corner) {
+        glm::vec3 p((corner & 1) ? local.max.x : local.min.x,
+                    (corner & 2) ? local.max.y : local.min.y,
+                    (corner & 4) ? local.max.z : local.min.z);
+        box.expand(glm::vec3(pm.transform * glm::vec4(p, 1.0f)));
+    }
+    return box;
+}
+
+void Picking::updateSceneBVH()
+{
+    std::vector<geometry::AABB> bounds;
+    bounds.reserve(m_meshes.size());
+    for (const auto& pm : m_meshes) {
+        bounds.push_back(worldBounds(pm));
+    }
+
+    // Moves only stretch boxes; added, removed or hidden meshes need a rebuild
+    if (!m_sceneBVH.refit(bounds) || m_sceneBVH.needsRebuild()) {
+        m_sceneBVH.build(bounds);
+    }
 }
 
 // ============================================================================
@@ -225,10 +285,9 @@ core::HitInfo Picking::pick(const geometry::Ray& worldRay) const
     bestHit.hit = false;
     bestHit.distance = std::numeric_limits<float>::max();
     
-    for (const auto& pm : m_meshes) {
-        if (!pm.visible || !pm.bvh || !pm.bvh->isValid()) {
-            continue;
-        }
+    // Only meshes whose world bounds the ray enters before the best hit
+    m_sceneBVH.intersect(worldRay, [&](uint32_t index, float tMax) {
+        const PickableMesh& pm = m_meshes[index];
         
         // Transform ray to mesh local space
         geometry::Ray localRay = transformRay(worldRay, pm.inverseTransform);
@@ -266,7 +325,9 @@ core::HitInfo Picking::pick(const geometry::Ray& worldRay) const
                 }
             }
         }
-    }
+        
+        return bestHit.hit ? std::min(tMax, bestHit.distance) : tMax;
+    });
     
     return bestHit;
 }
@@ -291,42 +352,39 @@ void Picking::buildSelectionFrustum(const QRect& rect,
     QMatrix4x4 vp = projMatrix * viewMatrix;
     glm::mat4 glmVP = toGlm(vp);
     
-    // Extract 6 frustum planes from the modified VP matrix
-    // We'll modify the projection to match our selection rect
-    
-    // For a full-screen frustum: planes from rows of VP matrix
-    // For selection rect: we need custom planes
+    // Side planes bound clip x/w and y/w to the rect: x0 * w <= x <= x1 * w,
+    // i.e. row0 - x0 * row3 >= 0 and x1 * row3 - row0 >= 0 (likewise for y)
     
     // Left plane (x >= x0)
     planes[0] = glm::vec4(
-        glmVP[0][3] + glmVP[0][0] - x0 * (glmVP[0][3]),
-        glmVP[1][3] + glmVP[1][0] - x0 * (glmVP[1][3]),
-        glmVP[2][3] + glmVP[2][0] - x0 * (glmVP[2][3]),
-        glmVP[3][3] + glmVP[3][0] - x0 * (glmVP[3][3])
+        glmVP[0][0] - x0 * glmVP[0][3],
+        glmVP[1][0] - x0 * glmVP[1][3],
+        glmVP[2][0] - x0 * glmVP[2][3],
+        glmVP[3][0] - x0 * glmVP[3][3]
     );
     
     // Right plane (x <= x1)
     planes[1] = glm::vec4(
-        glmVP[0][3] - glmVP[0][0] + x1 * (glmVP[0][3]),
-        glmVP[1][3] - glmVP[1][0] + x1 * (glmVP[1][3]),
-        glmVP[2][3] - glmVP[2][0] + x1 * (glmVP[2][3]),
-        glmVP[3][3] - glmVP[3][0] + x1 * (glmVP[3][3])
+        x1 * glmVP[0][3] - glmVP[0][0],
+        x1 * glmVP[1][3] - glmVP[1][0],
+        x1 * glmVP[2][3] - glmVP[2][0],
+        x1 * glmVP[3][3] - glmVP[3][0]
     );
     
     // Bottom plane (y >= y0)
     planes[2] = glm::vec4(
-        glmVP[0][3] + glmVP[0][1] - y0 * (glmVP[0][3]),
-        glmVP[1][3] + glmVP[1][1] - y0 * (glmVP[1][3]),
-        glmVP[2][3] + glmVP[2][1] - y0 * (glmVP[2][3]),
-        glmVP[3][3] + glmVP[3][1] - y0 * (glmVP[3][3])
+        glmVP[0][1] - y0 * glmVP[0][3],
+        glmVP[1][1] - y0 * glmVP[1][3],
+        glmVP[2][1] - y0 * glmVP[2][3],
+        glmVP[3][1] - y0 * glmVP[3][3]
     );
     
     // Top plane (y <= y1)
     planes[3] = glm::vec4(
-        glmVP[0][3] - glmVP[0][1] + y1 * (glmVP[0][3]),
-        glmVP[1][3] - glmVP[1][1] + y1 * (glmVP[1][3]),
-        glmVP[2][3] - glmVP[2][1] + y1 * (glmVP[2][3]),
-        glmVP[3][3] - glmVP[3][1] + y1 * (glmVP[3][3])
+        y1 * glmVP[0][3] - glmVP[0][1],
+        y1 * glmVP[1][3] - glmVP[1][1],
+        y1 * glmVP[2][3] - glmVP[2][1],
+        y1 * glmVP[3][3] - glmVP[3][1]
     );
     
     // Near plane
@@ -372,17 +430,20 @@ std::vector<core::SelectionElement> Picking::boxSelect(
                          camera.viewMatrix(), camera.projectionMatrix(),
                          planes);
     
-    for (const auto& pm : m_meshes) {
-        if (!pm.visible || !pm.bvh || !pm.bvh->isValid() || !pm.mesh) {
+    // Only meshes whose world bounds reach into the frustum
+    for (uint32_t index : m_sceneBVH.queryFrustum(planes)) {
+        const PickableMesh& pm = m_meshes[index];
+        if (!pm.mesh) {
             continue;
         }
         
-        // Transform frustum planes to mesh local space
+        // Transform frustum planes to mesh local space: a world plane p
+        // satisfies dot(p, M * x) = dot(transpose(M) * p, x) for local x
         glm::vec4 localPlanes[6];
-        glm::mat4 invTranspose = glm::transpose(pm.inverseTransform);
+        glm::mat4 planeToLocal = glm::transpose(pm.transform);
         
         for (int i = 0; i < 6; ++i) {
-            localPlanes[i] = invTranspose * planes[i];
+            localPlanes[i] = planeToLocal * planes[i];
             // Re-normalize
             float len = glm::length(glm::vec3(localPlanes[i]));
             if (len > 1e-10f) {
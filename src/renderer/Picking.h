@@ -4,7 +4,7 @@
  * 
  * Provides:
  * - Generate rays from mouse position + camera
- * - Query BVH for intersections
+ * - Two-level BVH queries: scene tree over mesh bounds, then per-mesh BVH
  * - Determine closest vertex/edge from hit point
  * - Box selection frustum generation
  */
@@ -88,10 +88,20 @@ public:
     void removeMesh(uint32_t meshId);
     
     /**
-     * @brief Rebuild BVH for a mesh (call after mesh data changes)
+     * @brief Update BVH for a mesh (call after mesh data changes)
+     * 
+     * If only vertex positions changed, the existing tree is refit; it is
+     * rebuilt when the topology changed or refits degraded it too much.
      */
     void rebuildBVH(uint32_t meshId);
     
+    /**
+     * @brief Refit BVH after some triangles moved (e.g. a sculpt stroke)
+     * @param meshId Mesh to update
+     * @param dirtyTriangles Every triangle that uses a moved vertex
+     */
+    void refitBVH(uint32_t meshId, const std::vector<uint32_t>& dirtyTriangles);
+    
     /**
      * @brief Clear all meshes
      */
@@ -197,7 +207,21 @@ private:
      */
     static glm::mat4 toGlm(const QMatrix4x4& m);
     
+    /**
+     * @brief World-space bounds of a mesh (invalid if hidden or unpickable)
+     */
+    static geometry::AABB worldBounds(const PickableMesh& pm);
+    
+    /**
+     * @brief Refit the scene BVH to current mesh bounds, rebuilding if needed
+     * 
+     * Called after every change to m_meshes, transforms, visibility or
+     * per-mesh BVHs, so queries never see a stale scene tree.
+     */
+    void updateSceneBVH();
+    
     std::vector<PickableMesh> m_meshes;
+    geometry::InstanceBVH m_sceneBVH;  ///< Top level: instance = index into m_meshes
 };
 
 /**
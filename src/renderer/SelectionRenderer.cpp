@@ -434,8 +434,8 @@ void SelectionRenderer::render(const dc::Camera& camera, const core::Selection&
     // Group selection by mesh
     std::map<uint32_t, std::vector<uint32_t>> selectionByMesh;
     
-    for (const auto& elem : selection.selectedElements()) {
-        selectionByMesh[elem.meshId].push_back(elem.elementIndex);
+    for (uint32_t meshId : selection.selectedMeshIds()) {
+        selectionByMesh[meshId] = selection.selectedIndices(meshId);
     }
     
     // Setup rendering state
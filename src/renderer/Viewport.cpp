@@ -162,6 +162,48 @@ void main() {
 }
 )";
 
+// Import preview shaders - positions only; the face normal comes from
+// screen-space derivatives so streamed chunks need no normals
+static const char* PREVIEW_VERTEX_SHADER = R"(
+#version 410 core
+
+layout(location = 0) in vec3 position;
+
+uniform mat4 viewProjection;
+
+out vec3 vWorldPosition;
+
+void main() {
+    vWorldPosition = position;
+    gl_Position = viewProjection * vec4(position, 1.0);
+}
+)";
+
+static const char* PREVIEW_FRAGMENT_SHADER = R"(
+#version 410 core
+
+in vec3 vWorldPosition;
+
+uniform vec3 baseColor;
+uniform vec3 lightDir;
+uniform float ambientStrength;
+
+out vec4 fragColor;
+
+void main() {
+    vec3 normal = normalize(cross(dFdx(vWorldPosition), dFdy(vWorldPosition)));
+    
+    // Two-sided: streamed geometry has no consistent winding guarantee
+    float diff = abs(dot(normal, normalize(-lightDir)));
+    vec3 color = baseColor * (ambientStrength + (1.0 - ambientStrength) * diff);
+    
+    // Gamma correction
+    color = pow(color, vec3(1.0 / 2.2));
+    
+    fragColor = vec4(color, 1.0);
+}
+)";
+
 Viewport::Viewport(QWidget* parent)
     : QOpenGLWidget(parent)
     , m_camera(std::make_unique<Camera>())
@@ -192,6 +234,8 @@ Viewport::Viewport(QWidget* parent)
 
 Viewport::~Viewport()
 {
+    endImportPreview();
+    
     makeCurrent();
     
     // Clean up mesh GPU data
@@ -230,6 +274,7 @@ void Viewport::initializeGL()
     setupOpenGLState();
     setupMeshShader();
     setupGradientShader();
+    setupPreviewShader();
     
     // Initialize grid renderer
     if (!m_gridRenderer->initialize()) {
@@ -348,6 +393,26 @@ void Viewport::setupGradientShader()
     qDebug() << "Gradient background shader initialized";
 }
 
+void Viewport::setupPreviewShader()
+{
+    m_previewShader = std::make_unique<QOpenGLShaderProgram>();
+    
+    if (!m_previewShader->addShaderFromSourceCode(QOpenGLShader::Vertex, PREVIEW_VERTEX_SHADER)) {
+        qWarning() << "Preview vertex shader compile error:" << m_previewShader->log();
+        return;
+    }
+    
+    if (!m_previewShader->addShaderFromSourceCode(QOpenGLShader::Fragment, PREVIEW_FRAGMENT_SHADER)) {
+        qWarning() << "Preview fragment shader compile error:" << m_previewShader->log();
+        return;
+    }
+    
+    if (!m_previewShader->link()) {
+        qWarning() << "Preview shader link error:" << m_previewShader->log();
+        return;
+    }
+}
+
 void Viewport::setupViewPresetsWidget()
 {
     m_viewPresetsWidget = new ViewPresetsWidget(this, this);
@@ -459,6 +524,7 @@ void Viewport::paintGL()
     
     // Render meshes
     renderMeshes();
+    renderImportPreview();
     
     // Render hover highlight (pre-selection feedback)
     if (m_selectionRenderer && m_selection && m_hoverEnabled && m_hoverHitInfo.hit) {
@@ -829,6 +895,237 @@ void Viewport::uploadMeshToGPU(uint64_t id, const dc3d::geometry::MeshData& mesh
              << mesh.faceCount() << "faces";
 }
 
+// ---- Import Preview ----
+
+void Viewport::beginImportPreview(size_t expectedVertices, size_t expectedTriangles)
+{
+    endImportPreview();
+    
+    m_previewActive = true;
+    m_previewBoundsMin = QVector3D(std::numeric_limits<float>::max(),
+                                   std::numeric_limits<float>::max(),
+                                   std::numeric_limits<float>::max());
+    m_previewBoundsMax = QVector3D(std::numeric_limits<float>::lowest(),
+                                   std::numeric_limits<float>::lowest(),
+                                   std::numeric_limits<float>::lowest());
+    
+    if (!m_initialized) {
+        return;
+    }
+    
+    makeCurrent();
+    
+    // Size the buffers from the header counts so they rarely need to grow
+    constexpr size_t MIN_PREVIEW_VERTICES = 65536;
+    m_previewVertexBytes = std::min(std::max(expectedVertices, MIN_PREVIEW_VERTICES) * sizeof(glm::vec3),
+                                    PREVIEW_MAX_BYTES / 2);
+    m_previewIndexBytes = std::min(std::max(expectedTriangles, MIN_PREVIEW_VERTICES) * 3 * sizeof(uint32_t),
+                                   PREVIEW_MAX_BYTES / 2);
+    
+    // The EBO binding is VAO state, so every preview buffer operation
+    // happens with the preview VAO bound
+    m_previewVAO.create();
+    m_previewVAO.bind();
+    
+    m_previewVBO.create();
+    m_previewVBO.bind();
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_previewVertexBytes), nullptr, GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+    
+    m_previewEBO.create();
+    m_previewEBO.bind();
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_previewIndexBytes), nullptr, GL_DYNAMIC_DRAW);
+    
+    m_previewVBO.release();
+    m_previewVAO.release();
+    
+    doneCurrent();
+}
+
+bool Viewport::reservePreviewBuffer(QOpenGLBuffer& buffer, size_t& capacityBytes,
+                                    size_t usedBytes, size_t requiredBytes)
+{
+    if (requiredBytes <= capacityBytes) {
+        return true;
+    }
+    
+    size_t grownBytes = std::max(requiredBytes, capacityBytes * 2);
+    if (grownBytes + m_previewVertexBytes + m_previewIndexBytes - capacityBytes > PREVIEW_MAX_BYTES) {
+        grownBytes = PREVIEW_MAX_BYTES - (m_previewVertexBytes + m_previewIndexBytes - capacityBytes);
+        if (grownBytes < requiredBytes) {
+            return false;
+        }
+    }
+    
+    // Copy the used part into a larger buffer on the GPU
+    const GLenum target = buffer.type() == QOpenGLBuffer::IndexBuffer
+        ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+    QOpenGLBuffer grown(buffer.type());
+    grown.create();
+    grown.bind();
+    glBufferData(target, static_cast<GLsizeiptr>(grownBytes), nullptr, GL_DYNAMIC_DRAW);
+    
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer.bufferId());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown.bufferId());
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(usedBytes));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    
+    buffer.destroy();
+    buffer = grown;
+    capacityBytes = grownBytes;
+    
+    if (target == GL_ARRAY_BUFFER) {
+        // Re-point the position attribute at the new VBO
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+    }
+    return true;
+}
+
+void Viewport::appendImportPreview(const glm::vec3* vertices, size_t vertexCount,
+                                   const uint32_t* indices, size_t indexCount,
+                                   const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+    if (!m_previewActive || m_previewFull || !m_initialized || !m_previewVAO.isCreated()) {
+        return;
+    }
+    
+    const size_t totalBytes =
+        (m_previewVertexCount + m_previewPendingVertices.size() + vertexCount) * sizeof(glm::vec3) +
+        (m_previewIndexCount + m_previewPendingIndices.size() + indexCount) * sizeof(uint32_t);
+    if (totalBytes > PREVIEW_MAX_BYTES) {
+        // Keep what is shown; later triangles could refer to dropped vertices
+        m_previewFull = true;
+        qDebug() << "Viewport::appendImportPreview - preview size limit reached at"
+                 << (m_previewIndexCount + m_previewPendingIndices.size()) / 3 << "triangles";
+        return;
+    }
+    
+    m_previewPendingVertices.insert(m_previewPendingVertices.end(), vertices, vertices + vertexCount);
+    m_previewPendingIndices.insert(m_previewPendingIndices.end(), indices, indices + indexCount);
+    
+    if (vertexCount > 0) {
+        m_previewBoundsMin.setX(std::min(m_previewBoundsMin.x(), boundsMin.x));
+        m_previewBoundsMin.setY(std::min(m_previewBoundsMin.y(), boundsMin.y));
+        m_previewBoundsMin.setZ(std::min(m_previewBoundsMin.z(), boundsMin.z));
+        m_previewBoundsMax.setX(std::max(m_previewBoundsMax.x(), boundsMax.x));
+        m_previewBoundsMax.setY(std::max(m_previewBoundsMax.y(), boundsMax.y));
+        m_previewBoundsMax.setZ(std::max(m_previewBoundsMax.z(), boundsMax.z));
+    }
+    update();
+}
+
+void Viewport::uploadImportPreview()
+{
+    if (m_previewPendingVertices.empty() && m_previewPendingIndices.empty()) {
+        return;
+    }
+    
+    // Called from paintGL: the context is current
+    m_previewVAO.bind();
+    
+    const size_t vertexBytes = m_previewVertexCount * sizeof(glm::vec3);
+    const size_t indexBytes = m_previewIndexCount * sizeof(uint32_t);
+    const size_t addedVertexBytes = m_previewPendingVertices.size() * sizeof(glm::vec3);
+    const size_t addedIndexBytes = m_previewPendingIndices.size() * sizeof(uint32_t);
+    
+    m_previewVBO.bind();
+    bool fits = reservePreviewBuffer(m_previewVBO, m_previewVertexBytes, vertexBytes, vertexBytes + addedVertexBytes);
+    if (fits) {
+        m_previewEBO.bind();
+        fits = reservePreviewBuffer(m_previewEBO, m_previewIndexBytes, indexBytes, indexBytes + addedIndexBytes);
+    }
+    
+    if (!fits) {
+        // Buffer growth did not fit next to the other buffer's capacity
+        m_previewFull = true;
+        qDebug() << "Viewport::uploadImportPreview - preview size limit reached at"
+                 << m_previewIndexCount / 3 << "triangles";
+    } else {
+        if (addedVertexBytes > 0) {
+            m_previewVBO.bind();
+            glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(vertexBytes),
+                            static_cast<GLsizeiptr>(addedVertexBytes), m_previewPendingVertices.data());
+            m_previewVertexCount += m_previewPendingVertices.size();
+        }
+        if (addedIndexBytes > 0) {
+            m_previewEBO.bind();
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(indexBytes),
+                            static_cast<GLsizeiptr>(addedIndexBytes), m_previewPendingIndices.data());
+            m_previewIndexCount += m_previewPendingIndices.size();
+        }
+    }
+    
+    m_previewVBO.release();
+    m_previewVAO.release();
+    
+    m_previewPendingVertices.clear();
+    m_previewPendingIndices.clear();
+}
+
+void Viewport::endImportPreview()
+{
+    if (m_previewVAO.isCreated()) {
+        makeCurrent();
+        m_previewVBO.destroy();
+        m_previewEBO.destroy();
+        m_previewVAO.destroy();
+        doneCurrent();
+    }
+    
+    m_previewVertexCount = 0;
+    m_previewIndexCount = 0;
+    m_previewVertexBytes = 0;
+    m_previewIndexBytes = 0;
+    m_previewPendingVertices = {};
+    m_previewPendingIndices = {};
+    m_previewFull = false;
+    if (m_previewActive) {
+        m_previewActive = false;
+        update();
+    }
+}
+
+void Viewport::fitViewToImportPreview()
+{
+    if (m_previewBoundsMin.x() > m_previewBoundsMax.x()) {
+        return;  // No vertices yet
+    }
+    
+    BoundingBox bounds;
+    bounds.min = m_previewBoundsMin;
+    bounds.max = m_previewBoundsMax;
+    fitView(bounds);
+}
+
+void Viewport::renderImportPreview()
+{
+    if (m_previewActive && m_previewVAO.isCreated()) {
+        uploadImportPreview();
+    }
+    if (!m_previewActive || m_previewIndexCount == 0 ||
+        !m_previewShader || !m_previewShader->isLinked()) {
+        return;
+    }
+    
+    m_previewShader->bind();
+    m_previewShader->setUniformValue("viewProjection", m_camera->projectionMatrix() * m_camera->viewMatrix());
+    m_previewShader->setUniformValue("baseColor", QVector3D(0.7f, 0.7f, 0.75f));
+    m_previewShader->setUniformValue("lightDir", QVector3D(-0.5f, -0.7f, -0.5f));
+    m_previewShader->setUniformValue("ambientStrength", 0.2f);
+    
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDisable(GL_CULL_FACE);
+    
+    m_previewVAO.bind();
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_previewIndexCount), GL_UNSIGNED_INT, nullptr);
+    m_previewVAO.release();
+    
+    glEnable(GL_CULL_FACE);
+    m_previewShader->release();
+}
+
 BoundingBox Viewport::computeSceneBounds() const
 {
     BoundingBox bounds;
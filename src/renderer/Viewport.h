@@ -12,6 +12,7 @@
  * - Professional gradient background
  * - Viewport info overlay (view name, selection count)
  * - View presets toolbar
+ * - Growing preview of a mesh while it is being imported
  */
 
 #pragma once
@@ -23,8 +24,10 @@
 #include <QOpenGLBuffer>
 #include <QOpenGLShaderProgram>
 #include <QElapsedTimer>
+#include <glm/glm.hpp>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include <cstdint>
 
 namespace dc {
@@ -308,6 +311,48 @@ public:
      * @param mode 0=Translate, 1=Rotate, 2=Scale
      */
     void setGizmoMode(int mode);
+    
+    // ---- Import Preview ----
+    
+    /**
+     * @brief Start showing geometry of a file that is still loading
+     * @param expectedVertices Vertex count hint for buffer sizing (0 if unknown)
+     * @param expectedTriangles Triangle count hint for buffer sizing (0 if unknown)
+     * 
+     * The preview is drawn flat-shaded on top of the scene until
+     * endImportPreview(). It stops growing once it reaches
+     * PREVIEW_MAX_BYTES of GPU memory.
+     */
+    void beginImportPreview(size_t expectedVertices, size_t expectedTriangles);
+    
+    /**
+     * @brief Append streamed geometry to the preview
+     * @param vertices New vertices, continuing the numbering of earlier calls
+     * @param indices Triangles over all vertices appended so far
+     * @param boundsMin Minimum corner of the new vertices (from the importer)
+     * @param boundsMax Maximum corner of the new vertices
+     * 
+     * Only copies the data; it is uploaded to the GPU with the next paint,
+     * where the GL context is current anyway.
+     */
+    void appendImportPreview(const glm::vec3* vertices, size_t vertexCount,
+                             const uint32_t* indices, size_t indexCount,
+                             const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    
+    /**
+     * @brief Release the preview (the imported mesh replaces it)
+     */
+    void endImportPreview();
+    
+    /**
+     * @brief Check if an import preview is being shown
+     */
+    bool hasImportPreview() const { return m_previewActive; }
+    
+    /**
+     * @brief Fit the camera to the preview geometry received so far
+     */
+    void fitViewToImportPreview();
 
 signals:
     /**
@@ -447,6 +492,11 @@ private:
     void renderInfoOverlay(QPainter& painter);
     void updateFPS();
     void uploadMeshToGPU(uint64_t id, const dc3d::geometry::MeshData& mesh);
+    void setupPreviewShader();
+    void renderImportPreview();
+    void uploadImportPreview();
+    bool reservePreviewBuffer(QOpenGLBuffer& buffer, size_t& capacityBytes,
+                              size_t usedBytes, size_t requiredBytes);
     BoundingBox computeSceneBounds() const;
     void renderFPSOverlay();
     void updateViewName();
@@ -498,6 +548,23 @@ private:
     QOpenGLVertexArrayObject m_gradientVAO;
     QOpenGLBuffer m_gradientVBO{QOpenGLBuffer::VertexBuffer};
     
+    // Import preview (positions only, flat-shaded in the fragment shader)
+    static constexpr size_t PREVIEW_MAX_BYTES = size_t(1) << 30;
+    std::unique_ptr<QOpenGLShaderProgram> m_previewShader;
+    QOpenGLVertexArrayObject m_previewVAO;
+    QOpenGLBuffer m_previewVBO{QOpenGLBuffer::VertexBuffer};
+    QOpenGLBuffer m_previewEBO{QOpenGLBuffer::IndexBuffer};
+    size_t m_previewVertexCount = 0;
+    size_t m_previewIndexCount = 0;
+    size_t m_previewVertexBytes = 0;     ///< VBO capacity
+    size_t m_previewIndexBytes = 0;      ///< EBO capacity
+    std::vector<glm::vec3> m_previewPendingVertices;    ///< Appended, not uploaded yet
+    std::vector<uint32_t> m_previewPendingIndices;
+    QVector3D m_previewBoundsMin;
+    QVector3D m_previewBoundsMax;
+    bool m_previewActive = false;
+    bool m_previewFull = false;          ///< Size limit reached; further chunks are ignored
+    
     // Viewport info overlay
     bool m_showInfoOverlay = true;
     QString m_currentViewName{"Perspective"};
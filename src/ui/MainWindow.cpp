@@ -18,6 +18,9 @@
 #include "renderer/TransformGizmo.h"
 #include "tools/MeasureTool.h"
 #include "app/Application.h"
+#include "core/SceneManager.h"
+#include "core/Selection.h"
+#include "io/MeshExporter.h"
 
 #include <QApplication>
 #include <QSettings>
@@ -33,6 +36,7 @@
 #include <QFileInfo>
 #include <QLocale>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QUndoStack>
 #include <QTimer>
 #include <QWhatsThis>
@@ -1659,6 +1663,32 @@ void MainWindow::onSaveProjectAsRequested()
 
 void MainWindow::onExportMeshRequested()
 {
+    auto* app = dc3d::Application::instance();
+    auto* scene = app ? app->sceneManager() : nullptr;
+    if (!scene) {
+        return;
+    }
+    
+    // Export the selected mesh, or the only mesh in the scene
+    std::shared_ptr<dc3d::geometry::MeshData> mesh;
+    if (app->selection()) {
+        auto selected = app->selection()->selectedMeshIds();
+        if (!selected.empty()) {
+            mesh = scene->getMesh(selected.front());
+        }
+    }
+    if (!mesh) {
+        auto ids = scene->meshIds();
+        if (ids.size() == 1) {
+            mesh = scene->getMesh(ids.front());
+        }
+    }
+    if (!mesh || mesh->isEmpty()) {
+        QMessageBox::information(this, tr("Export Mesh"),
+            tr("Select the mesh you want to export."));
+        return;
+    }
+    
     // Build export filter
     QString filter = tr(
         "STL Stereolithography (*.stl);;"
@@ -1673,12 +1703,56 @@ void MainWindow::onExportMeshRequested()
         return;
     }
     
-    // TODO: Implement actual export using SceneManager
-    // For now, show stub message
-    QMessageBox::information(this, tr("Export Mesh"),
-        tr("Mesh export to '%1' is not yet fully implemented.\n\n"
-           "This feature will be available in a future update.")
-            .arg(QFileInfo(filePath).fileName()));
+    dc::ExportOptions options;
+    if (!dc3d::io::MeshExporter::formatForExtension(QFileInfo(filePath).suffix().toStdString(),
+                                                     options.format)) {
+        QMessageBox::warning(this, tr("Export Mesh"),
+            tr("Unknown mesh format '%1'. Use a .stl, .obj or .ply file name.")
+                .arg(QFileInfo(filePath).suffix()));
+        return;
+    }
+    // Mesh formats carry no unit or axis metadata; keep scene coordinates
+    options.coordSystem = dc::CoordinateSystem::RightHanded_YUp;
+    
+    // Show progress for large meshes
+    constexpr size_t PROGRESS_DIALOG_FACES = 1000000;
+    std::unique_ptr<QProgressDialog> progressDialog;
+    if (mesh->faceCount() > PROGRESS_DIALOG_FACES) {
+        progressDialog = std::make_unique<QProgressDialog>(
+            tr("Exporting %1...").arg(QFileInfo(filePath).fileName()),
+            tr("Cancel"), 0, 100, this);
+        progressDialog->setWindowModality(Qt::WindowModal);
+        progressDialog->setMinimumDuration(0);
+        progressDialog->setValue(0);
+        QApplication::processEvents();
+    }
+    
+    auto progressCallback = [&progressDialog](float progress) -> bool {
+        if (progressDialog) {
+            if (progressDialog->wasCanceled()) {
+                return false;
+            }
+            progressDialog->setValue(static_cast<int>(progress * 100));
+            QApplication::processEvents();
+        }
+        return true;
+    };
+    
+    auto result = dc3d::io::MeshExporter::exportMesh(
+        *mesh, filePath.toStdString(), options, progressCallback);
+    
+    if (progressDialog) {
+        progressDialog->close();
+    }
+    
+    if (!result.ok()) {
+        QMessageBox::warning(this, tr("Export Failed"), QString::fromStdString(result.error));
+        return;
+    }
+    
+    setStatusMessage(tr("Exported: %1 (%2)")
+        .arg(QFileInfo(filePath).fileName())
+        .arg(QLocale().formattedDataSize(static_cast<qint64>(*result.value))));
 }
 
 // ============================================================================
@@ -8,11 +8,32 @@
 
 #include <iostream>
 #include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
 
 // Include headers to test compilation
 #include "core/SceneManager.h"
+#include "core/Selection.h"
+#include "core/UndoSpillStore.h"
+#include "core/Commands/MeshDelta.h"
 #include "geometry/MeshData.h"
+#include "geometry/KDTree.h"
+#include "geometry/BVH.h"
+#include "geometry/PrimitiveGenerator.h"
+#include "geometry/DerivedDataCache.h"
+#include "renderer/Picking.h"
+#include "renderer/Camera.h"
 #include "io/MeshImporter.h"
+#include "io/NativeFormat.h"
+#include "io/TextTokenizer.h"
 
 void testMeshData()
 {
@@ -24,9 +45,9 @@ void testMeshData()
     assert(mesh.faceCount() == 0);
     
     // Add a triangle
-    uint32_t v0 = mesh.addVertex(Vec3d(0, 0, 0));
-    uint32_t v1 = mesh.addVertex(Vec3d(1, 0, 0));
-    uint32_t v2 = mesh.addVertex(Vec3d(0, 1, 0));
+    uint32_t v0 = mesh.addVertex(glm::vec3(0, 0, 0));
+    uint32_t v1 = mesh.addVertex(glm::vec3(1, 0, 0));
+    uint32_t v2 = mesh.addVertex(glm::vec3(0, 1, 0));
     mesh.addFace(v0, v1, v2);
     
     assert(!mesh.isEmpty());
@@ -37,12 +58,585 @@ void testMeshData()
     mesh.computeNormals();
     
     // Test bounds
-    const BoundingBox& bounds = mesh.bounds();
+    const BoundingBox& bounds = mesh.boundingBox();
     assert(bounds.isValid());
     
     std::cout << "MeshData tests passed!" << std::endl;
 }
 
+void testKDTree()
+{
+    using namespace dc3d::geometry;
+    
+    // Clustered points with duplicates, so ties and empty regions both occur
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    std::vector<glm::vec3> points;
+    for (int i = 0; i < 2000; ++i) {
+        glm::vec3 p(coord(rng), coord(rng), coord(rng) * 0.1f);
+        points.push_back(p);
+        if (i % 50 == 0) {
+            points.push_back(p);
+        }
+    }
+    
+    KDTree empty;
+    empty.build({});
+    assert(empty.size() == 0);
+    assert(empty.findNearest(glm::vec3(0.0f)) == -1);
+    
+    for (uint32_t leafSize : {1u, 8u, 32u}) {
+        KDTree tree;
+        tree.build(points, leafSize);
+        assert(tree.size() == points.size());
+        
+        for (int q = 0; q < 200; ++q) {
+            glm::vec3 query(coord(rng) * 1.2f, coord(rng) * 1.2f, coord(rng) * 0.2f);
+            
+            std::vector<KDNeighbor> expected;
+            for (uint32_t i = 0; i < points.size(); ++i) {
+                glm::vec3 d = points[i] - query;
+                expected.push_back({i, glm::dot(d, d)});
+            }
+            std::sort(expected.begin(), expected.end(),
+                      [](const KDNeighbor& a, const KDNeighbor& b) {
+                          return a.distanceSquared < b.distanceSquared;
+                      });
+            
+            // Nearest: ties may resolve to either index, the distance must match
+            float dist = 0.0f;
+            int nearest = tree.findNearest(query, std::numeric_limits<float>::max(), &dist);
+            assert(nearest >= 0);
+            glm::vec3 dn = points[nearest] - query;
+            assert(glm::dot(dn, dn) == expected[0].distanceSquared);
+            
+            // Nearest with a cutoff below the true distance finds nothing
+            float cutoff = std::sqrt(expected[0].distanceSquared) * 0.5f;
+            if (cutoff > 0.0f) {
+                assert(tree.findNearest(query, cutoff) == -1);
+            }
+            
+            // k nearest: same sorted distances as the linear scan
+            std::vector<KDNeighbor> knn;
+            size_t found = tree.findKNearest(query, 16, knn);
+            assert(found == 16 && knn.size() == 16);
+            for (size_t k = 0; k < knn.size(); ++k) {
+                assert(knn[k].distanceSquared == expected[k].distanceSquared);
+            }
+            
+            // Radius: exactly the indices within the (inclusive) radius
+            float radius = 1.5f;
+            std::vector<KDNeighbor> inRadius;
+            tree.findInRadius(query, radius, inRadius);
+            std::vector<uint32_t> got, want;
+            for (const auto& n : inRadius) {
+                got.push_back(n.index);
+            }
+            for (const auto& n : expected) {
+                if (n.distanceSquared <= radius * radius) {
+                    want.push_back(n.index);
+                }
+            }
+            std::sort(got.begin(), got.end());
+            std::sort(want.begin(), want.end());
+            assert(got == want);
+        }
+    }
+    
+    std::cout << "KDTree tests passed!" << std::endl;
+}
+
+namespace {
+
+// Brute-force reference for BVH::intersect: nearest hit over all triangles
+float bruteForceRayHit(const dc3d::geometry::MeshData& mesh, const dc3d::geometry::Ray& ray)
+{
+    const auto& v = mesh.vertices();
+    const auto& idx = mesh.indices();
+    float best = std::numeric_limits<float>::max();
+    for (size_t f = 0; f + 2 < idx.size(); f += 3) {
+        glm::vec3 e1 = v[idx[f + 1]] - v[idx[f]];
+        glm::vec3 e2 = v[idx[f + 2]] - v[idx[f]];
+        glm::vec3 h = glm::cross(ray.direction, e2);
+        float a = glm::dot(e1, h);
+        if (std::abs(a) < 1e-8f) continue;
+        glm::vec3 s = ray.origin - v[idx[f]];
+        float u = glm::dot(s, h) / a;
+        if (u < 0.0f || u > 1.0f) continue;
+        glm::vec3 q = glm::cross(s, e1);
+        float w = glm::dot(ray.direction, q) / a;
+        if (w < 0.0f || u + w > 1.0f) continue;
+        float t = glm::dot(e2, q) / a;
+        if (t > ray.tMin && t < best) best = t;
+    }
+    return best;
+}
+
+// Brute-force reference for BVH::closestPoint
+float bruteForceClosestDistance(const dc3d::geometry::MeshData& mesh, const glm::vec3& p)
+{
+    const auto& v = mesh.vertices();
+    const auto& idx = mesh.indices();
+    float best = std::numeric_limits<float>::max();
+    for (size_t f = 0; f + 2 < idx.size(); f += 3) {
+        glm::vec3 bary;
+        glm::vec3 c = dc3d::geometry::closestPointOnTriangle(
+            p, v[idx[f]], v[idx[f + 1]], v[idx[f + 2]], bary);
+        best = std::min(best, glm::length(c - p));
+    }
+    return best;
+}
+
+void checkBVHAgainstBruteForce(const dc3d::geometry::BVH& bvh,
+                               const dc3d::geometry::MeshData& mesh,
+                               std::mt19937& rng)
+{
+    using namespace dc3d::geometry;
+    std::uniform_real_distribution<float> coord(-3.0f, 3.0f);
+    
+    for (int q = 0; q < 100; ++q) {
+        glm::vec3 origin(coord(rng), coord(rng), coord(rng));
+        glm::vec3 target(coord(rng) * 0.3f, coord(rng) * 0.3f, coord(rng) * 0.3f);
+        Ray ray(origin, target - origin);
+        
+        BVHHitResult hit = bvh.intersect(ray);
+        float expected = bruteForceRayHit(mesh, ray);
+        if (expected == std::numeric_limits<float>::max()) {
+            assert(!hit.hit);
+        } else {
+            assert(hit.hit);
+            assert(std::abs(hit.t - expected) <= 1e-4f * std::max(1.0f, expected));
+        }
+        
+        BVHClosestPointResult cp = bvh.closestPoint(origin);
+        assert(cp.found);
+        float expectedDist = bruteForceClosestDistance(mesh, origin);
+        assert(std::abs(cp.distance - expectedDist) <= 1e-4f * std::max(1.0f, expectedDist));
+    }
+}
+
+} // namespace
+
+void testBVHRefit()
+{
+    using namespace dc3d::geometry;
+    
+    std::mt19937 rng(42);
+    MeshData mesh = PrimitiveGenerator::createSphere(glm::vec3(0.0f), 1.0f, 16, 24);
+    BVH bvh(mesh);
+    checkBVHAgainstBruteForce(bvh, mesh, rng);
+    assert(bvh.degradation() == 1.0f);
+    
+    // Full refit after every vertex moved
+    for (auto& v : mesh.editVertices()) {
+        v += glm::vec3(0.3f * std::sin(v.y * 4.0f), 0.0f, 0.2f * v.x);
+    }
+    assert(bvh.refit(mesh));
+    checkBVHAgainstBruteForce(bvh, mesh, rng);
+    
+    // Dirty-list refit after moving a few vertices far out
+    std::vector<uint32_t> moved;
+    {
+        auto& vertices = mesh.editVertices();
+        for (uint32_t i = 0; i < vertices.size(); i += 37) {
+            vertices[i] *= 1.8f;
+            moved.push_back(i);
+        }
+    }
+    std::vector<uint32_t> dirty;
+    const auto& indices = mesh.indices();
+    for (uint32_t f = 0; f < indices.size() / 3; ++f) {
+        for (int k = 0; k < 3; ++k) {
+            if (std::binary_search(moved.begin(), moved.end(), indices[f * 3 + k])) {
+                dirty.push_back(f);
+                break;
+            }
+        }
+    }
+    assert(bvh.refit(mesh, dirty));
+    checkBVHAgainstBruteForce(bvh, mesh, rng);
+    
+    // Topology changes are rejected
+    MeshData other = PrimitiveGenerator::createSphere(glm::vec3(0.0f), 1.0f, 8, 12);
+    assert(!bvh.refit(other));
+    assert(!bvh.refit(other, dirty));
+    
+    // So are index rewrites that keep the counts (winding flip)
+    auto& flipped = mesh.editIndices();
+    std::swap(flipped[1], flipped[2]);
+    assert(!bvh.refit(mesh));
+    assert(!bvh.refit(mesh, dirty));
+    
+    std::cout << "BVH refit tests passed!" << std::endl;
+}
+
+namespace {
+
+struct TestInstance {
+    glm::mat4 transform;
+    bool visible = true;
+};
+
+glm::mat4 cubeTransform(const glm::vec3& position, float angle, float scale)
+{
+    glm::mat4 t = glm::translate(glm::mat4(1.0f), position);
+    t = glm::rotate(t, angle, glm::vec3(0.0f, 0.0f, 1.0f));
+    return glm::scale(t, glm::vec3(scale, scale, scale * 0.8f));
+}
+
+// Screen position of a world point, top-left origin
+QPoint projectToScreen(const dc::Camera& camera, const QSize& viewport, const glm::vec3& p)
+{
+    QVector4D clip = camera.viewProjectionMatrix() * QVector4D(p.x, p.y, p.z, 1.0f);
+    float x = clip.x() / clip.w();
+    float y = clip.y() / clip.w();
+    return QPoint(static_cast<int>((x + 1.0f) * 0.5f * viewport.width()),
+                  static_cast<int>((1.0f - y) * 0.5f * viewport.height()));
+}
+
+void checkPickingAgainstLinearScan(const dc3d::renderer::Picking& picking,
+                                   const dc3d::geometry::MeshData& cube,
+                                   const std::map<uint32_t, TestInstance>& instances,
+                                   const dc::Camera& camera,
+                                   std::mt19937& rng)
+{
+    using namespace dc3d;
+    
+    // World-space copies of every visible instance for the brute-force pick
+    std::map<uint32_t, geometry::MeshData> worldMeshes;
+    for (const auto& [id, inst] : instances) {
+        if (!inst.visible) continue;
+        geometry::MeshData world = cube;
+        for (auto& v : world.editVertices()) {
+            v = glm::vec3(inst.transform * glm::vec4(v, 1.0f));
+        }
+        worldMeshes.emplace(id, std::move(world));
+    }
+    
+    // Rays from above, aimed near instance centers so most of them hit
+    std::uniform_real_distribution<float> jitter(-0.8f, 0.8f);
+    std::uniform_real_distribution<float> spread(-4.0f, 40.0f);
+    for (int q = 0; q < 200; ++q) {
+        glm::vec3 origin(spread(rng), spread(rng), 30.0f);
+        glm::vec3 target(spread(rng), spread(rng), 0.0f);
+        if (q % 4 != 0 && !instances.empty()) {
+            auto it = instances.begin();
+            std::advance(it, rng() % instances.size());
+            target = glm::vec3(it->second.transform[3]) + glm::vec3(jitter(rng), jitter(rng), 0.0f);
+        }
+        geometry::Ray ray(origin, target - origin);
+        
+        float expected = std::numeric_limits<float>::max();
+        uint32_t expectedId = 0;
+        for (const auto& [id, world] : worldMeshes) {
+            float t = bruteForceRayHit(world, ray);
+            if (t < expected) {
+                expected = t;
+                expectedId = id;
+            }
+        }
+        
+        core::HitInfo hit = picking.pick(ray);
+        if (expected == std::numeric_limits<float>::max()) {
+            assert(!hit.hit);
+        } else {
+            assert(hit.hit);
+            assert(hit.meshId == expectedId);
+            assert(std::abs(hit.distance - expected) <= 1e-3f * std::max(1.0f, expected));
+        }
+    }
+    
+    // Box selection over rects whose edges run between grid cells
+    const QSize viewport(1000, 1000);
+    for (int q = 0; q < 20; ++q) {
+        float x0 = 4.0f * static_cast<float>(rng() % 10) - 2.0f;
+        float y0 = 4.0f * static_cast<float>(rng() % 10) - 2.0f;
+        float x1 = x0 + 4.0f * static_cast<float>(1 + rng() % 5);
+        float y1 = y0 + 4.0f * static_cast<float>(1 + rng() % 5);
+        QPoint a = projectToScreen(camera, viewport, glm::vec3(x0, y1, 0.0f));
+        QPoint b = projectToScreen(camera, viewport, glm::vec3(x1, y0, 0.0f));
+        QRect rect(a, b);
+        
+        std::set<uint32_t> expectedIds;
+        for (const auto& [id, inst] : instances) {
+            glm::vec3 c(inst.transform[3]);
+            if (inst.visible && c.x > x0 && c.x < x1 && c.y > y0 && c.y < y1) {
+                expectedIds.insert(id);
+            }
+        }
+        
+        std::set<uint32_t> objects;
+        for (const auto& e : picking.boxSelect(rect, viewport, camera, core::SelectionMode::Object)) {
+            assert(e.mode == core::SelectionMode::Object);
+            assert(objects.insert(e.meshId).second);
+        }
+        assert(objects == expectedIds);
+        
+        std::map<uint32_t, std::set<uint64_t>> faces;
+        for (const auto& e : picking.boxSelect(rect, viewport, camera, core::SelectionMode::Face)) {
+            assert(faces[e.meshId].insert(e.elementIndex).second);
+        }
+        assert(faces.size() == expectedIds.size());
+        for (const auto& [id, set] : faces) {
+            assert(expectedIds.count(id));
+            assert(set.size() == cube.faceCount());
+        }
+    }
+}
+
+} // namespace
+
+void testPicking()
+{
+    using namespace dc3d;
+    
+    geometry::DerivedDataCache::instance().setEnabled(false);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> scale(0.6f, 1.2f);
+    
+    geometry::MeshData cube = geometry::PrimitiveGenerator::createCube(glm::vec3(0.0f), 1.0f);
+    
+    dc::Camera camera;
+    camera.lookAt(QVector3D(18.0f, 18.0f, 60.0f), QVector3D(18.0f, 18.0f, 0.0f),
+                  QVector3D(0.0f, 1.0f, 0.0f));
+    camera.setPerspective(45.0f, 1.0f, 0.1f, 500.0f);
+    
+    // One instance per grid cell, cells are 4 units apart
+    std::vector<std::pair<int, int>> freeCells;
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10; ++j) {
+            freeCells.emplace_back(i, j);
+        }
+    }
+    std::shuffle(freeCells.begin(), freeCells.end(), rng);
+    auto takeCell = [&]() {
+        auto cell = freeCells.back();
+        freeCells.pop_back();
+        return glm::vec3(4.0f * cell.first, 4.0f * cell.second,
+                         static_cast<float>(rng() % 3) - 1.0f);
+    };
+    auto releaseCell = [&](const glm::mat4& transform) {
+        glm::vec3 c(transform[3]);
+        freeCells.emplace_back(static_cast<int>(std::lround(c.x / 4.0f)),
+                               static_cast<int>(std::lround(c.y / 4.0f)));
+    };
+    
+    renderer::Picking picking;
+    std::map<uint32_t, TestInstance> instances;
+    uint32_t nextId = 1;
+    
+    // Add
+    for (int i = 0; i < 30; ++i) {
+        TestInstance inst;
+        inst.transform = cubeTransform(takeCell(), angle(rng), scale(rng));
+        picking.addMesh(nextId, &cube, inst.transform);
+        instances[nextId++] = inst;
+    }
+    checkPickingAgainstLinearScan(picking, cube, instances, camera, rng);
+    
+    // Move
+    for (uint32_t id = 1; id <= 10; ++id) {
+        releaseCell(instances[id].transform);
+        instances[id].transform = cubeTransform(takeCell(), angle(rng), scale(rng));
+        picking.updateTransform(id, instances[id].transform);
+    }
+    checkPickingAgainstLinearScan(picking, cube, instances, camera, rng);
+    
+    // Hide, then show again
+    for (uint32_t id = 11; id <= 15; ++id) {
+        instances[id].visible = false;
+        picking.setMeshVisible(id, false);
+    }
+    checkPickingAgainstLinearScan(picking, cube, instances, camera, rng);
+    for (uint32_t id = 11; id <= 15; ++id) {
+        instances[id].visible = true;
+        picking.setMeshVisible(id, true);
+    }
+    checkPickingAgainstLinearScan(picking, cube, instances, camera, rng);
+    
+    // Remove, then add into the freed slots
+    for (uint32_t id = 16; id <= 20; ++id) {
+        releaseCell(instances[id].transform);
+        instances.erase(id);
+        picking.removeMesh(id);
+    }
+    checkPickingAgainstLinearScan(picking, cube, instances, camera, rng);
+    for (int i = 0; i < 5; ++i) {
+        TestInstance inst;
+        inst.transform = cubeTransform(takeCell(), angle(rng), scale(rng));
+        picking.addMesh(nextId, &cube, inst.transform);
+        instances[nextId++] = inst;
+    }
+    checkPickingAgainstLinearScan(picking, cube, instances, camera, rng);
+    
+    // Rewriting a triangle in place keeps both counts but must not be refit
+    geometry::MeshData quad;
+    quad.editVertices() = {{100, 0, 0}, {101, 0, 0}, {101, 1, 0}, {100, 1, 0},
+                           {110, 0, 0}, {111, 0, 0}, {111, 1, 0}};
+    quad.editIndices() = {0, 1, 2, 4, 5, 6};
+    picking.addMesh(nextId, &quad, glm::mat4(1.0f));
+    const geometry::Ray throughSecondHalf(glm::vec3(100.2f, 0.8f, 5.0f), glm::vec3(0.0f, 0.0f, -1.0f));
+    assert(!picking.pick(throughSecondHalf).hit);
+    
+    auto& quadIndices = quad.editIndices();
+    quadIndices[3] = 0;
+    quadIndices[4] = 2;
+    quadIndices[5] = 3;
+    picking.rebuildBVH(nextId);
+    core::HitInfo flipped = picking.pick(throughSecondHalf);
+    assert(flipped.hit && flipped.meshId == nextId && flipped.faceIndex == 1);
+    
+    std::cout << "Picking tests passed!" << std::endl;
+}
+
+namespace {
+
+void checkSelectionSet(const dc3d::core::SelectionSet& set, const std::set<uint64_t>& expected)
+{
+    assert(set.size() == expected.size());
+    assert(set.empty() == expected.empty());
+    
+    std::vector<uint64_t> visited;
+    set.forEach([&](uint64_t index) { visited.push_back(index); });
+    assert(std::equal(visited.begin(), visited.end(), expected.begin(), expected.end()));
+    
+    for (uint64_t index : expected) {
+        assert(set.contains(index));
+        assert(!set.contains(index + 1) || expected.count(index + 1));
+    }
+}
+
+} // namespace
+
+void testSelectionSet()
+{
+    using namespace dc3d::core;
+    
+    std::mt19937_64 rng(99);
+    SelectionSet set;
+    std::set<uint64_t> expected;
+    
+    auto randomSorted = [&](uint64_t range, size_t count) {
+        std::set<uint64_t> picked;
+        for (size_t i = 0; i < count; ++i) {
+            picked.insert(rng() % range);
+        }
+        return std::vector<uint64_t>(picked.begin(), picked.end());
+    };
+    
+    // Small selections stay sparse
+    for (uint64_t i = 0; i < 100; ++i) {
+        assert(set.insert(i * 3) == expected.insert(i * 3).second);
+    }
+    assert(!set.isDense());
+    checkSelectionSet(set, expected);
+    
+    // A large contiguous range turns dense
+    assert(set.insertRange(0, 5000) == 5000 - 100);
+    for (uint64_t i = 0; i < 5000; ++i) expected.insert(i);
+    assert(set.isDense());
+    checkSelectionSet(set, expected);
+    
+    // Shrinking well below the limit turns sparse again
+    assert(set.eraseRange(300, 5000) == 4700);
+    expected.erase(expected.lower_bound(300), expected.end());
+    assert(!set.isDense());
+    checkSelectionSet(set, expected);
+    
+    // An index beyond the bitset range forces a dense set back to sparse
+    set.insertRange(0, 4000);
+    for (uint64_t i = 0; i < 4000; ++i) expected.insert(i);
+    assert(set.isDense());
+    const uint64_t huge = SelectionSet::DENSE_INDEX_LIMIT + 5;
+    assert(set.insert(huge));
+    expected.insert(huge);
+    assert(!set.isDense());
+    checkSelectionSet(set, expected);
+    assert(set.erase(huge));
+    expected.erase(huge);
+    checkSelectionSet(set, expected);
+    
+    // Many indices spread over a wide range stay sparse
+    set.clear();
+    expected.clear();
+    assert(set.empty() && !set.isDense());
+    for (uint64_t i = 0; i < 2000; ++i) {
+        set.insert(i * 1000);
+        expected.insert(i * 1000);
+    }
+    assert(!set.isDense());
+    checkSelectionSet(set, expected);
+    
+    // Random mixed operations, crossing the dense/sparse boundary both ways
+    set.clear();
+    expected.clear();
+    bool sawDense = false, sawSparse = false;
+    for (int step = 0; step < 400; ++step) {
+        const uint64_t range = (step % 50 < 40) ? 8192 : SelectionSet::DENSE_INDEX_LIMIT * 2;
+        switch (rng() % 7) {
+        case 0: {
+            uint64_t index = rng() % range;
+            assert(set.insert(index) == expected.insert(index).second);
+            break;
+        }
+        case 1: {
+            uint64_t index = rng() % 8192;
+            assert(set.erase(index) == (expected.erase(index) == 1));
+            break;
+        }
+        case 2: {
+            auto indices = randomSorted(range, rng() % 1500);
+            size_t added = 0;
+            for (uint64_t index : indices) added += expected.insert(index).second;
+            assert(set.insert(indices) == added);
+            break;
+        }
+        case 3: {
+            auto indices = randomSorted(8192, rng() % 1500);
+            size_t removed = 0;
+            for (uint64_t index : indices) removed += expected.erase(index);
+            assert(set.erase(indices) == removed);
+            break;
+        }
+        case 4: {
+            auto indices = randomSorted(range, rng() % 1500);
+            for (uint64_t index : indices) {
+                if (!expected.erase(index)) expected.insert(index);
+            }
+            set.toggle(indices);
+            break;
+        }
+        case 5: {
+            uint64_t first = rng() % 8192;
+            uint64_t last = first + rng() % 3000;
+            size_t changed = 0;
+            bool insert = rng() % 2 == 0;
+            for (uint64_t i = first; i < last; ++i) {
+                changed += insert ? expected.insert(i).second : expected.erase(i);
+            }
+            assert((insert ? set.insertRange(first, last) : set.eraseRange(first, last)) == changed);
+            break;
+        }
+        default: {
+            uint64_t first = rng() % 8192;
+            uint64_t last = first + rng() % 3000;
+            for (uint64_t i = first; i < last; ++i) {
+                if (!expected.erase(i)) expected.insert(i);
+            }
+            set.toggleRange(first, last);
+            break;
+        }
+        }
+        sawDense |= set.isDense();
+        sawSparse |= !set.isDense() && set.size() > 0;
+        checkSelectionSet(set, expected);
+    }
+    assert(sawDense && sawSparse);
+    
+    std::cout << "SelectionSet tests passed!" << std::endl;
+}
+
 void testSceneManager()
 {
     using namespace dc3d::core;
@@ -75,13 +669,384 @@ void testImporter()
     std::cout << "MeshImporter tests passed!" << std::endl;
 }
 
+void testNativeFormatRoundTrip()
+{
+    const std::string path = "test_roundtrip.dca";
+    
+    auto makeBody = [](float offset) {
+        auto body = std::make_shared<dc::Body>();
+        for (int i = 0; i < 3000; i++) {
+            body->combinedMesh.vertices.push_back(glm::vec3(offset + i, 0.5f * i, 0.0f));
+            body->combinedMesh.indices.push_back(static_cast<uint32_t>(i));
+        }
+        return body;
+    };
+    
+    dc::Project project;
+    project.bodies.push_back(makeBody(0.0f));
+    project.bodies.push_back(makeBody(100.0f));
+    auto sketch = std::make_shared<dc::Sketch>();
+    sketch->elements.push_back(std::make_shared<dc::SketchElement>());
+    sketch->elements.back()->points = {glm::dvec2(0, 0), glm::dvec2(1, 0)};
+    project.sketches.push_back(sketch);
+    
+    dc::NativeFormat format;
+    assert(format.saveProject(project, path));
+    
+    auto fileSize = [&path]() {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return static_cast<size_t>(file.tellg());
+    };
+    
+    // Open lazily, edit one body without flagging it anywhere, save back
+    auto opened = format.openProject(path);
+    assert(opened && opened->bodies.size() == 2);
+    assert(format.loadBody(*opened, 0));
+    opened->bodies[0]->combinedMesh.vertices[7] = glm::vec3(-1.0f, -2.0f, -3.0f);
+    assert(format.saveProject(*opened, path));
+    
+    auto reopened = format.loadProject(path);
+    assert(reopened && reopened->bodies.size() == 2 && reopened->sketches.size() == 1);
+    assert(reopened->bodies[0]->combinedMesh.vertices[7] == glm::vec3(-1.0f, -2.0f, -3.0f));
+    assert(reopened->bodies[0]->combinedMesh.vertices[8] == glm::vec3(8.0f, 4.0f, 0.0f));
+    assert(reopened->bodies[1]->combinedMesh.vertices == project.bodies[1]->combinedMesh.vertices);
+    assert(reopened->sketches[0]->elements.size() == 1);
+    
+    // Saving unchanged parts only appends the manifest and table of contents
+    const size_t before = fileSize();
+    assert(format.saveProject(*reopened, path));
+    const size_t meshBytes = project.bodies[0]->combinedMesh.vertices.size() * sizeof(glm::vec3);
+    assert(fileSize() - before < meshBytes);
+    
+    // Sketch edits are detected the same way
+    reopened->sketches[0]->elements.back()->points[1] = glm::dvec2(5, 6);
+    assert(format.saveProject(*reopened, path));
+    auto saved = format.loadProject(path);
+    assert(saved && saved->sketches[0]->elements.size() == 1);
+    assert(saved->sketches[0]->elements[0]->points[1] == glm::dvec2(5, 6));
+    assert(saved->bodies[0]->combinedMesh.vertices[7] == glm::vec3(-1.0f, -2.0f, -3.0f));
+    
+    saved.reset();
+    reopened.reset();
+    opened.reset();
+    std::remove(path.c_str());
+    
+    std::cout << "NativeFormat round-trip tests passed!" << std::endl;
+}
+
+void testNativeFormatInterruptedAppend()
+{
+    const std::string path = "test_interrupted.dca";
+    
+    dc::Project project;
+    auto body = std::make_shared<dc::Body>();
+    for (int i = 0; i < 3000; i++) {
+        body->combinedMesh.vertices.push_back(glm::vec3(static_cast<float>(i), 1.0f, 2.0f));
+        body->combinedMesh.indices.push_back(static_cast<uint32_t>(i));
+    }
+    project.bodies.push_back(body);
+    project.bodies.push_back(std::make_shared<dc::Body>(*body));
+    
+    dc::NativeFormat format;
+    assert(format.saveProject(project, path));
+    
+    auto fileSize = [&path]() {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return static_cast<size_t>(file.tellg());
+    };
+    const size_t firstSave = fileSize();
+    
+    // A second save that is killed partway: entry data and part of a table
+    // of contents end up after the first save's footer
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        std::vector<char> partial(5000, '\x5a');
+        out.write(partial.data(), static_cast<std::streamsize>(partial.size()));
+    }
+    assert(fileSize() > firstSave);
+    
+    auto opened = format.openProject(path);
+    assert(opened && opened->bodies.size() == 2);
+    assert(format.loadBody(*opened, 0));
+    assert(opened->bodies[0]->combinedMesh.vertices == body->combinedMesh.vertices);
+    
+    // The next incremental save (one body changed) replaces the leftovers
+    opened->bodies[0]->combinedMesh.vertices[3] = glm::vec3(-4.0f);
+    assert(format.saveProject(*opened, path));
+    opened.reset();
+    auto reopened = format.loadProject(path);
+    assert(reopened && reopened->bodies[0]->combinedMesh.vertices[3] == glm::vec3(-4.0f));
+    const size_t secondSave = fileSize();
+    reopened.reset();
+    
+    // Losing the tail of a save (footer included) falls back to the one before
+    std::filesystem::resize_file(path, secondSave - 7);
+    auto truncated = format.loadProject(path);
+    assert(truncated && truncated->bodies.size() == 2);
+    assert(truncated->bodies[0]->combinedMesh.vertices == body->combinedMesh.vertices);
+    truncated.reset();
+    
+    // Damaging the last table of contents does the same
+    assert(format.saveProject(*format.loadProject(path), path));
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(fileSize()) - 30);
+        file.put('\x01');
+    }
+    auto corrupted = format.loadProject(path);
+    assert(corrupted && corrupted->bodies[0]->combinedMesh.vertices == body->combinedMesh.vertices);
+    corrupted.reset();
+    
+    std::remove(path.c_str());
+    
+    std::cout << "NativeFormat interrupted append tests passed!" << std::endl;
+}
+
+void testMeshDeltaSpillFailure()
+{
+    using namespace dc3d;
+    
+    const std::filesystem::path parent = std::filesystem::absolute("test_undo_spill");
+    std::filesystem::remove_all(parent);
+    std::filesystem::create_directories(parent);
+    
+    core::UndoSpillStore store(parent);
+    assert(store.isAvailable());
+    
+    // Take the store's directory away: its background writes start failing
+    // while edits keep spilling into it
+    for (const auto& entry : std::filesystem::directory_iterator(parent)) {
+        std::filesystem::remove_all(entry.path());
+    }
+    
+    std::mt19937 rng(11);
+    geometry::MeshData mesh = geometry::PrimitiveGenerator::createSphere(glm::vec3(0.0f), 1.0f, 16, 24);
+    std::vector<std::vector<glm::vec3>> states{mesh.vertices()};
+    std::vector<core::MeshDelta> deltas;
+    auto edit = [&]() {
+        geometry::MeshData before = mesh;
+        auto& vertices = mesh.editVertices();
+        for (int k = 0; k < 20; ++k) {
+            vertices[rng() % vertices.size()] += glm::vec3(0.01f * static_cast<float>(deltas.size() + 1));
+        }
+        deltas.push_back(core::MeshDelta::compute(before, mesh));
+        states.push_back(mesh.vertices());
+        return deltas.back().spill(store);
+    };
+    for (int i = 0; i < 100; ++i) {
+        edit();
+    }
+    store.flush();
+    assert(!store.isAvailable());
+    
+    // Spilling into the failed store keeps the bytes in the delta
+    for (int i = 0; i < 100; ++i) {
+        assert(edit() == 0);
+        assert(!deltas.back().isSpilled());
+    }
+    
+    // Every step still undoes and redoes, whether or not it reached the store
+    for (size_t i = deltas.size(); i-- > 0;) {
+        assert(deltas[i].revert(mesh));
+        assert(mesh.vertices() == states[i]);
+    }
+    for (size_t i = 0; i < deltas.size(); ++i) {
+        assert(deltas[i].reapply(mesh));
+        assert(mesh.vertices() == states[i + 1]);
+    }
+    
+    deltas.clear();
+    std::filesystem::remove_all(parent);
+    
+    std::cout << "MeshDelta spill failure tests passed!" << std::endl;
+}
+
+void testWeldCacheCancel()
+{
+    using namespace dc3d::geometry;
+    
+    auto& cache = DerivedDataCache::instance();
+    const std::filesystem::path previousDirectory = cache.directory();
+    const bool previouslyEnabled = cache.isEnabled();
+    const std::filesystem::path directory = std::filesystem::absolute("test_weld_cache");
+    std::filesystem::remove_all(directory);
+    cache.setDirectory(directory);
+    cache.setEnabled(true);
+    
+    // Every position twice, enough vertices for the weld to report progress
+    const uint32_t positions = 600000;
+    MeshData soup;
+    {
+        auto& vertices = soup.editVertices();
+        auto& indices = soup.editIndices();
+        for (uint32_t k = 0; k < positions; ++k) {
+            glm::vec3 p(static_cast<float>(k % 1000), static_cast<float>(k / 1000), 0.0f);
+            vertices.push_back(p);
+            vertices.push_back(p);
+        }
+        for (uint32_t i = 0; i < 2 * positions; ++i) {
+            indices.push_back(i);
+        }
+    }
+    
+    // A cancelled weld reports it and leaves nothing in the cache
+    MeshData cancelled = soup;
+    assert(!cache.weldMesh(cancelled, 1e-3f, false, [](float) { return false; }));
+    
+    MeshData welded = soup;
+    assert(cache.weldMesh(welded, 1e-3f, false, [](float) { return true; }));
+    assert(welded.vertexCount() == positions);
+    
+    // The completed weld is what later imports load
+    MeshData cached = soup;
+    assert(cache.weldMesh(cached, 1e-3f, false));
+    assert(cached.vertices() == welded.vertices());
+    assert(cached.indices() == welded.indices());
+    
+    cache.setDirectory(previousDirectory);
+    cache.setEnabled(previouslyEnabled);
+    std::filesystem::remove_all(directory);
+    
+    std::cout << "Weld cache cancel tests passed!" << std::endl;
+}
+
+void testTextTokenizer()
+{
+    using dc3d::io::TextTokenizer;
+    
+    const std::string line = "v 1.5 -2 +3e2 1e-50 -1e-50 1e-40 1e50\n";
+    TextTokenizer tokenizer(line.data(), line.data() + line.size());
+    assert(tokenizer.token() == "v");
+    float x = 0, y = 0, z = 0;
+    assert(tokenizer.read(x) && tokenizer.read(y) && tokenizer.read(z));
+    assert(x == 1.5f && y == -2.0f && z == 300.0f);
+    
+    // Underflow reads as zero or a denormal, like istringstream did
+    float tiny = 1.0f;
+    assert(tokenizer.read(tiny) && tiny == 0.0f && !std::signbit(tiny));
+    assert(tokenizer.read(tiny) && tiny == 0.0f && std::signbit(tiny));
+    assert(tokenizer.read(tiny) && tiny > 0.0f && tiny < std::numeric_limits<float>::min());
+    assert(std::abs(tiny - 1e-40f) <= 1e-45f);
+    
+    // Overflow is an error and leaves the cursor on the token
+    float huge = 0.0f;
+    assert(!tokenizer.read(huge));
+    assert(tokenizer.token() == "1e50");
+    assert(tokenizer.atLineEnd());
+    
+    double d = 1.0;
+    assert(TextTokenizer::parseNumber("1e-400", d) && d == 0.0);
+    assert(TextTokenizer::parseNumber("2.5E-310", d) && d > 0.0 && d < std::numeric_limits<double>::min());
+    assert(!TextTokenizer::parseNumber("1e400", d));
+    assert(!TextTokenizer::parseNumber("-1e400", d));
+    assert(!TextTokenizer::parseNumber("1e-5x", d));
+    
+    // Integers out of range stay errors
+    uint32_t index = 0;
+    assert(!TextTokenizer::parseNumber("99999999999", index));
+    assert(TextTokenizer::parseNumber("42", index) && index == 42);
+    
+    std::cout << "TextTokenizer tests passed!" << std::endl;
+}
+
+void testCompressedMeshRoundTrip()
+{
+    const std::string path = "test_compressed.dca";
+    
+    // Bumpy grid with analytic normals; every stream spans several blocks
+    const int side = 800;
+    dc::MeshData mesh;
+    for (int j = 0; j < side; j++) {
+        for (int i = 0; i < side; i++) {
+            float x = 0.1f * i;
+            float y = 0.1f * j;
+            mesh.vertices.push_back(glm::vec3(x, y, std::sin(x) * std::cos(y)));
+            mesh.normals.push_back(glm::normalize(glm::vec3(-std::cos(x) * std::cos(y),
+                                                            std::sin(x) * std::sin(y), 1.0f)));
+        }
+    }
+    for (int j = 0; j + 1 < side; j++) {
+        for (int i = 0; i + 1 < side; i++) {
+            uint32_t v = static_cast<uint32_t>(j * side + i);
+            mesh.indices.insert(mesh.indices.end(), {v, v + 1, v + side, v + 1, v + side + 1, v + side});
+        }
+    }
+    mesh.boundingBoxMin = glm::vec3(0.0f, 0.0f, -1.0f);
+    mesh.boundingBoxMax = glm::vec3(0.1f * (side - 1), 0.1f * (side - 1), 1.0f);
+    const size_t rawBytes = mesh.vertices.size() * 24 + mesh.indices.size() * 4;
+    
+    auto roundTrip = [&](const dc::MeshCompressionOptions& options) {
+        dc::Project project;
+        project.bodies.push_back(std::make_shared<dc::Body>());
+        project.bodies[0]->combinedMesh = mesh;
+        
+        dc::NativeFormat format;
+        format.setMeshCompression(options);
+        assert(format.saveProject(project, path));
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        assert(static_cast<size_t>(file.tellg()) < rawBytes);  // The compressed chunk was kept
+        file.close();
+        
+        auto loaded = format.loadProject(path);
+        assert(loaded && loaded->bodies.size() == 1);
+        dc::MeshData result = loaded->bodies[0]->combinedMesh;
+        loaded.reset();
+        std::remove(path.c_str());
+        
+        assert(result.indices == mesh.indices);
+        assert(result.vertices.size() == mesh.vertices.size());
+        assert(result.normals.size() == mesh.normals.size());
+        assert(result.boundingBoxMin == mesh.boundingBoxMin && result.boundingBoxMax == mesh.boundingBoxMax);
+        return result;
+    };
+    
+    // Quantized positions and octahedral normals stay within their bounds
+    dc::MeshCompressionOptions lossy;
+    lossy.enabled = true;
+    lossy.positionTolerance = 1e-3f;
+    lossy.octahedralNormals = true;
+    dc::MeshData result = roundTrip(lossy);
+    const double maxAngle = 0.01 * 3.14159265358979 / 180.0;
+    for (size_t i = 0; i < mesh.vertices.size(); i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            assert(std::abs(result.vertices[i][axis] - mesh.vertices[i][axis]) <= lossy.positionTolerance + 1e-5f);
+        }
+        glm::dvec3 a(mesh.normals[i]);
+        glm::dvec3 b(result.normals[i]);
+        double angle = std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b));
+        assert(angle <= maxAngle);
+    }
+    
+    // Lossless settings give back the exact floats
+    dc::MeshCompressionOptions lossless;
+    lossless.enabled = true;
+    lossless.positionTolerance = 0.0f;
+    lossless.octahedralNormals = false;
+    lossless.level = 6;
+    result = roundTrip(lossless);
+    assert(result.vertices == mesh.vertices);
+    assert(result.normals == mesh.normals);
+    
+    std::cout << "Compressed mesh round-trip tests passed!" << std::endl;
+}
+
 int main()
 {
     std::cout << "Running dc-3ddesignapp tests..." << std::endl;
     
     testMeshData();
+    testKDTree();
+    testBVHRefit();
+    testPicking();
+    testSelectionSet();
+    testMeshDeltaSpillFailure();
+    testWeldCacheCancel();
     testSceneManager();
     testImporter();
+    testTextTokenizer();
+    testNativeFormatRoundTrip();
+    testNativeFormatInterruptedAppend();
+    testCompressedMeshRoundTrip();
     
     std::cout << "\nAll tests passed!" << std::endl;
     return 0;